@@ -56,6 +56,7 @@ public enum GCCause {
   _g1_humongous_allocation ("G1 Humongous Allocation"),
 
   _g1_elastic_heap_trigger_gc("Elastic Heap triggered GC"),
+  _g1_periodic_collection ("G1 Periodic Collection"),
 
   _last_ditch_collection ("Last ditch collection"),
   _last_gc_cause ("ILLEGAL VALUE - last gc cause - ILLEGAL VALUE");
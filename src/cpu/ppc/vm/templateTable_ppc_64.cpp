@@ -3599,7 +3599,10 @@ void TemplateTable::_new() {
                  Rtags            = R3_ARG1,
                  Rindex           = R5_ARG3;
 
-  const bool allow_shared_alloc = Universe::heap()->supports_inline_contig_alloc() && !CMSIncrementalMode;
+  // With allocation site sampling a TLAB miss may be a sample point, which
+  // has to reach the slow case.
+  const bool allow_shared_alloc = Universe::heap()->supports_inline_contig_alloc() && !CMSIncrementalMode &&
+                                  AllocationSiteSamplingInterval == 0;
 
   // --------------------------------------------------------------------------
   // Check if fast case is possible.
@@ -3303,14 +3303,14 @@ void TemplateTable::invokedynamic(int byte_no) {
   // G4: CallSite object (from cpool->resolved_references[f1])
   // G5: MH.linkToCallSite method (from f2)
 
-  // Note:  G4_callsite is already pushed by prepare_invoke
+  // Note:  G4_callsite is already pushed by prepare_invoke, unless the
+  //        call site is linked directly to the target of a constant call site
 
   // %%% should make a type profile for any invokedynamic that takes a ref argument
   // profile this call
   __ profile_call(O4);
 
   // do the call
-  __ verify_oop(G4_callsite);
   __ profile_arguments_type(G5_method, Rscratch, Gargs, false);
   __ call_from_interpreter(Rscratch, Gargs, Rret);
 }
@@ -3367,8 +3367,11 @@ void TemplateTable::_new() {
   // 3) if the above fails (or is not applicable), go to a slow case
   // (creates a new TLAB, etc.)
 
+  // With allocation site sampling a TLAB miss may be a sample point, which
+  // has to reach the slow case.
   const bool allow_shared_alloc =
-    Universe::heap()->supports_inline_contig_alloc() && !CMSIncrementalMode;
+    Universe::heap()->supports_inline_contig_alloc() && !CMSIncrementalMode &&
+    AllocationSiteSamplingInterval == 0;
 
   if(UseTLAB) {
     Register RoldTopValue = RallocatedObject;
@@ -6457,9 +6457,16 @@ void MacroAssembler::string_indexofC8(Register str1, Register str2,
 void MacroAssembler::string_indexof(Register str1, Register str2,
                                     Register cnt1, Register cnt2,
                                     int int_cnt2,  Register result,
-                                    XMMRegister vec, Register tmp) {
+                                    XMMRegister vec, Register tmp, bool latin1) {
   ShortBranchVerifier sbv(this);
   assert(UseSSE42Intrinsics, "SSE4.2 is required");
+  assert(!latin1 || int_cnt2 == -1, "Latin-1 only for non constant substring");
+
+  // Latin-1 strings have one byte elements and twice as many per vector
+  Address::ScaleFactor scale = latin1 ? Address::times_1 : Address::times_2;
+  int elem_size = latin1 ? 1 : 2;
+  int stride = latin1 ? 16 : 8;
+  int mode = latin1 ? 0x0c : 0x0d;
   //
   // int_cnt2 is length of small (< 8 chars) constant substring
   // or (-1) for non constant substring in which case its length
@@ -6477,7 +6484,8 @@ void MacroAssembler::string_indexof(Register str1, Register str2,
   //     rax - substring length (elements count)
   //     mem - scanned string
   //     rdx - string length (elements count)
-  //     0xd - mode: 1100 (substring search) + 01 (unsigned shorts)
+  //     mode - 1100 (substring search) + 01 (unsigned shorts)
+  //            or + 00 (unsigned bytes) for Latin-1
   //   outputs:
   //     rcx - matched index in string
   assert(cnt1 == rdx && cnt2 == rax && tmp == rcx, "pcmpestri");
@@ -6510,7 +6518,7 @@ void MacroAssembler::string_indexof(Register str1, Register str2,
         psrldq(vec, 16-(int_cnt2*2));
       }
     } else { // not constant substring
-      cmpl(cnt2, 8);
+      cmpl(cnt2, stride);
       jccb(Assembler::aboveEqual, BIG_STRINGS); // Both strings are big enough
 
       // We can read beyond string if srt+16 does not cross page boundary
@@ -6523,12 +6531,17 @@ void MacroAssembler::string_indexof(Register str1, Register str2,
 
       // Move small strings to stack to allow load 16 bytes into vec.
       subptr(rsp, 16);
-      int stk_offset = wordSize-2;
+      int stk_offset = wordSize-elem_size;
       push(cnt2);
 
       bind(COPY_SUBSTR);
-      load_unsigned_short(result, Address(str2, cnt2, Address::times_2, -2));
-      movw(Address(rsp, cnt2, Address::times_2, stk_offset), result);
+      if (latin1) {
+        load_unsigned_byte(result, Address(str2, cnt2, scale, -1));
+        movb(Address(rsp, cnt2, scale, stk_offset), result);
+      } else {
+        load_unsigned_short(result, Address(str2, cnt2, scale, -2));
+        movw(Address(rsp, cnt2, scale, stk_offset), result);
+      }
       decrement(cnt2);
       jccb(Assembler::notZero, COPY_SUBSTR);
 
@@ -6537,7 +6550,7 @@ void MacroAssembler::string_indexof(Register str1, Register str2,
     } // non constant
 
     bind(CHECK_STR);
-    cmpl(cnt1, 8);
+    cmpl(cnt1, stride);
     jccb(Assembler::aboveEqual, BIG_STRINGS);
 
     // Check cross page boundary.
@@ -6547,7 +6560,7 @@ void MacroAssembler::string_indexof(Register str1, Register str2,
     jccb(Assembler::belowEqual, BIG_STRINGS);
 
     subptr(rsp, 16);
-    int stk_offset = -2;
+    int stk_offset = -elem_size;
     if (int_cnt2 < 0) { // not constant
       push(cnt2);
       stk_offset += wordSize;
@@ -6555,8 +6568,13 @@ void MacroAssembler::string_indexof(Register str1, Register str2,
     movl(cnt2, cnt1);
 
     bind(COPY_STR);
-    load_unsigned_short(result, Address(str1, cnt2, Address::times_2, -2));
-    movw(Address(rsp, cnt2, Address::times_2, stk_offset), result);
+    if (latin1) {
+      load_unsigned_byte(result, Address(str1, cnt2, scale, -1));
+      movb(Address(rsp, cnt2, scale, stk_offset), result);
+    } else {
+      load_unsigned_short(result, Address(str1, cnt2, scale, -2));
+      movw(Address(rsp, cnt2, scale, stk_offset), result);
+    }
     decrement(cnt2);
     jccb(Assembler::notZero, COPY_STR);
 
@@ -6604,32 +6622,34 @@ void MacroAssembler::string_indexof(Register str1, Register str2,
     // matched but the rest of it was not so we need to search
     // again. Start from the next element after the previous match.
     subptr(str1, result); // Restore counter
-    shrl(str1, 1);
+    if (!latin1) {
+      shrl(str1, 1);
+    }
     addl(cnt1, str1);
     decrementl(cnt1);   // Shift to next element
     cmpl(cnt1, cnt2);
     jccb(Assembler::negative, RET_NOT_FOUND);  // Left less then substring
 
-    addptr(result, 2);
+    addptr(result, elem_size);
   } // non constant
 
   // Scan string for start of substr in 16-byte vectors
   bind(SCAN_TO_SUBSTR);
   assert(cnt1 == rdx && cnt2 == rax && tmp == rcx, "pcmpestri");
-  pcmpestri(vec, Address(result, 0), 0x0d);
+  pcmpestri(vec, Address(result, 0), mode);
   jccb(Assembler::below, FOUND_CANDIDATE);   // CF == 1
-  subl(cnt1, 8);
+  subl(cnt1, stride);
   jccb(Assembler::lessEqual, RET_NOT_FOUND); // Scanned full string
   cmpl(cnt1, cnt2);
   jccb(Assembler::negative, RET_NOT_FOUND);  // Left less then substring
   addptr(result, 16);
 
   bind(ADJUST_STR);
-  cmpl(cnt1, 8); // Do not read beyond string
+  cmpl(cnt1, stride); // Do not read beyond string
   jccb(Assembler::greaterEqual, SCAN_TO_SUBSTR);
   // Back-up string to avoid reading beyond string.
-  lea(result, Address(result, cnt1, Address::times_2, -16));
-  movl(cnt1, 8);
+  lea(result, Address(result, cnt1, scale, -16));
+  movl(cnt1, stride);
   jmpb(SCAN_TO_SUBSTR);
 
   // Found a potential substr
@@ -6648,7 +6668,7 @@ void MacroAssembler::string_indexof(Register str1, Register str2,
 
   bind(FOUND_SUBSTR);
   // Compute start addr of substr
-  lea(result, Address(result, tmp, Address::times_2));
+  lea(result, Address(result, tmp, scale));
 
   if (int_cnt2 > 0) { // Constant substring
     // Repeat search for small substring (< 8 chars)
@@ -6662,12 +6682,12 @@ void MacroAssembler::string_indexof(Register str1, Register str2,
 
     addl(tmp, cnt2);
     // Found result if we matched whole substring.
-    cmpl(tmp, 8);
+    cmpl(tmp, stride);
     jccb(Assembler::lessEqual, RET_FOUND);
 
     // Repeat search for small substring (<= 8 chars)
     // from new point 'str1' without reloading substring.
-    cmpl(cnt2, 8);
+    cmpl(cnt2, stride);
     // Have to check that we don't read beyond string.
     jccb(Assembler::lessEqual, ADJUST_STR);
 
@@ -6680,24 +6700,24 @@ void MacroAssembler::string_indexof(Register str1, Register str2,
     jccb(Assembler::equal, CHECK_NEXT);
 
     bind(SCAN_SUBSTR);
-    pcmpestri(vec, Address(str1, 0), 0x0d);
+    pcmpestri(vec, Address(str1, 0), mode);
     // Need to reload strings pointers if not matched whole vector
     jcc(Assembler::noOverflow, RELOAD_SUBSTR); // OF == 0
 
     bind(CHECK_NEXT);
-    subl(cnt2, 8);
+    subl(cnt2, stride);
     jccb(Assembler::lessEqual, RET_FOUND_LONG); // Found full substring
     addptr(str1, 16);
     addptr(str2, 16);
-    subl(cnt1, 8);
-    cmpl(cnt2, 8); // Do not read beyond substring
+    subl(cnt1, stride);
+    cmpl(cnt2, stride); // Do not read beyond substring
     jccb(Assembler::greaterEqual, CONT_SCAN_SUBSTR);
     // Back-up strings to avoid reading beyond substring.
-    lea(str2, Address(str2, cnt2, Address::times_2, -16));
-    lea(str1, Address(str1, cnt2, Address::times_2, -16));
+    lea(str2, Address(str2, cnt2, scale, -16));
+    lea(str1, Address(str1, cnt2, scale, -16));
     subl(cnt1, cnt2);
-    movl(cnt2, 8);
-    addl(cnt1, 8);
+    movl(cnt2, stride);
+    addl(cnt1, stride);
     bind(CONT_SCAN_SUBSTR);
     movdqu(vec, Address(str2, 0));
     jmpb(SCAN_SUBSTR);
@@ -6709,17 +6729,28 @@ void MacroAssembler::string_indexof(Register str1, Register str2,
   bind(RET_FOUND);
   // Compute substr offset
   subptr(result, str1);
-  shrl(result, 1); // index
+  if (!latin1) {
+    shrl(result, 1); // index
+  }
 
   bind(CLEANUP);
   pop(rsp); // restore SP
 
 } // string_indexof
 
-// Compare strings.
+// Load an unsigned String element: a byte for Latin-1, else a char.
+void MacroAssembler::load_string_element(Register dst, Address src, bool latin1) {
+  if (latin1) {
+    load_unsigned_byte(dst, src);
+  } else {
+    load_unsigned_short(dst, src);
+  }
+}
+
+// Compare strings, both either UTF-16 (char[]) or Latin-1 (byte[]).
 void MacroAssembler::string_compare(Register str1, Register str2,
                                     Register cnt1, Register cnt2, Register result,
-                                    XMMRegister vec1) {
+                                    XMMRegister vec1, bool latin1) {
   ShortBranchVerifier sbv(this);
   Label LENGTH_DIFF_LABEL, POP_LABEL, DONE_LABEL, WHILE_HEAD_LABEL;
 
@@ -6736,8 +6767,8 @@ void MacroAssembler::string_compare(Register str1, Register str2,
   jcc(Assembler::zero, LENGTH_DIFF_LABEL);
 
   // Compare first characters
-  load_unsigned_short(result, Address(str1, 0));
-  load_unsigned_short(cnt1, Address(str2, 0));
+  load_string_element(result, Address(str1, 0), latin1);
+  load_string_element(cnt1, Address(str2, 0), latin1);
   subl(result, cnt1);
   jcc(Assembler::notZero,  POP_LABEL);
   cmpl(cnt2, 1);
@@ -6747,18 +6778,19 @@ void MacroAssembler::string_compare(Register str1, Register str2,
   cmpptr(str1, str2);
   jcc(Assembler::equal, LENGTH_DIFF_LABEL);
 
-  Address::ScaleFactor scale = Address::times_2;
-  int stride = 8;
+  // Vectors hold 8 chars or 16 Latin-1 bytes
+  Address::ScaleFactor scale = latin1 ? Address::times_1 : Address::times_2;
+  int stride = latin1 ? 16 : 8;
 
   if (UseAVX >= 2 && UseSSE42Intrinsics) {
     Label COMPARE_WIDE_VECTORS, VECTOR_NOT_EQUAL, COMPARE_WIDE_TAIL, COMPARE_SMALL_STR;
     Label COMPARE_WIDE_VECTORS_LOOP, COMPARE_16_CHARS, COMPARE_INDEX_CHAR;
     Label COMPARE_TAIL_LONG;
-    int pcmpmask = 0x19;
+    int pcmpmask = latin1 ? 0x18 : 0x19;
 
     // Setup to compare 16-chars (32-bytes) vectors,
     // start from first character again because it has aligned address.
-    int stride2 = 16;
+    int stride2 = stride * 2;
     int adr_stride  = stride  << scale;
     int adr_stride2 = stride2 << scale;
 
@@ -6781,8 +6813,8 @@ void MacroAssembler::string_compare(Register str1, Register str2,
 
     // Compare the characters at index in cnt1
     bind(COMPARE_INDEX_CHAR); //cnt1 has the offset of the mismatching character
-    load_unsigned_short(result, Address(str1, cnt1, scale));
-    load_unsigned_short(cnt2, Address(str2, cnt1, scale));
+    load_string_element(result, Address(str1, cnt1, scale), latin1);
+    load_string_element(cnt2, Address(str2, cnt1, scale), latin1);
     subl(result, cnt2);
     jmp(POP_LABEL);
 
@@ -6844,7 +6876,7 @@ void MacroAssembler::string_compare(Register str1, Register str2,
     bind(COMPARE_SMALL_STR);
   } else if (UseSSE42Intrinsics) {
     Label COMPARE_WIDE_VECTORS, VECTOR_NOT_EQUAL, COMPARE_TAIL;
-    int pcmpmask = 0x19;
+    int pcmpmask = latin1 ? 0x18 : 0x19;
     // Setup to compare 8-char (16-byte) vectors,
     // start from first character again because it has aligned address.
     movl(result, cnt2);
@@ -6891,8 +6923,8 @@ void MacroAssembler::string_compare(Register str1, Register str2,
     // Mismatched characters in the vectors
     bind(VECTOR_NOT_EQUAL);
     addptr(cnt1, result);
-    load_unsigned_short(result, Address(str1, cnt1, scale));
-    load_unsigned_short(cnt2, Address(str2, cnt1, scale));
+    load_string_element(result, Address(str1, cnt1, scale), latin1);
+    load_string_element(cnt2, Address(str2, cnt1, scale), latin1);
     subl(result, cnt2);
     jmpb(POP_LABEL);
 
@@ -6908,8 +6940,8 @@ void MacroAssembler::string_compare(Register str1, Register str2,
 
   // Compare the rest of the elements
   bind(WHILE_HEAD_LABEL);
-  load_unsigned_short(result, Address(str1, cnt2, scale, 0));
-  load_unsigned_short(cnt1, Address(str2, cnt2, scale, 0));
+  load_string_element(result, Address(str1, cnt2, scale, 0), latin1);
+  load_string_element(cnt1, Address(str2, cnt2, scale, 0), latin1);
   subl(result, cnt1);
   jccb(Assembler::notZero, POP_LABEL);
   increment(cnt2);
@@ -6928,15 +6960,15 @@ void MacroAssembler::string_compare(Register str1, Register str2,
   bind(DONE_LABEL);
 }
 
-// Compare char[] arrays aligned to 4 bytes or substrings.
-void MacroAssembler::char_arrays_equals(bool is_array_equ, Register ary1, Register ary2,
-                                        Register limit, Register result, Register chr,
-                                        XMMRegister vec1, XMMRegister vec2) {
+// Compare char[] or byte[] arrays aligned to 4 bytes or substrings.
+void MacroAssembler::arrays_equals(bool is_array_equ, Register ary1, Register ary2,
+                                   Register limit, Register result, Register chr,
+                                   XMMRegister vec1, XMMRegister vec2, bool is_char) {
   ShortBranchVerifier sbv(this);
-  Label TRUE_LABEL, FALSE_LABEL, DONE, COMPARE_VECTORS, COMPARE_CHAR;
+  Label TRUE_LABEL, FALSE_LABEL, DONE, COMPARE_VECTORS, COMPARE_CHAR, COMPARE_BYTE;
 
   int length_offset  = arrayOopDesc::length_offset_in_bytes();
-  int base_offset    = arrayOopDesc::base_offset_in_bytes(T_CHAR);
+  int base_offset    = arrayOopDesc::base_offset_in_bytes(is_char ? T_CHAR : T_BYTE);
 
   // Check the input args
   cmpptr(ary1, ary2);
@@ -6965,7 +6997,9 @@ void MacroAssembler::char_arrays_equals(bool is_array_equ, Register ary1, Regist
     lea(ary2, Address(ary2, base_offset));
   }
 
-  shll(limit, 1);      // byte count != 0
+  if (is_char) {
+    shll(limit, 1);      // byte count != 0
+  }
   movl(result, limit); // copy
 
   if (UseAVX >= 2) {
@@ -6973,7 +7007,7 @@ void MacroAssembler::char_arrays_equals(bool is_array_equ, Register ary1, Regist
     Label COMPARE_WIDE_VECTORS, COMPARE_TAIL;
 
     // Compare 32-byte vectors
-    andl(result, 0x0000001e);  //   tail count (in bytes)
+    andl(result, is_char ? 0x0000001e : 0x0000001f);  //   tail count (in bytes)
     andl(limit, 0xffffffe0);   // vector count (in bytes)
     jccb(Assembler::zero, COMPARE_TAIL);
 
@@ -7010,7 +7044,7 @@ void MacroAssembler::char_arrays_equals(bool is_array_equ, Register ary1, Regist
     Label COMPARE_WIDE_VECTORS, COMPARE_TAIL;
 
     // Compare 16-byte vectors
-    andl(result, 0x0000000e);  //   tail count (in bytes)
+    andl(result, is_char ? 0x0000000e : 0x0000000f);  //   tail count (in bytes)
     andl(limit, 0xfffffff0);   // vector count (in bytes)
     jccb(Assembler::zero, COMPARE_TAIL);
 
@@ -7062,12 +7096,25 @@ void MacroAssembler::char_arrays_equals(bool is_array_equ, Register ary1, Regist
   // Compare trailing char (final 2 bytes), if any
   bind(COMPARE_CHAR);
   testl(result, 0x2);   // tail  char
-  jccb(Assembler::zero, TRUE_LABEL);
+  jccb(Assembler::zero, is_char ? TRUE_LABEL : COMPARE_BYTE);
   load_unsigned_short(chr, Address(ary1, 0));
   load_unsigned_short(limit, Address(ary2, 0));
   cmpl(chr, limit);
   jccb(Assembler::notEqual, FALSE_LABEL);
 
+  if (!is_char) {
+    // Compare trailing byte, if any
+    addptr(ary1, 2);
+    addptr(ary2, 2);
+    bind(COMPARE_BYTE);
+    testl(result, 0x1);   // tail  byte
+    jccb(Assembler::zero, TRUE_LABEL);
+    load_unsigned_byte(chr, Address(ary1, 0));
+    load_unsigned_byte(limit, Address(ary2, 0));
+    cmpl(chr, limit);
+    jccb(Assembler::notEqual, FALSE_LABEL);
+  }
+
   bind(TRUE_LABEL);
   movl(result, 1);   // return true
   jmpb(DONE);
@@ -7414,6 +7461,77 @@ void MacroAssembler::encode_iso_array(Register src, Register dst, Register len,
   bind(L_done);
 }
 
+// inflate Latin-1 byte[] to char[]
+void MacroAssembler::byte_array_inflate(Register src, Register dst, Register len,
+                                        XMMRegister tmp1, Register tmp2) {
+  // rsi: src
+  // rdi: dst
+  // rdx: len
+  // rcx: tmp2
+  ShortBranchVerifier sbv(this);
+  assert_different_registers(src, dst, len, tmp2);
+  Label L_copy_1_char, L_done;
+
+  movl(tmp2, len);
+  if (UseSSE42Intrinsics) {
+    Label L_copy_8_chars, L_copy_tail;
+
+    if (UseAVX >= 2) {
+      Label L_copy_16_chars, L_copy_16_chars_exit;
+      andl(tmp2, 0x0000000f);    // tail count (in chars)
+      andl(len, 0xfffffff0);     // vector count (in chars)
+      jccb(Assembler::zero, L_copy_16_chars_exit);
+
+      lea(src, Address(src, len, Address::times_1));
+      lea(dst, Address(dst, len, Address::times_2));
+      negptr(len);
+
+      // zero extend 16 bytes into 16 chars (32 bytes) at once
+      bind(L_copy_16_chars);
+      vpmovzxbw(tmp1, Address(src, len, Address::times_1), /* vector256 */ true);
+      vmovdqu(Address(dst, len, Address::times_2), tmp1);
+      addptr(len, 16);
+      jccb(Assembler::notZero, L_copy_16_chars);
+      // clean upper bits of YMM registers
+      vpxor(tmp1, tmp1);
+
+      bind(L_copy_16_chars_exit);
+      movl(len, tmp2);
+    }
+
+    andl(tmp2, 0x00000007);    // tail count (in chars)
+    andl(len, 0xfffffff8);     // vector count (in chars)
+    jccb(Assembler::zero, L_copy_tail);
+
+    lea(src, Address(src, len, Address::times_1));
+    lea(dst, Address(dst, len, Address::times_2));
+    negptr(len);
+
+    bind(L_copy_8_chars);
+    pmovzxbw(tmp1, Address(src, len, Address::times_1));
+    movdqu(Address(dst, len, Address::times_2), tmp1);
+    addptr(len, 8);
+    jccb(Assembler::notZero, L_copy_8_chars);
+
+    bind(L_copy_tail);
+    movl(len, tmp2);
+  }
+
+  testl(len, len);
+  jccb(Assembler::zero, L_done);
+  lea(src, Address(src, len, Address::times_1));
+  lea(dst, Address(dst, len, Address::times_2));
+  negptr(len);
+
+  bind(L_copy_1_char);
+  load_unsigned_byte(tmp2, Address(src, len, Address::times_1));
+  movw(Address(dst, len, Address::times_2), tmp2);
+  increment(len);
+  jccb(Assembler::notZero, L_copy_1_char);
+
+  bind(L_done);
+}
+
 #ifdef _LP64
 /**
  * Helper for multiply_to_len().
@@ -2961,6 +2961,7 @@ void TemplateTable::prepare_invoke(int byte_no,
     assert(ConstantPoolCacheEntry::_indy_resolved_references_appendix_offset == 0, "appendix expected at index+0");
     __ load_resolved_reference_at_index(index, rbx);
     __ pop(rbx);
+    __ verify_oop(index);
     __ push(index);  // push appendix (MethodType, CallSite, etc.)
     __ bind(L_no_push);
   }
@@ -3251,15 +3252,14 @@ void TemplateTable::invokedynamic(int byte_no) {
   // rax: CallSite object (from cpool->resolved_references[f1])
   // rbx: MH.linkToCallSite method (from f2)
 
-  // Note:  rax_callsite is already pushed by prepare_invoke
+  // Note:  rax_callsite is already pushed by prepare_invoke, unless the
+  //        call site is linked directly to the target of a constant call site
 
   // %%% should make a type profile for any invokedynamic that takes a ref argument
   // profile this call
   __ profile_call(rsi);
   __ profile_arguments_type(rdx, rbx, rsi, false);
 
-  __ verify_oop(rax_callsite);
-
   __ jump_from_interpreted(rbx_method, rdx);
 }
 
@@ -3307,8 +3307,11 @@ void TemplateTable::_new() {
   // 3) if the above fails (or is not applicable), go to a slow case
   // (creates a new TLAB, etc.)
 
+  // With allocation site sampling a TLAB miss may be a sample point, which
+  // has to reach the slow case.
   const bool allow_shared_alloc =
-    Universe::heap()->supports_inline_contig_alloc() && !CMSIncrementalMode;
+    Universe::heap()->supports_inline_contig_alloc() && !CMSIncrementalMode &&
+    AllocationSiteSamplingInterval == 0;
 
   const Register thread = rcx;
   if (UseTLAB || allow_shared_alloc) {
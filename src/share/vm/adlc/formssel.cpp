@@ -889,9 +889,11 @@ uint InstructForm::oper_input_base(FormDict &globals) {
         strcmp(_matrule->_rChild->_opType,"StrComp"   )==0 ||
         strcmp(_matrule->_rChild->_opType,"StrEquals" )==0 ||
         strcmp(_matrule->_rChild->_opType,"StrIndexOf")==0 ||
-        strcmp(_matrule->_rChild->_opType,"EncodeISOArray")==0)) {
+        strcmp(_matrule->_rChild->_opType,"EncodeISOArray")==0 ||
+        strcmp(_matrule->_rChild->_opType,"StrInflatedCopy")==0)) {
         // String.(compareTo/equals/indexOf) and Arrays.equals
         // and sun.nio.cs.iso8859_1$Encoder.EncodeISOArray
+        // and StringLatin1.inflate
         // take 1 control and 1 memory edges.
     return 2;
   }
@@ -4138,6 +4140,8 @@ bool MatchRule::is_vector() const {
     "SubVB","SubVS","SubVI","SubVL","SubVF","SubVD",
     "MulVS","MulVI","MulVF","MulVD",
     "DivVF","DivVD",
+    "AddReductionVI","AddReductionVL","AddReductionVF","AddReductionVD",
+    "MulReductionVI","MulReductionVF","MulReductionVD",
     "AndV" ,"XorV" ,"OrV",
     "LShiftCntV","RShiftCntV",
     "LShiftVB","LShiftVS","LShiftVI","LShiftVL",
@@ -879,6 +879,7 @@ JRT_ENTRY(void, Runtime1::patch_code(JavaThread* thread, Runtime1::StubID stub_i
   BasicType patch_field_type = T_ILLEGAL;
 #endif // PRODUCT
   bool deoptimize_for_volatile = false;
+  bool deoptimize_for_direct_call_site = false;
   int patch_field_offset = -1;
   KlassHandle init_klass(THREAD, NULL); // klass needed by load_klass_patching code
   KlassHandle load_klass(THREAD, NULL); // klass needed by load_klass_patching code
@@ -974,7 +975,11 @@ JRT_ENTRY(void, Runtime1::patch_code(JavaThread* thread, Runtime1::StubID stub_i
         break;
       }
       case Bytecodes::_invokedynamic: {
-        pool->invokedynamic_cp_cache_entry_at(index)->set_dynamic_call(pool, info);
+        ConstantPoolCacheEntry* cpce = pool->invokedynamic_cp_cache_entry_at(index);
+        cpce->set_dynamic_call(pool, info);
+        // The code was compiled to pass an appendix, which a call site linked
+        // directly to its target (DirectLinkConstantCallSites) does not take.
+        deoptimize_for_direct_call_site = !cpce->has_appendix();
         break;
       }
       default: fatal("unexpected bytecode for load_appendix_patching_id");
@@ -983,12 +988,13 @@ JRT_ENTRY(void, Runtime1::patch_code(JavaThread* thread, Runtime1::StubID stub_i
     ShouldNotReachHere();
   }
 
-  if (deoptimize_for_volatile) {
+  if (deoptimize_for_volatile || deoptimize_for_direct_call_site) {
     // At compile time we assumed the field wasn't volatile but after
     // loading it turns out it was volatile so we have to throw the
     // compiled code out and let it be regenerated.
     if (TracePatching) {
-      tty->print_cr("Deoptimizing for patching volatile field reference");
+      tty->print_cr(deoptimize_for_volatile ? "Deoptimizing for patching volatile field reference"
+                                            : "Deoptimizing for patching directly linked call site");
     }
     // It's possible the nmethod was invalidated in the last
     // safepoint, but if it's still alive then make it not_entrant.
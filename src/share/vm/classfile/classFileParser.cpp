@@ -64,6 +64,7 @@
 #include "utilities/array.hpp"
 #include "utilities/globalDefinitions.hpp"
 #include "utilities/ostream.hpp"
+#include "utilities/sha256.hpp"
 
 // We generally try to create the oops directly when parsing, rather than
 // allocating temporary data structures and copying the bytes twice. A
@@ -4277,12 +4278,18 @@ instanceKlassHandle ClassFileParser::parseClassFile(Symbol* name,
   instanceKlassHandle this_klass (THREAD, preserve_this_klass);
   debug_only(this_klass->verify();)
 
-  if (CompilationWarmUp || CompilationWarmUpRecording) {
+  if (CompilationWarmUp || CompilationWarmUpRecording || VerificationCacheFile != NULL) {
     unsigned int crc32 = ClassLoader::crc32(0, (char*)(_stream->buffer()), _stream->length());
     unsigned int class_bytes_size = _stream->length();
     this_klass->set_crc32(crc32);
     this_klass->set_bytes_size(class_bytes_size);
   }
+  if (VerificationCacheFile != NULL) {
+    // The verification cache must not trust a checksum that can be forged
+    u1* digest = NEW_C_HEAP_ARRAY(u1, SHA256::digest_length, mtClass);
+    SHA256::digest(_stream->buffer(), _stream->length(), digest);
+    this_klass->set_bytes_digest(digest);
+  }
 
   // Clear class if no error has occurred so destructor doesn't deallocate it
   _klass = NULL;
@@ -59,14 +59,29 @@
 #include "memory/oopFactory.hpp"
 #include "runtime/jniHandles.hpp"
 #include "runtime/mutex.hpp"
+#include "runtime/mutexLocker.hpp"
 #include "runtime/safepoint.hpp"
 #include "runtime/synchronizer.hpp"
+#include "runtime/sweeper.hpp"
+#include "services/allocationSampler.hpp"
 #include "utilities/growableArray.hpp"
 #include "utilities/macros.hpp"
 #include "utilities/ostream.hpp"
+#include "utilities/resourceHash.hpp"
+#include "utilities/workgroup.hpp"
+#if INCLUDE_ALL_GCS
+#include "gc_implementation/g1/g1SATBCardTableModRefBS.hpp"
+#endif // INCLUDE_ALL_GCS
 
 ClassLoaderData * ClassLoaderData::_the_null_class_loader_data = NULL;
 
+// The open anonymous class arena of each host class. Arenas are removed
+// when they are full or unloaded, guarded by AnonymousClassArena_lock.
+typedef ResourceHashtable<Klass*, ClassLoaderData*,
+                          primitive_hash<Klass*>, primitive_equals<Klass*>,
+                          1031, ResourceObj::C_HEAP, mtClass> AnonymousClassArenaTable;
+static AnonymousClassArenaTable* _anonymous_class_arenas = NULL;
+
 ClassLoaderData::ClassLoaderData(Handle h_class_loader, bool is_anonymous, Dependencies dependencies) :
   _class_loader(h_class_loader()),
   _is_anonymous(is_anonymous),
@@ -74,6 +89,7 @@ ClassLoaderData::ClassLoaderData(Handle h_class_loader, bool is_anonymous, Depen
   // it from being unloaded during parsing of the anonymous class.
   // The null-class-loader should always be kept alive.
   _keep_alive(is_anonymous || h_class_loader.is_null()),
+  _arena_host(NULL),
   _metaspace(NULL), _unloading(false), _klasses(NULL),
   _claimed(0), _jmethod_ids(NULL), _handles(), _deallocate_list(NULL),
   _next(NULL), _dependencies(dependencies),
@@ -342,6 +358,15 @@ void ClassLoaderData::remove_class(Klass* scratch_class) {
 void ClassLoaderData::unload() {
   _unloading = true;
 
+  if (is_anonymous_class_arena()) {
+    // Nobody may define classes in it any more
+    MutexLockerEx ml(AnonymousClassArena_lock, Mutex::_no_safepoint_check_flag);
+    ClassLoaderData** open = _anonymous_class_arenas->get(_arena_host);
+    if (open != NULL && *open == this) {
+      _anonymous_class_arenas->remove(_arena_host);
+    }
+  }
+
   // Tell serviceability tools these classes are unloading
   classes_do(InstanceKlass::notify_unload_class);
 
@@ -359,14 +384,41 @@ void ClassLoaderData::unload() {
 
 oop ClassLoaderData::keep_alive_object() const {
   assert(!keep_alive(), "Don't use with CLDs that are artificially kept alive");
-  return is_anonymous() ? _klasses->java_mirror() : class_loader();
+  return is_anonymous() ? anonymous_mirror() : class_loader();
+}
+
+oop ClassLoaderData::anonymous_mirror() const {
+  assert(is_anonymous(), "only anonymous classes are kept alive by their mirror");
+  // An arena can also hold classes whose definition failed before their
+  // mirror was created.
+  for (Klass* k = _klasses; k != NULL; k = k->next_link()) {
+    if (k->java_mirror() != NULL) {
+      return k->java_mirror();
+    }
+  }
+  return NULL;
 }
 
 bool ClassLoaderData::is_alive(BoolObjectClosure* is_alive_closure) const {
-  bool alive = keep_alive() // null class loader and incomplete anonymous klasses.
-      || is_alive_closure->do_object_b(keep_alive_object());
+  if (keep_alive()) {
+    // null class loader and incomplete anonymous klasses.
+    return true;
+  }
+  if (_unloading) {
+    // Already found dead, its class loader may have been reclaimed since.
+    return false;
+  }
+  oop o = keep_alive_object();
+  return o != NULL && is_alive_closure->do_object_b(o);
+}
 
-  return alive;
+void ClassLoaderData::inc_keep_alive() {
+  Atomic::inc(&_keep_alive);
+}
+
+void ClassLoaderData::dec_keep_alive() {
+  assert(_keep_alive > 0, "invariant");
+  Atomic::dec(&_keep_alive);
 }
 
 
@@ -489,6 +541,56 @@ ClassLoaderData* ClassLoaderData::anonymous_class_loader_data(oop loader, TRAPS)
   return ClassLoaderDataGraph::add(loader, true, THREAD);
 }
 
+ClassLoaderData* ClassLoaderData::anonymous_class_arena_data(KlassHandle host_klass, TRAPS) {
+  assert(UseAnonymousClassArena, "sanity");
+  ClassLoaderData* open_arena = NULL;
+  {
+    MutexLockerEx ml(AnonymousClassArena_lock, Mutex::_no_safepoint_check_flag);
+    if (_anonymous_class_arenas == NULL) {
+      _anonymous_class_arenas = new (ResourceObj::C_HEAP, mtClass) AnonymousClassArenaTable();
+    }
+    ClassLoaderData** open = _anonymous_class_arenas->get(host_klass());
+    if (open != NULL) {
+      Metaspace* ms = (*open)->metaspace_or_null();
+      if (ms == NULL || ms->allocated_chunks_bytes() < AnonymousClassArenaSize) {
+        open_arena = *open;
+        open_arena->inc_keep_alive();
+      } else {
+        // Full, its classes keep it alive from now on
+        _anonymous_class_arenas->remove(host_klass());
+      }
+    }
+  }
+
+  if (open_arena != NULL) {
+#if INCLUDE_ALL_GCS
+    // The classes of the arena may be unreachable already. Concurrent
+    // marking must not miss them now that they are in use again.
+    if (UseG1GC) {
+      oop mirror = open_arena->anonymous_mirror();
+      if (mirror != NULL) {
+        G1SATBCardTableModRefBS::enqueue(mirror);
+      }
+    }
+#endif // INCLUDE_ALL_GCS
+    return open_arena;
+  }
+
+  // Kept alive by the constructor until the first class is defined
+  ClassLoaderData* cld = ClassLoaderDataGraph::add(Handle(THREAD, host_klass->class_loader()), true, CHECK_NULL);
+  cld->_arena_host = host_klass();
+  {
+    MutexLockerEx ml(AnonymousClassArena_lock, Mutex::_no_safepoint_check_flag);
+    _anonymous_class_arenas->put(host_klass(), cld);
+  }
+  if (TraceClassLoaderData) {
+    ResourceMark rm;
+    tty->print_cr("[ClassLoaderData: create anonymous class arena " INTPTR_FORMAT " for host %s]",
+                  p2i(cld), host_klass->external_name());
+  }
+  return cld;
+}
+
 const char* ClassLoaderData::loader_name() {
   // Handles null class loader
   return SystemDictionary::loader_name(class_loader());
@@ -566,6 +668,7 @@ ClassLoaderData* ClassLoaderDataGraph::_saved_unloading = NULL;
 ClassLoaderData* ClassLoaderDataGraph::_saved_head = NULL;
 
 bool ClassLoaderDataGraph::_should_purge = false;
+ClassLoaderData* volatile ClassLoaderDataGraph::_free_pending = NULL;
 
 // Add a new class loader data node to the list.  Assign the newly created
 // ClassLoaderData into the java/lang/ClassLoader object as a hidden field
@@ -748,13 +851,69 @@ bool ClassLoaderDataGraph::contains_loader_data(ClassLoaderData* loader_data) {
 }
 #endif // PRODUCT
 
+// Determines the liveness of a snapshot of the class loader data graph.
+// The workers claim strides of the snapshot, the unlinking is left to the
+// VM thread because unloading posts the JVMTI class unload events.
+class CLDLivenessTask : public AbstractGangTask {
+  BoolObjectClosure* _is_alive;
+  ClassLoaderData**  _clds;
+  bool*              _alive;
+  jint               _length;
+  volatile jint      _claimed;
+
+  enum { ClaimStride = 16 };
+
+ public:
+  CLDLivenessTask(BoolObjectClosure* is_alive, ClassLoaderData** clds, bool* alive, jint length) :
+      AbstractGangTask("CLD Liveness"),
+      _is_alive(is_alive),
+      _clds(clds),
+      _alive(alive),
+      _length(length),
+      _claimed(0) {
+  }
+
+  void work(uint worker_id) {
+    while (true) {
+      jint start = Atomic::add(ClaimStride, &_claimed) - ClaimStride;
+      if (start >= _length) {
+        return;
+      }
+      jint end = MIN2(start + (jint)ClaimStride, _length);
+      for (jint i = start; i < end; i++) {
+        _alive[i] = _clds[i]->is_alive(_is_alive);
+      }
+    }
+  }
+};
+
 // Move class loader data from main list to the unloaded list for unloading
 // and deallocation later.
-bool ClassLoaderDataGraph::do_unloading(BoolObjectClosure* is_alive_closure, bool clean_alive) {
+bool ClassLoaderDataGraph::do_unloading(BoolObjectClosure* is_alive_closure, bool clean_alive,
+                                        WorkGang* workers) {
+  ResourceMark rm;
   ClassLoaderData* data = _head;
   ClassLoaderData* prev = NULL;
   bool seen_dead_loader = false;
 
+  // With many class loaders, split the liveness checks across the workers.
+  bool* alive = NULL;
+  jint index = 0;
+  if (ParallelClassUnloading && workers != NULL && workers->active_workers() > 1) {
+    jint length = 0;
+    for (ClassLoaderData* cld = _head; cld != NULL; cld = cld->next()) {
+      length++;
+    }
+    ClassLoaderData** clds = NEW_RESOURCE_ARRAY(ClassLoaderData*, length);
+    alive = NEW_RESOURCE_ARRAY(bool, length);
+    for (ClassLoaderData* cld = _head; cld != NULL; cld = cld->next()) {
+      clds[index++] = cld;
+    }
+    index = 0;
+    CLDLivenessTask task(is_alive_closure, clds, alive, length);
+    workers->run_task(&task);
+  }
+
   // Unload PreloadClassChain
   if (CompilationWarmUp) {
     JitWarmUp* jwp = JitWarmUp::instance();
@@ -768,7 +927,8 @@ bool ClassLoaderDataGraph::do_unloading(BoolObjectClosure* is_alive_closure, boo
   _saved_unloading = _unloading;
 
   while (data != NULL) {
-    if (data->is_alive(is_alive_closure)) {
+    bool data_alive = alive != NULL ? alive[index++] : data->is_alive(is_alive_closure);
+    if (data_alive) {
       prev = data;
       data = data->next();
       continue;
@@ -799,8 +959,13 @@ bool ClassLoaderDataGraph::do_unloading(BoolObjectClosure* is_alive_closure, boo
 }
 
 void ClassLoaderDataGraph::clean_metaspaces() {
-  // mark metadata seen on the stack and code cache so we can delete unneeded entries.
   bool has_redefined_a_class = JvmtiExport::has_redefined_a_class();
+  if (!has_redefined_a_class && !has_metadata_to_deallocate()) {
+    // Nothing to free, don't walk the thread stacks for on stack metadata.
+    return;
+  }
+
+  // mark metadata seen on the stack and code cache so we can delete unneeded entries.
   MetadataOnStackMark md_on_stack(has_redefined_a_class);
 
   if (has_redefined_a_class) {
@@ -822,16 +987,61 @@ void ClassLoaderDataGraph::purge() {
   assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint!");
   ClassLoaderData* list = _unloading;
   _unloading = NULL;
-  ClassLoaderData* next = list;
-  while (next != NULL) {
-    ClassLoaderData* purge_me = next;
-    next = purge_me->next();
-    delete purge_me;
+  if (AllocationSampler::enabled()) {
+    AllocationSiteTable::purge();
+  }
+  if ((ConcurrentClassLoaderDataFree || NMethodSweeper::unloading_cleanup_pending()) && list != NULL) {
+    // Nothing can reach the dead class loader data any more. The service
+    // thread returns their metaspace to the free chunk lists, virtual space
+    // emptied by that is released by the Metaspace::purge() of a later GC.
+    // Inline caches may still refer to the dead classes until the sweeper
+    // has cleaned them, the service thread waits for that.
+    ClassLoaderData* tail = list;
+    while (tail->next() != NULL) {
+      tail = tail->next();
+    }
+    tail->set_next(_free_pending);
+    _free_pending = list;
+    MutexLockerEx ml(Service_lock, Mutex::_no_safepoint_check_flag);
+    Service_lock->notify_all();
+  } else {
+    ClassLoaderData* next = list;
+    while (next != NULL) {
+      ClassLoaderData* purge_me = next;
+      next = purge_me->next();
+      delete purge_me;
+    }
   }
   Metaspace::purge();
 }
 
+bool ClassLoaderDataGraph::has_free_pending() {
+  return _free_pending != NULL && !NMethodSweeper::unloading_cleanup_pending();
+}
+
+// Called by the service thread. It holds off safepoints while in the VM,
+// and CLDs are only added at a safepoint, so _free_pending needs no lock.
+// Free a few at a time so that a pending safepoint is not delayed.
+void ClassLoaderDataGraph::free_pending_clds() {
+  assert(Thread::current()->is_Java_thread() &&
+         ((JavaThread*)Thread::current())->thread_state() == _thread_in_vm, "must be in VM");
+  if (NMethodSweeper::unloading_cleanup_pending()) {
+    // Classes were unloaded again since the service thread was notified.
+    return;
+  }
+  const int batch_size = 16;
+  for (int i = 0; i < batch_size && _free_pending != NULL; i++) {
+    ClassLoaderData* purge_me = _free_pending;
+    _free_pending = purge_me->next();
+    delete purge_me;
+  }
+}
+
 void ClassLoaderDataGraph::free_deallocate_lists() {
+  if (AllocationSampler::enabled()) {
+    // Drop the allocation sites of the methods about to be freed.
+    AllocationSiteTable::purge();
+  }
   for (ClassLoaderData* cld = _head; cld != NULL; cld = cld->next()) {
     // We need to keep this data until InstanceKlass::purge_previous_version has been
     // called on all alive classes. See the comment in ClassLoaderDataGraph::clean_metaspaces.
@@ -845,6 +1055,20 @@ void ClassLoaderDataGraph::free_deallocate_lists() {
   }
 }
 
+bool ClassLoaderDataGraph::has_metadata_to_deallocate() {
+  for (ClassLoaderData* cld = _head; cld != NULL; cld = cld->next()) {
+    if (cld->_deallocate_list != NULL && cld->_deallocate_list->is_nonempty()) {
+      return true;
+    }
+  }
+  for (ClassLoaderData* cld = _unloading; cld != _saved_unloading; cld = cld->next()) {
+    if (cld->_deallocate_list != NULL && cld->_deallocate_list->is_nonempty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 // CDS support
 
 // Global metaspaces for writing information to the shared archive.  When
@@ -52,6 +52,7 @@
 class ClassLoaderData;
 class JNIMethodBlock;
 class Metadebug;
+class WorkGang;
 
 // GC root for walking class loader data created
 
@@ -68,6 +69,8 @@ class ClassLoaderDataGraph : public AllStatic {
   static ClassLoaderData* _saved_head;
   static ClassLoaderData* _saved_unloading;
   static bool _should_purge;
+  // Purged CLDs left for the service thread to free.
+  static ClassLoaderData* volatile _free_pending;
 
   static ClassLoaderData* add(Handle class_loader, bool anonymous, TRAPS);
   static void clean_metaspaces();
@@ -90,7 +93,7 @@ class ClassLoaderDataGraph : public AllStatic {
   static void classes_do(void f(Klass* const));
   static void loaded_classes_do(KlassClosure* klass_closure);
   static void classes_unloading_do(void f(Klass* const));
-  static bool do_unloading(BoolObjectClosure* is_alive, bool clean_alive);
+  static bool do_unloading(BoolObjectClosure* is_alive, bool clean_alive, WorkGang* workers = NULL);
 
   // CMS support.
   static void remember_new_clds(bool remember) { _saved_head = (remember ? _head : NULL); }
@@ -107,6 +110,11 @@ class ClassLoaderDataGraph : public AllStatic {
   }
 
   static void free_deallocate_lists();
+  static bool has_metadata_to_deallocate();
+
+  // ConcurrentClassLoaderDataFree support.
+  static bool has_free_pending();
+  static void free_pending_clds();
 
   static void dump_on(outputStream * const out) PRODUCT_RETURN;
   static void dump() { dump_on(tty); }
@@ -180,8 +188,12 @@ class ClassLoaderData : public CHeapObj<mtClass> {
                            // classes in the class loader are allocated.
   Mutex* _metaspace_lock;  // Locks the metaspace for allocations and setup.
   bool _unloading;         // true if this class loader goes away
-  bool _keep_alive;        // if this CLD is kept alive without a keep_alive_object().
+  volatile int _keep_alive; // if this CLD is kept alive without a keep_alive_object().
+                           // Counts the classes still being defined in an
+                           // anonymous class arena.
   bool _is_anonymous;      // if this CLD is for an anonymous class
+  Klass* _arena_host;      // host class if this CLD is an anonymous class arena
+                           // that the anonymous classes of the host share.
   volatile int _claimed;   // true if claimed, for example during GC traces.
                            // To avoid applying oop closure more than once.
                            // Has to be an int because we cas it.
@@ -220,7 +232,7 @@ class ClassLoaderData : public CHeapObj<mtClass> {
   Mutex* metaspace_lock() const { return _metaspace_lock; }
 
   void unload();
-  bool keep_alive() const       { return _keep_alive; }
+  bool keep_alive() const       { return _keep_alive > 0; }
   void classes_do(void f(Klass*));
   void loaded_classes_do(KlassClosure* klass_closure);
   void classes_do(void f(InstanceKlass*));
@@ -248,6 +260,7 @@ class ClassLoaderData : public CHeapObj<mtClass> {
   }
 
   bool is_anonymous() const { return _is_anonymous; }
+  bool is_anonymous_class_arena() const { return _arena_host != NULL; }
 
   static void init_null_class_loader_data() {
     assert(_the_null_class_loader_data == NULL, "cannot initialize twice");
@@ -275,6 +288,9 @@ class ClassLoaderData : public CHeapObj<mtClass> {
 
   // The object the GC is using to keep this ClassLoaderData alive.
   oop keep_alive_object() const;
+  // The mirror of an anonymous class in this CLD. Any of them keeps
+  // all classes of the CLD alive.
+  oop anonymous_mirror() const;
 
   // Returns true if this class loader data is for a loader going away.
   bool is_unloading() const     {
@@ -283,7 +299,8 @@ class ClassLoaderData : public CHeapObj<mtClass> {
   }
 
   // Used to make sure that this CLD is not unloaded.
-  void set_keep_alive(bool value) { _keep_alive = value; }
+  void inc_keep_alive();
+  void dec_keep_alive();
 
   unsigned int identity_hash() {
     return _class_loader == NULL ? 0 : _class_loader->identity_hash();
@@ -315,6 +332,10 @@ class ClassLoaderData : public CHeapObj<mtClass> {
   static ClassLoaderData* class_loader_data(oop loader);
   static ClassLoaderData* class_loader_data_or_null(oop loader);
   static ClassLoaderData* anonymous_class_loader_data(oop loader, TRAPS);
+  // The open anonymous class arena of host_klass, a new one if there is
+  // none or it is full. The caller has to dec_keep_alive() it once the
+  // anonymous class is defined.
+  static ClassLoaderData* anonymous_class_arena_data(KlassHandle host_klass, TRAPS);
   static void print_loader(ClassLoaderData *loader_data, outputStream *out);
 
   // CDS support
@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "precompiled.hpp"
+#include "classfile/classPreloader.hpp"
+#include "classfile/symbolTable.hpp"
+#include "classfile/systemDictionary.hpp"
+#include "classfile/vmSymbols.hpp"
+#include "jwarmup/jitWarmUp.hpp"
+#include "memory/resourceArea.hpp"
+#include "oops/instanceKlass.hpp"
+#include "runtime/atomic.inline.hpp"
+#include "runtime/handles.inline.hpp"
+#include "runtime/java.hpp"
+#include "runtime/javaCalls.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/os.hpp"
+#include "runtime/thread.inline.hpp"
+
+// the number of requests a thread claims at a time
+const int PreloadClaimChunkSize = 8;
+
+GrowableArray<ClassPreloader::Request>* ClassPreloader::_requests = NULL;
+volatile jint ClassPreloader::_next = 0;
+volatile jint ClassPreloader::_active_threads = 0;
+volatile jint ClassPreloader::_loaded = 0;
+volatile jint ClassPreloader::_failed = 0;
+jlong ClassPreloader::_start_time = 0;
+
+void ClassPreloader::add_request(const char* name, Loader loader, TRAPS) {
+  // Accept both the internal and the external form of the name
+  char* internal_name = os::strdup(name, mtClass);
+  for (char* p = internal_name; *p != '\0'; p++) {
+    if (*p == '.') {
+      *p = '/';
+    }
+  }
+  // The symbol keeps its reference until the preloading is done
+  Symbol* sym = SymbolTable::new_symbol(internal_name, THREAD);
+  os::free(internal_name, mtClass);
+  if (HAS_PENDING_EXCEPTION) {
+    CLEAR_PENDING_EXCEPTION;
+    return;
+  }
+  _requests->append(Request(sym, loader));
+}
+
+void ClassPreloader::read_class_list(const char* path, TRAPS) {
+  FILE* file = fopen(path, "r");
+  if (file == NULL) {
+    char errmsg[JVM_MAXPATHLEN];
+    os::lasterror(errmsg, JVM_MAXPATHLEN);
+    warning("Cannot read ClassPreloadList %s: %s", path, errmsg);
+    return;
+  }
+  char class_name[256];
+  while ((fgets(class_name, sizeof class_name, file)) != NULL) {
+    // Remove trailing newline and white space
+    size_t name_len = strlen(class_name);
+    while (name_len > 0 && isspace((unsigned char)class_name[name_len - 1])) {
+      class_name[--name_len] = '\0';
+    }
+    if (name_len == 0 || *class_name == '#') { // empty line or comment
+      continue;
+    }
+    add_request(class_name, any_loader, CHECK);
+  }
+  fclose(file);
+}
+
+// The JWarmUp record lists the classes in initialization order, with the
+// name of their loader. Only the classes of the boot and the system class
+// loader can be found by name.
+void ClassPreloader::add_jwarmup_classes(TRAPS) {
+  JitWarmUp* jwp = JitWarmUp::instance();
+  if (jwp == NULL || !jwp->is_valid() || jwp->preloader() == NULL) {
+    return;
+  }
+  PreloadClassChain* chain = jwp->preloader()->chain();
+  if (chain == NULL) {
+    return;
+  }
+  oop system_loader = SystemDictionary::java_system_loader();
+  // Loader names are recorded like JitWarmUp::get_class_loader_name() does
+  Symbol* system_loader_name = system_loader != NULL ?
+    PreloadJitInfo::remove_meaningless_suffix(system_loader->klass()->name()) : NULL;
+  ResourceMark rm(THREAD);
+  for (int i = 0; i < chain->length(); i++) {
+    PreloadClassChain::PreloadClassChainEntry* entry = chain->at(i);
+    Symbol* name = entry->class_name();
+    Symbol* loader_name = entry->loader_name();
+    if (name == NULL || loader_name == NULL) {
+      continue;
+    }
+    if (loader_name->equals("NULL", 4)) {
+      add_request(name->as_C_string(), boot_loader, CHECK);
+    } else if (system_loader_name != NULL && loader_name->fast_compare(system_loader_name) == 0) {
+      add_request(name->as_C_string(), any_loader, CHECK);
+    }
+  }
+}
+
+int ClassPreloader::number_of_threads() {
+  if (ClassPreloadThreads != 0) {
+    return (int)MIN2(ClassPreloadThreads, (uintx)_requests->length());
+  }
+  // Leave processors to the application that is starting up
+  int n = MAX2(1, os::active_processor_count() / 2);
+  return MIN2(MIN2(n, 16), _requests->length());
+}
+
+void ClassPreloader::initialize(TRAPS) {
+  if (ClassPreloadList == NULL && !(ClassPreloadFromJWarmUpRecord && CompilationWarmUp)) {
+    return;
+  }
+  _requests = new (ResourceObj::C_HEAP, mtClass) GrowableArray<Request>(1024, true, mtClass);
+  if (ClassPreloadList != NULL) {
+    read_class_list(ClassPreloadList, CHECK);
+  }
+  if (ClassPreloadFromJWarmUpRecord && CompilationWarmUp) {
+    add_jwarmup_classes(CHECK);
+  }
+  if (_requests->is_empty()) {
+    delete _requests;
+    _requests = NULL;
+    return;
+  }
+
+  _start_time = os::javaTimeNanos();
+  int n = number_of_threads();
+  _active_threads = n;
+  for (int i = 0; i < n; i++) {
+    start_thread(i, THREAD);
+    if (HAS_PENDING_EXCEPTION) {
+      // Could not create the thread, the started ones do all the work
+      CLEAR_PENDING_EXCEPTION;
+      for (int j = i; j < n; j++) {
+        thread_done();
+      }
+      return;
+    }
+  }
+}
+
+void ClassPreloader::start_thread(int id, TRAPS) {
+  instanceKlassHandle klass (THREAD, SystemDictionary::Thread_klass());
+  instanceHandle thread_oop = klass->allocate_instance_handle(CHECK);
+
+  char name[64];
+  jio_snprintf(name, sizeof(name), "Class Preload Thread #%d", id);
+  Handle string = java_lang_String::create_from_str(name, CHECK);
+
+  // Initialize thread_oop to put it into the system threadGroup
+  Handle thread_group (THREAD, Universe::system_thread_group());
+  JavaValue result(T_VOID);
+  JavaCalls::call_special(&result, thread_oop,
+                          klass,
+                          vmSymbols::object_initializer_name(),
+                          vmSymbols::threadgroup_string_void_signature(),
+                          thread_group,
+                          string,
+                          CHECK);
+
+  KlassHandle group(THREAD, SystemDictionary::ThreadGroup_klass());
+  JavaCalls::call_special(&result,
+                          thread_group,
+                          group,
+                          vmSymbols::add_method_name(),
+                          vmSymbols::thread_void_signature(),
+                          thread_oop,             // ARG 1
+                          CHECK);
+
+  {
+    MutexLocker mu(Threads_lock);
+    JavaThread* thread = new JavaThread(&preload_thread_entry);
+
+    if (thread == NULL || thread->osthread() == NULL) {
+      THROW_MSG(vmSymbols::java_lang_OutOfMemoryError(),
+                "unable to create new native thread");
+    }
+
+    java_lang_Thread::set_thread(thread_oop(), thread);
+    java_lang_Thread::set_daemon(thread_oop());
+    thread->set_threadObj(thread_oop());
+
+    Threads::add(thread);
+    Thread::start(thread);
+  }
+}
+
+void ClassPreloader::preload_thread_entry(JavaThread* thread, TRAPS) {
+  const int length = _requests->length();
+  while (true) {
+    int start = Atomic::add(PreloadClaimChunkSize, &_next) - PreloadClaimChunkSize;
+    if (start >= length) {
+      break;
+    }
+    int end = MIN2(length, start + PreloadClaimChunkSize);
+    for (int i = start; i < end; i++) {
+      HandleMark hm(THREAD);
+      preload(_requests->at(i), THREAD);
+    }
+  }
+  thread_done();
+}
+
+void ClassPreloader::preload(const Request& request, TRAPS) {
+  Klass* k = SystemDictionary::resolve_or_null(request._name, Handle(), Handle(), THREAD);
+  if (k == NULL && !HAS_PENDING_EXCEPTION && request._loader == any_loader) {
+    Handle system_loader(THREAD, SystemDictionary::java_system_loader());
+    if (system_loader.not_null()) {
+      k = SystemDictionary::resolve_or_null(request._name, system_loader, Handle(), THREAD);
+    }
+  }
+  if (HAS_PENDING_EXCEPTION) {
+    // The application gets the error when it loads the class itself
+    CLEAR_PENDING_EXCEPTION;
+    k = NULL;
+  }
+  if (k != NULL && k->oop_is_instance()) {
+    // Verify and rewrite ahead of the first use
+    InstanceKlass::cast(k)->link_class(THREAD);
+    if (HAS_PENDING_EXCEPTION) {
+      CLEAR_PENDING_EXCEPTION;
+    }
+    Atomic::inc(&_loaded);
+  } else {
+    Atomic::inc(&_failed);
+  }
+}
+
+void ClassPreloader::thread_done() {
+  if (Atomic::add(-1, &_active_threads) != 0) {
+    return;
+  }
+  // The last thread releases the list
+  if (PrintClassPreloadStatistics) {
+    jlong elapsed = os::javaTimeNanos() - _start_time;
+    tty->print_cr("Class preloading: %d classes loaded, %d not found, " JLONG_FORMAT " ms",
+                  _loaded, _failed, elapsed / NANOSECS_PER_MILLISEC);
+  }
+  for (int i = 0; i < _requests->length(); i++) {
+    _requests->at(i)._name->decrement_refcount();
+  }
+  delete _requests;
+  _requests = NULL;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef SHARE_VM_CLASSFILE_CLASSPRELOADER_HPP
+#define SHARE_VM_CLASSFILE_CLASSPRELOADER_HPP
+
+#include "runtime/thread.hpp"
+#include "utilities/growableArray.hpp"
+
+// Loads and links the classes of a class list on a pool of threads at
+// startup, ahead of the application asking for them. The list comes from
+// -XX:ClassPreloadList, in the format written by -XX:DumpLoadedClassList,
+// and from the JWarmUp record with -XX:+ClassPreloadFromJWarmUpRecord.
+//
+// The preload threads go through the normal SystemDictionary resolution, so
+// a class is published into the Dictionary only after its super types, and
+// a thread that needs a class another preload thread is loading waits on
+// its placeholder. Classes are looked up with the boot loader first and
+// then with the system class loader. Failures are dropped: the class is
+// loaded again, and the error thrown, when the application asks for it.
+// The classes are linked but not initialized.
+class ClassPreloader : AllStatic {
+ public:
+  enum Loader {
+    boot_loader,      // boot loader only
+    any_loader        // boot loader, then the system class loader
+  };
+
+ private:
+  struct Request {
+    Symbol* _name;
+    Loader  _loader;
+    Request() : _name(NULL), _loader(any_loader) {}
+    Request(Symbol* name, Loader loader) : _name(name), _loader(loader) {}
+  };
+
+  static GrowableArray<Request>* _requests;
+  // Next request to claim
+  static volatile jint _next;
+  static volatile jint _active_threads;
+  // Statistics
+  static volatile jint _loaded;
+  static volatile jint _failed;
+  static jlong _start_time;
+
+  static void add_request(const char* name, Loader loader, TRAPS);
+  static void read_class_list(const char* path, TRAPS);
+  static void add_jwarmup_classes(TRAPS);
+  static int  number_of_threads();
+  static void start_thread(int id, TRAPS);
+
+  static void preload_thread_entry(JavaThread* thread, TRAPS);
+  static void preload(const Request& request, TRAPS);
+  static void thread_done();
+
+ public:
+  // Called once at startup, after the system class loader is set up.
+  static void initialize(TRAPS);
+};
+
+#endif // SHARE_VM_CLASSFILE_CLASSPRELOADER_HPP
@@ -150,6 +150,7 @@ int java_lang_String::value_offset  = 0;
 int java_lang_String::offset_offset = 0;
 int java_lang_String::count_offset  = 0;
 int java_lang_String::hash_offset   = 0;
+int java_lang_String::coder_offset  = 0;
 
 bool java_lang_String::initialized  = false;
 
@@ -157,15 +158,55 @@ void java_lang_String::compute_offsets() {
   assert(!initialized, "offsets should be initialized only once");
 
   Klass* k = SystemDictionary::String_klass();
-  compute_offset(value_offset,           k, vmSymbols::value_name(),  vmSymbols::char_array_signature());
+  compute_optional_offset(coder_offset,  k, vmSymbols::coder_name(),  vmSymbols::byte_signature());
+  if (coder_offset > 0) {
+    compute_offset(value_offset,         k, vmSymbols::value_name(),  vmSymbols::byte_array_signature());
+  } else {
+    compute_offset(value_offset,         k, vmSymbols::value_name(),  vmSymbols::char_array_signature());
+  }
   compute_optional_offset(offset_offset, k, vmSymbols::offset_name(), vmSymbols::int_signature());
   compute_optional_offset(count_offset,  k, vmSymbols::count_name(),  vmSymbols::int_signature());
   compute_optional_offset(hash_offset,   k, vmSymbols::hash_name(),   vmSymbols::int_signature());
 
   initialized = true;
+
+  if (CompactStrings && coder_offset == 0) {
+    warning("CompactStrings is ignored: java.lang.String of this class library has no coder field");
+    FLAG_SET_DEFAULT(CompactStrings, false);
+  }
 }
 
-Handle java_lang_String::basic_create(int length, TRAPS) {
+// Called once String.<clinit> has run; the class library reads this
+// static to decide whether new strings may be stored as Latin-1.
+void java_lang_String::set_compact_strings(bool value) {
+  assert(initialized, "Must be initialized");
+  InstanceKlass* ik = InstanceKlass::cast(SystemDictionary::String_klass());
+  fieldDescriptor fd;
+  if (ik->find_local_field(vmSymbols::compact_strings_name(), vmSymbols::bool_signature(), &fd) &&
+      fd.is_static()) {
+    ik->java_mirror()->bool_field_put(fd.offset(), value);
+  }
+}
+
+// UTF-16 characters of a string with a coder field are stored two bytes
+// per char in its byte[] value.
+static jchar* utf16_addr(typeArrayOop value, int index) {
+  if (java_lang_String::has_coder_field()) {
+    return (jchar*)value->byte_at_addr(index * 2);
+  }
+  return value->char_at_addr(index);
+}
+
+// Returns a resource allocated UTF-16 copy of a Latin-1 string.
+static jchar* inflate_latin1(typeArrayOop value, int length) {
+  jchar* result = NEW_RESOURCE_ARRAY(jchar, length);
+  for (int index = 0; index < length; index++) {
+    result[index] = (jchar)(value->byte_at(index) & 0xff);
+  }
+  return result;
+}
+
+Handle java_lang_String::basic_create(int length, bool latin1, TRAPS) {
   assert(initialized, "Must be initialized");
   // Create the String object first, so there's a chance that the String
   // and the char array it points to end up in the same cache line.
@@ -176,7 +217,12 @@ Handle java_lang_String::basic_create(int length, TRAPS) {
   // because GC can happen as a result of the allocation attempt.
   Handle h_obj(THREAD, obj);
   typeArrayOop buffer;
+  if (has_coder_field()) {
+    buffer = oopFactory::new_byteArray(latin1 ? length : (length << 1), CHECK_NH);
+  } else {
+    assert(!latin1, "Latin-1 needs a coder field");
     buffer = oopFactory::new_charArray(length, CHECK_NH);
+  }
 
   // Point the String at the char array
   obj = h_obj();
@@ -185,15 +231,26 @@ Handle java_lang_String::basic_create(int length, TRAPS) {
   assert(offset(obj) == 0, "initial String offset should be zero");
 //set_offset(obj, 0);
   set_count(obj, length);
+  if (has_coder_field()) {
+    set_coder(obj, latin1 ? CODER_LATIN1 : CODER_UTF16);
+  }
 
   return h_obj;
 }
 
 Handle java_lang_String::create_from_unicode(jchar* unicode, int length, TRAPS) {
-  Handle h_obj = basic_create(length, CHECK_NH);
+  bool latin1 = CompactStrings && UNICODE::is_latin1(unicode, length);
+  Handle h_obj = basic_create(length, latin1, CHECK_NH);
   typeArrayOop buffer = value(h_obj());
-  for (int index = 0; index < length; index++) {
-    buffer->char_at_put(index, unicode[index]);
+  if (latin1) {
+    for (int index = 0; index < length; index++) {
+      buffer->byte_at_put(index, (jbyte)unicode[index]);
+    }
+  } else if (length > 0) {
+    jchar* base = utf16_addr(buffer, 0);
+    for (int index = 0; index < length; index++) {
+      base[index] = unicode[index];
+    }
   }
   return h_obj;
 }
@@ -208,7 +265,14 @@ Handle java_lang_String::create_from_str(const char* utf8_str, TRAPS) {
     return Handle();
   }
   int length = UTF8::unicode_length(utf8_str);
-  Handle h_obj = basic_create(length, CHECK_NH);
+  if (has_coder_field()) {
+    // Decode first to learn whether the string fits in Latin-1
+    ResourceMark rm(THREAD);
+    jchar* chars = NEW_RESOURCE_ARRAY(jchar, length);
+    UTF8::convert_to_unicode(utf8_str, chars, length);
+    return create_from_unicode(chars, length, THREAD);
+  }
+  Handle h_obj = basic_create(length, false, CHECK_NH);
   if (length > 0) {
     UTF8::convert_to_unicode(utf8_str, value(h_obj())->char_at_addr(0), length);
   }
@@ -222,7 +286,13 @@ oop java_lang_String::create_oop_from_str(const char* utf8_str, TRAPS) {
 
 Handle java_lang_String::create_from_symbol(Symbol* symbol, TRAPS) {
   int length = UTF8::unicode_length((char*)symbol->bytes(), symbol->utf8_length());
-  Handle h_obj = basic_create(length, CHECK_NH);
+  if (has_coder_field()) {
+    ResourceMark rm(THREAD);
+    jchar* chars = NEW_RESOURCE_ARRAY(jchar, length);
+    UTF8::convert_to_unicode((char*)symbol->bytes(), chars, length);
+    return create_from_unicode(chars, length, THREAD);
+  }
+  Handle h_obj = basic_create(length, false, CHECK_NH);
   if (length > 0) {
     UTF8::convert_to_unicode((char*)symbol->bytes(), value(h_obj())->char_at_addr(0), length);
   }
@@ -286,6 +356,20 @@ char* java_lang_String::as_platform_dependent_str(Handle java_string, TRAPS) {
 
 Handle java_lang_String::char_converter(Handle java_string, jchar from_char, jchar to_char, TRAPS) {
   oop          obj    = java_string();
+  if (has_coder_field()) {
+    ResourceMark rm(THREAD);
+    int length;
+    jchar* chars = as_unicode_string(obj, length, CHECK_NH);
+    bool found = false;
+    for (int index = 0; index < length; index++) {
+      if (chars[index] == from_char) {
+        chars[index] = to_char;
+        found = true;
+      }
+    }
+    // No from_char, so do not copy.
+    return found ? create_from_unicode(chars, length, THREAD) : java_string;
+  }
   // Typical usage is to convert all '/' to '.' in string.
   typeArrayOop value  = java_lang_String::value(obj);
   int          offset = java_lang_String::offset(obj);
@@ -306,7 +390,7 @@ Handle java_lang_String::char_converter(Handle java_string, jchar from_char, jch
   // Create new UNICODE buffer. Must handlize value because GC
   // may happen during String and char array creation.
   typeArrayHandle h_value(THREAD, value);
-  Handle string = basic_create(length, CHECK_NH);
+  Handle string = basic_create(length, false, CHECK_NH);
 
   typeArrayOop from_buffer = h_value();
   typeArrayOop to_buffer   = java_lang_String::value(string());
@@ -329,8 +413,15 @@ jchar* java_lang_String::as_unicode_string(oop java_string, int& length, TRAPS)
 
   jchar* result = NEW_RESOURCE_ARRAY_RETURN_NULL(jchar, length);
   if (result != NULL) {
-    for (int index = 0; index < length; index++) {
-      result[index] = value->char_at(index + offset);
+    if (is_latin1(java_string)) {
+      for (int index = 0; index < length; index++) {
+        result[index] = (jchar)(value->byte_at(index) & 0xff);
+      }
+    } else if (length > 0) {
+      jchar* base = utf16_addr(value, offset);
+      for (int index = 0; index < length; index++) {
+        result[index] = base[index];
+      }
     }
   } else {
     THROW_MSG_0(vmSymbols::java_lang_OutOfMemoryError(), "could not allocate Unicode string");
@@ -344,8 +435,11 @@ unsigned int java_lang_String::hash_code(oop java_string) {
   if (length == 0) return 0;
 
   typeArrayOop value  = java_lang_String::value(java_string);
+  if (is_latin1(java_string)) {
+    return java_lang_String::hash_code((jubyte*)value->byte_at_addr(0), length);
+  }
   int          offset = java_lang_String::offset(java_string);
-  return java_lang_String::hash_code(value->char_at_addr(offset), length);
+  return java_lang_String::hash_code(utf16_addr(value, offset), length);
 }
 
 char* java_lang_String::as_quoted_ascii(oop java_string) {
@@ -353,12 +447,21 @@ char* java_lang_String::as_quoted_ascii(oop java_string) {
   int          offset = java_lang_String::offset(java_string);
   int          length = java_lang_String::length(java_string);
 
-  jchar* base = (length == 0) ? NULL : value->char_at_addr(offset);
-  if (base == NULL) return NULL;
+  if (length == 0) return NULL;
 
-  int result_length = UNICODE::quoted_ascii_length(base, length) + 1;
-  char* result = NEW_RESOURCE_ARRAY(char, result_length);
-  UNICODE::as_quoted_ascii(base, length, result, result_length);
+  int result_length;
+  char* result;
+  if (is_latin1(java_string)) {
+    jbyte* base = value->byte_at_addr(0);
+    result_length = UNICODE::quoted_ascii_length(base, length) + 1;
+    result = NEW_RESOURCE_ARRAY(char, result_length);
+    UNICODE::as_quoted_ascii(base, length, result, result_length);
+  } else {
+    jchar* base = utf16_addr(value, offset);
+    result_length = UNICODE::quoted_ascii_length(base, length) + 1;
+    result = NEW_RESOURCE_ARRAY(char, result_length);
+    UNICODE::as_quoted_ascii(base, length, result, result_length);
+  }
   assert(result_length >= length + 1, "must not be shorter");
   assert(result_length == (int)strlen(result) + 1, "must match");
   return result;
@@ -372,8 +475,15 @@ unsigned int java_lang_String::hash_string(oop java_string) {
   }
 
   typeArrayOop value  = java_lang_String::value(java_string);
+  if (is_latin1(java_string)) {
+    if (!StringTable::use_alternate_hashcode()) {
+      return java_lang_String::hash_code((jubyte*)value->byte_at_addr(0), length);
+    }
+    ResourceMark rm;
+    return StringTable::hash_string(inflate_latin1(value, length), length);
+  }
   int          offset = java_lang_String::offset(java_string);
-  return StringTable::hash_string(value->char_at_addr(offset), length);
+  return StringTable::hash_string(utf16_addr(value, offset), length);
 }
 
 Symbol* java_lang_String::as_symbol(Handle java_string, TRAPS) {
@@ -381,7 +491,11 @@ Symbol* java_lang_String::as_symbol(Handle java_string, TRAPS) {
   typeArrayOop value  = java_lang_String::value(obj);
   int          offset = java_lang_String::offset(obj);
   int          length = java_lang_String::length(obj);
-  jchar* base = (length == 0) ? NULL : value->char_at_addr(offset);
+  if (is_latin1(obj)) {
+    ResourceMark rm(THREAD);
+    return SymbolTable::lookup_unicode(inflate_latin1(value, length), length, THREAD);
+  }
+  jchar* base = (length == 0) ? NULL : utf16_addr(value, offset);
   Symbol* sym = SymbolTable::lookup_unicode(base, length, THREAD);
   return sym;
 }
@@ -390,7 +504,11 @@ Symbol* java_lang_String::as_symbol_or_null(oop java_string) {
   typeArrayOop value  = java_lang_String::value(java_string);
   int          offset = java_lang_String::offset(java_string);
   int          length = java_lang_String::length(java_string);
-  jchar* base = (length == 0) ? NULL : value->char_at_addr(offset);
+  if (is_latin1(java_string)) {
+    ResourceMark rm;
+    return SymbolTable::probe_unicode(inflate_latin1(value, length), length);
+  }
+  jchar* base = (length == 0) ? NULL : utf16_addr(value, offset);
   return SymbolTable::probe_unicode(base, length);
 }
 
@@ -399,7 +517,11 @@ int java_lang_String::utf8_length(oop java_string) {
   typeArrayOop value  = java_lang_String::value(java_string);
   int          offset = java_lang_String::offset(java_string);
   int          length = java_lang_String::length(java_string);
-  jchar* position = (length == 0) ? NULL : value->char_at_addr(offset);
+  if (is_latin1(java_string)) {
+    jbyte* position = (length == 0) ? NULL : value->byte_at_addr(0);
+    return UNICODE::utf8_length(position, length);
+  }
+  jchar* position = (length == 0) ? NULL : utf16_addr(value, offset);
   return UNICODE::utf8_length(position, length);
 }
 
@@ -407,7 +529,11 @@ char* java_lang_String::as_utf8_string(oop java_string) {
   typeArrayOop value  = java_lang_String::value(java_string);
   int          offset = java_lang_String::offset(java_string);
   int          length = java_lang_String::length(java_string);
-  jchar* position = (length == 0) ? NULL : value->char_at_addr(offset);
+  if (is_latin1(java_string)) {
+    jbyte* position = (length == 0) ? NULL : value->byte_at_addr(0);
+    return UNICODE::as_utf8(position, length);
+  }
+  jchar* position = (length == 0) ? NULL : utf16_addr(value, offset);
   return UNICODE::as_utf8(position, length);
 }
 
@@ -415,7 +541,11 @@ char* java_lang_String::as_utf8_string(oop java_string, char* buf, int buflen) {
   typeArrayOop value  = java_lang_String::value(java_string);
   int          offset = java_lang_String::offset(java_string);
   int          length = java_lang_String::length(java_string);
-  jchar* position = (length == 0) ? NULL : value->char_at_addr(offset);
+  if (is_latin1(java_string)) {
+    jbyte* position = (length == 0) ? NULL : value->byte_at_addr(0);
+    return UNICODE::as_utf8(position, length, buf, buflen);
+  }
+  jchar* position = (length == 0) ? NULL : utf16_addr(value, offset);
   return UNICODE::as_utf8(position, length, buf, buflen);
 }
 
@@ -424,7 +554,11 @@ char* java_lang_String::as_utf8_string(oop java_string, int start, int len) {
   int          offset = java_lang_String::offset(java_string);
   int          length = java_lang_String::length(java_string);
   assert(start + len <= length, "just checking");
-  jchar* position = value->char_at_addr(offset + start);
+  if (is_latin1(java_string)) {
+    jbyte* position = value->byte_at_addr(start);
+    return UNICODE::as_utf8(position, len);
+  }
+  jchar* position = utf16_addr(value, offset + start);
   return UNICODE::as_utf8(position, len);
 }
 
@@ -437,6 +571,14 @@ bool java_lang_String::equals(oop java_string, jchar* chars, int len) {
   if (length != len) {
     return false;
   }
+  if (has_coder_field()) {
+    for (int i = 0; i < len; i++) {
+      if (char_at(java_string, i) != chars[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
   for (int i = 0; i < len; i++) {
     if (value->char_at(i + offset) != chars[i]) {
       return false;
@@ -460,6 +602,21 @@ bool java_lang_String::equals(oop str1, oop str2) {
   if (length1 != length2) {
     return false;
   }
+  if (has_coder_field()) {
+    // Compact strings are canonical, so equal strings agree on the coder
+    // unless one of them was built while CompactStrings was off.
+    if (is_latin1(str1) == is_latin1(str2)) {
+      int bytes = value1->length();
+      return bytes == value2->length() &&
+             (bytes == 0 || memcmp(value1->byte_at_addr(0), value2->byte_at_addr(0), bytes) == 0);
+    }
+    for (int i = 0; i < length1; i++) {
+      if (char_at(str1, i) != char_at(str2, i)) {
+        return false;
+      }
+    }
+    return true;
+  }
   for (int i = 0; i < length1; i++) {
     if (value1->char_at(i + offset1) != value2->char_at(i + offset2)) {
       return false;
@@ -482,7 +639,7 @@ void java_lang_String::print(oop java_string, outputStream* st) {
   } else {
     st->print("\"");
     for (int index = 0; index < length; index++) {
-      st->print("%c", value->char_at(index + offset));
+      st->print("%c", char_at(java_string, index));
     }
     st->print("\"");
   }
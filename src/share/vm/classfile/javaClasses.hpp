@@ -56,10 +56,11 @@ class java_lang_String : AllStatic {
   static int offset_offset;
   static int count_offset;
   static int hash_offset;
+  static int coder_offset;
 
   static bool initialized;
 
-  static Handle basic_create(int length, TRAPS);
+  static Handle basic_create(int length, bool latin1, TRAPS);
 
   static void set_offset(oop string, int offset) {
     assert(initialized, "Must be initialized");
@@ -101,6 +102,18 @@ class java_lang_String : AllStatic {
     return (hash_offset > 0);
   }
 
+  // A String with a coder field keeps its characters in a byte[]: one
+  // byte per char for CODER_LATIN1, two (native order) for CODER_UTF16.
+  static bool has_coder_field()  {
+    assert(initialized, "Must be initialized");
+    return (coder_offset > 0);
+  }
+
+  enum {
+    CODER_LATIN1 = 0,
+    CODER_UTF16  = 1
+  };
+
   static int value_offset_in_bytes()  {
     assert(initialized && (value_offset > 0), "Must be initialized");
     return value_offset;
@@ -117,6 +130,10 @@ class java_lang_String : AllStatic {
     assert(initialized && (hash_offset > 0), "Must be initialized");
     return hash_offset;
   }
+  static int coder_offset_in_bytes()  {
+    assert(initialized && (coder_offset > 0), "Must be initialized");
+    return coder_offset;
+  }
 
   static void set_value(oop string, typeArrayOop buffer) {
     assert(initialized && (value_offset > 0), "Must be initialized");
@@ -126,6 +143,11 @@ class java_lang_String : AllStatic {
     assert(initialized && (hash_offset > 0), "Must be initialized");
     string->int_field_put(hash_offset, hash);
   }
+  static void set_coder(oop string, jbyte coder) {
+    assert(initialized && (coder_offset > 0), "Must be initialized");
+    string->byte_field_put(coder_offset, coder);
+  }
+  static void set_compact_strings(bool value);
 
   // Accessors
   static typeArrayOop value(oop java_string) {
@@ -153,7 +175,27 @@ class java_lang_String : AllStatic {
     if (count_offset > 0) {
       return java_string->int_field(count_offset);
     } else {
-      return ((typeArrayOop)java_string->obj_field(value_offset))->length();
+      int array_length = ((typeArrayOop)java_string->obj_field(value_offset))->length();
+      if (coder_offset > 0 && !is_latin1(java_string)) {
+        array_length >>= 1;
+      }
+      return array_length;
+    }
+  }
+  static bool is_latin1(oop java_string) {
+    assert(initialized, "Must be initialized");
+    assert(is_instance(java_string), "must be java_string");
+    return coder_offset > 0 && java_string->byte_field(coder_offset) == CODER_LATIN1;
+  }
+  // Character at index, independent of the representation
+  static jchar char_at(oop java_string, int index) {
+    typeArrayOop value = java_lang_String::value(java_string);
+    if (coder_offset == 0) {
+      return value->char_at(index + offset(java_string));
+    } else if (is_latin1(java_string)) {
+      return (jchar)(value->byte_at(index) & 0xff);
+    } else {
+      return *(jchar*)value->byte_at_addr(index * 2);
     }
   }
   static int utf8_length(oop java_string);
@@ -33,6 +33,7 @@
 #include "memory/gcLocker.inline.hpp"
 #include "oops/oop.inline.hpp"
 #include "oops/oop.inline2.hpp"
+#include "runtime/interfaceSupport.hpp"
 #include "runtime/mutexLocker.hpp"
 #include "utilities/hashtable.inline.hpp"
 #if INCLUDE_ALL_GCS
@@ -46,11 +47,37 @@ PRAGMA_FORMAT_MUTE_WARNINGS_FOR_GCC
 
 // the number of buckets a thread claims
 const int ClaimChunkSize = 32;
+// the number of buckets the service thread moves or cleans between
+// checks for a pending safepoint
+const int ConcurrentChunkSize = 1024;
+// the tables do not grow beyond this many buckets
+const int MaxResizedTableSize = 1 << 24;
+
+// Returns the size the load factor asks for, or the current size. The
+// tables only shrink back to sizes a previous grow went through.
+static int desired_table_size(int table_size, int number_of_entries, int initial_size) {
+  if (!ResizeStringSymbolTables || DumpSharedSpaces) {
+    return table_size;
+  }
+  const double load = (double)number_of_entries / table_size;
+  if (load > StringSymbolTableMaxLoadFactor && table_size <= MaxResizedTableSize / 2) {
+    return table_size * 2;
+  }
+  if (load < StringSymbolTableMaxLoadFactor / 8.0 && table_size / 2 >= initial_size) {
+    return table_size / 2;
+  }
+  return table_size;
+}
 
 SymbolTable* SymbolTable::_the_table = NULL;
 // Static arena for symbols that are not deallocated
 Arena* SymbolTable::_arena = NULL;
 bool SymbolTable::_needs_rehashing = false;
+volatile jint SymbolTable::_has_work = 0;
+volatile bool SymbolTable::_needs_cleaning = false;
+int SymbolTable::_resize_index = 0;
+SymbolTable* SymbolTable::_replaced_table = NULL;
+GrowableArray<HashtableEntry<Symbol*, mtSymbol>*>* SymbolTable::_dead_entries = NULL;
 
 Symbol* SymbolTable::allocate_symbol(const u1* name, int len, bool c_heap, TRAPS) {
   assert (len <= Symbol::max_length(), "should be checked by caller");
@@ -130,15 +157,23 @@ void SymbolTable::buckets_unlink(int start_idx, int end_idx, BucketUnlinkContext
 // Remove unreferenced symbols from the symbol table
 // This is done late during GC.
 void SymbolTable::unlink(int* processed, int* removed) {
+  if (cleans_concurrently()) {
+    request_cleaning();
+    *processed = 0;
+    *removed = 0;
+    return;
+  }
   size_t memory_total = 0;
   BucketUnlinkContext context;
   buckets_unlink(0, the_table()->table_size(), &context, &memory_total);
-  _the_table->bulk_free_entries(&context);
+  _the_table->free_entries(&context);
   *processed = context._num_processed;
   *removed = context._num_removed;
 
   _symbols_removed = context._num_removed;
   _symbols_counted = context._num_processed;
+  // Shrink the table if many symbols died
+  _the_table->check_concurrent_work();
   // Exclude printing for normal PrintGCDetails because people parse
   // this output.
   if (PrintGCDetails && Verbose && WizardMode) {
@@ -150,6 +185,15 @@ void SymbolTable::unlink(int* processed, int* removed) {
 void SymbolTable::possibly_parallel_unlink(int* processed, int* removed) {
   const int limit = the_table()->table_size();
 
+  if (cleans_concurrently()) {
+    request_cleaning();
+    // Nothing to claim, the service thread scans the table.
+    _parallel_claimed_idx = limit;
+    *processed = 0;
+    *removed = 0;
+    return;
+  }
+
   size_t memory_total = 0;
 
   BucketUnlinkContext context;
@@ -165,12 +209,14 @@ void SymbolTable::possibly_parallel_unlink(int* processed, int* removed) {
     buckets_unlink(start_idx, end_idx, &context, &memory_total);
   }
 
-  _the_table->bulk_free_entries(&context);
+  _the_table->free_entries(&context);
   *processed = context._num_processed;
   *removed = context._num_removed;
 
   Atomic::add(context._num_processed, &_symbols_counted);
   Atomic::add(context._num_removed, &_symbols_removed);
+  // Shrink the table if many symbols died
+  _the_table->check_concurrent_work();
   // Exclude printing for normal PrintGCDetails because people parse
   // this output.
   if (PrintGCDetails && Verbose && WizardMode) {
@@ -183,10 +229,11 @@ void SymbolTable::possibly_parallel_unlink(int* processed, int* removed) {
 // with the existing strings.   Set flag to use the alternate hash code afterwards.
 void SymbolTable::rehash_table() {
   assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  assert(the_table()->resize_target() == NULL, "resize must be finished");
   // This should never happen with -Xshare:dump but it might in testing mode.
   if (DumpSharedSpaces) return;
   // Create a new symbol table
-  SymbolTable* new_table = new SymbolTable();
+  SymbolTable* new_table = new SymbolTable(the_table()->table_size());
 
   the_table()->move_to(new_table);
 
@@ -198,18 +245,17 @@ void SymbolTable::rehash_table() {
   _the_table = new_table;
 }
 
-// Lookup a symbol in a bucket.
-
-Symbol* SymbolTable::lookup(int index, const char* name,
-                              int len, unsigned int hash) {
+// Lookup a symbol in a bucket. Symbols the concurrent cleaning has
+// claimed are skipped.
+Symbol* SymbolTable::lookup_in_bucket(HashtableEntry<Symbol*, mtSymbol>* head,
+                                      const char* name, int len, unsigned int hash) {
   int count = 0;
-  for (HashtableEntry<Symbol*, mtSymbol>* e = bucket(index); e != NULL; e = e->next()) {
+  for (HashtableEntry<Symbol*, mtSymbol>* e = head; e != NULL; e = e->next()) {
     count++;  // count all entries in this bucket, not just ones with same hash
     if (e->hash() == hash) {
       Symbol* sym = e->literal();
-      if (sym->equals(name, len)) {
-        // something is referencing this symbol now.
-        sym->increment_refcount();
+      // something is referencing this symbol now.
+      if (sym->equals(name, len) && sym->try_increment_refcount()) {
         return sym;
       }
     }
@@ -221,6 +267,17 @@ Symbol* SymbolTable::lookup(int index, const char* name,
   return NULL;
 }
 
+Symbol* SymbolTable::do_lookup(const char* name, int len, unsigned int hash) {
+  SymbolTable* table = this;
+  while (true) {
+    intptr_t head = table->bucket_head(table->hash_to_index(hash));
+    if ((head & bucket_moved) == 0) {
+      return table->lookup_in_bucket(head_entry(head), name, len, hash);
+    }
+    table = (SymbolTable*)table->resize_target();
+  }
+}
+
 // Pick hashing algorithm.
 unsigned int SymbolTable::hash_symbol(const char* s, int len) {
   return use_alternate_hashcode() ?
@@ -229,32 +286,26 @@ unsigned int SymbolTable::hash_symbol(const char* s, int len) {
 }
 
 
-// We take care not to be blocking while holding the
-// SymbolTable_lock. Otherwise, the system might deadlock, since the
-// symboltable is used during compilation (VM_thread) The lock free
-// synchronization is simplified by the fact that we do not delete
-// entries in the symbol table during normal execution (only during
-// safepoints).
+// Neither lookups nor inserts take a lock. The table, and the entries a
+// lookup may be walking, are only replaced or freed at a safepoint, so a
+// thread must not block between reading the_table() and using it.
 
 Symbol* SymbolTable::lookup(const char* name, int len, TRAPS) {
   unsigned int hashValue = hash_symbol(name, len);
-  int index = the_table()->hash_to_index(hashValue);
+  SymbolTable* table = the_table();
 
-  Symbol* s = the_table()->lookup(index, name, len, hashValue);
+  Symbol* s = table->do_lookup(name, len, hashValue);
 
   // Found
   if (s != NULL) return s;
 
-  // Grab SymbolTable_lock first.
-  MutexLocker ml(SymbolTable_lock, THREAD);
-
   // Otherwise, add to symbol to table
-  return the_table()->basic_add(index, (u1*)name, len, hashValue, true, CHECK_NULL);
+  return table->do_add_if_needed((u1*)name, len, hashValue, true, CHECK_NULL);
 }
 
 Symbol* SymbolTable::lookup(const Symbol* sym, int begin, int end, TRAPS) {
   char* buffer;
-  int index, len;
+  int len;
   unsigned int hashValue;
   char* name;
   {
@@ -263,8 +314,7 @@ Symbol* SymbolTable::lookup(const Symbol* sym, int begin, int end, TRAPS) {
     name = (char*)sym->base() + begin;
     len = end - begin;
     hashValue = hash_symbol(name, len);
-    index = the_table()->hash_to_index(hashValue);
-    Symbol* s = the_table()->lookup(index, name, len, hashValue);
+    Symbol* s = the_table()->do_lookup(name, len, hashValue);
 
     // Found
     if (s != NULL) return s;
@@ -285,19 +335,13 @@ Symbol* SymbolTable::lookup(const Symbol* sym, int begin, int end, TRAPS) {
   // We can't include the code in No_Safepoint_Verifier because of the
   // ResourceMark.
 
-  // Grab SymbolTable_lock first.
-  MutexLocker ml(SymbolTable_lock, THREAD);
-
-  return the_table()->basic_add(index, (u1*)buffer, len, hashValue, true, CHECK_NULL);
+  return the_table()->do_add_if_needed((u1*)buffer, len, hashValue, true, CHECK_NULL);
 }
 
 Symbol* SymbolTable::lookup_only(const char* name, int len,
                                    unsigned int& hash) {
   hash = hash_symbol(name, len);
-  int index = the_table()->hash_to_index(hash);
-
-  Symbol* s = the_table()->lookup(index, name, len, hash);
-  return s;
+  return the_table()->do_lookup(name, len, hash);
 }
 
 // Look up the address of the literal in the SymbolTable for this Symbol*
@@ -305,9 +349,14 @@ Symbol* SymbolTable::lookup_only(const char* name, int len,
 // Do not increment the reference count to keep this alive
 Symbol** SymbolTable::lookup_symbol_addr(Symbol* sym){
   unsigned int hash = hash_symbol((char*)sym->bytes(), sym->utf8_length());
-  int index = the_table()->hash_to_index(hash);
+  SymbolTable* table = the_table();
+  intptr_t head = table->bucket_head(table->hash_to_index(hash));
+  while ((head & bucket_moved) != 0) {
+    table = (SymbolTable*)table->resize_target();
+    head = table->bucket_head(table->hash_to_index(hash));
+  }
 
-  for (HashtableEntry<Symbol*, mtSymbol>* e = the_table()->bucket(index); e != NULL; e = e->next()) {
+  for (HashtableEntry<Symbol*, mtSymbol>* e = head_entry(head); e != NULL; e = e->next()) {
     if (e->hash() == hash) {
       Symbol* literal_sym = e->literal();
       if (sym == literal_sym) {
@@ -356,21 +405,8 @@ void SymbolTable::add(ClassLoaderData* loader_data, constantPoolHandle cp,
                       int names_count,
                       const char** names, int* lengths, int* cp_indices,
                       unsigned int* hashValues, TRAPS) {
-  // Grab SymbolTable_lock first.
-  MutexLocker ml(SymbolTable_lock, THREAD);
-
-  SymbolTable* table = the_table();
-  bool added = table->basic_add(loader_data, cp, names_count, names, lengths,
-                                cp_indices, hashValues, CHECK);
-  if (!added) {
-    // do it the hard way
-    for (int i=0; i<names_count; i++) {
-      int index = table->hash_to_index(hashValues[i]);
-      bool c_heap = !loader_data->is_the_null_class_loader_data();
-      Symbol* sym = table->basic_add(index, (u1*)names[i], lengths[i], hashValues[i], c_heap, CHECK);
-      cp->symbol_at_put(cp_indices[i], sym);
-    }
-  }
+  the_table()->basic_add(loader_data, cp, names_count, names, lengths,
+                         cp_indices, hashValues, CHECK);
 }
 
 Symbol* SymbolTable::new_permanent_symbol(const char* name, TRAPS) {
@@ -379,16 +415,11 @@ Symbol* SymbolTable::new_permanent_symbol(const char* name, TRAPS) {
   if (result != NULL) {
     return result;
   }
-  // Grab SymbolTable_lock first.
-  MutexLocker ml(SymbolTable_lock, THREAD);
-
-  SymbolTable* table = the_table();
-  int index = table->hash_to_index(hash);
-  return table->basic_add(index, (u1*)name, (int)strlen(name), hash, false, THREAD);
+  return the_table()->do_add_if_needed((u1*)name, (int)strlen(name), hash, false, THREAD);
 }
 
-Symbol* SymbolTable::basic_add(int index_arg, u1 *name, int len,
-                               unsigned int hashValue_arg, bool c_heap, TRAPS) {
+Symbol* SymbolTable::do_add_if_needed(const u1* name, int len,
+                                      unsigned int hashValue, bool c_heap, TRAPS) {
   assert(!Universe::heap()->is_in_reserved(name),
          "proposed name of symbol must be stable");
 
@@ -401,34 +432,59 @@ Symbol* SymbolTable::basic_add(int index_arg, u1 *name, int len,
   // Cannot hit a safepoint in this function because the "this" pointer can move.
   No_Safepoint_Verifier nsv;
 
-  // Check if the symbol table has been rehashed, if so, need to recalculate
-  // the hash value and index.
-  unsigned int hashValue;
-  int index;
-  if (use_alternate_hashcode()) {
-    hashValue = hash_symbol((const char*)name, len);
-    index = hash_to_index(hashValue);
-  } else {
-    hashValue = hashValue_arg;
-    index = index_arg;
-  }
+  Symbol* sym = NULL;
+  HashtableEntry<Symbol*, mtSymbol>* entry = NULL;
+  SymbolTable* table = this;
+  while (true) {
+    int index = table->hash_to_index(hashValue);
+    intptr_t head = table->bucket_head(index);
+    if ((head & bucket_moved) != 0) {
+      table = (SymbolTable*)table->resize_target();
+      continue;
+    }
+    if ((head & bucket_locked) != 0) {
+      // The service thread is moving or cleaning this bucket
+      SpinPause();
+      continue;
+    }
 
-  // Since look-up was done lock-free, we need to check if another
-  // thread beat us in the race to insert the symbol.
-  Symbol* test = lookup(index, (char*)name, len, hashValue);
-  if (test != NULL) {
-    // A race occurred and another thread introduced the symbol.
-    assert(test->refcount() != 0, "lookup should have incremented the count");
-    return test;
-  }
+    // Since look-up was done lock-free, we need to check if another
+    // thread beat us in the race to insert the symbol.
+    Symbol* test = table->lookup_in_bucket(head_entry(head), (const char*)name, len, hashValue);
+    if (test != NULL) {
+      // A race occurred and another thread introduced the symbol.
+      assert(test->refcount() != 0, "lookup should have incremented the count");
+      if (entry != NULL) {
+        discard_symbol(sym, entry, c_heap);
+      }
+      return test;
+    }
 
-  // Create a new symbol.
-  Symbol* sym = allocate_symbol(name, len, c_heap, CHECK_NULL);
-  assert(sym->equals((char*)name, len), "symbol must be properly initialized");
+    if (entry == NULL) {
+      // Create a new symbol.
+      sym = allocate_symbol(name, len, c_heap, CHECK_NULL);
+      assert(sym->equals((char*)name, len), "symbol must be properly initialized");
+      entry = table->allocate_entry(hashValue, sym);
+    }
+    entry->set_next(head_entry(head));
+    if (table->cas_insert(index, head, entry)) {
+      // Inserts can only ask for a grow
+      if ((uintx)table->number_of_entries() > (uintx)table->table_size() * StringSymbolTableMaxLoadFactor) {
+        table->check_concurrent_work();
+      }
+      return sym;
+    }
+  }
+}
 
-  HashtableEntry<Symbol*, mtSymbol>* entry = new_entry(hashValue, sym);
-  add_entry(index, entry);
-  return sym;
+// Free a symbol that lost the race to be inserted.
+void SymbolTable::discard_symbol(Symbol* sym, HashtableEntry<Symbol*, mtSymbol>* entry, bool c_heap) {
+  free_entry_memory(entry);
+  if (c_heap && !DumpSharedSpaces) {
+    sym->decrement_refcount();
+    delete sym;
+  }
+  // Arena and metaspace symbols stay allocated
 }
 
 // This version of basic_add adds symbols in batch from the constant pool
@@ -450,6 +506,9 @@ bool SymbolTable::basic_add(ClassLoaderData* loader_data, constantPoolHandle cp,
   // Cannot hit a safepoint in this function because the "this" pointer can move.
   No_Safepoint_Verifier nsv;
 
+  // The null class loader is never unloaded so its symbols are allocated
+  // specially in a permanent arena.
+  bool c_heap = !loader_data->is_the_null_class_loader_data();
   for (int i=0; i<names_count; i++) {
     // Check if the symbol table has been rehashed, if so, need to recalculate
     // the hash value.
@@ -459,29 +518,192 @@ bool SymbolTable::basic_add(ClassLoaderData* loader_data, constantPoolHandle cp,
     } else {
       hashValue = hashValues[i];
     }
-    // Since look-up was done lock-free, we need to check if another
-    // thread beat us in the race to insert the symbol.
-    int index = hash_to_index(hashValue);
-    Symbol* test = lookup(index, names[i], lengths[i], hashValue);
-    if (test != NULL) {
-      // A race occurred and another thread introduced the symbol, this one
-      // will be dropped and collected. Use test instead.
-      cp->symbol_at_put(cp_indices[i], test);
-      assert(test->refcount() != 0, "lookup should have incremented the count");
+    Symbol* sym = do_add_if_needed((const u1*)names[i], lengths[i], hashValue, c_heap, CHECK_(false));
+    cp->symbol_at_put(cp_indices[i], sym);
+  }
+  return true;
+}
+
+// --------------------------------------------------------------------------
+// Concurrent resizing and cleaning
+//
+// The service thread moves the buckets into a table of the size the load
+// factor asks for, ConcurrentChunkSize buckets at a time. Safepoints can
+// happen between the chunks; a safepoint finishes a resize that is still in
+// progress, so that GCs and rehashing always see a single table. The old
+// table and its entries are freed at the next safepoint, when no lookup can
+// still be walking them.
+
+void SymbolTable::notify_service_thread() {
+  if (Atomic::cmpxchg(1, &_has_work, 0) == 0) {
+    MutexLockerEx ml(Service_lock, Mutex::_no_safepoint_check_flag);
+    Service_lock->notify_all();
+  }
+}
+
+void SymbolTable::check_concurrent_work() {
+  if (!has_work() &&
+      desired_table_size(table_size(), number_of_entries(), (int)SymbolTableSize) != table_size()) {
+    notify_service_thread();
+  }
+}
+
+void SymbolTable::request_cleaning() {
+  _needs_cleaning = true;
+  notify_service_thread();
+}
+
+// Move up to count buckets, returns true if there are more to move.
+bool SymbolTable::move_buckets(SymbolTable* table, int count) {
+  const int limit = table->table_size();
+  const int end = _resize_index + MIN2(count, limit - _resize_index);
+  for (int i = _resize_index; i < end; i++) {
+    table->move_bucket(i);
+  }
+  _resize_index = end;
+  return end < limit;
+}
+
+void SymbolTable::replace_table(SymbolTable* table) {
+  assert(_replaced_table == NULL, "only one table is replaced at a time");
+  OrderAccess::release_store_ptr(&_the_table, table->resize_target());
+  _replaced_table = table;
+}
+
+void SymbolTable::resize(JavaThread* jt, SymbolTable* table, int new_size) {
+  _resize_index = 0;
+  table->set_resize_target(new SymbolTable(new_size));
+  while (move_buckets(table, ConcurrentChunkSize)) {
+    {
+      // Let a safepoint in
+      ThreadBlockInVM tbivm(jt);
+    }
+    if (the_table() != table) {
+      // The safepoint finished the resize
+      return;
+    }
+  }
+  replace_table(table);
+}
+
+void SymbolTable::clean_bucket(int i, int* processed, int* removed) {
+  // Look for dead symbols before locking the bucket
+  bool found = false;
+  for (HashtableEntry<Symbol*, mtSymbol>* p = bucket(i); p != NULL; p = p->next()) {
+    if (p->is_shared() && !use_alternate_hashcode()) {
+      break;
+    }
+    (*processed)++;
+    if (p->literal()->refcount() == 0) {
+      found = true;
+      break;
+    }
+  }
+  if (!found) {
+    return;
+  }
+
+  HashtableEntry<Symbol*, mtSymbol>* head = lock_bucket(i);
+  HashtableEntry<Symbol*, mtSymbol>* prev = NULL;
+  HashtableEntry<Symbol*, mtSymbol>* entry = head;
+  while (entry != NULL) {
+    HashtableEntry<Symbol*, mtSymbol>* next = entry->next();
+    if (!entry->is_shared() && entry->literal()->try_mark_dead()) {
+      // Lookups may still be on the entry, so its next stays intact
+      if (prev == NULL) {
+        head = next;
+      } else {
+        bool shared = prev->is_shared();
+        prev->set_next(next);
+        if (shared) {
+          prev->set_shared();
+        }
+      }
+      _dead_entries->append(entry);
+      (*removed)++;
     } else {
-      // Create a new symbol.  The null class loader is never unloaded so these
-      // are allocated specially in a permanent arena.
-      bool c_heap = !loader_data->is_the_null_class_loader_data();
-      Symbol* sym = allocate_symbol((const u1*)names[i], lengths[i], c_heap, CHECK_(false));
-      assert(sym->equals(names[i], lengths[i]), "symbol must be properly initialized");  // why wouldn't it be???
-      HashtableEntry<Symbol*, mtSymbol>* entry = new_entry(hashValue, sym);
-      add_entry(index, entry);
-      cp->symbol_at_put(cp_indices[i], sym);
+      prev = entry;
     }
+    entry = next;
   }
-  return true;
+  unlock_bucket(i, head);
+}
+
+void SymbolTable::clean_dead_entries(JavaThread* jt) {
+  if (_dead_entries == NULL) {
+    _dead_entries = new (ResourceObj::C_HEAP, mtSymbol)
+      GrowableArray<HashtableEntry<Symbol*, mtSymbol>*>(256, true, mtSymbol);
+  }
+  SymbolTable* table = the_table();
+  const int limit = table->table_size();
+  int processed = 0;
+  int removed = 0;
+  for (int start = 0; start < limit; start += ConcurrentChunkSize) {
+    const int end = MIN2(limit, start + ConcurrentChunkSize);
+    for (int i = start; i < end; i++) {
+      table->clean_bucket(i, &processed, &removed);
+    }
+    {
+      // Let a safepoint in
+      ThreadBlockInVM tbivm(jt);
+    }
+    if (the_table() != table) {
+      // Rehashed at the safepoint, the next request cleans the new table
+      break;
+    }
+  }
+  table->add_number_of_entries(-removed);
+  _symbols_counted = processed;
+  _symbols_removed = removed;
 }
 
+void SymbolTable::do_concurrent_work(JavaThread* jt) {
+  OrderAccess::release_store(&_has_work, 0);
+  if (_needs_cleaning) {
+    _needs_cleaning = false;
+    clean_dead_entries(jt);
+  }
+  // The next resize waits for the replaced table to be freed
+  SymbolTable* table = the_table();
+  int new_size = desired_table_size(table->table_size(), table->number_of_entries(), (int)SymbolTableSize);
+  if (new_size != table->table_size() && _replaced_table == NULL) {
+    resize(jt, table, new_size);
+  }
+}
+
+void SymbolTable::free_dead_entries() {
+  if (_dead_entries == NULL) {
+    return;
+  }
+  for (int i = 0; i < _dead_entries->length(); i++) {
+    HashtableEntry<Symbol*, mtSymbol>* entry = _dead_entries->at(i);
+    assert(entry->literal()->is_dead(), "must be unlinked");
+    delete entry->literal();
+    free_entry_memory(entry);
+  }
+  _dead_entries->clear();
+}
+
+bool SymbolTable::has_safepoint_work() {
+  return the_table()->resize_target() != NULL || _replaced_table != NULL ||
+         (_dead_entries != NULL && _dead_entries->is_nonempty());
+}
+
+void SymbolTable::finish_concurrent_work_at_safepoint() {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  SymbolTable* table = the_table();
+  if (table->resize_target() != NULL) {
+    move_buckets(table, table->table_size());
+    replace_table(table);
+  }
+  // No lookup can be in the replaced table or the unlinked entries now
+  if (_replaced_table != NULL) {
+    _replaced_table->free_replaced_table();
+    delete _replaced_table;
+    _replaced_table = NULL;
+  }
+  free_dead_entries();
+}
 
 void SymbolTable::verify() {
   for (int i = 0; i < the_table()->table_size(); ++i) {
@@ -646,6 +868,10 @@ StringTable* StringTable::_the_table = NULL;
 
 bool StringTable::_needs_rehashing = false;
 
+volatile jint StringTable::_has_work = 0;
+int StringTable::_resize_index = 0;
+StringTable* StringTable::_replaced_table = NULL;
+
 volatile int StringTable::_parallel_claimed_idx = 0;
 
 // Pick hashing algorithm
@@ -654,10 +880,11 @@ unsigned int StringTable::hash_string(const jchar* s, int len) {
                                     java_lang_String::hash_code(s, len);
 }
 
-oop StringTable::lookup(int index, jchar* name,
-                        int len, unsigned int hash) {
+// Lookup a string in a bucket.
+oop StringTable::lookup_in_bucket(HashtableEntry<oop, mtSymbol>* head, jchar* name,
+                                  int len, unsigned int hash) {
   int count = 0;
-  for (HashtableEntry<oop, mtSymbol>* l = bucket(index); l != NULL; l = l->next()) {
+  for (HashtableEntry<oop, mtSymbol>* l = head; l != NULL; l = l->next()) {
     count++;
     if (l->hash() == hash) {
       if (java_lang_String::equals(l->literal(), name, len)) {
@@ -672,39 +899,61 @@ oop StringTable::lookup(int index, jchar* name,
   return NULL;
 }
 
+oop StringTable::do_lookup(jchar* name, int len, unsigned int hash) {
+  StringTable* table = this;
+  while (true) {
+    intptr_t head = table->bucket_head(table->hash_to_index(hash));
+    if ((head & bucket_moved) == 0) {
+      return table->lookup_in_bucket(head_entry(head), name, len, hash);
+    }
+    table = (StringTable*)table->resize_target();
+  }
+}
 
-oop StringTable::basic_add(int index_arg, Handle string, jchar* name,
-                           int len, unsigned int hashValue_arg, TRAPS) {
+
+oop StringTable::do_add_if_needed(Handle string, jchar* name,
+                                  int len, unsigned int hashValue, TRAPS) {
 
   assert(java_lang_String::equals(string(), name, len),
          "string must be properly initialized");
   // Cannot hit a safepoint in this function because the "this" pointer can move.
   No_Safepoint_Verifier nsv;
 
-  // Check if the symbol table has been rehashed, if so, need to recalculate
-  // the hash value and index before second lookup.
-  unsigned int hashValue;
-  int index;
-  if (use_alternate_hashcode()) {
-    hashValue = hash_string(name, len);
-    index = hash_to_index(hashValue);
-  } else {
-    hashValue = hashValue_arg;
-    index = index_arg;
-  }
+  HashtableEntry<oop, mtSymbol>* entry = NULL;
+  StringTable* table = this;
+  while (true) {
+    int index = table->hash_to_index(hashValue);
+    intptr_t head = table->bucket_head(index);
+    if ((head & bucket_moved) != 0) {
+      table = (StringTable*)table->resize_target();
+      continue;
+    }
+    if ((head & bucket_locked) != 0) {
+      // The service thread is moving this bucket
+      SpinPause();
+      continue;
+    }
 
-  // Since look-up was done lock-free, we need to check if another
-  // thread beat us in the race to insert the symbol.
+    // Since look-up was done lock-free, we need to check if another
+    // thread beat us in the race to insert the symbol.
+    oop test = table->lookup_in_bucket(head_entry(head), name, len, hashValue);
+    if (test != NULL) {
+      // Entry already added
+      if (entry != NULL) {
+        free_entry_memory(entry);
+      }
+      return test;
+    }
 
-  oop test = lookup(index, name, len, hashValue); // calls lookup(u1*, int)
-  if (test != NULL) {
-    // Entry already added
-    return test;
+    if (entry == NULL) {
+      entry = table->allocate_entry(hashValue, string());
+    }
+    entry->set_next(head_entry(head));
+    if (table->cas_insert(index, head, entry)) {
+      table->check_concurrent_work();
+      return string();
+    }
   }
-
-  HashtableEntry<oop, mtSymbol>* entry = new_entry(hashValue, string());
-  add_entry(index, entry);
-  return string();
 }
 
 
@@ -729,8 +978,7 @@ static void ensure_string_alive(oop string) {
 
 oop StringTable::lookup(jchar* name, int len) {
   unsigned int hash = hash_string(name, len);
-  int index = the_table()->hash_to_index(hash);
-  oop string = the_table()->lookup(index, name, len, hash);
+  oop string = the_table()->do_lookup(name, len, hash);
 
   ensure_string_alive(string);
 
@@ -741,8 +989,7 @@ oop StringTable::lookup(jchar* name, int len) {
 oop StringTable::intern(Handle string_or_null, jchar* name,
                         int len, TRAPS) {
   unsigned int hashValue = hash_string(name, len);
-  int index = the_table()->hash_to_index(hashValue);
-  oop found_string = the_table()->lookup(index, name, len, hashValue);
+  oop found_string = the_table()->do_lookup(name, len, hashValue);
 
   // Found
   if (found_string != NULL) {
@@ -771,15 +1018,14 @@ oop StringTable::intern(Handle string_or_null, jchar* name,
   }
 #endif
 
-  // Grab the StringTable_lock before getting the_table() because it could
-  // change at safepoint.
-  oop added_or_found;
-  {
-    MutexLocker ml(StringTable_lock, THREAD);
-    // Otherwise, add to symbol to table
-    added_or_found = the_table()->basic_add(index, string, name, len,
-                                  hashValue, CHECK_NULL);
+  // Creating the string could have hit a safepoint that replaced or
+  // rehashed the_table(), so get it again and recalculate the hash value.
+  if (use_alternate_hashcode()) {
+    hashValue = hash_string(name, len);
   }
+  // Otherwise, add to symbol to table
+  oop added_or_found = the_table()->do_add_if_needed(string, name, len,
+                                                     hashValue, CHECK_NULL);
 
   ensure_string_alive(added_or_found);
 
@@ -823,9 +1069,11 @@ oop StringTable::intern(const char* utf8_string, TRAPS) {
 void StringTable::unlink_or_oops_do(BoolObjectClosure* is_alive, OopClosure* f, int* processed, int* removed) {
   BucketUnlinkContext context;
   buckets_unlink_or_oops_do(is_alive, f, 0, the_table()->table_size(), &context);
-  _the_table->bulk_free_entries(&context);
+  _the_table->free_entries(&context);
   *processed = context._num_processed;
   *removed = context._num_removed;
+  // Shrink the table if many strings died
+  _the_table->check_concurrent_work();
 }
 
 void StringTable::possibly_parallel_unlink_or_oops_do(BoolObjectClosure* is_alive, OopClosure* f, int* processed, int* removed) {
@@ -846,9 +1094,11 @@ void StringTable::possibly_parallel_unlink_or_oops_do(BoolObjectClosure* is_aliv
     int end_idx = MIN2(limit, start_idx + ClaimChunkSize);
     buckets_unlink_or_oops_do(is_alive, f, start_idx, end_idx, &context);
   }
-  _the_table->bulk_free_entries(&context);
+  _the_table->free_entries(&context);
   *processed = context._num_processed;
   *removed = context._num_removed;
+  // Shrink the table if many strings died
+  _the_table->check_concurrent_work();
 }
 
 void StringTable::buckets_oops_do(OopClosure* f, int start_idx, int end_idx) {
@@ -1107,9 +1357,10 @@ int StringTable::verify_and_compare_entries() {
 // with the existing strings.   Set flag to use the alternate hash code afterwards.
 void StringTable::rehash_table() {
   assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  assert(the_table()->resize_target() == NULL, "resize must be finished");
   // This should never happen with -Xshare:dump but it might in testing mode.
   if (DumpSharedSpaces) return;
-  StringTable* new_table = new StringTable();
+  StringTable* new_table = new StringTable(the_table()->table_size());
 
   // Rehash the table
   the_table()->move_to(new_table);
@@ -1121,3 +1372,78 @@ void StringTable::rehash_table() {
   _needs_rehashing = false;
   _the_table = new_table;
 }
+
+// Concurrent resizing, works like the one of the SymbolTable.
+
+void StringTable::notify_service_thread() {
+  if (Atomic::cmpxchg(1, &_has_work, 0) == 0) {
+    MutexLockerEx ml(Service_lock, Mutex::_no_safepoint_check_flag);
+    Service_lock->notify_all();
+  }
+}
+
+void StringTable::check_concurrent_work() {
+  if (!has_work() &&
+      desired_table_size(table_size(), number_of_entries(), (int)StringTableSize) != table_size()) {
+    notify_service_thread();
+  }
+}
+
+// Move up to count buckets, returns true if there are more to move.
+bool StringTable::move_buckets(StringTable* table, int count) {
+  const int limit = table->table_size();
+  const int end = _resize_index + MIN2(count, limit - _resize_index);
+  for (int i = _resize_index; i < end; i++) {
+    table->move_bucket(i);
+  }
+  _resize_index = end;
+  return end < limit;
+}
+
+void StringTable::replace_table(StringTable* table) {
+  assert(_replaced_table == NULL, "only one table is replaced at a time");
+  OrderAccess::release_store_ptr(&_the_table, table->resize_target());
+  _replaced_table = table;
+}
+
+void StringTable::do_concurrent_work(JavaThread* jt) {
+  OrderAccess::release_store(&_has_work, 0);
+  // The next resize waits for the replaced table to be freed
+  StringTable* table = the_table();
+  int new_size = desired_table_size(table->table_size(), table->number_of_entries(), (int)StringTableSize);
+  if (new_size == table->table_size() || _replaced_table != NULL) {
+    return;
+  }
+  _resize_index = 0;
+  table->set_resize_target(new StringTable(new_size));
+  while (move_buckets(table, ConcurrentChunkSize)) {
+    {
+      // Let a safepoint in
+      ThreadBlockInVM tbivm(jt);
+    }
+    if (the_table() != table) {
+      // The safepoint finished the resize
+      return;
+    }
+  }
+  replace_table(table);
+}
+
+bool StringTable::has_safepoint_work() {
+  return the_table()->resize_target() != NULL || _replaced_table != NULL;
+}
+
+void StringTable::finish_concurrent_work_at_safepoint() {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  StringTable* table = the_table();
+  if (table->resize_target() != NULL) {
+    move_buckets(table, table->table_size());
+    replace_table(table);
+  }
+  // No lookup can be in the replaced table now
+  if (_replaced_table != NULL) {
+    _replaced_table->free_replaced_table();
+    delete _replaced_table;
+    _replaced_table = NULL;
+  }
+}
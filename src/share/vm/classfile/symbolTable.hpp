@@ -27,6 +27,7 @@
 
 #include "memory/allocation.inline.hpp"
 #include "oops/symbol.hpp"
+#include "utilities/growableArray.hpp"
 #include "utilities/hashtable.hpp"
 
 // The symbol table holds all Symbol*s and corresponding interned strings.
@@ -34,10 +35,9 @@
 //
 // The interned strings are created lazily.
 //
-// It is implemented as an open hash table with a fixed number of buckets.
-//
-// %note:
-//  - symbolTableEntrys are allocated in blocks to reduce the space overhead.
+// It is implemented as an open hash table. Lookups and inserts do not take
+// a lock; the service thread grows or shrinks the table when the load
+// factor asks for it, see ResizeStringSymbolTables.
 
 class BoolObjectClosure;
 class outputStream;
@@ -89,11 +89,22 @@ private:
   static int _symbols_removed;
   static int _symbols_counted;
 
+  // Concurrent work for the service thread, see do_concurrent_work()
+  static volatile jint _has_work;
+  static volatile bool _needs_cleaning;
+  // Next bucket to move while the table is resized
+  static int _resize_index;
+  // Table a resize replaced, freed at the next safepoint
+  static SymbolTable* _replaced_table;
+  // Symbols unlinked by the concurrent cleaning, freed at the next safepoint
+  static GrowableArray<HashtableEntry<Symbol*, mtSymbol>*>* _dead_entries;
+
   Symbol* allocate_symbol(const u1* name, int len, bool c_heap, TRAPS); // Assumes no characters larger than 0x7F
 
   // Adding elements
-  Symbol* basic_add(int index, u1* name, int len, unsigned int hashValue,
-                    bool c_heap, TRAPS);
+  Symbol* do_add_if_needed(const u1* name, int len, unsigned int hashValue,
+                           bool c_heap, TRAPS);
+  void discard_symbol(Symbol* sym, HashtableEntry<Symbol*, mtSymbol>* entry, bool c_heap);
   bool basic_add(ClassLoaderData* loader_data,
                  constantPoolHandle cp, int names_count,
                  const char** names, int* lengths, int* cp_indices,
@@ -107,11 +118,17 @@ private:
     add(loader_data, cp, names_count, name, lengths, cp_indices, hashValues, THREAD);
   }
 
-  Symbol* lookup(int index, const char* name, int len, unsigned int hash);
+  // Lock-free lookup, follows the buckets a resize has moved
+  Symbol* do_lookup(const char* name, int len, unsigned int hash);
+  Symbol* lookup_in_bucket(HashtableEntry<Symbol*, mtSymbol>* head,
+                           const char* name, int len, unsigned int hash);
 
   SymbolTable()
     : RehashableHashtable<Symbol*, mtSymbol>(SymbolTableSize, sizeof (HashtableEntry<Symbol*, mtSymbol>)) {}
 
+  SymbolTable(int size)
+    : RehashableHashtable<Symbol*, mtSymbol>(size, sizeof (HashtableEntry<Symbol*, mtSymbol>)) {}
+
   SymbolTable(HashtableBucket<mtSymbol>* t, int number_of_entries)
     : RehashableHashtable<Symbol*, mtSymbol>(SymbolTableSize, sizeof (HashtableEntry<Symbol*, mtSymbol>), t,
                 number_of_entries) {}
@@ -129,6 +146,16 @@ private:
   // context to be freed later.
   // This allows multiple threads to work on the table at once.
   static void buckets_unlink(int start_idx, int end_idx, BucketUnlinkContext* context, size_t* memory_total);
+
+  // Concurrent resizing and cleaning
+  static void notify_service_thread();
+  void check_concurrent_work();
+  static bool move_buckets(SymbolTable* table, int count);
+  static void replace_table(SymbolTable* table);
+  static void resize(JavaThread* jt, SymbolTable* table, int new_size);
+  static void clean_dead_entries(JavaThread* jt);
+  void clean_bucket(int i, int* processed, int* removed);
+  static void free_dead_entries();
 public:
   enum {
     symbol_alloc_batch_size = 8,
@@ -194,6 +221,20 @@ public:
   // Release any dead symbols, possibly parallel version
   static void possibly_parallel_unlink(int* processed, int* removed);
 
+  // With ConcurrentSymbolTableCleaning the unlink functions above only ask
+  // the service thread to remove the dead symbols.
+  static bool cleans_concurrently() {
+    return ConcurrentSymbolTableCleaning && !DumpSharedSpaces;
+  }
+  static void request_cleaning();
+
+  // Resizing and cleaning done by the service thread
+  static bool has_work()                { return _has_work != 0; }
+  static void do_concurrent_work(JavaThread* jt);
+  // Finish a pending resize and free what the concurrent work unlinked
+  static bool has_safepoint_work();
+  static void finish_concurrent_work_at_safepoint();
+
   // iterate over symbols
   static void symbols_do(SymbolClosure *cl);
 
@@ -268,11 +309,19 @@ private:
   // Claimed high water mark for parallel chunked scanning
   static volatile int _parallel_claimed_idx;
 
+  // Concurrent resizing, see SymbolTable
+  static volatile jint _has_work;
+  static int _resize_index;
+  static StringTable* _replaced_table;
+
   static oop intern(Handle string_or_null, jchar* chars, int length, TRAPS);
-  oop basic_add(int index, Handle string_or_null, jchar* name, int len,
-                unsigned int hashValue, TRAPS);
+  oop do_add_if_needed(Handle string, jchar* name, int len,
+                       unsigned int hashValue, TRAPS);
 
-  oop lookup(int index, jchar* chars, int length, unsigned int hashValue);
+  // Lock-free lookup, follows the buckets a resize has moved
+  oop do_lookup(jchar* chars, int length, unsigned int hashValue);
+  oop lookup_in_bucket(HashtableEntry<oop, mtSymbol>* head,
+                       jchar* chars, int length, unsigned int hashValue);
 
   // Apply the give oop closure to the entries to the buckets
   // in the range [start_idx, end_idx).
@@ -288,9 +337,17 @@ private:
   StringTable() : RehashableHashtable<oop, mtSymbol>((int)StringTableSize,
                               sizeof (HashtableEntry<oop, mtSymbol>)) {}
 
+  StringTable(int size) : RehashableHashtable<oop, mtSymbol>(size,
+                              sizeof (HashtableEntry<oop, mtSymbol>)) {}
+
   StringTable(HashtableBucket<mtSymbol>* t, int number_of_entries)
     : RehashableHashtable<oop, mtSymbol>((int)StringTableSize, sizeof (HashtableEntry<oop, mtSymbol>), t,
                      number_of_entries) {}
+
+  static void notify_service_thread();
+  void check_concurrent_work();
+  static bool move_buckets(StringTable* table, int count);
+  static void replace_table(StringTable* table);
 public:
   // The string table
   static StringTable* the_table() { return _the_table; }
@@ -329,6 +386,12 @@ public:
   }
   static void possibly_parallel_oops_do(OopClosure* f);
 
+  // Resizing done by the service thread
+  static bool has_work()                { return _has_work != 0; }
+  static void do_concurrent_work(JavaThread* jt);
+  static bool has_safepoint_work();
+  static void finish_concurrent_work_at_safepoint();
+
   // Hashing algorithm, used as the hash value used by the
   //     StringTable for bucket selection and comparison (stored in the
   //     HashtableEntry structures).  This is used in the String.intern() method.
@@ -1032,6 +1032,25 @@ Klass* SystemDictionary::find_instance_or_array_klass(Symbol* class_name,
   return k;
 }
 
+// An anonymous class arena is kept alive while a class is defined in it.
+// Release it if the definition fails, the class will not keep it alive.
+class AnonymousClassArenaMark : public StackObj {
+  ClassLoaderData* _arena;
+ public:
+  AnonymousClassArenaMark() : _arena(NULL) {}
+  ~AnonymousClassArenaMark() {
+    if (_arena != NULL) {
+      _arena->dec_keep_alive();
+    }
+  }
+  void set_arena(ClassLoaderData* cld) {
+    if (cld->is_anonymous_class_arena()) {
+      _arena = cld;
+    }
+  }
+  void set_defined() { _arena = NULL; }
+};
+
 // Note: this method is much like resolve_from_stream, but
 // updates no supplemental data structures.
 // TODO consolidate the two methods with a helper routine?
@@ -1047,13 +1066,19 @@ Klass* SystemDictionary::parse_stream(Symbol* class_name,
   EventClassLoad class_load_start_event;
 
   ClassLoaderData* loader_data;
+  AnonymousClassArenaMark arena_mark;
   if (host_klass.not_null()) {
     // Create a new CLD for anonymous class, that uses the same class loader
     // as the host_klass
     assert(EnableInvokeDynamic, "");
     guarantee(host_klass->class_loader() == class_loader(), "should be the same");
     guarantee(!DumpSharedSpaces, "must not create anonymous classes when dumping");
-    loader_data = ClassLoaderData::anonymous_class_loader_data(class_loader(), CHECK_NULL);
+    if (UseAnonymousClassArena) {
+      loader_data = ClassLoaderData::anonymous_class_arena_data(host_klass, CHECK_NULL);
+    } else {
+      loader_data = ClassLoaderData::anonymous_class_loader_data(class_loader(), CHECK_NULL);
+    }
+    arena_mark.set_arena(loader_data);
     loader_data->record_dependency(host_klass(), CHECK_NULL);
   } else {
     loader_data = ClassLoaderData::class_loader_data(class_loader());
@@ -1074,7 +1099,6 @@ Klass* SystemDictionary::parse_stream(Symbol* class_name,
                                                              true,
                                                              THREAD);
 
-
   if (host_klass.not_null() && k.not_null()) {
     assert(EnableInvokeDynamic, "");
     // If it's anonymous, initialize it now, since nobody else will.
@@ -1110,6 +1134,10 @@ Klass* SystemDictionary::parse_stream(Symbol* class_name,
   assert(host_klass.not_null() || cp_patches == NULL,
          "cp_patches only found with host_klass");
 
+  if (k.not_null()) {
+    // The caller releases the arena once the mirror is safe in a handle
+    arena_mark.set_defined();
+  }
   return k();
 }
 
@@ -1817,9 +1845,9 @@ public:
 
 // Assumes classes in the SystemDictionary are only unloaded at a safepoint
 // Note: anonymous classes are not in the SD.
-bool SystemDictionary::do_unloading(BoolObjectClosure* is_alive, bool clean_alive) {
+bool SystemDictionary::do_unloading(BoolObjectClosure* is_alive, bool clean_alive, WorkGang* workers) {
   // First, mark for unload all ClassLoaderData referencing a dead class loader.
-  bool unloading_occurred = ClassLoaderDataGraph::do_unloading(is_alive, clean_alive);
+  bool unloading_occurred = ClassLoaderDataGraph::do_unloading(is_alive, clean_alive, workers);
   if (unloading_occurred) {
     JFR_ONLY(Jfr::on_unloading_classes();)
     dictionary()->do_unloading();
@@ -0,0 +1,440 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "precompiled.hpp"
+#include "classfile/symbolTable.hpp"
+#include "classfile/systemDictionary.hpp"
+#include "classfile/verificationCache.hpp"
+#include "classfile/verifier.hpp"
+#include "memory/resourceArea.hpp"
+#include "oops/instanceKlass.hpp"
+#include "runtime/atomic.inline.hpp"
+#include "runtime/handles.inline.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/thread.inline.hpp"
+#include "runtime/vm_version.hpp"
+
+VerificationCacheEntry** VerificationCache::_table = NULL;
+Symbol* VerificationCache::_boot_loader_name = NULL;
+int VerificationCache::_number_of_entries = 0;
+int VerificationCache::_hits = 0;
+int VerificationCache::_misses = 0;
+
+VerificationCacheEntry::VerificationCacheEntry(Symbol* class_name, Symbol* loader_name,
+                                               const u1* digest, juint size)
+  : _class_name(class_name),
+    _loader_name(loader_name),
+    _size(size),
+    _supers(new (ResourceObj::C_HEAP, mtClass) GrowableArray<Symbol*>(4, true, mtClass)),
+    _constraints(new (ResourceObj::C_HEAP, mtClass) GrowableArray<Constraint>(8, true, mtClass)),
+    _used(false),
+    _next(NULL) {
+  memcpy(_digest, digest, sizeof(_digest));
+  _class_name->increment_refcount();
+  _loader_name->increment_refcount();
+}
+
+VerificationCacheEntry::~VerificationCacheEntry() {
+  _class_name->decrement_refcount();
+  _loader_name->decrement_refcount();
+  for (int i = 0; i < _supers->length(); i++) {
+    _supers->at(i)->decrement_refcount();
+  }
+  for (int i = 0; i < _constraints->length(); i++) {
+    Constraint& c = _constraints->adr_at(i)[0];
+    c._a->decrement_refcount();
+    c._b->decrement_refcount();
+    if (c._c != NULL) {
+      c._c->decrement_refcount();
+    }
+  }
+  delete _supers;
+  delete _constraints;
+}
+
+void VerificationCacheEntry::add_super(Symbol* name) {
+  name->increment_refcount();
+  _supers->append(name);
+}
+
+void VerificationCacheEntry::add_constraint(u1 kind, Symbol* a, Symbol* b, Symbol* c,
+                                            bool flag, bool result) {
+  // The verifier asks the same questions many times
+  for (int i = 0; i < _constraints->length(); i++) {
+    Constraint& old = _constraints->adr_at(i)[0];
+    if (old._kind == kind && old._a == a && old._b == b && old._c == c && old._flag == flag) {
+      assert(old._result == result, "class hierarchy changed during verification");
+      return;
+    }
+  }
+  Constraint constraint;
+  constraint._a = a;
+  constraint._b = b;
+  constraint._c = c;
+  constraint._kind = kind;
+  constraint._flag = flag;
+  constraint._result = result;
+  a->increment_refcount();
+  b->increment_refcount();
+  if (c != NULL) {
+    c->increment_refcount();
+  }
+  _constraints->append(constraint);
+}
+
+bool VerificationCacheEntry::matches(Symbol* class_name, Symbol* loader_name,
+                                     const u1* digest, juint size) const {
+  return _size == size && memcmp(_digest, digest, sizeof(_digest)) == 0 &&
+         _class_name == class_name && _loader_name == loader_name;
+}
+
+bool VerificationCacheEntry::constraints_hold(instanceKlassHandle klass, TRAPS) const {
+  Klass* super = klass->super();
+  for (int i = 0; i < _supers->length(); i++) {
+    if (super == NULL || super->name() != _supers->at(i)) {
+      return false;
+    }
+    super = super->super();
+  }
+  if (super != NULL) {
+    return false;
+  }
+
+  Handle loader(THREAD, klass->class_loader());
+  Handle protection_domain(THREAD, klass->protection_domain());
+  for (int i = 0; i < _constraints->length(); i++) {
+    const Constraint& c = _constraints->at(i);
+    bool result;
+    if (c._kind == assignability) {
+      bool from_is_object = c._b->byte_at(0) != '[';
+      result = VerificationType::resolve_and_check_assignability(
+          klass, c._a, c._b, c._flag, from_is_object, CHECK_false);
+    } else {
+      assert(c._kind == protected_access, "unknown constraint");
+      Klass* target = SystemDictionary::resolve_or_fail(
+          c._a, loader, protection_domain, true, CHECK_false);
+      result = ClassVerifier::check_protected_access(klass, target, c._b, c._c, c._flag);
+    }
+    if (result != c._result) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Symbol* VerificationCache::loader_name(instanceKlassHandle klass, TRAPS) {
+  oop loader = klass->class_loader();
+  return loader == NULL ? _boot_loader_name : loader->klass()->name();
+}
+
+VerificationCacheEntry* VerificationCache::find(Symbol* class_name, Symbol* loader_name,
+                                                const u1* digest, juint size) {
+  assert_locked_or_safepoint(VerificationCache_lock);
+  for (VerificationCacheEntry* e = _table[VerificationCacheEntry::hash(digest) % table_size]; e != NULL; e = e->_next) {
+    if (e->matches(class_name, loader_name, digest, size)) {
+      return e;
+    }
+  }
+  return NULL;
+}
+
+void VerificationCache::add_entry(VerificationCacheEntry* entry) {
+  assert_locked_or_safepoint(VerificationCache_lock);
+  // Newer entries shadow older ones with the same key
+  int index = VerificationCacheEntry::hash(entry->_digest) % table_size;
+  entry->_next = _table[index];
+  _table[index] = entry;
+  _number_of_entries++;
+}
+
+void VerificationCache::initialize() {
+  if (VerificationCacheFile == NULL) {
+    return;
+  }
+  if (DumpSharedSpaces) {
+    // The archive records its own verification dependencies
+    warning("VerificationCacheFile is ignored when dumping the shared archive");
+    return;
+  }
+  Thread* THREAD = Thread::current();
+  _boot_loader_name = SymbolTable::new_permanent_symbol("NULL", THREAD);
+  _table = NEW_C_HEAP_ARRAY(VerificationCacheEntry*, table_size, mtClass);
+  memset(_table, 0, sizeof(VerificationCacheEntry*) * table_size);
+  read(VerificationCacheFile);
+}
+
+VerificationCacheEntry* VerificationCache::start_recording(instanceKlassHandle klass, TRAPS) {
+  if (klass->bytes_digest() == NULL || klass->is_anonymous()) {
+    return NULL;
+  }
+  VerificationCacheEntry* entry = new VerificationCacheEntry(
+      klass->name(), loader_name(klass, THREAD), klass->bytes_digest(), klass->bytes_size());
+  for (Klass* super = klass->super(); super != NULL; super = super->super()) {
+    entry->add_super(super->name());
+  }
+  return entry;
+}
+
+void VerificationCache::add_verified(VerificationCacheEntry* entry) {
+  entry->_used = true;
+  MutexLockerEx ml(VerificationCache_lock, Mutex::_no_safepoint_check_flag);
+  add_entry(entry);
+}
+
+bool VerificationCache::is_verified(instanceKlassHandle klass, TRAPS) {
+  if (klass->bytes_digest() == NULL || klass->is_anonymous()) {
+    return false;
+  }
+  VerificationCacheEntry* entry;
+  {
+    MutexLockerEx ml(VerificationCache_lock, Mutex::_no_safepoint_check_flag);
+    entry = find(klass->name(), loader_name(klass, THREAD), klass->bytes_digest(), klass->bytes_size());
+  }
+  // Entries are never freed, so the checks run without the lock
+  bool hit = false;
+  if (entry != NULL) {
+    hit = entry->constraints_hold(klass, THREAD);
+    if (HAS_PENDING_EXCEPTION) {
+      // Let the verifier run and report the problem
+      CLEAR_PENDING_EXCEPTION;
+      hit = false;
+    }
+  }
+  if (hit) {
+    entry->_used = true;
+    Atomic::inc(&_hits);
+  } else {
+    Atomic::inc(&_misses);
+  }
+  return hit;
+}
+
+// File format, in native byte order:
+//   u4 magic, u4 version, string VM version, u4 entry count, entries
+// where an entry is
+//   string class name, string loader name, u1[32] SHA-256 digest, u4 size,
+//   u2 super count, strings,
+//   u4 constraint count, constraints
+// and a constraint is
+//   u1 kind, u1 flag, u1 result, string a, string b, [string c]
+// Strings are a u2 length followed by the UTF-8 bytes.
+
+class VerificationCacheReader : public StackObj {
+ private:
+  FILE* _file;
+  bool  _ok;
+
+ public:
+  VerificationCacheReader(FILE* file) : _file(file), _ok(true) {}
+
+  bool ok() const { return _ok; }
+  void fail()       { _ok = false; }
+
+  void read_bytes(void* buf, size_t size) {
+    if (_ok && fread(buf, 1, size, _file) != size) {
+      _ok = false;
+    }
+  }
+
+  u1 read_u1() { u1 v = 0; read_bytes(&v, sizeof(v)); return v; }
+  u2 read_u2() { u2 v = 0; read_bytes(&v, sizeof(v)); return v; }
+  u4 read_u4() { u4 v = 0; read_bytes(&v, sizeof(v)); return v; }
+
+  // Returns a symbol the caller must release, or NULL
+  Symbol* read_symbol(TRAPS) {
+    u2 length = read_u2();
+    if (!_ok) {
+      return NULL;
+    }
+    ResourceMark rm(THREAD);
+    char* buf = NEW_RESOURCE_ARRAY(char, length + 1);
+    read_bytes(buf, length);
+    if (!_ok) {
+      return NULL;
+    }
+    buf[length] = '\0';
+    return SymbolTable::new_symbol(buf, length, THREAD);
+  }
+};
+
+class VerificationCacheWriter : public StackObj {
+ private:
+  FILE* _file;
+  bool  _ok;
+
+ public:
+  VerificationCacheWriter(FILE* file) : _file(file), _ok(true) {}
+
+  bool ok() const { return _ok; }
+
+  void write_bytes(const void* buf, size_t size) {
+    if (_ok && fwrite(buf, 1, size, _file) != size) {
+      _ok = false;
+    }
+  }
+
+  void write_u1(u1 v) { write_bytes(&v, sizeof(v)); }
+  void write_u2(u2 v) { write_bytes(&v, sizeof(v)); }
+  void write_u4(u4 v) { write_bytes(&v, sizeof(v)); }
+
+  void write_string(const char* s, int length) {
+    write_u2((u2)length);
+    write_bytes(s, length);
+  }
+
+  void write_symbol(Symbol* s) {
+    write_string((const char*)s->bytes(), s->utf8_length());
+  }
+};
+
+void VerificationCache::read(const char* path) {
+  FILE* file = fopen(path, "rb");
+  if (file == NULL) {
+    // First run, nothing recorded yet
+    return;
+  }
+  Thread* THREAD = Thread::current();
+  VerificationCacheReader reader(file);
+  if (reader.read_u4() != file_magic || reader.read_u4() != file_version) {
+    warning("Verification cache file %s has a wrong format, ignored", path);
+    fclose(file);
+    return;
+  }
+  TempNewSymbol vm_version = reader.read_symbol(THREAD);
+  if (!reader.ok() || HAS_PENDING_EXCEPTION ||
+      !vm_version->equals(Abstract_VM_Version::internal_vm_info_string(),
+                          (int)strlen(Abstract_VM_Version::internal_vm_info_string()))) {
+    CLEAR_PENDING_EXCEPTION;
+    warning("Verification cache file %s was written by another VM, ignored", path);
+    fclose(file);
+    return;
+  }
+
+  u4 count = reader.read_u4();
+  MutexLockerEx ml(VerificationCache_lock, Mutex::_no_safepoint_check_flag);
+  for (u4 n = 0; n < count && reader.ok() && !HAS_PENDING_EXCEPTION; n++) {
+    TempNewSymbol class_name = reader.read_symbol(THREAD);
+    TempNewSymbol loader = reader.read_symbol(THREAD);
+    u1 digest[SHA256::digest_length];
+    reader.read_bytes(digest, sizeof(digest));
+    juint size = reader.read_u4();
+    if (!reader.ok() || HAS_PENDING_EXCEPTION) {
+      break;
+    }
+    VerificationCacheEntry* entry = new VerificationCacheEntry(class_name, loader, digest, size);
+    u2 supers = reader.read_u2();
+    for (u2 i = 0; i < supers && reader.ok(); i++) {
+      TempNewSymbol super = reader.read_symbol(THREAD);
+      if (super != NULL) {
+        entry->add_super(super);
+      }
+    }
+    u4 constraints = reader.read_u4();
+    for (u4 i = 0; i < constraints && reader.ok() && !HAS_PENDING_EXCEPTION; i++) {
+      u1 kind = reader.read_u1();
+      bool flag = reader.read_u1() != 0;
+      bool result = reader.read_u1() != 0;
+      TempNewSymbol a = reader.read_symbol(THREAD);
+      TempNewSymbol b = reader.read_symbol(THREAD);
+      TempNewSymbol c = kind == VerificationCacheEntry::protected_access ?
+                        reader.read_symbol(THREAD) : NULL;
+      if (!reader.ok() || HAS_PENDING_EXCEPTION ||
+          kind > VerificationCacheEntry::protected_access) {
+        reader.fail();
+        break;
+      }
+      entry->add_constraint(kind, a, b, c, flag, result);
+    }
+    if (!reader.ok() || HAS_PENDING_EXCEPTION) {
+      delete entry;
+      break;
+    }
+    add_entry(entry);
+  }
+  if (!reader.ok() || HAS_PENDING_EXCEPTION) {
+    CLEAR_PENDING_EXCEPTION;
+    warning("Verification cache file %s is truncated, %d entries read",
+            path, _number_of_entries);
+  }
+  fclose(file);
+}
+
+void VerificationCache::write() {
+  if (!is_enabled()) {
+    return;
+  }
+  MutexLockerEx ml(VerificationCache_lock, Mutex::_no_safepoint_check_flag);
+  FILE* file = fopen(VerificationCacheFile, "wb");
+  if (file == NULL) {
+    warning("Cannot open verification cache file %s", VerificationCacheFile);
+    return;
+  }
+  int written = 0;
+  for (int i = 0; i < table_size; i++) {
+    for (VerificationCacheEntry* e = _table[i]; e != NULL; e = e->_next) {
+      if (e->_used) {
+        written++;
+      }
+    }
+  }
+
+  VerificationCacheWriter writer(file);
+  writer.write_u4(file_magic);
+  writer.write_u4(file_version);
+  const char* vm_version = Abstract_VM_Version::internal_vm_info_string();
+  writer.write_string(vm_version, (int)strlen(vm_version));
+  writer.write_u4(written);
+  for (int i = 0; i < table_size; i++) {
+    for (VerificationCacheEntry* e = _table[i]; e != NULL; e = e->_next) {
+      if (!e->_used) {
+        continue;
+      }
+      writer.write_symbol(e->_class_name);
+      writer.write_symbol(e->_loader_name);
+      writer.write_bytes(e->_digest, sizeof(e->_digest));
+      writer.write_u4(e->_size);
+      writer.write_u2((u2)e->_supers->length());
+      for (int j = 0; j < e->_supers->length(); j++) {
+        writer.write_symbol(e->_supers->at(j));
+      }
+      writer.write_u4(e->_constraints->length());
+      for (int j = 0; j < e->_constraints->length(); j++) {
+        const VerificationCacheEntry::Constraint& c = e->_constraints->at(j);
+        writer.write_u1(c._kind);
+        writer.write_u1(c._flag ? 1 : 0);
+        writer.write_u1(c._result ? 1 : 0);
+        writer.write_symbol(c._a);
+        writer.write_symbol(c._b);
+        if (c._kind == VerificationCacheEntry::protected_access) {
+          writer.write_symbol(c._c);
+        }
+      }
+    }
+  }
+  if (fclose(file) != 0 || !writer.ok()) {
+    warning("Cannot write verification cache file %s", VerificationCacheFile);
+  }
+
+  if (PrintVerificationCacheStatistics) {
+    tty->print_cr("Verification cache: %d hits, %d misses, %d of %d entries written",
+                  _hits, _misses, written, _number_of_entries);
+  }
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef SHARE_VM_CLASSFILE_VERIFICATIONCACHE_HPP
+#define SHARE_VM_CLASSFILE_VERIFICATIONCACHE_HPP
+
+#include "memory/allocation.hpp"
+#include "oops/symbol.hpp"
+#include "runtime/handles.hpp"
+#include "utilities/growableArray.hpp"
+#include "utilities/sha256.hpp"
+
+// Remembers across JVM runs which classes the split verifier accepted, in
+// the file given by -XX:VerificationCacheFile.
+//
+// An entry is keyed by the class bytes (their SHA-256 digest and length),
+// the class name and the name of the defining loader's class. A checksum
+// is not enough: modified bytes that collide with it would skip
+// verification. Besides the bytes, a successful verification only depends
+// on the class hierarchy the verifier queried, so the entry also records
+//  - the names of the superclasses,
+//  - every assignability check between named classes, and
+//  - every protected member access check,
+// together with their results. When the same class bytes are linked again,
+// the recorded checks are evaluated against the classes loaded now, which
+// loads the same classes the verifier would load. Verification is skipped
+// only if all of them give the recorded results.
+//
+// The file is read at startup and written at exit. Only the entries used or
+// added during the run are written back.
+class VerificationCacheEntry : public CHeapObj<mtClass> {
+  friend class VerificationCache;
+ public:
+  enum Kind {
+    assignability,      // _a assignable from _b, _flag: from_field_is_protected
+    protected_access    // _a._b:_c is a protected access, _flag: is_method
+  };
+
+ private:
+  struct Constraint {
+    Symbol* _a;
+    Symbol* _b;
+    Symbol* _c;
+    u1      _kind;
+    bool    _flag;
+    bool    _result;
+  };
+
+  Symbol*                     _class_name;
+  Symbol*                     _loader_name;
+  u1                          _digest[SHA256::digest_length];
+  juint                       _size;
+  GrowableArray<Symbol*>*     _supers;
+  GrowableArray<Constraint>*  _constraints;
+  volatile bool               _used;
+  VerificationCacheEntry*     _next;
+
+  void add_constraint(u1 kind, Symbol* a, Symbol* b, Symbol* c, bool flag, bool result);
+
+ public:
+  VerificationCacheEntry(Symbol* class_name, Symbol* loader_name, const u1* digest, juint size);
+  ~VerificationCacheEntry();
+
+  // Recording, called by the ClassVerifier
+  void add_super(Symbol* name);
+  void record_assignability(Symbol* target, Symbol* from, bool from_field_is_protected, bool result) {
+    add_constraint(assignability, target, from, NULL, from_field_is_protected, result);
+  }
+  void record_protected_access(Symbol* target_class, Symbol* name, Symbol* sig, bool is_method, bool result) {
+    add_constraint(protected_access, target_class, name, sig, is_method, result);
+  }
+
+  bool matches(Symbol* class_name, Symbol* loader_name, const u1* digest, juint size) const;
+  // Index into the table, from the leading bytes of the digest
+  static juint hash(const u1* digest) {
+    return ((juint)digest[0] << 24) | ((juint)digest[1] << 16) |
+           ((juint)digest[2] << 8) | (juint)digest[3];
+  }
+  // Evaluate the recorded checks for the given class
+  bool constraints_hold(instanceKlassHandle klass, TRAPS) const;
+};
+
+class VerificationCache : AllStatic {
+ private:
+  enum {
+    table_size = 4099,
+    file_magic = 0x56434348,    // "VCCH"
+    file_version = 2
+  };
+
+  static VerificationCacheEntry** _table;
+  static Symbol* _boot_loader_name;
+  static int _number_of_entries;
+  static int _hits;
+  static int _misses;
+
+  static Symbol* loader_name(instanceKlassHandle klass, TRAPS);
+  static VerificationCacheEntry* find(Symbol* class_name, Symbol* loader_name, const u1* digest, juint size);
+  static void add_entry(VerificationCacheEntry* entry);
+  static void read(const char* path);
+
+ public:
+  static bool is_enabled()          { return _table != NULL; }
+
+  static void initialize();
+
+  // Entry to record into while verifying klass, or NULL if klass cannot
+  // be cached.
+  static VerificationCacheEntry* start_recording(instanceKlassHandle klass, TRAPS);
+  // Keep the recorded entry of a class that verified successfully.
+  static void add_verified(VerificationCacheEntry* entry);
+
+  // True if an earlier run verified the same class bytes under the
+  // same conditions.
+  static bool is_verified(instanceKlassHandle klass, TRAPS);
+
+  // Write the used and new entries back to VerificationCacheFile.
+  static void write();
+};
+
+#endif // SHARE_VM_CLASSFILE_VERIFICATIONCACHE_HPP
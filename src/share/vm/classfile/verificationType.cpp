@@ -42,6 +42,45 @@ VerificationType VerificationType::from_tag(u1 tag) {
   }
 }
 
+bool VerificationType::resolve_and_check_assignability(instanceKlassHandle klass, Symbol* name,
+                                                        Symbol* from_name, bool from_field_is_protected,
+                                                        bool from_is_object, TRAPS) {
+  Klass* obj = SystemDictionary::resolve_or_fail(
+      name, Handle(THREAD, klass->class_loader()),
+      Handle(THREAD, klass->protection_domain()), true, CHECK_false);
+  KlassHandle this_class(THREAD, obj);
+
+  if (this_class->is_interface() && (!from_field_is_protected ||
+      from_name != vmSymbols::java_lang_Object())) {
+    // If we are not trying to access a protected field or method in
+    // java.lang.Object then we treat interfaces as java.lang.Object,
+    // including java.lang.Cloneable and java.io.Serializable.
+    return true;
+  } else if (from_is_object) {
+    Klass* from_class = SystemDictionary::resolve_or_fail(
+        from_name, Handle(THREAD, klass->class_loader()),
+        Handle(THREAD, klass->protection_domain()), true, CHECK_false);
+    bool result = InstanceKlass::cast(from_class)->is_subclass_of(this_class());
+    if (result && DumpSharedSpaces) {
+      if (klass()->is_subclass_of(from_class) && klass()->is_subclass_of(this_class())) {
+        // No need to save verification dependency. At run time, <klass> will be
+        // loaded from the archived only if <from_class> and <this_class> are
+        // also loaded from the archive. I.e., all 3 classes are exactly the same
+        // as we saw at archive creation time.
+      } else {
+        // Save the dependency. At run time, we need to check that the condition
+        // from_class->is_subclass_of(this_class() is still true.
+        Symbol* accessor_clsname = from_name;
+        Symbol* target_clsname = this_class()->name();
+        SystemDictionaryShared::add_verification_dependency(klass(),
+                     accessor_clsname, target_clsname);
+      }
+    }
+    return result;
+  }
+  return false;
+}
+
 bool VerificationType::is_reference_assignable_from(
     const VerificationType& from, ClassVerifier* context,
     bool from_field_is_protected, TRAPS) const {
@@ -59,39 +98,11 @@ bool VerificationType::is_reference_assignable_from(
       // any object or array is assignable to java.lang.Object
       return true;
     }
-    Klass* obj = SystemDictionary::resolve_or_fail(
-        name(), Handle(THREAD, klass->class_loader()),
-        Handle(THREAD, klass->protection_domain()), true, CHECK_false);
-    KlassHandle this_class(THREAD, obj);
-
-    if (this_class->is_interface() && (!from_field_is_protected ||
-        from.name() != vmSymbols::java_lang_Object())) {
-      // If we are not trying to access a protected field or method in
-      // java.lang.Object then we treat interfaces as java.lang.Object,
-      // including java.lang.Cloneable and java.io.Serializable.
-      return true;
-    } else if (from.is_object()) {
-      Klass* from_class = SystemDictionary::resolve_or_fail(
-          from.name(), Handle(THREAD, klass->class_loader()),
-          Handle(THREAD, klass->protection_domain()), true, CHECK_false);
-      bool result = InstanceKlass::cast(from_class)->is_subclass_of(this_class());
-      if (result && DumpSharedSpaces) {
-        if (klass()->is_subclass_of(from_class) && klass()->is_subclass_of(this_class())) {
-          // No need to save verification dependency. At run time, <klass> will be
-          // loaded from the archived only if <from_class> and <this_class> are
-          // also loaded from the archive. I.e., all 3 classes are exactly the same
-          // as we saw at archive creation time.
-        } else {
-          // Save the dependency. At run time, we need to check that the condition
-          // from_class->is_subclass_of(this_class() is still true.
-          Symbol* accessor_clsname = from.name();
-          Symbol* target_clsname = this_class()->name();
-          SystemDictionaryShared::add_verification_dependency(klass(),
-                       accessor_clsname, target_clsname);
-        }
-      }
-      return result;
-    }
+    bool result = resolve_and_check_assignability(klass, name(), from.name(),
+                                                  from_field_is_protected,
+                                                  from.is_object(), CHECK_false);
+    context->record_assignability(name(), from.name(), from_field_is_protected, result);
+    return result;
   } else if (is_array() && from.is_array()) {
     VerificationType comp_this = get_component(context, CHECK_false);
     VerificationType comp_from = from.get_component(context, CHECK_false);
@@ -308,6 +308,13 @@ class VerificationType VALUE_OBJ_CLASS_SPEC {
 
   void print_on(outputStream* st) const;
 
+  // Check if class 'name' is assignable from class 'from_name' when seen
+  // from 'klass', loading both classes with its loader. Also used to
+  // revalidate a cached verification, see VerificationCache.
+  static bool resolve_and_check_assignability(instanceKlassHandle klass, Symbol* name,
+                                              Symbol* from_name, bool from_field_is_protected,
+                                              bool from_is_object, TRAPS);
+
  private:
 
   bool is_reference_assignable_from(
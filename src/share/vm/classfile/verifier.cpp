@@ -128,10 +128,21 @@ bool Verifier::verify(instanceKlassHandle klass, Verifier::Mode mode, bool shoul
     if (TraceClassInitialization) {
       tty->print_cr("Start class verification for: %s", klassName);
     }
-    if (klass->major_version() >= STACKMAP_ATTRIBUTE_MAJOR_VERSION) {
+    if (klass->major_version() >= STACKMAP_ATTRIBUTE_MAJOR_VERSION &&
+        VerificationCache::is_enabled() &&
+        VerificationCache::is_verified(klass, THREAD)) {
+      // An earlier run verified the same class bytes against the same
+      // class hierarchy
+      if (TraceClassInitialization || VerboseVerification) {
+        tty->print_cr("Verification cache hit for: %s", klassName);
+      }
+    } else if (klass->major_version() >= STACKMAP_ATTRIBUTE_MAJOR_VERSION) {
       ClassVerifier split_verifier(klass, THREAD);
       split_verifier.verify_class(THREAD);
       exception_name = split_verifier.result();
+      if (exception_name == NULL && !HAS_PENDING_EXCEPTION) {
+        split_verifier.add_to_verification_cache();
+      }
       if (can_failover && !HAS_PENDING_EXCEPTION &&
           (exception_name == vmSymbols::java_lang_VerifyError() ||
            exception_name == vmSymbols::java_lang_ClassFormatError())) {
@@ -523,10 +534,14 @@ void ErrorContext::stackmap_details(outputStream* ss, const Method* method) cons
 
 ClassVerifier::ClassVerifier(
     instanceKlassHandle klass, TRAPS)
-    : _thread(THREAD), _exception_type(NULL), _message(NULL), _klass(klass) {
+    : _thread(THREAD), _exception_type(NULL), _message(NULL), _klass(klass),
+      _cache_entry(NULL) {
   _this_type = VerificationType::reference_type(klass->name());
   // Create list to hold symbols in reference area.
   _symbols = new GrowableArray<Symbol*>(100, 0, NULL);
+  if (VerificationCache::is_enabled()) {
+    _cache_entry = VerificationCache::start_recording(klass, THREAD);
+  }
 }
 
 ClassVerifier::~ClassVerifier() {
@@ -535,6 +550,17 @@ ClassVerifier::~ClassVerifier() {
     Symbol* s = _symbols->at(i);
     s->decrement_refcount();
   }
+  if (_cache_entry != NULL) {
+    delete _cache_entry;
+  }
+}
+
+void ClassVerifier::add_to_verification_cache() {
+  // A recursive verification recorded its own checks
+  if (_cache_entry != NULL && !has_error() && !was_recursively_verified()) {
+    VerificationCache::add_verified(_cache_entry);
+    _cache_entry = NULL;
+  }
 }
 
 VerificationType ClassVerifier::object_type() const {
@@ -1959,6 +1985,20 @@ bool ClassVerifier::is_protected_access(instanceKlassHandle this_class,
                                         Symbol* field_name,
                                         Symbol* field_sig,
                                         bool is_method) {
+  bool result = check_protected_access(this_class, target_class, field_name,
+                                       field_sig, is_method);
+  if (_cache_entry != NULL) {
+    _cache_entry->record_protected_access(target_class->name(), field_name,
+                                          field_sig, is_method, result);
+  }
+  return result;
+}
+
+bool ClassVerifier::check_protected_access(instanceKlassHandle this_class,
+                                           Klass* target_class,
+                                           Symbol* field_name,
+                                           Symbol* field_sig,
+                                           bool is_method) {
   No_Safepoint_Verifier nosafepoint;
 
   // If target class isn't a super class of this class, we don't worry about this case
@@ -2541,6 +2581,13 @@ void ClassVerifier::verify_invoke_init(
         vmSymbols::object_initializer_name(),
         cp->signature_ref_at(bcs->get_index_u2()), Klass::find_overpass);
       // Do nothing if method is not found.  Let resolution detect the error.
+      if (_cache_entry != NULL) {
+        _cache_entry->record_protected_access(
+          ref_klass->name(), vmSymbols::object_initializer_name(),
+          cp->signature_ref_at(bcs->get_index_u2()), true,
+          m != NULL && m->is_protected() &&
+          !m->method_holder()->is_same_class_package(_klass()));
+      }
       if (m != NULL) {
         instanceKlassHandle mh(THREAD, m->method_holder());
         if (m->is_protected() && !mh->is_same_class_package(_klass())) {
@@ -25,6 +25,7 @@
 #ifndef SHARE_VM_CLASSFILE_VERIFIER_HPP
 #define SHARE_VM_CLASSFILE_VERIFIER_HPP
 
+#include "classfile/verificationCache.hpp"
 #include "classfile/verificationType.hpp"
 #include "memory/gcLocker.hpp"
 #include "oops/klass.hpp"
@@ -348,6 +349,9 @@ class ClassVerifier : public StackObj {
   methodHandle        _method; // current method being verified
   VerificationType    _this_type; // the verification type of the current class
 
+  // Hierarchy checks this verification relies on, see VerificationCache
+  VerificationCacheEntry* _cache_entry;
+
   // Some recursive calls from the verifier to the name resolver
   // can cause the current class to be re-verified and rewritten.
   // If this happens, the original verification should not continue,
@@ -383,6 +387,20 @@ class ClassVerifier : public StackObj {
   // the message_buffer will be filled in with the exception message.
   void verify_class(TRAPS);
 
+  // The protected access check of is_protected_access(), without recording
+  static bool check_protected_access(
+    instanceKlassHandle this_class, Klass* target_class,
+    Symbol* field_name, Symbol* field_sig, bool is_method);
+
+  void record_assignability(Symbol* target, Symbol* from,
+                            bool from_field_is_protected, bool result) {
+    if (_cache_entry != NULL) {
+      _cache_entry->record_assignability(target, from, from_field_is_protected, result);
+    }
+  }
+  // Hand the recorded checks of a successful verification to the cache
+  void add_to_verification_cache();
+
   // Return status modes
   Symbol* result() const { return _exception_type; }
   bool has_error() const { return result() != NULL; }
@@ -393,6 +393,8 @@
   template(offset_name,                               "offset")                                   \
   template(count_name,                                "count")                                    \
   template(hash_name,                                 "hash")                                     \
+  template(coder_name,                                "coder")                                    \
+  template(compact_strings_name,                      "COMPACT_STRINGS")                          \
   template(numberOfLeadingZeros_name,                 "numberOfLeadingZeros")                     \
   template(numberOfTrailingZeros_name,                "numberOfTrailingZeros")                    \
   template(bitCount_name,                             "bitCount")                                 \
@@ -863,6 +865,8 @@
                                                                                                                         \
   do_intrinsic(_equalsC,                  java_util_Arrays,       equals_name,    equalsC_signature,             F_S)   \
    do_signature(equalsC_signature,                               "([C[C)Z")                                             \
+  do_intrinsic(_equalsB,                  java_util_Arrays,       equals_name,    equalsB_signature,             F_S)   \
+   do_signature(equalsB_signature,                               "([B[B)Z")                                             \
                                                                                                                         \
   do_intrinsic(_compareTo,                java_lang_String,       compareTo_name, string_int_signature,          F_R)   \
    do_name(     compareTo_name,                                  "compareTo")                                           \
@@ -870,6 +874,20 @@
    do_name(     indexOf_name,                                    "indexOf")                                             \
   do_intrinsic(_equals,                   java_lang_String,       equals_name, object_boolean_signature,         F_R)   \
                                                                                                                         \
+  /* Latin-1 helpers of a class library with compact strings (-XX:+CompactStrings) */                                 \
+  do_class(java_lang_StringLatin1,        "java/lang/StringLatin1")                                                     \
+  do_class(java_lang_StringUTF16,         "java/lang/StringUTF16")                                                      \
+  do_intrinsic(_equalsL,                  java_lang_StringLatin1, equals_name,    equalsB_signature,             F_S)   \
+  do_intrinsic(_compareToL,               java_lang_StringLatin1, compareTo_name, compareToL_signature,          F_S)   \
+   do_signature(compareToL_signature,                            "([B[B)I")                                             \
+  do_intrinsic(_indexOfL,                 java_lang_StringLatin1, indexOf_name,   indexOfL_signature,            F_S)   \
+   do_signature(indexOfL_signature,                              "([BI[BII)I")                                          \
+  do_intrinsic(_inflateStringB,           java_lang_StringLatin1, inflate_name,   inflateB_signature,            F_S)   \
+   do_name(     inflate_name,                                    "inflate")                                             \
+   do_signature(inflateB_signature,                              "([BI[CII)V")                                          \
+  do_intrinsic(_compressStringC,          java_lang_StringUTF16,  compress_name,  encodeISOArray_signature,      F_S)   \
+   do_name(     compress_name,                                   "compress")                                            \
+                                                                                                                        \
   do_class(java_nio_Buffer,               "java/nio/Buffer")                                                            \
   do_intrinsic(_checkIndex,               java_nio_Buffer,        checkIndex_name, int_int_signature,            F_R)   \
    do_name(     checkIndex_name,                                 "checkIndex")                                          \
@@ -1171,7 +1171,24 @@ void nmethod::clear_ic_stubs() {
 }
 
 
-void nmethod::cleanup_inline_caches() {
+static bool is_unloading_metadata(Metadata* md) {
+  Klass* klass = md->is_klass() ? (Klass*)md : ((Method*)md)->method_holder();
+  return klass->class_loader_data()->is_unloading();
+}
+
+// The metadata of unloading class loaders is not freed before the sweeper
+// has cleaned all inline caches, so it can still be inspected here.
+static bool ic_refers_to_unloading_metadata(CompiledIC* ic) {
+  if (ic->is_icholder_call()) {
+    CompiledICHolder* cichk = ic->cached_icholder();
+    return is_unloading_metadata(cichk->holder_metadata()) ||
+           is_unloading_metadata(cichk->holder_klass());
+  }
+  Metadata* md = ic->cached_metadata();
+  return md != NULL && is_unloading_metadata(md);
+}
+
+int nmethod::cleanup_inline_caches(bool clean_unloading_metadata) {
   assert_locked_or_safepoint(CompiledIC_lock);
 
   // If the method is not entrant or zombie then a JMP is plastered over the
@@ -1189,6 +1206,7 @@ void nmethod::cleanup_inline_caches() {
 
   // Find all calls in an nmethod and clear the ones that point to non-entrant,
   // zombie and unloaded nmethods.
+  int unloading_cleaned = 0;
   ResourceMark rm;
   RelocIterator iter(this, low_boundary);
   while(iter.next()) {
@@ -1196,6 +1214,12 @@ void nmethod::cleanup_inline_caches() {
       case relocInfo::virtual_call_type:
       case relocInfo::opt_virtual_call_type: {
         CompiledIC *ic = CompiledIC_at(&iter);
+        if (clean_unloading_metadata && iter.type() == relocInfo::virtual_call_type &&
+            ic_refers_to_unloading_metadata(ic)) {
+          ic->set_to_clean(is_alive());
+          unloading_cleaned++;
+          break;
+        }
         // Ok, to lookup references to zombies here
         CodeBlob *cb = CodeCache::find_blob_unsafe(ic->ic_destination());
         if( cb != NULL && cb->is_nmethod() ) {
@@ -1217,6 +1241,7 @@ void nmethod::cleanup_inline_caches() {
       }
     }
   }
+  return unloading_cleaned;
 }
 
 void nmethod::verify_clean_inline_caches() {
@@ -1759,6 +1784,14 @@ void nmethod::post_compiled_method_unload() {
 }
 
 void static clean_ic_if_metadata_is_dead(CompiledIC *ic, BoolObjectClosure *is_alive, bool mark_on_stack) {
+  // Classes unloaded by an earlier G1 remark that left the inline caches to
+  // the sweeper are still unloading. Their mirrors and loaders may already
+  // have been reclaimed, so they must not be passed to is_alive.
+  if (ic_refers_to_unloading_metadata(ic)) {
+    ic->set_to_clean();
+    return;
+  }
+
   if (ic->is_icholder_call()) {
     // The only exception is compiledICHolder oops which may
     // yet be marked below. (We check this further below).
@@ -1954,7 +1987,8 @@ void nmethod::mark_metadata_on_stack_non_relocs() {
     if (_method != NULL) Metadata::mark_on_stack(_method);
 }
 
-bool nmethod::do_unloading_parallel(BoolObjectClosure* is_alive, bool unloading_occurred) {
+bool nmethod::do_unloading_parallel(BoolObjectClosure* is_alive, bool unloading_occurred,
+                                    bool defer_ic_cleaning) {
   ResourceMark rm;
 
   // Make sure the oop's ready to receive visitors
@@ -1966,7 +2000,8 @@ bool nmethod::do_unloading_parallel(BoolObjectClosure* is_alive, bool unloading_
   // should not get GC'd.  Skip the first few bytes of oops on
   // not-entrant methods.
   address low_boundary = verified_entry_point();
-  if (is_not_entrant()) {
+  bool was_not_entrant = is_not_entrant();
+  if (was_not_entrant) {
     low_boundary += NativeJump::instruction_size;
     // %%% Note:  On SPARC we patch only a 4-byte trap, not a full NativeJump.
     // (See comment above.)
@@ -1982,6 +2017,8 @@ bool nmethod::do_unloading_parallel(BoolObjectClosure* is_alive, bool unloading_
     // of this nmethod is reported.
     unloading_occurred = true;
   }
+  assert(!defer_ic_cleaning || !a_class_was_redefined,
+         "inline caches must be walked to mark redefined metadata");
 
   // When class redefinition is used all metadata in the CodeCache has to be recorded,
   // so that unused "previous versions" can be purged. Since walking the CodeCache can
@@ -2000,6 +2037,9 @@ bool nmethod::do_unloading_parallel(BoolObjectClosure* is_alive, bool unloading_
     switch (iter.type()) {
 
     case relocInfo::virtual_call_type:
+      if (defer_ic_cleaning) {
+        break;
+      }
       if (unloading_occurred) {
         // If class unloading occurred we first iterate over all inline caches and
         // clear ICs where the cached oop is referring to an unloaded klass or method.
@@ -2010,11 +2050,15 @@ bool nmethod::do_unloading_parallel(BoolObjectClosure* is_alive, bool unloading_
       break;
 
     case relocInfo::opt_virtual_call_type:
-      postponed |= clean_if_nmethod_is_unloaded(CompiledIC_at(&iter), is_alive, this);
+      if (!defer_ic_cleaning) {
+        postponed |= clean_if_nmethod_is_unloaded(CompiledIC_at(&iter), is_alive, this);
+      }
       break;
 
     case relocInfo::static_call_type:
-      postponed |= clean_if_nmethod_is_unloaded(compiledStaticCall_at(iter.reloc()), is_alive, this);
+      if (!defer_ic_cleaning) {
+        postponed |= clean_if_nmethod_is_unloaded(compiledStaticCall_at(iter.reloc()), is_alive, this);
+      }
       break;
 
     case relocInfo::oop_type:
@@ -2034,25 +2078,33 @@ bool nmethod::do_unloading_parallel(BoolObjectClosure* is_alive, bool unloading_
     mark_metadata_on_stack_non_relocs();
   }
 
-  if (is_unloaded) {
-    return postponed;
-  }
-
-  // Scopes
-  for (oop* p = oops_begin(); p < oops_end(); p++) {
-    if (*p == Universe::non_oop_word())  continue;  // skip non-oops
-    if (can_unload(is_alive, p, unloading_occurred)) {
-      is_unloaded = true;
-      break;
+  if (!is_unloaded) {
+    // Scopes
+    for (oop* p = oops_begin(); p < oops_end(); p++) {
+      if (*p == Universe::non_oop_word())  continue;  // skip non-oops
+      if (can_unload(is_alive, p, unloading_occurred)) {
+        is_unloaded = true;
+        break;
+      }
     }
   }
 
   if (is_unloaded) {
+    if (defer_ic_cleaning && !was_not_entrant && !is_osr_method()) {
+      // Inline caches and static calls of other nmethods may still call
+      // this nmethod until the sweeper has cleaned them. Send those calls
+      // to be re-resolved, like for a not entrant nmethod.
+      NativeJump::patch_verified_entry(entry_point(), verified_entry_point(),
+                  SharedRuntime::get_handle_wrong_method_stub());
+    }
     return postponed;
   }
 
-  // Ensure that all metadata is still alive
-  verify_metadata_loaders(low_boundary, is_alive);
+  // Ensure that all metadata is still alive. Inline caches may still refer
+  // to dead metadata when their cleaning is deferred.
+  if (!defer_ic_cleaning) {
+    verify_metadata_loaders(low_boundary, is_alive);
+  }
 
   return postponed;
 }
@@ -581,7 +581,10 @@ public:
   // Inline cache support
   void clear_inline_caches();
   void clear_ic_stubs();
-  void cleanup_inline_caches();
+  // With clean_unloading_metadata, also clean inline caches that refer to
+  // classes of class loaders that are being unloaded. Returns the number of
+  // those inline caches.
+  int cleanup_inline_caches(bool clean_unloading_metadata = false);
   bool inlinecache_check_contains(address addr) const {
     return (addr >= code_begin() && addr < verified_entry_point());
   }
@@ -615,8 +618,10 @@ public:
 
   // GC support
   void do_unloading(BoolObjectClosure* is_alive, bool unloading_occurred);
-  //  The parallel versions are used by G1.
-  bool do_unloading_parallel(BoolObjectClosure* is_alive, bool unloading_occurred);
+  //  The parallel versions are used by G1. With defer_ic_cleaning only the
+  //  nmethods with dead oops are unloaded, inline caches are left to the sweeper.
+  bool do_unloading_parallel(BoolObjectClosure* is_alive, bool unloading_occurred,
+                             bool defer_ic_cleaning = false);
   void do_unloading_parallel_postponed(BoolObjectClosure* is_alive, bool unloading_occurred);
 
  private:
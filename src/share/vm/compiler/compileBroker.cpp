@@ -327,14 +327,14 @@ void CompileTask::initialize(int compile_id,
   _hot_method = NULL;
   _hot_method_holder = NULL;
   _hot_count = hot_count;
-  _time_queued = 0;  // tidy
+  _time_queued = os::elapsed_counter();
   _comment = comment;
   _failure_reason = NULL;
 
   _is_jwarmup_compilation = false;
+  _queue_index = -1;
 
   if (LogCompilation) {
-    _time_queued = os::elapsed_counter();
     if (hot_method.not_null()) {
       if (hot_method == method) {
         _hot_method = _method;
@@ -629,6 +629,16 @@ void CompileTask::log_task_done(CompileLog* log) {
 
 
 
+// Index of the decade value falls in, the first one ends at bound.
+static int histogram_bucket(jlong value, jlong bound) {
+  int i = 0;
+  while (i < CompileQueue::histogram_buckets - 1 && value >= bound) {
+    bound *= 10;
+    i++;
+  }
+  return i;
+}
+
 /**
  * Add a CompileTask to a CompileQueue
  */
@@ -652,6 +662,16 @@ void CompileQueue::add(CompileTask* task) {
     _last = task;
   }
   ++_size;
+  if (_first_unrated == NULL) {
+    _first_unrated = task;
+  }
+
+  if (UsePerfData) {
+    _perf_queue_length[histogram_bucket(_size, 10)]->inc();
+    if (_size > _perf_max_length->get_value()) {
+      _perf_max_length->set_value(_size);
+    }
+  }
 
   // Mark the method as being in the compile queue.
   task->method()->set_queued_for_compilation();
@@ -689,6 +709,11 @@ void CompileQueue::free_all() {
     CompileTask::free(current);
   }
   _first = NULL;
+  _first_unrated = NULL;
+  _rate_cursor = NULL;
+  if (_heap != NULL) {
+    _heap->clear();
+  }
 
   // Wake up all threads that block on the queue.
   lock()->notify_all();
@@ -740,7 +765,12 @@ CompileTask* CompileQueue::get() {
       // We need a timed wait here, since compiler threads can exit if compilation
       // is disabled forever. We use 5 seconds wait time; the exiting of compiler threads
       // is not critical and we do not want idle compiler threads to wake up too often.
-      lock()->wait(!Mutex::_no_safepoint_check_flag, 5*1000);
+      bool timeout = lock()->wait(!Mutex::_no_safepoint_check_flag, 5*1000);
+      if (timeout && NMethodSweeper::unloading_cleanup_pending()) {
+        // The metadata of unloaded classes waits for a sweep.
+        MutexUnlocker ul(lock());
+        NMethodSweeper::possibly_sweep();
+      }
     }
   }
 
@@ -755,6 +785,10 @@ CompileTask* CompileQueue::get() {
   }
   if (task != NULL) {
     remove(task);
+    if (UsePerfData) {
+      jlong waited = (os::elapsed_counter() - task->time_queued()) * 1000 / os::elapsed_frequency();
+      _perf_wait_time[histogram_bucket(waited, 1)]->inc();
+    }
   }
   purge_stale_tasks(); // may temporarily release MCQ lock
   return task;
@@ -785,6 +819,15 @@ void CompileQueue::purge_stale_tasks() {
 
 void CompileQueue::remove(CompileTask* task) {
    assert(lock()->owned_by_self(), "must own lock");
+  if (task->queue_index() >= 0) {
+    remove_rated(task);
+  }
+  if (task == _first_unrated) {
+    _first_unrated = task->next();
+  }
+  if (task == _rate_cursor) {
+    _rate_cursor = task->next();
+  }
   if (task->prev() != NULL) {
     task->prev()->set_next(task->next());
   } else {
@@ -811,6 +854,136 @@ void CompileQueue::remove_and_mark_stale(CompileTask* task) {
   task->set_next(_first_stale);
   task->set_prev(NULL);
   _first_stale = task;
+
+  if (UsePerfData) {
+    _perf_stale_tasks->inc();
+  }
+}
+
+// Returns the rated task to re-rate next, going round the queue. Tasks
+// that are removed in between are skipped, see remove().
+CompileTask* CompileQueue::next_to_rate() {
+  assert(lock()->owned_by_self(), "must own lock");
+  if (_rate_cursor == NULL || _rate_cursor == _first_unrated) {
+    _rate_cursor = _first;
+  }
+  CompileTask* task = _rate_cursor;
+  if (task == _first_unrated) {
+    // Nothing is rated
+    return NULL;
+  }
+  _rate_cursor = task->next();
+  return task;
+}
+
+// Rate the first unrated task, or re-rate a rated one, and move it to its
+// place in the priority queue.
+void CompileQueue::rate(CompileTask* task, int level, double weight) {
+  assert(lock()->owned_by_self(), "must own lock");
+  task->set_rating(level, weight);
+  if (task->queue_index() < 0) {
+    assert(task == _first_unrated, "tasks are rated in queue order");
+    _first_unrated = task->next();
+    if (_heap == NULL) {
+      _heap = new (ResourceObj::C_HEAP, mtCompiler) GrowableArray<CompileTask*>(64, true, mtCompiler);
+    }
+    _heap->append(task);
+    task->set_queue_index(_heap->length() - 1);
+    move_up(task->queue_index());
+  } else {
+    move_up(task->queue_index());
+    move_down(task->queue_index());
+  }
+}
+
+// Same order as AdvancedThresholdPolicy::compare_methods()
+bool CompileQueue::rated_higher(CompileTask* x, CompileTask* y) {
+  if (x->rated_level() != y->rated_level()) {
+    // recompilation after deopt
+    return x->rated_level() > y->rated_level();
+  }
+  return x->rated_weight() > y->rated_weight();
+}
+
+void CompileQueue::swap(int i, int j) {
+  CompileTask* tmp = _heap->at(i);
+  _heap->at_put(i, _heap->at(j));
+  _heap->at_put(j, tmp);
+  _heap->at(i)->set_queue_index(i);
+  _heap->at(j)->set_queue_index(j);
+}
+
+void CompileQueue::move_up(int i) {
+  while (i > 0) {
+    int p = (i - 1) / 2;
+    if (!rated_higher(_heap->at(i), _heap->at(p))) {
+      break;
+    }
+    swap(i, p);
+    i = p;
+  }
+}
+
+void CompileQueue::move_down(int i) {
+  int n = _heap->length();
+  while (true) {
+    int l = 2 * i + 1;
+    int r = l + 1;
+    int max = i;
+    if (l < n && rated_higher(_heap->at(l), _heap->at(max))) {
+      max = l;
+    }
+    if (r < n && rated_higher(_heap->at(r), _heap->at(max))) {
+      max = r;
+    }
+    if (max == i) {
+      break;
+    }
+    swap(i, max);
+    i = max;
+  }
+}
+
+void CompileQueue::remove_rated(CompileTask* task) {
+  int i = task->queue_index();
+  int last = _heap->length() - 1;
+  assert(_heap->at(i) == task, "sanity");
+  if (i != last) {
+    swap(i, last);
+  }
+  _heap->pop();
+  task->set_queue_index(-1);
+  if (i < _heap->length()) {
+    move_up(i);
+    move_down(i);
+  }
+}
+
+static const char* wait_time_names[CompileQueue::histogram_buckets] = {
+  "lt1ms", "lt10ms", "lt100ms", "lt1s", "lt10s", "ge10s"
+};
+
+static const char* queue_length_names[CompileQueue::histogram_buckets] = {
+  "lt10", "lt100", "lt1000", "lt10000", "lt100000", "ge100000"
+};
+
+void CompileQueue::init_perf_counters(const char* perf_name, TRAPS) {
+  if (UsePerfData) {
+    ResourceMark rm;
+    for (int i = 0; i < histogram_buckets; i++) {
+      char* name = PerfDataManager::counter_name(perf_name, "waitTime");
+      name = PerfDataManager::counter_name(name, wait_time_names[i]);
+      _perf_wait_time[i] = PerfDataManager::create_counter(SUN_CI, name, PerfData::U_Events, CHECK);
+
+      name = PerfDataManager::counter_name(perf_name, "length");
+      name = PerfDataManager::counter_name(name, queue_length_names[i]);
+      _perf_queue_length[i] = PerfDataManager::create_counter(SUN_CI, name, PerfData::U_Events, CHECK);
+    }
+    char* name = PerfDataManager::counter_name(perf_name, "maxLength");
+    _perf_max_length = PerfDataManager::create_variable(SUN_CI, name, PerfData::U_None, CHECK);
+    name = PerfDataManager::counter_name(perf_name, "staleTasks");
+    _perf_stale_tasks = PerfDataManager::create_counter(SUN_CI, name, PerfData::U_Events, CHECK);
+  }
 }
 
 // methods in the compile queue need to be marked as used on the stack
@@ -1106,10 +1279,12 @@ void CompileBroker::init_compiler_threads(int c1_compiler_count, int c2_compiler
   // Initialize the compilation queue
   if (c2_compiler_count > 0) {
     _c2_compile_queue  = new CompileQueue("C2 CompileQueue",  MethodCompileQueue_lock);
+    _c2_compile_queue->init_perf_counters("c2Queue", CHECK);
     _compilers[1]->set_num_compiler_threads(c2_compiler_count);
   }
   if (c1_compiler_count > 0) {
     _c1_compile_queue  = new CompileQueue("C1 CompileQueue",  MethodCompileQueue_lock);
+    _c1_compile_queue->init_perf_counters("c1Queue", CHECK);
     _compilers[0]->set_num_compiler_threads(c1_compiler_count);
   }
 
@@ -66,6 +66,10 @@ class CompileTask : public CHeapObj<mtCompiler> {
   const char*  _comment;      // more info about the task
   const char*  _failure_reason;
   bool         _is_jwarmup_compilation;
+  // Priority queue support, see CompileQueue::rate()
+  int          _queue_index;  // position in the priority queue, -1 if not rated
+  int          _rated_level;  // highest compiled level of the method when rated
+  double       _rated_weight; // weight of the method when rated
 
  public:
   CompileTask() {
@@ -110,6 +114,16 @@ class CompileTask : public CHeapObj<mtCompiler> {
   void         set_prev(CompileTask* prev)       { _prev = prev; }
   bool         is_free() const                   { return _is_free; }
   void         set_is_free(bool val)             { _is_free = val; }
+  jlong        time_queued() const               { return _time_queued; }
+
+  int          queue_index() const               { return _queue_index; }
+  void         set_queue_index(int index)        { _queue_index = index; }
+  int          rated_level() const               { return _rated_level; }
+  double       rated_weight() const              { return _rated_weight; }
+  void         set_rating(int level, double weight) {
+    _rated_level = level;
+    _rated_weight = weight;
+  }
 
 private:
   static void  print_compilation_impl(outputStream* st, Method* method, int compile_id, int comp_level,
@@ -197,7 +211,17 @@ class CompilerCounters : public CHeapObj<mtCompiler> {
 // CompileQueue
 //
 // A list of CompileTasks.
+//
+// With TieredCompileQueueBatchSize the rated tasks are also kept in a
+// binary max-heap, so that the policy can take the hottest task without
+// scanning the whole queue. Tasks are rated in queue order: all tasks
+// from _first_unrated on were queued after the last rating.
 class CompileQueue : public CHeapObj<mtCompiler> {
+ public:
+  enum {
+    histogram_buckets = 6
+  };
+
  private:
   const char* _name;
   Monitor*    _lock;
@@ -209,7 +233,26 @@ class CompileQueue : public CHeapObj<mtCompiler> {
 
   int _size;
 
+  GrowableArray<CompileTask*>* _heap;
+  CompileTask* _first_unrated;
+  CompileTask* _rate_cursor;     // next rated task to re-rate, round robin
+
+  // Histograms of the time tasks waited in the queue, and of the queue
+  // length seen by newly queued tasks, in decades.
+  PerfCounter*  _perf_wait_time[histogram_buckets];
+  PerfCounter*  _perf_queue_length[histogram_buckets];
+  PerfVariable* _perf_max_length;
+  PerfCounter*  _perf_stale_tasks;
+
   void purge_stale_tasks();
+
+  // Priority queue support
+  static bool rated_higher(CompileTask* x, CompileTask* y);
+  void swap(int i, int j);
+  void move_up(int i);
+  void move_down(int i);
+  void remove_rated(CompileTask* task);
+
  public:
   CompileQueue(const char* name, Monitor* lock) {
     _name = name;
@@ -218,8 +261,19 @@ class CompileQueue : public CHeapObj<mtCompiler> {
     _last = NULL;
     _size = 0;
     _first_stale = NULL;
+    _heap = NULL;
+    _first_unrated = NULL;
+    _rate_cursor = NULL;
+    for (int i = 0; i < histogram_buckets; i++) {
+      _perf_wait_time[i] = NULL;
+      _perf_queue_length[i] = NULL;
+    }
+    _perf_max_length = NULL;
+    _perf_stale_tasks = NULL;
   }
 
+  void         init_perf_counters(const char* perf_name, TRAPS);
+
   const char*  name() const                      { return _name; }
   Monitor*     lock() const                      { return _lock; }
 
@@ -234,6 +288,12 @@ class CompileQueue : public CHeapObj<mtCompiler> {
   bool         is_empty() const                  { return _first == NULL; }
   int          size()     const                  { return _size;          }
 
+  // Priority queue support, called with the queue locked
+  CompileTask* first_unrated() const             { return _first_unrated; }
+  int          rated_count() const               { return _heap == NULL ? 0 : _heap->length(); }
+  CompileTask* highest_rated() const             { return rated_count() == 0 ? NULL : _heap->at(0); }
+  CompileTask* next_to_rate();
+  void         rate(CompileTask* task, int level, double weight);
 
   // Redefine Classes support
   void mark_on_stack();
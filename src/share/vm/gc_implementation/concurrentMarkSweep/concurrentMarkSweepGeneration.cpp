@@ -41,6 +41,7 @@
 #include "gc_implementation/shared/gcTrace.hpp"
 #include "gc_implementation/shared/gcTraceTime.hpp"
 #include "gc_implementation/shared/isGCActiveMark.hpp"
+#include "gc_implementation/shared/parallelCleaning.hpp"
 #include "gc_interface/collectedHeap.inline.hpp"
 #include "memory/allocation.hpp"
 #include "memory/cardTableRS.hpp"
@@ -63,6 +64,7 @@
 #include "runtime/vmThread.hpp"
 #include "services/memoryService.hpp"
 #include "services/runtimeService.hpp"
+#include "utilities/quickSort.hpp"
 
 PRAGMA_FORMAT_MUTE_WARNINGS_FOR_GCC
 
@@ -580,6 +582,8 @@ CMSCollector::CMSCollector(ConcurrentMarkSweepGeneration* cmsGen,
   _survivor_chunk_array(NULL), // -- ditto --
   _survivor_chunk_capacity(0), // -- ditto --
   _survivor_chunk_index(0),    // -- ditto --
+  _eden_chunk_order(NULL),     // -- ditto --
+  _survivor_chunk_order(NULL), // -- ditto --
   _ser_pmc_preclean_ovflw(0),
   _ser_kac_preclean_ovflw(0),
   _ser_pmc_remark_ovflw(0),
@@ -790,6 +794,14 @@ CMSCollector::CMSCollector(ConcurrentMarkSweepGeneration* cmsGen,
              && _survivor_chunk_index == 0),
          "Error");
 
+  // Support for claiming the young gen chunks largest first
+  if (CMSParallelRemarkLargestChunksFirst) {
+    // One more task than samples per space, see
+    // initialize_sequential_subtasks_for_young_gen_rescan()
+    _eden_chunk_order = NEW_C_HEAP_ARRAY(uint, _eden_chunk_capacity + 1, mtGC);
+    _survivor_chunk_order = NEW_C_HEAP_ARRAY(uint, _survivor_chunk_capacity + 1, mtGC);
+  }
+
   NOT_PRODUCT(_overflow_counter = CMSMarkStackOverflowInterval;)
   _gc_counters = new CollectorCounters("CMS", 1);
   _completed_initialization = true;
@@ -3640,7 +3652,8 @@ class CMSParMarkTask : public AbstractGangTask {
   // Work method in support of parallel rescan ... of young gen spaces
   void do_young_space_rescan(uint worker_id, OopsInGenClosure* cl,
                              ContiguousSpace* space,
-                             HeapWord** chunk_array, size_t chunk_top);
+                             HeapWord** chunk_array, size_t chunk_top,
+                             uint* chunk_order);
   void work_on_young_gen_roots(uint worker_id, OopsInGenClosure* cl);
 };
 
@@ -3758,6 +3771,7 @@ void CMSCollector::checkpointRootsInitialWork(bool asynch) {
       assert(workers != NULL, "Need parallel worker threads.");
       int n_workers = workers->active_workers();
       phase_times->note_gc_start(n_workers);
+      phase_times->note_cms_mark_start(false /* remark */);
       CMSParInitialMarkTask tsk(this, n_workers);
       gch->set_par_threads(n_workers);
       initialize_sequential_subtasks_for_young_gen_rescan(n_workers);
@@ -5272,6 +5286,7 @@ void CMSParInitialMarkTask::work(uint worker_id) {
 
   // ---------- young gen roots --------------
   {
+    GenGCParPhaseTimesTracker x(phase_times, GenGCPhaseTimes::YoungGenRescan, worker_id);
     work_on_young_gen_roots(worker_id, &par_mri_cl);
     _timer.stop();
     if (PrintCMSStatistics != 0) {
@@ -5317,6 +5332,11 @@ class CMSParRemarkTask: public CMSParMarkTask {
   OopTaskQueueSet*       _task_queues;
   ParallelTaskTerminator _term;
 
+  // The new CLDs are scanned by the first worker to get to them, the
+  // dirty klasses are claimed one by one by all workers.
+  volatile jint                           _new_clds_claimed;
+  ClassLoaderDataGraphKlassIteratorAtomic _klass_iterator;
+
  public:
   // A value of 0 passed to n_workers will cause the number of
   // workers to be taken from the active workers in the work gang.
@@ -5328,7 +5348,9 @@ class CMSParRemarkTask: public CMSParMarkTask {
                    collector, n_workers),
     _cms_space(cms_space),
     _task_queues(task_queues),
-    _term(n_workers, task_queues) { }
+    _term(n_workers, task_queues),
+    _new_clds_claimed(0),
+    _klass_iterator() { }
 
   OopTaskQueueSet* task_queues() { return _task_queues; }
 
@@ -5346,6 +5368,12 @@ class CMSParRemarkTask: public CMSParMarkTask {
 
   // ... work stealing for the above
   void do_work_steal(int i, Par_MarkRefsIntoAndScanClosure* cl, int* seed);
+
+  // ... of the new class loader data introduced during concurrent marking
+  void do_new_cld_rescan(Par_MarkRefsIntoAndScanClosure* cl);
+
+  // ... of the classes dirtied during concurrent marking
+  void do_dirty_klass_rescan(Par_MarkRefsIntoAndScanClosure* cl);
 };
 
 class RemarkKlassClosure : public KlassClosure {
@@ -5385,9 +5413,13 @@ void CMSParMarkTask::work_on_young_gen_roots(uint worker_id, OopsInGenClosure* c
   assert(ect <= _collector->_eden_chunk_capacity, "out of bounds");
   assert(sct <= _collector->_survivor_chunk_capacity, "out of bounds");
 
-  do_young_space_rescan(worker_id, cl, to_space, NULL, 0);
-  do_young_space_rescan(worker_id, cl, from_space, sca, sct);
-  do_young_space_rescan(worker_id, cl, eden_space, eca, ect);
+  // The chunk orders are only set up for more than one worker.
+  uint* eco = _n_workers > 1 ? _collector->_eden_chunk_order : NULL;
+  uint* sco = _n_workers > 1 ? _collector->_survivor_chunk_order : NULL;
+
+  do_young_space_rescan(worker_id, cl, to_space, NULL, 0, NULL);
+  do_young_space_rescan(worker_id, cl, from_space, sca, sct, sco);
+  do_young_space_rescan(worker_id, cl, eden_space, eca, ect, eco);
 }
 
 // work_queue(i) is passed to the closure
@@ -5416,6 +5448,7 @@ void CMSParRemarkTask::work(uint worker_id) {
   // work first.
   // ---------- young gen roots --------------
   {
+    GenGCParPhaseTimesTracker x(phase_times, GenGCPhaseTimes::YoungGenRescan, worker_id);
     work_on_young_gen_roots(worker_id, &par_mrias_cl);
     _timer.stop();
     if (PrintCMSStatistics != 0) {
@@ -5450,21 +5483,11 @@ void CMSParRemarkTask::work(uint worker_id) {
   }
 
   // ---------- unhandled CLD scanning ----------
-  if (worker_id == 0) { // Single threaded at the moment.
+  {
+    GenGCParPhaseTimesTracker x(phase_times, GenGCPhaseTimes::NewCLDScan, worker_id);
     _timer.reset();
     _timer.start();
-
-    // Scan all new class loader data objects and new dependencies that were
-    // introduced during concurrent marking.
-    ResourceMark rm;
-    GrowableArray<ClassLoaderData*>* array = ClassLoaderDataGraph::new_clds();
-    for (int i = 0; i < array->length(); i++) {
-      par_mrias_cl.do_class_loader_data(array->at(i));
-    }
-
-    // We don't need to keep track of new CLDs anymore.
-    ClassLoaderDataGraph::remember_new_clds(false);
-
+    do_new_cld_rescan(&par_mrias_cl);
     _timer.stop();
     if (PrintCMSStatistics != 0) {
       gclog_or_tty->print_cr(
@@ -5474,14 +5497,11 @@ void CMSParRemarkTask::work(uint worker_id) {
   }
 
   // ---------- dirty klass scanning ----------
-  if (worker_id == 0) { // Single threaded at the moment.
+  {
+    GenGCParPhaseTimesTracker x(phase_times, GenGCPhaseTimes::DirtyKlassScan, worker_id);
     _timer.reset();
     _timer.start();
-
-    // Scan all classes that was dirtied during the concurrent marking phase.
-    RemarkKlassClosure remark_klass_closure(&par_mrias_cl);
-    ClassLoaderDataGraph::classes_do(&remark_klass_closure);
-
+    do_dirty_klass_rescan(&par_mrias_cl);
     _timer.stop();
     if (PrintCMSStatistics != 0) {
       gclog_or_tty->print_cr(
@@ -5497,43 +5517,75 @@ void CMSParRemarkTask::work(uint worker_id) {
   // we don't have to revisit the _handles block during the remark phase.
 
   // ---------- rescan dirty cards ------------
-  _timer.reset();
-  _timer.start();
+  {
+    GenGCParPhaseTimesTracker x(phase_times, GenGCPhaseTimes::DirtyCardRescan, worker_id);
+    _timer.reset();
+    _timer.start();
 
-  // Do the rescan tasks for each of the two spaces
-  // (cms_space) in turn.
-  // "worker_id" is passed to select the task_queue for "worker_id"
-  do_dirty_card_rescan_tasks(_cms_space, worker_id, &par_mrias_cl);
-  _timer.stop();
-  if (PrintCMSStatistics != 0) {
-    gclog_or_tty->print_cr(
-      "Finished dirty card rescan work in %dth thread: %3.3f sec",
-      worker_id, _timer.seconds());
+    // Do the rescan tasks for each of the two spaces
+    // (cms_space) in turn.
+    // "worker_id" is passed to select the task_queue for "worker_id"
+    do_dirty_card_rescan_tasks(_cms_space, worker_id, &par_mrias_cl);
+    _timer.stop();
+    if (PrintCMSStatistics != 0) {
+      gclog_or_tty->print_cr(
+        "Finished dirty card rescan work in %dth thread: %3.3f sec",
+        worker_id, _timer.seconds());
+    }
   }
 
   // ---------- steal work from other threads ...
   // ---------- ... and drain overflow list.
-  _timer.reset();
-  _timer.start();
-  do_work_steal(worker_id, &par_mrias_cl, _collector->hash_seed(worker_id));
-  _timer.stop();
-  if (PrintCMSStatistics != 0) {
-    gclog_or_tty->print_cr(
-      "Finished work stealing in %dth thread: %3.3f sec",
-      worker_id, _timer.seconds());
+  {
+    GenGCParPhaseTimesTracker x(phase_times, GenGCPhaseTimes::WorkStealing, worker_id);
+    _timer.reset();
+    _timer.start();
+    do_work_steal(worker_id, &par_mrias_cl, _collector->hash_seed(worker_id));
+    _timer.stop();
+    if (PrintCMSStatistics != 0) {
+      gclog_or_tty->print_cr(
+        "Finished work stealing in %dth thread: %3.3f sec",
+        worker_id, _timer.seconds());
+    }
   }
   phase_times->record_time_secs(GenGCPhaseTimes::GCWorkerEnd, worker_id, os::elapsedTime());
 }
 
+// The boundaries of the nth_task-th chunk of a young gen space that was
+// partitioned by the chunk_top samples in chunk_array.
+static MemRegion young_gen_chunk(ContiguousSpace* space,
+                                 HeapWord** chunk_array, size_t chunk_top,
+                                 uint nth_task) {
+  HeapWord *start, *end;
+  if (chunk_top == 0) {  // no samples were taken
+    assert(nth_task == 0, "Can have only 1 task without samples");
+    start = space->bottom();
+    end   = space->top();
+  } else if (nth_task == 0) {
+    start = space->bottom();
+    end   = chunk_array[nth_task];
+  } else if (nth_task < (uint)chunk_top) {
+    assert(nth_task >= 1, "Control point invariant");
+    start = chunk_array[nth_task - 1];
+    end   = chunk_array[nth_task];
+  } else {
+    assert(nth_task == (uint)chunk_top, "Control point invariant");
+    start = chunk_array[chunk_top - 1];
+    end   = space->top();
+  }
+  return MemRegion(start, end);
+}
+
 // Note that parameter "i" is not used.
 void
 CMSParMarkTask::do_young_space_rescan(uint worker_id,
   OopsInGenClosure* cl, ContiguousSpace* space,
-  HeapWord** chunk_array, size_t chunk_top) {
+  HeapWord** chunk_array, size_t chunk_top, uint* chunk_order) {
   // Until all tasks completed:
   // . claim an unclaimed task
   // . compute region boundaries corresponding to task claimed
-  //   using chunk_array
+  //   using chunk_array (and chunk_order if the chunks are not
+  //   claimed in address order)
   // . par_oop_iterate(cl) over that region
 
   ResourceMark rm;
@@ -5546,26 +5598,11 @@ CMSParMarkTask::do_young_space_rescan(uint worker_id,
 
   if (n_tasks > 0) {
     assert(pst->valid(), "Uninitialized use?");
-    HeapWord *start, *end;
+    assert(n_tasks == chunk_top + 1, "One task per chunk");
     while (!pst->is_task_claimed(/* reference */ nth_task)) {
       // We claimed task # nth_task; compute its boundaries.
-      if (chunk_top == 0) {  // no samples were taken
-        assert(nth_task == 0 && n_tasks == 1, "Can have only 1 EdenSpace task");
-        start = space->bottom();
-        end   = space->top();
-      } else if (nth_task == 0) {
-        start = space->bottom();
-        end   = chunk_array[nth_task];
-      } else if (nth_task < (uint)chunk_top) {
-        assert(nth_task >= 1, "Control point invariant");
-        start = chunk_array[nth_task - 1];
-        end   = chunk_array[nth_task];
-      } else {
-        assert(nth_task == (uint)chunk_top, "Control point invariant");
-        start = chunk_array[chunk_top - 1];
-        end   = space->top();
-      }
-      MemRegion mr(start, end);
+      uint nth_chunk = (chunk_order != NULL) ? chunk_order[nth_task] : nth_task;
+      MemRegion mr = young_gen_chunk(space, chunk_array, chunk_top, nth_chunk);
       // Verify that mr is in space
       assert(mr.is_empty() || space->used_region().contains(mr),
              "Should be in space");
@@ -5578,6 +5615,33 @@ CMSParMarkTask::do_young_space_rescan(uint worker_id,
   }
 }
 
+void CMSParRemarkTask::do_new_cld_rescan(Par_MarkRefsIntoAndScanClosure* cl) {
+  if (_new_clds_claimed != 0 ||
+      Atomic::cmpxchg(1, &_new_clds_claimed, 0) != 0) {
+    return;
+  }
+
+  // Scan all new class loader data objects and new dependencies that were
+  // introduced during concurrent marking.
+  ResourceMark rm;
+  GrowableArray<ClassLoaderData*>* array = ClassLoaderDataGraph::new_clds();
+  for (int i = 0; i < array->length(); i++) {
+    cl->do_class_loader_data(array->at(i));
+  }
+
+  // We don't need to keep track of new CLDs anymore.
+  ClassLoaderDataGraph::remember_new_clds(false);
+}
+
+void CMSParRemarkTask::do_dirty_klass_rescan(Par_MarkRefsIntoAndScanClosure* cl) {
+  // Scan all classes that was dirtied during the concurrent marking phase.
+  RemarkKlassClosure remark_klass_closure(cl);
+  Klass* klass;
+  while ((klass = _klass_iterator.next_klass()) != NULL) {
+    remark_klass_closure.do_klass(klass);
+  }
+}
+
 void
 CMSParRemarkTask::do_dirty_card_rescan_tasks(
   CompactibleFreeListSpace* sp, int i,
@@ -5842,6 +5906,43 @@ void CMSCollector::merge_survivor_plab_arrays(ContiguousSpace* surv,
   #endif // ASSERT
 }
 
+// Sorts chunk indexes by decreasing size of the chunks.
+class YoungGenChunkSizeComparator VALUE_OBJ_CLASS_SPEC {
+  ContiguousSpace* _space;
+  HeapWord**       _chunk_array;
+  size_t           _chunk_top;
+
+ public:
+  YoungGenChunkSizeComparator(ContiguousSpace* space, HeapWord** chunk_array, size_t chunk_top) :
+    _space(space), _chunk_array(chunk_array), _chunk_top(chunk_top) { }
+
+  int operator()(uint a, uint b) const {
+    size_t size_a = young_gen_chunk(_space, _chunk_array, _chunk_top, a).word_size();
+    size_t size_b = young_gen_chunk(_space, _chunk_array, _chunk_top, b).word_size();
+    if (size_a > size_b) {
+      return -1;
+    } else if (size_a < size_b) {
+      return 1;
+    }
+    return 0;
+  }
+};
+
+// Large chunks claimed at the end of the young gen rescan leave the
+// other workers idle, so hand them out first.
+static void order_young_gen_chunks(uint* chunk_order, ContiguousSpace* space,
+                                   HeapWord** chunk_array, size_t chunk_top) {
+  if (chunk_order == NULL) {
+    return;
+  }
+  uint n_tasks = (uint)chunk_top + 1;
+  for (uint i = 0; i < n_tasks; i++) {
+    chunk_order[i] = i;
+  }
+  YoungGenChunkSizeComparator comparator(space, chunk_array, chunk_top);
+  QuickSort::sort<uint, YoungGenChunkSizeComparator>(chunk_order, (int)n_tasks, comparator, true);
+}
+
 // Set up the space's par_seq_tasks structure for work claiming
 // for parallel initial scan and rescan of young gen.
 // See ParRescanTask where this is currently used.
@@ -5894,6 +5995,13 @@ initialize_sequential_subtasks_for_young_gen_rescan(int n_threads) {
     pst->set_n_tasks((int)n_tasks);
     assert(pst->valid(), "Error");
   }
+
+  if (n_threads > 1) {
+    order_young_gen_chunks(_eden_chunk_order, dng->eden(),
+                           _eden_chunk_array, _eden_chunk_index);
+    order_young_gen_chunks(_survivor_chunk_order, dng->from(),
+                           _survivor_chunk_array, _survivor_chunk_index);
+  }
 }
 
 // Parallel version of remark
@@ -5942,6 +6050,7 @@ void CMSCollector::do_remark_parallel() {
 
   GenGCPhaseTimes* phase_times = gch->gen_policy()->phase_times();
   phase_times->note_gc_start(n_workers);
+  phase_times->note_cms_mark_start(true /* remark */);
   // It turns out that even when we're using 1 thread, doing the work in a
   // separate thread causes wide variance in run times.  We can't help this
   // in the multi-threaded case, but we special-case n=1 here to get
@@ -6316,29 +6425,31 @@ void CMSCollector::refProcessingWork(bool asynch, bool clear_all_soft_refs) {
   verify_work_stacks_empty();
 
   if (should_unload_classes()) {
+    FlexibleWorkGang* cleaning_workers = CMSParallelRemarkEnabled ? GenCollectedHeap::heap()->workers() : NULL;
     {
       GCTraceTime t("class unloading", PrintGCDetails, false, _gc_timer_cm, _gc_tracer_cm->gc_id());
 
-      // Unload classes and purge the SystemDictionary.
-      bool purged_class = SystemDictionary::do_unloading(&_is_alive_closure);
-
-      // Unload nmethods.
-      CodeCache::do_unloading(&_is_alive_closure, purged_class);
-
-      // Prune dead klasses from subklass/sibling/implementor lists.
-      Klass::clean_weak_klass_links(&_is_alive_closure);
+      // Unload classes, nmethods and prune dead klasses from
+      // subklass/sibling/implementor lists.
+      ParallelCleaning::unload_classes(&_is_alive_closure, cleaning_workers);
     }
 
-    {
-      GCTraceTime t("scrub symbol table", PrintGCDetails, false, _gc_timer_cm, _gc_tracer_cm->gc_id());
-      // Clean up unreferenced symbols in symbol table.
-      SymbolTable::unlink();
-    }
+    if (ParallelCleaning::use_workers(cleaning_workers)) {
+      GCTraceTime t("scrub string and symbol tables", PrintGCDetails, false, _gc_timer_cm, _gc_tracer_cm->gc_id());
+      // Both tables are scrubbed by the workers at the same time.
+      ParallelCleaning::unlink_string_and_symbol_tables(&_is_alive_closure, cleaning_workers);
+    } else {
+      {
+        GCTraceTime t("scrub symbol table", PrintGCDetails, false, _gc_timer_cm, _gc_tracer_cm->gc_id());
+        // Clean up unreferenced symbols in symbol table.
+        SymbolTable::unlink();
+      }
 
-    {
-      GCTraceTime t("scrub string table", PrintGCDetails, false, _gc_timer_cm, _gc_tracer_cm->gc_id());
-      // Delete entries for dead interned strings.
-      StringTable::unlink(&_is_alive_closure);
+      {
+        GCTraceTime t("scrub string table", PrintGCDetails, false, _gc_timer_cm, _gc_tracer_cm->gc_id());
+        // Delete entries for dead interned strings.
+        StringTable::unlink(&_is_alive_closure);
+      }
     }
   }
 
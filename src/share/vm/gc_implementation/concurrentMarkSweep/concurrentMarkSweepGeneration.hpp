@@ -764,6 +764,11 @@ class CMSCollector: public CHeapObj<mtGC> {
   size_t*    _cursor;
   ChunkArray* _survivor_plab_array;
 
+  // Orders in which the parallel workers claim the eden and survivor
+  // chunks above, largest chunk first (CMSParallelRemarkLargestChunksFirst)
+  uint*      _eden_chunk_order;
+  uint*      _survivor_chunk_order;
+
   // A bounded minimum size of PLABs, should not return too small values since
   // this will affect the size of the data structures used for parallel young gen rescan
   size_t plab_sample_minimum_size();
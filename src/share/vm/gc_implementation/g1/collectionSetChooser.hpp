@@ -98,6 +98,19 @@ public:
     _curr_index += 1;
   }
 
+  // Undo the most recent remove_and_move_to_next() of the given region,
+  // making it the current candidate again. Used for optional CSet
+  // regions that were not evacuated; several regions have to be pushed
+  // back in the reverse order of their removal.
+  void push_back(HeapRegion* hr) {
+    assert(hr != NULL, "pre-condition");
+    assert(_curr_index > 0, "pre-condition");
+    assert(regions_at(_curr_index - 1) == NULL, "pre-condition");
+    _curr_index -= 1;
+    regions_at_put(_curr_index, hr);
+    _remaining_reclaimable_bytes += hr->reclaimable_bytes();
+  }
+
   CollectionSetChooser();
 
   void sort_regions();
@@ -1364,6 +1364,10 @@ void ConcurrentMark::checkpointRootsFinal(bool clear_all_soft_refs) {
     assert(!restart_for_overflow(), "sanity");
     // Completely reset the marking state since marking completed
     set_non_marking_state();
+
+    // Periodic GCs rely on this to give memory back to the operating
+    // system without a Full GC.
+    g1h->resize_heap_after_remark();
   }
 
   // Expand the marking stack, if we have to and if we can.
@@ -2612,7 +2616,8 @@ void ConcurrentMark::weakRefsWork(bool clear_all_soft_refs) {
 
       {
         G1RemarkGCTraceTime trace("System Dictionary Unloading", G1Log::finest());
-        purged_classes = SystemDictionary::do_unloading(&g1_is_alive, false /* Defer klass cleaning */);
+        purged_classes = SystemDictionary::do_unloading(&g1_is_alive, false /* Defer klass cleaning */,
+                                                        _g1h->workers());
       }
 
       {
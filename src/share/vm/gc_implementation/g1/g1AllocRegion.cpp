@@ -238,7 +238,8 @@ G1AllocRegion::G1AllocRegion(const char* name,
                              bool bot_updates)
   : _name(name), _bot_updates(bot_updates),
     _alloc_region(NULL), _count(0), _used_bytes_before(0),
-    _allocation_context(AllocationContext::system()) { }
+    _allocation_context(AllocationContext::system()),
+    _node_index(G1NUMA::AnyNodeIndex) { }
 
 
 HeapRegion* MutatorAllocRegion::allocate_new_region(size_t word_size,
@@ -249,7 +250,7 @@ HeapRegion* MutatorAllocRegion::allocate_new_region(size_t word_size,
     return NULL;
   }
 
-  return _g1h->new_mutator_alloc_region(word_size, force);
+  return _g1h->new_mutator_alloc_region(word_size, force, node_index());
 }
 
 void MutatorAllocRegion::retire_region(HeapRegion* alloc_region,
@@ -265,7 +266,9 @@ void MutatorAllocRegion::retire_region(HeapRegion* alloc_region,
 HeapRegion* SurvivorGCAllocRegion::allocate_new_region(size_t word_size,
                                                        bool force) {
   assert(!force, "not supported for GC alloc regions");
-  return _g1h->new_gc_alloc_region(word_size, count(), InCSetState::Young);
+  // The per-node alloc regions share the limit on the number of regions.
+  uint total_count = _g1h->allocator()->gc_alloc_region_count(InCSetState::Young, allocation_context());
+  return _g1h->new_gc_alloc_region(word_size, total_count, InCSetState::Young, node_index());
 }
 
 void SurvivorGCAllocRegion::retire_region(HeapRegion* alloc_region,
@@ -281,7 +284,9 @@ void SurvivorGCAllocRegion::retire_region(HeapRegion* alloc_region,
 HeapRegion* OldGCAllocRegion::allocate_new_region(size_t word_size,
                                                   bool force) {
   assert(!force, "not supported for GC alloc regions");
-  return _g1h->new_gc_alloc_region(word_size, count(), InCSetState::Old);
+  // The per-node alloc regions share the limit on the number of regions.
+  uint total_count = _g1h->allocator()->gc_alloc_region_count(InCSetState::Old, allocation_context());
+  return _g1h->new_gc_alloc_region(word_size, total_count, InCSetState::Old, node_index());
 }
 
 void OldGCAllocRegion::retire_region(HeapRegion* alloc_region,
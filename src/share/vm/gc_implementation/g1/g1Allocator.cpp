@@ -29,13 +29,42 @@
 #include "gc_implementation/g1/heapRegion.inline.hpp"
 #include "gc_implementation/g1/heapRegionSet.inline.hpp"
 
+G1DefaultAllocator::G1DefaultAllocator(G1CollectedHeap* heap) :
+  G1Allocator(heap),
+  _num_alloc_regions(_numa->num_active_nodes()),
+  _mutator_alloc_regions(NULL),
+  _survivor_gc_alloc_regions(NULL),
+  _old_gc_alloc_regions(NULL),
+  _retained_old_gc_alloc_regions(NULL) {
+
+  _mutator_alloc_regions = NEW_C_HEAP_ARRAY(MutatorAllocRegion, _num_alloc_regions, mtGC);
+  _survivor_gc_alloc_regions = NEW_C_HEAP_ARRAY(SurvivorGCAllocRegion, _num_alloc_regions, mtGC);
+  _old_gc_alloc_regions = NEW_C_HEAP_ARRAY(OldGCAllocRegion, _num_alloc_regions, mtGC);
+  _retained_old_gc_alloc_regions = NEW_C_HEAP_ARRAY(HeapRegion*, _num_alloc_regions, mtGC);
+
+  for (uint i = 0; i < _num_alloc_regions; i++) {
+    ::new(_mutator_alloc_regions + i) MutatorAllocRegion();
+    ::new(_survivor_gc_alloc_regions + i) SurvivorGCAllocRegion();
+    ::new(_old_gc_alloc_regions + i) OldGCAllocRegion();
+    _retained_old_gc_alloc_regions[i] = NULL;
+
+    if (_numa->is_enabled()) {
+      _mutator_alloc_regions[i].set_node_index(i);
+      _survivor_gc_alloc_regions[i].set_node_index(i);
+      _old_gc_alloc_regions[i].set_node_index(i);
+    }
+  }
+}
+
 void G1DefaultAllocator::init_mutator_alloc_region() {
   if (TenantHeapIsolation) {
     G1TenantAllocationContexts::init_mutator_alloc_regions();
   }
 
-  assert(_mutator_alloc_region.get() == NULL, "pre-condition");
-  _mutator_alloc_region.init();
+  for (uint i = 0; i < _num_alloc_regions; i++) {
+    assert(_mutator_alloc_regions[i].get() == NULL, "pre-condition");
+    _mutator_alloc_regions[i].init();
+  }
 }
 
 void G1DefaultAllocator::release_mutator_alloc_region() {
@@ -43,35 +72,58 @@ void G1DefaultAllocator::release_mutator_alloc_region() {
     G1TenantAllocationContexts::release_mutator_alloc_regions();
   }
 
-  _mutator_alloc_region.release();
-  assert(_mutator_alloc_region.get() == NULL, "post-condition");
+  for (uint i = 0; i < _num_alloc_regions; i++) {
+    _mutator_alloc_regions[i].release();
+    assert(_mutator_alloc_regions[i].get() == NULL, "post-condition");
+  }
 }
 
-MutatorAllocRegion* G1DefaultAllocator::mutator_alloc_region(AllocationContext_t context) {
+MutatorAllocRegion* G1DefaultAllocator::mutator_alloc_region(AllocationContext_t context, uint node_index) {
   if (TenantHeapIsolation && !context.is_system()) {
     G1TenantAllocationContext* tac = context.tenant_allocation_context();
     assert(NULL != tac, "Tenant alloc context cannot be NULL");
     return tac->mutator_alloc_region();
   }
-  return &_mutator_alloc_region;
+  assert(node_index < _num_alloc_regions,
+         err_msg("Invalid node index %u, number of alloc regions %u", node_index, _num_alloc_regions));
+  return &_mutator_alloc_regions[node_index];
 }
 
-SurvivorGCAllocRegion* G1DefaultAllocator::survivor_gc_alloc_region(AllocationContext_t context) {
+SurvivorGCAllocRegion* G1DefaultAllocator::survivor_gc_alloc_region(AllocationContext_t context, uint node_index) {
   if (TenantHeapIsolation && !context.is_system()) {
     G1TenantAllocationContext* tac = context.tenant_allocation_context();
     assert(NULL != tac, "Tenant alloc context cannot be NULL");
     return tac->survivor_gc_alloc_region();
   }
-  return &_survivor_gc_alloc_region;
+  assert(node_index < _num_alloc_regions,
+         err_msg("Invalid node index %u, number of alloc regions %u", node_index, _num_alloc_regions));
+  return &_survivor_gc_alloc_regions[node_index];
 }
 
-OldGCAllocRegion* G1DefaultAllocator::old_gc_alloc_region(AllocationContext_t context) {
+OldGCAllocRegion* G1DefaultAllocator::old_gc_alloc_region(AllocationContext_t context, uint node_index) {
   if (TenantHeapIsolation && !context.is_system()) {
     G1TenantAllocationContext* tac = context.tenant_allocation_context();
     assert(NULL != tac, "Tenant alloc context cannot be NULL");
     return tac->old_gc_alloc_region();
   }
-  return &_old_gc_alloc_region;
+  assert(node_index < _num_alloc_regions,
+         err_msg("Invalid node index %u, number of alloc regions %u", node_index, _num_alloc_regions));
+  return &_old_gc_alloc_regions[node_index];
+}
+
+uint G1DefaultAllocator::gc_alloc_region_count(InCSetState dest, AllocationContext_t context) {
+  if (TenantHeapIsolation && !context.is_system()) {
+    G1TenantAllocationContext* tac = context.tenant_allocation_context();
+    assert(NULL != tac, "Tenant alloc context cannot be NULL");
+    return dest.is_young() ? tac->survivor_gc_alloc_region()->count()
+                           : tac->old_gc_alloc_region()->count();
+  }
+  uint result = 0;
+  for (uint i = 0; i < _num_alloc_regions; i++) {
+    result += dest.is_young() ? _survivor_gc_alloc_regions[i].count()
+                              : _old_gc_alloc_regions[i].count();
+  }
+  return result;
 }
 
 size_t G1DefaultAllocator::used() {
@@ -79,20 +131,18 @@ size_t G1DefaultAllocator::used() {
          "Should be owned on this thread's behalf.");
   size_t result = _summary_bytes_used;
 
-  if (TenantHeapIsolation) {
-    // root tenant's
-    HeapRegion* hr = mutator_alloc_region(AllocationContext::system())->get();
-    if (NULL != hr) { result += hr->used(); }
-
-    result += G1TenantAllocationContexts::total_used();
-  } else {
-    // TenantHeapIsolation disabled mode
+  // root tenant's, or all of them if TenantHeapIsolation is disabled
+  for (uint i = 0; i < _num_alloc_regions; i++) {
     // Read only once in case it is set to NULL concurrently
-    HeapRegion* hr = mutator_alloc_region(AllocationContext::current())->get();
+    HeapRegion* hr = _mutator_alloc_regions[i].get();
     if (hr != NULL) {
       result += hr->used();
     }
   }
+
+  if (TenantHeapIsolation) {
+    result += G1TenantAllocationContexts::total_used();
+  }
   return result;
 }
 
@@ -110,7 +160,8 @@ void G1Allocator::reuse_retained_old_region(EvacuationInfo& evacuation_info,
   });
 
   // We will discard the current GC alloc region if:
-  // a) it's in the collection set (it can happen!),
+  // a) it's in the collection set (it can happen!) or in the optional
+  // part of it,
   // b) it's already full (no point in using it),
   // c) it's empty (this means that it was emptied during
   // a cleanup and it should be on the free list now), or
@@ -120,6 +171,7 @@ void G1Allocator::reuse_retained_old_region(EvacuationInfo& evacuation_info,
   // object that may be less than the region size).
   if (retained_region != NULL &&
       !retained_region->in_collection_set() &&
+      !_g1h->is_optional_region(retained_region) &&
       !(retained_region->top() == retained_region->end()) &&
       !retained_region->is_empty() &&
       !retained_region->isHumongous()) {
@@ -134,8 +186,8 @@ void G1Allocator::reuse_retained_old_region(EvacuationInfo& evacuation_info,
     old->set(retained_region);
     _g1h->_hr_printer.reuse(retained_region);
 
-    // Do accumulation in tenant mode, otherwise just set it
-    if (TenantHeapIsolation) {
+    // Do accumulation in tenant mode or with per-node regions, otherwise just set it
+    if (TenantHeapIsolation || _numa->is_enabled()) {
       evacuation_info.increment_alloc_regions_used_before(retained_region->used());
     } else {
       evacuation_info.set_alloc_regions_used_before(retained_region->used());
@@ -146,11 +198,13 @@ void G1Allocator::reuse_retained_old_region(EvacuationInfo& evacuation_info,
 void G1DefaultAllocator::init_gc_alloc_regions(EvacuationInfo& evacuation_info) {
   assert_at_safepoint(true /* should_be_vm_thread */);
 
-  _survivor_gc_alloc_region.init();
-  _old_gc_alloc_region.init();
-  reuse_retained_old_region(evacuation_info,
-                            &_old_gc_alloc_region,
-                            &_retained_old_gc_alloc_region);
+  for (uint i = 0; i < _num_alloc_regions; i++) {
+    _survivor_gc_alloc_regions[i].init();
+    _old_gc_alloc_regions[i].init();
+    reuse_retained_old_region(evacuation_info,
+                              &_old_gc_alloc_regions[i],
+                              &_retained_old_gc_alloc_regions[i]);
+  }
 
   if (TenantHeapIsolation) {
     // for non-root tenants
@@ -159,25 +213,20 @@ void G1DefaultAllocator::init_gc_alloc_regions(EvacuationInfo& evacuation_info)
 }
 
 void G1DefaultAllocator::release_gc_alloc_regions(uint no_of_gc_workers, EvacuationInfo& evacuation_info) {
-  AllocationContext_t context = AllocationContext::current();
-  if (TenantHeapIsolation) {
-    // in non-tenant mode, system() == current(), AllocationContext::current() just works.
-    // but in tenant mode, we are trying to release all gc alloc regions from all tenants,
-    // thus explicitly overwrite the first operand context to system() like below.
-    context = AllocationContext::system();
-  }
-
-  evacuation_info.set_allocation_regions(survivor_gc_alloc_region(context)->count() +
-                                         old_gc_alloc_region(context)->count());
-  survivor_gc_alloc_region(context)->release();
-  // If we have an old GC alloc region to release, we'll save it in
-  // _retained_old_gc_alloc_region. If we don't
-  // _retained_old_gc_alloc_region will become NULL. This is what we
-  // want either way so no reason to check explicitly for either
-  // condition.
-  _retained_old_gc_alloc_region = old_gc_alloc_region(context)->release();
-  if (_retained_old_gc_alloc_region != NULL) {
-    _retained_old_gc_alloc_region->record_retained_region();
+  // Only the root context regions are released here, the ones of the
+  // non-root tenants are released by G1TenantAllocationContexts below.
+  evacuation_info.set_allocation_regions(gc_alloc_region_count(InCSetState::Young, AllocationContext::system()) +
+                                         gc_alloc_region_count(InCSetState::Old, AllocationContext::system()));
+  for (uint i = 0; i < _num_alloc_regions; i++) {
+    _survivor_gc_alloc_regions[i].release();
+    // If we have an old GC alloc region to release, we'll save it in
+    // _retained_old_gc_alloc_regions. If we don't the entry will become
+    // NULL. This is what we want either way so no reason to check
+    // explicitly for either condition.
+    _retained_old_gc_alloc_regions[i] = _old_gc_alloc_regions[i].release();
+    if (_retained_old_gc_alloc_regions[i] != NULL) {
+      _retained_old_gc_alloc_regions[i]->record_retained_region();
+    }
   }
 
   // Release GC alloc region for non-root tenants
@@ -192,19 +241,11 @@ void G1DefaultAllocator::release_gc_alloc_regions(uint no_of_gc_workers, Evacuat
 }
 
 void G1DefaultAllocator::abandon_gc_alloc_regions() {
-  DEBUG_ONLY(if (TenantHeapIsolation) {
-    // in non-tenant mode, system() == current(), AllocationContext::current() just works.
-    // but in tenant mode, we are trying to release all gc alloc regions from all tenants,
-    // thus explicitly overwrite the first operand context to system() like below.
-    assert(survivor_gc_alloc_region(AllocationContext::system())->get() == NULL, "pre-condition");
-    assert(old_gc_alloc_region(AllocationContext::system())->get() == NULL, "pre-condition");
-  } else {
-    // original logic, untouched
-    assert(survivor_gc_alloc_region(AllocationContext::current())->get() == NULL, "pre-condition");
-    assert(old_gc_alloc_region(AllocationContext::current())->get() == NULL, "pre-condition");
-  });
-
-  _retained_old_gc_alloc_region = NULL;
+  for (uint i = 0; i < _num_alloc_regions; i++) {
+    assert(_survivor_gc_alloc_regions[i].get() == NULL, "pre-condition");
+    assert(_old_gc_alloc_regions[i].get() == NULL, "pre-condition");
+    _retained_old_gc_alloc_regions[i] = NULL;
+  }
 
   if (TenantHeapIsolation) {
     G1TenantAllocationContexts::abandon_gc_alloc_regions();
@@ -217,7 +258,12 @@ bool G1DefaultAllocator::is_retained_old_region(HeapRegion* hr) {
     assert(NULL != tac, "pre-condition");
     return tac->retained_old_gc_alloc_region() == hr;
   }
-  return _retained_old_gc_alloc_region == hr;
+  for (uint i = 0; i < _num_alloc_regions; i++) {
+    if (_retained_old_gc_alloc_regions[i] == hr) {
+      return true;
+    }
+  }
+  return false;
 }
 
 G1ParGCAllocBuffer::G1ParGCAllocBuffer(size_t gclab_word_size) :
@@ -232,7 +278,7 @@ HeapWord* G1ParGCAllocator::allocate_direct_or_new_plab(InCSetState dest,
     add_to_alloc_buffer_waste(alloc_buf->words_remaining());
     alloc_buf->retire(false /* end_of_gc */, false /* retain */);
 
-    HeapWord* buf = _g1h->par_allocate_during_gc(dest, gclab_word_size, context);
+    HeapWord* buf = _g1h->par_allocate_during_gc(dest, gclab_word_size, context, _node_index);
     if (buf == NULL) {
       return NULL; // Let caller handle allocation failure.
     }
@@ -244,7 +290,7 @@ HeapWord* G1ParGCAllocator::allocate_direct_or_new_plab(InCSetState dest,
     assert(obj != NULL, "buffer was definitely big enough...");
     return obj;
   } else {
-    return _g1h->par_allocate_during_gc(dest, word_sz, context);
+    return _g1h->par_allocate_during_gc(dest, word_sz, context, _node_index);
   }
 }
 
@@ -28,6 +28,7 @@
 #include "gc_implementation/g1/g1AllocationContext.hpp"
 #include "gc_implementation/g1/g1AllocRegion.hpp"
 #include "gc_implementation/g1/g1InCSetState.hpp"
+#include "gc_implementation/g1/g1NUMA.hpp"
 #include "gc_implementation/shared/parGCAllocBuffer.hpp"
 #include "utilities/hashtable.hpp"
 #include "utilities/hashtable.inline.hpp"
@@ -38,13 +39,15 @@ class G1Allocator : public CHeapObj<mtGC> {
 protected:
   G1CollectedHeap* _g1h;
 
+  G1NUMA* _numa;
+
   // Outside of GC pauses, the number of bytes used in all regions other
   // than the current allocation region.
   size_t _summary_bytes_used;
 
 public:
    G1Allocator(G1CollectedHeap* heap) :
-     _g1h(heap), _summary_bytes_used(0) { }
+     _g1h(heap), _numa(G1NUMA::numa()), _summary_bytes_used(0) { }
 
    static G1Allocator* create_allocator(G1CollectedHeap* g1h);
 
@@ -55,9 +58,14 @@ public:
    virtual void release_gc_alloc_regions(uint no_of_gc_workers, EvacuationInfo& evacuation_info) = 0;
    virtual void abandon_gc_alloc_regions() = 0;
 
-   virtual MutatorAllocRegion*    mutator_alloc_region(AllocationContext_t context) = 0;
-   virtual SurvivorGCAllocRegion* survivor_gc_alloc_region(AllocationContext_t context) = 0;
-   virtual OldGCAllocRegion*      old_gc_alloc_region(AllocationContext_t context) = 0;
+   // The alloc regions of the root context are kept per NUMA node, the
+   // node_index selects among them. It is ignored for tenant contexts.
+   virtual MutatorAllocRegion*    mutator_alloc_region(AllocationContext_t context, uint node_index) = 0;
+   virtual SurvivorGCAllocRegion* survivor_gc_alloc_region(AllocationContext_t context, uint node_index) = 0;
+   virtual OldGCAllocRegion*      old_gc_alloc_region(AllocationContext_t context, uint node_index) = 0;
+   // Number of regions the GC alloc regions for dest in the given context
+   // have used during the current pause, summed over all nodes.
+   virtual uint                   gc_alloc_region_count(InCSetState dest, AllocationContext_t context) = 0;
    virtual size_t                 used() = 0;
    virtual bool                   is_retained_old_region(HeapRegion* hr) = 0;
 
@@ -65,6 +73,11 @@ public:
                                                             OldGCAllocRegion* old,
                                                             HeapRegion** retained);
 
+   // The node index to allocate on for the calling thread.
+   uint current_node_index() const {
+     return _numa->index_of_current_thread();
+   }
+
    size_t used_unlocked() const {
      return _summary_bytes_used;
    }
@@ -94,20 +107,24 @@ public:
 // The default allocator for G1.
 class G1DefaultAllocator : public G1Allocator {
 protected:
-  // Alloc region used to satisfy mutator allocation requests.
-  MutatorAllocRegion _mutator_alloc_region;
+  // The number of alloc regions of each kind below, one per active
+  // NUMA node.
+  uint _num_alloc_regions;
 
-  // Alloc region used to satisfy allocation requests by the GC for
+  // Alloc regions used to satisfy mutator allocation requests.
+  MutatorAllocRegion* _mutator_alloc_regions;
+
+  // Alloc regions used to satisfy allocation requests by the GC for
   // survivor objects.
-  SurvivorGCAllocRegion _survivor_gc_alloc_region;
+  SurvivorGCAllocRegion* _survivor_gc_alloc_regions;
 
-  // Alloc region used to satisfy allocation requests by the GC for
+  // Alloc regions used to satisfy allocation requests by the GC for
   // old objects.
-  OldGCAllocRegion _old_gc_alloc_region;
+  OldGCAllocRegion* _old_gc_alloc_regions;
 
-  HeapRegion* _retained_old_gc_alloc_region;
+  HeapRegion** _retained_old_gc_alloc_regions;
 public:
-  G1DefaultAllocator(G1CollectedHeap* heap) : G1Allocator(heap), _retained_old_gc_alloc_region(NULL) { }
+  G1DefaultAllocator(G1CollectedHeap* heap);
 
   virtual void init_mutator_alloc_region();
   virtual void release_mutator_alloc_region();
@@ -118,11 +135,13 @@ public:
 
   virtual bool is_retained_old_region(HeapRegion* hr);
 
-  virtual MutatorAllocRegion* mutator_alloc_region(AllocationContext_t context);
+  virtual MutatorAllocRegion* mutator_alloc_region(AllocationContext_t context, uint node_index);
+
+  virtual SurvivorGCAllocRegion* survivor_gc_alloc_region(AllocationContext_t context, uint node_index);
 
-  virtual SurvivorGCAllocRegion* survivor_gc_alloc_region(AllocationContext_t context);
+  virtual OldGCAllocRegion* old_gc_alloc_region(AllocationContext_t context, uint node_index);
 
-  virtual OldGCAllocRegion* old_gc_alloc_region(AllocationContext_t context);
+  virtual uint gc_alloc_region_count(InCSetState dest, AllocationContext_t context);
 
   virtual size_t used();
 };
@@ -163,6 +182,11 @@ protected:
   // architectures have a special compare against zero instructions.
   const uint _survivor_alignment_bytes;
 
+  // The NUMA node of the GC worker owning this allocator. PLABs are
+  // refilled from the GC alloc regions of that node so that the worker
+  // copies objects into node local memory.
+  const uint _node_index;
+
   size_t _alloc_buffer_waste;
   size_t _undo_waste;
 
@@ -189,6 +213,7 @@ protected:
 public:
   G1ParGCAllocator(G1CollectedHeap* g1h) :
     _g1h(g1h), _survivor_alignment_bytes(calc_survivor_alignment_bytes()),
+    _node_index(G1NUMA::numa()->index_of_current_thread()),
     _alloc_buffer_waste(0), _undo_waste(0) {
   }
 
@@ -42,6 +42,9 @@
 #include "gc_implementation/g1/g1GCPhaseTimes.hpp"
 #include "gc_implementation/g1/g1Log.hpp"
 #include "gc_implementation/g1/g1MarkSweep.hpp"
+#include "gc_implementation/g1/g1OptionalCSet.hpp"
+#include "gc_implementation/g1/g1ParMarkCompact.hpp"
+#include "gc_implementation/g1/g1PeriodicGC.hpp"
 #include "gc_implementation/g1/g1OopClosures.inline.hpp"
 #include "gc_implementation/g1/g1ParScanThreadState.inline.hpp"
 #include "gc_implementation/g1/g1RegionToSpaceMapper.hpp"
@@ -58,6 +61,7 @@
 #include "gc_implementation/shared/gcTrace.hpp"
 #include "gc_implementation/shared/gcTraceTime.hpp"
 #include "gc_implementation/shared/isGCActiveMark.hpp"
+#include "gc_implementation/shared/parallelCleaning.hpp"
 #include "memory/allocation.hpp"
 #include "memory/gcLocker.inline.hpp"
 #include "memory/generationSpec.hpp"
@@ -65,7 +69,9 @@
 #include "memory/referenceProcessor.hpp"
 #include "oops/oop.inline.hpp"
 #include "oops/oop.pcgc.inline.hpp"
+#include "prims/jvmtiExport.hpp"
 #include "runtime/orderAccess.inline.hpp"
+#include "runtime/sweeper.hpp"
 #include "runtime/vmThread.hpp"
 #include "gc_implementation/g1/elasticHeap.hpp"
 #include "gc_implementation/g1/g1TenantAllocationContext.hpp"
@@ -511,7 +517,7 @@ G1CollectedHeap* G1CollectedHeap::_g1h;
 // Private methods.
 
 HeapRegion*
-G1CollectedHeap::new_region_try_secondary_free_list(bool is_old) {
+G1CollectedHeap::new_region_try_secondary_free_list(bool is_old, uint node_index) {
   MutexLockerEx x(SecondaryFreeList_lock, Mutex::_no_safepoint_check_flag);
   while (!_secondary_free_list.is_empty() || free_regions_coming()) {
     if (!_secondary_free_list.is_empty()) {
@@ -527,7 +533,7 @@ G1CollectedHeap::new_region_try_secondary_free_list(bool is_old) {
 
       assert(_hrm.num_free_regions() > 0, "if the secondary_free_list was not "
              "empty we should have moved at least one entry to the free_list");
-      HeapRegion* res = _hrm.allocate_free_region(is_old);
+      HeapRegion* res = _hrm.allocate_free_region(is_old, node_index);
       if (G1ConcRegionFreeingVerbose) {
         gclog_or_tty->print_cr("G1ConcRegionFreeing [region alloc] : "
                                "allocated " HR_FORMAT " from secondary_free_list",
@@ -549,7 +555,7 @@ G1CollectedHeap::new_region_try_secondary_free_list(bool is_old) {
   return NULL;
 }
 
-HeapRegion* G1CollectedHeap::new_region(size_t word_size, bool is_old, bool do_expand) {
+HeapRegion* G1CollectedHeap::new_region(size_t word_size, bool is_old, bool do_expand, uint node_index) {
   assert(!isHumongous(word_size) || word_size <= HeapRegion::GrainWords,
          "the only time we use this to allocate a humongous region is "
          "when we are allocating a single humongous region");
@@ -561,21 +567,21 @@ HeapRegion* G1CollectedHeap::new_region(size_t word_size, bool is_old, bool do_e
         gclog_or_tty->print_cr("G1ConcRegionFreeing [region alloc] : "
                                "forced to look at the secondary_free_list");
       }
-      res = new_region_try_secondary_free_list(is_old);
+      res = new_region_try_secondary_free_list(is_old, node_index);
       if (res != NULL) {
         return res;
       }
     }
   }
 
-  res = _hrm.allocate_free_region(is_old);
+  res = _hrm.allocate_free_region(is_old, node_index);
 
   if (res == NULL) {
     if (G1ConcRegionFreeingVerbose) {
       gclog_or_tty->print_cr("G1ConcRegionFreeing [region alloc] : "
                              "res == NULL, trying the secondary_free_list");
     }
-    res = new_region_try_secondary_free_list(is_old);
+    res = new_region_try_secondary_free_list(is_old, node_index);
   }
   if (res == NULL && do_expand && _expand_heap_after_alloc_failure) {
     // Currently, only attempts to allocate GC alloc regions set
@@ -594,7 +600,7 @@ HeapRegion* G1CollectedHeap::new_region(size_t word_size, bool is_old, bool do_e
       // always expand the heap by an amount aligned to the heap
       // region size, the free list should in theory not be empty.
       // In either case allocate_free_region() will check for NULL.
-      res = _hrm.allocate_free_region(is_old);
+      res = _hrm.allocate_free_region(is_old, node_index);
     } else {
       _expand_heap_after_alloc_failure = false;
     }
@@ -908,6 +914,7 @@ G1CollectedHeap::mem_allocate(size_t word_size,
 
 HeapWord* G1CollectedHeap::attempt_allocation_slow(size_t word_size,
                                                    AllocationContext_t context,
+                                                   uint node_index,
                                                    uint* gc_count_before_ret,
                                                    uint* gclocker_retry_count_ret) {
   // Make sure you read the note in attempt_allocation_humongous().
@@ -930,22 +937,22 @@ HeapWord* G1CollectedHeap::attempt_allocation_slow(size_t word_size,
 
     {
       MutexLockerEx x(Heap_lock);
-      result = _allocator->mutator_alloc_region(context)->attempt_allocation_locked(word_size,
-                                                                                    false /* bot_updates */);
+      result = _allocator->mutator_alloc_region(context, node_index)->attempt_allocation_locked(word_size,
+                                                                                                false /* bot_updates */);
       if (result != NULL) {
         return result;
       }
 
       // If we reach here, attempt_allocation_locked() above failed to
       // allocate a new region. So the mutator alloc region should be NULL.
-      assert(_allocator->mutator_alloc_region(context)->get() == NULL, "only way to get here");
+      assert(_allocator->mutator_alloc_region(context, node_index)->get() == NULL, "only way to get here");
 
       if (GC_locker::is_active_and_needs_gc()) {
         if (g1_policy()->can_expand_young_list()) {
           // No need for an ergo verbose message here,
           // can_expand_young_list() does this when it returns true.
-          result = _allocator->mutator_alloc_region(context)->attempt_allocation_force(word_size,
-                                                                                       false /* bot_updates */);
+          result = _allocator->mutator_alloc_region(context, node_index)->attempt_allocation_force(word_size,
+                                                                                                   false /* bot_updates */);
           if (result != NULL) {
             return result;
           }
@@ -1005,8 +1012,8 @@ HeapWord* G1CollectedHeap::attempt_allocation_slow(size_t word_size,
     // first attempt (without holding the Heap_lock) here and the
     // follow-on attempt will be at the start of the next loop
     // iteration (after taking the Heap_lock).
-    result = _allocator->mutator_alloc_region(context)->attempt_allocation(word_size,
-                                                                           false /* bot_updates */);
+    result = _allocator->mutator_alloc_region(context, node_index)->attempt_allocation(word_size,
+                                                                                       false /* bot_updates */);
     if (result != NULL) {
       return result;
     }
@@ -1145,12 +1152,13 @@ HeapWord* G1CollectedHeap::attempt_allocation_at_safepoint(size_t word_size,
                                                            AllocationContext_t context,
                                                            bool expect_null_mutator_alloc_region) {
   assert_at_safepoint(true /* should_be_vm_thread */);
-  assert(_allocator->mutator_alloc_region(context)->get() == NULL ||
+  uint node_index = _allocator->current_node_index();
+  assert(_allocator->mutator_alloc_region(context, node_index)->get() == NULL ||
                                              !expect_null_mutator_alloc_region,
          "the current alloc region was unexpectedly found to be non-NULL");
 
   if (!isHumongous(word_size)) {
-    return _allocator->mutator_alloc_region(context)->attempt_allocation_locked(word_size,
+    return _allocator->mutator_alloc_region(context, node_index)->attempt_allocation_locked(word_size,
                                                       false /* bot_updates */);
   } else {
     HeapWord* result = humongous_obj_allocate(word_size, context);
@@ -1396,8 +1404,11 @@ bool G1CollectedHeap::do_collection(bool explicit_gc,
       // G1CollectedHeap::ref_processing_init() about
       // how reference processing currently works in G1.
 
-      // Temporarily make discovery by the STW ref processor single threaded (non-MT).
-      ReferenceProcessorMTDiscoveryMutator stw_rp_disc_ser(ref_processor_stw(), false);
+      // The parallel full GC discovers references in the GC workers,
+      // otherwise temporarily make discovery by the STW ref processor
+      // single threaded (non-MT).
+      const bool parallel_full_gc = G1ParMarkCompact::should_use();
+      ReferenceProcessorMTDiscoveryMutator stw_rp_disc_ser(ref_processor_stw(), parallel_full_gc);
 
       // Temporarily clear the STW ref processor's _is_alive_non_header field.
       ReferenceProcessorIsAliveMutator stw_rp_is_alive_null(ref_processor_stw(), NULL);
@@ -1408,7 +1419,11 @@ bool G1CollectedHeap::do_collection(bool explicit_gc,
       // Do collection work
       {
         HandleMark hm;  // Discard invalid handles created during gc
-        G1MarkSweep::invoke_at_safepoint(ref_processor_stw(), do_clear_all_soft_refs);
+        if (parallel_full_gc) {
+          G1ParMarkCompact::invoke_at_safepoint(ref_processor_stw(), do_clear_all_soft_refs);
+        } else {
+          G1MarkSweep::invoke_at_safepoint(ref_processor_stw(), do_clear_all_soft_refs);
+        }
       }
 
       assert(num_free_regions() == 0, "we should not have added any free regions");
@@ -1567,7 +1582,11 @@ bool G1CollectedHeap::do_collection(bool explicit_gc,
     }
 
     if (G1Log::finer()) {
+      if (G1ParMarkCompact::should_use()) {
+        g1_policy()->phase_times()->print_full_gc();
+      }
       g1_policy()->print_detailed_heap_transition(true /* full */);
+      _numa->print_statistics(gclog_or_tty);
     }
 
     print_heap_after_gc();
@@ -1598,19 +1617,9 @@ void G1CollectedHeap::do_full_collection(bool clear_all_soft_refs) {
 }
 
 // This code is mostly copied from TenuredGeneration.
-void
-G1CollectedHeap::
-resize_if_necessary_after_full_collection(size_t word_size) {
-  if (G1ElasticHeap) {
-    // We never resize heap in full GC with elastic heap
-    return;
-  }
-  // Include the current allocation, if any, and bytes that will be
-  // pre-allocated to support collections, as "used".
-  const size_t used_after_gc = used();
-  const size_t capacity_after_gc = capacity();
-  const size_t free_after_gc = capacity_after_gc - used_after_gc;
-
+void G1CollectedHeap::desired_capacity_range(size_t used_after_gc,
+                                             size_t* minimum_desired_capacity_out,
+                                             size_t* maximum_desired_capacity_out) {
   // This is enforced in arguments.cpp.
   assert(MinHeapFreeRatio <= MaxHeapFreeRatio,
          "otherwise the code below doesn't make sense");
@@ -1658,6 +1667,27 @@ resize_if_necessary_after_full_collection(size_t word_size) {
   // we'll try to make the capacity smaller than it, not greater).
   maximum_desired_capacity =  MAX2(maximum_desired_capacity, min_heap_size);
 
+  *minimum_desired_capacity_out = minimum_desired_capacity;
+  *maximum_desired_capacity_out = maximum_desired_capacity;
+}
+
+void
+G1CollectedHeap::
+resize_if_necessary_after_full_collection(size_t word_size) {
+  if (G1ElasticHeap) {
+    // We never resize heap in full GC with elastic heap
+    return;
+  }
+  // Include the current allocation, if any, and bytes that will be
+  // pre-allocated to support collections, as "used".
+  const size_t used_after_gc = used();
+  const size_t capacity_after_gc = capacity();
+
+  size_t minimum_desired_capacity;
+  size_t maximum_desired_capacity;
+  desired_capacity_range(used_after_gc,
+                         &minimum_desired_capacity, &maximum_desired_capacity);
+
   if (capacity_after_gc < minimum_desired_capacity) {
     // Don't expand unless it's significant
     size_t expand_bytes = minimum_desired_capacity - capacity_after_gc;
@@ -1689,6 +1719,44 @@ resize_if_necessary_after_full_collection(size_t word_size) {
   }
 }
 
+void G1CollectedHeap::resize_heap_after_remark() {
+  assert_at_safepoint(true /* should_be_vm_thread */);
+  if (G1PeriodicGCInterval == 0 || G1ElasticHeap) {
+    // Outside of full GCs we only give memory back for periodic GCs,
+    // and never when the elastic heap controls the committed size.
+    return;
+  }
+
+  const size_t used_after_remark = used();
+  const size_t capacity_after_remark = capacity();
+
+  size_t minimum_desired_capacity;
+  size_t maximum_desired_capacity;
+  desired_capacity_range(used_after_remark,
+                         &minimum_desired_capacity, &maximum_desired_capacity);
+
+  // Unlike after a Full GC we never expand here: young pauses already
+  // expand the heap based on the GC overhead.
+  if (capacity_after_remark > maximum_desired_capacity) {
+    size_t shrink_bytes = capacity_after_remark - maximum_desired_capacity;
+    ergo_verbose4(ErgoHeapSizing,
+                  "attempt heap shrinking",
+                  ergo_format_reason("capacity higher than "
+                                     "max desired capacity after remark")
+                  ergo_format_byte("capacity")
+                  ergo_format_byte("occupancy")
+                  ergo_format_byte_perc("max desired capacity"),
+                  capacity_after_remark, used_after_remark,
+                  maximum_desired_capacity, (double) MaxHeapFreeRatio);
+    // The current mutator alloc region may not have been allocated
+    // into yet. Retire it so that only free regions look empty to the
+    // region manager and get uncommitted.
+    _allocator->release_mutator_alloc_region();
+    shrink(shrink_bytes);
+    _allocator->init_mutator_alloc_region();
+  }
+}
+
 
 HeapWord*
 G1CollectedHeap::satisfy_failed_allocation(size_t word_size,
@@ -1864,9 +1932,10 @@ void G1CollectedHeap::shrink_helper(size_t shrink_bytes) {
 void G1CollectedHeap::shrink(size_t shrink_bytes) {
   verify_region_sets_optional();
 
-  // We should only reach here at the end of a Full GC which means we
-  // should not not be holding to any GC alloc regions. The method
-  // below will make sure of that and do any remaining clean up.
+  // We should only reach here at the end of a Full GC or during a
+  // remark pause which means we should not not be holding to any GC
+  // alloc regions. The method below will make sure of that and do any
+  // remaining clean up.
   _allocator->abandon_gc_alloc_regions();
 
   // Instead of tearing down / rebuilding the free lists here, we
@@ -1911,6 +1980,7 @@ G1CollectedHeap::G1CollectedHeap(G1CollectorPolicy* policy_) :
   _free_regions_coming(false),
   _young_list(new YoungList(this)),
   _elastic_heap(NULL),
+  _optional_cset(NULL),
   _gc_time_stamp(0),
   _survivor_plab_stats(YoungPLABSize, PLABWeight),
   _old_plab_stats(OldPLABSize, PLABWeight),
@@ -1931,6 +2001,7 @@ G1CollectedHeap::G1CollectedHeap(G1CollectorPolicy* policy_) :
 
   _g1h = this;
 
+  _numa = G1NUMA::create();
   _allocator = G1Allocator::create_allocator(_g1h);
   _humongous_object_threshold_in_words = HeapRegion::GrainWords / 2;
 
@@ -1952,6 +2023,10 @@ G1CollectedHeap::G1CollectedHeap(G1CollectorPolicy* policy_) :
   }
   clear_cset_start_regions();
 
+  if (G1UseOptionalCSet) {
+    _optional_cset = new G1OptionalCSet(this);
+  }
+
   // Initialize the G1EvacuationFailureALot counters and flags.
   NOT_PRODUCT(reset_evacuation_should_fail();)
 
@@ -2067,6 +2142,8 @@ jint G1CollectedHeap::initialize() {
   // Carve out the G1 part of the heap.
 
   ReservedSpace g1_rs = heap_rs.first_part(max_byte_size);
+  _numa->set_region_info(HeapRegion::GrainBytes,
+                         UseLargePages ? os::large_page_size() : os::vm_page_size());
   G1RegionToSpaceMapper* heap_storage =
     G1RegionToSpaceMapper::create_mapper(g1_rs,
                                          g1_rs.size(),
@@ -2221,6 +2298,9 @@ void G1CollectedHeap::stop() {
   if (G1ElasticHeap) {
     elastic_heap()->destroy();
   }
+  if (G1PeriodicGCInterval != 0) {
+    G1PeriodicGC::stop();
+  }
   if (G1StringDedup::is_enabled()) {
     G1StringDedup::stop();
   }
@@ -2411,6 +2491,7 @@ bool G1CollectedHeap::should_do_concurrent_full_gc(GCCause::Cause cause) {
     case GCCause::_g1_humongous_allocation: return true;
     case GCCause::_update_allocation_context_stats_inc: return true;
     case GCCause::_wb_conc_mark:            return true;
+    case GCCause::_g1_periodic_collection:  return true;
     default:                                return false;
   }
 }
@@ -2990,7 +3071,8 @@ size_t G1CollectedHeap::unsafe_max_tlab_alloc(Thread* ignored) const {
   // since we can't allow tlabs to grow big enough to accommodate
   // humongous objects.
 
-  HeapRegion* hr = _allocator->mutator_alloc_region(AllocationContext::current())->get();
+  HeapRegion* hr = _allocator->mutator_alloc_region(AllocationContext::current(),
+                                                    _allocator->current_node_index())->get();
   size_t max_tlab = max_tlab_size() * wordSize;
   if (hr == NULL) {
     return max_tlab;
@@ -3784,6 +3866,7 @@ class RegisterHumongousWithInCSetFastTestClosure : public HeapRegionClosure {
  private:
   size_t _total_humongous;
   size_t _candidate_humongous;
+  size_t _candidate_humongous_obj_arrays;
 
   DirtyCardQueue _dcq;
 
@@ -3800,6 +3883,15 @@ class RegisterHumongousWithInCSetFastTestClosure : public HeapRegionClosure {
     return oop(region->bottom())->is_typeArray();
   }
 
+  // See humongous_region_is_candidate() for why object arrays allocated
+  // before the start of a concurrent mark must be left to the marking.
+  bool is_reclaimable_objArray_region(G1CollectedHeap* heap, HeapRegion* region) const {
+    oop obj = oop(region->bottom());
+    return G1EagerReclaimHumongousObjArrays &&
+           obj->is_objArray() &&
+           (!heap->mark_in_progress() || region->obj_allocated_since_next_marking(obj));
+  }
+
   bool humongous_region_is_candidate(G1CollectedHeap* heap, HeapRegion* region) const {
     assert(region->startsHumongous(), "Must start a humongous object");
 
@@ -3824,10 +3916,14 @@ class RegisterHumongousWithInCSetFastTestClosure : public HeapRegionClosure {
     // structures don't support efficiently performing the needed
     // additional tests or scrubbing of the mark stack.
     //
-    // However, we presently only nominate is_typeArray() objects.
-    // A humongous object containing references induces remembered
-    // set entries on other regions.  In order to reclaim such an
-    // object, those remembered sets would need to be cleaned up.
+    // Object arrays are only nominated with G1EagerReclaimHumongousObjArrays,
+    // and only if they satisfy the constraints above, i.e. no marking is in
+    // progress or they were allocated after it started. A humongous object
+    // containing references induces remembered set entries on other
+    // regions. Those entries become stale when the object is reclaimed,
+    // like the ones of evacuated collection set regions, and remembered
+    // set scanning and refinement already tolerate stale entries into
+    // regions that have been freed or reused.
     //
     // We also treat is_typeArray() objects specially, allowing them
     // to be reclaimed even if allocated before the start of
@@ -3839,13 +3935,15 @@ class RegisterHumongousWithInCSetFastTestClosure : public HeapRegionClosure {
     // important use case for eager reclaim, and this special handling
     // may reduce needed headroom.
 
-    return is_typeArray_region(region) && is_remset_small(region);
+    return (is_typeArray_region(region) || is_reclaimable_objArray_region(heap, region)) &&
+           is_remset_small(region);
   }
 
  public:
   RegisterHumongousWithInCSetFastTestClosure()
   : _total_humongous(0),
     _candidate_humongous(0),
+    _candidate_humongous_obj_arrays(0),
     _dcq(&JavaThread::dirty_card_queue_set()) {
   }
 
@@ -3860,6 +3958,9 @@ class RegisterHumongousWithInCSetFastTestClosure : public HeapRegionClosure {
     g1h->set_humongous_reclaim_candidate(rindex, is_candidate);
     if (is_candidate) {
       _candidate_humongous++;
+      if (!is_typeArray_region(r)) {
+        _candidate_humongous_obj_arrays++;
+      }
       g1h->register_humongous_region_with_in_cset_fast_test(rindex);
       // Is_candidate already filters out humongous object with large remembered sets.
       // If we have a humongous object with a few remembered sets, we simply flush these
@@ -3893,13 +3994,14 @@ class RegisterHumongousWithInCSetFastTestClosure : public HeapRegionClosure {
 
   size_t total_humongous() const { return _total_humongous; }
   size_t candidate_humongous() const { return _candidate_humongous; }
+  size_t candidate_humongous_obj_arrays() const { return _candidate_humongous_obj_arrays; }
 
   void flush_rem_set_entries() { _dcq.flush(); }
 };
 
 void G1CollectedHeap::register_humongous_regions_with_in_cset_fast_test() {
   if (!G1EagerReclaimHumongousObjects) {
-    g1_policy()->phase_times()->record_fast_reclaim_humongous_stats(0.0, 0, 0);
+    g1_policy()->phase_times()->record_fast_reclaim_humongous_stats(0.0, 0, 0, 0);
     return;
   }
   double time = os::elapsed_counter();
@@ -3911,7 +4013,8 @@ void G1CollectedHeap::register_humongous_regions_with_in_cset_fast_test() {
   time = ((double)(os::elapsed_counter() - time) / os::elapsed_frequency()) * 1000.0;
   g1_policy()->phase_times()->record_fast_reclaim_humongous_stats(time,
                                                                   cl.total_humongous(),
-                                                                  cl.candidate_humongous());
+                                                                  cl.candidate_humongous(),
+                                                                  cl.candidate_humongous_obj_arrays());
   _has_humongous_reclaim_candidates = cl.candidate_humongous() > 0;
 
   // Finally flush all remembered set entries to re-check into the global DCQS.
@@ -4043,6 +4146,7 @@ void G1CollectedHeap::log_gc_footer(double pause_time_sec) {
     g1_policy()->phase_times()->note_gc_end();
     g1_policy()->phase_times()->print(pause_time_sec);
     g1_policy()->print_detailed_heap_transition();
+    _numa->print_statistics(gclog_or_tty);
   } else {
     if (evacuation_failed()) {
       gclog_or_tty->print("--");
@@ -4676,6 +4780,8 @@ void G1ParCopyClosure<barrier, do_mark_object>::do_oop_work(T* p) {
   } else {
     if (state.is_humongous()) {
       _g1->set_humongous_is_live(obj);
+    } else if (state.is_optional()) {
+      _par_scan_state->record_optional_ref(p);
     }
     // The object is not in collection set. If we're a root scanning
     // closure during an initial mark pause then attempt to mark the object.
@@ -4927,6 +5033,107 @@ public:
   }
 };
 
+// Evacuates one increment of the optional collection set: the objects
+// referenced from the locations recorded for the optional collection set,
+// from the remembered sets of the regions of the increment and from the
+// nmethods in their strong code root lists.
+class G1ParOptionalEvacTask : public AbstractGangTask {
+  G1CollectedHeap*       _g1h;
+  RefToScanQueueSet*     _queues;
+  G1RootProcessor*       _root_processor;
+  HeapRegion**           _regions;
+  uint                   _num_regions;
+  ParallelTaskTerminator _terminator;
+  uint                   _n_workers;
+
+  template <class T>
+  void process_recorded_refs(GrowableArray<T*>* refs,
+                             G1ParScanThreadState* pss,
+                             OopClosure* root_cl) {
+    if (refs == NULL) {
+      return;
+    }
+    for (int i = 0; i < refs->length(); i++) {
+      T* p = refs->at(i);
+      if (_g1h->is_in_g1_reserved(p)) {
+        // A location inside a collection set region is stale: the object
+        // containing it has either been copied, and the copy has been
+        // scanned, or it is dead.
+        if (!_g1h->heap_region_containing_raw(p)->in_collection_set()) {
+          pss->push_on_queue(p);
+        }
+      } else {
+        root_cl->do_oop(p);
+      }
+    }
+    delete refs;
+  }
+
+public:
+  G1ParOptionalEvacTask(G1CollectedHeap* g1h, RefToScanQueueSet* task_queues,
+                        G1RootProcessor* root_processor,
+                        HeapRegion** regions, uint num_regions)
+    : AbstractGangTask("G1 optional collection set"),
+      _g1h(g1h),
+      _queues(task_queues),
+      _root_processor(root_processor),
+      _regions(regions),
+      _num_regions(num_regions),
+      _terminator(0, _queues),
+      _n_workers(0)
+  {}
+
+  virtual void set_for_termination(int active_workers) {
+    _root_processor->set_num_workers(active_workers);
+    _terminator.reset_for_reuse(active_workers);
+    _n_workers = active_workers;
+  }
+
+  void work(uint worker_id) {
+    if (worker_id >= _n_workers) return;  // no work needed this round
+
+    ResourceMark rm;
+    HandleMark   hm;
+
+    G1GCPhaseTimes* phase_times = _g1h->g1_policy()->phase_times();
+    ReferenceProcessor*             rp = _g1h->ref_processor_stw();
+
+    G1ParScanThreadState            pss(_g1h, worker_id, rp);
+    G1ParScanHeapEvacFailureClosure evac_failure_cl(_g1h, &pss, rp);
+
+    pss.set_evac_failure_closure(&evac_failure_cl);
+
+    // Optional regions are never collected during an initial mark pause,
+    // so no root needs to be marked.
+    G1ParCopyClosure<G1BarrierNone, G1MarkNone> scan_only_root_cl(_g1h, &pss, rp);
+
+    double start = os::elapsedTime();
+    G1OptionalCSet* optional_cset = _g1h->optional_cset();
+    process_recorded_refs(optional_cset->claim_oop_refs(worker_id), &pss, &scan_only_root_cl);
+    process_recorded_refs(optional_cset->claim_narrow_oop_refs(worker_id), &pss, &scan_only_root_cl);
+    double recorded_refs_sec = os::elapsedTime() - start;
+
+    G1ParPushHeapRSClosure push_heap_rs_cl(_g1h, &pss);
+    _root_processor->scan_optional_remembered_sets(_regions, _num_regions,
+                                                   &push_heap_rs_cl,
+                                                   &scan_only_root_cl,
+                                                   worker_id);
+
+    {
+      double start = os::elapsedTime();
+      G1ParEvacuateFollowersClosure evac(_g1h, &pss, _queues, &_terminator);
+      evac.do_void();
+      double elapsed_sec = os::elapsedTime() - start;
+      double term_sec = pss.term_time();
+      phase_times->add_time_secs(G1GCPhaseTimes::OptObjCopy, worker_id, recorded_refs_sec + elapsed_sec - term_sec);
+      phase_times->add_time_secs(G1GCPhaseTimes::OptTermination, worker_id, term_sec);
+    }
+    _g1h->update_surviving_young_words(pss.surviving_young_words()+1);
+
+    assert(pss.queue_is_empty(), "should be empty");
+  }
+};
+
 class G1StringSymbolTableUnlinkTask : public AbstractGangTask {
 private:
   BoolObjectClosure* _is_alive;
@@ -5016,6 +5223,7 @@ private:
 
   BoolObjectClosure* const _is_alive;
   const bool               _unloading_occurred;
+  const bool               _defer_ic_cleaning;
   const uint               _num_workers;
 
   // Variables used to claim nmethods.
@@ -5027,9 +5235,11 @@ private:
   volatile uint     _num_entered_barrier;
 
  public:
-  G1CodeCacheUnloadingTask(uint num_workers, BoolObjectClosure* is_alive, bool unloading_occurred) :
+  G1CodeCacheUnloadingTask(uint num_workers, BoolObjectClosure* is_alive, bool unloading_occurred,
+                           bool defer_ic_cleaning) :
       _is_alive(is_alive),
       _unloading_occurred(unloading_occurred),
+      _defer_ic_cleaning(defer_ic_cleaning),
       _num_workers(num_workers),
       _first_nmethod(NULL),
       _claimed_nmethod(NULL),
@@ -5042,7 +5252,13 @@ private:
   }
 
   ~G1CodeCacheUnloadingTask() {
-    CodeCache::verify_clean_inline_caches();
+    if (_defer_ic_cleaning) {
+      // The sweeper cleans the inline caches before the metadata of the
+      // unloaded classes is freed.
+      NMethodSweeper::request_unloading_cleanup();
+    } else {
+      CodeCache::verify_clean_inline_caches();
+    }
 
     CodeCache::set_needs_cache_clean(false);
     guarantee(CodeCache::scavenge_root_nmethods() == NULL, "Must be");
@@ -5060,7 +5276,7 @@ private:
   }
 
   void clean_nmethod(nmethod* nm) {
-    bool postponed = nm->do_unloading_parallel(_is_alive, _unloading_occurred);
+    bool postponed = nm->do_unloading_parallel(_is_alive, _unloading_occurred, _defer_ic_cleaning);
 
     if (postponed) {
       // This nmethod referred to an nmethod that has not been cleaned/unloaded yet.
@@ -5181,75 +5397,20 @@ private:
 
 Monitor* G1CodeCacheUnloadingTask::_lock = new Monitor(Mutex::leaf, "Code Cache Unload lock");
 
-class G1KlassCleaningTask : public StackObj {
-  BoolObjectClosure*                      _is_alive;
-  volatile jint                           _clean_klass_tree_claimed;
-  ClassLoaderDataGraphKlassIteratorAtomic _klass_iterator;
-
- public:
-  G1KlassCleaningTask(BoolObjectClosure* is_alive) :
-      _is_alive(is_alive),
-      _clean_klass_tree_claimed(0),
-      _klass_iterator() {
-  }
-
- private:
-  bool claim_clean_klass_tree_task() {
-    if (_clean_klass_tree_claimed) {
-      return false;
-    }
-
-    return Atomic::cmpxchg(1, (jint*)&_clean_klass_tree_claimed, 0) == 0;
-  }
-
-  InstanceKlass* claim_next_klass() {
-    Klass* klass;
-    do {
-      klass =_klass_iterator.next_klass();
-    } while (klass != NULL && !klass->oop_is_instance());
-
-    return (InstanceKlass*)klass;
-  }
-
-public:
-
-  void clean_klass(InstanceKlass* ik) {
-    ik->clean_weak_instanceklass_links(_is_alive);
-
-    if (JvmtiExport::has_redefined_a_class()) {
-      InstanceKlass::purge_previous_versions(ik);
-    }
-  }
-
-  void work() {
-    ResourceMark rm;
-
-    // One worker will clean the subklass/sibling klass tree.
-    if (claim_clean_klass_tree_task()) {
-      Klass::clean_subklass_tree(_is_alive);
-    }
-
-    // All workers will help cleaning the classes,
-    InstanceKlass* klass;
-    while ((klass = claim_next_klass()) != NULL) {
-      clean_klass(klass);
-    }
-  }
-};
-
 // To minimize the remark pause times, the tasks below are done in parallel.
 class G1ParallelCleaningTask : public AbstractGangTask {
 private:
   G1StringSymbolTableUnlinkTask _string_symbol_task;
   G1CodeCacheUnloadingTask      _code_cache_task;
-  G1KlassCleaningTask           _klass_cleaning_task;
+  KlassCleaningTask             _klass_cleaning_task;
 
 public:
   // The constructor is run in the VMThread.
-  G1ParallelCleaningTask(BoolObjectClosure* is_alive, bool process_strings, bool process_symbols, uint num_workers, bool unloading_occurred) :
+  G1ParallelCleaningTask(BoolObjectClosure* is_alive, bool process_strings, bool process_symbols, uint num_workers,
+                         bool unloading_occurred, bool defer_ic_cleaning) :
       AbstractGangTask("Parallel Cleaning"),
       _string_symbol_task(is_alive, process_strings, process_symbols),
-      _code_cache_task(num_workers, is_alive, unloading_occurred),
+      _code_cache_task(num_workers, is_alive, unloading_occurred, defer_ic_cleaning),
       _klass_cleaning_task(is_alive) {
   }
 
@@ -5298,8 +5459,14 @@ void G1CollectedHeap::parallel_cleaning(BoolObjectClosure* is_alive,
   uint n_workers = (G1CollectedHeap::use_parallel_gc_threads() ?
                     workers()->active_workers() : 1);
 
+  // Leave the inline caches to the sweeper unless they have to be walked
+  // to mark the metadata of redefined classes.
+  bool defer_ic_cleaning = G1ConcurrentUnloadingCleanup &&
+                           NMethodSweeper::can_clean_unloading_caches() &&
+                           !JvmtiExport::has_redefined_a_class();
+
   G1ParallelCleaningTask g1_unlink_task(is_alive, process_strings, process_symbols,
-                                        n_workers, class_unloading_occurred);
+                                        n_workers, class_unloading_occurred, defer_ic_cleaning);
   if (G1CollectedHeap::use_parallel_gc_threads()) {
     set_par_threads(n_workers);
     workers()->run_task(&g1_unlink_task);
@@ -5947,6 +6114,8 @@ void G1CollectedHeap::evacuate_collection_set(EvacuationInfo& evacuation_info) {
 
   set_par_threads(0);
 
+  evacuate_optional_collection_set(evacuation_info);
+
   // Process any discovered reference objects - we have
   // to do this _before_ we retire the GC alloc regions
   // as we may have to copy some 'reachable' referent
@@ -6005,6 +6174,63 @@ void G1CollectedHeap::evacuate_collection_set(EvacuationInfo& evacuation_info) {
   COMPILER2_PRESENT(DerivedPointerTable::update_pointers());
 }
 
+void G1CollectedHeap::evacuate_optional_collection_set(EvacuationInfo& evacuation_info) {
+  G1OptionalCSet* optional_cset = _optional_cset;
+  if (optional_cset == NULL || optional_cset->length() == 0) {
+    return;
+  }
+
+  G1CollectorPolicy* policy = g1_policy();
+  double start_sec = os::elapsedTime();
+  policy->phase_times()->note_optional_evacuation_start();
+
+  // Stop at the first evacuation failure: there is no space left to copy
+  // more objects to, and locations recorded inside self-forwarded objects
+  // could not be told apart from stale ones.
+  while (!optional_cset->is_empty() && !evacuation_failed()) {
+    double time_left_ms = policy->optional_evacuation_time_left_ms();
+    double predicted_time_ms = 0.0;
+    uint num = policy->calc_optional_increment_length(optional_cset, time_left_ms, &predicted_time_ms);
+    if (num == 0) {
+      break;
+    }
+    HeapRegion** regions = optional_cset->start_increment(num);
+    double time_ms = evacuate_optional_regions(regions, num);
+    policy->record_optional_increment(num, predicted_time_ms, time_ms, time_left_ms);
+  }
+
+  uint increments = optional_cset->num_increments();
+  uint evacuated = optional_cset->num_evacuated();
+  uint returned = optional_cset->num_remaining();
+  policy->abandon_optional_cset(optional_cset);
+
+  evacuation_info.set_collectionset_regions(policy->cset_region_length());
+  policy->phase_times()->record_optional_evacuation((os::elapsedTime() - start_sec) * 1000.0,
+                                                    increments, evacuated, returned);
+}
+
+double G1CollectedHeap::evacuate_optional_regions(HeapRegion** regions, uint num) {
+  const uint n_workers = workers()->active_workers();
+  set_par_threads(n_workers);
+
+  double start_sec = os::elapsedTime();
+  {
+    G1RootProcessor root_processor(this);
+    G1ParOptionalEvacTask optional_task(this, _task_queues, &root_processor, regions, num);
+
+    if (G1CollectedHeap::use_parallel_gc_threads()) {
+      workers()->run_task(&optional_task);
+    } else {
+      optional_task.set_for_termination(n_workers);
+      optional_task.work(0);
+    }
+  }
+  double time_ms = (os::elapsedTime() - start_sec) * 1000.0;
+
+  set_par_threads(0);
+  return time_ms;
+}
+
 void G1CollectedHeap::free_region(HeapRegion* hr,
                                   FreeRegionList* free_list,
                                   bool par,
@@ -6448,11 +6674,13 @@ class G1FreeHumongousRegionClosure : public HeapRegionClosure {
   FreeRegionList* _free_region_list;
   HeapRegionSet* _proxy_set;
   HeapRegionSetCount _humongous_regions_removed;
+  size_t _obj_arrays_reclaimed;
   size_t _freed_bytes;
  public:
 
   G1FreeHumongousRegionClosure(FreeRegionList* free_region_list) :
-    _free_region_list(free_region_list), _humongous_regions_removed(), _freed_bytes(0) {
+    _free_region_list(free_region_list), _humongous_regions_removed(),
+    _obj_arrays_reclaimed(0), _freed_bytes(0) {
   }
 
   virtual bool doHeapRegion(HeapRegion* r) {
@@ -6489,10 +6717,11 @@ class G1FreeHumongousRegionClosure : public HeapRegionClosure {
     // are completely up-to-date wrt to references to the humongous object.
     //
     // Other implementation considerations:
-    // - never consider object arrays at this time because they would pose
-    // considerable effort for cleaning up the the remembered sets. This is
-    // required because stale remembered sets might reference locations that
-    // are currently allocated into.
+    // - object arrays are only candidates with G1EagerReclaimHumongousObjArrays.
+    // Reclaiming them leaves stale remembered set entries for their cards
+    // in other regions. These are treated like the stale entries of freed
+    // collection set regions: card scanning is limited to the parsable part
+    // of a region and skips young regions.
     uint region_idx = r->hrm_index();
     if (!g1h->is_humongous_reclaim_candidate(region_idx) ||
         !r->rem_set()->is_empty()) {
@@ -6514,8 +6743,8 @@ class G1FreeHumongousRegionClosure : public HeapRegionClosure {
       return false;
     }
 
-    guarantee(obj->is_typeArray(),
-              err_msg("Only eagerly reclaiming type arrays is supported, but the object "
+    guarantee(obj->is_typeArray() || (G1EagerReclaimHumongousObjArrays && obj->is_objArray()),
+              err_msg("Only eagerly reclaiming type arrays and object arrays is supported, but the object "
                       PTR_FORMAT " is not.",
                       r->bottom()));
 
@@ -6536,6 +6765,9 @@ class G1FreeHumongousRegionClosure : public HeapRegionClosure {
     if (next_bitmap->isMarked(r->bottom())) {
       next_bitmap->clear(r->bottom());
     }
+    if (obj->is_objArray()) {
+      _obj_arrays_reclaimed++;
+    }
     _freed_bytes += r->used();
     r->set_containing_set(NULL);
     _humongous_regions_removed.increment(1u, r->capacity());
@@ -6555,6 +6787,10 @@ class G1FreeHumongousRegionClosure : public HeapRegionClosure {
   size_t humongous_reclaimed() const {
     return _humongous_regions_removed.length();
   }
+
+  size_t obj_arrays_reclaimed() const {
+    return _obj_arrays_reclaimed;
+  }
 };
 
 void G1CollectedHeap::eagerly_reclaim_humongous_regions() {
@@ -6562,7 +6798,7 @@ void G1CollectedHeap::eagerly_reclaim_humongous_regions() {
 
   if (!G1EagerReclaimHumongousObjects ||
       (!_has_humongous_reclaim_candidates && !G1TraceEagerReclaimHumongousObjects)) {
-    g1_policy()->phase_times()->record_fast_reclaim_humongous_time_ms(0.0, 0);
+    g1_policy()->phase_times()->record_fast_reclaim_humongous_time_ms(0.0, 0, 0);
     return;
   }
 
@@ -6589,7 +6825,8 @@ void G1CollectedHeap::eagerly_reclaim_humongous_regions() {
   decrement_summary_bytes(cl.bytes_freed());
 
   g1_policy()->phase_times()->record_fast_reclaim_humongous_time_ms((os::elapsedTime() - start_time) * 1000.0,
-                                                                    cl.humongous_reclaimed());
+                                                                    cl.humongous_reclaimed(),
+                                                                    cl.obj_arrays_reclaimed());
 }
 
 // This routine is similar to the above but does not record
@@ -6821,7 +7058,8 @@ bool G1CollectedHeap::is_in_closed_subset(const void* p) const {
 // Methods for the mutator alloc region
 
 HeapRegion* G1CollectedHeap::new_mutator_alloc_region(size_t word_size,
-                                                      bool force) {
+                                                      bool force,
+                                                      uint node_index) {
   assert_heap_locked_or_at_safepoint(true /* should_be_vm_thread */);
   assert(!force || g1_policy()->can_expand_young_list(),
          "if force is true we should be able to expand the young list");
@@ -6829,7 +7067,8 @@ HeapRegion* G1CollectedHeap::new_mutator_alloc_region(size_t word_size,
   if (force || !young_list_full) {
     HeapRegion* new_alloc_region = new_region(word_size,
                                               false /* is_old */,
-                                              false /* do_expand */);
+                                              false /* do_expand */,
+                                              node_index);
     if (new_alloc_region != NULL) {
       set_region_short_lived_locked(new_alloc_region);
       _hr_printer.alloc(new_alloc_region, G1HRPrinter::Eden, young_list_full);
@@ -6874,14 +7113,16 @@ void G1CollectedHeap::set_par_threads() {
 
 HeapRegion* G1CollectedHeap::new_gc_alloc_region(size_t word_size,
                                                  uint count,
-                                                 InCSetState dest) {
+                                                 InCSetState dest,
+                                                 uint node_index) {
   assert(FreeList_lock->owned_by_self(), "pre-condition");
 
   if (count < g1_policy()->max_regions(dest)) {
     const bool is_survivor = (dest.is_young());
     HeapRegion* new_alloc_region = new_region(word_size,
                                               !is_survivor,
-                                              true /* do_expand */);
+                                              true /* do_expand */,
+                                              node_index);
     if (new_alloc_region != NULL) {
       // We really only need to do this for old regions given that we
       // should never scan survivors. But it doesn't hurt to do it
@@ -34,6 +34,7 @@
 #include "gc_implementation/g1/g1HRPrinter.hpp"
 #include "gc_implementation/g1/g1InCSetState.hpp"
 #include "gc_implementation/g1/g1MonitoringSupport.hpp"
+#include "gc_implementation/g1/g1NUMA.hpp"
 #include "gc_implementation/g1/g1SATBCardTableModRefBS.hpp"
 #include "gc_implementation/g1/g1TenantAllocationContext.hpp"
 #include "gc_implementation/g1/g1YCTypes.hpp"
@@ -79,6 +80,7 @@ class G1OldTracer;
 class EvacuationFailedInfo;
 class nmethod;
 class ElasticHeap;
+class G1OptionalCSet;
 
 typedef OverflowTaskQueue<StarTask, mtGC>         RefToScanQueue;
 typedef GenericTaskQueueSet<RefToScanQueue, mtGC> RefToScanQueueSet;
@@ -203,6 +205,7 @@ class G1CollectedHeap : public SharedHeap {
   friend class G1ParScanClosureSuper;
   friend class G1ParEvacuateFollowersClosure;
   friend class G1ParTask;
+  friend class G1ParOptionalEvacTask;
   friend class G1ParGCAllocator;
   friend class G1DefaultParGCAllocator;
   friend class G1FreeGarbageRegionClosure;
@@ -271,6 +274,9 @@ private:
   // Class that handles the different kinds of allocations.
   G1Allocator* _allocator;
 
+  // The NUMA nodes the heap regions are spread across.
+  G1NUMA* _numa;
+
   // Statistics for each allocation context
   AllocationContextStats _allocation_context_stats;
 
@@ -457,6 +463,9 @@ protected:
 
   ElasticHeap* _elastic_heap;
 
+  // The optional part of the collection set (G1UseOptionalCSet only).
+  G1OptionalCSet* _optional_cset;
+
   // The current policy object for the collector.
   G1CollectorPolicy* _g1_policy;
 
@@ -465,14 +474,16 @@ protected:
   // check whether there's anything available on the
   // secondary_free_list and/or wait for more regions to appear on
   // that list, if _free_regions_coming is set.
-  HeapRegion* new_region_try_secondary_free_list(bool is_old);
+  HeapRegion* new_region_try_secondary_free_list(bool is_old, uint node_index);
 
   // Try to allocate a single non-humongous HeapRegion sufficient for
   // an allocation of the given word_size. If do_expand is true,
   // attempt to expand the heap if necessary to satisfy the allocation
   // request. If the region is to be used as an old region or for a
-  // humongous object, set is_old to true. If not, to false.
-  HeapRegion* new_region(size_t word_size, bool is_old, bool do_expand);
+  // humongous object, set is_old to true. If not, to false. A region on
+  // the NUMA node node_index is preferred if one is available.
+  HeapRegion* new_region(size_t word_size, bool is_old, bool do_expand,
+                         uint node_index = G1NUMA::AnyNodeIndex);
 
   // Initialize a contiguous set of free regions of length num_regions
   // and starting at index first so that they appear as a single
@@ -541,6 +552,7 @@ protected:
   // pause. This should only be used for non-humongous allocations.
   HeapWord* attempt_allocation_slow(size_t word_size,
                                     AllocationContext_t context,
+                                    uint node_index,
                                     uint* gc_count_before_ret,
                                     uint* gclocker_retry_count_ret);
 
@@ -570,29 +582,32 @@ protected:
   // may not be a humongous - it must fit into a single heap region.
   inline HeapWord* par_allocate_during_gc(InCSetState dest,
                                           size_t word_size,
-                                          AllocationContext_t context);
+                                          AllocationContext_t context,
+                                          uint node_index);
   // Ensure that no further allocations can happen in "r", bearing in mind
   // that parallel threads might be attempting allocations.
   void par_allocate_remaining_space(HeapRegion* r);
 
   // Allocation attempt during GC for a survivor object / PLAB.
   inline HeapWord* survivor_attempt_allocation(size_t word_size,
-                                               AllocationContext_t context);
+                                               AllocationContext_t context,
+                                               uint node_index);
 
   // Allocation attempt during GC for an old object / PLAB.
   inline HeapWord* old_attempt_allocation(size_t word_size,
-                                          AllocationContext_t context);
+                                          AllocationContext_t context,
+                                          uint node_index);
 
   // These methods are the "callbacks" from the G1AllocRegion class.
 
   // For mutator alloc regions.
-  HeapRegion* new_mutator_alloc_region(size_t word_size, bool force);
+  HeapRegion* new_mutator_alloc_region(size_t word_size, bool force, uint node_index);
   void retire_mutator_alloc_region(HeapRegion* alloc_region,
                                    size_t allocated_bytes);
 
   // For GC alloc regions.
   HeapRegion* new_gc_alloc_region(size_t word_size, uint count,
-                                  InCSetState dest);
+                                  InCSetState dest, uint node_index);
   void retire_gc_alloc_region(HeapRegion* alloc_region,
                               size_t allocated_bytes, InCSetState dest);
 
@@ -617,6 +632,13 @@ protected:
   // and will be considered part of the used portion of the heap.
   void resize_if_necessary_after_full_collection(size_t word_size);
 
+  // Compute the range of heap capacities that keeps the free part of the
+  // heap within MinHeapFreeRatio and MaxHeapFreeRatio for the given
+  // number of used bytes, clamped to the minimum and maximum heap size.
+  void desired_capacity_range(size_t used_bytes,
+                              size_t* minimum_desired_capacity,
+                              size_t* maximum_desired_capacity);
+
   // Callback from VM_G1CollectForAllocation operation.
   // This function does everything necessary/possible to satisfy a
   // failed allocation request (including collection, expansion, etc.)
@@ -644,6 +666,10 @@ public:
     return _allocator;
   }
 
+  G1NUMA* numa() const {
+    return _numa;
+  }
+
   G1MonitoringSupport* g1mm() {
     assert(_g1mm != NULL, "should have been initialized");
     return _g1mm;
@@ -689,6 +715,15 @@ public:
   void register_old_region_with_in_cset_fast_test(HeapRegion* r) {
     _in_cset_fast_test.set_in_old(r->hrm_index());
   }
+  void register_optional_region_with_in_cset_fast_test(HeapRegion* r) {
+    _in_cset_fast_test.set_optional(r->hrm_index());
+  }
+  void clear_optional_region_in_cset_fast_test(HeapRegion* r) {
+    _in_cset_fast_test.clear_optional(r->hrm_index());
+  }
+  bool is_optional_region(HeapRegion* r) const {
+    return _in_cset_fast_test.get_by_index(r->hrm_index()).is_optional();
+  }
 
   // This is a fast test on whether a reference points into the
   // collection set or not. Assume that the reference
@@ -790,6 +825,15 @@ protected:
   // Actually do the work of evacuating the collection set.
   void evacuate_collection_set(EvacuationInfo& evacuation_info);
 
+  // Evacuate regions of the optional collection set in increments while
+  // the pause time goal leaves time for them, then hand the remaining
+  // optional regions back to the CSet chooser.
+  void evacuate_optional_collection_set(EvacuationInfo& evacuation_info);
+  // Evacuate the given regions, which were just added to the collection
+  // set, together with the objects referenced from the locations recorded
+  // for the optional collection set. Returns the elapsed time in ms.
+  double evacuate_optional_regions(HeapRegion** regions, uint num);
+
   // The g1 remembered set of the heap.
   G1RemSet* _g1_rem_set;
 
@@ -1009,6 +1053,11 @@ public:
 
   void set_refine_cte_cl_concurrency(bool concurrent);
 
+  // Uncommit free regions at the end of a successful remark pause so
+  // that the capacity does not exceed what MaxHeapFreeRatio allows.
+  // Only done if periodic GCs are enabled (see G1PeriodicGC).
+  void resize_heap_after_remark();
+
   RefToScanQueue *task_queue(int i) const;
 
   // A set of cards where updates happened during the GC
@@ -1499,6 +1548,8 @@ public:
 
   ElasticHeap* elastic_heap() const { return _elastic_heap; }
 
+  G1OptionalCSet* optional_cset() const { return _optional_cset; }
+
   // debugging
   bool check_young_list_well_formed() {
     return _young_list->check_list_well_formed();
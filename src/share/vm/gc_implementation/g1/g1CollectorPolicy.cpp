@@ -35,6 +35,7 @@
 #include "gc_implementation/g1/g1ErgoVerbose.hpp"
 #include "gc_implementation/g1/g1GCPhaseTimes.hpp"
 #include "gc_implementation/g1/g1Log.hpp"
+#include "gc_implementation/g1/g1OptionalCSet.hpp"
 #include "gc_implementation/g1/heapRegionRemSet.hpp"
 #include "gc_implementation/shared/gcPolicyCounters.hpp"
 #include "runtime/arguments.hpp"
@@ -95,6 +96,7 @@ G1CollectorPolicy::G1CollectorPolicy() :
 
   _alloc_rate_ms_seq(new TruncatedSeq(TruncatedSeqLength)),
   _prev_collection_pause_end_ms(0.0),
+  _last_pause_end_sec(0.0),
   _rs_length_diff_seq(new TruncatedSeq(TruncatedSeqLength)),
   _cost_per_card_ms_seq(new TruncatedSeq(TruncatedSeqLength)),
   _young_cards_per_entry_ratio_seq(new TruncatedSeq(TruncatedSeqLength)),
@@ -142,6 +144,8 @@ G1CollectorPolicy::G1CollectorPolicy() :
 
   _collection_set(NULL),
   _collection_set_bytes_used_before(0),
+  _cur_pause_target_ms(0.0),
+  _optional_increment_time_ratio(1.0),
 
   // Incremental CSet attributes
   _inc_cset_build_state(Inactive),
@@ -812,6 +816,7 @@ void G1CollectorPolicy::record_full_collection_end() {
   _trace_gen1_time_data.record_full_collection(full_gc_time_ms);
 
   update_recent_gc_times(end_sec, full_gc_time_ms);
+  _last_pause_end_sec = end_sec;
 
   _g1->clear_full_collection();
 
@@ -890,6 +895,7 @@ void G1CollectorPolicy::record_concurrent_mark_remark_end() {
   _concurrent_mark_remark_times_ms->add(elapsed_time_ms);
   _cur_mark_stop_world_time_ms += elapsed_time_ms;
   _prev_collection_pause_end_ms += elapsed_time_ms;
+  _last_pause_end_sec = end_time_sec;
 
   _mmu_tracker->add_pause(_mark_remark_start_sec, end_time_sec, true);
 }
@@ -988,6 +994,7 @@ void G1CollectorPolicy::record_collection_pause_end(double pause_time_ms, Evacua
 
   _mmu_tracker->add_pause(end_time_sec - pause_time_ms/1000.0,
                           end_time_sec, false);
+  _last_pause_end_sec = end_time_sec;
 
   evacuation_info.set_collectionset_used_before(_collection_set_bytes_used_before);
   evacuation_info.set_bytes_copied(_bytes_copied_during_gc);
@@ -1093,7 +1100,8 @@ void G1CollectorPolicy::record_collection_pause_end(double pause_time_ms, Evacua
 
     double cost_per_entry_ms = 0.0;
     if (cards_scanned > 10) {
-      cost_per_entry_ms = phase_times()->average_time_ms(G1GCPhaseTimes::ScanRS) / (double) cards_scanned;
+      cost_per_entry_ms = (phase_times()->average_time_ms(G1GCPhaseTimes::ScanRS) +
+                           phase_times()->average_optional_time_ms(G1GCPhaseTimes::OptScanRS)) / (double) cards_scanned;
       if (_last_gc_was_young) {
         _cost_per_entry_ms_seq->add(cost_per_entry_ms);
       } else {
@@ -1135,7 +1143,8 @@ void G1CollectorPolicy::record_collection_pause_end(double pause_time_ms, Evacua
     double cost_per_byte_ms = 0.0;
 
     if (copied_bytes > 0) {
-      cost_per_byte_ms = phase_times()->average_time_ms(G1GCPhaseTimes::ObjCopy) / (double) copied_bytes;
+      cost_per_byte_ms = (phase_times()->average_time_ms(G1GCPhaseTimes::ObjCopy) +
+                          phase_times()->average_optional_time_ms(G1GCPhaseTimes::OptObjCopy)) / (double) copied_bytes;
       if (_in_marking_window) {
         _cost_per_byte_ms_during_cm_seq->add(cost_per_byte_ms);
       } else {
@@ -1145,7 +1154,10 @@ void G1CollectorPolicy::record_collection_pause_end(double pause_time_ms, Evacua
 
     double all_other_time_ms = pause_time_ms -
       (phase_times()->average_time_ms(G1GCPhaseTimes::UpdateRS) + phase_times()->average_time_ms(G1GCPhaseTimes::ScanRS) +
-          phase_times()->average_time_ms(G1GCPhaseTimes::ObjCopy) + phase_times()->average_time_ms(G1GCPhaseTimes::Termination));
+          phase_times()->average_time_ms(G1GCPhaseTimes::ObjCopy) + phase_times()->average_time_ms(G1GCPhaseTimes::Termination) +
+          phase_times()->average_optional_time_ms(G1GCPhaseTimes::OptScanRS) +
+          phase_times()->average_optional_time_ms(G1GCPhaseTimes::OptObjCopy) +
+          phase_times()->average_optional_time_ms(G1GCPhaseTimes::OptTermination));
 
     double young_other_time_ms = 0.0;
     if (young_cset_region_length() > 0) {
@@ -1665,6 +1677,7 @@ G1CollectorPolicy::record_concurrent_mark_cleanup_end(int no_of_gc_threads) {
   _concurrent_mark_cleanup_times_ms->add(elapsed_time_ms);
   _cur_mark_stop_world_time_ms += elapsed_time_ms;
   _prev_collection_pause_end_ms += elapsed_time_ms;
+  _last_pause_end_sec = end_sec;
   _mmu_tracker->add_pause(_mark_cleanup_start_sec, end_sec, true);
 }
 
@@ -1684,6 +1697,105 @@ void G1CollectorPolicy::add_old_region_to_cset(HeapRegion* hr) {
   _old_cset_region_length += 1;
 }
 
+void G1CollectorPolicy::add_optional_region_to_cset(HeapRegion* hr) {
+  assert(_inc_cset_build_state == Inactive, "Precondition");
+  assert(SafepointSynchronize::is_at_safepoint(), "should be at a safepoint");
+  assert(hr->is_old(), "the region should be old");
+
+  assert(!hr->in_collection_set(), "should not already be in the CSet");
+  hr->set_in_collection_set(true);
+  hr->set_next_in_collection_set(_collection_set);
+  _collection_set = hr;
+  _collection_set_bytes_used_before += hr->used();
+  _g1->register_old_region_with_in_cset_fast_test(hr);
+  size_t rs_length = hr->rem_set()->occupied();
+  _recorded_rs_lengths += rs_length;
+  _old_cset_region_length += 1;
+}
+
+void G1CollectorPolicy::select_optional_cset_regions(G1OptionalCSet* optional_cset,
+                                                     uint max_regions,
+                                                     double time_budget_ms) {
+  assert(optional_cset->length() == 0, "optional regions of an earlier pause left over");
+  CollectionSetChooser* cset_chooser = _collectionSetChooser;
+  double predicted_total_ms = 0.0;
+
+  HeapRegion* hr = cset_chooser->peek();
+  while (hr != NULL && optional_cset->length() < max_regions) {
+    double reclaimable_perc = reclaimable_bytes_perc(cset_chooser->remaining_reclaimable_bytes());
+    if (reclaimable_perc <= (double) G1HeapWastePercent) {
+      break;
+    }
+    double predicted_time_ms = predict_region_elapsed_time_ms(hr, false);
+    if (predicted_total_ms + predicted_time_ms > time_budget_ms) {
+      break;
+    }
+    predicted_total_ms += predicted_time_ms;
+    // The region stays in the old region set until an increment moves it
+    // into the collection set.
+    cset_chooser->remove_and_move_to_next(hr);
+    optional_cset->add_region(hr);
+
+    hr = cset_chooser->peek();
+  }
+
+  ergo_verbose3(ErgoCSetConstruction,
+                "add optional old regions",
+                ergo_format_region("optional")
+                ergo_format_ms("predicted time")
+                ergo_format_ms("time budget"),
+                optional_cset->length(), predicted_total_ms, time_budget_ms);
+}
+
+double G1CollectorPolicy::optional_evacuation_time_left_ms() {
+  double elapsed_ms = (os::elapsedTime() - phase_times()->cur_collection_start_sec()) * 1000.0;
+  // Leave room for the work that follows the evacuation, such as
+  // reference processing and freeing the collection set.
+  return _cur_pause_target_ms - elapsed_ms - predict_constant_other_time_ms();
+}
+
+uint G1CollectorPolicy::calc_optional_increment_length(G1OptionalCSet* optional_cset,
+                                                       double time_left_ms,
+                                                       double* predicted_time_ms) {
+  uint num = 0;
+  double predicted_total_ms = 0.0;
+  while (num < optional_cset->num_remaining()) {
+    HeapRegion* hr = optional_cset->remaining_at(num);
+    double region_time_ms = predict_region_elapsed_time_ms(hr, false) * _optional_increment_time_ratio;
+    if (predicted_total_ms + region_time_ms > time_left_ms) {
+      break;
+    }
+    predicted_total_ms += region_time_ms;
+    num++;
+  }
+  *predicted_time_ms = predicted_total_ms;
+  return num;
+}
+
+void G1CollectorPolicy::record_optional_increment(uint num_regions,
+                                                  double predicted_time_ms,
+                                                  double time_ms,
+                                                  double time_left_ms) {
+  if (predicted_time_ms > 0.0) {
+    // Only ever make the predictions more conservative within a pause. The
+    // cost sequences pick up the measured times at the end of the pause.
+    _optional_increment_time_ratio = MAX2(_optional_increment_time_ratio,
+                                          time_ms / predicted_time_ms);
+  }
+  ergo_verbose4(ErgoCSetConstruction,
+                "evacuate optional old regions",
+                ergo_format_region("optional")
+                ergo_format_ms("predicted time")
+                ergo_format_ms("time")
+                ergo_format_ms("time left"),
+                num_regions, predicted_time_ms, time_ms, time_left_ms);
+}
+
+void G1CollectorPolicy::abandon_optional_cset(G1OptionalCSet* optional_cset) {
+  optional_cset->abandon_remaining(_collectionSetChooser);
+  _collectionSetChooser->verify();
+}
+
 // Initialize the per-collection-set information
 void G1CollectorPolicy::start_incremental_cset_building() {
   assert(_inc_cset_build_state == Inactive, "Precondition");
@@ -1964,6 +2076,9 @@ void G1CollectorPolicy::finalize_cset(double target_pause_time_ms, EvacuationInf
                     target_pause_time_ms));
   guarantee(_collection_set == NULL, "Precondition");
 
+  _cur_pause_target_ms = target_pause_time_ms;
+  _optional_increment_time_ratio = 1.0;
+
   double base_time_ms = predict_base_elapsed_time_ms(_pending_cards);
   double predicted_pause_time_ms = base_time_ms;
   double time_remaining_ms = MAX2(target_pause_time_ms - base_time_ms, 0.0);
@@ -2038,6 +2153,20 @@ void G1CollectorPolicy::finalize_cset(double target_pause_time_ms, EvacuationInf
     uint expensive_region_num = 0;
     bool check_time_remaining = adaptive_young_list_length();
 
+    // With an optional collection set, part of the time left is held back
+    // for the optional regions. Those are only evacuated if the mandatory
+    // part finishes early enough, so a misprediction for the old regions
+    // no longer extends the pause beyond its goal.
+    G1OptionalCSet* optional_cset = _g1->optional_cset();
+    double optional_time_ms = 0.0;
+    if (optional_cset != NULL && check_time_remaining &&
+        !during_initial_mark_pause()) {
+      optional_time_ms = time_remaining_ms * (double) G1OptionalCSetPercent / 100.0;
+      time_remaining_ms -= optional_time_ms;
+    } else {
+      optional_cset = NULL;
+    }
+
     HeapRegion* hr = cset_chooser->peek();
     while (hr != NULL) {
       if (old_cset_region_length() >= max_old_cset_length) {
@@ -2092,6 +2221,11 @@ void G1CollectorPolicy::finalize_cset(double target_pause_time_ms, EvacuationInf
                           ergo_format_region("min"),
                           predicted_time_ms, time_remaining_ms,
                           old_cset_region_length(), min_old_cset_length);
+            if (optional_cset != NULL) {
+              select_optional_cset_regions(optional_cset,
+                                           max_old_cset_length - old_cset_region_length(),
+                                           time_remaining_ms + optional_time_ms);
+            }
             break;
           }
 
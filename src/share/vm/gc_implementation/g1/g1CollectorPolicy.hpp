@@ -38,6 +38,7 @@
 class HeapRegion;
 class CollectionSetChooser;
 class G1GCPhaseTimes;
+class G1OptionalCSet;
 class ElasticHeap;
 
 // TraceGen0Time collects data on _both_ young and mixed evacuation pauses
@@ -242,6 +243,10 @@ private:
   TruncatedSeq* _alloc_rate_ms_seq;
   double        _prev_collection_pause_end_ms;
 
+  // The end time of the last pause of any kind, including remark,
+  // cleanup and Full GC pauses. Read by the periodic GC thread.
+  volatile double _last_pause_end_sec;
+
   TruncatedSeq* _rs_length_diff_seq;
   TruncatedSeq* _cost_per_card_ms_seq;
   TruncatedSeq* _young_cards_per_entry_ratio_seq;
@@ -455,6 +460,11 @@ public:
     return _mmu_tracker->max_gc_time() * 1000.0;
   }
 
+  // Milliseconds elapsed since the end of the last pause of any kind.
+  double time_since_last_pause_ms() const {
+    return (os::elapsedTime() - _last_pause_end_sec) * 1000.0;
+  }
+
   double predict_remark_time_ms() {
     return get_new_prediction(_concurrent_mark_remark_times_ms);
   }
@@ -505,6 +515,14 @@ private:
   // The number of bytes copied during the GC.
   size_t _bytes_copied_during_gc;
 
+  // The pause time goal of the current pause, used to decide how many
+  // optional regions can still be evacuated.
+  double _cur_pause_target_ms;
+
+  // How much longer than predicted the optional increments of the current
+  // pause took so far; applied to the predictions for the next increment.
+  double _optional_increment_time_ratio;
+
   // The associated information that is maintained while the incremental
   // collection set is being built with young regions. Used to populate
   // the recorded info for the evacuation pause.
@@ -646,6 +664,13 @@ private:
   // as a percentage of the current heap capacity.
   double reclaimable_bytes_perc(size_t reclaimable_bytes);
 
+  // Move candidate old regions from the CSet chooser to the optional
+  // collection set, as long as their predicted time fits into the given
+  // budget and at most max_regions of them.
+  void select_optional_cset_regions(G1OptionalCSet* optional_cset,
+                                    uint max_regions,
+                                    double time_budget_ms);
+
 public:
 
   G1CollectorPolicy();
@@ -746,6 +771,29 @@ public:
   // Add old region "hr" to the CSet.
   void add_old_region_to_cset(HeapRegion* hr);
 
+  // Add old region "hr" of the optional collection set to the CSet
+  // during the evacuation pause.
+  void add_optional_region_to_cset(HeapRegion* hr);
+
+  // The time in ms that is left for evacuating optional regions in the
+  // current pause.
+  double optional_evacuation_time_left_ms();
+
+  // Returns how many of the remaining optional regions are predicted
+  // to fit into the given time, and their predicted time.
+  uint calc_optional_increment_length(G1OptionalCSet* optional_cset,
+                                      double time_left_ms,
+                                      double* predicted_time_ms);
+
+  // Record the predicted and the actual time of an increment of the
+  // optional collection set.
+  void record_optional_increment(uint num_regions, double predicted_time_ms,
+                                 double time_ms, double time_left_ms);
+
+  // Hand the optional regions that were not evacuated back to the
+  // CSet chooser.
+  void abandon_optional_cset(G1OptionalCSet* optional_cset);
+
   // Incremental CSet Support
 
   // The head of the incrementally built collection set.
@@ -32,7 +32,8 @@
 #include "runtime/os.hpp"
 
 G1GCPhaseTimes::G1GCPhaseTimes(uint max_gc_threads) :
-  _max_gc_threads(max_gc_threads)
+  _max_gc_threads(max_gc_threads),
+  _optional_phases_active(false)
 {
   assert(max_gc_threads > 0, "Must have some GC threads");
 
@@ -68,6 +69,11 @@ G1GCPhaseTimes::G1GCPhaseTimes(uint max_gc_threads) :
   _update_rs_processed_buffers = new WorkerDataArray<size_t>(max_gc_threads, "Processed Buffers", true, G1Log::LevelFiner, 3);
   _gc_par_phases[UpdateRS]->link_thread_work_items(_update_rs_processed_buffers);
 
+  _scan_rs_scanned_cards = new WorkerDataArray<size_t>(max_gc_threads, "Scanned Cards", true, G1Log::LevelFiner, 3);
+  _gc_par_phases[ScanRS]->link_thread_work_items(_scan_rs_scanned_cards);
+  _scan_rs_claimed_cards = new WorkerDataArray<size_t>(max_gc_threads, "Claimed Cards", true, G1Log::LevelFinest, 3);
+  _scan_rs_skipped_cards = new WorkerDataArray<size_t>(max_gc_threads, "Skipped Cards", true, G1Log::LevelFinest, 3);
+
   _termination_attempts = new WorkerDataArray<size_t>(max_gc_threads, "Termination Attempts", true, G1Log::LevelFinest, 3);
   _gc_par_phases[Termination]->link_thread_work_items(_termination_attempts);
 
@@ -78,6 +84,15 @@ G1GCPhaseTimes::G1GCPhaseTimes(uint max_gc_threads) :
   _redirtied_cards = new WorkerDataArray<size_t>(max_gc_threads, "Redirtied Cards", true, G1Log::LevelFinest, 3);
   _gc_par_phases[RedirtyCards]->link_thread_work_items(_redirtied_cards);
 
+  _gc_par_phases[OptScanRS] = new WorkerDataArray<double>(max_gc_threads, "Optional Scan RS (ms)", true, G1Log::LevelFiner, 2);
+  _gc_par_phases[OptObjCopy] = new WorkerDataArray<double>(max_gc_threads, "Optional Object Copy (ms)", true, G1Log::LevelFiner, 2);
+  _gc_par_phases[OptTermination] = new WorkerDataArray<double>(max_gc_threads, "Optional Termination (ms)", true, G1Log::LevelFiner, 2);
+
+  _gc_par_phases[FullGCMark] = new WorkerDataArray<double>(max_gc_threads, "Mark (ms)", true, G1Log::LevelFiner, 2);
+  _gc_par_phases[FullGCPrepare] = new WorkerDataArray<double>(max_gc_threads, "Prepare Compaction (ms)", true, G1Log::LevelFiner, 2);
+  _gc_par_phases[FullGCAdjust] = new WorkerDataArray<double>(max_gc_threads, "Adjust Pointers (ms)", true, G1Log::LevelFiner, 2);
+  _gc_par_phases[FullGCCompact] = new WorkerDataArray<double>(max_gc_threads, "Compact (ms)", true, G1Log::LevelFiner, 2);
+
   // Cannot guard below line with TenantHeapIsolation since we do not have conditional compilation for tenant mode
   _gc_par_phases[TenantAllocationContextRoots] = new WorkerDataArray<double>(max_gc_threads, "G1TenantAllocationContext Roots (ms)", true, G1Log::LevelFinest, 3);
 }
@@ -90,11 +105,52 @@ void G1GCPhaseTimes::note_gc_start(uint active_gc_threads, bool mark_in_progress
   for (int i = 0; i < GCParPhasesSentinel; i++) {
     _gc_par_phases[i]->reset();
   }
+  _scan_rs_claimed_cards->reset();
+  _scan_rs_skipped_cards->reset();
 
   _gc_par_phases[StringDedupQueueFixup]->set_enabled(G1StringDedup::is_enabled());
   _gc_par_phases[StringDedupTableFixup]->set_enabled(G1StringDedup::is_enabled());
 
   _gc_par_phases[TenantAllocationContextRoots]->set_enabled(TenantHeapIsolation);
+
+  for (int i = FullGCPhasesFirst; i <= FullGCPhasesLast; i++) {
+    _gc_par_phases[i]->set_enabled(false);
+  }
+
+  _optional_phases_active = false;
+  for (int i = OptionalPhasesFirst; i <= OptionalPhasesLast; i++) {
+    _gc_par_phases[i]->set_enabled(false);
+  }
+  record_optional_evacuation(0.0, 0, 0, 0);
+}
+
+void G1GCPhaseTimes::note_optional_evacuation_start() {
+  assert(!_optional_phases_active, "only once per pause");
+  _optional_phases_active = true;
+  for (int i = OptionalPhasesFirst; i <= OptionalPhasesLast; i++) {
+    _gc_par_phases[i]->set_enabled(true);
+    for (uint j = 0; j < _active_gc_threads; j++) {
+      _gc_par_phases[i]->set(j, 0.0);
+    }
+  }
+}
+
+void G1GCPhaseTimes::note_full_gc_start(uint active_gc_threads) {
+  assert(active_gc_threads > 0, "The number of threads must be > 0");
+  assert(active_gc_threads <= _max_gc_threads, "The number of active threads must be <= the max number of threads");
+  _active_gc_threads = active_gc_threads;
+  _cur_full_gc_par_time_ms = 0.0;
+
+  for (int i = FullGCPhasesFirst; i <= FullGCPhasesLast; i++) {
+    _gc_par_phases[i]->reset();
+    _gc_par_phases[i]->set_enabled(true);
+  }
+}
+
+void G1GCPhaseTimes::note_full_gc_end() {
+  for (int i = FullGCPhasesFirst; i <= FullGCPhasesLast; i++) {
+    _gc_par_phases[i]->verify(_active_gc_threads);
+  }
 }
 
 void G1GCPhaseTimes::note_gc_end() {
@@ -117,6 +173,8 @@ void G1GCPhaseTimes::note_gc_end() {
   for (int i = 0; i < GCParPhasesSentinel; i++) {
     _gc_par_phases[i]->verify(_active_gc_threads);
   }
+  _scan_rs_claimed_cards->verify(_active_gc_threads);
+  _scan_rs_skipped_cards->verify(_active_gc_threads);
 }
 
 void G1GCPhaseTimes::print_stats(int level, const char* str, double value) {
@@ -144,6 +202,9 @@ double G1GCPhaseTimes::accounted_time_ms() {
     // Strong code root purge time
     misc_time_ms += _cur_strong_code_root_purge_time_ms;
 
+    // Evacuation of the optional collection set
+    misc_time_ms += _cur_optional_evac_time_ms;
+
     if (G1StringDedup::is_enabled()) {
       // String dedup fixup time
       misc_time_ms += _cur_string_dedup_fixup_time_ms;
@@ -170,6 +231,18 @@ void G1GCPhaseTimes::record_thread_work_item(GCParPhases phase, uint worker_i, s
   _gc_par_phases[phase]->set_thread_work_item(worker_i, count);
 }
 
+void G1GCPhaseTimes::record_scan_rs_cards(uint worker_i, size_t scanned, size_t claimed, size_t skipped) {
+  record_thread_work_item(ScanRS, worker_i, scanned);
+  _scan_rs_claimed_cards->set(worker_i, claimed);
+  _scan_rs_skipped_cards->set(worker_i, skipped);
+}
+
+void G1GCPhaseTimes::add_scan_rs_cards(uint worker_i, size_t scanned, size_t claimed, size_t skipped) {
+  _gc_par_phases[ScanRS]->thread_work_items()->add(worker_i, scanned);
+  _scan_rs_claimed_cards->add(worker_i, claimed);
+  _scan_rs_skipped_cards->add(worker_i, skipped);
+}
+
 // return the average time for a phase in milliseconds
 double G1GCPhaseTimes::average_time_ms(GCParPhases phase) {
   return _gc_par_phases[phase]->average(_active_gc_threads) * 1000.0;
@@ -233,6 +306,13 @@ class G1GCParPhasePrinter : public StackObj {
     } else {
       print_multi_length(phase_id, phase);
     }
+
+    // Claimed and Skipped Cards are finest level, unlike the Scanned Cards
+    // linked to the phase.
+    if (phase_id == G1GCPhaseTimes::ScanRS && G1Log::finest()) {
+      print_count_array(_phase_times->_scan_rs_claimed_cards);
+      print_count_array(_phase_times->_scan_rs_skipped_cards);
+    }
   }
 
  private:
@@ -243,8 +323,7 @@ class G1GCParPhasePrinter : public StackObj {
     buf.append_and_print_cr("[%s:  %.1lf]", phase->_title, _phase_times->get_time_ms(phase_id, 0));
 
     if (phase->_thread_work_items != NULL) {
-      LineBuffer buf2(phase->_thread_work_items->_indent_level);
-      buf2.append_and_print_cr("[%s:  " SIZE_FORMAT "]", phase->_thread_work_items->_title, _phase_times->sum_thread_work_items(phase_id));
+      print_count_array(phase->_thread_work_items);
     }
   }
 
@@ -256,29 +335,6 @@ class G1GCParPhasePrinter : public StackObj {
     buf.print_cr();
   }
 
-  void print_count_values(LineBuffer& buf, G1GCPhaseTimes::GCParPhases phase_id, WorkerDataArray<size_t>* thread_work_items) {
-    uint active_length = _phase_times->_active_gc_threads;
-    for (uint i = 0; i < active_length; ++i) {
-      buf.append("  " SIZE_FORMAT, _phase_times->get_thread_work_item(phase_id, i));
-    }
-    buf.print_cr();
-  }
-
-  void print_thread_work_items(G1GCPhaseTimes::GCParPhases phase_id, WorkerDataArray<size_t>* thread_work_items) {
-    LineBuffer buf(thread_work_items->_indent_level);
-    buf.append("[%s:", thread_work_items->_title);
-
-    if (G1Log::finest()) {
-      print_count_values(buf, phase_id, thread_work_items);
-    }
-
-    assert(thread_work_items->_print_sum, err_msg("%s does not have print sum true even though it is a count", thread_work_items->_title));
-
-    buf.append_and_print_cr(" Min: " SIZE_FORMAT ", Avg: %.1lf, Max: " SIZE_FORMAT ", Diff: " SIZE_FORMAT ", Sum: " SIZE_FORMAT "]",
-        _phase_times->min_thread_work_items(phase_id), _phase_times->average_thread_work_items(phase_id), _phase_times->max_thread_work_items(phase_id),
-        _phase_times->max_thread_work_items(phase_id) - _phase_times->min_thread_work_items(phase_id), _phase_times->sum_thread_work_items(phase_id));
-  }
-
   void print_multi_length(G1GCPhaseTimes::GCParPhases phase_id, WorkerDataArray<double>* phase) {
     LineBuffer buf(phase->_indent_level);
     buf.append("[%s:", phase->_title);
@@ -300,9 +356,33 @@ class G1GCParPhasePrinter : public StackObj {
     buf.append_and_print_cr("]");
 
     if (phase->_thread_work_items != NULL) {
-      print_thread_work_items(phase_id, phase->_thread_work_items);
+      print_count_array(phase->_thread_work_items);
     }
   }
+
+  void print_count_array(WorkerDataArray<size_t>* counts) {
+    uint active_length = _phase_times->_active_gc_threads;
+    LineBuffer buf(counts->_indent_level);
+    if (counts->_length == 1) {
+      // No need for min, max, average and sum for only one worker
+      buf.append_and_print_cr("[%s:  " SIZE_FORMAT "]", counts->_title, counts->get(0));
+      return;
+    }
+    buf.append("[%s:", counts->_title);
+
+    if (G1Log::finest()) {
+      for (uint i = 0; i < active_length; ++i) {
+        buf.append("  " SIZE_FORMAT, counts->get(i));
+      }
+      buf.print_cr();
+    }
+
+    assert(counts->_print_sum, err_msg("%s does not have print sum true even though it is a count", counts->_title));
+
+    buf.append_and_print_cr(" Min: " SIZE_FORMAT ", Avg: %.1lf, Max: " SIZE_FORMAT ", Diff: " SIZE_FORMAT ", Sum: " SIZE_FORMAT "]",
+        counts->minimum(active_length), counts->average(active_length), counts->maximum(active_length),
+        counts->maximum(active_length) - counts->minimum(active_length), counts->sum(active_length));
+  }
 };
 
 void G1GCPhaseTimes::print(double pause_time_sec) {
@@ -317,6 +397,18 @@ void G1GCPhaseTimes::print(double pause_time_sec) {
     par_phase_printer.print((GCParPhases) i);
   }
 
+  if (_optional_phases_active) {
+    print_stats(1, "Optional Evacuation", _cur_optional_evac_time_ms);
+    for (int i = OptionalPhasesFirst; i <= OptionalPhasesLast; i++) {
+      par_phase_printer.print((GCParPhases) i);
+    }
+    if (G1Log::finest()) {
+      print_stats(2, "Increments", (size_t) _cur_optional_increments);
+      print_stats(2, "Regions Evacuated", (size_t) _cur_optional_regions_evacuated);
+      print_stats(2, "Regions Returned", (size_t) _cur_optional_regions_returned);
+    }
+  }
+
   print_stats(1, "Code Root Fixup", _cur_collection_code_root_fixup_time_ms);
   print_stats(1, "Code Root Purge", _cur_strong_code_root_purge_time_ms);
   if (G1StringDedup::is_enabled()) {
@@ -354,10 +446,16 @@ void G1GCPhaseTimes::print(double pause_time_sec) {
     if (G1Log::finest()) {
       print_stats(3, "Humongous Total", _cur_fast_reclaim_humongous_total);
       print_stats(3, "Humongous Candidate", _cur_fast_reclaim_humongous_candidates);
+      if (G1EagerReclaimHumongousObjArrays) {
+        print_stats(3, "Humongous Obj Array Candidate", _cur_fast_reclaim_humongous_obj_array_candidates);
+      }
     }
     print_stats(2, "Humongous Reclaim", _cur_fast_reclaim_humongous_time_ms);
     if (G1Log::finest()) {
       print_stats(3, "Humongous Reclaimed", _cur_fast_reclaim_humongous_reclaimed);
+      if (G1EagerReclaimHumongousObjArrays) {
+        print_stats(3, "Humongous Obj Array Reclaimed", _cur_fast_reclaim_humongous_obj_array_reclaimed);
+      }
     }
   }
   print_stats(2, "Free CSet",
@@ -372,6 +470,15 @@ void G1GCPhaseTimes::print(double pause_time_sec) {
   }
 }
 
+void G1GCPhaseTimes::print_full_gc() {
+  G1GCParPhasePrinter par_phase_printer(this);
+
+  print_stats(1, "Parallel Time", _cur_full_gc_par_time_ms, _active_gc_threads);
+  for (int i = FullGCPhasesFirst; i <= FullGCPhasesLast; i++) {
+    par_phase_printer.print((GCParPhases) i);
+  }
+}
+
 G1GCParPhaseTimesTracker::G1GCParPhaseTimesTracker(G1GCPhaseTimes* phase_times, G1GCPhaseTimes::GCParPhases phase, uint worker_id) :
     _phase_times(phase_times), _phase(phase), _worker_id(worker_id) {
   if (_phase_times != NULL) {
@@ -69,6 +69,13 @@ class G1GCPhaseTimes : public CHeapObj<mtGC> {
     StringDedupQueueFixup,
     StringDedupTableFixup,
     RedirtyCards,
+    OptScanRS,
+    OptObjCopy,
+    OptTermination,
+    FullGCMark,
+    FullGCPrepare,
+    FullGCAdjust,
+    FullGCCompact,
     GCParPhasesSentinel
   };
 
@@ -77,9 +84,19 @@ class G1GCPhaseTimes : public CHeapObj<mtGC> {
   static const int GCMainParPhasesLast = GCWorkerEnd;
   static const int StringDedupPhasesFirst = StringDedupQueueFixup;
   static const int StringDedupPhasesLast = StringDedupTableFixup;
+  static const int OptionalPhasesFirst = OptScanRS;
+  static const int OptionalPhasesLast = OptTermination;
+  static const int FullGCPhasesFirst = FullGCMark;
+  static const int FullGCPhasesLast = FullGCCompact;
 
   WorkerDataArray<double>* _gc_par_phases[GCParPhasesSentinel];
   WorkerDataArray<size_t>* _update_rs_processed_buffers;
+  WorkerDataArray<size_t>* _scan_rs_scanned_cards;
+  // Cards of the blocks a worker claimed during RSet scanning and the
+  // cards it had to walk past because other workers claimed them; only
+  // printed at the finest level to show how the scan was balanced.
+  WorkerDataArray<size_t>* _scan_rs_claimed_cards;
+  WorkerDataArray<size_t>* _scan_rs_skipped_cards;
   WorkerDataArray<size_t>* _termination_attempts;
   WorkerDataArray<size_t>* _redirtied_cards;
 
@@ -93,6 +110,12 @@ class G1GCPhaseTimes : public CHeapObj<mtGC> {
 
   double _cur_string_dedup_fixup_time_ms;
 
+  bool   _optional_phases_active;
+  double _cur_optional_evac_time_ms;
+  uint   _cur_optional_increments;
+  uint   _cur_optional_regions_evacuated;
+  uint   _cur_optional_regions_returned;
+
   double _cur_clear_ct_time_ms;
   double _cur_ref_proc_time_ms;
   double _cur_ref_enq_time_ms;
@@ -113,10 +136,14 @@ class G1GCPhaseTimes : public CHeapObj<mtGC> {
   size_t _cur_fast_reclaim_humongous_total;
   size_t _cur_fast_reclaim_humongous_candidates;
   size_t _cur_fast_reclaim_humongous_reclaimed;
+  size_t _cur_fast_reclaim_humongous_obj_array_candidates;
+  size_t _cur_fast_reclaim_humongous_obj_array_reclaimed;
 
   double _cur_verify_before_time_ms;
   double _cur_verify_after_time_ms;
 
+  double _cur_full_gc_par_time_ms;
+
   // Helper methods for detailed logging
   void print_stats(int level, const char* str, double value);
   void print_stats(int level, const char* str, size_t value);
@@ -128,6 +155,11 @@ class G1GCPhaseTimes : public CHeapObj<mtGC> {
   void note_gc_end();
   void print(double pause_time_sec);
 
+  // The parallel full GC records its phases in the FullGC* entries.
+  void note_full_gc_start(uint active_gc_threads);
+  void note_full_gc_end();
+  void print_full_gc();
+
   // record the time a phase took in seconds
   void record_time_secs(GCParPhases phase, uint worker_i, double secs);
 
@@ -136,6 +168,9 @@ class G1GCPhaseTimes : public CHeapObj<mtGC> {
 
   void record_thread_work_item(GCParPhases phase, uint worker_i, size_t count);
 
+  void record_scan_rs_cards(uint worker_i, size_t scanned, size_t claimed, size_t skipped);
+  void add_scan_rs_cards(uint worker_i, size_t scanned, size_t claimed, size_t skipped);
+
   // return the average time for a phase in milliseconds
   double average_time_ms(GCParPhases phase);
 
@@ -205,15 +240,19 @@ class G1GCPhaseTimes : public CHeapObj<mtGC> {
     _recorded_non_young_free_cset_time_ms = time_ms;
   }
 
-  void record_fast_reclaim_humongous_stats(double time_ms, size_t total, size_t candidates) {
+  void record_fast_reclaim_humongous_stats(double time_ms, size_t total, size_t candidates,
+                                           size_t obj_array_candidates) {
     _cur_fast_reclaim_humongous_register_time_ms = time_ms;
     _cur_fast_reclaim_humongous_total = total;
     _cur_fast_reclaim_humongous_candidates = candidates;
+    _cur_fast_reclaim_humongous_obj_array_candidates = obj_array_candidates;
   }
 
-  void record_fast_reclaim_humongous_time_ms(double value, size_t reclaimed) {
+  void record_fast_reclaim_humongous_time_ms(double value, size_t reclaimed,
+                                             size_t obj_arrays_reclaimed) {
     _cur_fast_reclaim_humongous_time_ms = value;
     _cur_fast_reclaim_humongous_reclaimed = reclaimed;
+    _cur_fast_reclaim_humongous_obj_array_reclaimed = obj_arrays_reclaimed;
   }
 
   void record_young_cset_choice_time_ms(double time_ms) {
@@ -232,6 +271,28 @@ class G1GCPhaseTimes : public CHeapObj<mtGC> {
     _cur_collection_start_sec = time_ms;
   }
 
+  double cur_collection_start_sec() const {
+    return _cur_collection_start_sec;
+  }
+
+  // Enables the optional evacuation phases, which the increments of the
+  // optional collection set add their times to.
+  void note_optional_evacuation_start();
+
+  void record_optional_evacuation(double time_ms, uint increments,
+                                  uint regions_evacuated, uint regions_returned) {
+    _cur_optional_evac_time_ms = time_ms;
+    _cur_optional_increments = increments;
+    _cur_optional_regions_evacuated = regions_evacuated;
+    _cur_optional_regions_returned = regions_returned;
+  }
+
+  // Average time of an optional evacuation phase, zero if no optional
+  // regions were evacuated in this pause.
+  double average_optional_time_ms(GCParPhases phase) {
+    return _optional_phases_active ? average_time_ms(phase) : 0.0;
+  }
+
   void record_verify_before_time_ms(double time_ms) {
     _cur_verify_before_time_ms = time_ms;
   }
@@ -240,6 +301,10 @@ class G1GCPhaseTimes : public CHeapObj<mtGC> {
     _cur_verify_after_time_ms = time_ms;
   }
 
+  void record_full_gc_par_time_ms(double ms) {
+    _cur_full_gc_par_time_ms = ms;
+  }
+
   double accounted_time_ms();
 
   double cur_collection_start_sec() {
@@ -37,6 +37,7 @@
 #include "gc_implementation/shared/gcTimer.hpp"
 #include "gc_implementation/shared/gcTrace.hpp"
 #include "gc_implementation/shared/gcTraceTime.hpp"
+#include "gc_implementation/shared/parallelCleaning.hpp"
 #include "memory/gcLocker.hpp"
 #include "memory/genCollectedHeap.hpp"
 #include "memory/modRefBarrierSet.hpp"
@@ -170,14 +171,9 @@ void G1MarkSweep::mark_sweep_phase1(bool& marked_for_unloading,
 
   if (ClassUnloading) {
 
-     // Unload classes and purge the SystemDictionary.
-     bool purged_class = SystemDictionary::do_unloading(&GenMarkSweep::is_alive);
-
-     // Unload nmethods.
-     CodeCache::do_unloading(&GenMarkSweep::is_alive, purged_class);
-
-     // Prune dead klasses from subklass/sibling/implementor lists.
-     Klass::clean_weak_klass_links(&GenMarkSweep::is_alive);
+     // Unload classes, nmethods and prune dead klasses from
+     // subklass/sibling/implementor lists.
+     ParallelCleaning::unload_classes(&GenMarkSweep::is_alive, G1CollectedHeap::heap()->workers());
   }
   // Delete entries for dead interned string and clean up unreferenced symbols in symbol table.
   G1CollectedHeap::heap()->unlink_string_and_symbol_table(&GenMarkSweep::is_alive);
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "precompiled.hpp"
+#include "gc_implementation/g1/g1CollectedHeap.inline.hpp"
+#include "gc_implementation/g1/g1NUMA.hpp"
+#include "gc_implementation/g1/heapRegion.hpp"
+#include "utilities/ostream.hpp"
+
+G1NUMA* G1NUMA::_inst = NULL;
+
+G1NUMA* G1NUMA::create() {
+  guarantee(_inst == NULL, "Should be called once.");
+  _inst = new G1NUMA();
+  _inst->initialize(UseNUMA);
+  return _inst;
+}
+
+G1NUMA::G1NUMA() :
+  _node_ids(NULL), _node_id_to_index_map(NULL), _len_node_id_to_index_map(0),
+  _num_active_node_ids(0), _region_size(0), _page_size(0),
+  _local_region_allocs(NULL), _remote_region_allocs(NULL) {
+}
+
+void G1NUMA::initialize(bool use_numa) {
+  if (use_numa) {
+    size_t num_node_ids = os::numa_get_groups_num();
+    _node_ids = NEW_C_HEAP_ARRAY(int, MAX2(num_node_ids, (size_t)1), mtGC);
+    _num_active_node_ids = (uint)os::numa_get_leaf_groups(_node_ids, num_node_ids);
+  }
+  if (_num_active_node_ids <= 1) {
+    // Either NUMA is off or there is nothing to choose from: behave as
+    // a single node machine.
+    if (_node_ids == NULL) {
+      _node_ids = NEW_C_HEAP_ARRAY(int, 1, mtGC);
+    }
+    _node_ids[0] = 0;
+    _num_active_node_ids = 1;
+  }
+
+  int max_node_id = 0;
+  for (uint i = 0; i < _num_active_node_ids; i++) {
+    max_node_id = MAX2(max_node_id, _node_ids[i]);
+  }
+
+  _len_node_id_to_index_map = max_node_id + 1;
+  _node_id_to_index_map = NEW_C_HEAP_ARRAY(uint, _len_node_id_to_index_map, mtGC);
+  for (int i = 0; i < _len_node_id_to_index_map; i++) {
+    _node_id_to_index_map[i] = UnknownNodeIndex;
+  }
+  for (uint i = 0; i < _num_active_node_ids; i++) {
+    _node_id_to_index_map[_node_ids[i]] = i;
+  }
+
+  _local_region_allocs = NEW_C_HEAP_ARRAY(size_t, _num_active_node_ids, mtGC);
+  _remote_region_allocs = NEW_C_HEAP_ARRAY(size_t, _num_active_node_ids, mtGC);
+  for (uint i = 0; i < _num_active_node_ids; i++) {
+    _local_region_allocs[i] = 0;
+    _remote_region_allocs[i] = 0;
+  }
+}
+
+G1NUMA::~G1NUMA() {
+  FREE_C_HEAP_ARRAY(int, _node_ids, mtGC);
+  FREE_C_HEAP_ARRAY(uint, _node_id_to_index_map, mtGC);
+  FREE_C_HEAP_ARRAY(size_t, _local_region_allocs, mtGC);
+  FREE_C_HEAP_ARRAY(size_t, _remote_region_allocs, mtGC);
+}
+
+int G1NUMA::numa_id(uint index) const {
+  assert(index < _num_active_node_ids,
+         err_msg("Index %u should be less than " UINT32_FORMAT, index, _num_active_node_ids));
+  return _node_ids[index];
+}
+
+uint G1NUMA::index_of_node_id(int node_id) const {
+  if (node_id < 0 || node_id >= _len_node_id_to_index_map) {
+    return UnknownNodeIndex;
+  }
+  return _node_id_to_index_map[node_id];
+}
+
+uint G1NUMA::index_of_current_thread() const {
+  if (!is_enabled()) {
+    return 0;
+  }
+  uint index = index_of_node_id(os::numa_get_group_id());
+  // The thread may run on a cpu of a node without memory.
+  return index == UnknownNodeIndex ? 0 : index;
+}
+
+void G1NUMA::set_region_info(size_t region_size, size_t page_size) {
+  _region_size = region_size;
+  _page_size = page_size;
+}
+
+uint G1NUMA::preferred_node_index_for_index(uint region_index) const {
+  if (!is_enabled()) {
+    return 0;
+  }
+  if (region_size() >= page_size()) {
+    // Each region spans one or more whole pages, spread them round robin.
+    return region_index % _num_active_node_ids;
+  }
+  // Several regions share a page, and a page can only live on one node:
+  // all regions of a page get the node of that page.
+  size_t regions_per_page = page_size() / region_size();
+  return (uint)((region_index / regions_per_page) % _num_active_node_ids);
+}
+
+void G1NUMA::request_memory_on_node(void* address, size_t size, uint region_index) {
+  if (!is_enabled() || size == 0) {
+    return;
+  }
+  char* aligned_address = (char*)align_ptr_down(address, page_size());
+  size_t aligned_size = align_size_up(size + pointer_delta(address, aligned_address, 1), page_size());
+  uint node_index = preferred_node_index_for_index(region_index);
+  os::numa_make_local(aligned_address, aligned_size, numa_id(node_index));
+}
+
+void G1NUMA::record_region_allocation(uint requested_node_index, HeapRegion* hr) {
+  // Also counted with a single node, where every allocation is local.
+  if (!UseNUMA || requested_node_index >= _num_active_node_ids) {
+    return;
+  }
+  if (hr->node_index() == requested_node_index) {
+    _local_region_allocs[requested_node_index]++;
+  } else {
+    _remote_region_allocs[requested_node_index]++;
+  }
+}
+
+// Counts the committed regions of each node by region type.
+class G1NUMANodeStatsClosure : public HeapRegionClosure {
+public:
+  enum RegionKind {
+    Eden,
+    Survivor,
+    Old,
+    Humongous,
+    Free,
+    NumKinds
+  };
+
+private:
+  size_t* _counts;
+  uint _num_nodes;
+
+public:
+  G1NUMANodeStatsClosure(uint num_nodes) : _num_nodes(num_nodes) {
+    _counts = NEW_C_HEAP_ARRAY(size_t, num_nodes * NumKinds, mtGC);
+    for (uint i = 0; i < num_nodes * NumKinds; i++) {
+      _counts[i] = 0;
+    }
+  }
+
+  ~G1NUMANodeStatsClosure() {
+    FREE_C_HEAP_ARRAY(size_t, _counts, mtGC);
+  }
+
+  size_t count(uint node_index, RegionKind kind) const {
+    return _counts[node_index * NumKinds + kind];
+  }
+
+  bool doHeapRegion(HeapRegion* hr) {
+    uint node_index = hr->node_index();
+    if (node_index >= _num_nodes) {
+      return false;
+    }
+    RegionKind kind;
+    if (hr->is_eden()) {
+      kind = Eden;
+    } else if (hr->is_survivor()) {
+      kind = Survivor;
+    } else if (hr->isHumongous()) {
+      kind = Humongous;
+    } else if (hr->is_old()) {
+      kind = Old;
+    } else {
+      kind = Free;
+    }
+    _counts[node_index * NumKinds + kind]++;
+    return false;
+  }
+};
+
+void G1NUMA::print_statistics(outputStream* out) {
+  if (!UseNUMA) {
+    return;
+  }
+
+  G1NUMANodeStatsClosure cl(_num_active_node_ids);
+  G1CollectedHeap::heap()->heap_region_iterate(&cl);
+
+  out->print_cr("   [NUMA Nodes: %u]", _num_active_node_ids);
+  for (uint i = 0; i < _num_active_node_ids; i++) {
+    size_t local = _local_region_allocs[i];
+    size_t total = local + _remote_region_allocs[i];
+    out->print_cr("      [Node %u (id %d): Eden: " SIZE_FORMAT " Survivor: " SIZE_FORMAT
+                  " Old: " SIZE_FORMAT " Humongous: " SIZE_FORMAT " Free: " SIZE_FORMAT " regions,"
+                  " Local Region Allocs: " SIZE_FORMAT "/" SIZE_FORMAT " (%.1f%%)]",
+                  i, numa_id(i),
+                  cl.count(i, G1NUMANodeStatsClosure::Eden),
+                  cl.count(i, G1NUMANodeStatsClosure::Survivor),
+                  cl.count(i, G1NUMANodeStatsClosure::Old),
+                  cl.count(i, G1NUMANodeStatsClosure::Humongous),
+                  cl.count(i, G1NUMANodeStatsClosure::Free),
+                  local, total,
+                  total == 0 ? 100.0 : (double)local * 100.0 / (double)total);
+    _local_region_allocs[i] = 0;
+    _remote_region_allocs[i] = 0;
+  }
+}
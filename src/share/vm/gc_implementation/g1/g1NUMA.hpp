@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef SHARE_VM_GC_IMPLEMENTATION_G1_G1NUMA_HPP
+#define SHARE_VM_GC_IMPLEMENTATION_G1_G1NUMA_HPP
+
+#include "memory/allocation.hpp"
+#include "runtime/os.hpp"
+
+class HeapRegion;
+class outputStream;
+
+// G1NUMA keeps track of the NUMA nodes the heap is spread across when
+// running with -XX:+UseNUMA. Every heap region is assigned a preferred
+// node (by region index, round robin in page sized chunks) and its
+// memory is bound to that node when the region is committed. Allocators
+// then ask for regions on the node of the requesting thread so that
+// mutators allocate into, and GC workers copy into, node local memory.
+//
+// Nodes are identified by a dense "node index" in [0, num_active_nodes())
+// rather than by the OS node id, so that per-node data can be kept in
+// plain arrays. Without UseNUMA there is exactly one node, index 0.
+class G1NUMA : public CHeapObj<mtGC> {
+  friend class G1NUMANodeStatsClosure;
+
+  // Mapping of node index to OS node id.
+  int* _node_ids;
+  // Mapping of OS node id to node index, UnknownNodeIndex if the id is
+  // not one of the active nodes.
+  uint* _node_id_to_index_map;
+  int _len_node_id_to_index_map;
+  uint _num_active_node_ids;
+
+  size_t _region_size;
+  size_t _page_size;
+
+  // Per-node counts of region allocation requests that could / could
+  // not be satisfied from the requested node since the last time the
+  // statistics were printed. Updated with the free list lock held.
+  size_t* _local_region_allocs;
+  size_t* _remote_region_allocs;
+
+  static G1NUMA* _inst;
+
+  G1NUMA();
+  void initialize(bool use_numa);
+
+  size_t region_size() const { return _region_size; }
+  size_t page_size() const { return _page_size; }
+
+public:
+  static const uint UnknownNodeIndex = UINT_MAX;
+  // Passed instead of a node index when the caller has no preference.
+  static const uint AnyNodeIndex = UINT_MAX - 1;
+
+  static G1NUMA* create();
+  static G1NUMA* numa() { return _inst; }
+
+  ~G1NUMA();
+
+  // Whether more than one node is in use, i.e. whether the node of a
+  // region or a thread matters at all.
+  bool is_enabled() const { return num_active_nodes() > 1; }
+
+  uint num_active_nodes() const { return _num_active_node_ids; }
+
+  int numa_id(uint index) const;
+  uint index_of_node_id(int node_id) const;
+
+  // Node index of the node the calling thread is currently running on.
+  uint index_of_current_thread() const;
+
+  // Set the region and heap page size, the granularity at which regions
+  // are assigned to nodes is the larger of the two.
+  void set_region_info(size_t region_size, size_t page_size);
+
+  // Node index the region with the given index should live on.
+  uint preferred_node_index_for_index(uint region_index) const;
+
+  // Bind the (just committed) memory of the region with the given index
+  // to its preferred node.
+  void request_memory_on_node(void* address, size_t size, uint region_index);
+
+  // Record the outcome of a region allocation for the requested node.
+  void record_region_allocation(uint requested_node_index, HeapRegion* hr);
+
+  // Print per-node region usage and allocation locality since the last
+  // call, and reset the allocation counters. Printed with UseNUMA even if
+  // there is only one node.
+  void print_statistics(outputStream* out);
+};
+
+#endif // SHARE_VM_GC_IMPLEMENTATION_G1_G1NUMA_HPP
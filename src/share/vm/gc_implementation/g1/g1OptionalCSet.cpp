@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "precompiled.hpp"
+#include "gc_implementation/g1/collectionSetChooser.hpp"
+#include "gc_implementation/g1/g1CollectedHeap.inline.hpp"
+#include "gc_implementation/g1/g1CollectorPolicy.hpp"
+#include "gc_implementation/g1/g1OptionalCSet.hpp"
+#include "gc_implementation/g1/heapRegion.hpp"
+#include "memory/allocation.inline.hpp"
+
+G1OptionalCSet::G1OptionalCSet(G1CollectedHeap* g1h) :
+  _g1h(g1h),
+  _regions(new (ResourceObj::C_HEAP, mtGC) GrowableArray<HeapRegion*>(16, true, mtGC)),
+  _current_index(0),
+  _n_workers(MAX2((uint) ParallelGCThreads, 1u)),
+  _oop_refs(NULL),
+  _narrow_oop_refs(NULL),
+  _increments(0) {
+  _oop_refs = NEW_C_HEAP_ARRAY(GrowableArray<oop*>*, _n_workers, mtGC);
+  _narrow_oop_refs = NEW_C_HEAP_ARRAY(GrowableArray<narrowOop*>*, _n_workers, mtGC);
+  for (uint i = 0; i < _n_workers; i++) {
+    _oop_refs[i] = NULL;
+    _narrow_oop_refs[i] = NULL;
+  }
+}
+
+G1OptionalCSet::~G1OptionalCSet() {
+  delete_ref_lists(_oop_refs, _n_workers);
+  delete_ref_lists(_narrow_oop_refs, _n_workers);
+  FREE_C_HEAP_ARRAY(GrowableArray<oop*>*, _oop_refs, mtGC);
+  FREE_C_HEAP_ARRAY(GrowableArray<narrowOop*>*, _narrow_oop_refs, mtGC);
+  delete _regions;
+}
+
+template <class T>
+GrowableArray<T*>* G1OptionalCSet::new_ref_list() {
+  return new (ResourceObj::C_HEAP, mtGC) GrowableArray<T*>(1024, true, mtGC);
+}
+
+template <class T>
+void G1OptionalCSet::delete_ref_lists(GrowableArray<T*>** lists, uint n) {
+  for (uint i = 0; i < n; i++) {
+    if (lists[i] != NULL) {
+      delete lists[i];
+      lists[i] = NULL;
+    }
+  }
+}
+
+void G1OptionalCSet::add_region(HeapRegion* hr) {
+  assert(SafepointSynchronize::is_at_safepoint(), "should be at a safepoint");
+  assert(hr->is_old() && !hr->in_collection_set(), "only old regions outside the CSet can be optional");
+  _regions->append(hr);
+  _g1h->register_optional_region_with_in_cset_fast_test(hr);
+}
+
+HeapRegion** G1OptionalCSet::start_increment(uint num) {
+  assert(num > 0 && num <= num_remaining(),
+         err_msg("invalid increment of %u regions, %u remaining", num, num_remaining()));
+  G1CollectorPolicy* policy = _g1h->g1_policy();
+  for (uint i = 0; i < num; i++) {
+    HeapRegion* hr = remaining_at(i);
+    _g1h->clear_optional_region_in_cset_fast_test(hr);
+    _g1h->old_set_remove(hr);
+    policy->add_optional_region_to_cset(hr);
+    if (_g1h->hr_printer()->is_active()) {
+      _g1h->hr_printer()->cset(hr);
+    }
+  }
+  HeapRegion** result = _regions->adr_at((int) _current_index);
+  _current_index += num;
+  _increments++;
+  return result;
+}
+
+GrowableArray<oop*>* G1OptionalCSet::claim_oop_refs(uint worker_id) {
+  assert(worker_id < _n_workers, "invalid worker id");
+  GrowableArray<oop*>* result = _oop_refs[worker_id];
+  _oop_refs[worker_id] = NULL;
+  return result;
+}
+
+GrowableArray<narrowOop*>* G1OptionalCSet::claim_narrow_oop_refs(uint worker_id) {
+  assert(worker_id < _n_workers, "invalid worker id");
+  GrowableArray<narrowOop*>* result = _narrow_oop_refs[worker_id];
+  _narrow_oop_refs[worker_id] = NULL;
+  return result;
+}
+
+void G1OptionalCSet::abandon_remaining(CollectionSetChooser* chooser) {
+  // The regions were removed from the chooser in list order, so put them
+  // back starting with the last one.
+  for (int i = _regions->length() - 1; i >= (int) _current_index; i--) {
+    HeapRegion* hr = _regions->at(i);
+    _g1h->clear_optional_region_in_cset_fast_test(hr);
+    chooser->push_back(hr);
+  }
+  delete_ref_lists(_oop_refs, _n_workers);
+  delete_ref_lists(_narrow_oop_refs, _n_workers);
+  _regions->clear();
+  _current_index = 0;
+  _increments = 0;
+}
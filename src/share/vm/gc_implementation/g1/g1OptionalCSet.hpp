@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef SHARE_VM_GC_IMPLEMENTATION_G1_G1OPTIONALCSET_HPP
+#define SHARE_VM_GC_IMPLEMENTATION_G1_G1OPTIONALCSET_HPP
+
+#include "memory/allocation.hpp"
+#include "oops/oopsHierarchy.hpp"
+#include "utilities/growableArray.hpp"
+
+class CollectionSetChooser;
+class G1CollectedHeap;
+class HeapRegion;
+
+// The optional part of the collection set of a mixed pause.
+//
+// When G1UseOptionalCSet is enabled, G1CollectorPolicy::finalize_cset()
+// only adds the old regions that fit into a reduced pause time budget to
+// the collection set. The old regions the CSet chooser would hand out next
+// are kept here instead. They stay in the old region set and are tagged as
+// Optional in the in-cset fast test table, so that the evacuation closures
+// see references into them and record the locations of those references.
+//
+// After the collection set has been evacuated, the pause takes optional
+// regions in increments for as long as the predicted time of an increment
+// fits into the time left. An increment moves its regions into the
+// collection set, scans their remembered sets and strong code roots,
+// and evacuates the objects referenced from the recorded locations.
+// Regions that were not evacuated when the pause runs out of time are
+// handed back to the CSet chooser in their original order.
+class G1OptionalCSet : public CHeapObj<mtGC> {
+  G1CollectedHeap* _g1h;
+
+  // The optional regions in the order they were taken from the CSet chooser.
+  GrowableArray<HeapRegion*>* _regions;
+  // Index of the first region that has not been moved into the collection set.
+  uint _current_index;
+
+  // Per worker lists of the locations that referred to an optional region
+  // when they were scanned. Allocated lazily.
+  uint _n_workers;
+  GrowableArray<oop*>** _oop_refs;
+  GrowableArray<narrowOop*>** _narrow_oop_refs;
+
+  uint _increments;
+
+  template <class T> static GrowableArray<T*>* new_ref_list();
+  template <class T> static void delete_ref_lists(GrowableArray<T*>** lists, uint n);
+
+ public:
+  G1OptionalCSet(G1CollectedHeap* g1h);
+  ~G1OptionalCSet();
+
+  // Adds an old region that was just removed from the CSet chooser.
+  void add_region(HeapRegion* hr);
+
+  uint length() const           { return (uint) _regions->length(); }
+  uint num_remaining() const    { return length() - _current_index; }
+  bool is_empty() const         { return num_remaining() == 0; }
+  uint num_increments() const   { return _increments; }
+  uint num_evacuated() const    { return _current_index; }
+
+  // The i-th region that has not been moved into the collection set yet.
+  HeapRegion* remaining_at(uint i) const {
+    return _regions->at((int) (_current_index + i));
+  }
+
+  // Moves the next num regions into the collection set. Returns the
+  // address of the first of them; the array stays valid until clear().
+  HeapRegion** start_increment(uint num);
+
+  // Called by the evacuation closures with the id of the calling worker.
+  void record_ref(uint worker_id, oop* p) {
+    if (_oop_refs[worker_id] == NULL) {
+      _oop_refs[worker_id] = new_ref_list<oop>();
+    }
+    _oop_refs[worker_id]->append(p);
+  }
+  void record_ref(uint worker_id, narrowOop* p) {
+    if (_narrow_oop_refs[worker_id] == NULL) {
+      _narrow_oop_refs[worker_id] = new_ref_list<narrowOop>();
+    }
+    _narrow_oop_refs[worker_id]->append(p);
+  }
+
+  // Hands the references recorded by the given worker to the caller, which
+  // becomes responsible for deleting the list. References recorded from now
+  // on go to a new list.
+  GrowableArray<oop*>* claim_oop_refs(uint worker_id);
+  GrowableArray<narrowOop*>* claim_narrow_oop_refs(uint worker_id);
+
+  // Returns the regions that were not evacuated to the CSet chooser, clears
+  // their Optional tag and discards the recorded references.
+  void abandon_remaining(CollectionSetChooser* chooser);
+};
+
+#endif // SHARE_VM_GC_IMPLEMENTATION_G1_G1OPTIONALCSET_HPP
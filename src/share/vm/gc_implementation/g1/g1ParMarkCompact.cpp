@@ -0,0 +1,709 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "precompiled.hpp"
+#include "classfile/symbolTable.hpp"
+#include "classfile/systemDictionary.hpp"
+#include "code/codeCache.hpp"
+#include "gc_implementation/g1/concurrentMark.inline.hpp"
+#include "gc_implementation/g1/g1CollectedHeap.inline.hpp"
+#include "gc_implementation/g1/g1GCPhaseTimes.hpp"
+#include "gc_implementation/g1/g1Log.hpp"
+#include "gc_implementation/g1/g1MarkSweep.hpp"
+#include "gc_implementation/g1/g1ParMarkCompact.hpp"
+#include "gc_implementation/g1/g1RootProcessor.hpp"
+#include "gc_implementation/g1/g1StringDedup.hpp"
+#include "gc_implementation/g1/heapRegion.inline.hpp"
+#include "gc_implementation/shared/adaptiveSizePolicy.hpp"
+#include "gc_implementation/shared/gcTimer.hpp"
+#include "gc_implementation/shared/gcTrace.hpp"
+#include "gc_implementation/shared/gcTraceTime.hpp"
+#include "gc_implementation/shared/parallelCleaning.hpp"
+#include "memory/iterator.inline.hpp"
+#include "memory/referenceProcessor.hpp"
+#include "oops/objArrayOop.hpp"
+#include "oops/oop.inline.hpp"
+#include "prims/jvmtiExport.hpp"
+#include "runtime/biasedLocking.hpp"
+#include "runtime/thread.hpp"
+#include "utilities/copy.hpp"
+#include "utilities/stack.inline.hpp"
+#if INCLUDE_JFR
+#include "jfr/jfr.hpp"
+#endif // INCLUDE_JFR
+
+G1ParMarkCompactWorker** G1ParMarkCompact::_workers = NULL;
+G1PMCMarkQueueSet*       G1ParMarkCompact::_oop_queues = NULL;
+G1PMCObjArrayQueueSet*   G1ParMarkCompact::_objarray_queues = NULL;
+
+template <class T> inline void G1PMCMarkClosure::do_oop_nv(T* p) {
+  _worker->mark_and_push(p);
+}
+
+void G1PMCMarkClosure::do_oop(oop* p)       { do_oop_nv(p); }
+void G1PMCMarkClosure::do_oop(narrowOop* p) { do_oop_nv(p); }
+
+class G1PMCIsAliveClosure : public BoolObjectClosure {
+  CMBitMap* _bitmap;
+ public:
+  G1PMCIsAliveClosure(CMBitMap* bitmap) : _bitmap(bitmap) { }
+
+  bool do_object_b(oop obj) {
+    return _bitmap->isMarked((HeapWord*)obj);
+  }
+};
+
+class G1PMCDrainClosure : public VoidClosure {
+  G1ParMarkCompactWorker* _worker;
+ public:
+  G1PMCDrainClosure(G1ParMarkCompactWorker* worker) : _worker(worker) { }
+
+  void do_void() {
+    _worker->drain_marking_queues();
+  }
+};
+
+// Updates an oop location to the new address of the object it points to.
+// Objects that keep their address are not forwarded, their mark words are
+// not touched by the parallel full GC.
+class G1PMCAdjustClosure : public ExtendedOopClosure {
+ public:
+  template <class T> void do_oop_nv(T* p) {
+    T heap_oop = oopDesc::load_heap_oop(p);
+    if (!oopDesc::is_null(heap_oop)) {
+      oop obj = oopDesc::decode_heap_oop_not_null(heap_oop);
+      if (obj->is_forwarded()) {
+        oopDesc::encode_store_heap_oop_not_null(p, obj->forwardee());
+      }
+    }
+  }
+  virtual void do_oop(oop* p)       { do_oop_nv(p); }
+  virtual void do_oop(narrowOop* p) { do_oop_nv(p); }
+};
+
+G1ParMarkCompactWorker::G1ParMarkCompactWorker(uint worker_id, ReferenceProcessor* rp) :
+  _worker_id(worker_id),
+  _bitmap(NULL),
+  _mark_closure(this, rp),
+  _compaction_regions(new (ResourceObj::C_HEAP, mtGC) GrowableArray<HeapRegion*>(16, true, mtGC)) {
+  _oop_queue.initialize();
+  _objarray_queue.initialize();
+}
+
+void G1ParMarkCompactWorker::reset(CMBitMap* bitmap) {
+  assert(marking_queues_empty(), "should be empty");
+  assert(_preserved_oop_stack.is_empty() && _preserved_mark_stack.is_empty(),
+         "should be empty");
+  _bitmap = bitmap;
+  _compaction_regions->clear();
+}
+
+inline bool G1ParMarkCompactWorker::mark_object(oop obj) {
+  HeapWord* addr = (HeapWord*)obj;
+  if (_bitmap->isMarked(addr) || !_bitmap->parMark(addr)) {
+    // Already marked by this or another worker.
+    return false;
+  }
+  if (G1StringDedup::is_enabled()) {
+    G1StringDedup::enqueue_from_mark(obj, _worker_id);
+  }
+  return true;
+}
+
+template <class T> inline void G1ParMarkCompactWorker::mark_and_push(T* p) {
+  T heap_oop = oopDesc::load_heap_oop(p);
+  if (!oopDesc::is_null(heap_oop)) {
+    oop obj = oopDesc::decode_heap_oop_not_null(heap_oop);
+    if (mark_object(obj)) {
+      _oop_queue.push(obj);
+    }
+  }
+}
+
+void G1ParMarkCompactWorker::follow_object(oop obj) {
+  if (obj->is_objArray()) {
+    // Follow the class now and the elements in chunks, so that the
+    // elements of a large array can be shared among the workers.
+    _mark_closure.do_klass(obj->klass());
+    follow_array_chunk(objArrayOop(obj), 0);
+  } else if (!obj->is_typeArray()) {
+    obj->oop_iterate(&_mark_closure);
+  }
+}
+
+void G1ParMarkCompactWorker::follow_array_chunk(objArrayOop array, int index) {
+  const int len = array->length();
+  const int stride = MIN2(len - index, (int)ObjArrayMarkingStride);
+  const int end_index = index + stride;
+
+  // Push the continuation first so that other workers may steal it.
+  if (end_index < len) {
+    _objarray_queue.push(ObjArrayTask(array, end_index));
+  }
+  if (UseCompressedOops) {
+    follow_array_elements<narrowOop>(array, index, end_index);
+  } else {
+    follow_array_elements<oop>(array, index, end_index);
+  }
+}
+
+template <class T>
+void G1ParMarkCompactWorker::follow_array_elements(objArrayOop array, int begin, int end) {
+  T* const base = (T*)array->base();
+  T* const limit = base + end;
+  for (T* p = base + begin; p < limit; p++) {
+    mark_and_push(p);
+  }
+}
+
+void G1ParMarkCompactWorker::drain_marking_queues() {
+  do {
+    // Drain the overflow stack first, to allow stealing from the queue.
+    oop obj;
+    while (_oop_queue.pop_overflow(obj)) {
+      follow_object(obj);
+    }
+    while (_oop_queue.pop_local(obj)) {
+      follow_object(obj);
+    }
+
+    // Process ObjArrays one chunk at a time to avoid marking queue bloat.
+    ObjArrayTask task;
+    if (_objarray_queue.pop_overflow(task) || _objarray_queue.pop_local(task)) {
+      follow_array_task(task);
+    }
+  } while (!marking_queues_empty());
+}
+
+void G1ParMarkCompactWorker::preserve_mark(oop obj, markOop mark) {
+  _preserved_oop_stack.push(obj);
+  _preserved_mark_stack.push(mark);
+}
+
+void G1ParMarkCompactWorker::adjust_preserved_marks() {
+  // Only the marks of moved objects are preserved.
+  StackIterator<oop, mtGC> iter(_preserved_oop_stack);
+  while (!iter.is_empty()) {
+    oop* p = iter.next_addr();
+    assert((*p)->is_forwarded(), "must be");
+    *p = (*p)->forwardee();
+  }
+}
+
+void G1ParMarkCompactWorker::restore_preserved_marks() {
+  while (!_preserved_oop_stack.is_empty()) {
+    oop obj = _preserved_oop_stack.pop();
+    markOop mark = _preserved_mark_stack.pop();
+    obj->set_mark(mark);
+  }
+  assert(_preserved_mark_stack.is_empty(), "should be empty");
+}
+
+void G1ParMarkCompactWorker::forward_live_objects() {
+  if (_compaction_regions->is_empty()) {
+    return;
+  }
+
+  int target_index = 0;
+  HeapRegion* target = _compaction_regions->at(target_index);
+  HeapWord* compact_top = target->bottom();
+  HeapWord* threshold = target->initialize_threshold();
+
+  for (int i = 0; i < _compaction_regions->length(); i++) {
+    HeapRegion* hr = _compaction_regions->at(i);
+    HeapWord* const limit = hr->top();
+    HeapWord* cur = _bitmap->getNextMarkedWordAddress(hr->bottom(), limit);
+    while (cur < limit) {
+      oop obj = oop(cur);
+      size_t size = obj->size();
+
+      if (size > pointer_delta(target->end(), compact_top)) {
+        // Continue with the next region. The object always fits into
+        // its own region, so the target never passes the source region.
+        target->set_compaction_top(compact_top);
+        target = _compaction_regions->at(++target_index);
+        assert(target_index <= i, "must not compact into a later region");
+        compact_top = target->bottom();
+        threshold = target->initialize_threshold();
+      }
+
+      if (cur != compact_top) {
+        markOop mark = obj->mark();
+        if (mark->must_be_preserved(obj)) {
+          preserve_mark(obj, mark);
+        }
+        obj->forward_to(oop(compact_top));
+      }
+      compact_top += size;
+      if (compact_top > threshold) {
+        threshold = target->cross_threshold(compact_top - size, compact_top);
+      }
+
+      cur = _bitmap->getNextMarkedWordAddress(cur + size, limit);
+    }
+  }
+  target->set_compaction_top(compact_top);
+}
+
+void G1ParMarkCompactWorker::compact_regions() {
+  for (int i = 0; i < _compaction_regions->length(); i++) {
+    HeapRegion* hr = _compaction_regions->at(i);
+    HeapWord* const limit = hr->top();
+    HeapWord* cur = _bitmap->getNextMarkedWordAddress(hr->bottom(), limit);
+    while (cur < limit) {
+      oop obj = oop(cur);
+      size_t size = obj->size();
+      if (obj->is_forwarded()) {
+        HeapWord* destination = (HeapWord*)obj->forwardee();
+        Copy::aligned_conjoint_words(cur, destination, size);
+        oop(destination)->init_mark();
+      }
+      cur = _bitmap->getNextMarkedWordAddress(cur + size, limit);
+    }
+  }
+
+  for (int i = 0; i < _compaction_regions->length(); i++) {
+    HeapRegion* hr = _compaction_regions->at(i);
+    // Regions are never shared between workers, so the bitmap of the
+    // region can be cleared without synchronization.
+    _bitmap->clearRange(MemRegion(hr->bottom(), hr->end()));
+
+    bool was_empty = hr->used_region().is_empty();
+    hr->reset_after_compaction();
+    if (hr->used_region().is_empty()) {
+      if (!was_empty) {
+        hr->clear(SpaceDecorator::Mangle);
+      }
+    } else if (ZapUnusedHeapArea) {
+      hr->mangle_unused_area();
+    }
+  }
+}
+
+class G1PMCMarkTask : public AbstractGangTask {
+  G1RootProcessor*       _root_processor;
+  ParallelTaskTerminator _terminator;
+
+ public:
+  G1PMCMarkTask(G1RootProcessor* root_processor) :
+    AbstractGangTask("G1 Parallel Full GC Mark"),
+    _root_processor(root_processor),
+    _terminator(0, G1ParMarkCompact::oop_queues()) { }
+
+  virtual void set_for_termination(int active_workers) {
+    _root_processor->set_num_workers(active_workers);
+    _terminator.reset_for_reuse(active_workers);
+  }
+
+  void work(uint worker_id) {
+    G1GCParPhaseTimesTracker x(G1CollectedHeap::heap()->g1_policy()->phase_times(),
+                               G1GCPhaseTimes::FullGCMark, worker_id);
+    G1ParMarkCompactWorker* worker = G1ParMarkCompact::worker(worker_id);
+    G1PMCMarkClosure* mark_closure = worker->mark_closure();
+
+    CLDToOopClosure cld_closure(mark_closure);
+    MarkingCodeBlobClosure code_closure(mark_closure, !CodeBlobToOopClosure::FixRelocations);
+    if (ClassUnloading) {
+      _root_processor->process_strong_roots(mark_closure, &cld_closure, &code_closure);
+    } else {
+      _root_processor->process_all_roots_no_string_table(mark_closure, &cld_closure, &code_closure);
+    }
+    worker->drain_marking_queues();
+
+    int seed = 17;
+    do {
+      ObjArrayTask task;
+      while (G1ParMarkCompact::objarray_queues()->steal(worker_id, &seed, task)) {
+        worker->follow_array_task(task);
+        worker->drain_marking_queues();
+      }
+      oop obj;
+      while (G1ParMarkCompact::oop_queues()->steal(worker_id, &seed, obj)) {
+        worker->follow_object(obj);
+        worker->drain_marking_queues();
+      }
+    } while (!_terminator.offer_termination());
+  }
+};
+
+class G1PMCPrepareClosure : public HeapRegionClosure {
+  G1CollectedHeap*            _g1h;
+  CMBitMap*                   _bitmap;
+  GrowableArray<HeapRegion*>* _regions;
+  FreeRegionList              _free_list;
+  HeapRegionSetCount          _humongous_regions_removed;
+
+  void add_region(HeapRegion* hr) {
+    hr->set_compaction_top(hr->bottom());
+    _regions->append(hr);
+  }
+
+  void free_humongous_region(HeapRegion* hr) {
+    hr->set_containing_set(NULL);
+    _humongous_regions_removed.increment(1u, hr->capacity());
+    _g1h->free_humongous_region(hr, &_free_list, true /* par */);
+  }
+
+ public:
+  G1PMCPrepareClosure(CMBitMap* bitmap, GrowableArray<HeapRegion*>* regions) :
+    _g1h(G1CollectedHeap::heap()),
+    _bitmap(bitmap),
+    _regions(regions),
+    _free_list("Local Free List for G1ParMarkCompact"),
+    _humongous_regions_removed() { }
+
+  ~G1PMCPrepareClosure() {
+    _free_list.remove_all();
+  }
+
+  const HeapRegionSetCount& humongous_regions_removed() const {
+    return _humongous_regions_removed;
+  }
+
+  bool doHeapRegion(HeapRegion* hr) {
+    if (hr->isHumongous()) {
+      // The "continues humongous" regions of a dead humongous object are
+      // visited before its "starts humongous" region and are left empty.
+      if (hr->startsHumongous() && !_bitmap->isMarked(hr->bottom())) {
+        free_humongous_region(hr);
+        add_region(hr);
+      }
+    } else {
+      add_region(hr);
+    }
+    return false;
+  }
+};
+
+class G1PMCPrepareTask : public AbstractGangTask {
+  CMBitMap*          _bitmap;
+  uint               _n_workers;
+  HeapRegionSetCount _humongous_regions_removed;
+  Mutex              _lock;
+
+ public:
+  G1PMCPrepareTask(CMBitMap* bitmap) :
+    AbstractGangTask("G1 Parallel Full GC Prepare"),
+    _bitmap(bitmap),
+    _n_workers(0),
+    _humongous_regions_removed(),
+    _lock(Mutex::leaf, "G1 Parallel Full GC prepare lock", true) { }
+
+  virtual void set_for_termination(int active_workers) {
+    _n_workers = active_workers;
+  }
+
+  const HeapRegionSetCount& humongous_regions_removed() const {
+    return _humongous_regions_removed;
+  }
+
+  void work(uint worker_id) {
+    G1GCParPhaseTimesTracker x(G1CollectedHeap::heap()->g1_policy()->phase_times(),
+                               G1GCPhaseTimes::FullGCPrepare, worker_id);
+    G1ParMarkCompactWorker* worker = G1ParMarkCompact::worker(worker_id);
+
+    G1PMCPrepareClosure cl(_bitmap, worker->compaction_regions());
+    G1CollectedHeap::heap()->heap_region_par_iterate_chunked(&cl, worker_id, _n_workers,
+                                                             HeapRegion::ParPrepareCompactClaimValue);
+    {
+      MutexLockerEx ml(&_lock, Mutex::_no_safepoint_check_flag);
+      _humongous_regions_removed.increment(cl.humongous_regions_removed().length(),
+                                           cl.humongous_regions_removed().capacity());
+    }
+
+    worker->forward_live_objects();
+  }
+};
+
+class G1PMCAdjustRegionClosure : public HeapRegionClosure {
+  CMBitMap*           _bitmap;
+  G1PMCAdjustClosure* _adjust;
+
+ public:
+  G1PMCAdjustRegionClosure(CMBitMap* bitmap, G1PMCAdjustClosure* adjust) :
+    _bitmap(bitmap), _adjust(adjust) { }
+
+  bool doHeapRegion(HeapRegion* hr) {
+    if (hr->isHumongous()) {
+      if (hr->startsHumongous() && _bitmap->isMarked(hr->bottom())) {
+        oop(hr->bottom())->oop_iterate(_adjust);
+        // Humongous objects do not move, this is the last use of the
+        // bitmap for the region.
+        _bitmap->clear(hr->bottom());
+        hr->reset_during_compaction();
+      }
+    } else {
+      HeapWord* const limit = hr->top();
+      HeapWord* cur = _bitmap->getNextMarkedWordAddress(hr->bottom(), limit);
+      while (cur < limit) {
+        size_t size = oop(cur)->oop_iterate(_adjust);
+        cur = _bitmap->getNextMarkedWordAddress(cur + size, limit);
+      }
+    }
+    return false;
+  }
+};
+
+class G1PMCAdjustTask : public AbstractGangTask {
+  G1RootProcessor* _root_processor;
+  CMBitMap*        _bitmap;
+  uint             _n_workers;
+
+ public:
+  G1PMCAdjustTask(G1RootProcessor* root_processor, CMBitMap* bitmap) :
+    AbstractGangTask("G1 Parallel Full GC Adjust"),
+    _root_processor(root_processor),
+    _bitmap(bitmap),
+    _n_workers(0) { }
+
+  virtual void set_for_termination(int active_workers) {
+    _root_processor->set_num_workers(active_workers);
+    _n_workers = active_workers;
+  }
+
+  void work(uint worker_id) {
+    G1GCParPhaseTimesTracker x(G1CollectedHeap::heap()->g1_policy()->phase_times(),
+                               G1GCPhaseTimes::FullGCAdjust, worker_id);
+    G1PMCAdjustClosure adjust;
+    CLDToOopClosure adjust_cld_closure(&adjust);
+    CodeBlobToOopClosure adjust_code_closure(&adjust, CodeBlobToOopClosure::FixRelocations);
+    _root_processor->process_all_roots(&adjust, &adjust_cld_closure, &adjust_code_closure);
+
+    G1PMCAdjustRegionClosure cl(_bitmap, &adjust);
+    G1CollectedHeap::heap()->heap_region_par_iterate_chunked(&cl, worker_id, _n_workers,
+                                                             HeapRegion::ParAdjustPointersClaimValue);
+
+    G1ParMarkCompact::worker(worker_id)->adjust_preserved_marks();
+  }
+};
+
+class G1PMCCompactTask : public AbstractGangTask {
+ public:
+  G1PMCCompactTask() : AbstractGangTask("G1 Parallel Full GC Compact") { }
+
+  void work(uint worker_id) {
+    G1GCParPhaseTimesTracker x(G1CollectedHeap::heap()->g1_policy()->phase_times(),
+                               G1GCPhaseTimes::FullGCCompact, worker_id);
+    G1ParMarkCompactWorker* worker = G1ParMarkCompact::worker(worker_id);
+    worker->compact_regions();
+    // The objects of a worker are only moved within its own regions, so
+    // the worker can restore their marks without waiting for the others.
+    worker->restore_preserved_marks();
+  }
+};
+
+bool G1ParMarkCompact::should_use() {
+  // The tenant heap isolation keeps the objects of each tenant in its own
+  // regions during compaction, which only the serial collector supports.
+  return G1ParallelFullGC &&
+         G1CollectedHeap::use_parallel_gc_threads() &&
+         !TenantHeapIsolation;
+}
+
+void G1ParMarkCompact::initialize_workers(ReferenceProcessor* rp) {
+  uint n_workers = (uint)ParallelGCThreads;
+  _oop_queues = new G1PMCMarkQueueSet(n_workers);
+  _objarray_queues = new G1PMCObjArrayQueueSet(n_workers);
+  _workers = NEW_C_HEAP_ARRAY(G1ParMarkCompactWorker*, n_workers, mtGC);
+  for (uint i = 0; i < n_workers; i++) {
+    _workers[i] = new G1ParMarkCompactWorker(i, rp);
+    _oop_queues->register_queue(i, _workers[i]->oop_queue());
+    _objarray_queues->register_queue(i, _workers[i]->objarray_queue());
+  }
+}
+
+void G1ParMarkCompact::invoke_at_safepoint(ReferenceProcessor* rp,
+                                           bool clear_all_softrefs) {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at a safepoint");
+  assert(should_use(), "Precondition");
+  assert(rp == G1CollectedHeap::heap()->ref_processor_stw(), "Precondition");
+  assert(rp->discovery_is_mt(), "Workers discover references in parallel");
+
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+  CMBitMap* bitmap = g1h->concurrent_mark()->nextMarkBitMap();
+
+  if (_workers == NULL) {
+    // The queues take a few MB per worker, only set them up once the
+    // first parallel full GC is needed.
+    initialize_workers(rp);
+  }
+
+  uint n_workers =
+    AdaptiveSizePolicy::calc_active_workers(g1h->workers()->total_workers(),
+                                            g1h->workers()->active_workers(),
+                                            Threads::number_of_non_daemon_threads());
+  g1h->workers()->set_active_workers(n_workers);
+  for (uint i = 0; i < ParallelGCThreads; i++) {
+    _workers[i]->reset(bitmap);
+  }
+
+  G1GCPhaseTimes* phase_times = g1h->g1_policy()->phase_times();
+  phase_times->note_full_gc_start(n_workers);
+  double start = os::elapsedTime();
+
+  rp->setup_policy(clear_all_softrefs);
+
+  // When collecting the permanent generation Method*s may be moving,
+  // so we either have to flush all bcp data or convert it into bci.
+  CodeCache::gc_prologue();
+  Threads::gc_prologue();
+
+  // We should save the marks of the currently locked biased monitors.
+  // The marking doesn't preserve the marks of biased objects.
+  BiasedLocking::preserve_marks();
+
+  mark_phase(n_workers, clear_all_softrefs);
+
+  prepare_phase(n_workers);
+
+  // Don't add any more derived pointers during phase3
+  COMPILER2_PRESENT(DerivedPointerTable::set_active(false));
+
+  adjust_phase(n_workers);
+
+  compact_phase(n_workers);
+
+  g1h->reset_heap_region_claim_values();
+
+  BiasedLocking::restore_marks();
+
+  Threads::gc_epilogue();
+  CodeCache::gc_epilogue();
+  JvmtiExport::gc_epilogue();
+
+  phase_times->record_full_gc_par_time_ms((os::elapsedTime() - start) * 1000.0);
+  phase_times->note_full_gc_end();
+}
+
+void G1ParMarkCompact::mark_phase(uint n_workers, bool clear_all_softrefs) {
+  GCTraceTime tm("phase 1", G1Log::fine() && Verbose, true, G1MarkSweep::gc_timer(), G1MarkSweep::gc_tracer()->gc_id());
+
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+  CMBitMap* bitmap = g1h->concurrent_mark()->nextMarkBitMap();
+
+  // Need cleared claim bits for the roots processing
+  ClassLoaderDataGraph::clear_claimed_marks();
+
+  {
+    G1RootProcessor root_processor(g1h);
+    G1PMCMarkTask task(&root_processor);
+    g1h->set_par_threads(n_workers);
+    g1h->workers()->run_task(&task);
+    g1h->set_par_threads(0);
+  }
+
+  // Process reference objects found during marking. The keep alive
+  // closure marks into the queues of the first worker.
+  ReferenceProcessor* rp = g1h->ref_processor_stw();
+  G1ParMarkCompactWorker* worker = _workers[0];
+  G1PMCIsAliveClosure is_alive(bitmap);
+  G1PMCDrainClosure drain(worker);
+
+  rp->setup_policy(clear_all_softrefs);
+  const ReferenceProcessorStats& stats =
+    rp->process_discovered_references(&is_alive,
+                                      worker->mark_closure(),
+                                      &drain,
+                                      NULL,
+                                      G1MarkSweep::gc_timer(),
+                                      G1MarkSweep::gc_tracer()->gc_id());
+  G1MarkSweep::gc_tracer()->report_gc_reference_stats(stats);
+
+  // This is the point where the entire marking should have completed.
+#ifdef ASSERT
+  for (uint i = 0; i < n_workers; i++) {
+    assert(_workers[i]->marking_queues_empty(), "Marking should have completed");
+  }
+#endif
+
+  if (ClassUnloading) {
+    // Unload classes, nmethods and prune dead klasses from
+    // subklass/sibling/implementor lists.
+    ParallelCleaning::unload_classes(&is_alive, g1h->workers());
+  }
+  // Delete entries for dead interned string and clean up unreferenced symbols in symbol table.
+  g1h->unlink_string_and_symbol_table(&is_alive);
+
+  // The mark words are not changed by the marking, VerifyDuringGC can
+  // not verify against them as with the serial full GC. A warning is
+  // given at startup, see Arguments::set_g1_gc_flags.
+
+  G1MarkSweep::gc_tracer()->report_object_count_after_gc(&is_alive);
+}
+
+void G1ParMarkCompact::prepare_phase(uint n_workers) {
+  // Now all live objects are marked, compute the new object addresses.
+  GCTraceTime tm("phase 2", G1Log::fine() && Verbose, true, G1MarkSweep::gc_timer(), G1MarkSweep::gc_tracer()->gc_id());
+
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+  assert(g1h->check_heap_region_claim_values(HeapRegion::InitialClaimValue), "sanity check");
+
+  G1PMCPrepareTask task(g1h->concurrent_mark()->nextMarkBitMap());
+  g1h->set_par_threads(n_workers);
+  g1h->workers()->run_task(&task);
+  g1h->set_par_threads(0);
+
+  // We'll recalculate total used bytes and recreate the free list
+  // at the end of the GC, so no point in updating those values here.
+  HeapRegionSetCount empty_set;
+  g1h->remove_from_old_sets(empty_set, task.humongous_regions_removed());
+}
+
+void G1ParMarkCompact::adjust_phase(uint n_workers) {
+  // Adjust the pointers to reflect the new locations
+  GCTraceTime tm("phase 3", G1Log::fine() && Verbose, true, G1MarkSweep::gc_timer(), G1MarkSweep::gc_tracer()->gc_id());
+
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+
+  // Need cleared claim bits for the roots processing
+  ClassLoaderDataGraph::clear_claimed_marks();
+
+  {
+    G1RootProcessor root_processor(g1h);
+    G1PMCAdjustTask task(&root_processor, g1h->concurrent_mark()->nextMarkBitMap());
+    g1h->set_par_threads(n_workers);
+    g1h->workers()->run_task(&task);
+    g1h->set_par_threads(0);
+  }
+
+  // Now adjust pointers in remaining weak roots.  (All of which should
+  // have been cleared if they pointed to non-surviving objects.)
+  G1PMCAdjustClosure adjust;
+  g1h->ref_processor_stw()->weak_oops_do(&adjust);
+  JNIHandles::weak_oops_do(&adjust);
+  JFR_ONLY(Jfr::weak_oops_do(&adjust));
+
+  if (G1StringDedup::is_enabled()) {
+    G1StringDedup::oops_do(&adjust);
+  }
+}
+
+void G1ParMarkCompact::compact_phase(uint n_workers) {
+  // All pointers are now adjusted, move objects accordingly
+  GCTraceTime tm("phase 4", G1Log::fine() && Verbose, true, G1MarkSweep::gc_timer(), G1MarkSweep::gc_tracer()->gc_id());
+
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+
+  G1PMCCompactTask task;
+  g1h->set_par_threads(n_workers);
+  g1h->workers()->run_task(&task);
+  g1h->set_par_threads(0);
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef SHARE_VM_GC_IMPLEMENTATION_G1_G1PARMARKCOMPACT_HPP
+#define SHARE_VM_GC_IMPLEMENTATION_G1_G1PARMARKCOMPACT_HPP
+
+#include "memory/allocation.hpp"
+#include "memory/iterator.hpp"
+#include "oops/markOop.hpp"
+#include "utilities/growableArray.hpp"
+#include "utilities/stack.hpp"
+#include "utilities/taskqueue.hpp"
+
+class CMBitMap;
+class G1CollectedHeap;
+class HeapRegion;
+class ReferenceProcessor;
+class STWGCTimer;
+class SerialOldTracer;
+
+typedef OverflowTaskQueue<oop, mtGC>                       G1PMCMarkQueue;
+typedef GenericTaskQueueSet<G1PMCMarkQueue, mtGC>          G1PMCMarkQueueSet;
+typedef OverflowTaskQueue<ObjArrayTask, mtGC>              G1PMCObjArrayQueue;
+typedef GenericTaskQueueSet<G1PMCObjArrayQueue, mtGC>      G1PMCObjArrayQueueSet;
+
+class G1ParMarkCompactWorker;
+
+// Marks the objects reachable from an oop location in the mark bitmap
+// and pushes newly marked objects on the marking queue of the worker.
+// Also used as the keep alive closure during reference processing.
+class G1PMCMarkClosure : public MetadataAwareOopClosure {
+  G1ParMarkCompactWorker* _worker;
+ public:
+  G1PMCMarkClosure(G1ParMarkCompactWorker* worker, ReferenceProcessor* rp) :
+    MetadataAwareOopClosure(rp), _worker(worker) { }
+
+  template <class T> void do_oop_nv(T* p);
+  virtual void do_oop(oop* p);
+  virtual void do_oop(narrowOop* p);
+};
+
+// Per-worker state of the parallel full GC: the marking queues, the
+// regions the worker compacts, and the mark words it has to restore.
+class G1ParMarkCompactWorker : public CHeapObj<mtGC> {
+  friend class G1PMCMarkClosure;
+
+  uint                      _worker_id;
+  CMBitMap*                 _bitmap;
+  G1PMCMarkQueue            _oop_queue;
+  G1PMCObjArrayQueue        _objarray_queue;
+  G1PMCMarkClosure          _mark_closure;
+
+  // The regions claimed by this worker during the prepare phase, in
+  // claim order. Live objects of a region are only ever moved into the
+  // same region or a region earlier in this list, so that the workers
+  // can compact their lists independently of each other.
+  GrowableArray<HeapRegion*>* _compaction_regions;
+
+  // Marks of the moved objects that cannot be re-created from the
+  // prototype mark of their class.
+  Stack<oop, mtGC>          _preserved_oop_stack;
+  Stack<markOop, mtGC>      _preserved_mark_stack;
+
+  inline bool mark_object(oop obj);
+  template <class T> inline void mark_and_push(T* p);
+
+  void follow_array_chunk(objArrayOop array, int index);
+  template <class T> void follow_array_elements(objArrayOop array, int begin, int end);
+
+ public:
+  G1ParMarkCompactWorker(uint worker_id, ReferenceProcessor* rp);
+
+  // Prepare for a full GC marking into the given bitmap.
+  void reset(CMBitMap* bitmap);
+
+  uint worker_id() const                      { return _worker_id; }
+  G1PMCMarkQueue* oop_queue()                 { return &_oop_queue; }
+  G1PMCObjArrayQueue* objarray_queue()        { return &_objarray_queue; }
+  G1PMCMarkClosure* mark_closure()            { return &_mark_closure; }
+  GrowableArray<HeapRegion*>* compaction_regions() { return _compaction_regions; }
+
+  // Marking
+  void follow_object(oop obj);
+  void follow_array_task(const ObjArrayTask& task) {
+    follow_array_chunk(objArrayOop(task.obj()), task.index());
+  }
+  void drain_marking_queues();
+  bool marking_queues_empty() const {
+    return _oop_queue.is_empty() && _objarray_queue.is_empty();
+  }
+
+  // Compaction
+  void forward_live_objects();
+  void compact_regions();
+  void preserve_mark(oop obj, markOop mark);
+  void adjust_preserved_marks();
+  void restore_preserved_marks();
+};
+
+// G1ParMarkCompact is a parallel version of G1MarkSweep. The same four
+// phases are executed by the G1 work gang instead of the VM thread:
+//
+// 1. Live objects are marked in the next mark bitmap of the concurrent
+//    marker, which is cleared when the full GC aborts concurrent marking.
+//    The workers balance the marking with work stealing. Unlike the
+//    serial collector, marking does not touch the mark words, so no
+//    marks need to be preserved for objects that do not move.
+// 2. The workers claim the heap regions and compute the new locations of
+//    the live objects, sliding them towards the start of the regions the
+//    worker claimed. Dead humongous objects are freed.
+// 3. Roots and live objects are updated to point to the new locations.
+// 4. Each worker moves the objects of its own regions.
+//
+// Reference processing runs in the VM thread, as in the serial collector.
+class G1ParMarkCompact : AllStatic {
+  static G1ParMarkCompactWorker** _workers;
+  static G1PMCMarkQueueSet*       _oop_queues;
+  static G1PMCObjArrayQueueSet*   _objarray_queues;
+
+  static void initialize_workers(ReferenceProcessor* rp);
+
+  static void mark_phase(uint n_workers, bool clear_all_softrefs);
+  static void prepare_phase(uint n_workers);
+  static void adjust_phase(uint n_workers);
+  static void compact_phase(uint n_workers);
+
+ public:
+  // Whether the full GC should use the parallel collector.
+  static bool should_use();
+
+  static void invoke_at_safepoint(ReferenceProcessor* rp,
+                                  bool clear_all_softrefs);
+
+  static G1ParMarkCompactWorker* worker(uint worker_id) {
+    return _workers[worker_id];
+  }
+  static G1PMCMarkQueueSet* oop_queues()           { return _oop_queues; }
+  static G1PMCObjArrayQueueSet* objarray_queues()  { return _objarray_queues; }
+};
+
+#endif // SHARE_VM_GC_IMPLEMENTATION_G1_G1PARMARKCOMPACT_HPP
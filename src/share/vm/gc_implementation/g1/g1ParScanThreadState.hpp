@@ -123,6 +123,10 @@ class G1ParScanThreadState : public StackObj {
    }
   }
 
+  // Remember a location that refers to an optional collection set region,
+  // so that the referenced object is evacuated if the region is.
+  template <class T> inline void record_optional_ref(T* p);
+
   void set_evac_failure_closure(OopsInHeapRegionClosure* evac_failure_cl) {
     _evac_failure_cl = evac_failure_cl;
   }
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "precompiled.hpp"
+#include "classfile/javaClasses.hpp"
+#include "classfile/systemDictionary.hpp"
+#include "gc_implementation/g1/concurrentMarkThread.inline.hpp"
+#include "gc_implementation/g1/g1CollectedHeap.inline.hpp"
+#include "gc_implementation/g1/g1CollectorPolicy.hpp"
+#include "gc_implementation/g1/g1ErgoVerbose.hpp"
+#include "gc_implementation/g1/g1PeriodicGC.hpp"
+#include "runtime/javaCalls.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/os.hpp"
+#include "runtime/thread.inline.hpp"
+
+volatile bool G1PeriodicGC::_should_terminate = false;
+JavaThread*   G1PeriodicGC::_thread = NULL;
+Monitor*      G1PeriodicGC::_monitor = NULL;
+
+bool G1PeriodicGC::has_error(TRAPS, const char* error) {
+  if (HAS_PENDING_EXCEPTION) {
+    tty->print_cr("%s", error);
+    java_lang_Throwable::print(PENDING_EXCEPTION, tty);
+    tty->cr();
+    CLEAR_PENDING_EXCEPTION;
+    return true;
+  } else {
+    return false;
+  }
+}
+
+void G1PeriodicGC::start() {
+  assert(UseG1GC && G1PeriodicGCInterval != 0, "only used for G1 periodic GCs");
+  _monitor = new Monitor(Mutex::nonleaf, "G1PeriodicGC::_monitor", Mutex::_allow_vm_block_flag);
+
+  EXCEPTION_MARK;
+  Klass* k = SystemDictionary::resolve_or_fail(vmSymbols::java_lang_Thread(), true, CHECK);
+  instanceKlassHandle klass (THREAD, k);
+  instanceHandle thread_oop = klass->allocate_instance_handle(CHECK);
+
+  const char thread_name[] = "G1 Periodic GC";
+  Handle string = java_lang_String::create_from_str(thread_name, CHECK);
+
+  // Initialize thread_oop to put it into the system threadGroup
+  Handle thread_group (THREAD, Universe::system_thread_group());
+  JavaValue result(T_VOID);
+  JavaCalls::call_special(&result, thread_oop,
+                       klass,
+                       vmSymbols::object_initializer_name(),
+                       vmSymbols::threadgroup_string_void_signature(),
+                       thread_group,
+                       string,
+                       THREAD);
+  if (has_error(THREAD, "Exception in VM (G1PeriodicGC::start) : ")) {
+    vm_exit_during_initialization("Cannot create G1 periodic GC thread.");
+    return;
+  }
+
+  KlassHandle group(THREAD, SystemDictionary::ThreadGroup_klass());
+  JavaCalls::call_special(&result,
+                        thread_group,
+                        group,
+                        vmSymbols::add_method_name(),
+                        vmSymbols::thread_void_signature(),
+                        thread_oop,             // ARG 1
+                        THREAD);
+  if (has_error(THREAD, "Exception in VM (G1PeriodicGC::start) : ")) {
+    vm_exit_during_initialization("Cannot create G1 periodic GC thread.");
+    return;
+  }
+
+  {
+    MutexLocker mu(Threads_lock);
+    _thread = new JavaThread(&G1PeriodicGC::thread_entry);
+    if (_thread == NULL || _thread->osthread() == NULL) {
+      vm_exit_during_initialization("Cannot create G1 periodic GC thread. Out of system resources.");
+    }
+
+    java_lang_Thread::set_thread(thread_oop(), _thread);
+    java_lang_Thread::set_daemon(thread_oop());
+    _thread->set_threadObj(thread_oop());
+    Threads::add(_thread);
+    Thread::start(_thread);
+  }
+}
+
+bool G1PeriodicGC::should_start_periodic_gc() {
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+  // A running cycle will resize the heap at its remark pause anyway.
+  if (g1h->concurrent_mark()->cmThread()->during_cycle()) {
+    return false;
+  }
+
+  double time_since_last_pause_ms = g1h->g1_policy()->time_since_last_pause_ms();
+  if (time_since_last_pause_ms < (double) G1PeriodicGCInterval) {
+    return false;
+  }
+
+  // Do not disturb a machine that is busy with other work; the memory
+  // is given back once the load goes down.
+  if (G1PeriodicGCSystemLoadThreshold > 0.0) {
+    double recent_load;
+    if (os::loadavg(&recent_load, 1) != -1 &&
+        recent_load > G1PeriodicGCSystemLoadThreshold) {
+      ergo_verbose2(ErgoConcCycles,
+                    "do not request periodic collection",
+                    ergo_format_reason("system load above threshold")
+                    ergo_format_double("recent load")
+                    ergo_format_double("threshold"),
+                    recent_load, G1PeriodicGCSystemLoadThreshold);
+      return false;
+    }
+  }
+
+  ergo_verbose2(ErgoConcCycles,
+                "request periodic collection",
+                ergo_format_reason("no GC pause within interval")
+                ergo_format_ms("time since last pause")
+                ergo_format_ms("interval"),
+                time_since_last_pause_ms, (double) G1PeriodicGCInterval);
+  return true;
+}
+
+jlong G1PeriodicGC::wait_time_ms() {
+  double remaining_ms = (double) G1PeriodicGCInterval -
+                        G1CollectedHeap::heap()->g1_policy()->time_since_last_pause_ms();
+  if (remaining_ms < 1.0) {
+    // We have just declined to start a periodic collection; check
+    // again after a full interval.
+    return (jlong) G1PeriodicGCInterval;
+  }
+  return (jlong) remaining_ms;
+}
+
+void G1PeriodicGC::thread_entry(JavaThread* thread, TRAPS) {
+  while (!_should_terminate) {
+    assert(!SafepointSynchronize::is_at_safepoint(), "G1 periodic GC thread is a JavaThread");
+    if (should_start_periodic_gc()) {
+      Universe::heap()->collect(GCCause::_g1_periodic_collection);
+    }
+
+    MutexLockerEx x(_monitor);
+    if (_should_terminate) {
+      break;
+    }
+    _monitor->wait(false /* no_safepoint_check */, wait_time_ms());
+  }
+}
+
+void G1PeriodicGC::stop() {
+  _should_terminate = true;
+  if (_monitor != NULL) {
+    MutexLockerEx ml(_monitor, Mutex::_no_safepoint_check_flag);
+    _monitor->notify();
+  }
+}
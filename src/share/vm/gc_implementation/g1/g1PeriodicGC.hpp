@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef SHARE_VM_GC_IMPLEMENTATION_G1_G1PERIODICGC_HPP
+#define SHARE_VM_GC_IMPLEMENTATION_G1_G1PERIODICGC_HPP
+
+#include "memory/allocation.hpp"
+#include "runtime/mutex.hpp"
+#include "utilities/exceptions.hpp"
+
+class JavaThread;
+
+// Periodic GCs give memory back to the operating system when the
+// application is idle. If no GC pause happened for G1PeriodicGCInterval
+// milliseconds and the one-minute system load average is below
+// G1PeriodicGCSystemLoadThreshold, a concurrent cycle is started. Its
+// remark pause uncommits free regions according to MinHeapFreeRatio and
+// MaxHeapFreeRatio (see G1CollectedHeap::resize_heap_after_remark()).
+//
+// Like the elastic heap timer this has to be a Java thread, because GC
+// VM operations cannot be requested from other threads in JDK 1.8.
+class G1PeriodicGC : AllStatic {
+private:
+  volatile static bool _should_terminate;
+  static JavaThread*   _thread;
+  static Monitor*      _monitor;
+
+  static bool          has_error(TRAPS, const char* error);
+
+  // Whether a periodic collection is due right now.
+  static bool          should_start_periodic_gc();
+  // Milliseconds until the next check for a periodic collection.
+  static jlong         wait_time_ms();
+
+public:
+  static void          thread_entry(JavaThread* thread, TRAPS);
+  static void          start();
+  static void          stop();
+};
+
+#endif // SHARE_VM_GC_IMPLEMENTATION_G1_G1PERIODICGC_HPP
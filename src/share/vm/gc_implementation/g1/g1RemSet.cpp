@@ -103,7 +103,7 @@ void CountNonCleanMemRegionClosure::do_MemRegion(MemRegion mr) {
 }
 
 class ScanRSClosure : public HeapRegionClosure {
-  size_t _cards_done, _cards;
+  size_t _cards_done, _cards, _cards_skipped;
   G1CollectedHeap* _g1h;
 
   G1ParPushHeapRSClosure* _oc;
@@ -114,8 +114,7 @@ class ScanRSClosure : public HeapRegionClosure {
 
   double _strong_code_root_scan_time_sec;
   uint   _worker_i;
-  int    _block_size;
-  bool   _try_claimed;
+  size_t _block_size;
 
 public:
   ScanRSClosure(G1ParPushHeapRSClosure* oc,
@@ -126,17 +125,15 @@ public:
     _strong_code_root_scan_time_sec(0.0),
     _cards(0),
     _cards_done(0),
-    _worker_i(worker_i),
-    _try_claimed(false)
+    _cards_skipped(0),
+    _worker_i(worker_i)
   {
     _g1h = G1CollectedHeap::heap();
     _bot_shared = _g1h->bot_shared();
     _ct_bs = _g1h->g1_barrier_set();
-    _block_size = MAX2<int>(G1RSetScanBlockSize, 1);
+    _block_size = MAX2<size_t>(G1RSetScanBlockSize, 1);
   }
 
-  void set_try_claimed() { _try_claimed = true; }
-
   void scanCard(size_t index, HeapRegion *r) {
     // Stack allocate the DirtyCardToOopClosure instance
     HeapRegionDCTOC cl(_g1h, r, _oc,
@@ -178,27 +175,35 @@ public:
     assert(r->in_collection_set(), "should only be called on elements of CS.");
     HeapRegionRemSet* hrrs = r->rem_set();
     if (hrrs->iter_is_complete()) return false; // All done.
-    if (!_try_claimed && !hrrs->claim_iter()) return false;
-    // If we ever free the collection set concurrently, we should also
-    // clear the card table concurrently therefore we won't need to
-    // add regions of the collection set to the dirty cards region.
-    _g1h->push_dirty_cards_region(r);
-    // If we didn't return above, then
-    //   _try_claimed || r->claim_iter()
-    // is true: either we're supposed to work on claimed-but-not-complete
-    // regions, or we successfully claimed the region.
+
+    // Every worker joins the scan of every region it visits instead of
+    // only working on the regions it claimed first; the cards of a region
+    // are handed out in blocks of G1RSetScanBlockSize, so a region with a
+    // large (e.g. coarsened) remembered set is spread over all workers
+    // that come across it. The worker that claims the region is the one
+    // responsible for the per-region work below.
+    bool claimed = hrrs->claim_iter();
+    if (claimed) {
+      // If we ever free the collection set concurrently, we should also
+      // clear the card table concurrently therefore we won't need to
+      // add regions of the collection set to the dirty cards region.
+      _g1h->push_dirty_cards_region(r);
+    }
 
     HeapRegionRemSetIterator iter(hrrs);
     size_t card_index;
 
     // We claim cards in block so as to recude the contention. The block size is determined by
     // the G1RSetScanBlockSize parameter.
-    size_t jump_to_card = hrrs->iter_claimed_next(_block_size);
+    size_t claimed_card_block = hrrs->iter_claimed_next(_block_size);
     for (size_t current_card = 0; iter.has_next(card_index); current_card++) {
-      if (current_card >= jump_to_card + _block_size) {
-        jump_to_card = hrrs->iter_claimed_next(_block_size);
+      if (current_card >= claimed_card_block + _block_size) {
+        claimed_card_block = hrrs->iter_claimed_next(_block_size);
+      }
+      if (current_card < claimed_card_block) {
+        _cards_skipped++;
+        continue;
       }
-      if (current_card < jump_to_card) continue;
       HeapWord* card_start = _g1h->bot_shared()->address_for_index(card_index);
 #if 0
       gclog_or_tty->print("Rem set iteration yielded card [" PTR_FORMAT ", " PTR_FORMAT ").\n",
@@ -218,11 +223,13 @@ public:
         scanCard(card_index, card_region);
       }
     }
-    if (!_try_claimed) {
+    // Having walked to the end of the remembered set, all of its cards
+    // have been handed out to some worker. Let workers that visit this
+    // region later skip it without walking the iterator again.
+    hrrs->set_iter_complete();
+    if (claimed) {
       // Scan the strong code root list attached to the current region
       scan_strong_code_roots(r);
-
-      hrrs->set_iter_complete();
     }
     return false;
   }
@@ -233,6 +240,7 @@ public:
 
   size_t cards_done() { return _cards_done;}
   size_t cards_looked_up() { return _cards;}
+  size_t cards_skipped() { return _cards_skipped;}
 };
 
 void G1RemSet::scanRS(G1ParPushHeapRSClosure* oc,
@@ -243,8 +251,6 @@ void G1RemSet::scanRS(G1ParPushHeapRSClosure* oc,
 
   ScanRSClosure scanRScl(oc, code_root_cl, worker_i);
 
-  _g1->collection_set_iterate_from(startRegion, &scanRScl);
-  scanRScl.set_try_claimed();
   _g1->collection_set_iterate_from(startRegion, &scanRScl);
 
   double scan_rs_time_sec = (os::elapsedTime() - rs_time_start)
@@ -253,8 +259,44 @@ void G1RemSet::scanRS(G1ParPushHeapRSClosure* oc,
   assert(_cards_scanned != NULL, "invariant");
   _cards_scanned[worker_i] = scanRScl.cards_done();
 
-  _g1p->phase_times()->record_time_secs(G1GCPhaseTimes::ScanRS, worker_i, scan_rs_time_sec);
-  _g1p->phase_times()->record_time_secs(G1GCPhaseTimes::CodeRoots, worker_i, scanRScl.strong_code_root_scan_time_sec());
+  G1GCPhaseTimes* phase_times = _g1p->phase_times();
+  phase_times->record_time_secs(G1GCPhaseTimes::ScanRS, worker_i, scan_rs_time_sec);
+  phase_times->record_scan_rs_cards(worker_i,
+                                    scanRScl.cards_done(),
+                                    scanRScl.cards_looked_up(),
+                                    scanRScl.cards_skipped());
+  phase_times->record_time_secs(G1GCPhaseTimes::CodeRoots, worker_i, scanRScl.strong_code_root_scan_time_sec());
+}
+
+void G1RemSet::scan_optional_rs(HeapRegion** regions, uint num,
+                                G1ParPushHeapRSClosure* oc,
+                                CodeBlobClosure* code_root_cl,
+                                uint worker_i) {
+  double rs_time_start = os::elapsedTime();
+
+  ScanRSClosure scanRScl(oc, code_root_cl, worker_i);
+
+  // Spread the workers over the regions like scanRS() does over the
+  // collection set.
+  uint n_workers = G1CollectedHeap::use_parallel_gc_threads() ? _g1->workers()->active_workers() : 1;
+  uint start = (num * worker_i) / n_workers;
+  for (uint i = 0; i < num; i++) {
+    scanRScl.doHeapRegion(regions[(start + i) % num]);
+  }
+
+  double scan_rs_time_sec = (os::elapsedTime() - rs_time_start)
+                            - scanRScl.strong_code_root_scan_time_sec();
+
+  assert(_cards_scanned != NULL, "invariant");
+  _cards_scanned[worker_i] += scanRScl.cards_done();
+
+  G1GCPhaseTimes* phase_times = _g1p->phase_times();
+  phase_times->add_time_secs(G1GCPhaseTimes::OptScanRS, worker_i, scan_rs_time_sec);
+  // The cards of the optional regions count towards those of the Scan RS phase.
+  phase_times->add_scan_rs_cards(worker_i,
+                                 scanRScl.cards_done(),
+                                 scanRScl.cards_looked_up(),
+                                 scanRScl.cards_skipped());
 }
 
 // Closure used for updating RSets and recording references that
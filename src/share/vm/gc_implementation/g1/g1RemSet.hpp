@@ -111,6 +111,14 @@ public:
               CodeBlobClosure* code_root_cl,
               uint worker_i);
 
+  // Scan the remembered sets and strong code roots of the given regions,
+  // which were added to the collection set by an increment of the optional
+  // collection set. Cards claimed earlier in the pause are not scanned again.
+  void scan_optional_rs(HeapRegion** regions, uint num,
+                        G1ParPushHeapRSClosure* oc,
+                        CodeBlobClosure* code_root_cl,
+                        uint worker_i);
+
   void updateRS(DirtyCardQueue* into_cset_dcq, uint worker_i);
 
   CardTableModRefBS* ct_bs() { return _ct_bs; }
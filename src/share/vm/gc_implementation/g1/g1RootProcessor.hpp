@@ -35,6 +35,7 @@ class G1CollectedHeap;
 class G1GCPhaseTimes;
 class G1ParPushHeapRSClosure;
 class G1RootClosures;
+class HeapRegion;
 class Monitor;
 class OopClosure;
 class SubTasksDone;
@@ -129,6 +130,14 @@ public:
                             OopClosure* scan_non_heap_weak_roots,
                             uint worker_i);
 
+  // Apply scan_rs to the remembered sets of the given regions of the
+  // optional collection set and scan_non_heap_weak_roots to the nmethods
+  // in their strong code root lists.
+  void scan_optional_remembered_sets(HeapRegion** regions, uint num,
+                                     G1ParPushHeapRSClosure* scan_rs,
+                                     OopClosure* scan_non_heap_weak_roots,
+                                     uint worker_i);
+
   // Apply oops, clds and blobs to strongly and weakly reachable roots in the system,
   // the only thing different from process_all_roots is that we skip the string table
   // to avoid keeping every string live when doing class unloading.
@@ -299,6 +299,7 @@ HeapRegion::HeapRegion(uint hrm_index,
                        MemRegion mr) :
     G1OffsetTableContigSpace(sharedOffsetArray, mr),
     _hrm_index(hrm_index),
+    _node_index(0),
     _allocation_context(AllocationContext::system()),
     _humongous_start_region(NULL),
     _in_collection_set(false),
@@ -218,6 +218,9 @@ class HeapRegion: public G1OffsetTableContigSpace {
   // The index of this region in the heap region sequence.
   uint  _hrm_index;
 
+  // The index of the NUMA node this region's memory is bound to, see G1NUMA.
+  uint  _node_index;
+
   AllocationContext_t _allocation_context;
 
   HeapRegionType _type;
@@ -344,7 +347,11 @@ class HeapRegion: public G1OffsetTableContigSpace {
     ParEvacFailureClaimValue   = 6,
     AggregateCountClaimValue   = 7,
     VerifyCountClaimValue      = 8,
-    ParMarkRootClaimValue      = 9
+    ParMarkRootClaimValue      = 9,
+    ParPrepareCompactClaimValue = 10,
+    ParAdjustPointersClaimValue = 11,
+    HeapDumpClaimValue         = 12,
+    HeapInspectionClaimValue   = 13
   };
 
   // All allocated blocks are occupied by objects in a HeapRegion
@@ -367,6 +374,9 @@ class HeapRegion: public G1OffsetTableContigSpace {
   // sequence, otherwise -1.
   uint hrm_index() const { return _hrm_index; }
 
+  uint node_index() const { return _node_index; }
+  void set_node_index(uint node_index) { _node_index = node_index; }
+
   // The number of bytes marked live in the region in the last marking phase.
   size_t marked_bytes()    { return _prev_marked_bytes; }
   size_t live_bytes() {
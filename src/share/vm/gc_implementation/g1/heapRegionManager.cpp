@@ -82,6 +82,7 @@ void HeapRegionManager::commit_regions(uint index, size_t num_regions) {
   _num_committed += (uint)num_regions;
 
   _heap_mapper->commit_regions(index, num_regions);
+  request_memory_on_nodes(index, num_regions);
 
   // Also commit auxiliary data
   _prev_bitmap_mapper->commit_regions(index, num_regions);
@@ -113,6 +114,37 @@ void HeapRegionManager::commit_region_memory(uint idx) {
   }
 
   _heap_mapper->par_commit_region_memory(idx);
+  request_memory_on_nodes(idx, 1);
+}
+
+void HeapRegionManager::request_memory_on_nodes(uint start, size_t num_regions) {
+  G1NUMA* numa = G1NUMA::numa();
+  if (!numa->is_enabled()) {
+    return;
+  }
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+  for (uint i = start; i < start + num_regions; i++) {
+    numa->request_memory_on_node(g1h->bottom_addr_for_region(i), HeapRegion::GrainBytes, i);
+  }
+}
+
+HeapRegion* HeapRegionManager::allocate_free_region(bool is_old, uint requested_node_index) {
+  HeapRegion* hr = NULL;
+  G1NUMA* numa = G1NUMA::numa();
+  if (requested_node_index < numa->num_active_nodes() && numa->is_enabled()) {
+    // Prefer a region on the requested node, fall back to any.
+    hr = _free_list.remove_region_with_node_index(is_old, requested_node_index);
+  }
+  if (hr == NULL) {
+    hr = _free_list.remove_region(is_old);
+  }
+
+  if (hr != NULL) {
+    assert(hr->next() == NULL, "Single region should not have next");
+    assert(is_available(hr->hrm_index()), "Must be committed");
+    numa->record_region_allocation(requested_node_index, hr);
+  }
+  return hr;
 }
 
 void HeapRegionManager::free_region_memory(uint idx) {
@@ -170,6 +202,7 @@ void HeapRegionManager::make_regions_available(uint start, uint num_regions) {
     MemRegion mr(bottom, bottom + HeapRegion::GrainWords);
 
     hr->initialize(mr);
+    hr->set_node_index(G1NUMA::numa()->preferred_node_index_for_index(i));
     insert_into_free_list(at(i));
   }
 }
@@ -26,6 +26,7 @@
 #define SHARE_VM_GC_IMPLEMENTATION_G1_HEAPREGIONMANAGER_HPP
 
 #include "gc_implementation/g1/g1BiasedArray.hpp"
+#include "gc_implementation/g1/g1NUMA.hpp"
 #include "gc_implementation/g1/g1RegionToSpaceMapper.hpp"
 #include "gc_implementation/g1/heapRegionSet.hpp"
 #include "services/memoryUsage.hpp"
@@ -98,6 +99,8 @@ class HeapRegionManager: public CHeapObj<mtGC> {
   // Pass down commit calls to the VirtualSpace.
   void commit_regions(uint index, size_t num_regions = 1);
   void uncommit_regions(uint index, size_t num_regions = 1);
+  // Bind the heap memory of the given regions to their preferred NUMA nodes.
+  void request_memory_on_nodes(uint start, size_t num_regions);
 
   // Notify other data structures about change in the heap layout.
   void update_committed_space(HeapWord* old_end, HeapWord* new_end);
@@ -165,15 +168,9 @@ public:
     _free_list.add_ordered(list);
   }
 
-  HeapRegion* allocate_free_region(bool is_old) {
-    HeapRegion* hr = _free_list.remove_region(is_old);
-
-    if (hr != NULL) {
-      assert(hr->next() == NULL, "Single region should not have next");
-      assert(is_available(hr->hrm_index()), "Must be committed");
-    }
-    return hr;
-  }
+  // Allocate a free region, preferring one on the given NUMA node (see
+  // G1NUMA) if requested_node_index names an active node.
+  HeapRegion* allocate_free_region(bool is_old, uint requested_node_index = G1NUMA::AnyNodeIndex);
 
   inline void allocate_free_regions_starting_at(uint first, uint num_regions);
 
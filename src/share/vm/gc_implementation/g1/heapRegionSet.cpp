@@ -197,6 +197,21 @@ void FreeRegionList::add_ordered(FreeRegionList* from_list) {
   from_list->verify_optional();
 }
 
+HeapRegion* FreeRegionList::remove_region_with_node_index(bool from_head,
+                                                          uint requested_node_index) {
+  check_mt_safety();
+  verify_optional();
+
+  HeapRegion* cur = from_head ? _head : _tail;
+  while (cur != NULL && cur->node_index() != requested_node_index) {
+    cur = from_head ? cur->next() : cur->prev();
+  }
+  if (cur == NULL) {
+    return NULL;
+  }
+  return remove_region(cur);
+}
+
 void FreeRegionList::remove_starting_at(HeapRegion* first, uint num_regions) {
   check_mt_safety();
   assert(num_regions >= 1, hrs_ext_msg(this, "pre-condition"));
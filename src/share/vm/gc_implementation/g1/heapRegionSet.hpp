@@ -247,6 +247,11 @@ public:
   // Removes from head or tail based on the given argument.
   HeapRegion* remove_region(bool from_head);
 
+  // Removes the first region with the given NUMA node index, searching
+  // from head or tail based on the given argument. Returns NULL if there
+  // is no such region.
+  HeapRegion* remove_region_with_node_index(bool from_head, uint requested_node_index);
+
   // Merge two ordered lists. The result is also ordered. The order is
   // determined by hrm_index.
   void add_ordered(FreeRegionList* from_list);
@@ -93,7 +93,7 @@ bool VM_G1IncCollectionPause::doit_prologue() {
 void VM_G1IncCollectionPause::doit() {
   G1CollectedHeap* g1h = G1CollectedHeap::heap();
   assert(!_should_initiate_conc_mark || g1h->should_do_concurrent_full_gc(_gc_cause),
-      "only a GC locker, a System.gc(), stats update, whitebox, or a hum allocation induced GC should start a cycle");
+      "only a GC locker, a System.gc(), stats update, whitebox, periodic or a hum allocation induced GC should start a cycle");
 
   if (_word_size > 0) {
     AllocationContextMark acm(this->allocation_context());
@@ -140,9 +140,13 @@ void VM_G1IncCollectionPause::doit() {
     // will cause the requesting thread to spin inside collect() until the
     // just started marking cycle is complete - which may be a while. So
     // we do NOT retry the GC.
+    //
+    // The same holds for periodic collections: a running marking cycle
+    // already does what the periodic collection was asked for.
     if (!res) {
       assert(_word_size == 0, "Concurrent Full GC/Humongous Object IM shouldn't be allocating");
-      if (_gc_cause != GCCause::_g1_humongous_allocation) {
+      if (_gc_cause != GCCause::_g1_humongous_allocation &&
+          _gc_cause != GCCause::_g1_periodic_collection) {
         _should_retry_gc = true;
       }
       return;
@@ -133,6 +133,13 @@ GenGCPhaseTimes::GenGCPhaseTimes(uint max_gc_threads) :
 
   _gc_par_phases[OldGenScan] = new WorkerDataArray<double>(max_gc_threads, "older-gen scanning (ms)", true, GenGCLog::LevelFine, 3);
 
+  // CMS initial mark and remark phases
+  _gc_par_phases[YoungGenRescan] = new WorkerDataArray<double>(max_gc_threads, "Young Gen Rescan (ms)", true, GenGCLog::LevelFine, 2);
+  _gc_par_phases[NewCLDScan] = new WorkerDataArray<double>(max_gc_threads, "New CLD Scan (ms)", true, GenGCLog::LevelFine, 2);
+  _gc_par_phases[DirtyKlassScan] = new WorkerDataArray<double>(max_gc_threads, "Dirty Klass Scan (ms)", true, GenGCLog::LevelFine, 2);
+  _gc_par_phases[DirtyCardRescan] = new WorkerDataArray<double>(max_gc_threads, "Dirty Card Rescan (ms)", true, GenGCLog::LevelFine, 2);
+  _gc_par_phases[WorkStealing] = new WorkerDataArray<double>(max_gc_threads, "Work Stealing (ms)", true, GenGCLog::LevelFine, 2);
+
   _gc_par_phases[Other] = new WorkerDataArray<double>(max_gc_threads, "GC Worker Other (ms)", true, GenGCLog::LevelFine,     2);
   _gc_par_phases[GCWorkerTotal] = new WorkerDataArray<double>(max_gc_threads, "GC Worker Total (ms)", true, GenGCLog::LevelFine, 2);
   _gc_par_phases[GCWorkerEnd] = new WorkerDataArray<double>(max_gc_threads, "GC Worker End (ms)", false, GenGCLog::LevelFine, 2);
@@ -146,6 +153,19 @@ void GenGCPhaseTimes::note_gc_start(uint active_gc_threads) {
   for (int i = 0; i < GCParPhasesSentinel; i++) {
     _gc_par_phases[i]->reset();
   }
+
+  for (int i = CMSMarkPhasesFirst; i <= CMSMarkPhasesLast; i++) {
+    _gc_par_phases[i]->set_enabled(false);
+  }
+}
+
+void GenGCPhaseTimes::note_cms_mark_start(bool remark) {
+  _gc_par_phases[YoungGenRescan]->set_enabled(true);
+  if (remark) {
+    for (int i = CMSMarkPhasesFirst; i <= CMSMarkPhasesLast; i++) {
+      _gc_par_phases[i]->set_enabled(true);
+    }
+  }
 }
 
 void GenGCPhaseTimes::note_gc_end() {
@@ -154,6 +174,11 @@ void GenGCPhaseTimes::note_gc_end() {
     record_time_secs(GCWorkerTotal, i , worker_time);
 
     double worker_known_time = _gc_par_phases[RootProcess]->get(i);
+    for (int j = CMSMarkPhasesFirst; j <= CMSMarkPhasesLast; j++) {
+      if (_gc_par_phases[j]->enabled()) {
+        worker_known_time += _gc_par_phases[j]->get(i);
+      }
+    }
     record_time_secs(Other, i, worker_time - worker_known_time);
   }
 
@@ -214,6 +239,10 @@ class GenGCParPhasePrinter : public StackObj {
   void print(GenGCPhaseTimes::GCParPhases phase_id) {
     WorkerDataArray<double>* phase = _phase_times->_gc_par_phases[phase_id];
 
+    if (!phase->_enabled) {
+      return;
+    }
+
     if (phase->_length == 1) {
       print_single_length(phase_id, phase);
     } else {
@@ -68,6 +68,11 @@ class GenGCPhaseTimes : public CHeapObj<mtGC> {
     CodeCacheRoots,
     JVMTIRoots,
     OldGenScan,
+    YoungGenRescan,
+    NewCLDScan,
+    DirtyKlassScan,
+    DirtyCardRescan,
+    WorkStealing,
     Other,
     GCWorkerTotal,
     GCWorkerEnd,
@@ -76,6 +81,10 @@ class GenGCPhaseTimes : public CHeapObj<mtGC> {
 private:
   // Markers for grouping the phases in the GCPhases enum above
   static const int GCMainParPhasesLast = GCWorkerEnd;
+  // Phases of the parallel CMS initial mark and remark tasks outside of
+  // the root processing; disabled for the other collections.
+  static const int CMSMarkPhasesFirst = YoungGenRescan;
+  static const int CMSMarkPhasesLast = WorkStealing;
 
   WorkerDataArray<double>* _gc_par_phases[GCParPhasesSentinel];
 
@@ -88,6 +97,9 @@ private:
  public:
   GenGCPhaseTimes(uint max_gc_threads);
   void note_gc_start(uint active_gc_threads);
+  // Enable the CMS phases for a parallel initial mark (only the young
+  // gen is rescanned outside of the roots) or remark.
+  void note_cms_mark_start(bool remark);
   void note_gc_end();
   void print();
   void log_gc_details();
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "precompiled.hpp"
+#include "classfile/metadataOnStackMark.hpp"
+#include "classfile/symbolTable.hpp"
+#include "classfile/systemDictionary.hpp"
+#include "code/codeCache.hpp"
+#include "gc_implementation/shared/parallelCleaning.hpp"
+#include "memory/resourceArea.hpp"
+#include "oops/instanceKlass.hpp"
+#include "prims/jvmtiExport.hpp"
+#include "runtime/atomic.inline.hpp"
+
+bool KlassCleaningTask::claim_clean_klass_tree_task() {
+  if (_clean_klass_tree_claimed) {
+    return false;
+  }
+
+  return Atomic::cmpxchg(1, (jint*)&_clean_klass_tree_claimed, 0) == 0;
+}
+
+InstanceKlass* KlassCleaningTask::claim_next_klass() {
+  Klass* klass;
+  do {
+    klass =_klass_iterator.next_klass();
+  } while (klass != NULL && !klass->oop_is_instance());
+
+  return (InstanceKlass*)klass;
+}
+
+void KlassCleaningTask::clean_klass(InstanceKlass* ik) {
+  ik->clean_weak_instanceklass_links(_is_alive);
+
+  if (JvmtiExport::has_redefined_a_class()) {
+    InstanceKlass::purge_previous_versions(ik);
+  }
+}
+
+void KlassCleaningTask::work() {
+  ResourceMark rm;
+
+  // One worker will clean the subklass/sibling klass tree.
+  if (claim_clean_klass_tree_task()) {
+    Klass::clean_subklass_tree(_is_alive);
+  }
+
+  // All workers will help cleaning the classes,
+  InstanceKlass* klass;
+  while ((klass = claim_next_klass()) != NULL) {
+    clean_klass(klass);
+  }
+}
+
+bool ParallelCleaning::unload_classes(BoolObjectClosure* is_alive, FlexibleWorkGang* workers) {
+  if (!use_workers(workers)) {
+    // Unload classes and purge the SystemDictionary.
+    bool purged_class = SystemDictionary::do_unloading(is_alive);
+
+    // Unload nmethods.
+    CodeCache::do_unloading(is_alive, purged_class);
+
+    // Prune dead klasses from subklass/sibling/implementor lists.
+    Klass::clean_weak_klass_links(is_alive);
+    return purged_class;
+  }
+
+  if (JvmtiExport::has_redefined_a_class() || ClassLoaderDataGraph::has_metadata_to_deallocate()) {
+    // The klass cleaning task purges the previous versions of redefined
+    // classes and the deallocate lists are freed afterwards, both need
+    // the on stack marks.
+    MetadataOnStackMark md_on_stack(JvmtiExport::has_redefined_a_class());
+    return par_unload_classes(is_alive, workers);
+  }
+  return par_unload_classes(is_alive, workers);
+}
+
+bool ParallelCleaning::par_unload_classes(BoolObjectClosure* is_alive, FlexibleWorkGang* workers) {
+  bool purged_class = SystemDictionary::do_unloading(is_alive, false /* Defer klass cleaning */, workers);
+
+  CodeCache::do_unloading(is_alive, purged_class);
+
+  ParallelKlassCleaningTask klass_cleaning_task(is_alive);
+  workers->run_task(&klass_cleaning_task);
+
+  ClassLoaderDataGraph::free_deallocate_lists();
+  return purged_class;
+}
+
+StringSymbolTableUnlinkTask::StringSymbolTableUnlinkTask(BoolObjectClosure* is_alive) :
+    AbstractGangTask("String/Symbol Unlinking"),
+    _is_alive(is_alive) {
+  StringTable::clear_parallel_claimed_index();
+  SymbolTable::clear_parallel_claimed_index();
+}
+
+void StringSymbolTableUnlinkTask::work(uint worker_id) {
+  int processed = 0;
+  int removed = 0;
+  StringTable::possibly_parallel_unlink(_is_alive, &processed, &removed);
+  SymbolTable::possibly_parallel_unlink(&processed, &removed);
+}
+
+void ParallelCleaning::unlink_string_and_symbol_tables(BoolObjectClosure* is_alive, FlexibleWorkGang* workers) {
+  assert(use_workers(workers), "use the serial unlinking");
+  StringSymbolTableUnlinkTask unlink_task(is_alive);
+  workers->run_task(&unlink_task);
+}
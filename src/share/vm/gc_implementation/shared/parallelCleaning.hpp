@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef SHARE_VM_GC_IMPLEMENTATION_SHARED_PARALLELCLEANING_HPP
+#define SHARE_VM_GC_IMPLEMENTATION_SHARED_PARALLELCLEANING_HPP
+
+#include "classfile/classLoaderData.hpp"
+#include "memory/allocation.hpp"
+#include "utilities/workgroup.hpp"
+
+class BoolObjectClosure;
+class InstanceKlass;
+
+// Cleans the weak klass links of the classes that were not unloaded.
+// One worker cleans the subklass/sibling tree while all workers claim
+// classes from the ClassLoaderDataGraph to clean their implementors,
+// method data and previous versions.
+class KlassCleaningTask : public StackObj {
+  BoolObjectClosure*                      _is_alive;
+  volatile jint                           _clean_klass_tree_claimed;
+  ClassLoaderDataGraphKlassIteratorAtomic _klass_iterator;
+
+ public:
+  KlassCleaningTask(BoolObjectClosure* is_alive) :
+      _is_alive(is_alive),
+      _clean_klass_tree_claimed(0),
+      _klass_iterator() {
+  }
+
+ private:
+  bool claim_clean_klass_tree_task();
+  InstanceKlass* claim_next_klass();
+
+ public:
+  void clean_klass(InstanceKlass* ik);
+  void work();
+};
+
+// Gang task for collectors which otherwise clean the klass links
+// serially after class unloading.
+class ParallelKlassCleaningTask : public AbstractGangTask {
+  KlassCleaningTask _klass_cleaning_task;
+
+ public:
+  ParallelKlassCleaningTask(BoolObjectClosure* is_alive) :
+      AbstractGangTask("Parallel Klass Cleaning"),
+      _klass_cleaning_task(is_alive) {
+  }
+
+  void work(uint worker_id) {
+    _klass_cleaning_task.work();
+  }
+};
+
+// Gang task unlinking the dead entries of the StringTable and the
+// SymbolTable; the workers claim chunks of buckets of both tables.
+class StringSymbolTableUnlinkTask : public AbstractGangTask {
+  BoolObjectClosure* _is_alive;
+
+ public:
+  StringSymbolTableUnlinkTask(BoolObjectClosure* is_alive);
+
+  void work(uint worker_id);
+};
+
+class ParallelCleaning : AllStatic {
+  static bool par_unload_classes(BoolObjectClosure* is_alive, FlexibleWorkGang* workers);
+
+ public:
+  // Whether the cleaning below is split across the given workers.
+  static bool use_workers(FlexibleWorkGang* workers) {
+    return ParallelClassUnloading && workers != NULL && workers->active_workers() > 1;
+  }
+
+  // Unloads dead classes and nmethods and prunes the weak klass links of
+  // the remaining classes. With ParallelClassUnloading and a work gang the
+  // class loader liveness and klass cleaning are split across the workers.
+  // Returns true if any class was unloaded.
+  static bool unload_classes(BoolObjectClosure* is_alive, FlexibleWorkGang* workers);
+
+  // Removes the dead interned strings and the unreferenced symbols with
+  // the workers; only to be used if use_workers() holds.
+  static void unlink_string_and_symbol_tables(BoolObjectClosure* is_alive, FlexibleWorkGang* workers);
+};
+
+#endif // SHARE_VM_GC_IMPLEMENTATION_SHARED_PARALLELCLEANING_HPP
@@ -184,6 +184,8 @@ void VM_GC_HeapInspection::doit() {
   }
   HeapInspection inspect(_csv_format, _print_help, _print_class_stats,
                          _columns);
+  inspect.set_parallel_thread_num(_parallel_thread_num);
+  inspect.set_sample_percent(_sample_percent);
   inspect.heap_inspection(_out);
 }
 
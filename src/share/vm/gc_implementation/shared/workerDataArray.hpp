@@ -86,6 +86,7 @@ class WorkerDataArray  : public CHeapObj<mtGC> {
   void verify(uint active_threads) PRODUCT_RETURN;
 
   void set_enabled(bool enabled) { _enabled = enabled; }
+  bool enabled() const { return _enabled; }
 
   int log_level() { return _log_level;  }
 
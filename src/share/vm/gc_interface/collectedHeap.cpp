@@ -37,6 +37,7 @@
 #include "oops/instanceMirrorKlass.hpp"
 #include "runtime/init.hpp"
 #include "runtime/thread.inline.hpp"
+#include "services/allocationSampler.hpp"
 #include "services/heapDumper.hpp"
 
 
@@ -263,6 +264,18 @@ void CollectedHeap::check_for_valid_allocation_state() {
 
 HeapWord* CollectedHeap::allocate_from_tlab_slow(KlassHandle klass, Thread* thread, size_t size) {
 
+  // The allocation reached the sample point, not the end of the tlab.
+  // Allocate it below the real end if it fits, then move on to the next
+  // sample point.
+  if (thread->tlab().has_sample_end()) {
+    thread->tlab().set_back_allocation_end();
+    HeapWord* obj = thread->tlab().allocate(size);
+    AllocationSampler::sample_allocation(thread);
+    if (obj != NULL) {
+      return obj;
+    }
+  }
+
   // Retain tlab and allocate object in shared space if
   // the amount free in the tlab is too large to discard.
   if (thread->tlab().free() > thread->tlab().refill_waste_limit()) {
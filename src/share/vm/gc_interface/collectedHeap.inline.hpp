@@ -32,6 +32,7 @@
 #include "prims/jvmtiExport.hpp"
 #include "runtime/sharedRuntime.hpp"
 #include "runtime/thread.inline.hpp"
+#include "services/allocationSampler.hpp"
 #include "services/lowMemoryDetector.hpp"
 #include "utilities/copy.hpp"
 
@@ -144,6 +145,10 @@ HeapWord* CollectedHeap::common_mem_allocate_noinit(KlassHandle klass, size_t si
 
     CollectedHeap::trace_allocation_outside_tlab(klass, result, size * HeapWordSize, THREAD);
 
+    if (AllocationSampler::enabled()) {
+      AllocationSampler::sample_outside_tlab(THREAD, size * HeapWordSize);
+    }
+
     return result;
   }
 
@@ -103,6 +103,9 @@ const char* GCCause::to_string(GCCause::Cause cause) {
     case _g1_elastic_heap_trigger_gc:
       return "Elastic Heap triggered GC";
 
+    case _g1_periodic_collection:
+      return "G1 Periodic Collection";
+
     case _last_ditch_collection:
       return "Last ditch collection";
 
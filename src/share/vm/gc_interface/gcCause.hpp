@@ -74,6 +74,7 @@ class GCCause : public AllStatic {
     _g1_humongous_allocation,
 
     _g1_elastic_heap_trigger_gc,
+    _g1_periodic_collection,
 
     _last_ditch_collection,
     _last_gc_cause
@@ -2198,7 +2198,8 @@ run:
             // allocations go through InterpreterRuntime::_new() if THREAD->tlab().allocate
             // returns NULL.
 #ifndef CC_INTERP_PROFILE
-            if (result == NULL) {
+            // A TLAB miss may also be an allocation site sample point.
+            if (result == NULL && AllocationSiteSamplingInterval == 0) {
               need_zero = true;
               // Try allocate in shared eden
             retry:
@@ -1642,6 +1642,12 @@ void LinkResolver::resolve_invokedynamic(CallInfo& result, constantPoolHandle po
   }
   if (!cpce->is_f1_null()) {
     methodHandle method(     THREAD, cpce->f1_as_method());
+    if (!method->is_method_handle_intrinsic() && !method->is_compiled_lambda_form()) {
+      // Linked directly to the target of a constant call site.
+      result.set_static(KlassHandle(THREAD, method->method_holder()), method, THREAD);
+      wrap_invokedynamic_exception(CHECK);
+      return;
+    }
     Handle       appendix(   THREAD, cpce->appendix_if_resolved(pool));
     Handle       method_type(THREAD, cpce->method_type_if_resolved(pool));
     result.set_handle(method, appendix, method_type, THREAD);
@@ -1660,6 +1666,36 @@ void LinkResolver::resolve_invokedynamic(CallInfo& result, constantPoolHandle po
   resolve_dynamic_call(result, bootstrap_specifier, method_name, method_signature, current_klass, CHECK);
 }
 
+// Returns the static method a constant call site is bound to, if the call
+// site can call it directly instead of going through the LambdaForm adapter.
+// The appendix of a constant call site is its target method handle.
+static methodHandle constant_call_site_target(Handle appendix, Symbol* method_signature, TRAPS) {
+  if (appendix.is_null() || appendix->klass() != SystemDictionary::DirectMethodHandle_klass()) {
+    return methodHandle();
+  }
+  oop mname = java_lang_invoke_DirectMethodHandle::member(appendix());
+  if (mname == NULL) {
+    return methodHandle();
+  }
+  int flags = java_lang_invoke_MemberName::flags(mname);
+  int ref_kind = (flags >> java_lang_invoke_MemberName::MN_REFERENCE_KIND_SHIFT) &
+                 java_lang_invoke_MemberName::MN_REFERENCE_KIND_MASK;
+  Metadata* vmtarget = java_lang_invoke_MemberName::vmtarget(mname);
+  if (ref_kind != JVM_REF_invokeStatic || vmtarget == NULL || !vmtarget->is_method()) {
+    return methodHandle();
+  }
+  methodHandle target(THREAD, (Method*)vmtarget);
+  // Calling the target directly skips the class initialization barrier and
+  // the caller binding of the adapter. The target's type equals the call
+  // site type, so the signatures are identical.
+  if (!target->method_holder()->is_initialized() ||
+      target->caller_sensitive() ||
+      target->signature() != method_signature) {
+    return methodHandle();
+  }
+  return target;
+}
+
 void LinkResolver::resolve_dynamic_call(CallInfo& result,
                                         Handle bootstrap_specifier,
                                         Symbol* method_name, Symbol* method_signature,
@@ -1677,6 +1713,17 @@ void LinkResolver::resolve_dynamic_call(CallInfo& result,
                                                      &resolved_method_type,
                                                      THREAD);
   wrap_invokedynamic_exception(CHECK);
+  if (DirectLinkConstantCallSites) {
+    methodHandle target = constant_call_site_target(resolved_appendix, method_signature, THREAD);
+    if (target.not_null()) {
+      result.set_static(KlassHandle(THREAD, target->method_holder()), target, THREAD);
+      wrap_invokedynamic_exception(CHECK);
+      // Not passed to the target, but stored in the call site's resolved
+      // references to keep the target's class alive.
+      result._resolved_appendix = resolved_appendix;
+      return;
+    }
+  }
   result.set_handle(resolved_method, resolved_appendix, resolved_method_type, THREAD);
   wrap_invokedynamic_exception(CHECK);
 }
@@ -220,7 +220,7 @@ inline void WriterHost<BE, IE, WriterPolicyImpl>::write(jstring string) {
     write<u1>(EMPTY_STRING);
     return;
   }
-  const bool is_latin1_encoded = false;
+  const bool is_latin1_encoded = java_lang_String::is_latin1(string_oop);
   const typeArrayOop value = java_lang_String::value(string_oop);
   assert(value != NULL, "invariant");
   if (is_latin1_encoded) {
@@ -33,6 +33,7 @@
 #include "gc_implementation/shared/gcTimer.hpp"
 #include "gc_implementation/shared/gcTrace.hpp"
 #include "gc_implementation/shared/gcTraceTime.hpp"
+#include "gc_implementation/shared/parallelCleaning.hpp"
 #include "gc_interface/collectedHeap.inline.hpp"
 #include "memory/genCollectedHeap.hpp"
 #include "memory/genMarkSweep.hpp"
@@ -236,14 +237,9 @@ void GenMarkSweep::mark_sweep_phase1(int level,
   // This is the point where the entire marking should have completed.
   assert(_marking_stack.is_empty(), "Marking should have completed");
 
-  // Unload classes and purge the SystemDictionary.
-  bool purged_class = SystemDictionary::do_unloading(&is_alive);
-
-  // Unload nmethods.
-  CodeCache::do_unloading(&is_alive, purged_class);
-
-  // Prune dead klasses from subklass/sibling/implementor lists.
-  Klass::clean_weak_klass_links(&is_alive);
+  // Unload classes, nmethods and prune dead klasses from
+  // subklass/sibling/implementor lists.
+  ParallelCleaning::unload_classes(&is_alive, gch->workers());
 
   // Delete entries for dead interned strings.
   StringTable::unlink(&is_alive);
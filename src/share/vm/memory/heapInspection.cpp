@@ -29,10 +29,12 @@
 #include "memory/generation.hpp"
 #include "memory/heapInspection.hpp"
 #include "memory/resourceArea.hpp"
+#include "runtime/mutexLocker.hpp"
 #include "runtime/os.hpp"
 #include "utilities/globalDefinitions.hpp"
 #include "utilities/macros.hpp"
 #if INCLUDE_ALL_GCS
+#include "gc_implementation/g1/g1CollectedHeap.inline.hpp"
 #include "gc_implementation/parallelScavenge/parallelScavengeHeap.hpp"
 #endif // INCLUDE_ALL_GCS
 
@@ -201,6 +203,61 @@ size_t KlassInfoTable::size_of_instances_in_words() const {
   return _size_of_instances_in_words;
 }
 
+// Return false if the entry could not be merged on account
+// of running out of space required to create a new entry.
+bool KlassInfoTable::merge_entry(const KlassInfoEntry* cie) {
+  Klass*          k = cie->klass();
+  KlassInfoEntry* elt = lookup(k);
+  if (elt != NULL) {
+    elt->set_count(elt->count() + cie->count());
+    elt->set_words(elt->words() + cie->words());
+    _size_of_instances_in_words += cie->words();
+    return true;
+  } else {
+    return false;
+  }
+}
+
+class KlassInfoTableMergeClosure : public KlassInfoClosure {
+ private:
+  KlassInfoTable* _dest;
+  size_t _missed_count;
+ public:
+  KlassInfoTableMergeClosure(KlassInfoTable* table) : _dest(table), _missed_count(0) {}
+  void do_cinfo(KlassInfoEntry* cie) {
+    if (!_dest->merge_entry(cie)) {
+      _missed_count += cie->count();
+    }
+  }
+  size_t missed_count() const { return _missed_count; }
+};
+
+size_t KlassInfoTable::merge(KlassInfoTable* table) {
+  KlassInfoTableMergeClosure closure(this);
+  table->iterate(&closure);
+  return closure.missed_count();
+}
+
+class KlassInfoTableScaleClosure : public KlassInfoClosure {
+ private:
+  double _factor;
+  size_t _words;
+ public:
+  KlassInfoTableScaleClosure(double factor) : _factor(factor), _words(0) {}
+  void do_cinfo(KlassInfoEntry* cie) {
+    cie->set_count((long)(cie->count() * _factor + 0.5));
+    cie->set_words((size_t)(cie->words() * _factor + 0.5));
+    _words += cie->words();
+  }
+  size_t words() const { return _words; }
+};
+
+void KlassInfoTable::scale(double factor) {
+  KlassInfoTableScaleClosure closure(factor);
+  iterate(&closure);
+  _size_of_instances_in_words = closure.words();
+}
+
 int KlassInfoHisto::sort_helper(KlassInfoEntry** e1, KlassInfoEntry** e2) {
   return (*e1)->compare(*e1,*e2);
 }
@@ -484,9 +541,153 @@ class RecordInstanceClosure : public ObjectClosure {
   }
 };
 
+#if INCLUDE_ALL_GCS
+// Records the objects of the G1 heap regions claimed by a worker. When
+// sampling, only an evenly spread percentage of the regions is visited.
+class G1HeapInspectRegionClosure : public HeapRegionClosure {
+ private:
+  ObjectClosure* _cl;
+  uint   _sample_percent;
+  size_t _used_bytes;      // used bytes of all the regions seen
+  size_t _sampled_bytes;   // used bytes of the regions visited
+ public:
+  G1HeapInspectRegionClosure(ObjectClosure* cl, uint sample_percent) :
+    _cl(cl), _sample_percent(sample_percent), _used_bytes(0), _sampled_bytes(0) {}
+
+  bool doHeapRegion(HeapRegion* r) {
+    // the starts humongous region covers the whole humongous object
+    if (r->is_free() || r->continuesHumongous()) {
+      return false;
+    }
+    _used_bytes += r->used();
+    if ((r->hrm_index() * _sample_percent) % 100 < _sample_percent) {
+      _sampled_bytes += r->used();
+      r->object_iterate(_cl);
+    }
+    return false;
+  }
+
+  size_t used_bytes() const    { return _used_bytes; }
+  size_t sampled_bytes() const { return _sampled_bytes; }
+};
+
+// Each worker fills a KlassInfoTable of its own which is merged into the
+// shared table at the end. A worker that cannot allocate a table records
+// straight into the shared one under the lock.
+class G1ParHeapInspectTask : public AbstractGangTask {
+ private:
+  KlassInfoTable*    _shared_cit;
+  BoolObjectClosure* _filter;
+  uint               _num_workers;
+  uint               _sample_percent;
+  size_t             _missed_count;
+  size_t             _used_bytes;
+  size_t             _sampled_bytes;
+
+  void iterate_regions(KlassInfoTable* cit, uint worker_id) {
+    RecordInstanceClosure ric(cit, _filter);
+    G1HeapInspectRegionClosure blk(&ric, _sample_percent);
+    G1CollectedHeap::heap()->heap_region_par_iterate_chunked(&blk, worker_id, _num_workers,
+                                                             HeapRegion::HeapInspectionClaimValue);
+    _missed_count += ric.missed_count();
+    _used_bytes += blk.used_bytes();
+    _sampled_bytes += blk.sampled_bytes();
+  }
+
+ public:
+  G1ParHeapInspectTask(KlassInfoTable* shared_cit, BoolObjectClosure* filter,
+                       uint num_workers, uint sample_percent) :
+    AbstractGangTask("G1 Heap Inspection"),
+    _shared_cit(shared_cit), _filter(filter), _num_workers(num_workers),
+    _sample_percent(sample_percent), _missed_count(0), _used_bytes(0), _sampled_bytes(0) {}
+
+  void work(uint worker_id) {
+    KlassInfoTable cit(false);
+    if (cit.allocation_failed()) {
+      MutexLockerEx ml(ParGCRareEvent_lock, Mutex::_no_safepoint_check_flag);
+      iterate_regions(_shared_cit, worker_id);
+      return;
+    }
+
+    RecordInstanceClosure ric(&cit, _filter);
+    G1HeapInspectRegionClosure blk(&ric, _sample_percent);
+    G1CollectedHeap::heap()->heap_region_par_iterate_chunked(&blk, worker_id, _num_workers,
+                                                             HeapRegion::HeapInspectionClaimValue);
+
+    // the shared table and the counters are only updated under the lock
+    MutexLockerEx ml(ParGCRareEvent_lock, Mutex::_no_safepoint_check_flag);
+    _missed_count += ric.missed_count() + _shared_cit->merge(&cit);
+    _used_bytes += blk.used_bytes();
+    _sampled_bytes += blk.sampled_bytes();
+  }
+
+  size_t missed_count() const  { return _missed_count; }
+  size_t used_bytes() const    { return _used_bytes; }
+  size_t sampled_bytes() const { return _sampled_bytes; }
+};
+#endif // INCLUDE_ALL_GCS
+
+// Returns false if the heap is not inspected region by region, which
+// requires G1 and either several workers or sampling.
+bool HeapInspection::populate_table_g1(KlassInfoTable* cit, BoolObjectClosure* filter, size_t* missed_count) {
+#if INCLUDE_ALL_GCS
+  if (!UseG1GC) {
+    return false;
+  }
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+  uint n_workers = 1;
+  if (G1CollectedHeap::use_parallel_gc_threads()) {
+    n_workers = MIN2(_parallel_thread_num, g1h->workers()->total_workers());
+  }
+  if (n_workers <= 1 && _sample_percent == 100) {
+    return false;
+  }
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at a safepoint");
+
+  size_t used_bytes;
+  size_t sampled_bytes;
+  if (n_workers > 1) {
+    assert(g1h->check_heap_region_claim_values(HeapRegion::InitialClaimValue), "sanity check");
+    uint saved_active_workers = g1h->workers()->active_workers();
+    g1h->workers()->set_active_workers(n_workers);
+    G1ParHeapInspectTask task(cit, filter, n_workers, _sample_percent);
+    g1h->set_par_threads(n_workers);
+    g1h->workers()->run_task(&task);
+    g1h->set_par_threads(0);
+    g1h->workers()->set_active_workers(saved_active_workers);
+    g1h->reset_heap_region_claim_values();
+
+    *missed_count = task.missed_count();
+    used_bytes = task.used_bytes();
+    sampled_bytes = task.sampled_bytes();
+  } else {
+    RecordInstanceClosure ric(cit, filter);
+    G1HeapInspectRegionClosure blk(&ric, _sample_percent);
+    g1h->heap_region_iterate(&blk);
+
+    *missed_count = ric.missed_count();
+    used_bytes = blk.used_bytes();
+    sampled_bytes = blk.sampled_bytes();
+  }
+
+  if (sampled_bytes > 0 && sampled_bytes < used_bytes) {
+    _sampled_fraction = (double)sampled_bytes / (double)used_bytes;
+    cit->scale(1.0 / _sampled_fraction);
+  }
+  return true;
+#else
+  return false;
+#endif // INCLUDE_ALL_GCS
+}
+
 size_t HeapInspection::populate_table(KlassInfoTable* cit, BoolObjectClosure *filter) {
   ResourceMark rm;
 
+  size_t missed_count = 0;
+  if (populate_table_g1(cit, filter, &missed_count)) {
+    return missed_count;
+  }
+
   RecordInstanceClosure ric(cit, filter);
   if (PrintYoungGenHistoAfterParNewGC && UseParNewGC) {
     assert(GenCollectedHeap::heap()->n_gens() == 2, "When using ParNew GC, there are only two generations");
@@ -528,6 +729,11 @@ void HeapInspection::heap_inspection(outputStream* st) {
                    missed_count);
     }
 
+    if (_sampled_fraction < 1.0) {
+      st->print_cr("Estimated from %u%% of the heap regions (%3.1f%% of the used heap)",
+                   _sample_percent, _sampled_fraction * 100.0);
+    }
+
     // Sort and print klass instance info
     const char *title = "\n"
               " num     #instances         #bytes  class name\n"
@@ -254,6 +254,13 @@ class KlassInfoTable: public StackObj {
   void iterate(KlassInfoClosure* cic);
   bool allocation_failed() { return _buckets == NULL; }
   size_t size_of_instances_in_words() const;
+  // adds the counts of the given table, used to combine the tables of
+  // the workers of a parallel heap inspection. Returns the number of
+  // instances that could not be merged for lack of C-heap.
+  size_t merge(KlassInfoTable* table);
+  bool merge_entry(const KlassInfoEntry* cie);
+  // extrapolates the counts of a sampled heap inspection
+  void scale(double factor);
 
   friend class KlassInfoHisto;
 };
@@ -361,16 +368,28 @@ class HeapInspection : public StackObj {
   bool _print_help;
   bool _print_class_stats;
   const char* _columns;
+  uint _parallel_thread_num;
+  uint _sample_percent;
+  double _sampled_fraction;   // fraction of the used heap visited by populate_table
  public:
   HeapInspection(bool csv_format, bool print_help,
                  bool print_class_stats, const char *columns) :
       _csv_format(csv_format), _print_help(print_help),
-      _print_class_stats(print_class_stats), _columns(columns) {}
+      _print_class_stats(print_class_stats), _columns(columns),
+      _parallel_thread_num(1), _sample_percent(100), _sampled_fraction(1.0) {}
   void heap_inspection(outputStream* st) NOT_SERVICES_RETURN;
   size_t populate_table(KlassInfoTable* cit, BoolObjectClosure* filter = NULL) NOT_SERVICES_RETURN;
   static void find_instances_at_safepoint(Klass* k, GrowableArray<oop>* result) NOT_SERVICES_RETURN;
+
+  // With G1 the heap regions can be inspected by several GC workers, each
+  // filling a table of its own, and only a percentage of the regions may
+  // be visited to estimate the histogram in a shorter pause. Other
+  // collectors always inspect the whole heap on the VM thread.
+  void set_parallel_thread_num(uint n)   { _parallel_thread_num = MAX2(n, 1U); }
+  void set_sample_percent(uint percent)  { _sample_percent = MIN2(MAX2(percent, 1U), 100U); }
  private:
   void iterate_over_heap(KlassInfoTable* cit, BoolObjectClosure* filter = NULL);
+  bool populate_table_g1(KlassInfoTable* cit, BoolObjectClosure* filter, size_t* missed_count);
 };
 
 #endif // SHARE_VM_MEMORY_HEAPINSPECTION_HPP
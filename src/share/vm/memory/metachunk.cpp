@@ -55,7 +55,9 @@ Metachunk::Metachunk(size_t word_size,
                      VirtualSpaceNode* container)
     : Metabase<Metachunk>(word_size),
     _top(NULL),
-    _container(container)
+    _container(container),
+    _is_uncommitted(false),
+    _free_timestamp(0)
 {
   _top = initial_top();
 #ifdef ASSERT
@@ -102,6 +102,13 @@ class Metachunk : public Metabase<Metachunk> {
   // Current allocation top.
   MetaWord* _top;
 
+  // A free chunk whose payload has been given back to the OS.
+  // Only the page holding this header stays committed.
+  bool _is_uncommitted;
+
+  // When the chunk was last put on a free list, in nanoseconds.
+  jlong _free_timestamp;
+
   DEBUG_ONLY(bool _is_tagged_free;)
 
   MetaWord* initial_top() const { return (MetaWord*)this + overhead(); }
@@ -138,6 +145,12 @@ class Metachunk : public Metabase<Metachunk> {
   size_t used_word_size() const;
   size_t free_word_size() const;
 
+  bool is_uncommitted() const     { return _is_uncommitted; }
+  void set_is_uncommitted(bool v) { _is_uncommitted = v; }
+
+  jlong free_timestamp() const     { return _free_timestamp; }
+  void set_free_timestamp(jlong t) { _free_timestamp = t; }
+
 #ifdef ASSERT
   bool is_tagged_free() { return _is_tagged_free; }
   void set_is_tagged_free(bool v) { _is_tagged_free = v; }
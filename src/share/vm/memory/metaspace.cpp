@@ -43,8 +43,10 @@
 #include "runtime/java.hpp"
 #include "runtime/mutex.hpp"
 #include "runtime/orderAccess.inline.hpp"
+#include "runtime/task.hpp"
 #include "services/memTracker.hpp"
 #include "services/memoryService.hpp"
+#include "services/nmtCommon.hpp"
 #include "utilities/copy.hpp"
 #include "utilities/debug.hpp"
 
@@ -112,6 +114,10 @@ class ChunkManager : public CHeapObj<mtInternal> {
   size_t _free_chunks_total;
   size_t _free_chunks_count;
 
+  // Number of merges and splits of free chunks, for the statistics
+  size_t _num_chunks_merged;
+  size_t _num_chunks_split;
+
   void dec_free_chunks_total(size_t v) {
     assert(_free_chunks_count > 0 &&
              _free_chunks_total > 0,
@@ -140,10 +146,31 @@ class ChunkManager : public CHeapObj<mtInternal> {
   }
   void verify_free_chunks_count();
 
+  // Put a chunk on its free list, without touching the totals.
+  void add_free_chunk(ChunkIndex index, Metachunk* chunk);
+
+  // Free chunks are merged buddy-style: when all the chunks of a region
+  // that is aligned to, and as large as, a bigger chunk size are free,
+  // they are replaced by one chunk of that size. Returns true if the
+  // chunk was merged into a chunk of size target_index.
+  bool attempt_to_coalesce_around_chunk(Metachunk* chunk, ChunkIndex target_index);
+  void coalesce_around_chunk(ChunkIndex index, Metachunk* chunk);
+
+  // Splits a free chunk into a chunk of target_word_size at its bottom
+  // and aligned chunks for the rest. All pieces go to the free lists.
+  void split_chunk(Metachunk* chunk, size_t target_word_size);
+
+  // Splits the smallest larger free chunk to get a chunk of word_size.
+  bool split_larger_chunk(size_t word_size);
+
+  // Commits the payload of a free chunk that was uncommitted.
+  bool commit_chunk(Metachunk* chunk);
+
  public:
 
   ChunkManager(size_t specialized_size, size_t small_size, size_t medium_size)
-      : _free_chunks_total(0), _free_chunks_count(0) {
+      : _free_chunks_total(0), _free_chunks_count(0),
+        _num_chunks_merged(0), _num_chunks_split(0) {
     _free_chunks[SpecializedIndex].set_size(specialized_size);
     _free_chunks[SmallIndex].set_size(small_size);
     _free_chunks[MediumIndex].set_size(medium_size);
@@ -164,6 +191,20 @@ class ChunkManager : public CHeapObj<mtInternal> {
   // of type index.
   void return_chunks(ChunkIndex index, Metachunk* chunks);
 
+  // Return one chunk that was in use to its free list and merge it
+  // with its free neighbours where possible.
+  void return_single_chunk(ChunkIndex index, Metachunk* chunk);
+
+  // Add a chunk carved from the virtual space to keep the next chunk
+  // aligned.
+  void return_padding_chunk(Metachunk* chunk);
+
+  // Give the payload of the free medium chunks back to the OS once they
+  // have been free for MetaspaceUncommitDelay, keeping the first
+  // MetaspaceUncommitWatermark bytes of free memory committed.
+  // Returns the number of words uncommitted.
+  size_t uncommit_free_chunks(VirtualSpaceList* vs_list);
+
   // Total of the space in the free chunks list
   size_t free_chunks_total_words();
   size_t free_chunks_total_bytes();
@@ -248,6 +289,10 @@ class ChunkManager : public CHeapObj<mtInternal> {
   void locked_print_sum_free_chunks(outputStream* st);
 
   void print_on(outputStream* st) const;
+
+  // Free chunks by size, and the share of free space only usable by
+  // small allocations. Reads the counters without locking.
+  void print_fragmentation_on(outputStream* st, size_t uncommitted_bytes, size_t scale) const;
 };
 
 // Used to manage the free list of Metablocks (a block corresponds
@@ -281,6 +326,104 @@ class BlockFreelist VALUE_OBJ_CLASS_SPEC {
   void print_on(outputStream* st) const;
 };
 
+// Two bits for every smallest-chunk-sized area of a VirtualSpaceNode:
+// whether a chunk starts there, and whether that area is part of a chunk
+// in use. Lets the ChunkManager find out whether the neighbours of a
+// returned chunk are free without walking the node.
+class OccupancyMap : public CHeapObj<mtInternal> {
+  enum {
+    layer_chunk_start_map = 0,
+    layer_in_use_map = 1,
+    number_of_layers = 2
+  };
+
+  // Bottom of the node
+  const MetaWord* const _reference_address;
+  const size_t _word_size;
+  const size_t _smallest_chunk_word_size;
+  // Bytes per layer
+  size_t _map_size;
+  uint8_t* _map[number_of_layers];
+
+  size_t position_for_address(const MetaWord* p) const {
+    assert(p >= _reference_address && p < _reference_address + _word_size,
+           "address outside the map");
+    size_t offset = pointer_delta(p, _reference_address, sizeof(MetaWord));
+    assert(offset % _smallest_chunk_word_size == 0, "address not aligned");
+    return offset / _smallest_chunk_word_size;
+  }
+
+  bool get_bit_at_position(size_t pos, int layer) const {
+    return (_map[layer][pos / 8] & (1 << (pos % 8))) != 0;
+  }
+
+  void set_bit_at_position(size_t pos, int layer, bool v) {
+    if (v) {
+      _map[layer][pos / 8] |= (uint8_t)(1 << (pos % 8));
+    } else {
+      _map[layer][pos / 8] &= (uint8_t)~(1 << (pos % 8));
+    }
+  }
+
+  void set_bits_of_region(size_t pos, size_t num_bits, int layer, bool v) {
+    for (size_t i = pos; i < pos + num_bits; i++) {
+      set_bit_at_position(i, layer, v);
+    }
+  }
+
+  bool is_any_bit_set_in_region(size_t pos, size_t num_bits, int layer) const {
+    for (size_t i = pos; i < pos + num_bits; i++) {
+      if (get_bit_at_position(i, layer)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  size_t num_bits_for(size_t word_size) const {
+    assert(word_size % _smallest_chunk_word_size == 0, "size not aligned");
+    return word_size / _smallest_chunk_word_size;
+  }
+
+ public:
+  OccupancyMap(const MetaWord* reference_address, size_t word_size, size_t smallest_chunk_word_size) :
+    _reference_address(reference_address), _word_size(word_size),
+    _smallest_chunk_word_size(smallest_chunk_word_size) {
+    size_t num_bits = align_size_up(word_size, smallest_chunk_word_size) / smallest_chunk_word_size;
+    _map_size = (num_bits + 7) / 8;
+    for (int layer = 0; layer < number_of_layers; layer++) {
+      _map[layer] = NEW_C_HEAP_ARRAY(uint8_t, _map_size, mtInternal);
+      memset(_map[layer], 0, _map_size);
+    }
+  }
+
+  ~OccupancyMap() {
+    for (int layer = 0; layer < number_of_layers; layer++) {
+      FREE_C_HEAP_ARRAY(uint8_t, _map[layer], mtInternal);
+    }
+  }
+
+  bool chunk_starts_at_address(MetaWord* p) const {
+    return get_bit_at_position(position_for_address(p), layer_chunk_start_map);
+  }
+
+  void set_chunk_starts_at_address(MetaWord* p, bool v) {
+    set_bit_at_position(position_for_address(p), layer_chunk_start_map, v);
+  }
+
+  void wipe_chunk_start_bits_in_region(MetaWord* p, size_t word_size) {
+    set_bits_of_region(position_for_address(p), num_bits_for(word_size), layer_chunk_start_map, false);
+  }
+
+  bool is_region_in_use(MetaWord* p, size_t word_size) const {
+    return is_any_bit_set_in_region(position_for_address(p), num_bits_for(word_size), layer_in_use_map);
+  }
+
+  void set_region_in_use(MetaWord* p, size_t word_size, bool v) {
+    set_bits_of_region(position_for_address(p), num_bits_for(word_size), layer_in_use_map, v);
+  }
+};
+
 // A VirtualSpaceList node.
 class VirtualSpaceNode : public CHeapObj<mtClass> {
   friend class VirtualSpaceList;
@@ -288,6 +431,15 @@ class VirtualSpaceNode : public CHeapObj<mtClass> {
   // Link to next VirtualSpaceNode
   VirtualSpaceNode* _next;
 
+  // Whether this node belongs to the compressed class space
+  bool _is_class;
+
+  // Chunk starts and chunks in use, for merging free chunks
+  OccupancyMap* _occupancy_map;
+
+  // Words inside free chunks that were uncommitted again
+  size_t _uncommitted_words;
+
   // total in the VirtualSpace
   MemRegion _reserved;
   ReservedSpace _rs;
@@ -306,12 +458,25 @@ class VirtualSpaceNode : public CHeapObj<mtClass> {
 
   // Committed but unused space in the virtual space
   size_t free_words_in_vs() const;
+
+  // Carve free chunks from top until top is aligned to the given chunk
+  // size, so that chunks are always aligned to their size.
+  void allocate_padding_chunks_until_top_aligned_to(size_t alignment, ChunkManager* chunk_manager);
+
+  // The committed pages of a free chunk that can be uncommitted: all
+  // but the one holding the chunk header.
+  size_t uncommittable_words(Metachunk* chunk, MetaWord** start) const;
  public:
 
-  VirtualSpaceNode(size_t byte_size);
-  VirtualSpaceNode(ReservedSpace rs) : _top(NULL), _next(NULL), _rs(rs), _container_count(0) {}
+  VirtualSpaceNode(bool is_class, size_t byte_size);
+  VirtualSpaceNode(bool is_class, ReservedSpace rs) :
+    _top(NULL), _next(NULL), _is_class(is_class), _occupancy_map(NULL),
+    _uncommitted_words(0), _rs(rs), _container_count(0) {}
   ~VirtualSpaceNode();
 
+  bool is_class() const { return _is_class; }
+  OccupancyMap* occupancy_map() const { return _occupancy_map; }
+
   // Convenience functions for logical bottom and end
   MetaWord* bottom() const { return (MetaWord*) _virtual_space.low(); }
   MetaWord* end() const { return (MetaWord*) _virtual_space.high(); }
@@ -319,7 +484,8 @@ class VirtualSpaceNode : public CHeapObj<mtClass> {
   bool contains(const void* ptr) { return ptr >= low() && ptr < high(); }
 
   size_t reserved_words() const  { return _virtual_space.reserved_size() / BytesPerWord; }
-  size_t committed_words() const { return _virtual_space.actual_committed_size() / BytesPerWord; }
+  size_t committed_words() const { return _virtual_space.actual_committed_size() / BytesPerWord - _uncommitted_words; }
+  size_t uncommitted_words() const { return _uncommitted_words; }
 
   bool is_pre_committed() const { return _virtual_space.special(); }
 
@@ -356,10 +522,17 @@ class VirtualSpaceNode : public CHeapObj<mtClass> {
   bool initialize();
 
   // get space from the virtual space
-  Metachunk* take_from_committed(size_t chunk_word_size);
+  Metachunk* take_from_committed(size_t chunk_word_size, ChunkManager* chunk_manager);
 
-  // Allocate a chunk from the virtual space and return it.
-  Metachunk* get_chunk_vs(size_t chunk_word_size);
+  // Allocate a chunk from the virtual space and return it.  Padding
+  // chunks needed to align it go to the chunk_manager.
+  Metachunk* get_chunk_vs(size_t chunk_word_size, ChunkManager* chunk_manager);
+
+  // Uncommit the payload of a free chunk, returns the words uncommitted.
+  size_t uncommit_chunk(Metachunk* chunk);
+  // Commit the payload of a free chunk again, returns the words committed
+  // or 0 if the metaspace may not grow by that much.
+  size_t commit_chunk(Metachunk* chunk);
 
   // Expands/shrinks the committed space in a virtual space.  Delegates
   // to Virtualspace
@@ -410,7 +583,9 @@ static bool should_commit_large_pages_when_reserving(size_t bytes) {
 }
 
   // byte_size is the size of the associated virtualspace.
-VirtualSpaceNode::VirtualSpaceNode(size_t bytes) : _top(NULL), _next(NULL), _rs(), _container_count(0) {
+VirtualSpaceNode::VirtualSpaceNode(bool is_class, size_t bytes) :
+  _top(NULL), _next(NULL), _is_class(is_class), _occupancy_map(NULL),
+  _uncommitted_words(0), _rs(), _container_count(0) {
   assert_is_size_aligned(bytes, Metaspace::reserve_alignment());
 
 #if INCLUDE_CDS
@@ -525,6 +700,10 @@ class VirtualSpaceList : public CHeapObj<mtClass> {
   // virtual space and add the chunks to the free list.
   void retire_current_virtual_space();
 
+  ChunkManager* chunk_manager() const {
+    return is_class() ? Metaspace::chunk_manager_class() : Metaspace::chunk_manager_metadata();
+  }
+
  public:
   VirtualSpaceList(size_t word_size);
   VirtualSpaceList(ReservedSpace rs);
@@ -553,6 +732,8 @@ class VirtualSpaceList : public CHeapObj<mtClass> {
   size_t reserved_bytes()  { return reserved_words() * BytesPerWord; }
   size_t committed_words() { return _committed_words; }
   size_t committed_bytes() { return committed_words() * BytesPerWord; }
+  // Words uncommitted inside free chunks, over all nodes
+  size_t uncommitted_words();
 
   void inc_reserved_words(size_t v);
   void dec_reserved_words(size_t v);
@@ -887,6 +1068,9 @@ void BlockFreelist::print_on(outputStream* st) const {
 // VirtualSpaceNode methods
 
 VirtualSpaceNode::~VirtualSpaceNode() {
+  if (_occupancy_map != NULL) {
+    delete _occupancy_map;
+  }
   _rs.release();
 #ifdef ASSERT
   size_t word_size = sizeof(*this) / BytesPerWord;
@@ -907,21 +1091,46 @@ size_t VirtualSpaceNode::free_words_in_vs() const {
   return pointer_delta(end(), top(), sizeof(MetaWord));
 }
 
+void VirtualSpaceNode::allocate_padding_chunks_until_top_aligned_to(size_t alignment,
+                                                                     ChunkManager* chunk_manager) {
+  const size_t specialized_word_size = chunk_manager->free_chunks(SpecializedIndex)->size();
+  const size_t small_word_size = chunk_manager->free_chunks(SmallIndex)->size();
+  size_t offset = pointer_delta(top(), bottom(), sizeof(MetaWord));
+  while (!is_size_aligned(offset, alignment)) {
+    // Use small chunks as soon as top is aligned to them
+    size_t padding_word_size = specialized_word_size;
+    if (small_word_size < alignment && is_size_aligned(offset, small_word_size)) {
+      padding_word_size = small_word_size;
+    }
+    Metachunk* padding_chunk = ::new (top()) Metachunk(padding_word_size, this);
+    inc_top(padding_word_size);
+    occupancy_map()->set_chunk_starts_at_address((MetaWord*)padding_chunk, true);
+    chunk_manager->return_padding_chunk(padding_chunk);
+    offset += padding_word_size;
+  }
+}
+
 // Allocates the chunk from the virtual space only.
 // This interface is also used internally for debugging.  Not all
 // chunks removed here are necessarily used for allocation.
-Metachunk* VirtualSpaceNode::take_from_committed(size_t chunk_word_size) {
-  // Bottom of the new chunk
-  MetaWord* chunk_limit = top();
-  assert(chunk_limit != NULL, "Not safe to call this method");
-
+Metachunk* VirtualSpaceNode::take_from_committed(size_t chunk_word_size, ChunkManager* chunk_manager) {
   // The virtual spaces are always expanded by the
   // commit granularity to enforce the following condition.
   // Without this the is_available check will not work correctly.
   assert(_virtual_space.committed_size() == _virtual_space.actual_committed_size(),
       "The committed memory doesn't match the expanded memory.");
-
-  if (!is_available(chunk_word_size)) {
+  assert(top() != NULL, "Not safe to call this method");
+
+  // Chunks start at an offset from the bottom of the node that is a
+  // multiple of their size, humongous chunks at a multiple of the medium
+  // chunk size. This is what allows merging free neighbours.
+  ChunkIndex index = chunk_manager->list_index(chunk_word_size);
+  size_t alignment = index == HumongousIndex ?
+                     chunk_manager->free_chunks(MediumIndex)->size() : chunk_word_size;
+  size_t offset = pointer_delta(top(), bottom(), sizeof(MetaWord));
+  size_t padding = align_size_up(offset, alignment) - offset;
+
+  if (!is_available(padding + chunk_word_size)) {
     if (TraceMetadataChunkAllocation) {
       gclog_or_tty->print("VirtualSpaceNode::take_from_committed() not available %d words ", chunk_word_size);
       // Dump some information about the virtual space that is nearly full
@@ -930,14 +1139,65 @@ Metachunk* VirtualSpaceNode::take_from_committed(size_t chunk_word_size) {
     return NULL;
   }
 
+  if (padding > 0) {
+    allocate_padding_chunks_until_top_aligned_to(alignment, chunk_manager);
+  }
+
+  // Bottom of the new chunk
+  MetaWord* chunk_limit = top();
+
   // Take the space  (bump top on the current virtual space).
   inc_top(chunk_word_size);
 
   // Initialize the chunk
   Metachunk* result = ::new (chunk_limit) Metachunk(chunk_word_size, this);
+  occupancy_map()->set_chunk_starts_at_address(chunk_limit, true);
+  occupancy_map()->set_region_in_use(chunk_limit, chunk_word_size, true);
   return result;
 }
 
+size_t VirtualSpaceNode::uncommittable_words(Metachunk* chunk, MetaWord** start) const {
+  const size_t alignment = Metaspace::commit_alignment();
+  char* from = (char*)align_ptr_up((char*)(chunk->bottom() + Metachunk::overhead()), alignment);
+  char* to = (char*)align_ptr_down((char*)chunk->end(), alignment);
+  *start = (MetaWord*)from;
+  return to > from ? pointer_delta(to, from, sizeof(MetaWord)) : 0;
+}
+
+size_t VirtualSpaceNode::uncommit_chunk(Metachunk* chunk) {
+  assert_lock_strong(SpaceManager::expand_lock());
+  assert(!chunk->is_uncommitted(), "already uncommitted");
+  if (is_pre_committed()) {
+    return 0;
+  }
+  MetaWord* start;
+  size_t words = uncommittable_words(chunk, &start);
+  if (words == 0 || !os::uncommit_memory((char*)start, words * BytesPerWord)) {
+    return 0;
+  }
+  chunk->set_is_uncommitted(true);
+  _uncommitted_words += words;
+  return words;
+}
+
+size_t VirtualSpaceNode::commit_chunk(Metachunk* chunk) {
+  assert_lock_strong(SpaceManager::expand_lock());
+  assert(chunk->is_uncommitted(), "not uncommitted");
+  MetaWord* start;
+  size_t words = uncommittable_words(chunk, &start);
+  // Committing it again counts like expanding the metaspace
+  if (!MetaspaceGC::can_expand(words, is_class()) ||
+      MetaspaceGC::allowed_expansion() < words) {
+    return 0;
+  }
+  if (!os::commit_memory((char*)start, words * BytesPerWord, false)) {
+    return 0;
+  }
+  chunk->set_is_uncommitted(false);
+  _uncommitted_words -= words;
+  return words;
+}
+
 
 // Expand the virtual space (commit more of the reserved space)
 bool VirtualSpaceNode::expand_by(size_t min_words, size_t preferred_words) {
@@ -958,9 +1218,9 @@ bool VirtualSpaceNode::expand_by(size_t min_words, size_t preferred_words) {
   return result;
 }
 
-Metachunk* VirtualSpaceNode::get_chunk_vs(size_t chunk_word_size) {
+Metachunk* VirtualSpaceNode::get_chunk_vs(size_t chunk_word_size, ChunkManager* chunk_manager) {
   assert_lock_strong(SpaceManager::expand_lock());
-  Metachunk* result = take_from_committed(chunk_word_size);
+  Metachunk* result = take_from_committed(chunk_word_size, chunk_manager);
   if (result != NULL) {
     inc_container_count();
   }
@@ -994,6 +1254,9 @@ bool VirtualSpaceNode::initialize() {
     set_reserved(MemRegion((HeapWord*)_rs.base(),
                  (HeapWord*)(_rs.base() + _rs.size())));
 
+    STATIC_ASSERT(SpecializedChunk == ClassSpecializedChunk);
+    _occupancy_map = new OccupancyMap(bottom(), reserved_words(), SpecializedChunk);
+
     assert(reserved()->start() == (HeapWord*) _rs.base(),
       err_msg("Reserved start was not set properly " PTR_FORMAT
         " != " PTR_FORMAT, reserved()->start(), _rs.base()));
@@ -1152,15 +1415,22 @@ bool VirtualSpaceList::contains(const void* ptr) {
   return false;
 }
 
+size_t VirtualSpaceList::uncommitted_words() {
+  // Lock-free like contains(), nodes are only removed at a safepoint
+  size_t words = 0;
+  VirtualSpaceListIterator iter(virtual_space_list());
+  while (iter.repeat()) {
+    words += iter.get_next()->uncommitted_words();
+  }
+  return words;
+}
+
 void VirtualSpaceList::retire_current_virtual_space() {
   assert_lock_strong(SpaceManager::expand_lock());
 
   VirtualSpaceNode* vsn = current_virtual_space();
 
-  ChunkManager* cm = is_class() ? Metaspace::chunk_manager_class() :
-                                  Metaspace::chunk_manager_metadata();
-
-  vsn->retire(cm);
+  vsn->retire(chunk_manager());
 }
 
 void VirtualSpaceNode::retire(ChunkManager* chunk_manager) {
@@ -1170,11 +1440,15 @@ void VirtualSpaceNode::retire(ChunkManager* chunk_manager) {
 
     while (free_words_in_vs() >= chunk_size) {
       DEBUG_ONLY(verify_container_count();)
-      Metachunk* chunk = get_chunk_vs(chunk_size);
-      assert(chunk != NULL, "allocation should have been successful");
+      Metachunk* chunk = get_chunk_vs(chunk_size, chunk_manager);
+      if (chunk == NULL) {
+        // No room left for the padding that aligns a chunk of this size
+        break;
+      }
 
-      chunk_manager->return_chunks(index, chunk);
+      // Count it first, returning it may merge it with its neighbours
       chunk_manager->inc_free_chunks_total(chunk_size);
+      chunk_manager->return_chunks(index, chunk);
       DEBUG_ONLY(verify_container_count();)
     }
   }
@@ -1202,7 +1476,7 @@ VirtualSpaceList::VirtualSpaceList(ReservedSpace rs) :
                                    _virtual_space_count(0) {
   MutexLockerEx cl(SpaceManager::expand_lock(),
                    Mutex::_no_safepoint_check_flag);
-  VirtualSpaceNode* class_entry = new VirtualSpaceNode(rs);
+  VirtualSpaceNode* class_entry = new VirtualSpaceNode(is_class(), rs);
   bool succeeded = class_entry->initialize();
   if (succeeded) {
     link_vs(class_entry);
@@ -1234,7 +1508,7 @@ bool VirtualSpaceList::create_new_virtual_space(size_t vs_word_size) {
   assert_is_size_aligned(vs_byte_size, Metaspace::reserve_alignment());
 
   // Allocate the meta virtual space and initialize it.
-  VirtualSpaceNode* new_entry = new VirtualSpaceNode(vs_byte_size);
+  VirtualSpaceNode* new_entry = new VirtualSpaceNode(is_class(), vs_byte_size);
   if (!new_entry->initialize()) {
     delete new_entry;
     return false;
@@ -1332,7 +1606,7 @@ bool VirtualSpaceList::expand_by(size_t min_words, size_t preferred_words) {
 Metachunk* VirtualSpaceList::get_new_chunk(size_t chunk_word_size, size_t suggested_commit_granularity) {
 
   // Allocate a chunk out of the current virtual space.
-  Metachunk* next = current_virtual_space()->get_chunk_vs(chunk_word_size);
+  Metachunk* next = current_virtual_space()->get_chunk_vs(chunk_word_size, chunk_manager());
 
   if (next != NULL) {
     return next;
@@ -1350,7 +1624,7 @@ Metachunk* VirtualSpaceList::get_new_chunk(size_t chunk_word_size, size_t sugges
 
   bool expanded = expand_by(min_word_size, preferred_word_size);
   if (expanded) {
-    next = current_virtual_space()->get_chunk_vs(chunk_word_size);
+    next = current_virtual_space()->get_chunk_vs(chunk_word_size, chunk_manager());
     assert(next != NULL, "The allocation was expected to succeed after the expansion");
   }
 
@@ -1829,10 +2103,19 @@ Metachunk* ChunkManager::free_chunks_get(size_t word_size) {
 
     chunk = free_list->head();
 
+    if (chunk == NULL && split_larger_chunk(word_size)) {
+      chunk = free_list->head();
+    }
+
     if (chunk == NULL) {
       return NULL;
     }
 
+    // Uncommitted chunks are kept at the tail of the list
+    if (chunk->is_uncommitted() && !commit_chunk(chunk)) {
+      return NULL;
+    }
+
     // Remove the chunk as the head of the list.
     free_list->remove_chunk(chunk);
 
@@ -1871,11 +2154,189 @@ Metachunk* ChunkManager::free_chunks_get(size_t word_size) {
   chunk->set_is_tagged_free(false);
 #endif
   chunk->container()->inc_container_count();
+  chunk->container()->occupancy_map()->set_region_in_use(chunk->bottom(), chunk->word_size(), true);
 
   slow_locked_verify();
   return chunk;
 }
 
+void ChunkManager::add_free_chunk(ChunkIndex index, Metachunk* chunk) {
+  assert_lock_strong(SpaceManager::expand_lock());
+  DEBUG_ONLY(chunk->set_is_tagged_free(true);)
+  chunk->container()->occupancy_map()->set_region_in_use(chunk->bottom(), chunk->word_size(), false);
+  chunk->set_free_timestamp(os::javaTimeNanos());
+  if (index == HumongousIndex) {
+    humongous_dictionary()->return_chunk(chunk);
+  } else if (chunk->is_uncommitted()) {
+    free_chunks(index)->return_chunk_at_tail(chunk);
+  } else {
+    free_chunks(index)->return_chunk_at_head(chunk);
+  }
+}
+
+bool ChunkManager::attempt_to_coalesce_around_chunk(Metachunk* chunk, ChunkIndex target_index) {
+  assert_lock_strong(SpaceManager::expand_lock());
+  const size_t target_word_size = free_chunks(target_index)->size();
+  if (chunk->word_size() >= target_word_size) {
+    return false;
+  }
+
+  VirtualSpaceNode* const vsn = chunk->container();
+  OccupancyMap* const ocmap = vsn->occupancy_map();
+
+  // The region of the target size that the chunk is part of
+  size_t offset = pointer_delta(chunk->bottom(), vsn->bottom(), sizeof(MetaWord));
+  MetaWord* const region_start = vsn->bottom() + align_size_down(offset, target_word_size);
+  MetaWord* const region_end = region_start + target_word_size;
+
+  // It must be carved from the node completely, must not cut through a
+  // chunk at either end and must not contain a chunk in use.
+  if (region_end > vsn->top() ||
+      !ocmap->chunk_starts_at_address(region_start) ||
+      (region_end < vsn->top() && !ocmap->chunk_starts_at_address(region_end)) ||
+      ocmap->is_region_in_use(region_start, target_word_size)) {
+    return false;
+  }
+
+  // Take the free chunks of the region off their lists
+  MetaWord* p = region_start;
+  while (p < region_end) {
+    Metachunk* c = (Metachunk*)p;
+    assert(c->is_tagged_free(), "Should be tagged free");
+    assert(!c->is_uncommitted(), "only chunks of the largest size are uncommitted");
+    p += c->word_size();
+    remove_chunk(c);
+  }
+  assert(p == region_end, "chunks must end at the region end");
+
+  ocmap->wipe_chunk_start_bits_in_region(region_start, target_word_size);
+  Metachunk* merged = ::new (region_start) Metachunk(target_word_size, vsn);
+  ocmap->set_chunk_starts_at_address(region_start, true);
+  add_free_chunk(target_index, merged);
+  inc_free_chunks_total(target_word_size);
+  _num_chunks_merged++;
+
+  if (TraceMetadataChunkAllocation && Verbose) {
+    gclog_or_tty->print_cr("ChunkManager::attempt_to_coalesce_around_chunk: merged "
+                           PTR_FORMAT " size " SIZE_FORMAT,
+                           merged, target_word_size);
+  }
+  return true;
+}
+
+void ChunkManager::split_chunk(Metachunk* chunk, size_t target_word_size) {
+  assert_lock_strong(SpaceManager::expand_lock());
+  assert(!chunk->is_uncommitted(), "must be committed");
+  VirtualSpaceNode* const vsn = chunk->container();
+  OccupancyMap* const ocmap = vsn->occupancy_map();
+  // The first piece overwrites the header of the chunk
+  const size_t chunk_word_size = chunk->word_size();
+  MetaWord* const start = chunk->bottom();
+  MetaWord* const end = start + chunk_word_size;
+
+  remove_chunk(chunk);
+
+  // The target chunk at the bottom, then the largest chunks that keep
+  // their alignment. Aligned chunks never cross the end since all
+  // chunk sizes divide each other.
+  MetaWord* p = start;
+  size_t piece_word_size = target_word_size;
+  while (p < end) {
+    size_t offset = pointer_delta(p, vsn->bottom(), sizeof(MetaWord));
+    for (ChunkIndex i = MediumIndex; ; i = (ChunkIndex)(i - 1)) {
+      size_t size = free_chunks(i)->size();
+      if (size < chunk_word_size && is_size_aligned(offset, size) &&
+          (p > start || size <= target_word_size)) {
+        piece_word_size = size;
+        break;
+      }
+      assert(i > SpecializedIndex, "specialized chunks always fit");
+    }
+    Metachunk* piece = ::new (p) Metachunk(piece_word_size, vsn);
+    ocmap->set_chunk_starts_at_address(p, true);
+    add_free_chunk(list_index(piece_word_size), piece);
+    inc_free_chunks_total(piece_word_size);
+    p += piece_word_size;
+  }
+  _num_chunks_split++;
+
+  if (TraceMetadataChunkAllocation && Verbose) {
+    gclog_or_tty->print_cr("ChunkManager::split_chunk: " PTR_FORMAT " size " SIZE_FORMAT
+                           " for a chunk of size " SIZE_FORMAT,
+                           start, pointer_delta(end, start, sizeof(MetaWord)), target_word_size);
+  }
+}
+
+bool ChunkManager::split_larger_chunk(size_t word_size) {
+  for (ChunkIndex i = next_chunk_index(list_index(word_size)); i < HumongousIndex; i = next_chunk_index(i)) {
+    Metachunk* larger = free_chunks(i)->head();
+    if (larger == NULL) {
+      continue;
+    }
+    if (larger->is_uncommitted() && !commit_chunk(larger)) {
+      return false;
+    }
+    split_chunk(larger, word_size);
+    return true;
+  }
+  return false;
+}
+
+bool ChunkManager::commit_chunk(Metachunk* chunk) {
+  size_t words = chunk->container()->commit_chunk(chunk);
+  if (words == 0) {
+    return false;
+  }
+  Metaspace::get_space_list(chunk->container()->is_class() ? Metaspace::ClassType
+                                                            : Metaspace::NonClassType)->inc_committed_words(words);
+  // Keep the committed chunks in front
+  ChunkList* list = free_chunks(list_index(chunk->word_size()));
+  list->remove_chunk(chunk);
+  list->return_chunk_at_head(chunk);
+  return true;
+}
+
+size_t ChunkManager::uncommit_free_chunks(VirtualSpaceList* vs_list) {
+  assert_lock_strong(SpaceManager::expand_lock());
+  // Only chunks of the largest size are uncommitted, the smaller ones
+  // are merged into them once their neighbours are free.
+  ChunkList* list = free_chunks(MediumIndex);
+  const size_t watermark = MetaspaceUncommitWatermark / BytesPerWord;
+  const jlong delay = (jlong)MetaspaceUncommitDelay * NANOSECS_PER_MILLISEC;
+  const jlong now = os::javaTimeNanos();
+  // Only medium chunks are uncommitted, so all other free chunks stay
+  // committed and count against the watermark first.
+  size_t kept = free_chunks_total_words() - size_free_chunks_in_bytes(MediumIndex) / BytesPerWord;
+  size_t uncommitted = 0;
+  ssize_t count = list->count();
+  Metachunk* chunk = list->head();
+  // Committed chunks are at the head of the list, most recently freed
+  // first. Those are handed out next and are kept to fill the watermark.
+  for (ssize_t i = 0; i < count && chunk != NULL; i++) {
+    Metachunk* next = chunk->next();
+    if (chunk->is_uncommitted()) {
+      // Already given back
+    } else if (kept + chunk->word_size() <= watermark ||
+               now - chunk->free_timestamp() < delay) {
+      kept += chunk->word_size();
+    } else {
+      size_t words = chunk->container()->uncommit_chunk(chunk);
+      if (words > 0) {
+        uncommitted += words;
+        list->remove_chunk(chunk);
+        list->return_chunk_at_tail(chunk);
+      } else {
+        kept += chunk->word_size();
+      }
+    }
+    chunk = next;
+  }
+  if (uncommitted > 0) {
+    vs_list->dec_committed_words(uncommitted);
+  }
+  return uncommitted;
+}
+
 Metachunk* ChunkManager::chunk_freelist_allocate(size_t word_size) {
   assert_lock_strong(SpaceManager::expand_lock());
   slow_locked_verify();
@@ -1912,6 +2373,31 @@ void ChunkManager::print_on(outputStream* out) const {
   }
 }
 
+void ChunkManager::print_fragmentation_on(outputStream* out, size_t uncommitted_bytes, size_t scale) const {
+  const char* unit = NMTUtil::scale_name(scale);
+  size_t specialized = size_free_chunks_in_bytes(SpecializedIndex);
+  size_t small = size_free_chunks_in_bytes(SmallIndex);
+  size_t medium = size_free_chunks_in_bytes(MediumIndex);
+  size_t humongous = size_free_chunks_in_bytes(HumongousIndex);
+  size_t total = specialized + small + medium + humongous;
+  // Free space left in chunks smaller than a medium chunk, which only
+  // small requests can use until their neighbours are freed
+  size_t fragmented = specialized + small;
+  out->print_cr("specialized " SIZE_FORMAT " (" SIZE_FORMAT "%s), "
+                "small " SIZE_FORMAT " (" SIZE_FORMAT "%s), "
+                "medium " SIZE_FORMAT " (" SIZE_FORMAT "%s, " SIZE_FORMAT "%s uncommitted), "
+                "humongous " SIZE_FORMAT " (" SIZE_FORMAT "%s), "
+                "fragmentation " SIZE_FORMAT "%%, "
+                "merged " SIZE_FORMAT ", split " SIZE_FORMAT,
+                num_free_chunks(SpecializedIndex), NMTUtil::amount_in_scale(specialized, scale), unit,
+                num_free_chunks(SmallIndex), NMTUtil::amount_in_scale(small, scale), unit,
+                num_free_chunks(MediumIndex), NMTUtil::amount_in_scale(medium, scale), unit,
+                NMTUtil::amount_in_scale(uncommitted_bytes, scale), unit,
+                num_free_chunks(HumongousIndex), NMTUtil::amount_in_scale(humongous, scale), unit,
+                total == 0 ? (size_t)0 : fragmented * 100 / total,
+                _num_chunks_merged, _num_chunks_split);
+}
+
 // SpaceManager methods
 
 size_t SpaceManager::adjust_initial_chunk_size(size_t requested, bool is_class_space) {
@@ -2251,27 +2737,49 @@ void ChunkManager::return_chunks(ChunkIndex index, Metachunk* chunks) {
   if (chunks == NULL) {
     return;
   }
-  ChunkList* list = free_chunks(index);
-  assert(list->size() == chunks->word_size(), "Mismatch in chunk sizes");
+  assert(free_chunks(index)->size() == chunks->word_size(), "Mismatch in chunk sizes");
   assert_lock_strong(SpaceManager::expand_lock());
   Metachunk* cur = chunks;
 
-  // This returns chunks one at a time.  If a new
-  // class List can be created that is a base class
-  // of FreeList then something like FreeList::prepend()
-  // can be used in place of this loop
+  // This returns chunks one at a time, so that each can be merged
+  // with its free neighbours.
   while (cur != NULL) {
-    assert(cur->container() != NULL, "Container should have been set");
-    cur->container()->dec_container_count();
     // Capture the next link before it is changed
     // by the call to return_chunk_at_head();
     Metachunk* next = cur->next();
-    DEBUG_ONLY(cur->set_is_tagged_free(true);)
-    list->return_chunk_at_head(cur);
+    return_single_chunk(index, cur);
     cur = next;
   }
 }
 
+void ChunkManager::return_single_chunk(ChunkIndex index, Metachunk* chunk) {
+  assert_lock_strong(SpaceManager::expand_lock());
+  assert(chunk->container() != NULL, "Container should have been set");
+  chunk->container()->dec_container_count();
+  chunk->set_next(NULL);
+  chunk->set_prev(NULL);
+  add_free_chunk(index, chunk);
+  coalesce_around_chunk(index, chunk);
+}
+
+void ChunkManager::return_padding_chunk(Metachunk* chunk) {
+  assert_lock_strong(SpaceManager::expand_lock());
+  ChunkIndex index = list_index(chunk->word_size());
+  assert(index == SpecializedIndex || index == SmallIndex, "padding is small");
+  add_free_chunk(index, chunk);
+  inc_free_chunks_total(chunk->word_size());
+  coalesce_around_chunk(index, chunk);
+}
+
+void ChunkManager::coalesce_around_chunk(ChunkIndex index, Metachunk* chunk) {
+  // Into a medium chunk if possible and otherwise into a small one
+  if (index == SpecializedIndex || index == SmallIndex) {
+    if (!attempt_to_coalesce_around_chunk(chunk, MediumIndex) && index == SpecializedIndex) {
+      attempt_to_coalesce_around_chunk(chunk, SmallIndex);
+    }
+  }
+}
+
 SpaceManager::~SpaceManager() {
   // This call this->_lock which can't be done while holding expand_lock()
   assert(sum_capacity_in_chunks_in_use() == allocated_chunks_words(),
@@ -2337,9 +2845,6 @@ SpaceManager::~SpaceManager() {
   Metachunk* humongous_chunks = chunks_in_use(HumongousIndex);
 
   while (humongous_chunks != NULL) {
-#ifdef ASSERT
-    humongous_chunks->set_is_tagged_free(true);
-#endif
     if (TraceMetadataChunkAllocation && Verbose) {
       gclog_or_tty->print(PTR_FORMAT " (" SIZE_FORMAT ") ",
                           humongous_chunks,
@@ -2352,8 +2857,7 @@ SpaceManager::~SpaceManager() {
                    " granularity %d",
                    humongous_chunks->word_size(), smallest_chunk_size()));
     Metachunk* next_humongous_chunks = humongous_chunks->next();
-    humongous_chunks->container()->dec_container_count();
-    chunk_manager()->humongous_dictionary()->return_chunk(humongous_chunks);
+    chunk_manager()->return_single_chunk(HumongousIndex, humongous_chunks);
     humongous_chunks = next_humongous_chunks;
   }
   if (TraceMetadataChunkAllocation && Verbose) {
@@ -2817,6 +3321,8 @@ void MetaspaceAux::print_on(outputStream* out) {
                 capacity_bytes()/K,
                 committed_bytes()/K,
                 reserved_bytes()/K);
+  out->print("  free chunks    ");
+  print_fragmentation_on(out, nct, K);
 
   if (Metaspace::using_class_space()) {
     Metaspace::MetadataType ct = Metaspace::ClassType;
@@ -2829,7 +3335,157 @@ void MetaspaceAux::print_on(outputStream* out) {
                   capacity_bytes(ct)/K,
                   committed_bytes(ct)/K,
                   reserved_bytes(ct)/K);
+    out->print("  class chunks   ");
+    print_fragmentation_on(out, ct, K);
+  }
+}
+
+void MetaspaceAux::print_fragmentation_on(outputStream* out, Metaspace::MetadataType mdtype, size_t scale) {
+  ChunkManager* cm = Metaspace::get_chunk_manager(mdtype);
+  VirtualSpaceList* vsl = Metaspace::get_space_list(mdtype);
+  if (cm == NULL || vsl == NULL) {
+    out->cr();
+    return;
   }
+  cm->print_fragmentation_on(out, vsl->uncommitted_words() * BytesPerWord, scale);
+}
+
+// Sums up the metaspaces of the class loaders per space type and
+// optionally prints the usage of each loader.
+class MetaspaceReportClosure : public CLDClosure {
+  class CountClassesClosure : public KlassClosure {
+   public:
+    size_t _count;
+    CountClassesClosure() : _count(0) {}
+    void do_klass(Klass* k) { _count++; }
+  };
+
+  outputStream* const _out;
+  const size_t _scale;
+  const bool _show_loaders;
+
+ public:
+  enum { SpaceTypeCount = Metaspace::ReflectionMetaspaceType + 1 };
+
+  size_t _loaders[SpaceTypeCount];
+  size_t _classes[SpaceTypeCount];
+  size_t _used[SpaceTypeCount][Metaspace::MetadataTypeCount];
+  size_t _capacity[SpaceTypeCount][Metaspace::MetadataTypeCount];
+
+  MetaspaceReportClosure(outputStream* out, size_t scale, bool show_loaders) :
+    _out(out), _scale(scale), _show_loaders(show_loaders) {
+    memset(_loaders, 0, sizeof(_loaders));
+    memset(_classes, 0, sizeof(_classes));
+    memset(_used, 0, sizeof(_used));
+    memset(_capacity, 0, sizeof(_capacity));
+  }
+
+  void do_cld(ClassLoaderData* cld) {
+    Metaspace* ms = cld->metaspace_or_null();
+    if (ms == NULL) {
+      return;
+    }
+    Metaspace::MetaspaceType type = ms->space_type();
+    CountClassesClosure counter;
+    cld->classes_do(&counter);
+
+    _loaders[type]++;
+    _classes[type] += counter._count;
+    for (int i = 0; i < Metaspace::MetadataTypeCount; i++) {
+      Metaspace::MetadataType mdtype = (Metaspace::MetadataType)i;
+      _used[type][mdtype] += ms->used_bytes_slow(mdtype);
+      _capacity[type][mdtype] += ms->capacity_bytes_slow(mdtype);
+    }
+
+    if (_show_loaders) {
+      const char* unit = NMTUtil::scale_name(_scale);
+      size_t used = ms->used_bytes_slow(Metaspace::NonClassType);
+      size_t capacity = ms->capacity_bytes_slow(Metaspace::NonClassType);
+      size_t class_used = ms->used_bytes_slow(Metaspace::ClassType);
+      size_t class_capacity = ms->capacity_bytes_slow(Metaspace::ClassType);
+      _out->print_cr("  " PTR_FORMAT " %-10s classes " SIZE_FORMAT_W(5) ", "
+                     "used " SIZE_FORMAT "%s (class " SIZE_FORMAT "%s), "
+                     "free " SIZE_FORMAT "%s (class " SIZE_FORMAT "%s)  %s%s",
+                     p2i(cld), Metaspace::space_type_name(type), counter._count,
+                     NMTUtil::amount_in_scale(used, _scale), unit,
+                     NMTUtil::amount_in_scale(class_used, _scale), unit,
+                     NMTUtil::amount_in_scale(capacity - used, _scale), unit,
+                     NMTUtil::amount_in_scale(class_capacity - class_used, _scale), unit,
+                     cld->loader_name(),
+                     cld->is_anonymous_class_arena() ? " (anonymous class arena)" :
+                     cld->is_anonymous() ? " (anonymous)" : "");
+    }
+  }
+};
+
+void MetaspaceAux::print_report(outputStream* out, size_t scale, bool show_loaders) {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at a safepoint");
+  const char* unit = NMTUtil::scale_name(scale);
+
+  MetaspaceReportClosure cl(out, scale, show_loaders);
+  if (show_loaders) {
+    out->print_cr("Usage per loader:");
+  }
+  ClassLoaderDataGraph::cld_do(&cl);
+  if (show_loaders) {
+    out->cr();
+  }
+
+  out->print_cr("Usage per space type:");
+  for (int i = 0; i < MetaspaceReportClosure::SpaceTypeCount; i++) {
+    if (cl._loaders[i] == 0) {
+      continue;
+    }
+    size_t used = cl._used[i][Metaspace::NonClassType];
+    size_t capacity = cl._capacity[i][Metaspace::NonClassType];
+    size_t class_used = cl._used[i][Metaspace::ClassType];
+    size_t class_capacity = cl._capacity[i][Metaspace::ClassType];
+    out->print_cr("  %10s: " SIZE_FORMAT " loaders, " SIZE_FORMAT " classes, "
+                  "used " SIZE_FORMAT "%s (class " SIZE_FORMAT "%s), "
+                  "free " SIZE_FORMAT "%s (class " SIZE_FORMAT "%s)",
+                  Metaspace::space_type_name((Metaspace::MetaspaceType)i),
+                  cl._loaders[i], cl._classes[i],
+                  NMTUtil::amount_in_scale(used, scale), unit,
+                  NMTUtil::amount_in_scale(class_used, scale), unit,
+                  NMTUtil::amount_in_scale(capacity - used, scale), unit,
+                  NMTUtil::amount_in_scale(class_capacity - class_used, scale), unit);
+  }
+  out->cr();
+
+  out->print_cr("Virtual space:");
+  for (int i = 0; i < Metaspace::MetadataTypeCount; i++) {
+    Metaspace::MetadataType mdtype = (Metaspace::MetadataType)i;
+    if (mdtype == Metaspace::ClassType && !Metaspace::using_class_space()) {
+      continue;
+    }
+    VirtualSpaceList* vsl = Metaspace::get_space_list(mdtype);
+    size_t uncommitted = vsl == NULL ? 0 : vsl->uncommitted_words() * BytesPerWord;
+    out->print_cr("  %10s: reserved " SIZE_FORMAT "%s, committed " SIZE_FORMAT "%s, "
+                  "used " SIZE_FORMAT "%s, capacity " SIZE_FORMAT "%s, "
+                  "free chunks " SIZE_FORMAT "%s, uncommitted " SIZE_FORMAT "%s",
+                  mdtype == Metaspace::ClassType ? "Class" : "Non-Class",
+                  NMTUtil::amount_in_scale(reserved_bytes(mdtype), scale), unit,
+                  NMTUtil::amount_in_scale(committed_bytes(mdtype), scale), unit,
+                  NMTUtil::amount_in_scale(used_bytes(mdtype), scale), unit,
+                  NMTUtil::amount_in_scale(capacity_bytes(mdtype), scale), unit,
+                  NMTUtil::amount_in_scale(free_chunks_total_bytes(mdtype), scale), unit,
+                  NMTUtil::amount_in_scale(uncommitted, scale), unit);
+  }
+  out->cr();
+
+  out->print_cr("Free chunks:");
+  out->print("   Non-Class: ");
+  print_fragmentation_on(out, Metaspace::NonClassType, scale);
+  if (Metaspace::using_class_space()) {
+    out->print("       Class: ");
+    print_fragmentation_on(out, Metaspace::ClassType, scale);
+  }
+  out->cr();
+
+  out->print_cr("Uncommit of free chunks %s, delay " UINTX_FORMAT " ms, watermark " SIZE_FORMAT "%s",
+                MetaspaceUncommitFreeChunks ? "enabled" : "disabled",
+                MetaspaceUncommitDelay,
+                NMTUtil::amount_in_scale(MetaspaceUncommitWatermark, scale), unit);
 }
 
 // Print information for class space and data space separately.
@@ -3340,8 +3996,31 @@ void Metaspace::global_initialize() {
   _tracer = new MetaspaceTracer();
 }
 
+// Free chunks only get old enough to be uncommitted some time after the
+// class unloading that freed them, so look at them again periodically.
+class MetaspaceUncommitTask : public PeriodicTask {
+ public:
+  MetaspaceUncommitTask(size_t interval_time) : PeriodicTask(interval_time) {}
+  void task() {
+    MutexLockerEx cl(SpaceManager::expand_lock(),
+                     Mutex::_no_safepoint_check_flag);
+    Metaspace::uncommit_free_chunks(Metaspace::NonClassType);
+    if (Metaspace::using_class_space()) {
+      Metaspace::uncommit_free_chunks(Metaspace::ClassType);
+    }
+  }
+};
+
 void Metaspace::post_initialize() {
   MetaspaceGC::post_initialize();
+
+  if (MetaspaceUncommitFreeChunks && MetaspaceUncommitDelay > 0 && !DumpSharedSpaces) {
+    size_t interval = (size_t)align_size_down(MetaspaceUncommitDelay, PeriodicTask::interval_gran);
+    interval = MIN2(MAX2(interval, (size_t)PeriodicTask::min_interval),
+                    (size_t)PeriodicTask::max_interval);
+    MetaspaceUncommitTask* task = new MetaspaceUncommitTask(interval);
+    task->enroll();
+  }
 }
 
 void Metaspace::initialize_first_chunk(MetaspaceType type, MetadataType mdtype) {
@@ -3384,6 +4063,8 @@ void Metaspace::verify_global_initialization() {
 void Metaspace::initialize(Mutex* lock, MetaspaceType type) {
   verify_global_initialization();
 
+  _space_type = type;
+
   // Allocate SpaceManager for metadata objects.
   _vsm = new SpaceManager(NonClassType, lock);
 
@@ -3665,6 +4346,20 @@ const char* Metaspace::metadata_type_name(Metaspace::MetadataType mdtype) {
   }
 }
 
+const char* Metaspace::space_type_name(Metaspace::MetaspaceType type) {
+  switch (type) {
+    case Metaspace::StandardMetaspaceType:   return "Standard";
+    case Metaspace::BootMetaspaceType:       return "Boot";
+    case Metaspace::ROMetaspaceType:         return "ReadOnly";
+    case Metaspace::ReadWriteMetaspaceType:  return "ReadWrite";
+    case Metaspace::AnonymousMetaspaceType:  return "Anonymous";
+    case Metaspace::ReflectionMetaspaceType: return "Reflection";
+    default:
+      assert(false, err_msg("Got bad space type: %d", (int) type));
+      return NULL;
+  }
+}
+
 void Metaspace::record_allocation(void* ptr, MetaspaceObj::Type type, size_t word_size) {
   assert(DumpSharedSpaces, "sanity");
 
@@ -3739,6 +4434,20 @@ void Metaspace::iterate(Metaspace::AllocRecordClosure *closure) {
 
 void Metaspace::purge(MetadataType mdtype) {
   get_space_list(mdtype)->purge(get_chunk_manager(mdtype));
+  uncommit_free_chunks(mdtype);
+}
+
+size_t Metaspace::uncommit_free_chunks(MetadataType mdtype) {
+  assert_lock_strong(SpaceManager::expand_lock());
+  if (!MetaspaceUncommitFreeChunks || DumpSharedSpaces) {
+    return 0;
+  }
+  size_t words = get_chunk_manager(mdtype)->uncommit_free_chunks(get_space_list(mdtype));
+  if (TraceMetadataChunkAllocation && words > 0) {
+    gclog_or_tty->print_cr("Metaspace::uncommit_free_chunks: uncommitted " SIZE_FORMAT "K of free %s chunks",
+                           words * BytesPerWord / K, mdtype == ClassType ? "class" : "metadata");
+  }
+  return words;
 }
 
 void Metaspace::purge() {
@@ -3879,7 +4588,7 @@ class TestVirtualSpaceNodeTest {
 
     { // No committed memory in VSN
       ChunkManager cm(SpecializedChunk, SmallChunk, MediumChunk);
-      VirtualSpaceNode vsn(vsn_test_size_bytes);
+      VirtualSpaceNode vsn(false, vsn_test_size_bytes);
       vsn.initialize();
       vsn.retire(&cm);
       assert(cm.sum_free_chunks_count() == 0, "did not commit any memory in the VSN");
@@ -3887,11 +4596,11 @@ class TestVirtualSpaceNodeTest {
 
     { // All of VSN is committed, half is used by chunks
       ChunkManager cm(SpecializedChunk, SmallChunk, MediumChunk);
-      VirtualSpaceNode vsn(vsn_test_size_bytes);
+      VirtualSpaceNode vsn(false, vsn_test_size_bytes);
       vsn.initialize();
       vsn.expand_by(vsn_test_size_words, vsn_test_size_words);
-      vsn.get_chunk_vs(MediumChunk);
-      vsn.get_chunk_vs(MediumChunk);
+      vsn.get_chunk_vs(MediumChunk, &cm);
+      vsn.get_chunk_vs(MediumChunk, &cm);
       vsn.retire(&cm);
       assert(cm.sum_free_chunks_count() == 2, "should have been memory left for 2 medium chunks");
       assert(cm.sum_free_chunks() == 2*MediumChunk, "sizes should add up");
@@ -3899,13 +4608,13 @@ class TestVirtualSpaceNodeTest {
 
     { // 4 pages of VSN is committed, some is used by chunks
       ChunkManager cm(SpecializedChunk, SmallChunk, MediumChunk);
-      VirtualSpaceNode vsn(vsn_test_size_bytes);
+      VirtualSpaceNode vsn(false, vsn_test_size_bytes);
       const size_t page_chunks = 4 * (size_t)os::vm_page_size() / BytesPerWord;
       assert(page_chunks < MediumChunk, "Test expects medium chunks to be at least 4*page_size");
       vsn.initialize();
       vsn.expand_by(page_chunks, page_chunks);
-      vsn.get_chunk_vs(SmallChunk);
-      vsn.get_chunk_vs(SpecializedChunk);
+      vsn.get_chunk_vs(SmallChunk, &cm);
+      vsn.get_chunk_vs(SpecializedChunk, &cm);
       vsn.retire(&cm);
 
       // committed - used = words left to retire
@@ -3921,10 +4630,10 @@ class TestVirtualSpaceNodeTest {
 
     { // Half of VSN is committed, a humongous chunk is used
       ChunkManager cm(SpecializedChunk, SmallChunk, MediumChunk);
-      VirtualSpaceNode vsn(vsn_test_size_bytes);
+      VirtualSpaceNode vsn(false, vsn_test_size_bytes);
       vsn.initialize();
       vsn.expand_by(MediumChunk * 2, MediumChunk * 2);
-      vsn.get_chunk_vs(MediumChunk + SpecializedChunk); // Humongous chunks will be aligned up to MediumChunk + SpecializedChunk
+      vsn.get_chunk_vs(MediumChunk + SpecializedChunk, &cm); // Humongous chunks will be aligned up to MediumChunk + SpecializedChunk
       vsn.retire(&cm);
 
       const size_t words_left = MediumChunk * 2 - (MediumChunk + SpecializedChunk);
@@ -3952,7 +4661,7 @@ class TestVirtualSpaceNodeTest {
 
   static void test_is_available_positive() {
     // Reserve some memory.
-    VirtualSpaceNode vsn(os::vm_allocation_granularity());
+    VirtualSpaceNode vsn(false, os::vm_allocation_granularity());
     assert(vsn.initialize(), "Failed to setup VirtualSpaceNode");
 
     // Commit some memory.
@@ -3970,7 +4679,7 @@ class TestVirtualSpaceNodeTest {
 
   static void test_is_available_negative() {
     // Reserve some memory.
-    VirtualSpaceNode vsn(os::vm_allocation_granularity());
+    VirtualSpaceNode vsn(false, os::vm_allocation_granularity());
     assert(vsn.initialize(), "Failed to setup VirtualSpaceNode");
 
     // Commit some memory.
@@ -3985,7 +4694,7 @@ class TestVirtualSpaceNodeTest {
 
   static void test_is_available_overflow() {
     // Reserve some memory.
-    VirtualSpaceNode vsn(os::vm_allocation_granularity());
+    VirtualSpaceNode vsn(false, os::vm_allocation_granularity());
     assert(vsn.initialize(), "Failed to setup VirtualSpaceNode");
 
     // Commit some memory.
@@ -134,6 +134,8 @@ class Metaspace : public CHeapObj<mtClass> {
   static size_t _commit_alignment;
   static size_t _reserve_alignment;
 
+  MetaspaceType _space_type;
+
   SpaceManager* _vsm;
   SpaceManager* vsm() const { return _vsm; }
 
@@ -224,6 +226,9 @@ class Metaspace : public CHeapObj<mtClass> {
   static size_t commit_alignment()        { return _commit_alignment; }
   static size_t commit_alignment_words()  { return _commit_alignment / BytesPerWord; }
 
+  MetaspaceType space_type() const { return _space_type; }
+  static const char* space_type_name(MetaspaceType type);
+
   char*  bottom() const;
   size_t used_words_slow(MetadataType mdtype) const;
   size_t free_words_slow(MetadataType mdtype) const;
@@ -250,6 +255,10 @@ class Metaspace : public CHeapObj<mtClass> {
   static void purge(MetadataType mdtype);
   static void purge();
 
+  // Give the memory of free chunks back to the OS, see MetaspaceUncommitDelay
+  // and MetaspaceUncommitWatermark. Returns the number of words uncommitted.
+  static size_t uncommit_free_chunks(MetadataType mdtype);
+
   static void report_metadata_oome(ClassLoaderData* loader_data, size_t word_size,
                                    MetaspaceObj::Type type, MetadataType mdtype, TRAPS);
 
@@ -376,6 +385,11 @@ class MetaspaceAux : AllStatic {
   static void print_metaspace_change(size_t prev_metadata_used);
   static void print_on(outputStream * out);
   static void print_on(outputStream * out, Metaspace::MetadataType mdtype);
+  // Free chunks of the given type and how fragmented they are
+  static void print_fragmentation_on(outputStream* out, Metaspace::MetadataType mdtype, size_t scale);
+  // Committed, used and free metaspace per space type and, optionally,
+  // per class loader. Used by the VM.metaspace diagnostic command.
+  static void print_report(outputStream* out, size_t scale, bool show_loaders);
 
   static void print_class_waste(outputStream* out);
   static void print_waste(outputStream* out);
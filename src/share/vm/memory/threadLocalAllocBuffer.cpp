@@ -29,6 +29,7 @@
 #include "memory/universe.inline.hpp"
 #include "oops/oop.inline.hpp"
 #include "runtime/thread.inline.hpp"
+#include "services/allocationSampler.hpp"
 #include "utilities/copy.hpp"
 
 PRAGMA_FORMAT_MUTE_WARNINGS_FOR_GCC
@@ -121,10 +122,15 @@ void ThreadLocalAllocBuffer::make_parsable(bool retire) {
     CollectedHeap::fill_with_object(top(), hard_end(), retire);
 
     if (retire || ZeroTLAB) {  // "Reset" the TLAB
+      if (AllocationSampler::enabled()) {
+        charge_sampled_bytes(0);
+      }
       set_start(NULL);
       set_top(NULL);
       set_pf_top(NULL);
       set_end(NULL);
+      _allocation_end = NULL;
+      _sample_start = NULL;
     }
   }
   assert(!(retire || ZeroTLAB)  ||
@@ -179,10 +185,50 @@ void ThreadLocalAllocBuffer::fill(HeapWord* start,
   assert(top <= start + new_size - alignment_reserve(), "size too small");
   initialize(start, top, start + new_size - alignment_reserve());
 
+  if (AllocationSampler::enabled()) {
+    // Also charge the object the TLAB was refilled for.
+    charge_sampled_bytes(0);
+    set_sample_end();
+  }
+
   // Reset amount of internal fragmentation
   set_refill_waste_limit(initial_refill_waste_limit());
 }
 
+bool ThreadLocalAllocBuffer::charge_sampled_bytes(size_t outside_bytes) {
+  size_t bytes = outside_bytes;
+  if (_sample_start != NULL) {
+    bytes += pointer_delta(top(), _sample_start, 1);
+    _sample_start = top();
+  }
+  if (bytes >= _bytes_until_sample) {
+    _bytes_until_sample = 0;
+    return true;
+  }
+  _bytes_until_sample -= bytes;
+  return false;
+}
+
+// Lower end() to the point where _bytes_until_sample more bytes have been
+// allocated, or leave it at the end of the TLAB if that lies beyond.
+void ThreadLocalAllocBuffer::set_sample_end() {
+  _sample_start = top();
+  set_end(allocation_end());
+  if (top() != NULL) {
+    size_t words_until_sample = _bytes_until_sample / HeapWordSize;
+    if (pointer_delta(allocation_end(), top()) > words_until_sample) {
+      set_end(top() + words_until_sample);
+    }
+  }
+  invariants();
+}
+
+void ThreadLocalAllocBuffer::pick_next_sample() {
+  _sample_distance = AllocationSampler::next_sample_distance();
+  _bytes_until_sample = _sample_distance;
+  set_sample_end();
+}
+
 void ThreadLocalAllocBuffer::initialize(HeapWord* start,
                                         HeapWord* top,
                                         HeapWord* end) {
@@ -190,6 +236,8 @@ void ThreadLocalAllocBuffer::initialize(HeapWord* start,
   set_top(top);
   set_pf_top(top);
   set_end(end);
+  _allocation_end = end;
+  _sample_start = start;
   invariants();
 }
 
@@ -200,6 +248,9 @@ void ThreadLocalAllocBuffer::initialize() {
 
   set_desired_size(initial_desired_size());
 
+  _sample_distance = AllocationSampler::enabled() ? AllocationSampler::next_sample_distance() : 0;
+  _bytes_until_sample = _sample_distance;
+
   // Following check is needed because at startup the main
   // thread is initialized before the heap is.  The initialization for
   // this thread is redone in startup_initialization below.
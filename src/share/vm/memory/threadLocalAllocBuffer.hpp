@@ -46,11 +46,17 @@ private:
   HeapWord* _start;                              // address of TLAB
   HeapWord* _top;                                // address after last allocation
   HeapWord* _pf_top;                             // allocation prefetch watermark
-  HeapWord* _end;                                // allocation end (excluding alignment_reserve)
+  HeapWord* _end;                                // allocation end or sample point (excluding alignment_reserve)
+  HeapWord* _allocation_end;                     // end of the TLAB (excluding alignment_reserve)
   size_t    _desired_size;                       // desired size   (including alignment_reserve)
   size_t    _refill_waste_limit;                 // hold onto tlab if free() is larger than this
   size_t    _allocated_before_last_gc;           // total bytes allocated up until the last gc
 
+  // Allocation site sampling
+  HeapWord* _sample_start;                       // top when the sample end was last set
+  size_t    _bytes_until_sample;                 // bytes left to allocate before the next sample
+  size_t    _sample_distance;                    // bytes accounted to the next sample
+
   static size_t   _max_size;                     // maximum size of any TLAB
   static unsigned _target_refills;               // expected number of refills between GCs
 
@@ -85,7 +91,7 @@ private:
   // Resize based on amount of allocation, etc.
   void resize();
 
-  void invariants() const { assert(top() >= start() && top() <= end(), "invalid tlab"); }
+  void invariants() const { assert(top() >= start() && top() <= end() && end() <= allocation_end(), "invalid tlab"); }
 
   void initialize(HeapWord* start, HeapWord* top, HeapWord* end);
 
@@ -122,13 +128,14 @@ public:
 
   HeapWord* start() const                        { return _start; }
   HeapWord* end() const                          { return _end; }
-  HeapWord* hard_end() const                     { return _end + alignment_reserve(); }
+  HeapWord* allocation_end() const               { return _allocation_end; }
+  HeapWord* hard_end() const                     { return _allocation_end + alignment_reserve(); }
   HeapWord* top() const                          { return _top; }
   HeapWord* pf_top() const                       { return _pf_top; }
   size_t desired_size() const                    { return _desired_size; }
   size_t used() const                            { return pointer_delta(top(), start()); }
   size_t used_bytes() const                      { return pointer_delta(top(), start(), 1); }
-  size_t free() const                            { return pointer_delta(end(), top()); }
+  size_t free() const                            { return pointer_delta(allocation_end(), top()); }
   // Don't discard tlab if remaining space is larger than this.
   size_t refill_waste_limit() const              { return _refill_waste_limit; }
 
@@ -151,6 +158,19 @@ public:
   // Record slow allocation
   inline void record_slow_allocation(size_t obj_size);
 
+  // Allocation site sampling. end() is lowered to the next sample point so
+  // that the allocation crossing it takes the slow path, whether it comes
+  // from the interpreter, C1 or C2 code.
+  bool has_sample_end() const                    { return end() != allocation_end(); }
+  void set_back_allocation_end()                 { set_end(allocation_end()); }
+  size_t sample_distance() const                 { return _sample_distance; }
+  // Charge the bytes allocated since the sample end was set, and those
+  // allocated outside of the TLAB, against the sample distance.
+  // Returns true if the sample point has been reached.
+  bool charge_sampled_bytes(size_t outside_bytes);
+  void set_sample_end();
+  void pick_next_sample();
+
   // Initialization at startup
   static void startup_initialization();
 
@@ -313,7 +313,10 @@ void ConstantPoolCacheEntry::set_method_handle_common(constantPoolHandle cpool,
   const methodHandle adapter = call_info.resolved_method();
   const Handle appendix      = call_info.resolved_appendix();
   const Handle method_type   = call_info.resolved_method_type();
-  const bool has_appendix    = appendix.not_null();
+  // An invokedynamic linked directly to the target of a constant call site
+  // (see DirectLinkConstantCallSites) does not pass its appendix.
+  const bool is_direct       = !adapter->is_method_handle_intrinsic() && !adapter->is_compiled_lambda_form();
+  const bool has_appendix    = appendix.not_null() && !is_direct;
   const bool has_method_type = method_type.not_null();
 
   // Write the flags.
@@ -353,8 +356,9 @@ void ConstantPoolCacheEntry::set_method_handle_common(constantPoolHandle cpool,
   //
 
   objArrayHandle resolved_references = cpool->resolved_references();
-  // Store appendix, if any.
-  if (has_appendix) {
+  // Store appendix, if any. A direct call site stores it only to keep the
+  // target method's class alive.
+  if (appendix.not_null()) {
     const int appendix_index = f2_as_index() + _indy_resolved_references_appendix_offset;
     assert(appendix_index >= 0 && appendix_index < resolved_references->length(), "oob");
     assert(resolved_references->obj_at(appendix_index) == NULL, "init just once");
@@ -336,6 +336,7 @@ InstanceKlass::InstanceKlass(int vtable_len,
 #endif
   set_crc32(0);
   set_bytes_size(0);
+  set_bytes_digest(NULL);
   set_source_file_path(NULL);
 }
 
@@ -2630,6 +2631,10 @@ void InstanceKlass::release_C_heap_structures() {
   // class can't be referenced anymore).
   if (_array_name != NULL)  _array_name->decrement_refcount();
   if (_source_debug_extension != NULL) FREE_C_HEAP_ARRAY(char, _source_debug_extension, mtClass);
+  if (_class_bytes_digest != NULL) {
+    FREE_C_HEAP_ARRAY(u1, _class_bytes_digest, mtClass);
+    _class_bytes_digest = NULL;
+  }
 
   assert(_total_instanceKlass_count >= 1, "Sanity check");
   Atomic::dec(&_total_instanceKlass_count);
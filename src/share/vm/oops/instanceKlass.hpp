@@ -214,6 +214,8 @@ class InstanceKlass: public Klass {
   unsigned int    _crc32;
   // if not using JWarmUP, default value is 0
   unsigned int    _class_bytes_size;
+  // SHA-256 of the class bytes, only with -XX:VerificationCacheFile
+  u1*             _class_bytes_digest;
 
   // CompilationWarmUp eager init support
   bool            _is_jwarmup_recorded;
@@ -680,6 +682,10 @@ class InstanceKlass: public Klass {
   unsigned int bytes_size()                { return _class_bytes_size; }
   void set_bytes_size(unsigned int size)   { _class_bytes_size = size; }
 
+  // VerificationCache support
+  const u1* bytes_digest()                 { return _class_bytes_digest; }
+  void set_bytes_digest(u1* digest)        { _class_bytes_digest = digest; }
+
   bool is_jwarmup_recorded()               { return _is_jwarmup_recorded; }
   void set_jwarmup_recorded(bool value)    { _is_jwarmup_recorded = value; }
 
@@ -62,7 +62,7 @@ void* Symbol::operator new(size_t sz, int len, ClassLoaderData* loader_data, TRA
 }
 
 void Symbol::operator delete(void *p) {
-  assert(((Symbol*)p)->refcount() == 0, "should not call this");
+  assert(((Symbol*)p)->refcount() == 0 || ((Symbol*)p)->is_dead(), "should not call this");
   FreeHeap(p);
 }
 
@@ -217,10 +217,50 @@ void Symbol::increment_refcount() {
   // Only increment the refcount if positive.  If negative either
   // overflow has occurred or it is a permanent symbol in a read only
   // shared archive.
-  if (_refcount >= 0) {
-    Atomic::inc(&_refcount);
-    NOT_PRODUCT(Atomic::inc(&_total_count);)
+  if (!ConcurrentSymbolTableCleaning) {
+    if (_refcount >= 0) {
+      Atomic::inc(&_refcount);
+      NOT_PRODUCT(Atomic::inc(&_total_count);)
+    }
+    return;
+  }
+  // The symbol table may unlink a symbol as soon as its refcount is zero,
+  // so the increment has to be a CAS that can see the dead state.
+  if (!try_increment_refcount()) {
+#ifdef ASSERT
+    print();
+    assert(false, "incrementing the reference count of a reclaimed symbol");
+#endif
+  }
+}
+
+bool Symbol::try_increment_refcount() {
+  volatile jint* word = refcount_word();
+  while (true) {
+    jint old_word = *word;
+    short count = (short)(old_word >> 16);
+    if (count == dead_refcount) {
+      return false;
+    }
+    if (count < 0) {
+      // Permanent or overflowed, not counted any more
+      return true;
+    }
+    if (Atomic::cmpxchg(old_word + 0x10000, word, old_word) == old_word) {
+      NOT_PRODUCT(Atomic::inc(&_total_count);)
+      return true;
+    }
+  }
+}
+
+bool Symbol::try_mark_dead() {
+  volatile jint* word = refcount_word();
+  jint old_word = *word;
+  if ((short)(old_word >> 16) != 0) {
+    return false;
   }
+  jint dead_word = (old_word & 0xffff) | (jint)((juint)(jushort)dead_refcount << 16);
+  return Atomic::cmpxchg(dead_word, word, old_word) == old_word;
 }
 
 void Symbol::decrement_refcount() {
@@ -122,9 +122,17 @@ class Symbol : private SymbolBase {
 
   enum {
     // max_symbol_length is constrained by type of _length
-    max_symbol_length = (1 << 16) -1
+    max_symbol_length = (1 << 16) -1,
+    // Refcount of a symbol the concurrent symbol table cleaning has
+    // unlinked. The symbol is freed at the next safepoint.
+    dead_refcount = -2
   };
 
+  // _refcount is the upper half of this aligned 32-bit word, see ATOMIC_SHORT_PAIR
+  volatile jint* refcount_word() const {
+    return (volatile jint*)((intptr_t)&_refcount & ~(intptr_t)(sizeof(jint) - 1));
+  }
+
   static int size(int length) {
     size_t sz = heap_word_size(sizeof(SymbolBase) + (length > 0 ? length : 0));
     return align_object_size(sz);
@@ -160,6 +168,12 @@ class Symbol : private SymbolBase {
   int refcount() const      { return _refcount; }
   void increment_refcount();
   void decrement_refcount();
+  // Increment unless the symbol table has already unlinked this symbol.
+  // Used by the lock-free symbol table lookups.
+  bool try_increment_refcount();
+  // Claim an unreferenced symbol for reclamation, fails if it got referenced.
+  bool try_mark_dead();
+  bool is_dead() const      { return _refcount == dead_refcount; }
 
   int byte_at(int index) const {
     assert(index >=0 && index < _length, "symbol index overflow");
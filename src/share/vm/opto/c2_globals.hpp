@@ -208,6 +208,11 @@
   product(bool, UseCountedLoopSafepoints, false,                            \
           "Force counted loops to keep a safepoint")                        \
                                                                             \
+  product(uintx, LoopStripMiningIter, 0,                                    \
+          "Number of iterations of a counted loop between safepoint "       \
+          "polls when UseCountedLoopSafepoints is on (0 or 1: poll every "  \
+          "iteration and keep the loop uncounted)")                         \
+                                                                            \
   product(bool, UseLoopPredicate, true,                                     \
           "Generate a predicate to select fast/slow loop versions")         \
                                                                             \
@@ -321,6 +326,9 @@
   product(bool, UseSuperWord, true,                                         \
           "Transform scalar operations into superword operations")          \
                                                                             \
+  product(bool, SuperWordReductions, true,                                  \
+          "Vectorize add and multiply reductions carried by loop phis")     \
+                                                                            \
   develop(bool, SuperWordRTDepCheck, false,                                 \
           "Enable runtime dependency checks.")                              \
                                                                             \
@@ -491,6 +499,12 @@
   product(intx, EliminateAllocationArraySizeLimit, 64,                      \
           "Array size (number of elements) limit for scalar replacement")   \
                                                                             \
+  product(bool, PartialEscapeAnalysis, false,                               \
+          "Recompile with rarely taken branches replaced by uncommon traps "\
+          "when they are the only paths on which an allocation escapes. "   \
+          "Only an approximation of partial escape analysis: allocations "  \
+          "are not sunk and virtual objects are not merged at Phis")        \
+                                                                            \
   product(bool, OptimizePtrCompare, true,                                   \
           "Use escape analysis to optimize pointers compare")               \
                                                                             \
@@ -550,6 +564,12 @@
   product(bool, SpecialEncodeISOArray, true,                                \
           "special version of ISO_8859_1$Encoder.encodeISOArray")           \
                                                                             \
+  product(bool, SpecialStringInflate, true,                                 \
+          "special version of StringLatin1.inflate (CompactStrings)")       \
+                                                                            \
+  product(bool, SpecialStringCompress, true,                                \
+          "special version of StringUTF16.compress (CompactStrings)")       \
+                                                                            \
   develop(bool, BailoutToInterpreterForThrows, false,                       \
           "Compiled methods which throws/catches exceptions will be "       \
           "deopt and intp.")                                                \
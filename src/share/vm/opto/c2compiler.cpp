@@ -52,6 +52,9 @@ const char* C2Compiler::retry_no_escape_analysis() {
 const char* C2Compiler::retry_class_loading_during_parsing() {
   return "retry class loading during parsing";
 }
+const char* C2Compiler::retry_pruning_rare_escape_paths() {
+  return "retry pruning rare escape paths";
+}
 bool C2Compiler::init_c2_runtime() {
 
   // Check assumptions used while running ADLC
@@ -111,9 +114,13 @@ void C2Compiler::compile_method(ciEnv* env, ciMethod* target, int entry_bci) {
   bool subsume_loads = SubsumeLoads;
   bool do_escape_analysis = DoEscapeAnalysis && !env->jvmti_can_access_local_variables();
   bool eliminate_boxing = EliminateAutoBox;
+  // Rarely taken branches on which escape analysis found allocations
+  // escaping; they are parsed as uncommon traps on the next attempt.
+  GrowableArray<Compile::RareBranch> pruned_branches(env->arena(), 4, 0, Compile::RareBranch());
   while (!env->failing()) {
     // Attempt to compile while subsuming loads into machine instructions.
-    Compile C(env, this, target, entry_bci, subsume_loads, do_escape_analysis, eliminate_boxing);
+    Compile C(env, this, target, entry_bci, subsume_loads, do_escape_analysis, eliminate_boxing,
+              PartialEscapeAnalysis ? &pruned_branches : NULL);
 
 
     // Check result and retry if appropriate.
@@ -130,6 +137,11 @@ void C2Compiler::compile_method(ciEnv* env, ciMethod* target, int entry_bci) {
       if (C.failure_reason_is(retry_no_escape_analysis())) {
         assert(do_escape_analysis, "must make progress");
         do_escape_analysis = false;
+        pruned_branches.clear();
+        continue;  // retry
+      }
+      if (C.failure_reason_is(retry_pruning_rare_escape_paths())) {
+        assert(pruned_branches.length() > 0, "must make progress");
         continue;  // retry
       }
       if (C.has_boxed_value()) {
@@ -150,6 +162,7 @@ void C2Compiler::compile_method(ciEnv* env, ciMethod* target, int entry_bci) {
       }
       if (do_escape_analysis) {
         do_escape_analysis = false;
+        pruned_branches.clear();
         continue;  // retry
       }
     }
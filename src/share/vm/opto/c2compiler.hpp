@@ -50,6 +50,7 @@ public:
   static const char* retry_no_subsuming_loads();
   static const char* retry_no_escape_analysis();
   static const char* retry_class_loading_during_parsing();
+  static const char* retry_pruning_rare_escape_paths();
 
   // Print compilation timers and statistics
   void print_timers();
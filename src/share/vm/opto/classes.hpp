@@ -251,6 +251,7 @@ macro(StoreNKlass)
 macro(StrComp)
 macro(StrEquals)
 macro(StrIndexOf)
+macro(StrInflatedCopy)
 macro(SubD)
 macro(SubF)
 macro(SubI)
@@ -298,6 +299,13 @@ macro(URShiftVB)
 macro(URShiftVS)
 macro(URShiftVI)
 macro(URShiftVL)
+macro(AddReductionVI)
+macro(AddReductionVL)
+macro(AddReductionVF)
+macro(AddReductionVD)
+macro(MulReductionVI)
+macro(MulReductionVF)
+macro(MulReductionVD)
 macro(AndV)
 macro(OrV)
 macro(XorV)
@@ -509,6 +509,12 @@ void Compile::print_compile_messages() {
     tty->print_cr("** Bailout: Recompile without boxing elimination       **");
     tty->print_cr("*********************************************************");
   }
+  if (pruned_branch_count() > 0 && PrintOpto) {
+    // Recompiling with rarely taken escaping branches turned into traps
+    tty->print_cr("*********************************************************");
+    tty->print_cr("** Bailout: Recompile with rare escape paths pruned    **");
+    tty->print_cr("*********************************************************");
+  }
   if (env()->break_at_compile()) {
     // Open the debugger when compiling this method.
     tty->print("### Breaking when compiling: ");
@@ -630,7 +636,8 @@ debug_only( int Compile::_debug_idx = 100000; )
 
 
 Compile::Compile( ciEnv* ci_env, C2Compiler* compiler, ciMethod* target, int osr_bci,
-                  bool subsume_loads, bool do_escape_analysis, bool eliminate_boxing )
+                  bool subsume_loads, bool do_escape_analysis, bool eliminate_boxing,
+                  GrowableArray<RareBranch>* pruned_branches )
                 : Phase(Compiler),
                   _env(ci_env),
                   _log(ci_env->log()),
@@ -647,6 +654,7 @@ Compile::Compile( ciEnv* ci_env, C2Compiler* compiler, ciMethod* target, int osr
                   _subsume_loads(subsume_loads),
                   _do_escape_analysis(do_escape_analysis),
                   _eliminate_boxing(eliminate_boxing),
+                  _pruned_branches(pruned_branches),
                   _failure_reason(NULL),
                   _code_buffer("Compile::Fill_buffer"),
                   _orig_pc_slot(0),
@@ -976,6 +984,7 @@ Compile::Compile( ciEnv* ci_env,
     _subsume_loads(true),
     _do_escape_analysis(false),
     _eliminate_boxing(false),
+    _pruned_branches(NULL),
     _failure_reason(NULL),
     _code_buffer("Compile::Fill_buffer"),
     _has_method_handle_invokes(false),
@@ -1169,6 +1178,7 @@ void Compile::Init(int aliaslevel) {
   _predicate_opaqs = new(comp_arena()) GrowableArray<Node*>(comp_arena(), 8,  0, NULL);
   _expensive_nodes = new(comp_arena()) GrowableArray<Node*>(comp_arena(), 8,  0, NULL);
   _range_check_casts = new(comp_arena()) GrowableArray<Node*>(comp_arena(), 8,  0, NULL);
+  _rare_branches = new(comp_arena()) GrowableArray<RareBranch>(comp_arena(), 8,  0, RareBranch());
   register_library_intrinsics();
 }
 
@@ -1931,6 +1941,34 @@ void Compile::remove_range_check_casts(PhaseIterGVN &igvn) {
   assert(range_check_cast_count() == 0, "should be empty");
 }
 
+Compile::RareBranch::RareBranch(ciMethod* method, int bci, Node* proj)
+  : _method(method), _bci(bci), _proj(proj), _proj_idx(proj == NULL ? 0 : proj->_idx) {}
+
+void Compile::record_rare_branch(ciMethod* method, int bci, Node* proj) {
+  assert(proj->is_IfTrue() || proj->is_IfFalse(), "rare paths start at a branch projection");
+  _rare_branches->append(RareBranch(method, bci, proj));
+}
+
+bool Compile::is_pruned_branch(ciMethod* method, int bci) const {
+  if (_pruned_branches == NULL) {
+    return false;
+  }
+  for (int i = 0; i < _pruned_branches->length(); i++) {
+    const RareBranch* rb = _pruned_branches->adr_at(i);
+    if (rb->_method == method && rb->_bci == bci) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Compile::add_pruned_branch(ciMethod* method, int bci) {
+  assert(_pruned_branches != NULL, "only for normal compilations");
+  if (!is_pruned_branch(method, bci)) {
+    _pruned_branches->append(RareBranch(method, bci, NULL));
+  }
+}
+
 // StringOpts and late inlining of string methods
 void Compile::inline_string_calls(bool parse_time) {
   {
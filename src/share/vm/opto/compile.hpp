@@ -114,6 +114,22 @@ class Compile : public Phase {
     ~TracePhase();
   };
 
+  // A conditional branch that the profile says is rarely taken, named by
+  // the method and bci of the bytecode that tests it.  The parser records
+  // the projection that starts each such path; escape analysis looks for
+  // allocations escaping only on these paths and asks for a recompilation
+  // in which they are replaced by uncommon traps.
+  class RareBranch {
+   public:
+    ciMethod* _method;
+    int       _bci;
+    Node*     _proj;        // first control node on the rare path
+    uint      _proj_idx;    // _idx of _proj, to detect a dead projection
+
+    RareBranch() : _method(NULL), _bci(InvocationEntryBci), _proj(NULL), _proj_idx(0) {}
+    RareBranch(ciMethod* method, int bci, Node* proj);
+  };
+
   // Information per category of alias (memory slice)
   class AliasType {
    private:
@@ -338,6 +354,8 @@ class Compile : public Phase {
   GrowableArray<Node*>* _predicate_opaqs;       // List of Opaque1 nodes for the loop predicates.
   GrowableArray<Node*>* _expensive_nodes;       // List of nodes that are expensive to compute and that we'd better not let the GVN freely common
   GrowableArray<Node*>* _range_check_casts;     // List of CastII nodes with a range check dependency
+  GrowableArray<RareBranch>* _rare_branches;    // Rarely taken branches seen by the parser
+  GrowableArray<RareBranch>* _pruned_branches;  // Rare branches to parse as uncommon traps (owned by C2Compiler)
   ConnectionGraph*      _congraph;
 #ifndef PRODUCT
   IdealGraphPrinter*    _printer;
@@ -710,6 +728,20 @@ class Compile : public Phase {
   // Remove all range check dependent CastIINodes.
   void  remove_range_check_casts(PhaseIterGVN &igvn);
 
+  // Rarely taken branches, see RareBranch.
+  void record_rare_branch(ciMethod* method, int bci, Node* proj);
+  int  rare_branch_count()                  const { return _rare_branches->length(); }
+  const RareBranch* rare_branch(int idx)    const { return _rare_branches->adr_at(idx); }
+  bool is_pruned_branch(ciMethod* method, int bci) const;
+  // Only the first attempt may ask for a recompilation with pruned branches.
+  bool can_prune_rare_branches() const {
+    return _pruned_branches != NULL && _pruned_branches->is_empty();
+  }
+  void add_pruned_branch(ciMethod* method, int bci);
+  int  pruned_branch_count() const {
+    return (_pruned_branches == NULL) ? 0 : _pruned_branches->length();
+  }
+
   // remove the opaque nodes that protect the predicates so that the unused checks and
   // uncommon traps will be eliminated from the graph.
   void cleanup_loop_predicates(PhaseIterGVN &igvn);
@@ -1040,7 +1072,7 @@ class Compile : public Phase {
   // continuation.
   Compile(ciEnv* ci_env, C2Compiler* compiler, ciMethod* target,
           int entry_bci, bool subsume_loads, bool do_escape_analysis,
-          bool eliminate_boxing);
+          bool eliminate_boxing, GrowableArray<RareBranch>* pruned_branches = NULL);
 
   // Second major entry point.  From the TypeFunc signature, generate code
   // to pass arguments from the Java calling convention to the C calling
@@ -217,6 +217,7 @@ bool ConnectionGraph::compute_escape() {
                                  java_objects_worklist, oop_fields_worklist)) {
     // All objects escaped or hit time or iterations limits.
     _collecting = false;
+    prune_rare_escape_paths(java_objects_worklist);
     return false;
   }
 
@@ -242,6 +243,13 @@ bool ConnectionGraph::compute_escape() {
     }
   }
 
+  // Allocations that escape only on rarely taken branches can be scalar
+  // replaced after a recompilation which turns those branches into traps.
+  if (prune_rare_escape_paths(java_objects_worklist)) {
+    _collecting = false;
+    return false;
+  }
+
 #ifdef ASSERT
   if (VerifyConnectionGraph) {
     // Verify that graph is complete - no new edges could be added or needed.
@@ -309,6 +317,209 @@ bool ConnectionGraph::compute_escape() {
   return has_non_escaping_obj;
 }
 
+// Partial escape analysis.  An allocation which escapes only on branches
+// the profile says are rarely taken is not scalar replaceable in the graph
+// as parsed.  If all its other uses are ones scalar replacement can deal
+// with, record those branches and bail out; the next attempt parses them
+// as uncommon traps (see Parse::adjust_map_after_if()) and the allocation
+// becomes a regular candidate.  The object is rematerialized from its
+// scalar replaced fields if a trap is ever hit.
+bool ConnectionGraph::prune_rare_escape_paths(GrowableArray<JavaObjectNode*>& java_objects_worklist) {
+  Compile* C = _compile;
+  if (!C->can_prune_rare_branches() || C->rare_branch_count() == 0) {
+    return false;
+  }
+  GrowableArray<int> rare_branches;
+  int java_objects_length = java_objects_worklist.length();
+  for (int next = 0; next < java_objects_length; next++) {
+    JavaObjectNode* ptn = java_objects_worklist.at(next);
+    Node* n = ptn->ideal_node();
+    if (!n->is_Allocate() ||
+        (ptn->escape_state() == PointsToNode::NoEscape && ptn->scalar_replaceable())) {
+      continue; // Not an allocation or already a scalar replacement candidate.
+    }
+    AllocateNode* alloc = n->as_Allocate();
+    if (!can_be_scalar_replaced(alloc)) {
+      continue;
+    }
+    GrowableArray<int> alloc_rare_branches;
+    if (is_on_rare_path(alloc, alloc, NULL, alloc_rare_branches)) {
+      continue; // The allocation itself is on a rare path.
+    }
+    Node* res = alloc->result_cast();
+    if (res == NULL) {
+      continue;
+    }
+    int rare_length = rare_branches.length();
+    if (!escapes_only_on_rare_paths(alloc, res, rare_branches)) {
+      rare_branches.trunc_to(rare_length);
+    }
+  }
+  if (rare_branches.length() == 0) {
+    return false;
+  }
+  for (int i = 0; i < rare_branches.length(); i++) {
+    const Compile::RareBranch* rb = C->rare_branch(rare_branches.at(i));
+    C->add_pruned_branch(rb->_method, rb->_bci);
+    if (C->log() != NULL) {
+      C->log()->elem("rare_escape_path method='%d' bci='%d'",
+                     C->log()->identify(rb->_method), rb->_bci);
+    }
+#ifndef PRODUCT
+    if (PrintEscapeAnalysis) {
+      tty->print("=== Pruning rare escape path at bci %d in ", rb->_bci);
+      rb->_method->print_short_name();
+      tty->cr();
+    }
+#endif
+  }
+  C->record_failure(C2Compiler::retry_pruning_rare_escape_paths());
+  return true;
+}
+
+// Same checks as in add_call_node() for objects which are never
+// scalar replaced because of their class or size.
+bool ConnectionGraph::can_be_scalar_replaced(AllocateNode* alloc) {
+  Node* k = alloc->in(AllocateNode::KlassNode);
+  const TypeKlassPtr* kt = k->bottom_type()->isa_klassptr();
+  if (kt == NULL) {
+    return false;
+  }
+  ciKlass* cik = kt->klass();
+  if (alloc->is_AllocateArray()) {
+    if (!cik->is_array_klass()) {
+      return false;
+    }
+    int length = alloc->in(AllocateNode::ALength)->find_int_con(-1);
+    return (length >= 0 && length <= EliminateAllocationArraySizeLimit);
+  }
+  return !(cik->is_subclass_of(_compile->env()->Thread_klass()) ||
+           cik->is_subclass_of(_compile->env()->Reference_klass()) ||
+           !cik->is_instance_klass() ||
+           cik->as_instance_klass()->has_finalizer());
+}
+
+// Returns true if the object produced by 'alloc' is only used in ways
+// scalar replacement can handle, except for uses on rarely taken paths,
+// and there is at least one such use.  Indexes of the rare branches
+// involved are appended to 'rare_branches'.
+bool ConnectionGraph::escapes_only_on_rare_paths(AllocateNode* alloc, Node* res,
+                                                 GrowableArray<int>& rare_branches) {
+  bool found = false;
+  Unique_Node_List ptrs;  // Result of the allocation and its casts.
+  ptrs.push(res);
+  for (uint i = 0; i < ptrs.size(); i++) {
+    Node* p = ptrs.at(i);
+    for (DUIterator_Fast jmax, j = p->fast_outs(jmax); j < jmax; j++) {
+      Node* use = p->fast_out(j);
+      if (use->Opcode() == Op_CastPP || use->is_CheckCastPP() || use->is_EncodeP()) {
+        ptrs.push(use);
+        continue;
+      }
+      if (use->is_AddP()) {
+        if (is_field_address(use)) {
+          continue;
+        }
+      } else if (use->is_SafePoint()) {
+        if (use->is_AbstractLock() ||
+            !use->is_Call() || !use->as_Call()->has_non_debug_use(p)) {
+          continue; // Debug info or a lock which can be eliminated.
+        }
+      } else if (use->Opcode() == Op_CmpP || use->Opcode() == Op_CmpN ||
+                 use->is_MemBar()) {
+        continue;
+      }
+      // The object escapes through this use unless it is on a rare path.
+      if (!is_on_rare_path(alloc, use, p, rare_branches)) {
+        return false;
+      }
+      found = true;
+    }
+  }
+  return found;
+}
+
+// Address of a field or element of a new object: only used to load and
+// store values which are not the address itself.
+bool ConnectionGraph::is_field_address(Node* addp) {
+  for (DUIterator_Fast imax, i = addp->fast_outs(imax); i < imax; i++) {
+    Node* use = addp->fast_out(i);
+    if (use->is_AddP()) {
+      if (use->in(AddPNode::Address) != addp || !is_field_address(use)) {
+        return false;
+      }
+    } else if (use->is_Load()) {
+      if (use->in(MemNode::Address) != addp) {
+        return false;
+      }
+    } else if (use->is_Store()) {
+      if (use->in(MemNode::Address) != addp || use->in(MemNode::ValueIn) == addp) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Walk the control graph up from 'use' and check that every path to it
+// passes through a rarely taken branch recorded by the parser before it
+// reaches the allocation.  'p' is the input of 'use' being examined.
+bool ConnectionGraph::is_on_rare_path(AllocateNode* alloc, Node* use, Node* p,
+                                      GrowableArray<int>& rare_branches) {
+  const uint visit_limit = 1000;
+  Compile* C = _compile;
+  Node_List stack;
+  if (use->is_Phi()) {
+    // Only the region paths on which the object flows into the phi.
+    Node* region = use->in(0);
+    if (region == NULL) {
+      return false;
+    }
+    for (uint k = 1; k < use->req(); k++) {
+      if (use->in(k) == p) {
+        stack.push(region->in(k));
+      }
+    }
+  } else if (use->in(0) != NULL) {
+    stack.push(use->in(0));
+  } else {
+    return false; // Floating node: position unknown.
+  }
+  VectorSet visited(Thread::current()->resource_area());
+  uint visit_count = 0;
+  while (stack.size() > 0) {
+    Node* c = stack.pop();
+    if (c == NULL || c->is_top() || visited.test_set(c->_idx)) {
+      continue; // Dead path or already seen.
+    }
+    if (++visit_count > visit_limit || c == alloc || c->is_Start() || c->is_Root()) {
+      return false;
+    }
+    int rare = -1;
+    for (int i = 0; i < C->rare_branch_count(); i++) {
+      const Compile::RareBranch* rb = C->rare_branch(i);
+      if (rb->_proj == c && rb->_proj_idx == c->_idx) {
+        rare = i;
+        break;
+      }
+    }
+    if (rare >= 0) {
+      rare_branches.append_if_missing(rare);
+      continue;
+    }
+    if (c->is_Region()) {
+      for (uint k = 1; k < c->req(); k++) {
+        stack.push(c->in(k));
+      }
+    } else {
+      stack.push(c->in(0));
+    }
+  }
+  return true;
+}
+
 // Utility function for nodes that load an object
 void ConnectionGraph::add_objload_to_connection_graph(Node *n, Unique_Node_List *delayed_worklist) {
   // Using isa_ptr() instead of isa_oopptr() for LoadP and Phi because
@@ -556,6 +767,7 @@ void ConnectionGraph::add_node_to_connection_graph(Node *n, Unique_Node_List *de
     case Op_StrComp:
     case Op_StrEquals:
     case Op_StrIndexOf:
+    case Op_StrInflatedCopy:
     case Op_EncodeISOArray: {
       add_local_var(n, PointsToNode::ArgEscape);
       delayed_worklist->push(n); // Process it later.
@@ -739,6 +951,7 @@ void ConnectionGraph::add_final_edges(Node *n) {
     case Op_StrComp:
     case Op_StrEquals:
     case Op_StrIndexOf:
+    case Op_StrInflatedCopy:
     case Op_EncodeISOArray: {
       // char[] arrays passed to string intrinsic do not escape but
       // they are not scalar replaceable. Adjust escape state for them.
@@ -2698,7 +2911,7 @@ Node* ConnectionGraph::find_inst_mem(Node *orig_mem, int alias_idx, GrowableArra
       if (mem->is_LoadStore()) {
         adr = mem->in(MemNode::Address);
       } else {
-        assert(mem->Opcode() == Op_EncodeISOArray, "sanity");
+        assert(mem->Opcode() == Op_EncodeISOArray || mem->Opcode() == Op_StrInflatedCopy, "sanity");
         adr = mem->in(3); // Memory edge corresponds to destination array
       }
       const Type *at = igvn->type(adr);
@@ -3062,9 +3275,9 @@ void ConnectionGraph::split_unique_types(GrowableArray<Node *>  &alloc_worklist)
         if (m->is_MergeMem()) {
           assert(_mergemem_worklist.contains(m->as_MergeMem()), "EA: missing MergeMem node in the worklist");
         }
-      } else if (use->Opcode() == Op_EncodeISOArray) {
+      } else if (use->Opcode() == Op_EncodeISOArray || use->Opcode() == Op_StrInflatedCopy) {
         if (use->in(MemNode::Memory) == n || use->in(3) == n) {
-          // EncodeISOArray overwrites destination array
+          // EncodeISOArray and StrInflatedCopy overwrite destination array
           memnode_worklist.append_if_missing(use);
         }
       } else {
@@ -3102,7 +3315,7 @@ void ConnectionGraph::split_unique_types(GrowableArray<Node *>  &alloc_worklist)
       n = n->as_MemBar()->proj_out(TypeFunc::Memory);
       if (n == NULL)
         continue;
-    } else if (n->Opcode() == Op_EncodeISOArray) {
+    } else if (n->Opcode() == Op_EncodeISOArray || n->Opcode() == Op_StrInflatedCopy) {
       // get the memory projection
       for (DUIterator_Fast imax, i = n->fast_outs(imax); i < imax; i++) {
         Node *use = n->fast_out(i);
@@ -3162,9 +3375,9 @@ void ConnectionGraph::split_unique_types(GrowableArray<Node *>  &alloc_worklist)
         assert(use->in(MemNode::Memory) != n, "EA: missing memory path");
       } else if (use->is_MergeMem()) {
         assert(_mergemem_worklist.contains(use->as_MergeMem()), "EA: missing MergeMem node in the worklist");
-      } else if (use->Opcode() == Op_EncodeISOArray) {
+      } else if (use->Opcode() == Op_EncodeISOArray || use->Opcode() == Op_StrInflatedCopy) {
         if (use->in(MemNode::Memory) == n || use->in(3) == n) {
-          // EncodeISOArray overwrites destination array
+          // EncodeISOArray and StrInflatedCopy overwrite destination array
           memnode_worklist.append_if_missing(use);
         }
       } else {
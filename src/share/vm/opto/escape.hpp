@@ -456,6 +456,16 @@ private:
   // Adjust scalar_replaceable state after Connection Graph is built.
   void adjust_scalar_replaceable_state(JavaObjectNode* jobj);
 
+  // Find allocations which escape only on rarely taken branches and ask
+  // for a recompilation with those branches replaced by uncommon traps.
+  bool prune_rare_escape_paths(GrowableArray<JavaObjectNode*>& java_objects_worklist);
+  bool can_be_scalar_replaced(AllocateNode* alloc);
+  bool escapes_only_on_rare_paths(AllocateNode* alloc, Node* res,
+                                  GrowableArray<int>& rare_branches);
+  bool is_field_address(Node* addp);
+  bool is_on_rare_path(AllocateNode* alloc, Node* use, Node* p,
+                       GrowableArray<int>& rare_branches);
+
   // Optimize ideal graph.
   void optimize_ideal_graph(GrowableArray<Node*>& ptr_cmp_worklist,
                             GrowableArray<Node*>& storestore_worklist);
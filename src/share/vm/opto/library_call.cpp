@@ -203,6 +203,10 @@ class LibraryCallKit : public GraphKit {
   bool inline_string_indexOf();
   Node* string_indexOf(Node* string_object, ciTypeArray* target_array, jint offset, jint cache_i, jint md2_i);
   bool inline_string_equals();
+  bool inline_string_compareL();
+  bool inline_string_indexOfL();
+  bool inline_string_inflate();
+  bool inline_string_compress();
   Node* round_double_node(Node* n);
   bool runtime_math(const TypeFunc* call_type, address funcAddr, const char* funcName);
   bool inline_math_native(vmIntrinsics::ID id);
@@ -249,7 +253,7 @@ class LibraryCallKit : public GraphKit {
   bool inline_native_newArray();
   bool inline_native_getLength();
   bool inline_array_copyOf(bool is_copyOfRange);
-  bool inline_array_equals();
+  bool inline_array_equals(StrIntrinsicNode::ArgEncoding encoding);
   void copy_to_clone(Node* obj, Node* alloc_obj, Node* obj_size, bool is_array, bool card_mark);
   bool inline_native_clone(bool is_virtual);
   bool inline_native_Reflection_getCallerClass();
@@ -376,6 +380,10 @@ CallGenerator* Compile::make_vm_intrinsic(ciMethod* m, bool is_virtual) {
     case vmIntrinsics::_compareTo:
     case vmIntrinsics::_equals:
     case vmIntrinsics::_equalsC:
+    case vmIntrinsics::_equalsB:
+    case vmIntrinsics::_equalsL:
+    case vmIntrinsics::_compareToL:
+    case vmIntrinsics::_indexOfL:
     case vmIntrinsics::_getAndAddInt:
     case vmIntrinsics::_getAndAddLong:
     case vmIntrinsics::_getAndSetInt:
@@ -399,18 +407,48 @@ CallGenerator* Compile::make_vm_intrinsic(ciMethod* m, bool is_virtual) {
   case vmIntrinsics::_compareTo:
     if (!SpecialStringCompareTo)  return NULL;
     if (!Matcher::match_rule_supported(Op_StrComp))  return NULL;
+    // The String intrinsics below assume the char[] value/offset/count layout.
+    if (java_lang_String::has_coder_field())  return NULL;
     break;
   case vmIntrinsics::_indexOf:
     if (!SpecialStringIndexOf)  return NULL;
+    if (java_lang_String::has_coder_field())  return NULL;
     break;
   case vmIntrinsics::_equals:
     if (!SpecialStringEquals)  return NULL;
     if (!Matcher::match_rule_supported(Op_StrEquals))  return NULL;
+    if (java_lang_String::has_coder_field())  return NULL;
     break;
   case vmIntrinsics::_equalsC:
     if (!SpecialArraysEquals)  return NULL;
     if (!Matcher::match_rule_supported(Op_AryEq))  return NULL;
     break;
+  case vmIntrinsics::_equalsB:
+  case vmIntrinsics::_equalsL:
+    if (!SpecialArraysEquals)  return NULL;
+    if (!Matcher::match_rule_supported(Op_AryEq))  return NULL;
+    if (!Matcher::has_latin1_string_intrinsics())  return NULL;
+    break;
+  case vmIntrinsics::_compareToL:
+    if (!SpecialStringCompareTo)  return NULL;
+    if (!Matcher::match_rule_supported(Op_StrComp))  return NULL;
+    if (!Matcher::has_latin1_string_intrinsics())  return NULL;
+    break;
+  case vmIntrinsics::_indexOfL:
+    if (!SpecialStringIndexOf)  return NULL;
+    if (!UseSSE42Intrinsics)  return NULL;
+    if (!Matcher::match_rule_supported(Op_StrIndexOf))  return NULL;
+    if (!Matcher::has_latin1_string_intrinsics())  return NULL;
+    break;
+  case vmIntrinsics::_inflateStringB:
+    if (!SpecialStringInflate)  return NULL;
+    if (!Matcher::match_rule_supported(Op_StrInflatedCopy))  return NULL;
+    if (!Matcher::has_latin1_string_intrinsics())  return NULL;
+    break;
+  case vmIntrinsics::_compressStringC:
+    if (!SpecialStringCompress)  return NULL;
+    if (!Matcher::match_rule_supported(Op_EncodeISOArray))  return NULL;
+    break;
   case vmIntrinsics::_arraycopy:
     if (!InlineArrayCopy)  return NULL;
     break;
@@ -800,6 +838,10 @@ bool LibraryCallKit::try_to_inline(int predicate) {
   case vmIntrinsics::_compareTo:                return inline_string_compareTo();
   case vmIntrinsics::_indexOf:                  return inline_string_indexOf();
   case vmIntrinsics::_equals:                   return inline_string_equals();
+  case vmIntrinsics::_compareToL:               return inline_string_compareL();
+  case vmIntrinsics::_indexOfL:                 return inline_string_indexOfL();
+  case vmIntrinsics::_inflateStringB:           return inline_string_inflate();
+  case vmIntrinsics::_compressStringC:          return inline_string_compress();
 
   case vmIntrinsics::_getObject:                return inline_unsafe_access(!is_native_ptr, !is_store, T_OBJECT,  !is_volatile, false);
   case vmIntrinsics::_getBoolean:               return inline_unsafe_access(!is_native_ptr, !is_store, T_BOOLEAN, !is_volatile, false);
@@ -898,7 +940,9 @@ bool LibraryCallKit::try_to_inline(int predicate) {
   case vmIntrinsics::_getLength:                return inline_native_getLength();
   case vmIntrinsics::_copyOf:                   return inline_array_copyOf(false);
   case vmIntrinsics::_copyOfRange:              return inline_array_copyOf(true);
-  case vmIntrinsics::_equalsC:                  return inline_array_equals();
+  case vmIntrinsics::_equalsC:                  return inline_array_equals(StrIntrinsicNode::UU);
+  case vmIntrinsics::_equalsB:
+  case vmIntrinsics::_equalsL:                  return inline_array_equals(StrIntrinsicNode::LL);
   case vmIntrinsics::_clone:                    return inline_native_clone(intrinsic()->is_virtual());
 
   case vmIntrinsics::_isAssignableFrom:         return inline_native_subtype_check();
@@ -1256,6 +1300,27 @@ bool LibraryCallKit::inline_string_compareTo() {
   return true;
 }
 
+//------------------------------inline_string_compareL------------------------
+// static int java.lang.StringLatin1.compareTo(byte[] value, byte[] other);
+bool LibraryCallKit::inline_string_compareL() {
+  Node* value = null_check(argument(0));
+  Node* other = null_check(argument(1));
+  if (stopped()) {
+    return true;
+  }
+  Node* value_start = array_element_address(value, intcon(0), T_BYTE);
+  Node* value_len   = load_array_length(value);
+  Node* other_start = array_element_address(other, intcon(0), T_BYTE);
+  Node* other_len   = load_array_length(other);
+
+  Node* result = new (C) StrCompNode(control(), memory(TypeAryPtr::BYTES),
+                                     value_start, value_len, other_start, other_len,
+                                     StrIntrinsicNode::LL);
+  C->set_has_split_ifs(true); // Has chance for split-if optimization
+  set_result(_gvn.transform(result));
+  return true;
+}
+
 //------------------------------inline_string_equals------------------------
 bool LibraryCallKit::inline_string_equals() {
   Node* receiver = null_check_receiver();
@@ -1351,10 +1416,13 @@ bool LibraryCallKit::inline_string_equals() {
 }
 
 //------------------------------inline_array_equals----------------------------
-bool LibraryCallKit::inline_array_equals() {
+// Arrays.equals(char[], char[]) for UU, Arrays.equals(byte[], byte[]) and
+// StringLatin1.equals(byte[], byte[]) for LL
+bool LibraryCallKit::inline_array_equals(StrIntrinsicNode::ArgEncoding encoding) {
   Node* arg1 = argument(0);
   Node* arg2 = argument(1);
-  set_result(_gvn.transform(new (C) AryEqNode(control(), memory(TypeAryPtr::CHARS), arg1, arg2)));
+  const TypeAryPtr* mtype = (encoding == StrIntrinsicNode::LL) ? TypeAryPtr::BYTES : TypeAryPtr::CHARS;
+  set_result(_gvn.transform(new (C) AryEqNode(control(), memory(mtype), arg1, arg2, encoding)));
   return true;
 }
 
@@ -1643,6 +1711,70 @@ bool LibraryCallKit::inline_string_indexOf() {
   return true;
 }
 
+//------------------------------inline_string_indexOfL------------------------
+// static int java.lang.StringLatin1.indexOf(byte[] src, int srcCount,
+//                                           byte[] tgt, int tgtCount, int fromIndex);
+// The caller guarantees 0 <= fromIndex <= srcCount and that both counts are
+// within the array bounds, as it does for the char[] String.indexOf helper.
+bool LibraryCallKit::inline_string_indexOfL() {
+  Node* src        = null_check(argument(0));
+  Node* src_count  = argument(1);
+  Node* tgt        = null_check(argument(2));
+  Node* tgt_count  = argument(3);
+  Node* from_index = argument(4);
+  if (stopped()) {
+    return true;
+  }
+
+  Node* src_start = array_element_address(src, from_index, T_BYTE);
+  Node* tgt_start = array_element_address(tgt, intcon(0), T_BYTE);
+  // Number of bytes left to search
+  Node* count = _gvn.transform(new (C) SubINode(src_count, from_index));
+
+  // 3 paths: tgt longer than what is left, empty tgt, search
+  RegionNode* result_rgn = new (C) RegionNode(4);
+  Node*       result_phi = new (C) PhiNode(result_rgn, TypeInt::INT);
+
+  // tgt_count > count => -1
+  Node* cmp = _gvn.transform(new (C) CmpINode(tgt_count, count));
+  Node* bol = _gvn.transform(new (C) BoolNode(cmp, BoolTest::gt));
+  Node* if_gt = generate_slow_guard(bol, NULL);
+  if (if_gt != NULL) {
+    result_phi->init_req(1, intcon(-1));
+    result_rgn->init_req(1, if_gt);
+  }
+
+  // tgt_count == 0 => fromIndex
+  if (!stopped()) {
+    cmp = _gvn.transform(new (C) CmpINode(tgt_count, intcon(0)));
+    bol = _gvn.transform(new (C) BoolNode(cmp, BoolTest::eq));
+    Node* if_zero = generate_slow_guard(bol, NULL);
+    if (if_zero != NULL) {
+      result_phi->init_req(2, from_index);
+      result_rgn->init_req(2, if_zero);
+    }
+  }
+
+  if (!stopped()) {
+    Node* result = new (C) StrIndexOfNode(control(), memory(TypeAryPtr::BYTES),
+                                          src_start, count, tgt_start, tgt_count,
+                                          StrIntrinsicNode::LL);
+    result = _gvn.transform(result);
+    C->set_has_split_ifs(true); // Has chance for split-if optimization
+    // The node returns the index relative to fromIndex, or -1
+    Node* found = _gvn.transform(new (C) AddINode(result, from_index));
+    cmp = _gvn.transform(new (C) CmpINode(result, intcon(-1)));
+    bol = _gvn.transform(new (C) BoolNode(cmp, BoolTest::eq));
+    Node* res = _gvn.transform(CMoveNode::make(C, NULL, bol, found, intcon(-1), TypeInt::INT));
+    result_phi->init_req(3, res);
+    result_rgn->init_req(3, control());
+  }
+  set_control(_gvn.transform(result_rgn));
+  record_for_igvn(result_rgn);
+  set_result(_gvn.transform(result_phi));
+  return true;
+}
+
 //--------------------------round_double_node--------------------------------
 // Round a double node if necessary.
 Node* LibraryCallKit::round_double_node(Node* n) {
@@ -5834,6 +5966,64 @@ bool LibraryCallKit::inline_encodeISOArray() {
   return true;
 }
 
+//-------------inline_string_inflate-----------------------------------
+// static void java.lang.StringLatin1.inflate(byte[] src, int srcOff,
+//                                            char[] dst, int dstOff, int len);
+// Like encodeISOArray the trusted caller has already checked the ranges.
+bool LibraryCallKit::inline_string_inflate() {
+  assert(callee()->signature()->size() == 5, "inflate has 5 parameters");
+  Node* src        = argument(0);
+  Node* src_offset = argument(1);
+  Node* dst        = argument(2);
+  Node* dst_offset = argument(3);
+  Node* length     = argument(4);
+
+  const TypeAryPtr* top_src  = src->Value(&_gvn)->isa_aryptr();
+  const TypeAryPtr* top_dest = dst->Value(&_gvn)->isa_aryptr();
+  if (top_src  == NULL || top_src->klass()  == NULL ||
+      top_dest == NULL || top_dest->klass() == NULL) {
+    // failed array check
+    return false;
+  }
+  BasicType src_elem = top_src->klass()->as_array_klass()->element_type()->basic_type();
+  BasicType dst_elem = top_dest->klass()->as_array_klass()->element_type()->basic_type();
+  if (src_elem != T_BYTE || dst_elem != T_CHAR) {
+    return false;
+  }
+  Node* src_start = array_element_address(src, src_offset, T_BYTE);
+  Node* dst_start = array_element_address(dst, dst_offset, T_CHAR);
+
+  // The copy reads the byte[] slice and writes the char[] slice, so it
+  // takes both: stores to the source must be ordered before it.
+  MergeMemNode* mem = MergeMemNode::make(C, map()->memory());
+  record_for_igvn(mem);
+  mem->set_memory_at(C->get_alias_index(TypeAryPtr::BYTES), memory(TypeAryPtr::BYTES));
+  mem->set_memory_at(C->get_alias_index(TypeAryPtr::CHARS), memory(TypeAryPtr::CHARS));
+
+  Node* inf = new (C) StrInflatedCopyNode(control(), mem, src_start, dst_start, length);
+  inf = _gvn.transform(inf);
+  Node* res_mem = _gvn.transform(new (C) SCMemProjNode(inf));
+  set_memory(res_mem, TypeAryPtr::CHARS);
+  return true;
+}
+
+//-------------inline_string_compress-----------------------------------
+// static int java.lang.StringUTF16.compress(char[] src, int srcOff,
+//                                           byte[] dst, int dstOff, int len);
+// Returns len if every char fits in Latin-1, 0 otherwise. This is the
+// EncodeISOArray loop with the result folded to the all-or-nothing answer.
+bool LibraryCallKit::inline_string_compress() {
+  if (!inline_encodeISOArray()) {
+    return false;
+  }
+  Node* enc = result();
+  Node* length = argument(4);
+  Node* cmp = _gvn.transform(new (C) CmpINode(enc, length));
+  Node* bol = _gvn.transform(new (C) BoolNode(cmp, BoolTest::eq));
+  set_result(_gvn.transform(CMoveNode::make(C, NULL, bol, intcon(0), length, TypeInt::INT)));
+  return true;
+}
+
 //-------------inline_multiplyToLen-----------------------------------
 bool LibraryCallKit::inline_multiplyToLen() {
   assert(UseMultiplyToLenIntrinsic, "not implementated on this platform");
@@ -59,6 +59,8 @@ void LoopNode::dump_spec(outputStream *st) const {
   if (is_inner_loop()) st->print( "inner " );
   if (is_partial_peel_loop()) st->print( "partial_peel " );
   if (partial_peel_has_failed()) st->print( "partial_peel_failed " );
+  if (is_strip_mined()) st->print( "strip_mined " );
+  if (is_strip_mined_outer()) st->print( "strip_mined_outer " );
 }
 #endif
 
@@ -269,6 +271,10 @@ bool PhaseIdealLoop::is_counted_loop( Node *x, IdealLoopTree *loop ) {
   if (x->in(LoopNode::Self) == NULL || x->req() != 3 || loop->_irreducible) {
     return false;
   }
+  // The outer loop of a strip mined loop is what keeps the safepoint poll
+  if (x->is_Loop() && x->as_Loop()->is_strip_mined_outer()) {
+    return false;
+  }
   Node *init_control = x->in(LoopNode::EntryControl);
   Node *back_control = x->in(LoopNode::LoopBackControl);
   if (init_control == NULL || back_control == NULL)    // Partially dead
@@ -278,14 +284,16 @@ bool PhaseIdealLoop::is_counted_loop( Node *x, IdealLoopTree *loop ) {
     return false;
 
   // Allow funny placement of Safepoint
+  Node* loop_sfpt = NULL;
   if (back_control->Opcode() == Op_SafePoint) {
-    if (UseCountedLoopSafepoints) {
+    if (UseCountedLoopSafepoints && LoopStripMiningIter <= 1) {
       // Leaving the safepoint on the backedge and creating a
       // CountedLoop will confuse optimizations. We can't move the
       // safepoint around because its jvm state wouldn't match a new
       // location. Give up on that loop.
       return false;
     }
+    loop_sfpt = back_control;
     back_control = back_control->in(TypeFunc::Control);
   }
 
@@ -457,6 +465,38 @@ bool PhaseIdealLoop::is_counted_loop( Node *x, IdealLoopTree *loop ) {
     }
   }
 
+  // With UseCountedLoopSafepoints the loop keeps polling.  If strip mining
+  // is enabled the poll moves to an outer loop which runs this loop in
+  // chunks of LoopStripMiningIter iterations; a loop that can not run
+  // longer than one chunk simply loses its poll.
+  bool remove_sfpt = !UseCountedLoopSafepoints;
+  bool strip_mine = false;
+  if (UseCountedLoopSafepoints && LoopStripMiningIter > 1 && LoopLimitCheck) {
+    if (loop_sfpt == NULL && iff->in(0)->Opcode() == Op_SafePoint) {
+      loop_sfpt = iff->in(0);
+    }
+    if (loop_sfpt != NULL && !loop->_has_call && is_deleteable_safept(loop_sfpt)) {
+      jlong stride_abs = stride_con > 0 ? (jlong)stride_con : -(jlong)stride_con;
+      jlong chunk = (jlong)LoopStripMiningIter * stride_abs;
+      jlong span = stride_con > 0 ? (jlong)limit_t->_hi - init_t->_lo
+                                  : (jlong)init_t->_hi - limit_t->_lo;
+      // The exit test must become '<' or '>' (see the canonicalization below)
+      bool ordered = bt != BoolTest::ne ||
+                     (stride_con > 0 && init_t->_hi < limit_t->_lo) ||
+                     (stride_con < 0 && init_t->_lo > limit_t->_hi);
+      if (span + 2 * stride_abs <= chunk) {
+        remove_sfpt = true;
+      } else if (ordered && chunk <= (jlong)max_jint) {
+        remove_sfpt = true;
+        strip_mine = true;
+      }
+    }
+  }
+  if (loop_sfpt != NULL && loop_sfpt == x->in(LoopNode::LoopBackControl) && !remove_sfpt) {
+    // Safepoint on the backedge must stay, see above.
+    return false;
+  }
+
   // =================================================
   // ---- SUCCESS!   Found A Trip-Counted Loop!  -----
   //
@@ -693,7 +733,15 @@ bool PhaseIdealLoop::is_counted_loop( Node *x, IdealLoopTree *loop ) {
 
   } // LoopLimitCheck
 
-  if (!UseCountedLoopSafepoints) {
+  // The safepoint is removed from the counted loop below; keep a copy
+  // with the same jvm state for the outer loop.
+  Node* outer_sfpt = NULL;
+  if (strip_mine) {
+    outer_sfpt = loop_sfpt->clone();
+    outer_sfpt->set_req(TypeFunc::Control, NULL);
+  }
+
+  if (remove_sfpt) {
     // Check for SafePoint on backedge and remove
     Node *sfpt = x->in(LoopNode::LoopBackControl);
     if (sfpt->Opcode() == Op_SafePoint && is_deleteable_safept(sfpt)) {
@@ -791,7 +839,7 @@ bool PhaseIdealLoop::is_counted_loop( Node *x, IdealLoopTree *loop ) {
   lazy_replace( x, l );
   set_idom(l, init_control, dom_depth(x));
 
-  if (!UseCountedLoopSafepoints) {
+  if (remove_sfpt) {
     // Check for immediately preceding SafePoint and remove
     Node *sfpt2 = le->in(0);
     if (sfpt2->Opcode() == Op_SafePoint && is_deleteable_safept(sfpt2)) {
@@ -816,11 +864,161 @@ bool PhaseIdealLoop::is_counted_loop( Node *x, IdealLoopTree *loop ) {
   }
 #endif
 
+  if (strip_mine) {
+    strip_mine_counted_loop(loop, l, outer_sfpt);
+  }
+
   C->print_method(PHASE_AFTER_CLOOPS, 3);
 
   return true;
 }
 
+//------------------------------strip_mine_counted_loop------------------------
+// Nest the freshly built counted loop 'cl' in an outer loop that runs it in
+// chunks of at most LoopStripMiningIter iterations and polls for safepoints
+// between chunks.  'sfpt' carries the jvm state of the safepoint that was
+// removed from the counted loop.  The counted loop keeps its shape so it is
+// still unrolled, range check eliminated and vectorized.
+//
+//   outer: oiv = Phi(init, incr)       (one Phi per Phi of the inner loop)
+//          inner_limit = (limit - oiv < chunk) ? limit : oiv + chunk
+//   cl:    iv = Phi(oiv, incr)
+//          ...
+//          incr = iv + stride
+//          if (incr < inner_limit) goto cl
+//          if (incr < limit) { safepoint; goto outer }
+//   exit:
+//
+// The outer loop only shows up in the loop tree at the next build, so this
+// pass is ended early.
+void PhaseIdealLoop::strip_mine_counted_loop( IdealLoopTree *loop, CountedLoopNode *cl, Node *sfpt ) {
+  CountedLoopEndNode* cle = cl->loopexit();
+  Node* entry = cl->in(LoopNode::EntryControl);
+  Node* exit = cle->proj_out(false);
+  IdealLoopTree* outer_loop = loop->_parent;
+  IdealLoopTree* exit_loop = get_loop(exit);
+  Node* incr = cle->incr();
+  Node* limit = cle->limit();
+  int stride_con = cl->stride_con();
+  BoolTest::mask bt = cle->test_trip();
+  uint dd = dom_depth(cl);
+  uint dd_exit = dom_depth(exit);
+
+  LoopNode* outer_head = new (C) LoopNode(entry, NULL);
+  outer_head->mark_strip_mined_outer();
+  set_loop(outer_head, outer_loop);
+  set_idom(outer_head, entry, dd);
+
+  // Every value carried around the inner loop is carried around the outer
+  // loop too: the inner loop exits at the bottom, after all backedge values
+  // are computed.
+  Node_List phis;
+  for (DUIterator_Fast imax, i = cl->fast_outs(imax); i < imax; i++) {
+    Node* u = cl->fast_out(i);
+    if (u->is_Phi()) {
+      phis.push(u);
+    }
+  }
+  for (uint i = 0; i < phis.size(); i++) {
+    Node* phi = phis.at(i);
+    Node* outer_phi = phi->clone();
+    outer_phi->set_req(0, outer_head);
+    _igvn.register_new_node_with_optimizer(outer_phi);
+    set_ctrl(outer_phi, outer_head);
+    _igvn.replace_input_of(phi, LoopNode::EntryControl, outer_phi);
+  }
+  _igvn.replace_input_of(cl, LoopNode::EntryControl, outer_head);
+  set_idom(cl, outer_head, dd);
+
+  // Limit of the inner loop: at most one chunk past the outer iv.  The
+  // distance to the real limit is computed in long to avoid overflow.
+  Node* oiv = cl->phi()->in(LoopNode::EntryControl);
+  jlong chunk = (jlong)LoopStripMiningIter * stride_con;
+  Node* next = new (C) AddINode(oiv, _igvn.intcon((jint)chunk));
+  Node* oiv_l = new (C) ConvI2LNode(oiv);
+  Node* limit_l = new (C) ConvI2LNode(limit);
+  Node* dist = stride_con > 0 ? new (C) SubLNode(limit_l, oiv_l)
+                              : new (C) SubLNode(oiv_l, limit_l);
+  Node* dist_cmp = new (C) CmpLNode(dist, _igvn.longcon(chunk > 0 ? chunk : -chunk));
+  Node* dist_bol = new (C) BoolNode(dist_cmp, BoolTest::lt);
+  Node* inner_limit = CMoveNode::make(C, outer_head, dist_bol, next, limit, TypeInt::INT);
+  Node* limit_nodes[] = { next, oiv_l, limit_l, dist, dist_cmp, dist_bol, inner_limit };
+  for (uint i = 0; i < sizeof(limit_nodes) / sizeof(limit_nodes[0]); i++) {
+    _igvn.register_new_node_with_optimizer(limit_nodes[i]);
+    set_ctrl(limit_nodes[i], outer_head);
+  }
+  set_ctrl(next->in(2), C->root());
+  set_ctrl(dist_cmp->in(2), C->root());
+
+  Node* inner_cmp = new (C) CmpINode(incr, inner_limit);
+  _igvn.register_new_node_with_optimizer(inner_cmp);
+  set_ctrl(inner_cmp, cle->in(0));
+  Node* inner_test = new (C) BoolNode(inner_cmp, bt);
+  _igvn.register_new_node_with_optimizer(inner_test);
+  set_ctrl(inner_test, cle->in(0));
+  _igvn.replace_input_of(cle, CountedLoopEndNode::TestValue, inner_test);
+
+  // The original exit test now decides whether to run another chunk
+  Node_List exit_uses;
+  for (DUIterator_Fast imax, i = exit->fast_outs(imax); i < imax; i++) {
+    exit_uses.push(exit->fast_out(i));
+  }
+  Node* outer_cmp = new (C) CmpINode(incr, limit);
+  _igvn.register_new_node_with_optimizer(outer_cmp);
+  set_ctrl(outer_cmp, exit);
+  Node* outer_test = new (C) BoolNode(outer_cmp, bt);
+  _igvn.register_new_node_with_optimizer(outer_test);
+  set_ctrl(outer_test, exit);
+
+  IfNode* outer_le = new (C) IfNode(exit, outer_test, cle->_prob, cle->_fcnt);
+  _igvn.register_new_node_with_optimizer(outer_le);
+  set_loop(outer_le, outer_loop);
+  set_idom(outer_le, exit, dd_exit);
+  Node* outer_tail = new (C) IfTrueNode(outer_le);
+  _igvn.register_new_node_with_optimizer(outer_tail);
+  set_loop(outer_tail, outer_loop);
+  set_idom(outer_tail, outer_le, dd_exit);
+  Node* outer_exit = new (C) IfFalseNode(outer_le);
+  _igvn.register_new_node_with_optimizer(outer_exit);
+  set_loop(outer_exit, exit_loop);
+  set_idom(outer_exit, outer_le, dd_exit);
+
+  for (uint i = 0; i < exit_uses.size(); i++) {
+    Node* use = exit_uses.at(i);
+    for (uint j = 0; j < use->req(); j++) {
+      if (use->in(j) == exit) {
+        _igvn.replace_input_of(use, j, outer_exit);
+      }
+    }
+    if (use->is_CFG()) {
+      if (idom(use) == exit) {
+        set_idom(use, outer_exit, dom_depth(use));
+      }
+    } else if (has_ctrl(use) && get_ctrl(use) == exit) {
+      set_ctrl(use, outer_exit);
+    }
+  }
+
+  sfpt->set_req(TypeFunc::Control, outer_tail);
+  _igvn.register_new_node_with_optimizer(sfpt);
+  set_loop(sfpt, outer_loop);
+  set_idom(sfpt, outer_tail, dd_exit);
+
+  outer_head->set_req(LoopNode::LoopBackControl, sfpt);
+  _igvn.register_new_node_with_optimizer(outer_head);
+  cl->mark_strip_mined();
+
+#ifndef PRODUCT
+  if (TraceLoopOpts) {
+    tty->print("StripMined   ");
+    loop->dump_head();
+  }
+#endif
+
+  set_created_loop_node();
+  C->set_major_progress();
+}
+
 //----------------------exact_limit-------------------------------------------
 Node* PhaseIdealLoop::exact_limit( IdealLoopTree *loop ) {
   assert(loop->_head->is_CountedLoop(), "");
@@ -1875,7 +2073,7 @@ void IdealLoopTree::counted_loop( PhaseIdealLoop *phase ) {
   if (_head->is_CountedLoop() ||
       phase->is_counted_loop(_head, this)) {
 
-    if (!UseCountedLoopSafepoints) {
+    if (!UseCountedLoopSafepoints || _head->as_Loop()->is_strip_mined()) {
       // Indicate we do not need a safepoint here
       _has_sfpt = 1;
     }
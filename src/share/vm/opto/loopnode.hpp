@@ -62,7 +62,9 @@ protected:
          HasExactTripCount=8,
          InnerLoop=16,
          PartialPeelLoop=32,
-         PartialPeelFailed=64 };
+         PartialPeelFailed=64,
+         StripMined=128,
+         StripMinedOuter=256 };
   char _unswitch_count;
   enum { _unswitch_max=3 };
 
@@ -78,6 +80,14 @@ public:
   int partial_peel_has_failed() const { return _loop_flags & PartialPeelFailed; }
   void mark_partial_peel_failed() { _loop_flags |= PartialPeelFailed; }
 
+  // A strip mined loop is a counted loop that runs at most LoopStripMiningIter
+  // iterations per trip of its (uncounted) outer loop, which holds the
+  // safepoint poll.
+  int is_strip_mined() const { return _loop_flags & StripMined; }
+  void mark_strip_mined() { _loop_flags |= StripMined; }
+  int is_strip_mined_outer() const { return _loop_flags & StripMinedOuter; }
+  void mark_strip_mined_outer() { _loop_flags |= StripMinedOuter; }
+
   int unswitch_max() { return _unswitch_max; }
   int unswitch_count() { return _unswitch_count; }
   void set_unswitch_count(int val) {
@@ -827,6 +837,9 @@ public:
 
   bool is_counted_loop( Node *x, IdealLoopTree *loop );
 
+  // Nest a counted loop in an outer loop that polls for safepoints
+  void strip_mine_counted_loop( IdealLoopTree *loop, CountedLoopNode *cl, Node *sfpt );
+
   Node* exact_limit( IdealLoopTree *loop );
 
   // Return a post-walked LoopNode
@@ -936,6 +936,7 @@ static void match_alias_type(Compile* C, Node* n, Node* m) {
     case Op_AryEq:
     case Op_MemBarVolatile:
     case Op_MemBarCPUOrder: // %%% these ideals should have narrower adr_type?
+    case Op_StrInflatedCopy:
     case Op_EncodeISOArray:
       nidx = Compile::AliasIdxTop;
       nat = NULL;
@@ -2112,6 +2113,7 @@ void Matcher::find_shared( Node *n ) {
       case Op_StrEquals:
       case Op_StrIndexOf:
       case Op_AryEq:
+      case Op_StrInflatedCopy:
       case Op_EncodeISOArray:
       case Op_ThreadRefetch:      // This must be added, otherwise we couldn't match the ThreadRefetchNode.
         set_shared(n); // Force result into register (it will be anyways)
@@ -2316,6 +2318,7 @@ void Matcher::find_shared( Node *n ) {
         n->del_req(4);
         break;
       }
+      case Op_StrInflatedCopy:
       case Op_EncodeISOArray: {
         // Restructure into a binary tree for Matching.
         Node* pair = new (C) BinaryNode(n->in(3), n->in(4));
@@ -292,6 +292,10 @@ public:
   // Should original key array reference be passed to AES stubs
   static const bool pass_original_key_for_aes();
 
+  // Are there match rules for the Latin-1 (LL) encoding of the String
+  // intrinsic nodes and for StrInflatedCopy (CompactStrings)?
+  static const bool has_latin1_string_intrinsics();
+
   // Used to determine a "low complexity" 64-bit constant.  (Zero is simple.)
   // The standard of comparison is one (StoreL ConL) vs. two (StoreI ConI).
   // Depends on the details of 64-bit constant generation on the CPU.
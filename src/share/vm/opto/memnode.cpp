@@ -3011,6 +3011,26 @@ const Type *EncodeISOArrayNode::Value(PhaseTransform *phase) const {
   return bottom_type();
 }
 
+//=============================================================================
+//------------------------------match_edge-------------------------------------
+// Do not match memory edge
+uint StrInflatedCopyNode::match_edge(uint idx) const {
+  return idx == 2 || idx == 3; // StrInflatedCopy src (Binary dst len)
+}
+
+//------------------------------Ideal------------------------------------------
+// Return a node which is more "ideal" than the current node.  Strip out
+// control copies
+Node *StrInflatedCopyNode::Ideal(PhaseGVN *phase, bool can_reshape) {
+  return remove_dead_region(phase, can_reshape) ? this : NULL;
+}
+
+//------------------------------Value------------------------------------------
+const Type *StrInflatedCopyNode::Value(PhaseTransform *phase) const {
+  if (in(0) && phase->type(in(0)) == Type::TOP) return Type::TOP;
+  return bottom_type();
+}
+
 //=============================================================================
 MemBarNode::MemBarNode(Compile* C, int alias_idx, Node* precedent)
   : MultiNode(TypeFunc::Parms + (precedent == NULL? 0: 1)),
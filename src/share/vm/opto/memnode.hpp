@@ -948,24 +948,36 @@ public:
 //------------------------------StrIntrinsic-------------------------------
 // Base class for Ideal nodes used in String instrinsic code.
 class StrIntrinsicNode: public Node {
+public:
+  // Encoding of the operands: UU for char[] (UTF-16),
+  // LL for Latin-1 byte[] (CompactStrings).
+  typedef enum ArgEncoding { UU, LL } ArgEncoding;
+
+protected:
+  ArgEncoding _encoding;
+
 public:
   StrIntrinsicNode(Node* control, Node* char_array_mem,
-                   Node* s1, Node* c1, Node* s2, Node* c2):
-    Node(control, char_array_mem, s1, c1, s2, c2) {
+                   Node* s1, Node* c1, Node* s2, Node* c2, ArgEncoding encoding = UU):
+    Node(control, char_array_mem, s1, c1, s2, c2), _encoding(encoding) {
   }
 
   StrIntrinsicNode(Node* control, Node* char_array_mem,
-                   Node* s1, Node* s2, Node* c):
-    Node(control, char_array_mem, s1, s2, c) {
+                   Node* s1, Node* s2, Node* c, ArgEncoding encoding = UU):
+    Node(control, char_array_mem, s1, s2, c), _encoding(encoding) {
   }
 
   StrIntrinsicNode(Node* control, Node* char_array_mem,
-                   Node* s1, Node* s2):
-    Node(control, char_array_mem, s1, s2) {
+                   Node* s1, Node* s2, ArgEncoding encoding = UU):
+    Node(control, char_array_mem, s1, s2), _encoding(encoding) {
   }
 
   virtual bool depends_only_on_test() const { return false; }
-  virtual const TypePtr* adr_type() const { return TypeAryPtr::CHARS; }
+  virtual const TypePtr* adr_type() const { return _encoding == LL ? TypeAryPtr::BYTES : TypeAryPtr::CHARS; }
+  virtual uint size_of() const { return sizeof(StrIntrinsicNode); }
+  virtual uint hash() const { return Node::hash() + _encoding; }
+  virtual uint cmp(const Node& n) const { return _encoding == ((StrIntrinsicNode&)n)._encoding; }
+  ArgEncoding encoding() const { return _encoding; }
   virtual uint match_edge(uint idx) const;
   virtual uint ideal_reg() const { return Op_RegI; }
   virtual Node *Ideal(PhaseGVN *phase, bool can_reshape);
@@ -976,8 +988,8 @@ public:
 class StrCompNode: public StrIntrinsicNode {
 public:
   StrCompNode(Node* control, Node* char_array_mem,
-              Node* s1, Node* c1, Node* s2, Node* c2):
-    StrIntrinsicNode(control, char_array_mem, s1, c1, s2, c2) {};
+              Node* s1, Node* c1, Node* s2, Node* c2, ArgEncoding encoding = UU):
+    StrIntrinsicNode(control, char_array_mem, s1, c1, s2, c2, encoding) {};
   virtual int Opcode() const;
   virtual const Type* bottom_type() const { return TypeInt::INT; }
 };
@@ -996,8 +1008,8 @@ public:
 class StrIndexOfNode: public StrIntrinsicNode {
 public:
   StrIndexOfNode(Node* control, Node* char_array_mem,
-              Node* s1, Node* c1, Node* s2, Node* c2):
-    StrIntrinsicNode(control, char_array_mem, s1, c1, s2, c2) {};
+              Node* s1, Node* c1, Node* s2, Node* c2, ArgEncoding encoding = UU):
+    StrIntrinsicNode(control, char_array_mem, s1, c1, s2, c2, encoding) {};
   virtual int Opcode() const;
   virtual const Type* bottom_type() const { return TypeInt::INT; }
 };
@@ -1005,8 +1017,8 @@ public:
 //------------------------------AryEq---------------------------------------
 class AryEqNode: public StrIntrinsicNode {
 public:
-  AryEqNode(Node* control, Node* char_array_mem, Node* s1, Node* s2):
-    StrIntrinsicNode(control, char_array_mem, s1, s2) {};
+  AryEqNode(Node* control, Node* char_array_mem, Node* s1, Node* s2, ArgEncoding encoding = UU):
+    StrIntrinsicNode(control, char_array_mem, s1, s2, encoding) {};
   virtual int Opcode() const;
   virtual const Type* bottom_type() const { return TypeInt::BOOL; }
 };
@@ -1027,6 +1039,22 @@ public:
   virtual const Type *Value(PhaseTransform *phase) const;
 };
 
+//------------------------------StrInflatedCopy--------------------------------
+// inflate Latin-1 byte[] to char[]; like EncodeISOArray the memory
+// effect is carried by an SCMemProj and the int result is unused
+class StrInflatedCopyNode: public Node {
+public:
+  StrInflatedCopyNode(Node *control, Node* arymem, Node* s1, Node* s2, Node* c): Node(control, arymem, s1, s2, c) {};
+  virtual int Opcode() const;
+  virtual bool depends_only_on_test() const { return false; }
+  virtual const Type* bottom_type() const { return TypeInt::INT; }
+  virtual const TypePtr* adr_type() const { return TypePtr::BOTTOM; }
+  virtual uint match_edge(uint idx) const;
+  virtual uint ideal_reg() const { return Op_RegI; }
+  virtual Node *Ideal(PhaseGVN *phase, bool can_reshape);
+  virtual const Type *Value(PhaseTransform *phase) const;
+};
+
 //------------------------------MemBar-----------------------------------------
 // There are different flavors of Memory Barriers to match the Java Memory
 // Model.  Monitor-enter and volatile-load act as Aquires: no following ref
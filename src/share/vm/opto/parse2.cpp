@@ -1175,6 +1175,20 @@ bool Parse::path_is_suitable_for_uncommon_trap(float prob) const {
   return (seems_never_taken(prob) && seems_stable_comparison());
 }
 
+// A branch that is taken, but so seldom that escape analysis may ask to
+// replace it with an uncommon trap if an allocation escapes only there.
+bool Parse::is_rare_path(float prob) const {
+  if (!PartialEscapeAnalysis || !C->do_escape_analysis() || !UseInterpreter) {
+    return false;
+  }
+  return (prob < PROB_UNLIKELY_MAG(3) && seems_stable_comparison());
+}
+
+bool Parse::path_is_rare_escape_path(float prob) const {
+  return (prob < PROB_FAIR && C->is_pruned_branch(method(), bci()) &&
+          UseInterpreter && seems_stable_comparison());
+}
+
 //----------------------------adjust_map_after_if------------------------------
 // Adjust the JVM state to reflect the result of taking this path.
 // Basically, it means inspecting the CmpNode controlling this
@@ -1197,6 +1211,22 @@ void Parse::adjust_map_after_if(BoolTest::mask btest, Node* c, float prob,
     return;
   }
 
+  if (path_is_rare_escape_path(prob)) {
+    // Escape analysis found an allocation that escapes only on this
+    // path.  Trap here so that the allocation can be scalar replaced;
+    // deoptimization rematerializes it if the path is ever taken.
+    repush_if_args();
+    uncommon_trap(Deoptimization::Reason_unstable_if,
+                  Deoptimization::Action_reinterpret,
+                  NULL,
+                  "rare escape path");
+    return;
+  }
+
+  if (is_rare_path(prob) && (control()->is_IfTrue() || control()->is_IfFalse())) {
+    C->record_rare_branch(method(), bci(), control());
+  }
+
   Node* val = c->in(1);
   Node* con = c->in(2);
   const Type* tcon = _gvn.type(con);
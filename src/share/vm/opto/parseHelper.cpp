@@ -313,7 +313,9 @@ void Parse::do_new() {
 
   // Keep track of whether opportunities exist for StringBuilder
   // optimizations.
-  if (OptimizeStringConcat &&
+  // PhaseStringOpts builds char[] based Strings, so it is skipped for a
+  // class library with compact (byte[] + coder) Strings.
+  if (OptimizeStringConcat && !java_lang_String::has_coder_field() &&
       (klass == C->env()->StringBuilder_klass() ||
        klass == C->env()->StringBuffer_klass())) {
     C->set_has_stringbuilder(true);
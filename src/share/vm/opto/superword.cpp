@@ -56,6 +56,7 @@ SuperWord::SuperWord(PhaseIdealLoop* phase) :
   _dg(_arena),                            // dependence graph
   _visited(arena()),                      // visited node set
   _post_visited(arena()),                 // post visited node set
+  _reductions(arena()),                   // reduction chain members
   _n_idx_list(arena(), 8),                // scratch list of (node,index) pairs
   _stk(arena(), 8, 0, NULL),              // scratch stack of nodes
   _nlist(arena(), 8, 0, NULL),            // scratch list of nodes
@@ -110,6 +111,8 @@ void SuperWord::transform_loop(IdealLoopTree* lpt) {
 //
 // 1) A reverse post-order of nodes in the block is constructed.  By scanning
 //    this list from first to last, all definitions are visited before their uses.
+//    Chains of adds or multiplies that reduce into a loop phi are recorded,
+//    they may be packed although each member depends on the previous one.
 //
 // 2) A point-to-point dependence graph is constructed between memory references.
 //    This simplies the upcoming "independence" checker.
@@ -146,6 +149,8 @@ void SuperWord::SLP_extract() {
   if (!construct_bb())
     return; // Exit if no interesting nodes or complex graph.
 
+  mark_reductions();
+
   dependence_graph();
 
   compute_max_depth();
@@ -169,6 +174,89 @@ void SuperWord::SLP_extract() {
   output();
 }
 
+//------------------------------mark_reductions---------------------------
+// Record the chains of isomorphic add or mul nodes through which the
+// unrolled body reduces into a loop phi:
+//
+//   phi -> s0 -> s1 -> ... -> sN -> phi (backedge)
+//
+// Every member but the last has no other use, the last one has no other
+// use in the loop.  The chain input of each member is moved to in(1), the
+// value combined into it stays in in(2).
+void SuperWord::mark_reductions() {
+  _reductions.Clear();
+  if (!SuperWordReductions) return;
+
+  CountedLoopNode* cl = lp()->as_CountedLoop();
+  for (DUIterator_Fast imax, i = cl->fast_outs(imax); i < imax; i++) {
+    Node* phi = cl->fast_out(i);
+    if (!phi->is_Phi() || phi == iv() || !in_bb(phi) ||
+        phi->bottom_type() == Type::MEMORY) {
+      continue;
+    }
+    Node* last = phi->in(LoopNode::LoopBackControl);
+    if (!in_bb(last)) continue;
+    int opc = last->Opcode();
+    if (ReductionNode::opcode(opc, last->bottom_type()->basic_type()) == 0) continue;
+
+    // Walk the chain forward from the phi to the backedge value.
+    _nlist.clear();
+    Node* prev = phi;
+    Node* n = NULL;
+    for (DUIterator_Fast jmax, j = phi->fast_outs(jmax); j < jmax; j++) {
+      Node* use = phi->fast_out(j);
+      if (in_bb(use)) {
+        if (n != NULL) { n = NULL; break; } // phi feeds more than the chain
+        n = use;
+      }
+    }
+    bool ok = (n != NULL);
+    while (ok) {
+      if (n->Opcode() != opc || n->req() != 3 ||
+          (n->in(1) == prev) == (n->in(2) == prev)) {
+        ok = false;
+        break;
+      }
+      _nlist.push(n);
+      if (n == last) break;
+      if (n->outcnt() != 1 || !in_bb(n->unique_out())) {
+        ok = false;
+        break;
+      }
+      prev = n;
+      n = n->unique_out();
+    }
+    if (ok) {
+      for (DUIterator_Fast jmax, j = last->fast_outs(jmax); j < jmax; j++) {
+        Node* use = last->fast_out(j);
+        if (use != phi && in_bb(use)) {
+          ok = false;
+          break;
+        }
+      }
+    }
+    if (!ok || _nlist.length() < 2) continue;
+
+    prev = phi;
+    for (int j = 0; j < _nlist.length(); j++) {
+      Node* s = _nlist.at(j);
+      if (s->in(2) == prev) {
+        // Add and mul nodes hash commutatively, no rehash is needed.
+        s->swap_edges(1, 2);
+      }
+      _reductions.set(s->_idx);
+      prev = s;
+    }
+#ifndef PRODUCT
+    if (TraceSuperWord) {
+      tty->print_cr("\nreduction chain of %d nodes into", _nlist.length());
+      phi->dump();
+    }
+#endif
+  }
+  _nlist.clear();
+}
+
 //------------------------------find_adjacent_refs---------------------------
 // Find the adjacent memory references and create pack pairs for them.
 // This is the initial set of packs that will then be extended by
@@ -680,7 +768,7 @@ bool SuperWord::stmts_can_pack(Node* s1, Node* s2, int align) {
   }
 
   if (isomorphic(s1, s2)) {
-    if (independent(s1, s2)) {
+    if (independent(s1, s2) || reduction(s1, s2)) {
       if (!exists_at(s1, 0) && !exists_at(s2, 1)) {
         if (!s1->is_Mem() || are_adjacent_refs(s1, s2)) {
           int s1_align = alignment(s1);
@@ -779,6 +867,14 @@ bool SuperWord::independent_path(Node* shallow, Node* deep, uint dp) {
   return true;
 }
 
+//------------------------------reduction---------------------------
+// Is s1 the reduction chain member immediately feeding s2?  Such
+// dependent pairs are packed into one reduction operation.
+bool SuperWord::reduction(Node* s1, Node* s2) {
+  if (!is_reduction(s1) || !is_reduction(s2)) return false;
+  return depth(s1) + 1 == depth(s2) && s2->in(1) == s1;
+}
+
 //------------------------------set_alignment---------------------------
 void SuperWord::set_alignment(Node* s1, Node* s2, int align) {
   set_alignment(s1, align);
@@ -1108,6 +1204,9 @@ void SuperWord::filter_packs() {
 // Can code be generated for pack p?
 bool SuperWord::implemented(Node_List* p) {
   Node* p0 = p->at(0);
+  if (is_reduction(p0)) {
+    return ReductionNode::implemented(p0->Opcode(), p->size(), velt_basic_type(p0));
+  }
   return VectorNode::implemented(p0->Opcode(), p->size(), velt_basic_type(p0));
 }
 
@@ -1130,6 +1229,26 @@ static bool same_inputs(Node_List* p, int idx) {
 // For pack p, are all operands and all uses (with in the block) vector?
 bool SuperWord::profitable(Node_List* p) {
   Node* p0 = p->at(0);
+  if (is_reduction(p0)) {
+    // The chain input in(1) stays scalar; in(2) must be a vector of the
+    // same element type with lanes in chain order.  All uses other than
+    // the chain are uses of the last member, which gets the scalar result.
+    Node* opd = p0->in(2);
+    Node_List* opd_pk = my_pack(opd);
+    if (opd_pk == NULL || !is_vector_use(p0, 2) ||
+        velt_basic_type(opd) != velt_basic_type(p0)) {
+      return false;
+    }
+    // Float and double reductions are done lane by lane to keep the
+    // rounding of the scalar loop, so they only pay off when they consume
+    // the result of other vector arithmetic.
+    BasicType bt = velt_basic_type(p0);
+    if ((bt == T_FLOAT || bt == T_DOUBLE) && opd->is_Load()) {
+      return false;
+    }
+    return true;
+  }
+
   uint start, end;
   VectorNode::vector_operands(p0, &start, &end);
 
@@ -1445,6 +1564,12 @@ void SuperWord::output() {
         const TypePtr* atyp = n->adr_type();
         vn = StoreVectorNode::make(C, opc, ctl, mem, adr, atyp, val, vlen);
         vlen_in_bytes = vn->as_StoreVector()->memory_size();
+      } else if (is_reduction(n)) {
+        // Combine the scalar chain input with the vector of operands
+        Node* in1 = low_adr->in(1);
+        Node* in2 = vector_opd(p, 2);
+        vn = ReductionNode::make(C, opc, NULL, in1, in2, velt_basic_type(n));
+        vlen_in_bytes = in2->bottom_type()->is_vect()->length_in_bytes();
       } else if (n->req() == 3) {
         // Promote operands to vector
         Node* in1 = vector_opd(p, 1);
@@ -1570,6 +1695,7 @@ Node* SuperWord::vector_opd(Node_List* p, int opd_idx) {
 // use with an extract operation.
 void SuperWord::insert_extracts(Node_List* p) {
   if (p->at(0)->is_Store()) return;
+  if (is_reduction(p->at(0))) return; // result replaces the last member
   assert(_n_idx_list.is_empty(), "empty (node,index) list");
 
   // Inspect each use of each pack member.  For each use that is
@@ -256,6 +256,7 @@ class SuperWord : public ResourceObj {
   // Scratch pads
   VectorSet    _visited;       // Visited set
   VectorSet    _post_visited;  // Post-visited set
+  VectorSet    _reductions;    // Members of reduction chains, by node _idx
   Node_Stack   _n_idx_list;    // List of (node,index) pairs
   GrowableArray<Node*> _nlist; // List of nodes
   GrowableArray<Node*> _stk;   // Stack of nodes
@@ -337,10 +338,15 @@ class SuperWord : public ResourceObj {
   Node_List* my_pack(Node* n)                { return !in_bb(n) ? NULL : _node_info.adr_at(bb_idx(n))->_my_pack; }
   void set_my_pack(Node* n, Node_List* p)    { int i = bb_idx(n); grow_node_info(i); _node_info.adr_at(i)->_my_pack = p; }
 
+  // reduction chain membership
+  bool is_reduction(Node* n)                 { return _reductions.test(n->_idx) != 0; }
+
   // methods
 
   // Extract the superword level parallelism
   void SLP_extract();
+  // Find chains of add or mul nodes which reduce into a loop phi.
+  void mark_reductions();
   // Find the adjacent memory references and create pack pairs for them.
   void find_adjacent_refs();
   // Find a memory reference to align the loop induction variable to.
@@ -363,6 +369,8 @@ class SuperWord : public ResourceObj {
   bool isomorphic(Node* s1, Node* s2);
   // Is there no data path from s1 to s2 or s2 to s1?
   bool independent(Node* s1, Node* s2);
+  // Is s1 the reduction chain member immediately feeding s2?
+  bool reduction(Node* s1, Node* s2);
   // Helper for independent
   bool independent_path(Node* shallow, Node* deep, uint dp=0);
   void set_alignment(Node* s1, Node* s2, int align);
@@ -541,6 +541,92 @@ class Pack2DNode : public PackNode {
 };
 
 
+//========================Reduce_Vector_to_Scalar==============================
+
+//------------------------------ReductionNode----------------------------------
+// Combine a scalar with all elements of a vector: in(1) is the scalar
+// value carried by the loop, in(2) the vector.  Float and double
+// reductions must combine the elements in order, starting with in(1).
+class ReductionNode : public Node {
+ public:
+  ReductionNode(Node* ctrl, Node* in1, Node* in2) : Node(ctrl, in1, in2) {}
+
+  static ReductionNode* make(Compile* C, int opc, Node* ctrl, Node* n1, Node* n2, BasicType bt);
+  static int  opcode(int opc, BasicType bt);
+  static bool implemented(int opc, uint vlen, BasicType bt);
+};
+
+//------------------------------AddReductionVINode-----------------------------
+// Add all elements of an int vector to an int scalar
+class AddReductionVINode : public ReductionNode {
+ public:
+  AddReductionVINode(Node* ctrl, Node* in1, Node* in2) : ReductionNode(ctrl, in1, in2) {}
+  virtual int Opcode() const;
+  virtual const Type *bottom_type() const { return TypeInt::INT; }
+  virtual uint ideal_reg() const { return Op_RegI; }
+};
+
+//------------------------------AddReductionVLNode-----------------------------
+// Add all elements of a long vector to a long scalar
+class AddReductionVLNode : public ReductionNode {
+ public:
+  AddReductionVLNode(Node* ctrl, Node* in1, Node* in2) : ReductionNode(ctrl, in1, in2) {}
+  virtual int Opcode() const;
+  virtual const Type *bottom_type() const { return TypeLong::LONG; }
+  virtual uint ideal_reg() const { return Op_RegL; }
+};
+
+//------------------------------AddReductionVFNode-----------------------------
+// Add all elements of a float vector to a float scalar, in order
+class AddReductionVFNode : public ReductionNode {
+ public:
+  AddReductionVFNode(Node* ctrl, Node* in1, Node* in2) : ReductionNode(ctrl, in1, in2) {}
+  virtual int Opcode() const;
+  virtual const Type *bottom_type() const { return Type::FLOAT; }
+  virtual uint ideal_reg() const { return Op_RegF; }
+};
+
+//------------------------------AddReductionVDNode-----------------------------
+// Add all elements of a double vector to a double scalar, in order
+class AddReductionVDNode : public ReductionNode {
+ public:
+  AddReductionVDNode(Node* ctrl, Node* in1, Node* in2) : ReductionNode(ctrl, in1, in2) {}
+  virtual int Opcode() const;
+  virtual const Type *bottom_type() const { return Type::DOUBLE; }
+  virtual uint ideal_reg() const { return Op_RegD; }
+};
+
+//------------------------------MulReductionVINode-----------------------------
+// Multiply an int scalar by all elements of an int vector
+class MulReductionVINode : public ReductionNode {
+ public:
+  MulReductionVINode(Node* ctrl, Node* in1, Node* in2) : ReductionNode(ctrl, in1, in2) {}
+  virtual int Opcode() const;
+  virtual const Type *bottom_type() const { return TypeInt::INT; }
+  virtual uint ideal_reg() const { return Op_RegI; }
+};
+
+//------------------------------MulReductionVFNode-----------------------------
+// Multiply a float scalar by all elements of a float vector, in order
+class MulReductionVFNode : public ReductionNode {
+ public:
+  MulReductionVFNode(Node* ctrl, Node* in1, Node* in2) : ReductionNode(ctrl, in1, in2) {}
+  virtual int Opcode() const;
+  virtual const Type *bottom_type() const { return Type::FLOAT; }
+  virtual uint ideal_reg() const { return Op_RegF; }
+};
+
+//------------------------------MulReductionVDNode-----------------------------
+// Multiply a double scalar by all elements of a double vector, in order
+class MulReductionVDNode : public ReductionNode {
+ public:
+  MulReductionVDNode(Node* ctrl, Node* in1, Node* in2) : ReductionNode(ctrl, in1, in2) {}
+  virtual int Opcode() const;
+  virtual const Type *bottom_type() const { return Type::DOUBLE; }
+  virtual uint ideal_reg() const { return Op_RegD; }
+};
+
+
 //========================Extract_Scalar_from_Vector===========================
 
 //------------------------------ExtractNode------------------------------------
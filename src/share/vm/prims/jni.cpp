@@ -3261,7 +3261,13 @@ JNI_QUICK_ENTRY(const jchar*, jni_GetStringChars(
     /* JNI Specification states return NULL on OOM */
     if (buf != NULL) {
       if (s_len > 0) {
-        memcpy(buf, s_value->char_at_addr(s_offset), sizeof(jchar)*s_len);
+        if (!java_lang_String::is_latin1(s)) {
+          memcpy(buf, s_value->char_at_addr(s_offset), sizeof(jchar)*s_len);
+        } else {
+          for (int i = 0; i < s_len; i++) {
+            buf[i] = ((jchar) s_value->byte_at(i)) & 0xff;
+          }
+        }
       }
       buf[s_len] = 0;
       //%note jni_5
@@ -4209,7 +4215,13 @@ JNI_ENTRY(void, jni_GetStringRegion(JNIEnv *env, jstring string, jsize start, js
     if (len > 0) {
       int s_offset = java_lang_String::offset(s);
       typeArrayOop s_value = java_lang_String::value(s);
-      memcpy(buf, s_value->char_at_addr(s_offset+start), sizeof(jchar)*len);
+      if (!java_lang_String::is_latin1(s)) {
+        memcpy(buf, s_value->char_at_addr(s_offset+start), sizeof(jchar)*len);
+      } else {
+        for (int i = 0; i < len; i++) {
+          buf[i] = ((jchar) s_value->byte_at(i + start)) & 0xff;
+        }
+      }
     }
   }
 JNI_END
@@ -4310,19 +4322,35 @@ JNI_ENTRY(const jchar*, jni_GetStringCritical(JNIEnv *env, jstring string, jbool
   HOTSPOT_JNI_GETSTRINGCRITICAL_ENTRY(
                                       env, string, (uintptr_t *) isCopy);
 #endif /* USDT2 */
-  GC_locker::lock_critical(thread);
-  if (isCopy != NULL) {
-    *isCopy = JNI_FALSE;
-  }
   oop s = JNIHandles::resolve_non_null(string);
   int s_len = java_lang_String::length(s);
   typeArrayOop s_value = java_lang_String::value(s);
   int s_offset = java_lang_String::offset(s);
-  const jchar* ret;
-  if (s_len > 0) {
-    ret = s_value->char_at_addr(s_offset);
-  } else {
-    ret = (jchar*) s_value->base(T_CHAR);
+  bool is_latin1 = java_lang_String::is_latin1(s);
+  jchar* ret = NULL;
+  if (is_latin1) {
+    // Inflate Latin-1 encoded string to UTF-16; freed in ReleaseStringCritical.
+    // The copy is made before entering the critical region since callers do
+    // not release it when NULL is returned.
+    ret = NEW_C_HEAP_ARRAY_RETURN_NULL(jchar, s_len + 1, mtInternal);
+    if (ret == NULL) {
+      THROW_0(vmSymbols::java_lang_OutOfMemoryError());
+    }
+    for (int i = 0; i < s_len; i++) {
+      ret[i] = ((jchar) s_value->byte_at(i)) & 0xff;
+    }
+    ret[s_len] = 0;
+  }
+  GC_locker::lock_critical(thread);
+  if (isCopy != NULL) {
+    *isCopy = is_latin1 ? JNI_TRUE : JNI_FALSE;
+  }
+  if (!is_latin1) {
+    if (s_len > 0) {
+      ret = s_value->char_at_addr(s_offset);
+    } else {
+      ret = (jchar*) s_value->base(T_CHAR);
+    }
   }
 #ifndef USDT2
   DTRACE_PROBE1(hotspot_jni, GetStringCritical__return, ret);
@@ -4342,7 +4370,10 @@ JNI_ENTRY(void, jni_ReleaseStringCritical(JNIEnv *env, jstring str, const jchar
   HOTSPOT_JNI_RELEASESTRINGCRITICAL_ENTRY(
                                           env, str, (uint16_t *) chars);
 #endif /* USDT2 */
-  // The str and chars arguments are ignored
+  // The chars argument is only used for inflated Latin-1 strings
+  if (java_lang_String::is_latin1(JNIHandles::resolve_non_null(str))) {
+    FREE_C_HEAP_ARRAY(jchar, chars, mtInternal);
+  }
   GC_locker::unlock_critical(thread);
 #ifndef USDT2
   DTRACE_PROBE(hotspot_jni, ReleaseStringCritical__return);
@@ -1057,8 +1057,16 @@ static jint invoke_string_value_callback(jvmtiStringPrimitiveValueCallback cb,
   // (string value may be offset from the base)
   int s_len = java_lang_String::length(str);
   int s_offset = java_lang_String::offset(str);
+  bool is_latin1 = java_lang_String::is_latin1(str);
+  ResourceMark rm;
   jchar* value;
-  if (s_len > 0) {
+  if (is_latin1) {
+    // Inflate Latin-1 encoded string to UTF-16
+    value = NEW_RESOURCE_ARRAY(jchar, s_len);
+    for (int i = 0; i < s_len; i++) {
+      value[i] = ((jchar) s_value->byte_at(i)) & 0xff;
+    }
+  } else if (s_len > 0) {
     value = s_value->char_at_addr(s_offset);
   } else {
     value = (jchar*) s_value->base(T_CHAR);
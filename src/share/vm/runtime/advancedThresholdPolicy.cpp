@@ -160,38 +160,83 @@ bool AdvancedThresholdPolicy::is_method_profiled(Method* method) {
   return false;
 }
 
+// Rate the tasks queued since the last selection and a batch of the
+// others, round robin, and return the task rated highest. A task is
+// checked for staleness whenever it is re-rated, so that stale tasks are
+// removed without scanning the whole queue. Called with the queue locked.
+CompileTask* AdvancedThresholdPolicy::select_rated_task(jlong t, CompileQueue* compile_queue) {
+  CompileTask* task;
+  while ((task = compile_queue->first_unrated()) != NULL) {
+    Method* method = task->method();
+    update_rate(t, method);
+    compile_queue->rate(task, method->highest_comp_level(), weight(method));
+  }
+
+  int batch = (int)MIN2(TieredCompileQueueBatchSize, (uintx)compile_queue->rated_count());
+  for (int i = 0; i < batch; i++) {
+    task = compile_queue->next_to_rate();
+    if (task == NULL) {
+      break;
+    }
+    Method* method = task->method();
+    update_rate(t, method);
+    // If a method has been stale for some time, or can no longer be compiled
+    // at the level of the task, remove it from the queue. Like the full scan,
+    // always leave a task to select.
+    bool not_compilable = task->osr_bci() == InvocationEntryBci ?
+                          method->is_not_compilable(task->comp_level()) :
+                          method->is_not_osr_compilable(task->comp_level());
+    if (compile_queue->size() > 1 &&
+        (not_compilable || (is_stale(t, TieredCompileTaskTimeout, method) && !is_old(method)))) {
+      if (PrintTieredEvents) {
+        print_event(REMOVE_FROM_QUEUE, method, method, task->osr_bci(), (CompLevel)task->comp_level());
+      }
+      compile_queue->remove_and_mark_stale(task);
+      method->clear_queued_for_compilation();
+      continue;
+    }
+    compile_queue->rate(task, method->highest_comp_level(), weight(method));
+  }
+  return compile_queue->highest_rated();
+}
+
 // Called with the queue locked and with at least one element
 CompileTask* AdvancedThresholdPolicy::select_task(CompileQueue* compile_queue) {
   CompileTask *max_task = NULL;
   Method* max_method = NULL;
   jlong t = os::javaTimeMillis();
-  // Iterate through the queue and find a method with a maximum rate.
-  for (CompileTask* task = compile_queue->first(); task != NULL;) {
-    CompileTask* next_task = task->next();
-    Method* method = task->method();
-    update_rate(t, method);
-    if (max_task == NULL) {
-      max_task = task;
-      max_method = method;
-    } else {
-      // If a method has been stale for some time, remove it from the queue.
-      if (is_stale(t, TieredCompileTaskTimeout, method) && !is_old(method)) {
-        if (PrintTieredEvents) {
-          print_event(REMOVE_FROM_QUEUE, method, method, task->osr_bci(), (CompLevel)task->comp_level());
-        }
-        compile_queue->remove_and_mark_stale(task);
-        method->clear_queued_for_compilation();
-        task = next_task;
-        continue;
-      }
-
-      // Select a method with a higher rate
-      if (compare_methods(method, max_method)) {
+  if (TieredCompileQueueBatchSize > 0) {
+    max_task = select_rated_task(t, compile_queue);
+    max_method = max_task->method();
+  } else {
+    // Iterate through the queue and find a method with a maximum rate.
+    for (CompileTask* task = compile_queue->first(); task != NULL;) {
+      CompileTask* next_task = task->next();
+      Method* method = task->method();
+      update_rate(t, method);
+      if (max_task == NULL) {
         max_task = task;
         max_method = method;
+      } else {
+        // If a method has been stale for some time, remove it from the queue.
+        if (is_stale(t, TieredCompileTaskTimeout, method) && !is_old(method)) {
+          if (PrintTieredEvents) {
+            print_event(REMOVE_FROM_QUEUE, method, method, task->osr_bci(), (CompLevel)task->comp_level());
+          }
+          compile_queue->remove_and_mark_stale(task);
+          method->clear_queued_for_compilation();
+          task = next_task;
+          continue;
+        }
+
+        // Select a method with a higher rate
+        if (compare_methods(method, max_method)) {
+          max_task = task;
+          max_method = method;
+        }
       }
+      task = next_task;
     }
-    task = next_task;
   }
 
   if (max_task->comp_level() == CompLevel_full_profile && TieredStopAtLevel > CompLevel_full_profile
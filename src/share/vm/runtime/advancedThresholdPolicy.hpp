@@ -200,6 +200,8 @@ class AdvancedThresholdPolicy : public SimpleThresholdPolicy {
   void create_mdo(methodHandle mh, JavaThread* thread);
   // Is method profiled enough?
   bool is_method_profiled(Method* method);
+  // Select a task from the priority order of the compile queue
+  CompileTask* select_rated_task(jlong t, CompileQueue* compile_queue);
 
   double _increase_threshold_at_ratio;
 
@@ -1702,6 +1702,12 @@ void Arguments::set_g1_gc_flags() {
   if (G1ConcRefinementThreads == 0) {
     FLAG_SET_DEFAULT(G1ConcRefinementThreads, ParallelGCThreads);
   }
+
+  // The parallel full GC keeps its marks in a bitmap only, the heap
+  // verification has nothing to check them against.
+  if (G1ParallelFullGC && VerifyDuringGC && !TenantHeapIsolation) {
+    warning("VerifyDuringGC is ignored by the G1 full GC with -XX:+G1ParallelFullGC");
+  }
 #endif
 
   // MarkStackSize will be set (if it hasn't been set by the user)
@@ -2339,6 +2345,17 @@ bool Arguments::check_vm_args_consistency() {
     }
   }
 
+  status = status && verify_interval(SafepointProfilerLaggards, 1, 64, "SafepointProfilerLaggards");
+  status = status && verify_interval(SafepointProfilerHistorySize, 1, 64 * K, "SafepointProfilerHistorySize");
+  status = status && verify_percentage(G1OptionalCSetPercent, "G1OptionalCSetPercent");
+
+  if (G1PeriodicGCSystemLoadThreshold < 0.0) {
+    jio_fprintf(defaultStream::error_stream(),
+                "G1PeriodicGCSystemLoadThreshold (%f) must not be negative\n",
+                G1PeriodicGCSystemLoadThreshold);
+    status = false;
+  }
+
   // Allow both -XX:-UseStackBanging and -XX:-UseBoundThreads in non-product
   // builds so the cost of stack banging can be measured.
 #if (defined(PRODUCT) && defined(SOLARIS))
@@ -2370,6 +2387,9 @@ bool Arguments::check_vm_args_consistency() {
   status = status && verify_interval(SymbolTableSize, minimumSymbolTableSize,
     (max_uintx / SymbolTable::bucket_size()), "SymbolTable size");
 
+  status = status && verify_min_value(StringSymbolTableMaxLoadFactor, 1,
+                                      "StringSymbolTableMaxLoadFactor");
+
   {
     // Using "else if" below to avoid printing two error messages if min > max.
     // This will also prevent us from reporting both min>100 and max>100 at the
@@ -4204,6 +4224,17 @@ jint Arguments::apply_ergo() {
 
   ArgumentsExt::set_gc_specific_flags();
 
+  if (AllocationSiteSamplingInterval > 0) {
+    if (!UseTLAB) {
+      warning("Allocation site sampling requires UseTLAB; disabling AllocationSiteSamplingInterval");
+      FLAG_SET_DEFAULT(AllocationSiteSamplingInterval, 0);
+    } else {
+      // The TLAB refill inlined in the C1 allocation stubs takes the
+      // lowered end of a sampling TLAB for its real end.
+      FLAG_SET_DEFAULT(FastTLABRefill, false);
+    }
+  }
+
   // Initialize Metaspace flags and alignments.
   Metaspace::ergo_initialize();
 
@@ -4258,6 +4289,15 @@ jint Arguments::apply_ergo() {
     // nothing to use the profiling, turn if off
     FLAG_SET_DEFAULT(TypeProfileLevel, 0);
   }
+  if (LoopStripMiningIter > 1 && !UseCountedLoopSafepoints) {
+    if (FLAG_IS_DEFAULT(UseCountedLoopSafepoints)) {
+      // strip mining is only useful with a safepoint in the outer loop
+      FLAG_SET_DEFAULT(UseCountedLoopSafepoints, true);
+    } else {
+      warning("Disabling counted loop safepoints implies no loop strip mining: setting LoopStripMiningIter to 0");
+      FLAG_SET_DEFAULT(LoopStripMiningIter, 0);
+    }
+  }
 #endif
 
   if (PrintAssembly && FLAG_IS_DEFAULT(DebugNonSafepoints)) {
@@ -4331,7 +4371,9 @@ jint Arguments::adjust_after_os() {
     // such as the parallel collector for Linux and Solaris will
     // interleave old gen and survivor spaces on top of NUMA
     // allocation policy for the eden space.
-    // Non NUMA-aware collectors such as CMS, G1 and Serial-GC on
+    // G1 binds each heap region to a node when it is committed, on
+    // top of the interleaving of its auxiliary data structures.
+    // Non NUMA-aware collectors such as CMS and Serial-GC on
     // all platforms and ParallelGC on Windows will interleave all
     // of the heap spaces across NUMA nodes.
     if (FLAG_IS_DEFAULT(UseNUMAInterleaving)) {
@@ -136,6 +136,154 @@
   manageable(uintx, HugeObjectAllocationThreshold, 128*M,                   \
           "The size of the used heap of the instance must occupy to "       \
           "generate a jfr event")                                           \
+                                                                            \
+  product(bool, UseSafepointProfiler, false,                                \
+          "Keep a history of the threads that were last to reach "          \
+          "each safepoint, see the VM.safepoint_profile command")           \
+                                                                            \
+  product(uintx, SafepointProfilerLaggards, 4,                              \
+          "Number of threads that were last to reach a safepoint "          \
+          "recorded by the safepoint profiler")                             \
+                                                                            \
+  product(uintx, SafepointProfilerHistorySize, 64,                          \
+          "Number of safepoints kept in the safepoint profiler history")    \
+                                                                            \
+  manageable(uintx, SafepointProfilerThreshold, 0,                          \
+          "Only keep safepoints whose time to safepoint is at least "       \
+          "this many milliseconds in the safepoint profiler history")       \
+                                                                            \
+  product(bool, CompactStrings, false,                                      \
+          "Store Latin-1 strings one byte per character. Requires a "       \
+          "class library whose java.lang.String has a coder field")         \
+                                                                            \
+  product(bool, ResizeStringSymbolTables, false,                            \
+          "Grow and shrink the SymbolTable and StringTable in the service " \
+          "thread as their load factor changes")                            \
+                                                                            \
+  product(uintx, StringSymbolTableMaxLoadFactor, 4,                         \
+          "Average bucket length above which the SymbolTable or the "       \
+          "StringTable doubles its number of buckets")                      \
+                                                                            \
+  product(bool, ConcurrentSymbolTableCleaning, false,                       \
+          "Unlink unreferenced symbols in the service thread instead of "   \
+          "during garbage collection pauses")                               \
+                                                                            \
+  product(ccstr, ClassPreloadList, NULL,                                    \
+          "File with class names, one per line, that are loaded and "       \
+          "linked in parallel at startup. The format is the one of "        \
+          "-XX:DumpLoadedClassList")                                        \
+                                                                            \
+  product(uintx, ClassPreloadThreads, 0,                                    \
+          "Number of threads loading the classes of ClassPreloadList or "   \
+          "of the JWarmUp record, 0 picks one from the processor count")    \
+                                                                            \
+  product(bool, ClassPreloadFromJWarmUpRecord, false,                       \
+          "With CompilationWarmUp, also preload the classes of the "        \
+          "JWarmUp record in parallel at startup")                          \
+                                                                            \
+  product(bool, PrintClassPreloadStatistics, false,                         \
+          "Print how many classes the class preload threads loaded")        \
+                                                                            \
+  product(ccstr, VerificationCacheFile, NULL,                               \
+          "File remembering the classes the split verifier accepted. "      \
+          "Classes whose bytes and class hierarchy did not change since "   \
+          "are not verified again; the file is written at exit")            \
+                                                                            \
+  product(bool, PrintVerificationCacheStatistics, false,                    \
+          "Print verification cache hits and misses at exit")               \
+                                                                            \
+  product(bool, MetaspaceUncommitFreeChunks, true,                          \
+          "Give the memory of free medium metaspace chunks back to the "    \
+          "OS after class unloading")                                       \
+                                                                            \
+  product(uintx, MetaspaceUncommitDelay, 0,                                 \
+          "Time in milliseconds a free medium metaspace chunk stays "       \
+          "committed before its memory is given back to the OS. 0 "         \
+          "uncommits free chunks right after class unloading")              \
+                                                                            \
+  product(uintx, MetaspaceUncommitWatermark, 0,                             \
+          "Amount of free committed memory in bytes each metaspace "        \
+          "keeps in its chunk free lists instead of uncommitting it")       \
+                                                                            \
+  product(bool, UseAnonymousClassArena, false,                              \
+          "Define the anonymous classes of a host class in a shared "       \
+          "class loader data, which is unloaded once all of its "           \
+          "classes are unreachable")                                        \
+                                                                            \
+  product(uintx, AnonymousClassArenaSize, 64*K,                             \
+          "Metaspace in bytes an anonymous class arena may use before "     \
+          "new anonymous classes of its host class go to a new arena")      \
+                                                                            \
+  product(bool, ParallelClassUnloading, false,                              \
+          "Determine class loader liveness and clean weak klass links "     \
+          "with the GC worker threads when unloading classes")              \
+                                                                            \
+  product(bool, ConcurrentClassLoaderDataFree, false,                       \
+          "Free the metaspace of unloaded class loaders in the service "    \
+          "thread rather than in the GC pause")                             \
+                                                                            \
+  product(bool, DirectLinkConstantCallSites, false,                         \
+          "Link an invokedynamic bound to a constant DirectMethodHandle "   \
+          "of a static method directly to that method, bypassing the "      \
+          "LambdaForm adapters")                                            \
+                                                                            \
+  product(uintx, AllocationSiteSamplingInterval, 0,                         \
+          "Sample the Java heap allocations of each thread about every "    \
+          "this many bytes and account them to the allocating method and "  \
+          "bci, see jcmd GC.allocation_sites. 0 disables sampling")         \
+                                                                            \
+  product(uintx, TieredCompileQueueBatchSize, 0,                            \
+          "Keep the compile queue in priority order and re-rate only this " \
+          "many queued tasks, round robin, when selecting the next task. "  \
+          "0 re-rates the whole queue on every selection")                  \
+                                                                            \
+  product(bool, G1ParallelFullGC, false,                                    \
+          "Mark, adjust and compact the heap with the parallel GC worker "  \
+          "threads in a G1 full GC instead of the serial mark-compact. "    \
+          "Not used with TenantHeapIsolation")                              \
+                                                                            \
+  manageable(uintx, HeapDumpParallelThreads, 1,                             \
+          "Number of GC worker threads used by the heap dump on "           \
+          "OutOfMemoryError, only G1 dumps in parallel")                    \
+                                                                            \
+  manageable(uintx, HeapDumpGzipLevel, 0,                                   \
+          "When non-zero, the heap dump on OutOfMemoryError is written "    \
+          "in gzipped format using the given compression level (1-9)")      \
+                                                                            \
+  product(bool, G1ConcurrentUnloadingCleanup, false,                        \
+          "Leave the cleaning of inline caches that refer to classes and "  \
+          "nmethods unloaded by G1 remark to the code cache sweeper; the "  \
+          "metadata of those classes is freed by the service thread "       \
+          "after the sweeper has visited the whole code cache")             \
+                                                                            \
+  product(bool, G1UseOptionalCSet, false,                                   \
+          "Split the old regions of a mixed collection set into a "         \
+          "mandatory part and an optional part that is evacuated in "       \
+          "increments only while the pause time goal has time left")        \
+                                                                            \
+  product(uintx, G1OptionalCSetPercent, 20,                                 \
+          "Percentage of the time left for old regions in a mixed pause "   \
+          "that is held back to evacuate the optional part of the "         \
+          "collection set")                                                 \
+                                                                            \
+  product(uintx, G1PeriodicGCInterval, 0,                                   \
+          "Number of milliseconds without any GC pause after which G1 "     \
+          "starts a concurrent cycle and gives unused memory back to the "  \
+          "operating system at its remark pause. 0 disables periodic GCs")  \
+                                                                            \
+  product(double, G1PeriodicGCSystemLoadThreshold, 0.0,                     \
+          "Maximum one-minute system load average for periodic GCs to "     \
+          "start. 0.0 disables the system load check")                      \
+                                                                            \
+  product(bool, G1EagerReclaimHumongousObjArrays, false,                    \
+          "Also try to reclaim dead humongous object arrays at every young "\
+          "GC. During concurrent marking only arrays allocated after the "  \
+          "start of the marking are considered. Requires "                  \
+          "G1EagerReclaimHumongousObjects")                                 \
+                                                                            \
+  product(bool, CMSParallelRemarkLargestChunksFirst, true,                  \
+          "Let the parallel CMS initial mark and remark workers claim the " \
+          "sampled eden and survivor chunks in order of decreasing size")   \
   //add new AJVM specific flags here
 
 
@@ -26,6 +26,7 @@
 #include "classfile/classLoader.hpp"
 #include "classfile/symbolTable.hpp"
 #include "classfile/systemDictionary.hpp"
+#include "classfile/verificationCache.hpp"
 #include "code/codeCache.hpp"
 #include "compiler/compileBroker.hpp"
 #include "compiler/compilerOracle.hpp"
@@ -508,6 +509,9 @@ void before_exit(JavaThread * thread) {
   // Stop concurrent GC threads
   Universe::heap()->stop();
 
+  // Save the verification results for the next run
+  VerificationCache::write();
+
   // Print GC/heap related information.
   if (PrintGCDetails) {
     Universe::print();
@@ -42,6 +42,8 @@ Monitor* SystemDictionary_monitor_lock= NULL;
 Mutex*   ProfileRecorder_lock         = NULL;
 Mutex*   PreloadClassChain_lock       = NULL;
 Mutex*   JitWarmUpPrint_lock          = NULL;
+Mutex*   VerificationCache_lock       = NULL;
+Mutex*   AnonymousClassArena_lock     = NULL;
 Mutex*   PackageTable_lock            = NULL;
 Mutex*   CompiledIC_lock              = NULL;
 Mutex*   InlineCacheBuffer_lock       = NULL;
@@ -129,6 +131,7 @@ Mutex*   Management_lock              = NULL;
 Monitor* Service_lock                 = NULL;
 Monitor* PeriodicTask_lock            = NULL;
 Monitor* RedefineClasses_lock         = NULL;
+Mutex*   SafepointProfiler_lock       = NULL;
 
 #ifdef INCLUDE_JFR
 Mutex*   JfrStacktrace_lock           = NULL;
@@ -266,6 +269,8 @@ void mutex_init() {
   def(ProfileRecorder_lock         , Mutex  , nonleaf+2,   true ); // used for JitWarmUp
   def(PreloadClassChain_lock       , Mutex  , max_nonleaf, true ); // used for JitWarmUp
   def(JitWarmUpPrint_lock          , Mutex  , max_nonleaf, true ); // used for JitWarmUp
+  def(VerificationCache_lock       , Mutex  , leaf,        true );
+  def(AnonymousClassArena_lock     , Mutex  , leaf,        true );
   def(PackageTable_lock            , Mutex  , leaf,        false);
   def(InlineCacheBuffer_lock       , Mutex  , leaf,        true );
   def(VMStatistic_lock             , Mutex  , leaf,        false);
@@ -329,6 +334,7 @@ void mutex_init() {
   def(CompileThread_lock           , Monitor, nonleaf+5,   false );
   def(PeriodicTask_lock            , Monitor, nonleaf+5,   true);
   def(RedefineClasses_lock         , Monitor, nonleaf+5,   true);
+  def(SafepointProfiler_lock       , Mutex  , special,     true ); // protects the safepoint profiler history
 
 #if INCLUDE_JFR
   def(JfrMsg_lock                  , Monitor, leaf,        true);
@@ -52,6 +52,8 @@ extern SystemDictMonitor* SystemDictionary_lock; // a lock on the system dictona
 extern Mutex*   ProfileRecorder_lock;            // a lock on the JWarmUP class ProfileRecorder
 extern Mutex*   PreloadClassChain_lock;          // a lock on the JWarmUP preload class chain
 extern Mutex*   JitWarmUpPrint_lock;             // a lock on the JWarmUP jstack print
+extern Mutex*   VerificationCache_lock;          // a lock on the verification cache table
+extern Mutex*   AnonymousClassArena_lock;        // a lock on the table of open anonymous class arenas
 extern Mutex*   PackageTable_lock;               // a lock on the class loader package table
 extern Mutex*   CompiledIC_lock;                 // a lock used to guard compiled IC patching and access
 extern Mutex*   InlineCacheBuffer_lock;          // a lock used to guard the InlineCacheBuffer
@@ -147,6 +149,7 @@ extern Mutex*   Management_lock;                 // a lock used to serialize JVM
 extern Monitor* Service_lock;                    // a lock used for service thread operation
 extern Monitor* PeriodicTask_lock;               // protects the periodic task structure
 extern Monitor* RedefineClasses_lock;            // locks classes from parallel redefinition
+extern Mutex*   SafepointProfiler_lock;          // protects the safepoint profiler history
 
 #if INCLUDE_JFR
 extern Mutex*   JfrStacktrace_lock;              // used to guard access to the JFR stacktrace table
@@ -46,6 +46,7 @@
 #include "runtime/orderAccess.inline.hpp"
 #include "runtime/osThread.hpp"
 #include "runtime/safepoint.hpp"
+#include "runtime/safepointProfiler.hpp"
 #include "runtime/signature.hpp"
 #include "runtime/stubCodeGenerator.hpp"
 #include "runtime/stubRoutines.hpp"
@@ -261,6 +262,8 @@ void SafepointSynchronize::begin() {
   EventSafepointStateSynchronization sync_event;
   int initial_running = 0;
 
+  SafepointProfiler::begin_synchronize();
+
   _state            = _synchronizing;
   OrderAccess::fence();
 
@@ -462,6 +465,9 @@ void SafepointSynchronize::begin() {
     }
   }
 
+  // Blame the threads that were last to reach the safepoint
+  SafepointProfiler::end_synchronize();
+
 #ifdef ASSERT
   for (JavaThread *cur = Threads::first(); cur != NULL; cur = cur->next()) {
     // make sure all the threads were visited
@@ -601,6 +607,8 @@ void SafepointSynchronize::end() {
 bool SafepointSynchronize::is_cleanup_needed() {
   // Need a safepoint if some inline cache buffers is non-empty
   if (!InlineCacheBuffer::is_empty()) return true;
+  // Need a safepoint if no compiler thread will clean the inline caches of unloaded classes
+  if (NMethodSweeper::unloading_cleanup_stalled()) return true;
   return false;
 }
 
@@ -647,6 +655,18 @@ void SafepointSynchronize::do_cleanup_tasks() {
     }
   }
 
+  if (SymbolTable::has_safepoint_work() || StringTable::has_safepoint_work()) {
+    // Must come before the rehashing, which expects a single table
+    const char* name = "finishing symbol and string table resizing";
+    EventSafepointCleanupTask event;
+    TraceTime t9(name, TraceSafepointCleanupTime);
+    SymbolTable::finish_concurrent_work_at_safepoint();
+    StringTable::finish_concurrent_work_at_safepoint();
+    if (event.should_commit()) {
+      post_safepoint_cleanup_task_event(&event, name);
+    }
+  }
+
   if (SymbolTable::needs_rehashing()) {
     const char* name = "rehashing symbol table";
     EventSafepointCleanupTask event;
@@ -789,6 +809,9 @@ void SafepointSynchronize::block(JavaThread *thread) {
         assert(_waiting_to_block > 0, "sanity check");
         _waiting_to_block--;
         thread->safepoint_state()->set_has_called_back(true);
+        if (SafepointProfiler::is_active()) {
+          thread->safepoint_state()->record_reached();
+        }
 
         DEBUG_ONLY(thread->set_visited_for_critical_count(true));
         if (thread->in_critical()) {
@@ -1031,6 +1054,9 @@ void ThreadSafepointState::roll_forward(suspend_type type) {
   switch(_type) {
     case _at_safepoint:
       SafepointSynchronize::signal_thread_at_safepoint();
+      if (SafepointProfiler::is_active()) {
+        record_reached();
+      }
       DEBUG_ONLY(_thread->set_visited_for_critical_count(true));
       if (_thread->in_critical()) {
         // Notice that this thread is in a critical section
@@ -32,6 +32,7 @@
 #include "runtime/mutexLocker.hpp"
 #include "runtime/os.hpp"
 #include "utilities/ostream.hpp"
+#include "utilities/ticks.hpp"
 
 //
 // Safepoint synchronization
@@ -218,6 +219,9 @@ class ThreadSafepointState: public CHeapObj<mtThread> {
   volatile suspend_type          _type;
   JavaThreadState                _orig_thread_state;
 
+  // Time the thread was found safe or called back (safepoint profiling)
+  Ticks                          _reached_time;
+
 
  public:
   ThreadSafepointState(JavaThread *thread);
@@ -233,6 +237,10 @@ class ThreadSafepointState: public CHeapObj<mtThread> {
   bool         is_running() const     { return (_type==_running); }
   JavaThreadState orig_thread_state() const { return _orig_thread_state; }
 
+  // Support for safepoint profiling
+  const Ticks& reached_time() const   { return _reached_time; }
+  void record_reached()               { _reached_time.stamp(); }
+
   // Support for safepoint timeout (debugging)
   bool has_called_back() const                   { return _has_called_back; }
   void set_has_called_back(bool val)             { _has_called_back = val; }
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "precompiled.hpp"
+#include "jfr/jfrEvents.hpp"
+#include "jfr/support/jfrThreadId.hpp"
+#include "memory/resourceArea.hpp"
+#include "oops/method.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/safepoint.hpp"
+#include "runtime/safepointProfiler.hpp"
+#include "runtime/thread.inline.hpp"
+#include "runtime/vframe.hpp"
+#include "runtime/vmThread.hpp"
+#include "runtime/vm_operations.hpp"
+
+extern const char* _get_thread_state_name(JavaThreadState _thread_state);
+
+volatile bool           SafepointProfiler::_is_active = false;
+Ticks                   SafepointProfiler::_sync_start;
+double                  SafepointProfiler::_sync_time_stamp = 0.0;
+SafepointProfileRecord* SafepointProfiler::_history = NULL;
+SafepointLaggard*       SafepointProfiler::_laggard_buffer = NULL;
+uint                    SafepointProfiler::_history_size = 0;
+uint                    SafepointProfiler::_laggards_per_record = 0;
+uint                    SafepointProfiler::_recorded = 0;
+
+void SafepointLaggard::print_on(outputStream* st) const {
+  st->print("  %10.3f ms  \"%s\" %s%s",
+            (double)_time_to_reach / NANOSECS_PER_MILLISEC,
+            _thread_name,
+            _get_thread_state_name(_state),
+            _in_critical ? " (in JNI critical)" : "");
+  if (_bci < 0) {
+    st->print_cr("  <no Java frame>");
+  } else if (_compiled) {
+    st->print_cr("  %s @ %d (compiled, pc=" PTR_FORMAT ")", _method_name, _bci, p2i(_pc));
+  } else {
+    st->print_cr("  %s @ %d (interpreted)", _method_name, _bci);
+  }
+}
+
+void SafepointProfileRecord::print_on(outputStream* st) const {
+  st->print_cr("Safepoint #%d at %.3fs: %s, %d threads, time to safepoint %.3f ms",
+               _safepoint_id, _time_stamp,
+               _vmop_type == -1 ? "no vm operation" : VM_Operation::name(_vmop_type),
+               _nof_threads,
+               (double)_time_to_sync / NANOSECS_PER_MILLISEC);
+  for (int i = 0; i < _nof_laggards; i++) {
+    _laggards[i].print_on(st);
+  }
+}
+
+void SafepointProfiler::initialize_history() {
+  assert(Thread::current()->is_VM_thread(), "only the VM thread records safepoints");
+  if (_history != NULL) {
+    return;
+  }
+  uint history_size = (uint)SafepointProfilerHistorySize;
+  uint laggards = (uint)SafepointProfilerLaggards;
+  SafepointLaggard* laggard_buffer = NEW_C_HEAP_ARRAY(SafepointLaggard, history_size * laggards, mtInternal);
+  SafepointProfileRecord* history = NEW_C_HEAP_ARRAY(SafepointProfileRecord, history_size, mtInternal);
+  for (uint i = 0; i < history_size; i++) {
+    history[i]._nof_laggards = 0;
+    history[i]._laggards = laggard_buffer + i * laggards;
+  }
+
+  MutexLockerEx ml(SafepointProfiler_lock, Mutex::_no_safepoint_check_flag);
+  _laggard_buffer = laggard_buffer;
+  _history_size = history_size;
+  _laggards_per_record = laggards;
+  _recorded = 0;
+  _history = history;
+}
+
+void SafepointProfiler::begin_synchronize() {
+  assert(Thread::current()->is_VM_thread(), "only the VM thread synchronizes safepoints");
+  bool active = UseSafepointProfiler || EventSafepointLaggard::is_enabled();
+  if (active) {
+    _sync_start.stamp();
+    _sync_time_stamp = tty->time_stamp().seconds();
+  }
+  // Published to the Java threads by the fence that follows the
+  // transition to _synchronizing.
+  _is_active = active;
+}
+
+// Collect the threads that were last to reach the safepoint, latest first.
+int SafepointProfiler::select_laggards(JavaThread** laggards, int max) {
+  int count = 0;
+  for (JavaThread* cur = Threads::first(); cur != NULL; cur = cur->next()) {
+    const Ticks reached = cur->safepoint_state()->reached_time();
+    if (reached < _sync_start) {
+      // Not stamped during this synchronization.
+      continue;
+    }
+    int pos = count;
+    while (pos > 0 && laggards[pos - 1]->safepoint_state()->reached_time() < reached) {
+      if (pos < max) {
+        laggards[pos] = laggards[pos - 1];
+      }
+      pos--;
+    }
+    if (pos < max) {
+      laggards[pos] = cur;
+      if (count < max) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+const Method* SafepointProfiler::describe_laggard(JavaThread* thread, SafepointLaggard* laggard) {
+  ThreadSafepointState* state = thread->safepoint_state();
+  laggard->_time_to_reach = (state->reached_time() - _sync_start).nanoseconds();
+  laggard->_state = state->orig_thread_state();
+  laggard->_in_critical = thread->in_critical();
+  laggard->_compiled = false;
+  laggard->_bci = -1;
+  laggard->_pc = NULL;
+  jio_snprintf(laggard->_thread_name, SafepointLaggard::thread_name_length, "%s",
+               thread->get_thread_name());
+  laggard->_method_name[0] = '\0';
+
+  // The thread is stopped, so its stack is walkable. The top Java frame is
+  // the one that contains the poll (or transition) the thread stopped at.
+  const Method* method = NULL;
+  vframeStream vfst(thread);
+  if (!vfst.at_end()) {
+    method = vfst.method();
+    laggard->_bci = vfst.bci();
+    if (!vfst.is_interpreted_frame()) {
+      laggard->_compiled = true;
+      laggard->_pc = vfst.frame_pc();
+    }
+    method->name_and_sig_as_C_string(laggard->_method_name, SafepointLaggard::method_name_length);
+  }
+  return method;
+}
+
+void SafepointProfiler::post_laggard_event(JavaThread* thread,
+                                           const SafepointLaggard* laggard,
+                                           const Method* method) {
+  EventSafepointLaggard event(UNTIMED);
+  if (event.should_commit()) {
+    event.set_starttime(_sync_start);
+    event.set_endtime(thread->safepoint_state()->reached_time());
+    event.set_safepointId(SafepointSynchronize::safepoint_counter());
+    event.set_laggard(JFR_THREAD_ID(thread));
+    event.set_threadState(_get_thread_state_name(laggard->_state));
+    event.set_inCritical(laggard->_in_critical);
+    event.set_method(method);
+    event.set_bci(laggard->_bci);
+    event.set_compiled(laggard->_compiled);
+    event.set_pc((u8)(uintptr_t)laggard->_pc);
+    event.commit();
+  }
+}
+
+void SafepointProfiler::end_synchronize() {
+  assert(SafepointSynchronize::is_at_safepoint(), "all threads must be stopped");
+  if (!_is_active) {
+    return;
+  }
+  _is_active = false;
+
+  const jlong time_to_sync = (Ticks::now() - _sync_start).nanoseconds();
+  const int max_laggards = (int)SafepointProfilerLaggards;
+
+  ResourceMark rm;
+  JavaThread** threads = NEW_RESOURCE_ARRAY(JavaThread*, max_laggards);
+  SafepointLaggard* laggards = NEW_RESOURCE_ARRAY(SafepointLaggard, max_laggards);
+  int count = select_laggards(threads, max_laggards);
+  for (int i = 0; i < count; i++) {
+    const Method* method = describe_laggard(threads[i], &laggards[i]);
+    post_laggard_event(threads[i], &laggards[i], method);
+  }
+
+  if (!UseSafepointProfiler ||
+      time_to_sync < (jlong)SafepointProfilerThreshold * NANOSECS_PER_MILLISEC) {
+    return;
+  }
+
+  initialize_history();
+  VM_Operation* op = VMThread::vm_operation();
+
+  MutexLockerEx ml(SafepointProfiler_lock, Mutex::_no_safepoint_check_flag);
+  SafepointProfileRecord* record = &_history[_recorded % _history_size];
+  record->_safepoint_id = SafepointSynchronize::safepoint_counter();
+  record->_vmop_type = (op != NULL ? op->type() : -1);
+  record->_time_stamp = _sync_time_stamp;
+  record->_time_to_sync = time_to_sync;
+  record->_nof_threads = Threads::number_of_threads();
+  record->_nof_laggards = count;
+  for (int i = 0; i < count; i++) {
+    record->_laggards[i] = laggards[i];
+  }
+  _recorded++;
+}
+
+void SafepointProfiler::print_on(outputStream* st) {
+  if (!UseSafepointProfiler) {
+    st->print_cr("Safepoint profiling is disabled, use -XX:+UseSafepointProfiler to enable it");
+    return;
+  }
+
+  // Copy the history out so that the VM thread is not held up while printing.
+  ResourceMark rm;
+  SafepointProfileRecord* records = NULL;
+  SafepointLaggard* laggards = NULL;
+  uint count = 0;
+  uint recorded = 0;
+  {
+    MutexLockerEx ml(SafepointProfiler_lock, Mutex::_no_safepoint_check_flag);
+    if (_history != NULL) {
+      recorded = _recorded;
+      count = MIN2(_recorded, _history_size);
+      records = NEW_RESOURCE_ARRAY(SafepointProfileRecord, count);
+      laggards = NEW_RESOURCE_ARRAY(SafepointLaggard, count * _laggards_per_record);
+      // Oldest record first.
+      for (uint i = 0; i < count; i++) {
+        const SafepointProfileRecord* src = &_history[(_recorded - count + i) % _history_size];
+        records[i] = *src;
+        records[i]._laggards = laggards + i * _laggards_per_record;
+        for (int j = 0; j < src->_nof_laggards; j++) {
+          records[i]._laggards[j] = src->_laggards[j];
+        }
+      }
+    }
+  }
+
+  st->print_cr("Safepoint profile: %u of %u recorded safepoints "
+               "(threshold " UINTX_FORMAT " ms, " UINTX_FORMAT " laggards per safepoint)",
+               count, recorded, SafepointProfilerThreshold, SafepointProfilerLaggards);
+  for (uint i = 0; i < count; i++) {
+    records[i].print_on(st);
+  }
+}
+
+void SafepointProfiler::reset() {
+  MutexLockerEx ml(SafepointProfiler_lock, Mutex::_no_safepoint_check_flag);
+  _recorded = 0;
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef SHARE_VM_RUNTIME_SAFEPOINTPROFILER_HPP
+#define SHARE_VM_RUNTIME_SAFEPOINTPROFILER_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/globalDefinitions.hpp"
+#include "utilities/ostream.hpp"
+#include "utilities/ticks.hpp"
+
+class JavaThread;
+class Method;
+
+//
+// Time-to-safepoint profiling
+//
+// While a safepoint is being synchronized every JavaThread stamps the time
+// it was found safe (or called back) in its ThreadSafepointState. Once all
+// threads are stopped the VM thread picks the SafepointProfilerLaggards
+// threads that arrived last, resolves the Java frame they stopped in and
+// reports them through the SafepointLaggard JFR event. With
+// -XX:+UseSafepointProfiler the laggards are also kept in a ring buffer
+// of SafepointProfilerHistorySize safepoints that can be printed with
+// the VM.safepoint_profile diagnostic command.
+//
+
+// One of the last threads to reach a safepoint.
+class SafepointLaggard VALUE_OBJ_CLASS_SPEC {
+  friend class SafepointProfiler;
+ public:
+  enum {
+    thread_name_length = 64,
+    method_name_length = 256
+  };
+
+ private:
+  jlong           _time_to_reach;      // nanos from the start of synchronization
+  JavaThreadState _state;              // thread state when synchronization started
+  bool            _in_critical;        // thread was inside a JNI critical region
+  bool            _compiled;           // top Java frame is a compiled frame
+  int             _bci;                // bci of the top Java frame, -1 if none
+  address         _pc;                 // pc of the top frame if compiled
+  char            _thread_name[thread_name_length];
+  char            _method_name[method_name_length];
+
+ public:
+  void print_on(outputStream* st) const;
+};
+
+// Laggards recorded for a single safepoint.
+class SafepointProfileRecord VALUE_OBJ_CLASS_SPEC {
+  friend class SafepointProfiler;
+ private:
+  int               _safepoint_id;
+  int               _vmop_type;        // -1 if there was no VM operation
+  double            _time_stamp;       // seconds since VM start
+  jlong             _time_to_sync;     // nanos until all threads were stopped
+  int               _nof_threads;
+  int               _nof_laggards;
+  SafepointLaggard* _laggards;
+
+ public:
+  void print_on(outputStream* st) const;
+};
+
+class SafepointProfiler : AllStatic {
+ private:
+  static volatile bool           _is_active;  // stamp arrival times for the current safepoint
+  static Ticks                   _sync_start;
+  static double                  _sync_time_stamp;
+  static SafepointProfileRecord* _history;
+  static SafepointLaggard*       _laggard_buffer;
+  static uint                    _history_size;
+  static uint                    _laggards_per_record;
+  static uint                    _recorded;   // total number of records ever written
+
+  static void initialize_history();
+  static int  select_laggards(JavaThread** laggards, int max);
+  static const Method* describe_laggard(JavaThread* thread, SafepointLaggard* laggard);
+  static void post_laggard_event(JavaThread* thread, const SafepointLaggard* laggard,
+                                 const Method* method);
+
+ public:
+  inline static bool is_active() { return _is_active; }
+
+  // Called by the VM thread when it starts to synchronize threads.
+  static void begin_synchronize();
+  // Called by the VM thread once all threads are stopped.
+  static void end_synchronize();
+
+  static void print_on(outputStream* st);
+  static void reset();
+};
+
+#endif // SHARE_VM_RUNTIME_SAFEPOINTPROFILER_HPP
@@ -23,6 +23,8 @@
  */
 
 #include "precompiled.hpp"
+#include "classfile/classLoaderData.hpp"
+#include "classfile/symbolTable.hpp"
 #include "runtime/interfaceSupport.hpp"
 #include "runtime/javaCalls.hpp"
 #include "runtime/serviceThread.hpp"
@@ -88,6 +90,9 @@ void ServiceThread::service_thread_entry(JavaThread* jt, TRAPS) {
     bool has_gc_notification_event = false;
     bool has_dcmd_notification_event = false;
     bool acs_notify = false;
+    bool symbol_table_work = false;
+    bool string_table_work = false;
+    bool cld_free_work = false;
     JvmtiDeferredEvent jvmti_event;
     {
       // Need state transition ThreadBlockInVM so that this thread
@@ -105,9 +110,14 @@ void ServiceThread::service_thread_entry(JavaThread* jt, TRAPS) {
              !(has_jvmti_events = JvmtiDeferredEventQueue::has_events()) &&
               !(has_gc_notification_event = GCNotifier::has_event()) &&
               !(has_dcmd_notification_event = DCmdFactory::has_pending_jmx_notification()) &&
-             !(acs_notify = AllocationContextService::should_notify())) {
+             !(acs_notify = AllocationContextService::should_notify()) &&
+             !(symbol_table_work = SymbolTable::has_work()) &&
+             !(string_table_work = StringTable::has_work()) &&
+             !(cld_free_work = ClassLoaderDataGraph::has_free_pending())) {
         // wait until one of the sensors has pending requests, or there is a
-        // pending JVMTI event or JMX GC notification to post
+        // pending JVMTI event or JMX GC notification to post, or one of the
+        // symbol and string tables needs resizing or cleaning, or unloaded
+        // class loader data needs freeing
         Service_lock->wait(Mutex::_no_safepoint_check_flag);
       }
 
@@ -135,6 +145,18 @@ void ServiceThread::service_thread_entry(JavaThread* jt, TRAPS) {
     if (acs_notify) {
       AllocationContextService::notify(CHECK);
     }
+
+    if (symbol_table_work) {
+      SymbolTable::do_concurrent_work(jt);
+    }
+
+    if (string_table_work) {
+      StringTable::do_concurrent_work(jt);
+    }
+
+    if (cld_free_work) {
+      ClassLoaderDataGraph::free_pending_clds();
+    }
   }
 }
 
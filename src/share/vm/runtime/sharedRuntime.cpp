@@ -2800,9 +2800,13 @@ void SharedRuntime::get_utf(oopDesc* src, address dst) {
   typeArrayOop jlsValue  = java_lang_String::value(src);
   int          jlsOffset = java_lang_String::offset(src);
   int          jlsLen    = java_lang_String::length(src);
+  if (java_lang_String::is_latin1(src)) {
+    jbyte* jlsPos = (jlsLen == 0) ? NULL : jlsValue->byte_at_addr(0);
+    (void) UNICODE::as_utf8(jlsPos, jlsLen, (char *)dst, max_dtrace_string_size);
+    return;
+  }
   jchar*       jlsPos    = (jlsLen == 0) ? NULL :
                                            jlsValue->char_at_addr(jlsOffset);
-  assert(TypeArrayKlass::cast(jlsValue->klass())->element_type() == T_CHAR, "compressed string");
   (void) UNICODE::as_utf8(jlsPos, jlsLen, (char *)dst, max_dtrace_string_size);
 }
 #endif // ndef HAVE_DTRACE_H
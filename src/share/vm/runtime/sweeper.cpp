@@ -23,6 +23,7 @@
  */
 
 #include "precompiled.hpp"
+#include "classfile/classLoaderData.hpp"
 #include "code/codeCache.hpp"
 #include "code/compiledIC.hpp"
 #include "code/icBuffer.hpp"
@@ -148,6 +149,8 @@ volatile int  NMethodSweeper::_bytes_changed           = 0;    // Counts the tot
                                                                //   1) alive       -> not_entrant
                                                                //   2) not_entrant -> zombie
                                                                //   3) zombie      -> marked_for_reclamation
+long   NMethodSweeper::_unloading_cleanup_traversal    = 0;    // Traversal that cleans the inline caches referring to unloading classes
+long   NMethodSweeper::_unloading_ics_cleaned          = 0;    // Nof. inline caches cleaned because they referred to unloading classes
 int    NMethodSweeper::_hotness_counter_reset_val       = 0;
 
 long   NMethodSweeper::_total_nof_methods_reclaimed     = 0;    // Accumulated nof methods flushed
@@ -197,11 +200,69 @@ bool NMethodSweeper::sweep_in_progress() {
   return (_current != NULL);
 }
 
+bool NMethodSweeper::can_clean_unloading_caches() {
+  // Only compiler threads sweep.
+  return MethodFlushing && UseCompiler && !CompileBroker::is_compilation_disabled_forever();
+}
+
+void NMethodSweeper::request_unloading_cleanup() {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be executed at a safepoint");
+  assert(can_clean_unloading_caches(), "nobody would sweep");
+  if (!unloading_cleanup_pending()) {
+    _unloading_ics_cleaned = 0;
+  }
+  // A traversal in progress may already have passed some nmethods, so only
+  // the next traversal is guaranteed to visit all of them.
+  _unloading_cleanup_traversal = _traversals + 1;
+  _should_sweep = true;
+  if (TraceClassUnloading) {
+    tty->print_cr("[Deferring inline cache cleaning of unloaded classes to sweep %ld]",
+                  _unloading_cleanup_traversal);
+  }
+}
+
+// Traversals only start at a safepoint, so a thread that does not let a
+// safepoint happen sees a stable answer once it got false.
+bool NMethodSweeper::unloading_cleanup_pending() {
+  if (_unloading_cleanup_traversal == 0) {
+    return false;
+  }
+  long completed = sweep_in_progress() ? _traversals - 1 : _traversals;
+  OrderAccess::loadload();
+  return completed < _unloading_cleanup_traversal;
+}
+
+bool NMethodSweeper::unloading_cleanup_stalled() {
+  return unloading_cleanup_pending() && !can_clean_unloading_caches();
+}
+
+// Cleans the inline caches like the remark pause would have done, and lets
+// the service thread free the metadata of the unloaded classes.
+void NMethodSweeper::clean_unloading_caches_at_safepoint() {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be executed at a safepoint");
+  for (nmethod* nm = CodeCache::first_nmethod(); nm != NULL; nm = CodeCache::next_nmethod(nm)) {
+    if (nm->is_alive()) {
+      _unloading_ics_cleaned += nm->cleanup_inline_caches(true);
+    }
+  }
+  _unloading_cleanup_traversal = 0;
+  if (TraceClassUnloading) {
+    tty->print_cr("[Compilation is disabled, cleaned %ld inline caches of unloaded classes at a safepoint]",
+                  _unloading_ics_cleaned);
+  }
+  MutexLockerEx ml(Service_lock, Mutex::_no_safepoint_check_flag);
+  Service_lock->notify_all();
+}
+
 // Scans the stacks of all Java threads and marks activations of not-entrant methods.
 // No need to synchronize access, since 'mark_active_nmethods' is always executed at a
 // safepoint.
 void NMethodSweeper::mark_active_nmethods() {
   assert(SafepointSynchronize::is_at_safepoint(), "must be executed at a safepoint");
+  if (unloading_cleanup_stalled()) {
+    clean_unloading_caches_at_safepoint();
+  }
+
   // If we do not want to reclaim not-entrant or zombie methods there is no need
   // to scan stacks
   if (!MethodFlushing) {
@@ -312,6 +373,19 @@ void NMethodSweeper::possibly_sweep() {
       if (_should_sweep) {
         _bytes_changed = 0;
       }
+      if (_unloading_cleanup_traversal != 0 && !unloading_cleanup_pending()) {
+        if (TraceClassUnloading) {
+          tty->print_cr("[Sweep %ld cleaned %ld inline caches of unloaded classes]",
+                        _unloading_cleanup_traversal, _unloading_ics_cleaned);
+        }
+        _unloading_cleanup_traversal = 0;
+      }
+      if (ClassLoaderDataGraph::has_free_pending()) {
+        // This traversal may have been the one the service thread waits for
+        // to free the metadata of unloaded classes.
+        MutexLockerEx ml(Service_lock, Mutex::_no_safepoint_check_flag);
+        Service_lock->notify_all();
+      }
     }
     // Release work, because another compiler thread could continue.
     OrderAccess::release_store((int*)&_sweep_started, 0);
@@ -354,6 +428,10 @@ void NMethodSweeper::sweep_code_cache() {
     // threads will slow down sweeping.
     _sweep_fractions_left = 1;
   }
+  if (unloading_cleanup_pending()) {
+    // The metadata of unloaded classes is freed only after this traversal.
+    _sweep_fractions_left = 1;
+  }
 
   // We want to visit all nmethods after NmethodSweepFraction
   // invocations so divide the remaining number of nmethods by the
@@ -509,13 +587,16 @@ int NMethodSweeper::process_nmethod(nmethod *nm) {
   NMethodMarker nmm(nm);
   SWEEP(nm);
 
+  // Inline caches that refer to unloading classes have to be cleaned as well.
+  bool clean_metadata = unloading_cleanup_pending();
+
   // Skip methods that are currently referenced by the VM
   if (nm->is_locked_by_vm()) {
     // But still remember to clean-up inline caches for alive nmethods
     if (nm->is_alive()) {
       // Clean inline caches that point to zombie/non-entrant methods
       MutexLocker cl(CompiledIC_lock);
-      nm->cleanup_inline_caches();
+      _unloading_ics_cleaned += nm->cleanup_inline_caches(clean_metadata);
       SWEEP(nm);
     }
     return freed_memory;
@@ -564,7 +645,7 @@ int NMethodSweeper::process_nmethod(nmethod *nm) {
     } else {
       // Still alive, clean up its inline caches
       MutexLocker cl(CompiledIC_lock);
-      nm->cleanup_inline_caches();
+      _unloading_ics_cleaned += nm->cleanup_inline_caches(clean_metadata);
       SWEEP(nm);
     }
   } else if (nm->is_unloaded()) {
@@ -586,7 +667,7 @@ int NMethodSweeper::process_nmethod(nmethod *nm) {
         // Clean ICs of unloaded nmethods as well because they may reference other
         // unloaded nmethods that may be flushed earlier in the sweeper cycle.
         MutexLocker cl(CompiledIC_lock);
-        nm->cleanup_inline_caches();
+        _unloading_ics_cleaned += nm->cleanup_inline_caches(clean_metadata);
       }
       // Code cache state change is tracked in make_zombie()
       nm->make_zombie();
@@ -627,7 +708,7 @@ int NMethodSweeper::process_nmethod(nmethod *nm) {
     }
     // Clean-up all inline caches that point to zombie/non-reentrant methods
     MutexLocker cl(CompiledIC_lock);
-    nm->cleanup_inline_caches();
+    _unloading_ics_cleaned += nm->cleanup_inline_caches(clean_metadata);
     SWEEP(nm);
   }
   return freed_memory;
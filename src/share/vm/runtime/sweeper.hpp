@@ -71,6 +71,8 @@ class NMethodSweeper : public AllStatic {
                                                     //   1) alive       -> not_entrant
                                                     //   2) not_entrant -> zombie
                                                     //   3) zombie      -> marked_for_reclamation
+  static long      _unloading_cleanup_traversal;    // Traversal that cleans the inline caches referring to unloading classes
+  static long      _unloading_ics_cleaned;          // Nof. inline caches cleaned because they referred to unloading classes
   // Stat counters
   static long      _total_nof_methods_reclaimed;    // Accumulated nof methods flushed
   static long      _total_nof_c2_methods_reclaimed; // Accumulated nof C2-compiled methods flushed
@@ -87,6 +89,7 @@ class NMethodSweeper : public AllStatic {
 
   static bool sweep_in_progress();
   static void sweep_code_cache();
+  static void clean_unloading_caches_at_safepoint();
 
  public:
   static long traversal_count()              { return _traversals; }
@@ -112,6 +115,16 @@ class NMethodSweeper : public AllStatic {
   static void report_state_change(nmethod* nm);
   static void possibly_enable_sweeper();
   static void print();   // Printing/debugging
+
+  // Inline caches that refer to unloaded classes and nmethods can be left to
+  // the sweeper (see G1ConcurrentUnloadingCleanup). The metadata of the
+  // unloaded classes must not be freed before a full traversal has cleaned them.
+  static bool can_clean_unloading_caches();
+  static void request_unloading_cleanup();   // Invoked at the safepoint that unloaded the classes
+  static bool unloading_cleanup_pending();
+  // Compilation was disabled for good while a cleanup was pending, so no
+  // compiler thread will sweep. The next safepoint cleans the inline caches.
+  static bool unloading_cleanup_stalled();
 };
 
 #endif // SHARE_VM_RUNTIME_SWEEPER_HPP
@@ -24,6 +24,7 @@
 
 #include "precompiled.hpp"
 #include "classfile/classLoader.hpp"
+#include "classfile/classPreloader.hpp"
 #include "classfile/javaClasses.hpp"
 #include "classfile/systemDictionary.hpp"
 #include "classfile/vmSymbols.hpp"
@@ -103,6 +104,7 @@
 #include "gc_implementation/g1/concurrentMarkThread.inline.hpp"
 #include "gc_implementation/parallelScavenge/pcTasks.hpp"
 #include "gc_implementation/g1/elasticHeap.hpp"
+#include "gc_implementation/g1/g1PeriodicGC.hpp"
 #endif // INCLUDE_ALL_GCS
 #ifdef COMPILER1
 #include "c1/c1_Compiler.hpp"
@@ -3849,6 +3851,9 @@ jint Threads::create_vm(JavaVMInitArgs* args, bool* canTryAgain) {
 
     initialize_class(vmSymbols::java_lang_String(), CHECK_0);
 
+    // Inject CompactStrings value after the static initializers for String ran.
+    java_lang_String::set_compact_strings(CompactStrings);
+
     // Initialize java_lang.System (needed before creating the thread)
     initialize_class(vmSymbols::java_lang_System(), CHECK_0);
     initialize_class(vmSymbols::java_lang_ThreadGroup(), CHECK_0);
@@ -3990,6 +3995,12 @@ jint Threads::create_vm(JavaVMInitArgs* args, bool* canTryAgain) {
       vm_exit_during_initialization(Handle(THREAD, PENDING_EXCEPTION));
     }
   }
+  if (UseG1GC && G1PeriodicGCInterval != 0) {
+    G1PeriodicGC::start();
+    if (HAS_PENDING_EXCEPTION) {
+      vm_exit_during_initialization(Handle(THREAD, PENDING_EXCEPTION));
+    }
+  }
 #endif // INCLUDE_ALL_GCS
 
   // Always call even when there are not JVMTI environments yet, since environments
@@ -4062,6 +4073,12 @@ jint Threads::create_vm(JavaVMInitArgs* args, bool* canTryAgain) {
     jwp->preloader()->jvm_booted_is_done();
   }
 
+  // Start loading the classes of -XX:ClassPreloadList in the background
+  ClassPreloader::initialize(THREAD);
+  if (HAS_PENDING_EXCEPTION) {
+    CLEAR_PENDING_EXCEPTION;
+  }
+
 #if INCLUDE_RTM_OPT
   RTMLockingCounters::init();
 #endif
@@ -98,6 +98,7 @@
   template(RotateGCLog)                           \
   template(WhiteBoxOperation)                     \
   template(ClassLoaderStatsOperation)             \
+  template(PrintMetadata)                         \
   template(DestroyG1TenantAllocationContext)      \
   template(JFROldObject)                          \
 
@@ -328,6 +329,19 @@ class VM_PrintJNI: public VM_Operation {
   void doit();
 };
 
+class VM_PrintMetadata : public VM_Operation {
+ private:
+  outputStream* _out;
+  size_t        _scale;
+  bool          _show_loaders;
+ public:
+  VM_PrintMetadata(outputStream* out, size_t scale, bool show_loaders)
+    : _out(out), _scale(scale), _show_loaders(show_loaders) {}
+
+  VMOp_Type type() const  { return VMOp_PrintMetadata; }
+  void doit();
+};
+
 class DeadlockCycle;
 class VM_FindDeadlocks: public VM_Operation {
  private:
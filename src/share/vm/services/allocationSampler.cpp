@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "precompiled.hpp"
+#include "classfile/classLoaderData.hpp"
+#include "memory/allocation.inline.hpp"
+#include "memory/resourceArea.hpp"
+#include "memory/threadLocalAllocBuffer.hpp"
+#include "oops/method.hpp"
+#include "runtime/os.hpp"
+#include "runtime/safepoint.hpp"
+#include "runtime/thread.inline.hpp"
+#include "runtime/vframe.hpp"
+#include "services/allocationSampler.hpp"
+#include "utilities/growableArray.hpp"
+#include "utilities/ostream.hpp"
+
+AllocationSiteEntry* volatile AllocationSiteTable::_table[AllocationSiteTable::table_size];
+
+AllocationSiteEntry* AllocationSiteTable::lookup_or_add(Method* method, int bci) {
+  unsigned int index = hash_to_index(method, bci);
+
+  // First entry for this hash bucket
+  if (_table[index] == NULL) {
+    AllocationSiteEntry* entry = new (std::nothrow) AllocationSiteEntry(method, bci);
+    if (entry == NULL) return NULL;
+
+    // swap in the head
+    if (Atomic::cmpxchg_ptr((void*)entry, (volatile void*)&_table[index], NULL) == NULL) {
+      return entry;
+    }
+    delete entry;
+  }
+
+  AllocationSiteEntry* head = _table[index];
+  while (head != NULL) {
+    if (head->equals(method, bci)) {
+      return head;
+    }
+    if (head->next() == NULL) {
+      AllocationSiteEntry* entry = new (std::nothrow) AllocationSiteEntry(method, bci);
+      if (entry == NULL) return NULL;
+      if (head->atomic_insert(entry)) {
+        return entry;
+      }
+      // contended, other thread won
+      delete entry;
+    }
+    head = head->next();
+  }
+  return NULL;
+}
+
+bool AllocationSiteTable::record(Method* method, int bci, size_t bytes) {
+  AllocationSiteEntry* site = lookup_or_add(method, bci);
+  if (site != NULL) {
+    site->sample(bytes);
+  }
+  return site != NULL;
+}
+
+bool AllocationSiteTable::is_dead(AllocationSiteEntry* entry) {
+  Method* m = entry->method();
+  if (m == NULL) {
+    return false;
+  }
+  // on_stack() is only set while the metadata on stack is being marked,
+  // otherwise all redefined methods are dropped.
+  return m->method_holder()->class_loader_data()->is_unloading() ||
+         (m->is_old() && !m->on_stack());
+}
+
+void AllocationSiteTable::purge() {
+  assert(SafepointSynchronize::is_at_safepoint(), "only called at safepoint");
+  for (int index = 0; index < table_size; index++) {
+    AllocationSiteEntry* volatile* p = &_table[index];
+    while (*p != NULL) {
+      AllocationSiteEntry* entry = *p;
+      if (is_dead(entry)) {
+        *p = entry->next();
+        delete entry;
+      } else {
+        p = &entry->_next;
+      }
+    }
+  }
+}
+
+void AllocationSiteTable::reset() {
+  for (int index = 0; index < table_size; index++) {
+    for (AllocationSiteEntry* e = _table[index]; e != NULL; e = e->next()) {
+      Atomic::store((jlong)0, &e->_bytes);
+      Atomic::store((jlong)0, &e->_samples);
+    }
+  }
+}
+
+static int compare_bytes(AllocationSiteEntry** e1, AllocationSiteEntry** e2) {
+  jlong b1 = (*e1)->bytes();
+  jlong b2 = (*e2)->bytes();
+  return b1 > b2 ? -1 : (b1 < b2 ? 1 : 0);
+}
+
+static void print_site(outputStream* st, Method* m, int bci) {
+  if (m == NULL) {
+    st->print("<no Java frame>");
+    return;
+  }
+  st->print("%s @ %d", m->name_and_sig_as_C_string(), bci);
+  if (m->is_native() || bci < 0 || bci >= m->code_size()) {
+    return;
+  }
+  Bytecodes::Code code = m->java_code_at(bci);
+  address bcp = m->bcp_from(bci);
+  st->print(" %s", Bytecodes::name(code));
+  switch (code) {
+    case Bytecodes::_new:
+    case Bytecodes::_anewarray:
+    case Bytecodes::_multianewarray:
+      st->print(" %s", m->constants()->klass_name_at(Bytes::get_Java_u2(bcp + 1))->as_klass_external_name());
+      break;
+    case Bytecodes::_newarray:
+      st->print(" %s", type2name((BasicType)bcp[1]));
+      break;
+    default:
+      break;
+  }
+  int line = m->line_number_from_bci(bci);
+  if (line != -1) {
+    st->print(" (line %d)", line);
+  }
+}
+
+// The caller is in the VM, so no safepoint can purge the table meanwhile.
+void AllocationSiteTable::print_on(outputStream* st, int max_sites) {
+  ResourceMark rm;
+  GrowableArray<AllocationSiteEntry*> sites(256);
+  jlong total_bytes = 0;
+  jlong total_samples = 0;
+  for (int index = 0; index < table_size; index++) {
+    for (AllocationSiteEntry* e = _table[index]; e != NULL; e = e->next()) {
+      if (e->samples() > 0) {
+        sites.append(e);
+        total_bytes += e->bytes();
+        total_samples += e->samples();
+      }
+    }
+  }
+  sites.sort(compare_bytes);
+
+  st->print_cr("Allocation sites sampled every " UINTX_FORMAT " bytes: %d sites, "
+               JLONG_FORMAT " samples, " JLONG_FORMAT "K",
+               AllocationSiteSamplingInterval, sites.length(), total_samples, total_bytes / K);
+  st->print_cr("%12s %10s  %s", "Bytes", "Samples", "Site");
+  int n = max_sites > 0 ? MIN2(max_sites, sites.length()) : sites.length();
+  for (int i = 0; i < n; i++) {
+    AllocationSiteEntry* e = sites.at(i);
+    st->print(INT64_FORMAT_W(12) " " INT64_FORMAT_W(10) "  ", e->bytes(), e->samples());
+    print_site(st, e->method(), e->bci());
+    st->cr();
+  }
+}
+
+size_t AllocationSampler::next_sample_distance() {
+  // Randomize the distance around the interval so that the samples do not
+  // follow a periodic allocation pattern.
+  size_t interval = AllocationSiteSamplingInterval;
+  return interval / 2 + (size_t)os::random() % interval;
+}
+
+// Account the bytes to the bytecode that is allocating. For compiled code
+// the top vframe is decoded from the debug info at the runtime call, so
+// inlined allocation sites are told apart as well.
+void AllocationSampler::record_sample(Thread* thread, size_t bytes) {
+  Method* method = NULL;
+  int bci = 0;
+  if (thread->is_Java_thread()) {
+    ResourceMark rm(thread);
+    vframeStream vfst((JavaThread*)thread);
+    if (!vfst.at_end()) {
+      method = vfst.method();
+      bci = vfst.bci();
+    }
+  }
+  AllocationSiteTable::record(method, bci, bytes);
+}
+
+void AllocationSampler::sample_allocation(Thread* thread) {
+  ThreadLocalAllocBuffer& tlab = thread->tlab();
+  tlab.charge_sampled_bytes(0);
+  record_sample(thread, tlab.sample_distance());
+  tlab.pick_next_sample();
+}
+
+void AllocationSampler::sample_outside_tlab(Thread* thread, size_t bytes) {
+  ThreadLocalAllocBuffer& tlab = thread->tlab();
+  if (tlab.charge_sampled_bytes(bytes)) {
+    record_sample(thread, tlab.sample_distance());
+    tlab.pick_next_sample();
+  } else {
+    tlab.set_sample_end();
+  }
+}
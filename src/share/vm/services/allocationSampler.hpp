@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef SHARE_VM_SERVICES_ALLOCATIONSAMPLER_HPP
+#define SHARE_VM_SERVICES_ALLOCATIONSAMPLER_HPP
+
+#include "memory/allocation.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/globals.hpp"
+
+class Method;
+class outputStream;
+class Thread;
+
+// An allocation site is a bytecode of a Java method that allocated sampled
+// heap memory. Sites with no Java frame, e.g. those of VM internal
+// allocations, are recorded with a NULL method.
+class AllocationSiteEntry : public CHeapObj<mtInternal> {
+  friend class AllocationSiteTable;
+ private:
+  Method*               _method;
+  int                   _bci;
+  volatile jlong        _bytes;
+  volatile jlong        _samples;
+  AllocationSiteEntry*  _next;
+
+ public:
+  AllocationSiteEntry(Method* method, int bci) :
+    _method(method), _bci(bci), _bytes(0), _samples(0), _next(NULL) { }
+
+  Method* method() const { return _method; }
+  int     bci() const    { return _bci; }
+  jlong   bytes() const  { return _bytes; }
+  jlong   samples() const { return _samples; }
+  AllocationSiteEntry* next() const { return _next; }
+
+  bool equals(Method* method, int bci) const {
+    return _method == method && _bci == bci;
+  }
+
+  void sample(size_t bytes) {
+    Atomic::add((jlong)bytes, &_bytes);
+    Atomic::add((jlong)1, &_samples);
+  }
+
+  // Insert an entry atomically.
+  // Return true if the entry is inserted successfully.
+  bool atomic_insert(AllocationSiteEntry* entry) {
+    return Atomic::cmpxchg_ptr((void*)entry, (volatile void*)&_next, NULL) == NULL;
+  }
+};
+
+/*
+ * Table of the sampled allocation sites.
+ * Like the malloc site table, entries are linked into their hash bucket
+ * with compare-and-swap and are never removed while Java threads run, so
+ * recording a sample takes no lock. Entries of unloaded classes and of
+ * freed redefined methods are removed at a safepoint.
+ */
+class AllocationSiteTable : AllStatic {
+ private:
+  enum {
+    table_size = 4093
+  };
+
+  static AllocationSiteEntry* volatile _table[table_size];
+
+  static unsigned int hash_to_index(Method* method, int bci) {
+    uintptr_t hash = ((uintptr_t)method >> LogBytesPerWord) ^ ((uintptr_t)bci * 31);
+    return (unsigned int)(hash % table_size);
+  }
+
+  static AllocationSiteEntry* lookup_or_add(Method* method, int bci);
+  static bool is_dead(AllocationSiteEntry* entry);
+
+ public:
+  // Account bytes to the site, return false if out of memory.
+  static bool record(Method* method, int bci, size_t bytes);
+
+  // Remove the sites of unloading classes and of redefined methods that
+  // are no longer on stack. Must be called at a safepoint before their
+  // metadata is freed.
+  static void purge();
+
+  static void reset();
+  static void print_on(outputStream* st, int max_sites);
+};
+
+// Samples the Java heap allocations of each thread about every
+// AllocationSiteSamplingInterval bytes. The sample point is tracked by the
+// thread's TLAB; allocations crossing it take the slow path and are
+// accounted to the method and bci of the top Java frame, along with the
+// bytes allocated since the previous sample.
+class AllocationSampler : AllStatic {
+ private:
+  static void record_sample(Thread* thread, size_t bytes);
+
+ public:
+  static bool enabled() { return AllocationSiteSamplingInterval > 0; }
+
+  static size_t next_sample_distance();
+
+  // An allocation in the TLAB reached the sample end.
+  static void sample_allocation(Thread* thread);
+  // An allocation outside of the TLAB.
+  static void sample_outside_tlab(Thread* thread, size_t bytes);
+};
+
+#endif // SHARE_VM_SERVICES_ALLOCATIONSAMPLER_HPP
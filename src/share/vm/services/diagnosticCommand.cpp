@@ -27,11 +27,14 @@
 #include "gc_implementation/shared/vmGCOperations.hpp"
 #include "runtime/javaCalls.hpp"
 #include "runtime/os.hpp"
+#include "runtime/safepointProfiler.hpp"
+#include "services/allocationSampler.hpp"
 #include "services/diagnosticArgument.hpp"
 #include "services/diagnosticCommand.hpp"
 #include "services/diagnosticFramework.hpp"
 #include "services/heapDumper.hpp"
 #include "services/management.hpp"
+#include "services/nmtCommon.hpp"
 #include "utilities/macros.hpp"
 #include "oops/objArrayOop.hpp"
 #include "gc_implementation/g1/elasticHeap.hpp"
@@ -52,6 +55,7 @@ void DCmdRegistrant::register_dcmds(){
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<PrintVMFlagsDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<VMDynamicLibrariesDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<VMUptimeDCmd>(full_export, true, false));
+  DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<SafepointProfileDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<SystemGCDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<RunFinalizationDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<HeapInfoDCmd>(full_export, true, false));
@@ -65,6 +69,8 @@ void DCmdRegistrant::register_dcmds(){
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<RotateGCLogDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<ClassLoaderStatsDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<JWarmupDCmd>(full_export, true, false));
+  DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<MetaspaceDCmd>(full_export, true, false));
+  DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<AllocationSitesDCmd>(full_export, true, false));
 
   // Enhanced JMX Agent Support
   // These commands won't be exported via the DiagnosticCommandMBean until an
@@ -265,6 +271,30 @@ int VMUptimeDCmd::num_arguments() {
   }
 }
 
+SafepointProfileDCmd::SafepointProfileDCmd(outputStream* output, bool heap) :
+                                           DCmdWithParser(output, heap),
+  _reset("-reset", "Clear the history after printing it", "BOOLEAN", false, "false") {
+  _dcmdparser.add_dcmd_option(&_reset);
+}
+
+void SafepointProfileDCmd::execute(DCmdSource source, TRAPS) {
+  SafepointProfiler::print_on(output());
+  if (_reset.value()) {
+    SafepointProfiler::reset();
+  }
+}
+
+int SafepointProfileDCmd::num_arguments() {
+  ResourceMark rm;
+  SafepointProfileDCmd* dcmd = new SafepointProfileDCmd(NULL, false);
+  if (dcmd != NULL) {
+    DCmdMark mark(dcmd);
+    return dcmd->_dcmdparser.num_arguments();
+  } else {
+    return 0;
+  }
+}
+
 void SystemGCDCmd::execute(DCmdSource source, TRAPS) {
   if (!DisableExplicitGC) {
     Universe::heap()->collect(GCCause::_java_lang_system_gc);
@@ -344,17 +374,44 @@ HeapDumpDCmd::HeapDumpDCmd(outputStream* output, bool heap) :
   _all("-all", "Dump all objects, including unreachable objects",
        "BOOLEAN", false, "false"),
   _mini_dump("-mini", "Use mini-dump format",
-       "BOOLEAN", false, "false") {
+       "BOOLEAN", false, "false"),
+  _parallel("-parallel", "Number of GC worker threads dumping the heap, "
+       "only G1 dumps in parallel. Prints the progress of the dump to the VM output",
+       "INT", false, "1"),
+  _gzip("-gz", "If specified, the heap dump is written in gzipped format "
+       "using the given compression level, 1 (fastest) to 9 (strongest)",
+       "INT", false) {
   _dcmdparser.add_dcmd_option(&_all);
   _dcmdparser.add_dcmd_option(&_mini_dump);
+  _dcmdparser.add_dcmd_option(&_parallel);
+  _dcmdparser.add_dcmd_option(&_gzip);
   _dcmdparser.add_dcmd_argument(&_filename);
 }
 
 void HeapDumpDCmd::execute(DCmdSource source, TRAPS) {
+  jlong parallel = _parallel.value();
+  if (parallel < 1 || parallel > max_jint) {
+    output()->print_cr("Invalid number of parallel dump threads: " JLONG_FORMAT, parallel);
+    return;
+  }
+  jlong level = 0;
+  if (_gzip.is_set()) {
+    level = _gzip.value();
+    if (level < 1 || level > 9) {
+      output()->print_cr("Compression level out of range (1-9): " JLONG_FORMAT, level);
+      return;
+    }
+  }
+
   // Request a full GC before heap dump if _all is false
   // This helps reduces the amount of unreachable objects in the dump
   // and makes it easier to browse.
   HeapDumper dumper(!_all.value() /* request GC if _all is false*/, _mini_dump.value());
+  dumper.set_parallel_thread_num((uint)parallel);
+  dumper.set_compression_level((int)level);
+  if (_parallel.is_set()) {
+    dumper.set_report_progress(true);
+  }
   int res = dumper.dump(_filename.value());
   if (res == 0) {
     if (_mini_dump.value()) {
@@ -388,13 +445,31 @@ int HeapDumpDCmd::num_arguments() {
 ClassHistogramDCmd::ClassHistogramDCmd(outputStream* output, bool heap) :
                                        DCmdWithParser(output, heap),
   _all("-all", "Inspect all objects, including unreachable objects",
-       "BOOLEAN", false, "false") {
+       "BOOLEAN", false, "false"),
+  _parallel("-parallel", "Number of GC worker threads inspecting the heap, "
+       "only G1 inspects in parallel", "INT", false, "1"),
+  _sample("-sample", "Percentage of the heap regions to inspect, the histogram "
+       "is estimated from them. Only supported with G1", "INT", false, "100") {
   _dcmdparser.add_dcmd_option(&_all);
+  _dcmdparser.add_dcmd_option(&_parallel);
+  _dcmdparser.add_dcmd_option(&_sample);
 }
 
 void ClassHistogramDCmd::execute(DCmdSource source, TRAPS) {
+  if (_parallel.value() < 1 || _parallel.value() > max_jint) {
+    output()->print_cr("Invalid number of parallel inspection threads: " JLONG_FORMAT,
+                       _parallel.value());
+    return;
+  }
+  if (_sample.value() < 1 || _sample.value() > 100) {
+    output()->print_cr("Sample percentage out of range (1-100): " JLONG_FORMAT,
+                       _sample.value());
+    return;
+  }
   VM_GC_HeapInspection heapop(output(),
                               !_all.value() /* request full gc if false */);
+  heapop.set_parallel_thread_num((uint)_parallel.value());
+  heapop.set_sample_percent((uint)_sample.value());
   VMThread::execute(&heapop);
 }
 
@@ -852,6 +927,74 @@ void JWarmupDCmd::print_info() {
                        _notify_startup.description(), _check_compile_finished.description(), _deopt.description(), _help.description());
 }
 
+MetaspaceDCmd::MetaspaceDCmd(outputStream* output, bool heap) :
+                               DCmdWithParser(output, heap),
+  _show_loaders("show-loaders", "Also print the metaspace usage of each class loader",
+                "BOOLEAN", false, "false"),
+  _scale("scale", "Memory usage in which scale, KB, MB or GB",
+         "STRING", false, "KB") {
+  _dcmdparser.add_dcmd_option(&_show_loaders);
+  _dcmdparser.add_dcmd_option(&_scale);
+}
+
+int MetaspaceDCmd::num_arguments() {
+  ResourceMark rm;
+  MetaspaceDCmd* dcmd = new MetaspaceDCmd(NULL, false);
+  if (dcmd != NULL) {
+    DCmdMark mark(dcmd);
+    return dcmd->_dcmdparser.num_arguments();
+  } else {
+    return 0;
+  }
+}
+
+void MetaspaceDCmd::execute(DCmdSource source, TRAPS) {
+  size_t scale = NMTUtil::scale_from_name(_scale.value());
+  if (scale == 0) {
+    output()->print_cr("Incorrect scale value: %s", _scale.value());
+    return;
+  }
+  VM_PrintMetadata op(output(), scale, _show_loaders.value());
+  VMThread::execute(&op);
+}
+
+AllocationSitesDCmd::AllocationSitesDCmd(outputStream* output, bool heap) :
+                                           DCmdWithParser(output, heap),
+  _top("top", "Number of sites to print, 0 prints all of them",
+       "INT", false, "20"),
+  _reset("-reset", "Clear the counters after printing them",
+         "BOOLEAN", false, "false") {
+  _dcmdparser.add_dcmd_option(&_top);
+  _dcmdparser.add_dcmd_option(&_reset);
+}
+
+int AllocationSitesDCmd::num_arguments() {
+  ResourceMark rm;
+  AllocationSitesDCmd* dcmd = new AllocationSitesDCmd(NULL, false);
+  if (dcmd != NULL) {
+    DCmdMark mark(dcmd);
+    return dcmd->_dcmdparser.num_arguments();
+  } else {
+    return 0;
+  }
+}
+
+void AllocationSitesDCmd::execute(DCmdSource source, TRAPS) {
+  if (!AllocationSampler::enabled()) {
+    output()->print_cr("Allocation site sampling is not enabled, "
+                       "use -XX:AllocationSiteSamplingInterval=<bytes>");
+    return;
+  }
+  if (_top.value() < 0 || _top.value() > max_jint) {
+    output()->print_cr("Invalid number of sites: " JLONG_FORMAT, _top.value());
+    return;
+  }
+  AllocationSiteTable::print_on(output(), (int)_top.value());
+  if (_reset.value()) {
+    AllocationSiteTable::reset();
+  }
+}
+
 ElasticHeapDCmd::ElasticHeapDCmd(outputStream* output, bool heap) :
                            DCmdWithParser(output, heap),
     _young_commit_percent("young_commit_percent",
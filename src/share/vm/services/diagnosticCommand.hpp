@@ -171,6 +171,28 @@ public:
   virtual void execute(DCmdSource source, TRAPS);
 };
 
+class SafepointProfileDCmd : public DCmdWithParser {
+protected:
+  DCmdArgument<bool> _reset;
+public:
+  SafepointProfileDCmd(outputStream* output, bool heap);
+  static const char* name() { return "VM.safepoint_profile"; }
+  static const char* description() {
+    return "Print the threads that were last to reach recent safepoints. "
+           "Requires -XX:+UseSafepointProfiler.";
+  }
+  static const char* impact() {
+    return "Low";
+  }
+  static const JavaPermission permission() {
+    JavaPermission p = {"java.lang.management.ManagementPermission",
+                        "monitor", NULL};
+    return p;
+  }
+  static int num_arguments();
+  virtual void execute(DCmdSource source, TRAPS);
+};
+
 class SystemGCDCmd : public DCmd {
 public:
   SystemGCDCmd(outputStream* output, bool heap) : DCmd(output, heap) { }
@@ -246,6 +268,8 @@ protected:
   DCmdArgument<char*> _filename;
   DCmdArgument<bool>  _all;
   DCmdArgument<bool>  _mini_dump;
+  DCmdArgument<jlong> _parallel;
+  DCmdArgument<jlong> _gzip;
 public:
   HeapDumpDCmd(outputStream* output, bool heap);
   static const char* name() {
@@ -272,6 +296,8 @@ public:
 class ClassHistogramDCmd : public DCmdWithParser {
 protected:
   DCmdArgument<bool> _all;
+  DCmdArgument<jlong> _parallel;
+  DCmdArgument<jlong> _sample;
 public:
   ClassHistogramDCmd(outputStream* output, bool heap);
   static const char* name() {
@@ -461,6 +487,56 @@ public:
   virtual void execute(DCmdSource source, TRAPS);
 };
 
+class MetaspaceDCmd : public DCmdWithParser {
+protected:
+  DCmdArgument<bool> _show_loaders;
+  DCmdArgument<char*> _scale;
+public:
+  MetaspaceDCmd(outputStream* output, bool heap);
+  static const char* name() {
+    return "VM.metaspace";
+  }
+  static const char* description() {
+    return "Print committed, used and free metaspace per space type "
+           "and, optionally, per class loader.";
+  }
+  static const char* impact() {
+    return "Medium: Depends on number of class loaders.";
+  }
+  static const JavaPermission permission() {
+    JavaPermission p = {"java.lang.management.ManagementPermission",
+                        "monitor", NULL};
+    return p;
+  }
+  static int num_arguments();
+  virtual void execute(DCmdSource source, TRAPS);
+};
+
+class AllocationSitesDCmd : public DCmdWithParser {
+protected:
+  DCmdArgument<jlong> _top;
+  DCmdArgument<bool> _reset;
+public:
+  AllocationSitesDCmd(outputStream* output, bool heap);
+  static const char* name() {
+    return "GC.allocation_sites";
+  }
+  static const char* description() {
+    return "Print the sampled Java heap allocations per allocating method "
+           "and bci, requires -XX:AllocationSiteSamplingInterval.";
+  }
+  static const char* impact() {
+    return "Low: Depends on number of allocation sites.";
+  }
+  static const JavaPermission permission() {
+    JavaPermission p = {"java.lang.management.ManagementPermission",
+                        "monitor", NULL};
+    return p;
+  }
+  static int num_arguments();
+  virtual void execute(DCmdSource source, TRAPS);
+};
+
 class ElasticHeapDCmd : public DCmdWithParser {
 protected:
   DCmdArgument<jlong> _young_commit_percent;
@@ -31,8 +31,11 @@
 #include "memory/genCollectedHeap.hpp"
 #include "memory/universe.hpp"
 #include "oops/objArrayKlass.hpp"
+#include "runtime/arguments.hpp"
+#include "runtime/atomic.inline.hpp"
 #include "runtime/javaCalls.hpp"
 #include "runtime/jniHandles.hpp"
+#include "runtime/mutexLocker.hpp"
 #include "runtime/reflectionUtils.hpp"
 #include "runtime/vframe.hpp"
 #include "runtime/vmThread.hpp"
@@ -42,6 +45,7 @@
 #include "utilities/ostream.hpp"
 #include "utilities/macros.hpp"
 #if INCLUDE_ALL_GCS
+#include "gc_implementation/g1/g1CollectedHeap.inline.hpp"
 #include "gc_implementation/parallelScavenge/parallelScavengeHeap.hpp"
 #endif // INCLUDE_ALL_GCS
 
@@ -366,64 +370,353 @@ enum {
   INITIAL_CLASS_COUNT = 200
 };
 
-// Supports I/O operations on a dump file
-
-class DumpWriter : public StackObj {
+// zlib stream state, mirrors z_stream from zlib.h. zlib is resolved at
+// runtime when the first compressed dump is requested, the VM itself is
+// not linked against it.
+typedef struct {
+  const unsigned char* next_in;
+  unsigned int         avail_in;
+  unsigned long        total_in;
+  unsigned char*       next_out;
+  unsigned int         avail_out;
+  unsigned long        total_out;
+  const char*          msg;
+  void*                state;
+  void*                zalloc;
+  void*                zfree;
+  void*                opaque;
+  int                  data_type;
+  unsigned long        adler;
+  unsigned long        reserved;
+} dump_z_stream;
+
+typedef int (*DeflateInit2_t)(dump_z_stream* strm, int level, int method, int window_bits,
+                              int mem_level, int strategy, const char* version, int stream_size);
+typedef int (*Deflate_t)(dump_z_stream* strm, int flush);
+typedef int (*DeflateEnd_t)(dump_z_stream* strm);
+
+// Compresses the output of a DumpWriter into gzip members. Each member
+// is complete on its own, so the members written by the workers of a
+// parallel dump can be concatenated in any order and still form a valid
+// gzip file.
+
+class DumpCompressor : public CHeapObj<mtInternal> {
  private:
   enum {
-    io_buffer_size  = 8*M
+    out_buffer_size = 1*M,
+    z_ok            = 0,
+    z_stream_end    = 1,
+    z_no_flush      = 0,
+    z_finish        = 4,
+    z_buf_error     = -5,
+    z_deflated      = 8,
+    gzip_window     = 15 + 16,   // 32K window with a gzip header and trailer
+    mem_level       = 8
   };
 
+  static DeflateInit2_t _deflate_init2;
+  static Deflate_t      _deflate;
+  static DeflateEnd_t   _deflate_end;
+
+  int           _level;
+  dump_z_stream _stream;
+  bool          _in_member;   // deflate stream initialized and not yet finished
+  char*         _out;         // compressed bytes not yet written
+  size_t        _out_size;
+  size_t        _out_pos;
+
+  bool grow_out();
+
+  static bool lookup_zlib(void* handle);
+
+ public:
+  DumpCompressor(int level);
+  ~DumpCompressor();
+
+  // loads zlib, returns false if it is not available
+  static bool load_zlib();
+
+  // Compresses len bytes and appends them to the output, finish ends the
+  // gzip member. Returns an error message, or NULL on success.
+  const char* compress(const char* s, size_t len, bool finish);
+
+  char* out() const                     { return _out; }
+  size_t out_length() const             { return _out_pos; }
+  void reset_out()                      { _out_pos = 0; }
+};
+
+DeflateInit2_t DumpCompressor::_deflate_init2 = NULL;
+Deflate_t      DumpCompressor::_deflate       = NULL;
+DeflateEnd_t   DumpCompressor::_deflate_end   = NULL;
+
+bool DumpCompressor::lookup_zlib(void* handle) {
+  DeflateInit2_t init2 = CAST_TO_FN_PTR(DeflateInit2_t, os::dll_lookup(handle, "deflateInit2_"));
+  Deflate_t      defl  = CAST_TO_FN_PTR(Deflate_t, os::dll_lookup(handle, "deflate"));
+  DeflateEnd_t   end   = CAST_TO_FN_PTR(DeflateEnd_t, os::dll_lookup(handle, "deflateEnd"));
+  if (init2 == NULL || defl == NULL || end == NULL) {
+    return false;
+  }
+  _deflate = defl;
+  _deflate_end = end;
+  // published last, it tells the other threads zlib is ready
+  OrderAccess::release_store_ptr(&_deflate_init2, init2);
+  return true;
+}
+
+bool DumpCompressor::load_zlib() {
+  if (OrderAccess::load_ptr_acquire(&_deflate_init2) != NULL) {
+    return true;
+  }
+  char path[JVM_MAXPATHLEN];
+  char ebuf[1024];
+  // A libzip built against the system zlib resolves deflate through its
+  // dependencies, otherwise fall back to the system zlib itself.
+  if (os::dll_build_name(path, sizeof(path), Arguments::get_dll_dir(), "zip")) {
+    void* handle = os::dll_load(path, ebuf, sizeof ebuf);
+    if (handle != NULL && lookup_zlib(handle)) {
+      return true;
+    }
+  }
+  if (os::dll_build_name(path, sizeof(path), "", "z")) {
+    void* handle = os::dll_load(path, ebuf, sizeof ebuf);
+    if (handle != NULL && lookup_zlib(handle)) {
+      return true;
+    }
+  }
+#ifdef LINUX
+  void* handle = os::dll_load("libz.so.1", ebuf, sizeof ebuf);
+  if (handle != NULL && lookup_zlib(handle)) {
+    return true;
+  }
+#endif
+  return false;
+}
+
+DumpCompressor::DumpCompressor(int level) {
+  assert(_deflate_init2 != NULL, "zlib not loaded");
+  assert(level >= 1 && level <= 9, "invalid compression level");
+  _level = level;
+  _in_member = false;
+  _out = NULL;
+  _out_size = 0;
+  _out_pos = 0;
+}
+
+DumpCompressor::~DumpCompressor() {
+  if (_in_member) {
+    _deflate_end(&_stream);
+  }
+  if (_out != NULL) os::free(_out);
+}
+
+bool DumpCompressor::grow_out() {
+  size_t new_size = (_out_size == 0) ? (size_t)out_buffer_size : _out_size * 2;
+  char* new_out = (char*)os::realloc(_out, new_size, mtInternal);
+  if (new_out == NULL) {
+    return false;
+  }
+  _out = new_out;
+  _out_size = new_size;
+  return true;
+}
+
+const char* DumpCompressor::compress(const char* s, size_t len, bool finish) {
+  if (!_in_member) {
+    memset(&_stream, 0, sizeof(_stream));
+    // zlib only checks the major version of the caller
+    if (_deflate_init2(&_stream, _level, z_deflated, gzip_window, mem_level,
+                       0 /* default strategy */, "1", (int)sizeof(_stream)) != z_ok) {
+      return "Could not initialize the gzip compression";
+    }
+    _in_member = true;
+  }
+  for (;;) {
+    // avail_in and avail_out are only 32 bits wide
+    if (_stream.avail_in == 0 && len > 0) {
+      uint chunk = (uint)MIN2(len, (size_t)UINT_MAX);
+      _stream.next_in = (const unsigned char*)s;
+      _stream.avail_in = chunk;
+      s += chunk;
+      len -= chunk;
+    }
+    if (_out_pos == _out_size && !grow_out()) {
+      return "Could not allocate the compression buffer";
+    }
+    uint avail = (uint)MIN2(_out_size - _out_pos, (size_t)UINT_MAX);
+    _stream.next_out = (unsigned char*)_out + _out_pos;
+    _stream.avail_out = avail;
+    int flush = (finish && len == 0) ? z_finish : z_no_flush;
+    int res = _deflate(&_stream, flush);
+    if (res != z_ok && res != z_stream_end && res != z_buf_error) {
+      return _stream.msg != NULL ? _stream.msg : "gzip compression failed";
+    }
+    _out_pos += avail - _stream.avail_out;
+    if (flush == z_finish) {
+      if (res == z_stream_end) {
+        _deflate_end(&_stream);
+        _in_member = false;
+        return NULL;
+      }
+    } else if (_stream.avail_in == 0 && _stream.avail_out != 0) {
+      // all input consumed and no output pending
+      return NULL;
+    }
+  }
+}
+
+// The dump file. The writers of a parallel dump share it and write their
+// output to it in complete units, see DumpWriter::write_internal.
+
+class DumpFile : public StackObj {
+ private:
   int _fd;              // file descriptor (-1 if dump file not open)
   julong _bytes_written; // number of byte written to dump file
+  char* _error;   // error message when I/O fails
+  Mutex* _lock;   // serializes the writers of a parallel dump
+
+ public:
+  DumpFile(const char* path);
+  ~DumpFile();
+
+  void close();
+  bool is_open() const                  { return _fd >= 0; }
+
+  // writes to the file, the caller holds the lock
+  void write(const char* s, size_t len);
+
+  // records the error, if it is the first one, and closes the file.
+  // The caller holds the lock.
+  void fail(const char* error);
+
+  Mutex* lock() const                   { return _lock; }
+
+  // total number of bytes written to the disk
+  julong bytes_written() const          { return _bytes_written; }
+
+  char* error() const                   { return _error; }
+};
+
+DumpFile::DumpFile(const char* path) {
+  _error = NULL;
+  _bytes_written = 0L;
+  _lock = new Mutex(Mutex::leaf, "HeapDumpFile_lock", true);
+  _fd = os::create_binary_file(path, false);    // don't replace existing file
+
+  // if the open failed we record the error
+  if (_fd < 0) {
+    _error = (char*)os::strdup(strerror(errno));
+  }
+}
+
+DumpFile::~DumpFile() {
+  close();
+  delete _lock;
+  if (_error != NULL) os::free(_error);
+}
+
+// closes dump file (if open)
+void DumpFile::close() {
+  if (is_open()) {
+    ::close(_fd);
+    _fd = -1;
+  }
+}
+
+void DumpFile::fail(const char* error) {
+  assert(_lock->owned_by_self(), "must hold the dump file lock");
+  if (_error == NULL) {
+    _error = (char*)os::strdup(error);
+  }
+  close();
+}
+
+// write directly to the file
+void DumpFile::write(const char* s, size_t len) {
+  assert(_lock->owned_by_self(), "must hold the dump file lock");
+  if (is_open()) {
+    const char* pos = s;
+    ssize_t n = 0;
+    while (len > 0) {
+      uint tmp = (uint)MIN2(len, (size_t)UINT_MAX);
+      n = ::write(_fd, pos, tmp);
+
+      if (n < 0) {
+        fail(strerror(errno));
+        return;
+      }
+
+      _bytes_written += n;
+      pos += n;
+      len -= n;
+    }
+  }
+}
+
+// Supports I/O operations on a dump file. A HPROF_HEAP_DUMP_SEGMENT record
+// is kept in memory until it is complete and its length can be filled in,
+// so nothing is written twice. This lets the output be compressed while
+// it is written and the writers of a parallel dump share the dump file.
+
+class DumpWriter : public StackObj {
+ private:
+  enum {
+    io_buffer_size  = 8*M,
+    // tag, ticks and length of a HPROF_HEAP_DUMP_SEGMENT record
+    segment_header_size = 1 + 2 * 4
+  };
+
+  DumpFile* _file;
+  int _compression_level;
+  DumpCompressor* _compressor;  // NULL if the dump is not compressed
 
   char* _buffer;    // internal buffer
   size_t _size;
   size_t _pos;
 
-  jlong _dump_start;
-
-  char* _error;   // error message when I/O fails
-
-  void set_file_descriptor(int fd)              { _fd = fd; }
-  int file_descriptor() const                   { return _fd; }
+  size_t _segment_limit;   // a segment is ended on the next sub-record boundary past this length
+  bool _in_segment;        // the buffer starts with a segment that is not complete yet
+  bool _in_large_record;   // writing a segment with a single sub-record, the file is locked
 
   char* buffer() const                          { return _buffer; }
   size_t buffer_size() const                    { return _size; }
   size_t position() const                       { return _pos; }
   void set_position(size_t pos)                 { _pos = pos; }
 
-  void set_error(const char* error)             { _error = (char*)os::strdup(error); }
+  bool grow_buffer(size_t min_size);
+  void fail(const char* error);
 
   // all I/O go through this function
-  void write_internal(void* s, size_t len);
+  void write_internal(const char* s, size_t len);
 
  public:
-  DumpWriter(const char* path);
+  DumpWriter(DumpFile* file, int compression_level);
   ~DumpWriter();
 
-  void close();
-  bool is_open() const                  { return file_descriptor() >= 0; }
+  // flushes the buffered bytes, the file is closed by its owner
+  void close()                          { flush(); }
+  bool is_open() const                  { return _file->is_open(); }
   void flush();
 
-  jlong dump_start() const                      { return _dump_start; }
-  void set_dump_start(jlong pos);
-  julong current_record_length();
-
-  // total number of bytes written to the disk
-  julong bytes_written() const          { return _bytes_written; }
+  DumpFile* file() const                { return _file; }
+  int compression_level() const         { return _compression_level; }
 
-  // adjust the number of bytes written to disk (used to keep the count
-  // of the number of bytes written in case of rewrites)
-  void adjust_bytes_written(jlong n)    { _bytes_written += n; }
+  // starts a HPROF_HEAP_DUMP_SEGMENT record
+  void start_segment();
+  // fills in the length of the current segment and writes it
+  void end_segment();
+  // true if the current segment should be ended at the next sub-record boundary
+  bool segment_full() const             { return position() - segment_header_size >= _segment_limit; }
 
-  // number of (buffered) bytes as yet unwritten to the dump file
-  size_t bytes_unwritten() const        { return position(); }
+  // A sub-record of the given length that is too long to be buffered is
+  // written to a segment of its own, with the length known upfront. Returns
+  // false if the sub-record is buffered with the current segment instead.
+  bool start_large_sub_record(julong len);
+  void end_large_sub_record();
 
-  char* error() const                   { return _error; }
+  // total number of bytes written to the disk
+  julong bytes_written() const          { return _file->bytes_written(); }
 
-  jlong current_offset();
-  void seek_to_offset(jlong pos);
+  char* error() const                   { return _file->error(); }
 
   // writer functions
   void write_raw(void* s, size_t len);
@@ -437,7 +730,13 @@ class DumpWriter : public StackObj {
   void write_id(u4 x);
 };
 
-DumpWriter::DumpWriter(const char* path) {
+DumpWriter::DumpWriter(DumpFile* file, int compression_level) {
+  _file = file;
+  _compression_level = compression_level;
+  _compressor = (compression_level > 0) ? new DumpCompressor(compression_level) : NULL;
+  _pos = 0;
+  _in_segment = false;
+  _in_large_record = false;
   // try to allocate an I/O buffer of io_buffer_size. If there isn't
   // sufficient memory then reduce size until we can allocate something.
   _size = io_buffer_size;
@@ -448,125 +747,176 @@ DumpWriter::DumpWriter(const char* path) {
     }
   } while (_buffer == NULL && _size > 0);
   assert((_size > 0 && _buffer != NULL) || (_size == 0 && _buffer == NULL), "sanity check");
-  _pos = 0;
-  _error = NULL;
-  _bytes_written = 0L;
-  _dump_start = (jlong)-1;
-  _fd = os::create_binary_file(path, false);    // don't replace existing file
-
-  // if the open failed we record the error
-  if (_fd < 0) {
-    _error = (char*)os::strdup(strerror(errno));
+  _segment_limit = _size / 2;
+  if (_buffer == NULL) {
+    fail("Could not allocate the dump buffer");
   }
 }
 
 DumpWriter::~DumpWriter() {
-  // flush and close dump file
-  if (is_open()) {
-    close();
-  }
+  close();
   if (_buffer != NULL) os::free(_buffer);
-  if (_error != NULL) os::free(_error);
+  if (_compressor != NULL) delete _compressor;
 }
 
-// closes dump file (if open)
-void DumpWriter::close() {
-  // flush and close dump file
-  if (is_open()) {
-    flush();
-    ::close(file_descriptor());
-    set_file_descriptor(-1);
+void DumpWriter::fail(const char* error) {
+  if (_in_large_record) {
+    _file->fail(error);
+  } else {
+    MutexLockerEx ml(_file->lock(), Mutex::_no_safepoint_check_flag);
+    _file->fail(error);
   }
 }
 
-// sets the dump starting position
-void DumpWriter::set_dump_start(jlong pos) {
-  _dump_start = pos;
-}
-
-julong DumpWriter::current_record_length() {
-  if (is_open()) {
-    // calculate the size of the dump record
-    julong dump_end = bytes_written() + bytes_unwritten();
-    assert(dump_end == (size_t)current_offset(), "checking");
-    julong dump_len = dump_end - dump_start() - 4;
-    return dump_len;
+// Hands the bytes to the file. Outside of a large sub-record they form a
+// unit of their own, compressed as a separate gzip member before the file
+// is locked.
+void DumpWriter::write_internal(const char* s, size_t len) {
+  if (!is_open() || len == 0) {
+    return;
+  }
+  if (_in_large_record) {
+    // the file is already locked, end_large_sub_record finishes the member
+    if (_compressor == NULL) {
+      _file->write(s, len);
+      return;
+    }
+    const char* error = _compressor->compress(s, len, false);
+    if (error != NULL) {
+      _file->fail(error);
+      return;
+    }
+    _file->write(_compressor->out(), _compressor->out_length());
+    _compressor->reset_out();
+    return;
+  }
+  if (_compressor != NULL) {
+    const char* error = _compressor->compress(s, len, true);
+    if (error != NULL) {
+      fail(error);
+      return;
+    }
+    s = _compressor->out();
+    len = _compressor->out_length();
+  }
+  {
+    MutexLockerEx ml(_file->lock(), Mutex::_no_safepoint_check_flag);
+    _file->write(s, len);
+  }
+  if (_compressor != NULL) {
+    _compressor->reset_out();
   }
-  return 0;
 }
 
-// write directly to the file
-void DumpWriter::write_internal(void* s, size_t len) {
-  if (is_open()) {
-    const char* pos = (char*)s;
-    ssize_t n = 0;
-    while (len > 0) {
-      uint tmp = (uint)MIN2(len, (size_t)UINT_MAX);
-      n = ::write(file_descriptor(), pos, tmp);
-
-      if (n < 0) {
-        set_error(strerror(errno));
-        ::close(file_descriptor());
-        set_file_descriptor(-1);
-        return;
-      }
-
-      _bytes_written += n;
-      pos += n;
-      len -= n;
-    }
+bool DumpWriter::grow_buffer(size_t min_size) {
+  size_t new_size = MAX2(buffer_size() * 2, min_size);
+  char* new_buffer = (char*)os::realloc(_buffer, new_size, mtInternal);
+  if (new_buffer == NULL) {
+    fail("Could not allocate memory for a heap dump segment");
+    return false;
   }
+  _buffer = new_buffer;
+  _size = new_size;
+  return true;
 }
 
 // write raw bytes
 void DumpWriter::write_raw(void* s, size_t len) {
   if (is_open()) {
-    // flush buffer to make room
-    if ((position() + len) >= buffer_size()) {
-      flush();
-    }
+    if ((position() + len) > buffer_size()) {
+      if (_in_segment) {
+        // the segment length is not known yet, keep all of it in memory
+        if (!grow_buffer(position() + len)) {
+          return;
+        }
+      } else {
+        // flush buffer to make room
+        flush();
 
-    // buffer not available or too big to buffer it
-    if ((buffer() == NULL) || (len >= buffer_size())) {
-      write_internal(s, len);
-    } else {
-      // Should optimize this for u1/u2/u4/u8 sizes.
-      memcpy(buffer() + position(), s, len);
-      set_position(position() + len);
+        // too big to buffer it
+        if (len > buffer_size()) {
+          write_internal((const char*)s, len);
+          return;
+        }
+      }
     }
+    // Should optimize this for u1/u2/u4/u8 sizes.
+    memcpy(buffer() + position(), s, len);
+    set_position(position() + len);
   }
 }
 
 // flush any buffered bytes to the file
 void DumpWriter::flush() {
   if (is_open() && position() > 0) {
+    assert(!_in_segment, "the segment length is not known yet");
     write_internal(buffer(), position());
     set_position(0);
   }
 }
 
-jlong DumpWriter::current_offset() {
-  if (is_open()) {
-    // the offset is the file offset plus whatever we have buffered
-    jlong offset = os::current_file_offset(file_descriptor());
-    assert(offset >= 0, "lseek failed");
-    return offset + position();
-  } else {
-    return (jlong)-1;
-  }
+void DumpWriter::start_segment() {
+  assert(!_in_segment && !_in_large_record, "segment already started");
+  flush();
+  write_u1(HPROF_HEAP_DUMP_SEGMENT);
+  write_u4(0); // current ticks
+  write_u4(0); // length, filled in by end_segment
+  _in_segment = true;
 }
 
-void DumpWriter::seek_to_offset(jlong off) {
-  assert(off >= 0, "bad offset");
+void DumpWriter::end_segment() {
+  assert(_in_segment, "no segment started");
+  _in_segment = false;
+  if (!is_open()) {
+    set_position(0);
+    return;
+  }
+  assert(position() >= segment_header_size, "segment header is buffered");
+  julong dump_len = position() - segment_header_size;
+  if (dump_len == 0) {
+    // drop the empty segment
+    set_position(0);
+    return;
+  }
 
-  // need to flush before seeking
+  // record length must fit in a u4
+  if (dump_len > max_juint) {
+    warning("record is too large");
+  }
+  Bytes::put_Java_u4((address)(buffer() + 1 + 4), (u4)dump_len);
   flush();
+}
 
-  // may be closed due to I/O error
-  if (is_open()) {
-    jlong n = os::seek_to_file_offset(file_descriptor(), off);
-    assert(n >= 0, "lseek failed");
+bool DumpWriter::start_large_sub_record(julong len) {
+  assert(_in_segment, "sub-records are written to a segment");
+  if (len <= _segment_limit || len > max_juint) {
+    return false;
+  }
+  end_segment();
+  // keeps the other writers out until the whole segment is written
+  _file->lock()->lock_without_safepoint_check();
+  _in_large_record = true;
+  write_u1(HPROF_HEAP_DUMP_SEGMENT);
+  write_u4(0); // current ticks
+  write_u4((u4)len);
+  return true;
+}
+
+void DumpWriter::end_large_sub_record() {
+  assert(_in_large_record, "no large sub-record started");
+  flush();
+  if (_compressor != NULL && is_open()) {
+    const char* error = _compressor->compress(NULL, 0, true);
+    if (error != NULL) {
+      _file->fail(error);
+    } else {
+      _file->write(_compressor->out(), _compressor->out_length());
+    }
+    _compressor->reset_out();
   }
+  _in_large_record = false;
+  _file->lock()->unlock();
+  start_segment();
 }
 
 void DumpWriter::write_u2(u2 x) {
@@ -619,7 +969,6 @@ void DumpWriter::write_classID(Klass* k) {
 }
 
 
-
 // Support class with a collection of functions used when dumping the heap
 
 class DumperSupport : AllStatic {
@@ -665,7 +1014,7 @@ class DumperSupport : AllStatic {
   static void dump_stack_frame(DumpWriter* writer, int frame_serial_num, int class_serial_num, Method* m, int bci);
 
   // check if we need to truncate an array
-  static int calculate_array_max_length(DumpWriter* writer, arrayOop array, short header_size);
+  static int calculate_array_max_length(arrayOop array, short header_size);
 
   // writes a HPROF_HEAP_DUMP_SEGMENT record
   static void write_dump_header(DumpWriter* writer);
@@ -673,6 +1022,9 @@ class DumperSupport : AllStatic {
   // fixes up the length of the current dump record
   static void write_current_dump_record_length(DumpWriter* writer);
 
+  // used on a sub-record boundary to start a new segment if needed
+  static void check_segment_length(DumpWriter* writer);
+
   // fixes up the current dump record and writes HPROF_HEAP_DUMP_END record
   static void end_of_dump(DumpWriter* writer);
 };
@@ -1083,7 +1435,7 @@ void DumperSupport::dump_basic_type_array_class(DumpWriter* writer, Klass* k) {
 
 // Hprof uses an u4 as record length field,
 // which means we need to truncate arrays that are too long.
-int DumperSupport::calculate_array_max_length(DumpWriter* writer, arrayOop array, short header_size) {
+int DumperSupport::calculate_array_max_length(arrayOop array, short header_size) {
   BasicType type = ArrayKlass::cast(array->klass())->element_type();
   assert(type >= T_BOOLEAN && type <= T_OBJECT, "invalid array element type");
 
@@ -1098,19 +1450,9 @@ int DumperSupport::calculate_array_max_length(DumpWriter* writer, arrayOop array
 
   size_t length_in_bytes = (size_t)length * type_size;
 
-  // Create a new record if the current record is non-empty and the array can't fit.
-  julong current_record_length = writer->current_record_length();
-  if (current_record_length > 0 &&
-      (current_record_length + header_size + length_in_bytes) > max_juint) {
-    write_current_dump_record_length(writer);
-    write_dump_header(writer);
-
-    // We now have an empty record.
-    current_record_length = 0;
-  }
-
-  // Calculate max bytes we can use.
-  uint max_bytes = max_juint - (header_size + current_record_length);
+  // Calculate max bytes we can use. An array that does not fit in the
+  // current segment is written to a segment of its own.
+  uint max_bytes = max_juint - header_size;
 
   // Array too long for the record?
   // Calculate max length and return it.
@@ -1129,7 +1471,8 @@ void DumperSupport::dump_object_array(DumpWriter* writer, objArrayOop array) {
   // sizeof(u1) + 2 * sizeof(u4) + sizeof(objectID) + sizeof(classID)
   short header_size = 1 + 2 * 4 + 2 * sizeof(address);
 
-  int length = calculate_array_max_length(writer, array, header_size);
+  int length = calculate_array_max_length(array, header_size);
+  bool large = writer->start_large_sub_record(header_size + (julong)length * sizeof(address));
 
   writer->write_u1(HPROF_GC_OBJ_ARRAY_DUMP);
   writer->write_objectID(array);
@@ -1145,6 +1488,10 @@ void DumperSupport::dump_object_array(DumpWriter* writer, objArrayOop array) {
     oop o = array->obj_at(index);
     writer->write_objectID(o);
   }
+
+  if (large) {
+    writer->end_large_sub_record();
+  }
 }
 
 #define WRITE_ARRAY(Array, Type, Size, Length) \
@@ -1157,9 +1504,11 @@ void DumperSupport::dump_prim_array(DumpWriter* writer, typeArrayOop array, bool
   // 2 * sizeof(u1) + 2 * sizeof(u4) + sizeof(objectID)
   short header_size = 2 * 1 + 2 * 4 + sizeof(address);
 
-  int length = calculate_array_max_length(writer, array, header_size);
+  int length = calculate_array_max_length(array, header_size);
   int type_size = type2aelembytes(type);
   u4 length_in_bytes = (u4)length * type_size;
+  // the elements are left out of a mini dump
+  bool large = writer->start_large_sub_record(header_size + (minidump ? 0 : (julong)length_in_bytes));
 
   writer->write_u1(HPROF_GC_PRIM_ARRAY_DUMP);
   writer->write_objectID(array);
@@ -1171,8 +1520,9 @@ void DumperSupport::dump_prim_array(DumpWriter* writer, typeArrayOop array, bool
   }
   writer->write_u1(type2tag(type));
 
-  // nothing to copy
+  // nothing to copy, the record is too short to be a large one
   if (array->length() == 0 || minidump) {
+    assert(!large, "sanity check");
     return;
   }
 
@@ -1242,6 +1592,10 @@ void DumperSupport::dump_prim_array(DumpWriter* writer, typeArrayOop array, bool
     }
     default : ShouldNotReachHere();
   }
+
+  if (large) {
+    writer->end_large_sub_record();
+  }
 }
 
 // create a HPROF_FRAME record of the given Method* and bci
@@ -1395,12 +1749,50 @@ class StickyClassDumper : public KlassClosure {
 
 class VM_HeapDumper;
 
+// Reports how much of the heap has been dumped in 10% steps. It is
+// shared by the workers of a parallel dump and prints to the VM output
+// while the dump is running.
+
+class HeapDumpProgress : public StackObj {
+ private:
+  enum {
+    report_step = 10
+  };
+
+  size_t          _total_bytes;
+  volatile size_t _dumped_bytes;
+  volatile jint   _reported;      // last reported percentage
+
+ public:
+  HeapDumpProgress(size_t total_bytes) :
+    _total_bytes(MAX2(total_bytes, (size_t)1)), _dumped_bytes(0), _reported(0) { }
+
+  // adds the given number of dumped bytes
+  void add(size_t bytes);
+};
+
+void HeapDumpProgress::add(size_t bytes) {
+  size_t dumped = (size_t)Atomic::add_ptr((intptr_t)bytes, (volatile intptr_t*)&_dumped_bytes);
+  jint percent = (jint)MIN2((julong)dumped * 100 / _total_bytes, (julong)100);
+  percent -= percent % report_step;
+  jint reported = _reported;
+  if (percent > reported && Atomic::cmpxchg(percent, &_reported, reported) == reported) {
+    tty->print_cr("Heap dump progress: %d%%", percent);
+  }
+}
+
 // Support class using when iterating over the heap.
 
 class HeapObjectDumper : public ObjectClosure {
  private:
+  enum {
+    progress_report_bytes = 16*M
+  };
+
   VM_HeapDumper* _dumper;
   DumpWriter* _writer;
+  HeapDumpProgress* _progress;
+  size_t _unreported_bytes;
 
   VM_HeapDumper* dumper()               { return _dumper; }
   DumpWriter* writer()                  { return _writer; }
@@ -1411,16 +1803,22 @@ class HeapObjectDumper : public ObjectClosure {
   bool using_minidump();
 
  public:
-  HeapObjectDumper(VM_HeapDumper* dumper, DumpWriter* writer) {
-    _dumper = dumper;
-    _writer = writer;
-  }
+  HeapObjectDumper(VM_HeapDumper* dumper, DumpWriter* writer);
+  ~HeapObjectDumper();
 
   // called for each object in the heap
   void do_object(oop o);
 };
 
 void HeapObjectDumper::do_object(oop o) {
+  if (_progress != NULL) {
+    _unreported_bytes += o->size() * HeapWordSize;
+    if (_unreported_bytes >= progress_report_bytes) {
+      _progress->add(_unreported_bytes);
+      _unreported_bytes = 0;
+    }
+  }
+
   // hide the sentinel for deleted handles
   if (o == JNIHandles::deleted_handle()) return;
 
@@ -1464,6 +1862,7 @@ class VM_HeapDumper : public VM_GC_Operation {
   int _num_threads;
 
   HeapDumper*           _heap_dumper;
+  HeapDumpProgress*     _progress;
 
   // accessors and setters
   static VM_HeapDumper* dumper()         {  assert(_global_dumper != NULL, "Error"); return _global_dumper; }
@@ -1503,6 +1902,12 @@ class VM_HeapDumper : public VM_GC_Operation {
   // HPROF_TRACE and HPROF_FRAME records
   void dump_stack_traces();
 
+  // number of GC workers that dump the heap objects in parallel
+  uint parallel_dump_workers() const;
+
+  // HPROF_GC_INSTANCE_DUMP, HPROF_GC_OBJ_ARRAY_DUMP and HPROF_GC_PRIM_ARRAY_DUMP records
+  void dump_objects();
+
  public:
   VM_HeapDumper(DumpWriter* writer, bool gc_before_heap_dump, bool oome, HeapDumper* heap_dumper = NULL) :
     VM_GC_Operation(0 /* total collections,      dummy, ignored */,
@@ -1515,6 +1920,7 @@ class VM_HeapDumper : public VM_GC_Operation {
     _stack_traces = NULL;
     _num_threads = 0;
     _heap_dumper = heap_dumper;
+    _progress = NULL;
     if (oome) {
       assert(!Thread::current()->is_VM_thread(), "Dump from OutOfMemoryError cannot be called by the VMThread");
       // get OutOfMemoryError zero-parameter constructor
@@ -1544,76 +1950,139 @@ class VM_HeapDumper : public VM_GC_Operation {
   void doit();
 
   HeapDumper* heap_dumper() { return _heap_dumper; }
+  HeapDumpProgress* progress() const { return _progress; }
 };
 
 VM_HeapDumper* VM_HeapDumper::_global_dumper = NULL;
 DumpWriter*    VM_HeapDumper::_global_writer = NULL;
 
+HeapObjectDumper::HeapObjectDumper(VM_HeapDumper* dumper, DumpWriter* writer) {
+  _dumper = dumper;
+  _writer = writer;
+  _progress = dumper->progress();
+  _unreported_bytes = 0;
+}
+
+HeapObjectDumper::~HeapObjectDumper() {
+  if (_progress != NULL && _unreported_bytes > 0) {
+    _progress->add(_unreported_bytes);
+  }
+}
+
 bool HeapObjectDumper::using_minidump() {
   return _dumper->heap_dumper()->is_mini_dump();
 }
 
+#if INCLUDE_ALL_GCS
+// Applies the object dumper to the G1 heap regions claimed by a worker.
+class G1HeapDumpRegionClosure : public HeapRegionClosure {
+ private:
+  ObjectClosure* _cl;
+ public:
+  G1HeapDumpRegionClosure(ObjectClosure* cl) : _cl(cl) { }
+  bool doHeapRegion(HeapRegion* r) {
+    if (!r->continuesHumongous()) {
+      r->object_iterate(_cl);
+    }
+    return false;
+  }
+};
+
+// Each worker dumps the objects of the regions it claims with a writer of
+// its own. The writers share the dump file and add complete
+// HPROF_HEAP_DUMP_SEGMENT records to it, compressed if requested.
+class G1HeapDumpTask : public AbstractGangTask {
+ private:
+  VM_HeapDumper* _dumper;
+  DumpFile*      _file;
+  int            _compression_level;
+  uint           _num_workers;
+ public:
+  G1HeapDumpTask(VM_HeapDumper* dumper, DumpWriter* writer, uint num_workers) :
+    AbstractGangTask("G1 Heap Dump"), _dumper(dumper), _file(writer->file()),
+    _compression_level(writer->compression_level()), _num_workers(num_workers) { }
+
+  void work(uint worker_id) {
+    DumpWriter writer(_file, _compression_level);
+    DumperSupport::write_dump_header(&writer);
+    {
+      HeapObjectDumper obj_dumper(_dumper, &writer);
+      G1HeapDumpRegionClosure blk(&obj_dumper);
+      G1CollectedHeap::heap()->heap_region_par_iterate_chunked(&blk, worker_id, _num_workers,
+                                                               HeapRegion::HeapDumpClaimValue);
+    }
+    DumperSupport::write_current_dump_record_length(&writer);
+  }
+};
+#endif // INCLUDE_ALL_GCS
+
+uint VM_HeapDumper::parallel_dump_workers() const {
+#if INCLUDE_ALL_GCS
+  if (_heap_dumper != NULL && UseG1GC &&
+      G1CollectedHeap::use_parallel_gc_threads()) {
+    return MIN2(_heap_dumper->parallel_thread_num(),
+                G1CollectedHeap::heap()->workers()->total_workers());
+  }
+#endif // INCLUDE_ALL_GCS
+  return 1;
+}
+
+void VM_HeapDumper::dump_objects() {
+#if INCLUDE_ALL_GCS
+  uint n_workers = parallel_dump_workers();
+  if (n_workers > 1) {
+    G1CollectedHeap* g1h = G1CollectedHeap::heap();
+    assert(g1h->check_heap_region_claim_values(HeapRegion::InitialClaimValue), "sanity check");
+
+    uint saved_active_workers = g1h->workers()->active_workers();
+    g1h->workers()->set_active_workers(n_workers);
+    G1HeapDumpTask task(this, writer(), n_workers);
+    g1h->set_par_threads(n_workers);
+    g1h->workers()->run_task(&task);
+    g1h->set_par_threads(0);
+    g1h->workers()->set_active_workers(saved_active_workers);
+
+    g1h->reset_heap_region_claim_values();
+    return;
+  }
+#endif // INCLUDE_ALL_GCS
+
+  HeapObjectDumper obj_dumper(this, writer());
+  Universe::heap()->safe_object_iterate(&obj_dumper);
+}
+
 bool VM_HeapDumper::skip_operation() const {
   return false;
 }
 
  // writes a HPROF_HEAP_DUMP_SEGMENT record
 void DumperSupport::write_dump_header(DumpWriter* writer) {
-  if (writer->is_open()) {
-    writer->write_u1(HPROF_HEAP_DUMP_SEGMENT);
-    writer->write_u4(0); // current ticks
-
-    // record the starting position for the dump (its length will be fixed up later)
-    writer->set_dump_start(writer->current_offset());
-    writer->write_u4(0);
-  }
+  // the segment is buffered until its length is known
+  writer->start_segment();
 }
 
 // fixes up the length of the current dump record
 void DumperSupport::write_current_dump_record_length(DumpWriter* writer) {
-  if (writer->is_open()) {
-    julong dump_end = writer->bytes_written() + writer->bytes_unwritten();
-    julong dump_len = writer->current_record_length();
-
-    // record length must fit in a u4
-    if (dump_len > max_juint) {
-      warning("record is too large");
-    }
-
-    // seek to the dump start and fix-up the length
-    assert(writer->dump_start() >= 0, "no dump start recorded");
-    writer->seek_to_offset(writer->dump_start());
-    writer->write_u4((u4)dump_len);
-
-    // adjust the total size written to keep the bytes written correct.
-    writer->adjust_bytes_written(-((jlong) sizeof(u4)));
-
-    // seek to dump end so we can continue
-    writer->seek_to_offset(dump_end);
-
-    // no current dump record
-    writer->set_dump_start((jlong)-1);
-  }
+  writer->end_segment();
 }
 
 // used on a sub-record boundary to check if we need to start a
 // new segment.
-void VM_HeapDumper::check_segment_length() {
-  if (writer()->is_open()) {
-    julong dump_len = writer()->current_record_length();
-
-    if (dump_len > 2UL*G) {
-      DumperSupport::write_current_dump_record_length(writer());
-      DumperSupport::write_dump_header(writer());
-    }
+void DumperSupport::check_segment_length(DumpWriter* writer) {
+  if (writer->is_open() && writer->segment_full()) {
+    write_current_dump_record_length(writer);
+    write_dump_header(writer);
   }
 }
 
+void VM_HeapDumper::check_segment_length() {
+  DumperSupport::check_segment_length(writer());
+}
+
 // fixes up the current dump record and writes HPROF_HEAP_DUMP_END record
 void DumperSupport::end_of_dump(DumpWriter* writer) {
+  write_current_dump_record_length(writer);
   if (writer->is_open()) {
-    write_current_dump_record_length(writer);
-
     writer->write_u1(HPROF_HEAP_DUMP_END);
     writer->write_u4(0);
     writer->write_u4(0);
@@ -1622,7 +2091,7 @@ void DumperSupport::end_of_dump(DumpWriter* writer) {
 
 // marks sub-record boundary
 void HeapObjectDumper::mark_end_of_record() {
-  dumper()->check_segment_length();
+  DumperSupport::check_segment_length(writer());
 }
 
 // writes a HPROF_LOAD_CLASS record for the class (and each of its
@@ -1791,12 +2260,15 @@ void VM_HeapDumper::do_threads() {
 // unknown object alloc site.
 //
 // Each HPROF_HEAP_DUMP_SEGMENT record has a length followed by sub-records.
-// To allow the heap dump be generated in a single pass we remember the position
-// of the dump length and fix it up after all sub-records have been written.
+// To allow the heap dump be generated in a single pass a segment is kept in
+// memory until all its sub-records have been written, see DumpWriter.
 // To generate the sub-records we iterate over the heap, writing
 // HPROF_GC_INSTANCE_DUMP, HPROF_GC_OBJ_ARRAY_DUMP, and HPROF_GC_PRIM_ARRAY_DUMP
 // records as we go. Once that is done we write records for some of the GC
 // roots.
+//
+// In a parallel dump each worker writes the object records to segments of
+// its own, which are added to the dump file as they are completed.
 
 void VM_HeapDumper::doit() {
 
@@ -1821,6 +2293,11 @@ void VM_HeapDumper::doit() {
 
   // Write the file header - we always use 1.0.2
   size_t used = ch->used();
+
+  HeapDumpProgress progress(used);
+  if (_heap_dumper != NULL && _heap_dumper->report_progress()) {
+    _progress = &progress;
+  }
   const char* header = "JAVA PROFILE 1.0.2";
 
   // header is few bytes long - no chance to overflow int
@@ -1855,8 +2332,7 @@ void VM_HeapDumper::doit() {
   // segment is started.
   // The HPROF_GC_CLASS_DUMP and HPROF_GC_INSTANCE_DUMP are the vast bulk
   // of the heap dump.
-  HeapObjectDumper obj_dumper(this, writer());
-  Universe::heap()->safe_object_iterate(&obj_dumper);
+  dump_objects();
 
   // HPROF_GC_ROOT_THREAD_OBJ + frames + jni locals
   do_threads();
@@ -1880,8 +2356,10 @@ void VM_HeapDumper::doit() {
 
   // fixes up the length of the dump record and writes the HPROF_HEAP_DUMP_END record.
   DumperSupport::end_of_dump(writer());
+  writer()->flush();
 
   // Now we clear the global variables, so that a future dumper might run.
+  _progress = NULL;
   clear_global_dumper();
   clear_global_writer();
 }
@@ -1951,10 +2429,18 @@ int HeapDumper::dump(const char* path) {
     timer()->start();
   }
 
-  // create the dump writer. If the file can be opened then bail
-  DumpWriter writer(path);
-  if (!writer.is_open()) {
-    set_error(writer.error());
+  if (compression_level() > 0 && !DumpCompressor::load_zlib()) {
+    set_error((char*)"Compressed heap dumps need zlib, which could not be loaded");
+    if (print_to_tty()) {
+      tty->print_cr("Unable to create %s: %s", path, error());
+    }
+    return -1;
+  }
+
+  // create the dump file. If the file can be opened then bail
+  DumpFile file(path);
+  if (!file.is_open()) {
+    set_error(file.error());
     if (print_to_tty()) {
       tty->print_cr("Unable to create %s: %s", path,
         (error() != NULL) ? error() : "reason unknown");
@@ -1962,6 +2448,9 @@ int HeapDumper::dump(const char* path) {
     return -1;
   }
 
+  // create the dump writer, the dump is compressed while it is written
+  DumpWriter writer(&file, compression_level());
+
   // generate the dump
   VM_HeapDumper dumper(&writer, _gc_before_heap_dump, _oome, this);
   if (Thread::current()->is_VM_thread()) {
@@ -1973,20 +2462,21 @@ int HeapDumper::dump(const char* path) {
 
   // close dump file and record any error that the writer may have encountered
   writer.close();
-  set_error(writer.error());
+  file.close();
+  set_error(file.error());
 
   // print message in interactive case
   if (print_to_tty()) {
     timer()->stop();
     if (error() == NULL) {
       tty->print_cr("Heap dump file created [" JULONG_FORMAT " bytes in %3.3f secs]",
-                    writer.bytes_written(), timer()->seconds());
+                    file.bytes_written(), timer()->seconds());
     } else {
-      tty->print_cr("Dump file is incomplete: %s", writer.error());
+      tty->print_cr("Dump file is incomplete: %s", file.error());
     }
   }
 
-  return (writer.error() == NULL) ? 0 : -1;
+  return (file.error() == NULL) ? 0 : -1;
 }
 
 // stop timer (if still active), and free any error string we might be holding
@@ -2112,6 +2602,12 @@ void HeapDumper::dump_heap(bool oome) {
   HeapDumper dumper(false /* no GC before heap dump */,
                     true  /* send to tty */,
                     oome  /* pass along out-of-memory-error flag */);
+  dumper.set_parallel_thread_num((uint)MIN2(HeapDumpParallelThreads, (uintx)max_juint));
+  if (HeapDumpGzipLevel > 9) {
+    warning("HeapDumpGzipLevel is out of range (1-9), the heap dump is not compressed");
+  } else {
+    dumper.set_compression_level((int)HeapDumpGzipLevel);
+  }
   dumper.dump(my_path);
   os::free(my_path);
 }
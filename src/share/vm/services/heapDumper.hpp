@@ -48,11 +48,15 @@ class HeapDumper : public StackObj {
   bool _gc_before_heap_dump;
   bool _oome;
   bool _mini_dump;
+  uint _parallel_thread_num;
+  int _compression_level;
+  bool _report_progress;
   elapsedTimer _t;
 
   HeapDumper(bool gc_before_heap_dump, bool print_to_tty, bool oome) :
     _gc_before_heap_dump(gc_before_heap_dump), _error(NULL),
-    _print_to_tty(print_to_tty), _oome(oome), _mini_dump(false) { }
+    _print_to_tty(print_to_tty), _oome(oome), _mini_dump(false),
+    _parallel_thread_num(1), _compression_level(0), _report_progress(false) { }
 
   // string representation of error
   char* error() const                   { return _error; }
@@ -72,7 +76,10 @@ class HeapDumper : public StackObj {
     _error(NULL),
     _print_to_tty(false),
     _oome(false),
-    _mini_dump(mini_dump) { }
+    _mini_dump(mini_dump),
+    _parallel_thread_num(1),
+    _compression_level(0),
+    _report_progress(false) { }
 
   ~HeapDumper();
 
@@ -87,6 +94,21 @@ class HeapDumper : public StackObj {
   static void dump_heap_from_oome()    NOT_SERVICES_RETURN;
 
   inline bool is_mini_dump() const { return _mini_dump; }
+
+  // Number of GC worker threads that dump the heap objects. Each adds
+  // complete heap dump segments to the dump file. Only G1 splits the heap,
+  // other collectors dump serially.
+  uint parallel_thread_num() const             { return _parallel_thread_num; }
+  void set_parallel_thread_num(uint n)         { _parallel_thread_num = MAX2(n, 1U); }
+
+  // gzip compression level of the dump file, 0 writes plain HPROF.
+  int compression_level() const                { return _compression_level; }
+  void set_compression_level(int level)        { _compression_level = level; }
+
+  // If set, the progress of the object dump is printed to the VM output
+  // in 10% steps while the dump is running.
+  bool report_progress() const                 { return _report_progress; }
+  void set_report_progress(bool report)        { _report_progress = report; }
 };
 
 #endif // SHARE_VM_SERVICES_HEAPDUMPER_HPP
@@ -24,6 +24,7 @@
 #include "precompiled.hpp"
 
 #include "memory/allocation.hpp"
+#include "memory/metaspace.hpp"
 #include "services/mallocTracker.hpp"
 #include "services/memReporter.hpp"
 #include "services/virtualMemoryTracker.hpp"
@@ -251,6 +252,19 @@ void MemDetailReporter::report_virtual_memory_map() {
   }
 }
 
+void MemDetailReporter::report_metaspace() {
+  outputStream* out = output();
+  out->print_cr(" ");
+  out->print_cr("Metaspace free chunks:");
+  out->print("  Metadata:    ");
+  MetaspaceAux::print_fragmentation_on(out, Metaspace::NonClassType, scale());
+  if (Metaspace::using_class_space()) {
+    out->print("  Class space: ");
+    MetaspaceAux::print_fragmentation_on(out, Metaspace::ClassType, scale());
+  }
+  out->print_cr(" ");
+}
+
 void MemDetailReporter::report_virtual_memory_region(const ReservedMemoryRegion* reserved_rgn) {
   assert(reserved_rgn != NULL, "NULL pointer");
 
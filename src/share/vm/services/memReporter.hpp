@@ -51,6 +51,9 @@ class MemReporterBase : public StackObj {
   inline outputStream* output() const {
     return _output;
   }
+  inline size_t scale() const {
+    return _scale;
+  }
   // Current reporting scale
   inline const char* current_scale() const {
     return NMTUtil::scale_name(_scale);
@@ -129,6 +132,7 @@ class MemDetailReporter : public MemSummaryReporter {
   virtual void report() {
     MemSummaryReporter::report();
     report_virtual_memory_map();
+    report_metaspace();
     report_detail();
   }
 
@@ -137,6 +141,8 @@ class MemDetailReporter : public MemSummaryReporter {
   void report_detail();
   // Report virtual memory map
   void report_virtual_memory_map();
+  // Report free metaspace chunks and their fragmentation
+  void report_metaspace();
   // Report malloc allocation sites
   void report_malloc_sites();
   // Report virtual memory reservation sites
@@ -45,31 +45,3 @@ const char* NMTUtil::_memory_type_names[] = {
   "Unknown"
 };
 
-
-const char* NMTUtil::scale_name(size_t scale) {
-  switch(scale) {
-    case K: return "KB";
-    case M: return "MB";
-    case G: return "GB";
-  }
-  ShouldNotReachHere();
-  return NULL;
-}
-
-size_t NMTUtil::scale_from_name(const char* scale) {
-  assert(scale != NULL, "Null pointer check");
-  if (strncmp(scale, "KB", 2) == 0 ||
-      strncmp(scale, "kb", 2) == 0) {
-    return K;
-  } else if (strncmp(scale, "MB", 2) == 0 ||
-             strncmp(scale, "mb", 2) == 0) {
-    return M;
-  } else if (strncmp(scale, "GB", 2) == 0 ||
-             strncmp(scale, "gb", 2) == 0) {
-    return G;
-  } else {
-    return 0; // Invalid value
-  }
-  return K;
-}
-
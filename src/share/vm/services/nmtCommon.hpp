@@ -68,9 +68,33 @@ class NMTUtil : AllStatic {
     return (MEMFLAGS)index;
   }
 
-  // Memory size scale
-  static const char* scale_name(size_t scale);
-  static size_t scale_from_name(const char* scale);
+  // Memory size scale, defined inline so that metaspace reporting can
+  // use them in builds without NMT
+  static const char* scale_name(size_t scale) {
+    switch(scale) {
+      case K: return "KB";
+      case M: return "MB";
+      case G: return "GB";
+    }
+    ShouldNotReachHere();
+    return NULL;
+  }
+
+  static size_t scale_from_name(const char* scale) {
+    assert(scale != NULL, "Null pointer check");
+    if (strncmp(scale, "KB", 2) == 0 ||
+        strncmp(scale, "kb", 2) == 0) {
+      return K;
+    } else if (strncmp(scale, "MB", 2) == 0 ||
+               strncmp(scale, "mb", 2) == 0) {
+      return M;
+    } else if (strncmp(scale, "GB", 2) == 0 ||
+               strncmp(scale, "gb", 2) == 0) {
+      return G;
+    } else {
+      return 0; // Invalid value
+    }
+  }
 
   // Translate memory size in specified scale
   static size_t amount_in_scale(size_t amount, size_t scale) {
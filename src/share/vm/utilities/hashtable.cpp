@@ -112,7 +112,7 @@ template <class T, MEMFLAGS F> void RehashableHashtable<T, F>::move_to(Rehashabl
   int saved_entry_count = this->number_of_entries();
 
   // Iterate through the table and create a new entry for the new table
-  for (int i = 0; i < new_table->table_size(); ++i) {
+  for (int i = 0; i < this->table_size(); ++i) {
     for (HashtableEntry<T, F>* p = this->bucket(i); p != NULL; ) {
       HashtableEntry<T, F>* next = p->next();
       T string = p->literal();
@@ -145,6 +145,91 @@ template <class T, MEMFLAGS F> void RehashableHashtable<T, F>::move_to(Rehashabl
   BasicHashtable<F>::free_buckets();
 }
 
+template <class T, MEMFLAGS F> HashtableEntry<T, F>* RehashableHashtable<T, F>::allocate_entry(unsigned int hashValue, T obj) {
+  HashtableEntry<T, F>* entry =
+    (HashtableEntry<T, F>*)NEW_C_HEAP_ARRAY2(char, this->entry_size(), F, CURRENT_PC);
+  entry->set_next(NULL);
+  entry->set_hash(hashValue);
+  entry->set_literal(obj);
+  return entry;
+}
+
+template <class T, MEMFLAGS F> void RehashableHashtable<T, F>::free_entry_memory(BasicHashtableEntry<F>* entry) {
+  // Shared entries live in the CDS archive
+  if (!entry->is_shared()) {
+    FREE_C_HEAP_ARRAY(char, entry, F);
+  }
+}
+
+template <class T, MEMFLAGS F> void RehashableHashtable<T, F>::free_entries(typename BasicHashtable<F>::BucketUnlinkContext* context) {
+  BasicHashtableEntry<F>* entry = context->_removed_head;
+  while (entry != NULL) {
+    BasicHashtableEntry<F>* next = entry->next();
+    free_entry_memory(entry);
+    entry = next;
+  }
+  this->add_number_of_entries(-context->_num_removed);
+}
+
+template <class T, MEMFLAGS F> bool RehashableHashtable<T, F>::cas_insert(int i, intptr_t head, HashtableEntry<T, F>* entry) {
+  assert((head & HashtableBucket<F>::tag_mask) == 0, "cannot insert into a tagged bucket");
+  assert(entry->next() == head_entry(head), "entry must be linked to the head");
+  if (this->bucket_at(i)->cas_raw_entry(head, (intptr_t)entry)) {
+    this->add_number_of_entries(1);
+    return true;
+  }
+  return false;
+}
+
+template <class T, MEMFLAGS F> HashtableEntry<T, F>* RehashableHashtable<T, F>::lock_bucket(int i) {
+  HashtableBucket<F>* b = this->bucket_at(i);
+  while (true) {
+    intptr_t head = b->get_raw_entry();
+    assert((head & HashtableBucket<F>::tag_mask) == 0, "only one thread locks buckets");
+    // Fails only if an insert got in first
+    if (b->cas_raw_entry(head, head | bucket_locked)) {
+      return head_entry(head);
+    }
+  }
+}
+
+template <class T, MEMFLAGS F> void RehashableHashtable<T, F>::unlock_bucket(int i, HashtableEntry<T, F>* head) {
+  assert((this->bucket_head(i) & bucket_locked) != 0, "bucket must be locked");
+  this->bucket_at(i)->set_raw_entry((intptr_t)head);
+}
+
+template <class T, MEMFLAGS F> void RehashableHashtable<T, F>::move_bucket(int i) {
+  RehashableHashtable<T, F>* target = resize_target();
+  assert(target != NULL, "no resize in progress");
+  HashtableEntry<T, F>* head = lock_bucket(i);
+  for (HashtableEntry<T, F>* p = head; p != NULL; p = p->next()) {
+    // Lookups may still walk this bucket, so the entries are copied, not relinked
+    HashtableEntry<T, F>* copy = allocate_entry(p->hash(), p->literal());
+    int index = target->hash_to_index(p->hash());
+    while (true) {
+      intptr_t target_head = target->bucket_head(index);
+      copy->set_next(head_entry(target_head));
+      if (target->cas_insert(index, target_head, copy)) {
+        break;
+      }
+    }
+  }
+  // Keep the old chain reachable so that free_replaced_table() can free it
+  this->bucket_at(i)->set_raw_entry((intptr_t)head | bucket_moved);
+}
+
+template <class T, MEMFLAGS F> void RehashableHashtable<T, F>::free_replaced_table() {
+  for (int i = 0; i < this->table_size(); ++i) {
+    HashtableEntry<T, F>* p = head_entry(this->bucket_head(i));
+    while (p != NULL) {
+      HashtableEntry<T, F>* next = p->next();
+      free_entry_memory(p);
+      p = next;
+    }
+  }
+  BasicHashtable<F>::free_buckets();
+}
+
 template <MEMFLAGS F> void BasicHashtable<F>::free_buckets() {
   if (NULL != _buckets) {
     // Don't delete the buckets in the shared space.  They aren't
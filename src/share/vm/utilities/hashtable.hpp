@@ -128,11 +128,21 @@ public:
   // Accessing
   void clear()                        { _entry = NULL; }
 
+  // The low bits of _entry are free because entries are aligned. Tables
+  // that are updated without a lock (see RehashableHashtable) use them to
+  // tag a bucket while it is being worked on.
+  enum { tag_mask = 3 };
+
   // The following methods use order access methods to avoid race
-  // conditions in multiprocessor systems.
+  // conditions in multiprocessor systems. get_entry() strips the tags.
   BasicHashtableEntry<F>* get_entry() const;
   void set_entry(BasicHashtableEntry<F>* l);
 
+  // Tagged head for lock-free updates
+  intptr_t get_raw_entry() const;
+  void set_raw_entry(intptr_t l);
+  bool cas_raw_entry(intptr_t expected, intptr_t l);
+
   // The following method is not MT-safe and must be done under lock.
   BasicHashtableEntry<F>** entry_addr()  { return &_entry; }
 };
@@ -191,6 +201,11 @@ protected:
   // The following method is not MT-safe and must be done under lock.
   BasicHashtableEntry<F>** bucket_addr(int i) { return _buckets[i].entry_addr(); }
 
+  HashtableBucket<F>* bucket_at(int i) { return &_buckets[i]; }
+
+  // MT-safe update of the entry count
+  void add_number_of_entries(int delta);
+
   // Attempt to get an entry from the free list
   BasicHashtableEntry<F>* new_entry_free_list();
 
@@ -342,13 +357,59 @@ template <class T, MEMFLAGS F> class RehashableHashtable : public Hashtable<T, F
   // Check that the table is unbalanced
   bool check_rehash_table(int count);
 
+  // Support for lock-free inserts and online resizing, used by the
+  // SymbolTable and the StringTable.
+  //
+  // Lookups walk the buckets without any lock. Inserts CAS the new entry
+  // onto the bucket head. A resize copies the entries bucket by bucket into
+  // a new table, the resize target, and the new table replaces this one when
+  // all buckets are moved. Entries that get unlinked or replaced by a copy
+  // are freed at the next safepoint, when no lookup can still see them.
+  //
+  // While a bucket is worked on its head carries one of the tags below.
+  enum {
+    bucket_locked = 1,   // being moved or cleaned, inserts wait
+    bucket_moved  = 2    // entries now live in the resize target
+  };
+
+  RehashableHashtable<T, F>* volatile _resize_target;
+
+  intptr_t bucket_head(int i)  { return this->bucket_at(i)->get_raw_entry(); }
+
+  static HashtableEntry<T, F>* head_entry(intptr_t head) {
+    return (HashtableEntry<T, F>*)(head & ~(intptr_t)HashtableBucket<F>::tag_mask);
+  }
+
+  // Try to make 'entry', already linked to the current head, the new head.
+  bool cas_insert(int i, intptr_t head, HashtableEntry<T, F>* entry);
+
+  // Only one thread at a time locks buckets, the service thread or the
+  // VM thread at a safepoint. Returns the entries of the bucket.
+  HashtableEntry<T, F>* lock_bucket(int i);
+  void unlock_bucket(int i, HashtableEntry<T, F>* head);
+
+  // Copy the entries of bucket i into the resize target and tag it moved.
+  void move_bucket(int i);
+
  public:
   RehashableHashtable(int table_size, int entry_size)
-    : Hashtable<T, F>(table_size, entry_size) { }
+    : Hashtable<T, F>(table_size, entry_size), _resize_target(NULL) { }
 
   RehashableHashtable(int table_size, int entry_size,
                    HashtableBucket<F>* buckets, int number_of_entries)
-    : Hashtable<T, F>(table_size, entry_size, buckets, number_of_entries) { }
+    : Hashtable<T, F>(table_size, entry_size, buckets, number_of_entries), _resize_target(NULL) { }
+
+  inline RehashableHashtable<T, F>* resize_target() const;
+  inline void set_resize_target(RehashableHashtable<T, F>* target);
+
+  // Entries of lock-free tables are allocated one by one so that they can
+  // be freed one by one once unreachable.
+  HashtableEntry<T, F>* allocate_entry(unsigned int hashValue, T obj);
+  static void free_entry_memory(BasicHashtableEntry<F>* entry);
+  // Free the entries collected by an unlink at a safepoint.
+  void free_entries(typename BasicHashtable<F>::BucketUnlinkContext* context);
+  // Free the buckets and the entries of a table that a resize replaced.
+  void free_replaced_table();
 
 
   // Function to move these elements into the new table.
@@ -26,6 +26,7 @@
 #define SHARE_VM_UTILITIES_HASHTABLE_INLINE_HPP
 
 #include "memory/allocation.inline.hpp"
+#include "runtime/atomic.inline.hpp"
 #include "runtime/orderAccess.inline.hpp"
 #include "utilities/hashtable.hpp"
 #include "utilities/dtrace.hpp"
@@ -92,7 +93,37 @@ template <MEMFLAGS F> inline BasicHashtableEntry<F>* HashtableBucket<F>::get_ent
   //          without locks.  The new SystemDictionaryEntry must be
   //          complete before other threads can be allowed to see it
   //          via a store to _buckets[index].
-  return (BasicHashtableEntry<F>*) OrderAccess::load_ptr_acquire(&_entry);
+  return (BasicHashtableEntry<F>*) ((intptr_t) OrderAccess::load_ptr_acquire(&_entry) & ~(intptr_t)tag_mask);
+}
+
+
+template <MEMFLAGS F> inline intptr_t HashtableBucket<F>::get_raw_entry() const {
+  return (intptr_t) OrderAccess::load_ptr_acquire(&_entry);
+}
+
+
+template <MEMFLAGS F> inline void HashtableBucket<F>::set_raw_entry(intptr_t l) {
+  OrderAccess::release_store_ptr(&_entry, (BasicHashtableEntry<F>*)l);
+}
+
+
+template <MEMFLAGS F> inline bool HashtableBucket<F>::cas_raw_entry(intptr_t expected, intptr_t l) {
+  return Atomic::cmpxchg_ptr(l, (volatile intptr_t*)&_entry, expected) == expected;
+}
+
+
+template <MEMFLAGS F> inline void BasicHashtable<F>::add_number_of_entries(int delta) {
+  Atomic::add(delta, &_number_of_entries);
+}
+
+
+template <class T, MEMFLAGS F> inline RehashableHashtable<T, F>* RehashableHashtable<T, F>::resize_target() const {
+  return (RehashableHashtable<T, F>*) OrderAccess::load_ptr_acquire(&_resize_target);
+}
+
+
+template <class T, MEMFLAGS F> inline void RehashableHashtable<T, F>::set_resize_target(RehashableHashtable<T, F>* target) {
+  OrderAccess::release_store_ptr(&_resize_target, target);
 }
 
 
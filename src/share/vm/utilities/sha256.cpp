@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "precompiled.hpp"
+#include "utilities/sha256.hpp"
+
+static const juint round_constants[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static inline juint rotr(juint x, int n) {
+  return (x >> n) | (x << (32 - n));
+}
+
+SHA256::SHA256() : _block_used(0), _total_length(0) {
+  _state[0] = 0x6a09e667;
+  _state[1] = 0xbb67ae85;
+  _state[2] = 0x3c6ef372;
+  _state[3] = 0xa54ff53a;
+  _state[4] = 0x510e527f;
+  _state[5] = 0x9b05688c;
+  _state[6] = 0x1f83d9ab;
+  _state[7] = 0x5be0cd19;
+}
+
+void SHA256::process_block(const u1* block) {
+  juint w[64];
+  for (int i = 0; i < 16; i++) {
+    w[i] = ((juint)block[4 * i] << 24) | ((juint)block[4 * i + 1] << 16) |
+           ((juint)block[4 * i + 2] << 8) | (juint)block[4 * i + 3];
+  }
+  for (int i = 16; i < 64; i++) {
+    juint s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    juint s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  juint a = _state[0], b = _state[1], c = _state[2], d = _state[3];
+  juint e = _state[4], f = _state[5], g = _state[6], h = _state[7];
+  for (int i = 0; i < 64; i++) {
+    juint s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+    juint ch = (e & f) ^ (~e & g);
+    juint t1 = h + s1 + ch + round_constants[i] + w[i];
+    juint s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+    juint maj = (a & b) ^ (a & c) ^ (b & c);
+    juint t2 = s0 + maj;
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+  _state[0] += a; _state[1] += b; _state[2] += c; _state[3] += d;
+  _state[4] += e; _state[5] += f; _state[6] += g; _state[7] += h;
+}
+
+void SHA256::update(const u1* data, size_t length) {
+  _total_length += length;
+  if (_block_used > 0) {
+    size_t n = MIN2(length, (size_t)block_length - _block_used);
+    memcpy(_block + _block_used, data, n);
+    _block_used += n;
+    data += n;
+    length -= n;
+    if (_block_used < block_length) {
+      return;
+    }
+    process_block(_block);
+    _block_used = 0;
+  }
+  while (length >= block_length) {
+    process_block(data);
+    data += block_length;
+    length -= block_length;
+  }
+  memcpy(_block, data, length);
+  _block_used = length;
+}
+
+void SHA256::finish(u1* digest) {
+  // Padding: a one bit, zeros, then the message length in bits
+  const julong bit_length = _total_length * 8;
+  _block[_block_used++] = 0x80;
+  if (_block_used > block_length - 8) {
+    memset(_block + _block_used, 0, block_length - _block_used);
+    process_block(_block);
+    _block_used = 0;
+  }
+  memset(_block + _block_used, 0, block_length - 8 - _block_used);
+  for (int i = 0; i < 8; i++) {
+    _block[block_length - 1 - i] = (u1)(bit_length >> (8 * i));
+  }
+  process_block(_block);
+
+  for (int i = 0; i < 8; i++) {
+    digest[4 * i]     = (u1)(_state[i] >> 24);
+    digest[4 * i + 1] = (u1)(_state[i] >> 16);
+    digest[4 * i + 2] = (u1)(_state[i] >> 8);
+    digest[4 * i + 3] = (u1)_state[i];
+  }
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef SHARE_VM_UTILITIES_SHA256_HPP
+#define SHARE_VM_UTILITIES_SHA256_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+// SHA-256 (FIPS 180-4) of a byte buffer, for keying persistent caches on
+// file contents where a checksum could be forged.
+class SHA256 : public StackObj {
+ public:
+  enum {
+    digest_length = 32,
+    block_length  = 64
+  };
+
+ private:
+  juint    _state[8];
+  u1       _block[block_length];
+  size_t   _block_used;
+  julong   _total_length;
+
+  void process_block(const u1* block);
+
+ public:
+  SHA256();
+
+  void update(const u1* data, size_t length);
+  // Writes the digest_length bytes of the digest, the object cannot be
+  // updated any more afterwards.
+  void finish(u1* digest);
+
+  static void digest(const u1* data, size_t length, u1* digest) {
+    SHA256 sha;
+    sha.update(data, length);
+    sha.finish(digest);
+  }
+};
+
+#endif // SHARE_VM_UTILITIES_SHA256_HPP
@@ -316,10 +316,15 @@ int UNICODE::utf8_size(jchar c) {
   return 3;
 }
 
-int UNICODE::utf8_length(jchar* base, int length) {
+// Latin-1 strings are stored one byte per character; widen them so
+// that the same conversions serve both representations.
+static inline jchar as_jchar(jchar c) { return c; }
+static inline jchar as_jchar(jbyte c) { return (jchar)(c & 0xff); }
+
+template<typename T> static int utf8_length_impl(const T* base, int length) {
   int result = 0;
   for (int index = 0; index < length; index++) {
-    jchar c = base[index];
+    jchar c = as_jchar(base[index]);
     if ((0x0001 <= c) && (c <= 0x007F)) result += 1;
     else if (c <= 0x07FF) result += 2;
     else result += 3;
@@ -327,42 +332,41 @@ int UNICODE::utf8_length(jchar* base, int length) {
   return result;
 }
 
-char* UNICODE::as_utf8(jchar* base, int length) {
-  int utf8_len = utf8_length(base, length);
+template<typename T> static char* as_utf8_impl(const T* base, int length) {
+  int utf8_len = utf8_length_impl(base, length);
   u_char* result = NEW_RESOURCE_ARRAY(u_char, utf8_len + 1);
   u_char* p = result;
   for (int index = 0; index < length; index++) {
-    p = utf8_write(p, base[index]);
+    p = utf8_write(p, as_jchar(base[index]));
   }
   *p = '\0';
   assert(p == &result[utf8_len], "length prediction must be correct");
   return (char*) result;
 }
 
-char* UNICODE::as_utf8(jchar* base, int length, char* buf, int buflen) {
+template<typename T> static char* as_utf8_impl(const T* base, int length, char* buf, int buflen) {
   u_char* p = (u_char*)buf;
   u_char* end = (u_char*)buf + buflen;
   for (int index = 0; index < length; index++) {
-    jchar c = base[index];
-    if (p + utf8_size(c) >= end) break;      // string is truncated
-    p = utf8_write(p, base[index]);
+    jchar c = as_jchar(base[index]);
+    if (p + UNICODE::utf8_size(c) >= end) break;      // string is truncated
+    p = utf8_write(p, c);
   }
   *p = '\0';
   return buf;
 }
 
-void UNICODE::convert_to_utf8(const jchar* base, int length, char* utf8_buffer) {
+template<typename T> static void convert_to_utf8_impl(const T* base, int length, char* utf8_buffer) {
   for(int index = 0; index < length; index++) {
-    utf8_buffer = (char*)utf8_write((u_char*)utf8_buffer, base[index]);
+    utf8_buffer = (char*)utf8_write((u_char*)utf8_buffer, as_jchar(base[index]));
   }
   *utf8_buffer = '\0';
 }
 
-// returns the quoted ascii length of a unicode string
-int UNICODE::quoted_ascii_length(jchar* base, int length) {
+template<typename T> static int quoted_ascii_length_impl(const T* base, int length) {
   int result = 0;
   for (int i = 0; i < length; i++) {
-    jchar c = base[i];
+    jchar c = as_jchar(base[i]);
     if (c >= 32 && c < 127) {
       result++;
     } else {
@@ -372,12 +376,11 @@ int UNICODE::quoted_ascii_length(jchar* base, int length) {
   return result;
 }
 
-// converts a utf8 string to quoted ascii
-void UNICODE::as_quoted_ascii(const jchar* base, int length, char* buf, int buflen) {
+template<typename T> static void as_quoted_ascii_impl(const T* base, int length, char* buf, int buflen) {
   char* p = buf;
   char* end = buf + buflen;
   for (int index = 0; index < length; index++) {
-    jchar c = base[index];
+    jchar c = as_jchar(base[index]);
     if (c >= 32 && c < 127) {
       if (p + 1 >= end) break;      // string is truncated
       *p++ = (char)c;
@@ -389,3 +392,62 @@ void UNICODE::as_quoted_ascii(const jchar* base, int length, char* buf, int bufl
   }
   *p = '\0';
 }
+
+int UNICODE::utf8_length(jchar* base, int length) {
+  return utf8_length_impl(base, length);
+}
+
+int UNICODE::utf8_length(jbyte* base, int length) {
+  return utf8_length_impl(base, length);
+}
+
+char* UNICODE::as_utf8(jchar* base, int length) {
+  return as_utf8_impl(base, length);
+}
+
+char* UNICODE::as_utf8(jbyte* base, int length) {
+  return as_utf8_impl(base, length);
+}
+
+char* UNICODE::as_utf8(jchar* base, int length, char* buf, int buflen) {
+  return as_utf8_impl(base, length, buf, buflen);
+}
+
+char* UNICODE::as_utf8(jbyte* base, int length, char* buf, int buflen) {
+  return as_utf8_impl(base, length, buf, buflen);
+}
+
+void UNICODE::convert_to_utf8(const jchar* base, int length, char* utf8_buffer) {
+  convert_to_utf8_impl(base, length, utf8_buffer);
+}
+
+void UNICODE::convert_to_utf8(const jbyte* base, int length, char* utf8_buffer) {
+  convert_to_utf8_impl(base, length, utf8_buffer);
+}
+
+// returns the quoted ascii length of a unicode string
+int UNICODE::quoted_ascii_length(jchar* base, int length) {
+  return quoted_ascii_length_impl(base, length);
+}
+
+int UNICODE::quoted_ascii_length(jbyte* base, int length) {
+  return quoted_ascii_length_impl(base, length);
+}
+
+// converts a utf8 string to quoted ascii
+void UNICODE::as_quoted_ascii(const jchar* base, int length, char* buf, int buflen) {
+  as_quoted_ascii_impl(base, length, buf, buflen);
+}
+
+void UNICODE::as_quoted_ascii(const jbyte* base, int length, char* buf, int buflen) {
+  as_quoted_ascii_impl(base, length, buf, buflen);
+}
+
+bool UNICODE::is_latin1(const jchar* base, int length) {
+  for (int index = 0; index < length; index++) {
+    if (base[index] > 0xff) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -73,6 +73,7 @@ class UTF8 : AllStatic {
 // A unicode string represents a string in the UTF-16 format in which supplementary
 // characters are represented by surrogate pairs. Index values refer to char code
 // units, so a supplementary character uses two positions in a unicode string.
+// The jbyte variants take Latin-1 strings, one byte per character.
 
 class UNICODE : AllStatic {
  public:
@@ -81,20 +82,29 @@ class UNICODE : AllStatic {
 
   // returns the utf8 length of a unicode string
   static int utf8_length(jchar* base, int length);
+  static int utf8_length(jbyte* base, int length);
 
   // converts a unicode string to utf8 string
   static void convert_to_utf8(const jchar* base, int length, char* utf8_buffer);
+  static void convert_to_utf8(const jbyte* base, int length, char* utf8_buffer);
 
   // converts a unicode string to a utf8 string; result is allocated
   // in resource area unless a buffer is provided.
   static char* as_utf8(jchar* base, int length);
+  static char* as_utf8(jbyte* base, int length);
   static char* as_utf8(jchar* base, int length, char* buf, int buflen);
+  static char* as_utf8(jbyte* base, int length, char* buf, int buflen);
 
   // returns the quoted ascii length of a unicode string
   static int quoted_ascii_length(jchar* base, int length);
+  static int quoted_ascii_length(jbyte* base, int length);
 
   // converts a utf8 string to quoted ascii
   static void as_quoted_ascii(const jchar* base, int length, char* buf, int buflen);
+  static void as_quoted_ascii(const jbyte* base, int length, char* buf, int buflen);
+
+  // returns true if every character fits in one Latin-1 byte
+  static bool is_latin1(const jchar* base, int length);
 };
 
 #endif // SHARE_VM_UTILITIES_UTF8_HPP
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+
+/*
+ * @test
+ * @summary An allocation that escapes only on a rarely taken branch is
+ *          scalar replaced elsewhere and rematerialized correctly when the
+ *          branch is finally taken; prints allocated bytes per call
+ * @run main/othervm -XX:-TieredCompilation -XX:-BackgroundCompilation
+ *      -XX:CompileCommand=dontinline,compiler.escapeAnalysis.TestRareEscapePath::test
+ *      -XX:+PartialEscapeAnalysis
+ *      compiler.escapeAnalysis.TestRareEscapePath
+ * @run main/othervm -XX:-TieredCompilation -XX:-BackgroundCompilation
+ *      -XX:CompileCommand=dontinline,compiler.escapeAnalysis.TestRareEscapePath::test
+ *      -XX:-PartialEscapeAnalysis
+ *      compiler.escapeAnalysis.TestRareEscapePath
+ */
+
+package compiler.escapeAnalysis;
+
+import java.lang.management.ManagementFactory;
+
+public class TestRareEscapePath {
+    static final int RARE_MASK = 4095; // escape once every 4096 calls
+    static final int WARMUP = 200000;
+    static final int TIMED = 1000000;
+
+    static class Point {
+        int x;
+        int y;
+        Point(int x, int y) {
+            this.x = x;
+            this.y = y;
+        }
+    }
+
+    static Point sink;
+
+    static int test(int i) {
+        Point p = new Point(i, i + 1);
+        if ((i & RARE_MASK) == RARE_MASK) {
+            sink = p; // rare escape
+        }
+        p.x += 3;
+        return p.x * p.y;
+    }
+
+    static int expected(int i) {
+        return (i + 3) * (i + 1);
+    }
+
+    static void check(int i) {
+        int r = test(i);
+        if (r != expected(i)) {
+            throw new RuntimeException("test(" + i + ") = " + r + ", expected " + expected(i));
+        }
+        if ((i & RARE_MASK) == RARE_MASK) {
+            // The escaped object must carry the state it had at the escape
+            // point and see the later update.
+            if (sink == null || sink.x != i + 3 || sink.y != i + 1) {
+                throw new RuntimeException("escaped object has wrong state at " + i);
+            }
+            sink = null;
+        }
+    }
+
+    static long allocatedBytes() {
+        com.sun.management.ThreadMXBean bean =
+            (com.sun.management.ThreadMXBean) ManagementFactory.getThreadMXBean();
+        return bean.getThreadAllocatedBytes(Thread.currentThread().getId());
+    }
+
+    public static void main(String[] args) {
+        for (int i = 0; i < WARMUP; i++) {
+            check(i);
+        }
+
+        // Compiled code must handle the rare branch, either through the
+        // compiled escape or through a trap and rematerialization.
+        for (int i = 0; i < 16; i++) {
+            check(i * (RARE_MASK + 1) + RARE_MASK);
+            check(i);
+        }
+
+        long before = allocatedBytes();
+        int sum = 0;
+        for (int i = 0; i < TIMED; i++) {
+            sum += test(i & ~RARE_MASK); // never takes the rare branch
+        }
+        long after = allocatedBytes();
+        System.out.println("sum " + sum + ", bytes/call " + (double) (after - before) / TIMED);
+    }
+}
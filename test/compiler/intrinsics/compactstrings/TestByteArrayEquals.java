@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test
+ * @summary Arrays.equals(byte[], byte[]) intrinsic must agree with the
+ *          interpreter for all lengths and mismatch positions
+ * @run main/othervm -XX:-BackgroundCompilation -XX:-UseOnStackReplacement TestByteArrayEquals
+ * @run main/othervm -XX:-BackgroundCompilation -XX:-UseOnStackReplacement -XX:UseAVX=0 TestByteArrayEquals
+ */
+
+import java.util.Arrays;
+
+public class TestByteArrayEquals {
+
+    static boolean test(byte[] a, byte[] b) {
+        return Arrays.equals(a, b);
+    }
+
+    static boolean reference(byte[] a, byte[] b) {
+        if (a == b) {
+            return true;
+        }
+        if (a == null || b == null || a.length != b.length) {
+            return false;
+        }
+        for (int i = 0; i < a.length; i++) {
+            if (a[i] != b[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static void check(byte[] a, byte[] b) {
+        boolean expected = reference(a, b);
+        boolean actual = test(a, b);
+        if (expected != actual) {
+            throw new RuntimeException("Arrays.equals(" + Arrays.toString(a) + ", " +
+                                       Arrays.toString(b) + ") returned " + actual);
+        }
+    }
+
+    public static void main(String[] args) {
+        byte[] warm = new byte[17];
+        for (int i = 0; i < 20000; i++) {
+            test(warm, warm.clone());
+        }
+
+        for (int len = 0; len < 80; len++) {
+            byte[] a = new byte[len];
+            for (int i = 0; i < len; i++) {
+                a[i] = (byte)(i * 31 + 7);
+            }
+            check(a, a);
+            check(a, a.clone());
+            check(a, null);
+            check(null, a);
+            check(a, Arrays.copyOf(a, len + 1));
+            // A mismatch at every position, including the vector tails
+            for (int pos = 0; pos < len; pos++) {
+                byte[] b = a.clone();
+                b[pos] ^= (byte)0x80;
+                check(a, b);
+            }
+        }
+        System.out.println("TEST PASSED");
+    }
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test
+ * @summary Strip mined counted loops compute the same results as the
+ *          interpreter and let threads reach safepoints quickly
+ * @library /testlibrary
+ * @run main/othervm -XX:-TieredCompilation -XX:-BackgroundCompilation
+ *      -XX:+UseCountedLoopSafepoints -XX:LoopStripMiningIter=1000
+ *      TestLoopStripMining
+ * @run main/othervm -XX:-TieredCompilation -XX:-BackgroundCompilation
+ *      -XX:+UseCountedLoopSafepoints -XX:LoopStripMiningIter=7
+ *      TestLoopStripMining
+ */
+
+import java.util.Arrays;
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.ProcessTools;
+
+public class TestLoopStripMining {
+
+    static int sumUp(int[] a, int from, int to) {
+        int sum = 0;
+        for (int i = from; i < to; i++) {
+            sum += a[i];
+        }
+        return sum;
+    }
+
+    static int sumDown(int[] a) {
+        int sum = 0;
+        for (int i = a.length - 1; i >= 0; i--) {
+            sum = sum * 31 + a[i];
+        }
+        return sum;
+    }
+
+    static void scale(int[] dst, int[] src, int k) {
+        for (int i = 0; i < src.length; i++) {
+            dst[i] = src[i] * k;
+        }
+    }
+
+    static long strided(int from, int to) {
+        long sum = 0;
+        int i = from;
+        for (; i < to; i += 3) {
+            sum += i;
+        }
+        return sum * 1000 + i;
+    }
+
+    static int nearMax(int from) {
+        int n = 0;
+        for (int i = from; i < Integer.MAX_VALUE - 1; i++) {
+            n++;
+        }
+        return n;
+    }
+
+    static int doWhile(int i, int limit) {
+        int n = 0;
+        do {
+            n++;
+            i++;
+        } while (i < limit);
+        return n * 1000 + i;
+    }
+
+    static long sumUpRef(int[] a, int from, int to) {
+        long sum = 0;
+        for (int i = from; i < to; i++) {
+            sum += a[i];
+        }
+        return sum;
+    }
+
+    static void check(long expected, long actual, String what) {
+        if (expected != actual) {
+            throw new RuntimeException(what + ": expected " + expected + " but got " + actual);
+        }
+    }
+
+    public static void main(String[] args) throws Exception {
+        if (args.length == 1) {
+            spin(Integer.parseInt(args[0]));
+            return;
+        }
+
+        int[] a = new int[10007];
+        for (int i = 0; i < a.length; i++) {
+            a[i] = i * 7 - 5000;
+        }
+        int[] b = new int[a.length];
+        int expectedDown = 0;
+        for (int i = a.length - 1; i >= 0; i--) {
+            expectedDown = expectedDown * 31 + a[i];
+        }
+
+        for (int iter = 0; iter < 20000; iter++) {
+            int from = iter % 13;
+            int to = a.length - (iter % 17);
+            check((int)sumUpRef(a, from, to), sumUp(a, from, to), "sumUp");
+            check(expectedDown, sumDown(a), "sumDown");
+            scale(b, a, 3);
+            check(a[iter % a.length] * 3, b[iter % a.length], "scale");
+            check(1498500L * 1000 + 3000, strided(0, 3000), "strided");
+            check(1000 + 6, doWhile(5, 3), "doWhile single trip");
+            check(4, nearMax(Integer.MAX_VALUE - 5), "nearMax");
+            check(1000 * 1000 + 1000, doWhile(0, 1000), "doWhile");
+        }
+        check(Integer.MAX_VALUE - 1, nearMax(0), "nearMax full range");
+        int[] expected = new int[a.length];
+        for (int i = 0; i < a.length; i++) {
+            expected[i] = a[i] * 3;
+        }
+        if (!Arrays.equals(expected, b)) {
+            throw new RuntimeException("scale: arrays differ");
+        }
+
+        // A long counted loop must not hold off a safepoint
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+                "-XX:-TieredCompilation",
+                "-XX:+UseBiasedLocking",
+                "-XX:BiasedLockingStartupDelay=500",
+                "-XX:+SafepointTimeout",
+                "-XX:SafepointTimeoutDelay=2000",
+                "-XX:LoopStripMiningIter=1000",
+                "TestLoopStripMining",
+                "2000000000");
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldNotContain("Timeout detected");
+        output.shouldHaveExitValue(0);
+    }
+
+    static volatile int sink;
+
+    static void spin(int loops) {
+        int[] a = new int[1024];
+        int sum = 0;
+        for (int i = 0; i < loops; i++) {
+            sum += a[i & 1023] + i;
+        }
+        sink = sum;
+    }
+}
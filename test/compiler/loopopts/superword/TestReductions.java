@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test
+ * @summary Vectorized add and mul reductions compute the same results as
+ *          the interpreter; prints timings with and without reductions
+ * @run main/othervm -XX:-TieredCompilation -XX:-BackgroundCompilation
+ *      -XX:+UseSuperWord -XX:+SuperWordReductions
+ *      compiler.loopopts.superword.TestReductions
+ * @run main/othervm -XX:-TieredCompilation -XX:-BackgroundCompilation
+ *      -XX:+UseSuperWord -XX:-SuperWordReductions
+ *      compiler.loopopts.superword.TestReductions
+ */
+
+package compiler.loopopts.superword;
+
+import java.util.Random;
+
+public class TestReductions {
+    static final int LEN = 8 * 1024 + 3; // odd length exercises the post loop
+    static final int WARMUP = 20000;
+    static final int TIMED = 2000;
+
+    static int[] ia = new int[LEN];
+    static int[] ib = new int[LEN];
+    static long[] la = new long[LEN];
+    static float[] fa = new float[LEN];
+    static float[] fb = new float[LEN];
+    static double[] da = new double[LEN];
+    static double[] db = new double[LEN];
+
+    static int sumI(int[] a) {
+        int sum = 0;
+        for (int i = 0; i < a.length; i++) {
+            sum += a[i];
+        }
+        return sum;
+    }
+
+    static int prodI(int[] a) {
+        int prod = 1;
+        for (int i = 0; i < a.length; i++) {
+            prod *= a[i] | 1; // keep the product odd, hence non-zero
+        }
+        return prod;
+    }
+
+    static int dotI(int[] a, int[] b) {
+        int sum = 0;
+        for (int i = 0; i < a.length; i++) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+
+    static long sumL(long[] a) {
+        long sum = 0;
+        for (int i = 0; i < a.length; i++) {
+            sum += a[i];
+        }
+        return sum;
+    }
+
+    static float sumF(float[] a) {
+        float sum = 0;
+        for (int i = 0; i < a.length; i++) {
+            sum += a[i];
+        }
+        return sum;
+    }
+
+    static float dotF(float[] a, float[] b) {
+        float sum = 0;
+        for (int i = 0; i < a.length; i++) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+
+    static float prodF(float[] b) {
+        float prod = 1;
+        for (int i = 0; i < b.length; i++) {
+            prod *= b[i] * b[i];
+        }
+        return prod;
+    }
+
+    static double dotD(double[] a, double[] b) {
+        double sum = 0;
+        for (int i = 0; i < a.length; i++) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+
+    static double prodD(double[] a, double[] b) {
+        double prod = 1;
+        for (int i = 0; i < a.length; i++) {
+            prod *= 1 + a[i] * b[i];
+        }
+        return prod;
+    }
+
+    // The running sum is also used inside the loop, so it must not be
+    // turned into a reduction.
+    static int prefixSum(int[] a, int[] out) {
+        int sum = 0;
+        for (int i = 0; i < a.length; i++) {
+            sum += a[i];
+            out[i] = sum;
+        }
+        return sum;
+    }
+
+    static final int N = 10;
+    static long[] golden = new long[N];
+    static long[] nanos = new long[N];
+    static final String[] NAMES = {
+        "sumI", "prodI", "dotI", "sumL", "sumF", "dotF", "prodF", "dotD", "prodD", "prefixSum"
+    };
+
+    static long run(int k) {
+        switch (k) {
+        case 0: return sumI(ia);
+        case 1: return prodI(ia);
+        case 2: return dotI(ia, ib);
+        case 3: return sumL(la);
+        case 4: return Float.floatToRawIntBits(sumF(fa));
+        case 5: return Float.floatToRawIntBits(dotF(fa, fb));
+        case 6: return Float.floatToRawIntBits(prodF(fb));
+        case 7: return Double.doubleToRawLongBits(dotD(da, db));
+        case 8: return Double.doubleToRawLongBits(prodD(da, db));
+        case 9: return prefixSum(ia, ib.clone());
+        }
+        throw new InternalError();
+    }
+
+    public static void main(String[] args) {
+        Random r = new Random(42);
+        for (int i = 0; i < LEN; i++) {
+            ia[i] = r.nextInt();
+            ib[i] = r.nextInt(1000) - 500;
+            la[i] = r.nextLong();
+            fa[i] = r.nextFloat() * 2 - 1;
+            fb[i] = 1 + r.nextFloat() / 1024;
+            da[i] = r.nextDouble() * 2 - 1;
+            db[i] = r.nextDouble() / 1024;
+        }
+
+        // The first call runs in the interpreter and gives the expected
+        // values, with the exact rounding of sequential float arithmetic.
+        for (int k = 0; k < N; k++) {
+            golden[k] = run(k);
+        }
+
+        for (int iter = 0; iter < WARMUP; iter++) {
+            for (int k = 0; k < N; k++) {
+                check(k, run(k));
+            }
+        }
+
+        for (int k = 0; k < N; k++) {
+            long start = System.nanoTime();
+            for (int iter = 0; iter < TIMED; iter++) {
+                check(k, run(k));
+            }
+            nanos[k] = (System.nanoTime() - start) / TIMED;
+        }
+        for (int k = 0; k < N; k++) {
+            System.out.println(NAMES[k] + ": " + nanos[k] + " ns/op");
+        }
+    }
+
+    static void check(int k, long value) {
+        if (value != golden[k]) {
+            throw new RuntimeException(NAMES[k] + ": expected " + golden[k] + " but got " + value);
+        }
+    }
+}
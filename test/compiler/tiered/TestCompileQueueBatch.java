@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test TestCompileQueueBatch
+ * @key jcmd
+ * @summary Tiered compilation selects tasks from the rated compile queue, and reports queue histograms
+ * @library /testlibrary /testlibrary/whitebox
+ * @build TestCompileQueueBatch
+ * @run main ClassFileInstaller sun.hotspot.WhiteBox
+ * @run main/othervm -XX:+TieredCompilation -XX:TieredCompileQueueBatchSize=1 TestCompileQueueBatch
+ * @run main/othervm -XX:+TieredCompilation -XX:TieredCompileQueueBatchSize=16 -XX:TieredCompileTaskTimeout=1 TestCompileQueueBatch
+ * @run main/othervm -XX:+TieredCompilation TestCompileQueueBatch
+ * @run main/othervm -Xbootclasspath/a:. -XX:+UnlockDiagnosticVMOptions -XX:+WhiteBoxAPI
+ *      -XX:+TieredCompilation -XX:CICompilerCount=2 -XX:TieredCompileQueueBatchSize=16 -XX:TieredCompileTaskTimeout=1000000
+ *      -XX:Tier3InvocationThreshold=1000000000 -XX:Tier3MinInvocationThreshold=1000000000
+ *      -XX:Tier3CompileThreshold=1000000000 -XX:Tier3BackEdgeThreshold=1000000000
+ *      TestCompileQueueBatch order
+ */
+
+import java.lang.reflect.Method;
+import java.lang.reflect.Modifier;
+import java.math.BigDecimal;
+import java.math.BigInteger;
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.List;
+import java.util.concurrent.ConcurrentSkipListMap;
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+import com.oracle.java.testlibrary.JDKToolFinder;
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.ProcessTools;
+import sun.hotspot.WhiteBox;
+
+public class TestCompileQueueBatch {
+    static volatile Object sink;
+
+    // Touch enough JDK code to keep both compile queues busy
+    static void work(int i) {
+        List<String> list = new ArrayList<>();
+        for (int j = 0; j < 50; j++) {
+            list.add(String.format("%d-%x-%s", i * j, j, BigInteger.valueOf(i).pow(j % 7)));
+        }
+        Collections.sort(list);
+        Matcher m = Pattern.compile("(\\d+)-([0-9a-f]+)").matcher(list.toString());
+        int count = 0;
+        while (m.find()) {
+            count += m.group(2).length();
+        }
+        sink = count;
+    }
+
+    static long sum(String output, String prefix) {
+        long sum = 0;
+        for (String line : output.split("\n")) {
+            if (line.startsWith(prefix)) {
+                sum += Long.parseLong(line.substring(line.indexOf('=') + 1).trim());
+            }
+        }
+        return sum;
+    }
+
+    static OutputAnalyzer perfCounters() throws Exception {
+        String pid = Integer.toString(ProcessTools.getProcessId());
+        ProcessBuilder pb = new ProcessBuilder(JDKToolFinder.getJDKTool("jcmd"), pid, "PerfCounter.print");
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+        return output;
+    }
+
+    public static void main(String[] args) throws Exception {
+        if (args.length > 0 && args[0].equals("order")) {
+            testOrder();
+            return;
+        }
+
+        for (int i = 0; i < 5000; i++) {
+            work(i);
+        }
+
+        OutputAnalyzer output = perfCounters();
+        for (String queue : new String[] { "c1Queue", "c2Queue" }) {
+            output.shouldContain("sun.ci." + queue + ".waitTime.lt1ms=");
+            output.shouldContain("sun.ci." + queue + ".waitTime.ge10s=");
+            output.shouldContain("sun.ci." + queue + ".length.lt10=");
+            output.shouldContain("sun.ci." + queue + ".maxLength=");
+            output.shouldContain("sun.ci." + queue + ".staleTasks=");
+        }
+        String text = output.getOutput();
+        long selected = sum(text, "sun.ci.c1Queue.waitTime.");
+        long queued = sum(text, "sun.ci.c1Queue.length.");
+        System.out.println("c1 tasks queued: " + queued + ", selected: " + selected);
+        if (selected == 0 || selected > queued) {
+            throw new RuntimeException("Unexpected C1 queue histograms: queued " + queued + ", selected " + selected);
+        }
+    }
+
+    static final int C2_LEVEL = 4;
+
+    static int hotCalls;
+
+    // Called often enough to outweigh any method that ran during startup.
+    static void hot() {
+        for (int i = 0; i < 100; i++) {
+            hotCalls += i;
+        }
+    }
+
+    // Methods that did not run, and are not compiled automatically since
+    // the thresholds are out of reach.
+    static List<Method> coldMethods(Class<?> klass) {
+        List<Method> methods = new ArrayList<>();
+        for (Method m : klass.getDeclaredMethods()) {
+            if (!Modifier.isAbstract(m.getModifiers()) && !Modifier.isNative(m.getModifiers())) {
+                methods.add(m);
+            }
+        }
+        return methods;
+    }
+
+    static List<Method> enqueue(WhiteBox wb, List<Method> methods) {
+        List<Method> queued = new ArrayList<>();
+        for (Method m : methods) {
+            if (wb.enqueueMethodForCompilation(m, C2_LEVEL)) {
+                queued.add(m);
+            }
+        }
+        return queued;
+    }
+
+    static void testOrder() throws Exception {
+        WhiteBox wb = WhiteBox.getWhiteBox();
+        sink = new BigDecimal(1);
+        sink = new ConcurrentSkipListMap<String, String>();
+
+        // A hot method queued after cold ones is selected first: when it is
+        // compiled, cold methods queued before it are still waiting.
+        List<Method> cold = enqueue(wb, coldMethods(BigDecimal.class));
+        for (int i = 0; i < 100000; i++) {
+            hot();
+        }
+        Method hotMethod = TestCompileQueueBatch.class.getDeclaredMethod("hot");
+        if (!wb.enqueueMethodForCompilation(hotMethod, C2_LEVEL)) {
+            throw new RuntimeException("hot() was not queued");
+        }
+        int waiting = 0;
+        for (Method m : cold) {
+            if (wb.isMethodQueuedForCompilation(m)) {
+                waiting++;
+            }
+        }
+        System.out.println(cold.size() + " cold methods queued, " + waiting + " still waiting when hot() was queued");
+        if (waiting < 2) {
+            throw new RuntimeException("the C2 queue drained before hot() was queued");
+        }
+        while (wb.getMethodCompilationLevel(hotMethod) != C2_LEVEL) {
+            Thread.sleep(1);
+        }
+        int stillWaiting = 0;
+        for (Method m : cold) {
+            if (wb.isMethodQueuedForCompilation(m)) {
+                stillWaiting++;
+            }
+        }
+        System.out.println(stillWaiting + " cold methods still waiting when hot() was compiled");
+        if (stillWaiting == 0) {
+            throw new RuntimeException("hot() was not selected before the cold methods queued earlier");
+        }
+
+        // Queued tasks of methods that can no longer be compiled are removed
+        // as stale when they are re-rated.
+        List<Method> doomed = enqueue(wb, coldMethods(ConcurrentSkipListMap.class));
+        for (Method m : doomed) {
+            wb.makeMethodNotCompilable(m, C2_LEVEL);
+        }
+        for (int i = 0; i < 60000 && wb.getCompileQueueSize(C2_LEVEL) > 0; i++) {
+            Thread.sleep(1);
+        }
+        long stale = sum(perfCounters().getOutput(), "sun.ci.c2Queue.staleTasks");
+        System.out.println(doomed.size() + " tasks made not compilable, stale tasks: " + stale);
+        if (stale == 0) {
+            throw new RuntimeException("No stale tasks removed from the C2 queue");
+        }
+    }
+}
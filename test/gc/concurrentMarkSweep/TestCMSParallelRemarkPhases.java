@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+/*
+ * @test TestCMSParallelRemarkPhases
+ * @summary test the per-task timings of the parallel CMS initial mark and remark
+ * @library /testlibrary
+ * @build TestCMSParallelRemarkPhases
+ * @run main/othervm TestCMSParallelRemarkPhases
+ */
+
+import com.oracle.java.testlibrary.*;
+
+public class TestCMSParallelRemarkPhases {
+    public static void main(String[] args) throws Exception {
+        // chunks claimed largest first
+        testPhases("-XX:+CMSParallelRemarkLargestChunksFirst");
+        // chunks claimed in address order
+        testPhases("-XX:-CMSParallelRemarkLargestChunksFirst");
+        // class unloading and table scrubbing by the remark workers
+        OutputAnalyzer output = testPhases("-XX:+ParallelClassUnloading");
+        output.shouldContain("scrub string and symbol tables");
+    }
+
+    private static OutputAnalyzer testPhases(String flag) throws Exception {
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder("-Xmx200m",
+                "-Xmn50m",
+                "-XX:+UseConcMarkSweepGC",
+                "-XX:ParallelGCThreads=4",
+                "-XX:+CMSParallelInitialMarkEnabled",
+                "-XX:+CMSParallelRemarkEnabled",
+                "-XX:+ExplicitGCInvokesConcurrent",
+                "-XX:+PrintGCDetails",
+                "-XX:+PrintGCRootsTraceTime",
+                flag,
+                Foo.class.getName());
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldContain("Young Gen Rescan");
+        output.shouldContain("New CLD Scan");
+        output.shouldContain("Dirty Klass Scan");
+        output.shouldContain("Dirty Card Rescan");
+        output.shouldContain("Work Stealing");
+        output.shouldHaveExitValue(0);
+        return output;
+    }
+
+    static class Foo {
+        public static Object sink;
+
+        public static void main(String[] args) throws Exception {
+            for (int i = 0; i < 1024; i++) {
+                sink = new byte[16 * 1024];
+            }
+            System.gc();
+            // give the concurrent cycle time to reach the remark
+            Thread.sleep(2000);
+        }
+    }
+}
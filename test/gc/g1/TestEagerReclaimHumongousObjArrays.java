@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test TestEagerReclaimHumongousObjArrays
+ * @summary Dead humongous object arrays should be eagerly reclaimed at young GC while live ones stay intact
+ * @key gc
+ * @library /testlibrary
+ * @run main/othervm TestEagerReclaimHumongousObjArrays
+ */
+
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+import com.oracle.java.testlibrary.Asserts;
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.ProcessTools;
+
+public class TestEagerReclaimHumongousObjArrays {
+    public static void main(String[] args) throws Exception {
+        OutputAnalyzer output = runTest("-XX:+G1EagerReclaimHumongousObjArrays");
+        Asserts.assertLT(countFullGCs(output), 10, "Eager reclaim of humongous object arrays seems to not work at all");
+        output.shouldMatch("\\[Humongous Obj Array Reclaimed: [1-9]");
+
+        runTest("-XX:+G1EagerReclaimHumongousObjArrays", "-XX:+UnlockDiagnosticVMOptions",
+                "-XX:+VerifyAfterGC", "-XX:InitiatingHeapOccupancyPercent=1");
+
+        output = runTest("-XX:-G1EagerReclaimHumongousObjArrays");
+        output.shouldNotContain("Humongous Obj Array");
+    }
+
+    private static int countFullGCs(OutputAnalyzer output) {
+        int found = 0;
+        Matcher m = Pattern.compile("Full GC").matcher(output.getStdout());
+        while (m.find()) { found++; }
+        System.out.println("Issued " + found + " Full GCs");
+        return found;
+    }
+
+    private static OutputAnalyzer runTest(String... extraArgs) throws Exception {
+        String[] baseArgs = {
+            "-XX:+UseG1GC",
+            "-Xms128M",
+            "-Xmx128M",
+            "-Xmn16M",
+            "-XX:G1HeapRegionSize=1M",
+            "-XX:+PrintGCDetails",
+            "-XX:G1LogLevel=finest"
+        };
+        String[] allArgs = new String[baseArgs.length + extraArgs.length + 1];
+        System.arraycopy(baseArgs, 0, allArgs, 0, baseArgs.length);
+        System.arraycopy(extraArgs, 0, allArgs, baseArgs.length, extraArgs.length);
+        allArgs[allArgs.length - 1] = ObjArrayReclaimer.class.getName();
+
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(allArgs);
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+        output.shouldContain("ObjArrayReclaimer passed");
+        return output;
+    }
+
+    static class ObjArrayReclaimer {
+        static final int ELEMENTS = 2 * 1024 * 1024;
+
+        // A humongous object array that stays reachable from an old object
+        // and points to young objects.
+        static Object[] survivor = new Object[ELEMENTS];
+
+        public static void main(String[] args) {
+            for (int i = 0; i < 100; i++) {
+                // Large object arrays that die young, like the tables left
+                // behind by a hash map resize, each about 8M in size.
+                Object[] table = new Object[ELEMENTS];
+                for (int j = 0; j < table.length; j += 1024) {
+                    table[j] = new int[16];
+                }
+                survivor[i] = new Integer(i);
+                // Make sure that the compiler cannot completely remove
+                // the allocation of the large array until here.
+                if (table.hashCode() == 0) {
+                    System.out.println(table);
+                }
+            }
+            for (int i = 0; i < 100; i++) {
+                if (((Integer) survivor[i]).intValue() != i) {
+                    throw new RuntimeException("Element " + i + " of the live array changed");
+                }
+            }
+            System.out.println("ObjArrayReclaimer passed");
+        }
+    }
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test TestG1NUMA
+ * @summary G1 with UseNUMA should keep node local alloc regions and report per-node usage
+ * @library /testlibrary
+ * @run main/othervm TestG1NUMA
+ */
+
+import com.oracle.java.testlibrary.*;
+
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+public class TestG1NUMA {
+    public static void main(String[] args) throws Exception {
+        runTest(128, "-XX:G1HeapRegionSize=1m");
+        // Regions smaller than a large page share their node with the page.
+        runTest(128, "-XX:G1HeapRegionSize=1m", "-XX:+UseLargePages");
+        runTest(32, "-XX:G1HeapRegionSize=4m", "-XX:+ParallelRefProcEnabled");
+    }
+
+    private static void runTest(int heapRegions, String... extraArgs) throws Exception {
+        String[] baseArgs = {
+            "-XX:+UseG1GC",
+            "-XX:+UseNUMA",
+            // Keep UseNUMA on single node machines, where the statistics
+            // are printed for the one node.
+            "-XX:+ForceNUMA",
+            "-Xms128m",
+            "-Xmx128m",
+            "-XX:+PrintGCDetails",
+            "-XX:+UnlockDiagnosticVMOptions",
+            "-XX:+VerifyBeforeGC",
+            "-XX:+VerifyAfterGC"
+        };
+        String[] allArgs = new String[baseArgs.length + extraArgs.length + 1];
+        System.arraycopy(baseArgs, 0, allArgs, 0, baseArgs.length);
+        System.arraycopy(extraArgs, 0, allArgs, baseArgs.length, extraArgs.length);
+        allArgs[allArgs.length - 1] = Allocator.class.getName();
+
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(allArgs);
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+        output.shouldContain("GC pause (G1 Evacuation Pause) (young)");
+        checkStatistics(output.getStdout().split("\n"), heapRegions);
+    }
+
+    // Every committed region has to be tagged with exactly one node, and
+    // with a single node all region allocations have to be local.
+    private static void checkStatistics(String[] lines, int heapRegions) {
+        Pattern nodesPattern = Pattern.compile("\\[NUMA Nodes: (\\d+)\\]");
+        Pattern nodePattern = Pattern.compile("\\[Node (\\d+) \\(id -?\\d+\\): Eden: (\\d+) Survivor: (\\d+) Old: (\\d+) Humongous: (\\d+) Free: (\\d+) regions, Local Region Allocs: (\\d+)/(\\d+)");
+        int reports = 0;
+        long regionAllocs = 0;
+        int nodes = 0;
+        for (int i = 0; i < lines.length; i++) {
+            Matcher m = nodesPattern.matcher(lines[i]);
+            if (!m.find()) {
+                continue;
+            }
+            nodes = Integer.parseInt(m.group(1));
+            if (nodes < 1) {
+                throw new RuntimeException("No NUMA nodes: " + lines[i]);
+            }
+            int regions = 0;
+            for (int node = 0; node < nodes; node++) {
+                Matcher n = nodePattern.matcher(lines[i + 1 + node]);
+                if (!n.find() || Integer.parseInt(n.group(1)) != node) {
+                    throw new RuntimeException("Missing statistics of node " + node + ": " + lines[i + 1 + node]);
+                }
+                for (int group = 2; group <= 6; group++) {
+                    regions += Integer.parseInt(n.group(group));
+                }
+                long local = Long.parseLong(n.group(7));
+                long total = Long.parseLong(n.group(8));
+                if (nodes == 1 && local != total) {
+                    throw new RuntimeException("Remote region allocation on a single node: " + lines[i + 1 + node]);
+                }
+                regionAllocs += total;
+            }
+            if (regions != heapRegions) {
+                throw new RuntimeException(regions + " regions tagged with a node, expected " + heapRegions);
+            }
+            reports++;
+        }
+        if (reports == 0) {
+            throw new RuntimeException("No NUMA statistics printed");
+        }
+        if (regionAllocs == 0) {
+            throw new RuntimeException("No region allocations counted");
+        }
+        System.out.println(reports + " NUMA reports for " + nodes + " node(s) checked");
+    }
+
+    static class Allocator {
+        private static Object[] keep = new Object[1024];
+
+        public static void main(String[] args) throws Exception {
+            Thread[] threads = new Thread[4];
+            for (int t = 0; t < threads.length; t++) {
+                final int id = t;
+                threads[t] = new Thread() {
+                    public void run() {
+                        for (int i = 0; i < 200000; i++) {
+                            Object o = new byte[1024];
+                            if (i % 64 == 0) {
+                                keep[(id * 256 + i / 64) % keep.length] = o;
+                            }
+                        }
+                    }
+                };
+                threads[t].start();
+            }
+            for (Thread thread : threads) {
+                thread.join();
+            }
+            System.gc();
+        }
+    }
+}
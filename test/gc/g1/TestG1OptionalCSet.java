@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test TestG1OptionalCSet
+ * @summary Mixed collections with an optional collection set should keep all reachable objects intact
+ * @library /testlibrary
+ * @run main/othervm TestG1OptionalCSet
+ */
+
+import com.oracle.java.testlibrary.*;
+
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+public class TestG1OptionalCSet {
+    public static void main(String[] args) throws Exception {
+        runTest("-XX:ParallelGCThreads=4", "-XX:G1OptionalCSetPercent=50");
+        runTest("-XX:ParallelGCThreads=1", "-XX:G1OptionalCSetPercent=90");
+        runTest("-XX:ParallelGCThreads=4", "-XX:G1OptionalCSetPercent=20", "-XX:-UseCompressedOops");
+    }
+
+    private static void runTest(String... extraArgs) throws Exception {
+        String[] baseArgs = {
+            "-XX:+UseG1GC",
+            "-XX:+G1UseOptionalCSet",
+            "-Xms64m",
+            "-Xmx64m",
+            "-Xmn8m",
+            "-XX:G1HeapRegionSize=1m",
+            "-XX:MaxGCPauseMillis=2",
+            "-XX:InitiatingHeapOccupancyPercent=10",
+            "-XX:+UnlockExperimentalVMOptions",
+            "-XX:G1MixedGCLiveThresholdPercent=100",
+            "-XX:G1HeapWastePercent=0",
+            "-XX:G1LogLevel=finest",
+            "-XX:+PrintGCDetails",
+            "-XX:+UnlockDiagnosticVMOptions",
+            "-XX:+VerifyAfterGC"
+        };
+        String[] allArgs = new String[baseArgs.length + extraArgs.length + 1];
+        System.arraycopy(baseArgs, 0, allArgs, 0, baseArgs.length);
+        System.arraycopy(extraArgs, 0, allArgs, baseArgs.length, extraArgs.length);
+        allArgs[allArgs.length - 1] = Mutator.class.getName();
+
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(allArgs);
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+        output.shouldContain("(mixed)");
+        output.shouldContain("[Optional Evacuation:");
+        output.shouldContain("Mutator passed");
+
+        // At least one pause has to evacuate regions of the optional collection set.
+        Matcher m = Pattern.compile("\\[Regions Evacuated: (\\d+)\\]").matcher(output.getStdout());
+        long evacuated = 0;
+        while (m.find()) {
+            evacuated += Long.parseLong(m.group(1));
+        }
+        if (evacuated == 0) {
+            throw new RuntimeException("No optional collection set region was evacuated");
+        }
+    }
+
+    static class Node {
+        Node next;
+        Object payload;
+        final int value;
+
+        Node(int value) {
+            this.value = value;
+        }
+    }
+
+    static class Mutator {
+        private static final int SLOTS = 40000;
+
+        public static void main(String[] args) throws Exception {
+            // A long-lived table whose entries are replaced over time leaves
+            // the old generation fragmented, so that many old regions become
+            // mixed collection candidates with references between them.
+            Node[] table = new Node[SLOTS];
+            for (int i = 0; i < SLOTS; i++) {
+                table[i] = new Node(i);
+                table[i].payload = new byte[256];
+            }
+            for (int round = 0; round < 30; round++) {
+                for (int i = round % 3; i < SLOTS; i += 3) {
+                    Node n = new Node(i);
+                    Node old = table[(i * 31 + round) % SLOTS];
+                    old.next = null;
+                    n.next = old;
+                    n.payload = new byte[256 + (i % 5) * 64];
+                    table[i] = n;
+                }
+                check(table);
+            }
+            System.out.println("Mutator passed");
+        }
+
+        private static void check(Node[] table) {
+            for (int i = 0; i < SLOTS; i++) {
+                Node n = table[i];
+                if (n.value != i) {
+                    throw new RuntimeException("Slot " + i + " holds node " + n.value);
+                }
+                if (((byte[]) n.payload).length < 256) {
+                    throw new RuntimeException("Payload of slot " + i + " corrupted");
+                }
+            }
+        }
+    }
+}
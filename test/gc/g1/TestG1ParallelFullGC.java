@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test TestG1ParallelFullGC
+ * @summary The G1 parallel full GC should keep all reachable objects, their identity hash codes and the referents of strong references intact
+ * @library /testlibrary
+ * @run main/othervm TestG1ParallelFullGC
+ */
+
+import com.oracle.java.testlibrary.*;
+
+import java.lang.ref.WeakReference;
+import java.util.ArrayList;
+import java.util.List;
+
+public class TestG1ParallelFullGC {
+    public static void main(String[] args) throws Exception {
+        runTest("-XX:ParallelGCThreads=4");
+        runTest("-XX:ParallelGCThreads=2", "-XX:+UseStringDeduplication");
+        runTest("-XX:ParallelGCThreads=4", "-XX:-UseCompressedOops", "-XX:-ClassUnloading");
+
+        OutputAnalyzer output = runTest("-XX:ParallelGCThreads=2", "-XX:+VerifyDuringGC");
+        output.shouldContain("VerifyDuringGC is ignored by the G1 full GC with -XX:+G1ParallelFullGC");
+    }
+
+    private static OutputAnalyzer runTest(String... extraArgs) throws Exception {
+        String[] baseArgs = {
+            "-XX:+UseG1GC",
+            "-XX:+G1ParallelFullGC",
+            "-Xms64m",
+            "-Xmx64m",
+            "-XX:G1HeapRegionSize=1m",
+            "-XX:+PrintGCDetails",
+            "-XX:+UnlockDiagnosticVMOptions",
+            "-XX:+VerifyBeforeGC",
+            "-XX:+VerifyAfterGC"
+        };
+        String[] allArgs = new String[baseArgs.length + extraArgs.length + 1];
+        System.arraycopy(baseArgs, 0, allArgs, 0, baseArgs.length);
+        System.arraycopy(extraArgs, 0, allArgs, baseArgs.length, extraArgs.length);
+        allArgs[allArgs.length - 1] = Collector.class.getName();
+
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(allArgs);
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+        output.shouldContain("[Full GC (System.gc())");
+        output.shouldMatch("\\[Parallel Time: \\d+\\.\\d ms, GC Workers: \\d+\\]");
+        output.shouldContain("[Mark (ms):");
+        output.shouldContain("[Prepare Compaction (ms):");
+        output.shouldContain("[Adjust Pointers (ms):");
+        output.shouldContain("[Compact (ms):");
+        output.shouldContain("Collector passed");
+        return output;
+    }
+
+    static class Node {
+        Node next;
+        Object[] payload;
+        final int value;
+
+        Node(int value) {
+            this.value = value;
+        }
+    }
+
+    static class Collector {
+        public static void main(String[] args) throws Exception {
+            Node head = null;
+            List<Integer> hashes = new ArrayList<Integer>();
+            List<WeakReference<Object>> weak = new ArrayList<WeakReference<Object>>();
+            Object[] large = new Object[300000];
+            byte[] humongous = null;
+
+            for (int i = 0; i < 20000; i++) {
+                // Interleave garbage with live objects so that the live
+                // objects have to move during the compaction.
+                new byte[512].hashCode();
+                Node n = new Node(i);
+                n.next = head;
+                head = n;
+                hashes.add(System.identityHashCode(n));
+                if (i % 100 == 0) {
+                    n.payload = new Object[] { "node" + i, new int[i % 7] };
+                    weak.add(new WeakReference<Object>(new Object()));
+                }
+                large[i * 15] = n;
+                if (i % 5000 == 0) {
+                    humongous = new byte[2 * 1024 * 1024];
+                    humongous[i % humongous.length] = (byte)i;
+                }
+            }
+
+            for (int gc = 0; gc < 3; gc++) {
+                System.gc();
+                check(head, hashes, large);
+            }
+            for (WeakReference<Object> ref : weak) {
+                if (ref.get() != null) {
+                    throw new RuntimeException("Weakly reachable object was not cleared");
+                }
+            }
+            if (humongous[15000 % humongous.length] != (byte)15000) {
+                throw new RuntimeException("Humongous array changed");
+            }
+            System.out.println("Collector passed");
+        }
+
+        private static void check(Node head, List<Integer> hashes, Object[] large) {
+            int expected = hashes.size() - 1;
+            for (Node n = head; n != null; n = n.next, expected--) {
+                if (n.value != expected) {
+                    throw new RuntimeException("Lost node " + expected + ", found " + n.value);
+                }
+                if (System.identityHashCode(n) != hashes.get(expected)) {
+                    throw new RuntimeException("Identity hash of node " + expected + " changed");
+                }
+                if (large[expected * 15] != n) {
+                    throw new RuntimeException("Array element " + (expected * 15) + " not updated");
+                }
+                if (expected % 100 == 0 && !("node" + expected).equals(n.payload[0])) {
+                    throw new RuntimeException("Payload of node " + expected + " changed");
+                }
+            }
+            if (expected != -1) {
+                throw new RuntimeException("Node list ended at " + expected);
+            }
+        }
+    }
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test TestG1PeriodicGC
+ * @summary An idle G1 heap should start periodic concurrent cycles and uncommit free regions at remark
+ * @library /testlibrary
+ * @run main/othervm TestG1PeriodicGC
+ */
+
+import com.oracle.java.testlibrary.*;
+
+import java.lang.management.ManagementFactory;
+
+public class TestG1PeriodicGC {
+    private static final double LOAD_THRESHOLD = 0.00001;
+
+    public static void main(String[] args) throws Exception {
+        OutputAnalyzer output = runTest("-XX:G1PeriodicGCInterval=200");
+        output.shouldContain("(G1 Periodic Collection) (young) (initial-mark)");
+        output.shouldContain("request periodic collection");
+        output.shouldContain("max desired capacity after remark");
+        output.shouldContain("Heap shrunk");
+
+        // A load threshold below the current load suppresses periodic GCs.
+        // The VM reads the same load average as the management bean.
+        double load = ManagementFactory.getOperatingSystemMXBean().getSystemLoadAverage();
+        if (load < 0) {
+            System.out.println("Skipping the load threshold case, the system load average is not available");
+        } else if (load <= LOAD_THRESHOLD) {
+            System.out.println("Skipping the load threshold case, the system load " + load + " is too low");
+        } else {
+            output = runTest("-XX:G1PeriodicGCInterval=200",
+                             "-XX:G1PeriodicGCSystemLoadThreshold=" + LOAD_THRESHOLD);
+            output.shouldContain("system load above threshold");
+            output.shouldNotContain("(G1 Periodic Collection)");
+        }
+
+        output = runTest("-XX:G1PeriodicGCInterval=0");
+        output.shouldNotContain("G1 Periodic Collection");
+    }
+
+    private static OutputAnalyzer runTest(String... extraArgs) throws Exception {
+        String[] baseArgs = {
+            "-XX:+UseG1GC",
+            "-XX:InitialHeapSize=128m",
+            "-Xmx256m",
+            "-XX:G1HeapRegionSize=1m",
+            "-XX:MinHeapFreeRatio=10",
+            "-XX:MaxHeapFreeRatio=30",
+            "-XX:+PrintGCDetails",
+            "-XX:+PrintAdaptiveSizePolicy"
+        };
+        String[] allArgs = new String[baseArgs.length + extraArgs.length + 1];
+        System.arraycopy(baseArgs, 0, allArgs, 0, baseArgs.length);
+        System.arraycopy(extraArgs, 0, allArgs, baseArgs.length, extraArgs.length);
+        allArgs[allArgs.length - 1] = IdleApp.class.getName();
+
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(allArgs);
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+        return output;
+    }
+
+    static class IdleApp {
+        public static void main(String[] args) throws Exception {
+            long committedBefore = Runtime.getRuntime().totalMemory();
+            // Stay idle for several periodic GC intervals.
+            Thread.sleep(3000);
+            long committedAfter = Runtime.getRuntime().totalMemory();
+            if (committedAfter < committedBefore) {
+                System.out.println("Heap shrunk from " + committedBefore + " to " + committedAfter + " bytes");
+            }
+        }
+    }
+}
@@ -69,6 +69,10 @@ public class TestGCLogMessages {
         new LogMessageWithLevel("CM RefProcessor Roots", Level.FINEST),
         new LogMessageWithLevel("Wait For Strong CLD", Level.FINEST),
         new LogMessageWithLevel("Weak CLD Roots", Level.FINEST),
+        // Scan RS
+        new LogMessageWithLevel("Scanned Cards", Level.FINER),
+        new LogMessageWithLevel("Claimed Cards", Level.FINEST),
+        new LogMessageWithLevel("Skipped Cards", Level.FINEST),
         // Redirty Cards
         new LogMessageWithLevel("Redirty Cards", Level.FINER),
         new LogMessageWithLevel("Parallel Redirty", Level.FINEST),
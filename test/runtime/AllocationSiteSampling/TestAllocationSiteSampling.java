@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test TestAllocationSiteSampling
+ * @key jcmd
+ * @summary GC.allocation_sites accounts sampled allocations to the allocating bytecode
+ * @library /testlibrary
+ * @run main/othervm -Xint -XX:AllocationSiteSamplingInterval=16384 TestAllocationSiteSampling
+ * @run main/othervm -XX:TieredStopAtLevel=1 -XX:AllocationSiteSamplingInterval=16384 TestAllocationSiteSampling
+ * @run main/othervm -XX:-TieredCompilation -XX:AllocationSiteSamplingInterval=16384 TestAllocationSiteSampling
+ * @run main/othervm TestAllocationSiteSampling disabled
+ */
+
+import com.oracle.java.testlibrary.JDKToolFinder;
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.ProcessTools;
+
+public class TestAllocationSiteSampling {
+    static volatile Object sink;
+
+    static OutputAnalyzer jcmd(String... args) throws Exception {
+        String pid = Integer.toString(ProcessTools.getProcessId());
+        String[] command = new String[args.length + 3];
+        command[0] = JDKToolFinder.getJDKTool("jcmd");
+        command[1] = pid;
+        command[2] = "GC.allocation_sites";
+        System.arraycopy(args, 0, command, 3, args.length);
+        OutputAnalyzer output = new OutputAnalyzer(new ProcessBuilder(command).start());
+        System.out.println(output.getOutput());
+        output.shouldHaveExitValue(0);
+        return output;
+    }
+
+    static void allocateArrays() {
+        for (int i = 0; i < 1000; i++) {
+            sink = new byte[1024];
+        }
+    }
+
+    static void allocateObjects() {
+        for (int i = 0; i < 10000; i++) {
+            sink = new StringBuilder();
+        }
+    }
+
+    public static void main(String[] args) throws Exception {
+        if (args.length > 0 && args[0].equals("disabled")) {
+            jcmd().shouldContain("Allocation site sampling is not enabled");
+            return;
+        }
+
+        // About 100M of arrays and 50M of builders, so that both sites get
+        // a good number of samples
+        for (int i = 0; i < 100; i++) {
+            allocateArrays();
+        }
+        for (int i = 0; i < 200; i++) {
+            allocateObjects();
+        }
+
+        OutputAnalyzer output = jcmd("top=0");
+        output.shouldMatch("Allocation sites sampled every 16384 bytes: \\d+ sites");
+        output.shouldMatch("\\d+ +\\d+  TestAllocationSiteSampling.allocateArrays\\(\\)V @ \\d+ newarray byte");
+        output.shouldMatch("\\d+ +\\d+  TestAllocationSiteSampling.allocateObjects\\(\\)V @ \\d+ new java.lang.StringBuilder");
+
+        output = jcmd("top=1", "-reset");
+        output.shouldContain("TestAllocationSiteSampling.allocateArrays()V");
+        output.shouldNotContain("TestAllocationSiteSampling.allocateObjects()V");
+
+        output = jcmd();
+        output.shouldNotContain("TestAllocationSiteSampling.allocateArrays()V");
+
+        output = jcmd("top=-1");
+        output.shouldContain("Invalid number of sites: -1");
+    }
+}
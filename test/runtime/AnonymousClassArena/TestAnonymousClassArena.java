@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test TestAnonymousClassArena
+ * @summary Anonymous classes of a host share arenas that are unloaded with their classes
+ * @library /testlibrary
+ * @run main TestAnonymousClassArena
+ */
+
+import java.io.ByteArrayOutputStream;
+import java.io.InputStream;
+import java.lang.ref.WeakReference;
+import java.lang.reflect.Field;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.ProcessTools;
+
+import sun.misc.Unsafe;
+
+public class TestAnonymousClassArena {
+    static final int CLASSES = 200;
+
+    static int countArenas(String gc, String arena) throws Exception {
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            gc,
+            arena,
+            "-XX:+TraceClassLoaderData",
+            "TestAnonymousClassArena$Worker");
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+        output.shouldContain("all anonymous classes unloaded");
+        Matcher m = Pattern.compile("create anonymous class arena").matcher(output.getStdout());
+        int arenas = 0;
+        while (m.find()) {
+            arenas++;
+        }
+        return arenas;
+    }
+
+    public static void main(String[] args) throws Exception {
+        for (String gc : new String[] { "-XX:+UseSerialGC", "-XX:+UseG1GC", "-XX:+UseConcMarkSweepGC" }) {
+            int arenas = countArenas(gc, "-XX:+UseAnonymousClassArena");
+            if (arenas == 0 || arenas >= CLASSES / 2) {
+                throw new RuntimeException(gc + ": " + arenas + " arenas for " + CLASSES + " classes");
+            }
+            if (countArenas(gc, "-XX:-UseAnonymousClassArena") != 0) {
+                throw new RuntimeException(gc + ": arenas created although disabled");
+            }
+        }
+    }
+
+    public static class Payload {
+        public int value() {
+            return 42;
+        }
+    }
+
+    public static class Worker {
+        public static void main(String[] args) throws Exception {
+            Field f = Unsafe.class.getDeclaredField("theUnsafe");
+            f.setAccessible(true);
+            Unsafe unsafe = (Unsafe) f.get(null);
+
+            InputStream in = Worker.class.getResourceAsStream("TestAnonymousClassArena$Payload.class");
+            ByteArrayOutputStream bytes = new ByteArrayOutputStream();
+            byte[] buf = new byte[4096];
+            for (int n; (n = in.read(buf)) > 0; ) {
+                bytes.write(buf, 0, n);
+            }
+            in.close();
+
+            List<WeakReference<Class<?>>> refs = new ArrayList<>();
+            for (int i = 0; i < CLASSES; i++) {
+                Class<?> c = unsafe.defineAnonymousClass(Worker.class, bytes.toByteArray(), null);
+                c.newInstance();
+                refs.add(new WeakReference<Class<?>>(c));
+            }
+
+            for (int i = 0; i < 10; i++) {
+                System.gc();
+                boolean unloaded = true;
+                for (WeakReference<Class<?>> ref : refs) {
+                    unloaded &= ref.get() == null;
+                }
+                if (unloaded) {
+                    System.out.println("all anonymous classes unloaded");
+                    return;
+                }
+                Thread.sleep(100);
+            }
+            throw new RuntimeException("anonymous classes are still alive");
+        }
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test TestClassPreloadList
+ * @summary Preload the classes of -XX:ClassPreloadList on a thread pool at startup
+ * @library /testlibrary
+ * @run main TestClassPreloadList
+ */
+
+import java.io.File;
+import java.io.PrintWriter;
+
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.ProcessTools;
+
+public class TestClassPreloadList {
+    public static void main(String[] args) throws Exception {
+        File list = new File("preload.classlist");
+        PrintWriter out = new PrintWriter(list);
+        out.println("# boot classes, in both name forms");
+        out.println("java/util/concurrent/ConcurrentSkipListMap");
+        out.println("java.util.zip.Deflater");
+        out.println("");
+        out.println("# a class of the system class loader");
+        out.println("TestClassPreloadList$Preloaded");
+        out.println("does/not/Exist");
+        out.close();
+
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            "-XX:ClassPreloadList=" + list.getAbsolutePath(),
+            "-XX:ClassPreloadThreads=2",
+            "-XX:+PrintClassPreloadStatistics",
+            "-cp", System.getProperty("test.classes"),
+            "TestClassPreloadList$Preloaded");
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+        output.shouldContain("Class preloading: 3 classes loaded, 1 not found");
+        output.shouldContain("Preloaded ran");
+
+        // A missing list does not stop the VM
+        pb = ProcessTools.createJavaProcessBuilder(
+            "-XX:ClassPreloadList=does-not-exist.classlist",
+            "-version");
+        output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+        output.shouldContain("Cannot read ClassPreloadList");
+    }
+
+    public static class Preloaded {
+        public static void main(String[] args) throws Exception {
+            // Give the preload threads time to finish before the VM exits
+            Thread.sleep(2000);
+            System.out.println("Preloaded ran");
+        }
+    }
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test TestG1ConcurrentUnloadingCleanup
+ * @summary G1 remark leaves the inline caches of unloaded classes to the sweeper,
+ *          and the metaspace of the dead loaders is only freed after that
+ * @library /testlibrary
+ * @run main TestG1ConcurrentUnloadingCleanup
+ */
+
+import java.io.ByteArrayOutputStream;
+import java.io.InputStream;
+import java.lang.management.ManagementFactory;
+import java.lang.management.MemoryPoolMXBean;
+import java.lang.ref.WeakReference;
+import java.util.ArrayList;
+import java.util.List;
+
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.ProcessTools;
+
+public class TestG1ConcurrentUnloadingCleanup {
+    static final int LOADERS = 200;
+
+    public static void main(String[] args) throws Exception {
+        String[][] configs = {
+            { },
+            { "-XX:TieredStopAtLevel=1" },
+            { "-XX:+ConcurrentClassLoaderDataFree" },
+        };
+        for (String[] config : configs) {
+            OutputAnalyzer output = runWorker(config);
+            output.shouldContain("all loaders unloaded");
+            output.shouldContain("[Deferring inline cache cleaning of unloaded classes to sweep");
+            output.shouldMatch("\\[Sweep \\d+ cleaned [1-9]\\d* inline caches of unloaded classes\\]");
+            output.shouldContain("metaspace freed");
+        }
+
+        // A full GC between the remark that deferred the inline cache
+        // cleaning and the sweep must not look at the dead classes through
+        // the stale inline caches. Concurrent cycles are started by young
+        // GCs, System.gc() does a full GC. The sweeper may still win the
+        // race against the full GC, then the run is repeated.
+        String[] fullGC = {
+            "-XX:-ExplicitGCInvokesConcurrent",
+            "-XX:InitiatingHeapOccupancyPercent=0",
+            "-XX:+PrintGC",
+        };
+        for (int attempt = 0; ; attempt++) {
+            OutputAnalyzer output = runWorker(fullGC, "young");
+            output.shouldContain("all loaders unloaded");
+            output.shouldContain("metaspace freed");
+            String stdout = output.getStdout();
+            int full = stdout.indexOf("[Full GC (System.gc())");
+            if (full < 0) {
+                throw new RuntimeException("no full GC");
+            }
+            int deferred = stdout.lastIndexOf("[Deferring inline cache cleaning", full);
+            int swept = stdout.lastIndexOf("[Sweep ", full);
+            if (deferred >= 0 && swept < deferred) {
+                break;
+            }
+            if (attempt == 2) {
+                throw new RuntimeException("the sweeper always finished before the full GC");
+            }
+            System.out.println("The sweeper finished before the full GC, retrying");
+        }
+    }
+
+    private static OutputAnalyzer runWorker(String[] config, String... workerArgs) throws Exception {
+        List<String> vmArgs = new ArrayList<>();
+        vmArgs.add("-XX:+UseG1GC");
+        vmArgs.add("-XX:+ExplicitGCInvokesConcurrent");
+        vmArgs.add("-XX:+G1ConcurrentUnloadingCleanup");
+        vmArgs.add("-XX:+TraceClassUnloading");
+        // Compile drive() before the loop ends.
+        vmArgs.add("-Xbatch");
+        for (String arg : config) {
+            vmArgs.add(arg);
+        }
+        vmArgs.add("TestG1ConcurrentUnloadingCleanup$Worker");
+        for (String arg : workerArgs) {
+            vmArgs.add(arg);
+        }
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(vmArgs.toArray(new String[0]));
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+        return output;
+    }
+
+    public static class Payload implements Runnable {
+        int count;
+
+        public void run() {
+            count++;
+        }
+    }
+
+    static class PayloadLoader extends ClassLoader {
+        final Class<?> payload;
+
+        PayloadLoader(byte[] bytes) {
+            super(null);
+            payload = defineClass(Payload.class.getName(), bytes, 0, bytes.length);
+            resolveClass(payload);
+        }
+    }
+
+    public static class Worker {
+        static int calls;
+        static byte[] garbage;
+
+        // Compiled with an inline cache that refers to the payload class of
+        // the first loader. It only ever sees that class, so the inline cache
+        // stays monomorphic until the sweeper cleans it.
+        static void drive(Runnable r) {
+            r.run();
+            calls++;
+        }
+
+        static MemoryPoolMXBean metaspace() {
+            for (MemoryPoolMXBean pool : ManagementFactory.getMemoryPoolMXBeans()) {
+                if (pool.getName().equals("Metaspace")) {
+                    return pool;
+                }
+            }
+            throw new RuntimeException("no Metaspace pool");
+        }
+
+        public static void main(String[] args) throws Exception {
+            InputStream in = Worker.class.getResourceAsStream("TestG1ConcurrentUnloadingCleanup$Payload.class");
+            ByteArrayOutputStream bytes = new ByteArrayOutputStream();
+            byte[] buf = new byte[4096];
+            for (int n; (n = in.read(buf)) > 0; ) {
+                bytes.write(buf, 0, n);
+            }
+            in.close();
+
+            MemoryPoolMXBean pool = metaspace();
+            List<WeakReference<ClassLoader>> refs = new ArrayList<>();
+            for (int i = 0; i < LOADERS; i++) {
+                PayloadLoader loader = new PayloadLoader(bytes.toByteArray());
+                Runnable r = (Runnable)loader.payload.newInstance();
+                if (i == 0) {
+                    for (int j = 0; j < 2000; j++) {
+                        drive(r);
+                    }
+                }
+                refs.add(new WeakReference<ClassLoader>(loader));
+            }
+            long loaded = pool.getUsage().getUsed();
+
+            // With "young" the concurrent cycles are started by young GCs,
+            // and System.gc() below is a full GC.
+            boolean young = args.length > 0 && args[0].equals("young");
+            boolean unloaded = false;
+            for (int i = 0; i < 20 && !unloaded; i++) {
+                if (young) {
+                    for (int j = 0; j < 64; j++) {
+                        garbage = new byte[1024 * 1024];
+                    }
+                } else {
+                    System.gc();
+                }
+                Thread.sleep(100);
+                unloaded = true;
+                for (WeakReference<ClassLoader> ref : refs) {
+                    unloaded &= ref.get() == null;
+                }
+            }
+            if (!unloaded) {
+                throw new RuntimeException("class loaders are still alive");
+            }
+            System.out.println("all loaders unloaded");
+
+            // drive() is not called again, a call with another receiver
+            // would replace the stale inline cache before the sweeper sees it.
+            for (int i = 0; i < 60; i++) {
+                System.gc();
+                Thread.sleep(1000);
+                if (pool.getUsage().getUsed() < loaded) {
+                    System.out.println("metaspace freed");
+                    return;
+                }
+            }
+            throw new RuntimeException("metaspace of unloaded loaders is still in use: " + loaded);
+        }
+    }
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test TestParallelClassUnloading
+ * @summary Classes are unloaded with parallel CLD liveness and klass cleaning, and
+ *          the metaspace of dead loaders is freed by the service thread
+ * @library /testlibrary
+ * @run main TestParallelClassUnloading
+ */
+
+import java.io.ByteArrayOutputStream;
+import java.io.InputStream;
+import java.lang.management.ManagementFactory;
+import java.lang.management.MemoryPoolMXBean;
+import java.lang.ref.WeakReference;
+import java.util.ArrayList;
+import java.util.List;
+
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.ProcessTools;
+
+public class TestParallelClassUnloading {
+    static final int LOADERS = 500;
+
+    public static void main(String[] args) throws Exception {
+        String[][] gcs = {
+            { "-XX:+UseSerialGC" },
+            { "-XX:+UseParallelGC" },
+            { "-XX:+UseG1GC" },
+            { "-XX:+UseG1GC", "-XX:+ExplicitGCInvokesConcurrent" },
+            { "-XX:+UseConcMarkSweepGC" },
+            { "-XX:+UseConcMarkSweepGC", "-XX:+ExplicitGCInvokesConcurrent" },
+        };
+        for (String[] gc : gcs) {
+            List<String> vmArgs = new ArrayList<>();
+            for (String arg : gc) {
+                vmArgs.add(arg);
+            }
+            vmArgs.add("-XX:ParallelGCThreads=4");
+            vmArgs.add("-XX:+ParallelClassUnloading");
+            vmArgs.add("-XX:+ConcurrentClassLoaderDataFree");
+            vmArgs.add("TestParallelClassUnloading$Worker");
+            ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(vmArgs.toArray(new String[0]));
+            OutputAnalyzer output = new OutputAnalyzer(pb.start());
+            output.shouldHaveExitValue(0);
+            output.shouldContain("all loaders unloaded");
+            output.shouldContain("metaspace freed");
+        }
+    }
+
+    public static class Payload {
+        public int value() {
+            return 42;
+        }
+    }
+
+    static class PayloadLoader extends ClassLoader {
+        PayloadLoader(byte[] bytes) {
+            super(null);
+            Class<?> c = defineClass(Payload.class.getName(), bytes, 0, bytes.length);
+            resolveClass(c);
+        }
+    }
+
+    public static class Worker {
+        static MemoryPoolMXBean metaspace() {
+            for (MemoryPoolMXBean pool : ManagementFactory.getMemoryPoolMXBeans()) {
+                if (pool.getName().equals("Metaspace")) {
+                    return pool;
+                }
+            }
+            throw new RuntimeException("no Metaspace pool");
+        }
+
+        public static void main(String[] args) throws Exception {
+            InputStream in = Worker.class.getResourceAsStream("TestParallelClassUnloading$Payload.class");
+            ByteArrayOutputStream bytes = new ByteArrayOutputStream();
+            byte[] buf = new byte[4096];
+            for (int n; (n = in.read(buf)) > 0; ) {
+                bytes.write(buf, 0, n);
+            }
+            in.close();
+
+            MemoryPoolMXBean pool = metaspace();
+            List<WeakReference<ClassLoader>> refs = new ArrayList<>();
+            for (int i = 0; i < LOADERS; i++) {
+                refs.add(new WeakReference<ClassLoader>(new PayloadLoader(bytes.toByteArray())));
+            }
+            long loaded = pool.getUsage().getUsed();
+
+            boolean unloaded = false;
+            for (int i = 0; i < 20 && !unloaded; i++) {
+                System.gc();
+                Thread.sleep(100);
+                unloaded = true;
+                for (WeakReference<ClassLoader> ref : refs) {
+                    unloaded &= ref.get() == null;
+                }
+            }
+            if (!unloaded) {
+                throw new RuntimeException("class loaders are still alive");
+            }
+            System.out.println("all loaders unloaded");
+
+            // Dead loaders are purged by a GC and then freed by the service thread.
+            for (int i = 0; i < 20; i++) {
+                System.gc();
+                Thread.sleep(100);
+                if (pool.getUsage().getUsed() < loaded) {
+                    System.out.println("metaspace freed");
+                    return;
+                }
+            }
+            throw new RuntimeException("metaspace of unloaded loaders is still in use: " + loaded);
+        }
+    }
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.ProcessTools;
+
+/*
+ * @test
+ * @summary -XX:+CompactStrings is ignored with a warning when java.lang.String
+ *          has no coder field, and Strings keep working
+ * @library /testlibrary
+ * @run main TestCompactStringsFlag
+ */
+public class TestCompactStringsFlag {
+
+    public static void main(String[] args) throws Exception {
+        if (args.length > 0) {
+            String s = "compact" + args.length;
+            if (!s.equals("compact1") || s.hashCode() != "compact1".hashCode()) {
+                throw new RuntimeException("unexpected string " + s);
+            }
+            System.out.println(s.intern());
+            return;
+        }
+
+        boolean hasCoder = true;
+        try {
+            String.class.getDeclaredField("coder");
+        } catch (NoSuchFieldException e) {
+            hasCoder = false;
+        }
+
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            "-XX:+CompactStrings", TestCompactStringsFlag.class.getName(), "child");
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+        output.shouldContain("compact1");
+        if (hasCoder) {
+            output.shouldNotContain("CompactStrings is ignored");
+        } else {
+            output.shouldContain("CompactStrings is ignored");
+        }
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test TestMetaspaceChunkMerging
+ * @summary Free metaspace chunks of unloaded class loaders are merged, reported and uncommitted
+ * @library /testlibrary /runtime/testlibrary
+ * @build GeneratedClassLoader
+ * @run main TestMetaspaceChunkMerging
+ */
+
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.ProcessTools;
+
+public class TestMetaspaceChunkMerging {
+    static final String FREE_CHUNKS =
+        "free chunks    specialized \\d+ \\(\\d+KB\\), small \\d+ \\(\\d+KB\\), " +
+        "medium \\d+ \\(\\d+KB, (\\d+)KB uncommitted\\), humongous \\d+ \\(\\d+KB\\), " +
+        "fragmentation \\d+%, merged (\\d+), split (\\d+)";
+
+    static OutputAnalyzer run(String uncommit) throws Exception {
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            "-XX:+UseSerialGC",
+            "-XX:+PrintGCDetails",
+            uncommit,
+            "TestMetaspaceChunkMerging$LoadAndUnload");
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+        // The heap printed at exit reports the free chunks
+        Matcher m = Pattern.compile(FREE_CHUNKS).matcher(output.getStdout());
+        if (!m.find()) {
+            throw new RuntimeException("No free chunk statistics in the output");
+        }
+        long merged = Long.parseLong(m.group(2));
+        long split = Long.parseLong(m.group(3));
+        System.out.println(uncommit + ": merged " + merged + ", split " + split);
+        // The chunks of the unloaded loaders were merged and the next
+        // loaders got their chunks by splitting the merged ones
+        if (merged == 0) {
+            throw new RuntimeException("No free chunks were merged");
+        }
+        if (split == 0) {
+            throw new RuntimeException("No free chunks were split");
+        }
+        return output;
+    }
+
+    public static void main(String[] args) throws Exception {
+        run("-XX:+MetaspaceUncommitFreeChunks");
+
+        OutputAnalyzer output = run("-XX:-MetaspaceUncommitFreeChunks");
+        output.shouldNotMatch(FREE_CHUNKS.replace("(\\d+)KB uncommitted", "[1-9]\\d*KB uncommitted"));
+    }
+
+    public static class LoadAndUnload {
+        static void loadClasses(int count) throws Exception {
+            for (int i = 0; i < count; i++) {
+                GeneratedClassLoader gcl = new GeneratedClassLoader();
+                Class<?> c = gcl.getGeneratedClasses(i % 20, 10)[0];
+                c.newInstance();
+            }
+        }
+
+        public static void main(String[] args) throws Exception {
+            loadClasses(500);
+            // Unload the loaders and free their chunks
+            System.gc();
+            // Allocate chunks again from the merged free chunks
+            loadClasses(100);
+        }
+    }
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test TestMetaspaceDCmd
+ * @key jcmd
+ * @summary VM.metaspace reports metaspace usage, and free chunks are uncommitted after the delay
+ * @library /testlibrary /runtime/testlibrary
+ * @build GeneratedClassLoader
+ * @run main/othervm -XX:+UseSerialGC -XX:+MetaspaceUncommitFreeChunks -XX:MetaspaceUncommitDelay=100 TestMetaspaceDCmd
+ */
+
+import com.oracle.java.testlibrary.JDKToolFinder;
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.ProcessTools;
+
+public class TestMetaspaceDCmd {
+    static OutputAnalyzer jcmd(String... args) throws Exception {
+        String pid = Integer.toString(ProcessTools.getProcessId());
+        String[] command = new String[args.length + 3];
+        command[0] = JDKToolFinder.getJDKTool("jcmd");
+        command[1] = pid;
+        command[2] = "VM.metaspace";
+        System.arraycopy(args, 0, command, 3, args.length);
+        OutputAnalyzer output = new OutputAnalyzer(new ProcessBuilder(command).start());
+        System.out.println(output.getOutput());
+        output.shouldHaveExitValue(0);
+        return output;
+    }
+
+    public static void main(String[] args) throws Exception {
+        for (int i = 0; i < 500; i++) {
+            GeneratedClassLoader gcl = new GeneratedClassLoader();
+            Class<?> c = gcl.getGeneratedClasses(i % 20, 10)[0];
+            c.newInstance();
+        }
+        // Unload the loaders and give the uncommit task time to run
+        System.gc();
+        Thread.sleep(1000);
+
+        OutputAnalyzer output = jcmd();
+        output.shouldContain("Usage per space type:");
+        output.shouldMatch("Boot: \\d+ loaders, \\d+ classes, used \\d+KB \\(class \\d+KB\\), free \\d+KB");
+        output.shouldContain("Virtual space:");
+        output.shouldMatch("Non-Class: reserved \\d+KB, committed \\d+KB, used \\d+KB, capacity \\d+KB, " +
+                           "free chunks \\d+KB, uncommitted \\d+KB");
+        output.shouldContain("Free chunks:");
+        output.shouldContain("Uncommit of free chunks enabled, delay 100 ms, watermark 0KB");
+        output.shouldNotContain("Usage per loader:");
+
+        output = jcmd("show-loaders", "scale=MB");
+        output.shouldContain("Usage per loader:");
+        output.shouldContain("<bootloader>");
+        output.shouldMatch("Standard: \\d+ loaders, \\d+ classes, used \\d+MB");
+
+        output = jcmd("scale=apa");
+        output.shouldContain("Incorrect scale value: apa");
+    }
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+import com.oracle.java.testlibrary.JDKToolFinder;
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.ProcessTools;
+
+/*
+ * @test
+ * @summary Test that the safepoint profiler records the last threads to reach
+ *          a safepoint and that VM.safepoint_profile prints them
+ * @library /testlibrary
+ * @run main/othervm -XX:+UseSafepointProfiler -XX:SafepointProfilerLaggards=64 -XX:SafepointProfilerHistorySize=8 TestSafepointProfiler
+ */
+public class TestSafepointProfiler {
+
+    private static volatile long sink;
+
+    public static void main(String[] args) throws Exception {
+        // Keep a thread busy in Java code while safepoints are requested
+        Thread spinner = new Thread("spinner") {
+            public void run() {
+                long sum = 0;
+                while (!isInterrupted()) {
+                    for (int i = 0; i < 100000; i++) {
+                        sum += i ^ sum;
+                    }
+                    sink = sum;
+                }
+            }
+        };
+        spinner.setDaemon(true);
+        spinner.start();
+
+        for (int i = 0; i < 5; i++) {
+            System.gc();
+        }
+
+        OutputAnalyzer output = jcmd("VM.safepoint_profile", "-reset");
+        output.shouldContain("Safepoint profile:");
+        output.shouldContain("Safepoint #");
+        output.shouldContain("\"main\"");
+        output.shouldContain("\"spinner\"");
+
+        spinner.interrupt();
+    }
+
+    private static OutputAnalyzer jcmd(String... command) throws Exception {
+        String pid = Integer.toString(ProcessTools.getProcessId());
+        String[] cmd = new String[command.length + 2];
+        cmd[0] = JDKToolFinder.getJDKTool("jcmd");
+        cmd[1] = pid;
+        System.arraycopy(command, 0, cmd, 2, command.length);
+        ProcessBuilder pb = new ProcessBuilder(cmd);
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        System.out.println(output.getOutput());
+        return output;
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test TestConcurrentIntern
+ * @summary Intern strings from many threads while the StringTable grows and shrinks
+ * @run main/othervm -XX:StringTableSize=1009 -XX:+ResizeStringSymbolTables -XX:StringSymbolTableMaxLoadFactor=1 -XX:+ConcurrentSymbolTableCleaning TestConcurrentIntern
+ * @run main/othervm -XX:StringTableSize=1009 -XX:+UnlockExperimentalVMOptions -XX:SymbolTableSize=1009 -XX:+ResizeStringSymbolTables -XX:-ConcurrentSymbolTableCleaning TestConcurrentIntern
+ * @run main/othervm -XX:StringTableSize=1009 -XX:-ResizeStringSymbolTables TestConcurrentIntern
+ */
+
+import java.util.concurrent.CyclicBarrier;
+
+public class TestConcurrentIntern {
+    static final int THREADS = 4;
+    static final int STRINGS = 50000;
+    // Strides coprime with STRINGS, so that every thread visits each index once
+    static final int[] STRIDES = { 1, 3, 7, 11 };
+
+    static final String[][] results = new String[THREADS][];
+
+    public static void main(String... args) throws Exception {
+        for (int round = 0; round < 3; round++) {
+            final CyclicBarrier barrier = new CyclicBarrier(THREADS);
+            Thread[] threads = new Thread[THREADS];
+            for (int t = 0; t < THREADS; t++) {
+                final int id = t;
+                final int r = round;
+                threads[t] = new Thread() {
+                    public void run() {
+                        String[] interned = new String[STRINGS];
+                        try {
+                            barrier.await();
+                        } catch (Exception e) {
+                            throw new RuntimeException(e);
+                        }
+                        for (int i = 0; i < STRINGS; i++) {
+                            // Every thread interns the same strings, in a different order
+                            int k = (int)(((long)i * STRIDES[id]) % STRINGS);
+                            interned[k] = new String("str-" + r + "-" + k).intern();
+                        }
+                        results[id] = interned;
+                    }
+                };
+                threads[t].start();
+            }
+            for (Thread t : threads) {
+                t.join();
+            }
+            for (int i = 0; i < STRINGS; i++) {
+                String s = results[0][i];
+                if (s == null || !s.equals("str-" + round + "-" + i)) {
+                    throw new RuntimeException("Wrong string " + s + " at " + i);
+                }
+                for (int t = 1; t < THREADS; t++) {
+                    if (results[t][i] != s) {
+                        throw new RuntimeException("Interned twice: " + s);
+                    }
+                }
+                if (s.intern() != s) {
+                    throw new RuntimeException("Lost interned string: " + s);
+                }
+            }
+            // Let the strings of this round die so that the table can shrink
+            for (int t = 0; t < THREADS; t++) {
+                results[t] = null;
+            }
+            System.gc();
+        }
+    }
+}
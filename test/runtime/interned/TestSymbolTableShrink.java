@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test TestSymbolTableShrink
+ * @summary The SymbolTable shrinks again after its symbols were unlinked
+ * @library /testlibrary
+ * @build TestSymbolTableShrink
+ * @run main/othervm TestSymbolTableShrink
+ */
+
+import com.oracle.java.testlibrary.*;
+
+public class TestSymbolTableShrink {
+    static final int SYMBOLS = 300000;
+
+    public static void main(String[] args) throws Exception {
+        // The symbols are unlinked by the service thread and in the GC pause
+        testShrink("-XX:+ConcurrentSymbolTableCleaning");
+        testShrink("-XX:-ConcurrentSymbolTableCleaning");
+    }
+
+    private static void testShrink(String cleaning) throws Exception {
+        int grown = symbolTableBuckets(cleaning, "keep");
+        int shrunk = symbolTableBuckets(cleaning, "gc");
+        System.out.println(cleaning + ": " + grown + " buckets grown, " + shrunk + " after the symbols died");
+        if (grown <= 1009) {
+            throw new RuntimeException("SymbolTable did not grow: " + grown);
+        }
+        if (shrunk >= grown) {
+            throw new RuntimeException("SymbolTable did not shrink: " + shrunk + " >= " + grown);
+        }
+    }
+
+    private static int symbolTableBuckets(String cleaning, String mode) throws Exception {
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+                "-XX:+UnlockExperimentalVMOptions",
+                "-XX:SymbolTableSize=1009",
+                "-XX:+ResizeStringSymbolTables",
+                "-XX:StringSymbolTableMaxLoadFactor=2",
+                "-XX:+PrintStringTableStatistics",
+                cleaning,
+                Foo.class.getName(),
+                mode);
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+        String[] lines = output.getStdout().split("\n");
+        for (int i = 0; i < lines.length - 1; i++) {
+            if (lines[i].startsWith("SymbolTable statistics:")) {
+                // Number of buckets       :    262144 = ...
+                String buckets = lines[i + 1].split(":")[1].split("=")[0].trim();
+                return Integer.parseInt(buckets);
+            }
+        }
+        throw new RuntimeException("No SymbolTable statistics");
+    }
+
+    static class Foo {
+        public static void main(String[] args) throws Exception {
+            // Every failed lookup leaves an unreferenced symbol behind
+            for (int i = 0; i < SYMBOLS; i++) {
+                try {
+                    Class.forName("NoSuchClass" + i, false, null);
+                } catch (ClassNotFoundException e) {
+                }
+            }
+            if (args[0].equals("gc")) {
+                System.gc();
+                // give the service thread time to unlink and resize
+                Thread.sleep(3000);
+            }
+        }
+    }
+}
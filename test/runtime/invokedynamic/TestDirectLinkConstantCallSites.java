@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test TestDirectLinkConstantCallSites
+ * @summary invokedynamic call sites linked directly to constant DirectMethodHandles
+ *          compute the same results in the interpreter and compiled code
+ * @library /testlibrary
+ * @run main TestDirectLinkConstantCallSites
+ */
+
+import java.util.function.DoubleSupplier;
+import java.util.function.LongSupplier;
+import java.util.function.Supplier;
+
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.ProcessTools;
+
+public class TestDirectLinkConstantCallSites {
+    public static void main(String[] args) throws Exception {
+        String[][] modes = {
+            { "-Xint" },
+            { "-XX:TieredStopAtLevel=1", "-Xbatch" },
+            { "-XX:-TieredCompilation", "-Xbatch" },
+            { "-Xcomp", "-XX:-TieredCompilation" },
+        };
+        for (String[] mode : modes) {
+            String[] vmArgs = new String[mode.length + 2];
+            System.arraycopy(mode, 0, vmArgs, 0, mode.length);
+            vmArgs[mode.length] = "-XX:+DirectLinkConstantCallSites";
+            vmArgs[mode.length + 1] = "TestDirectLinkConstantCallSites$Worker";
+            ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(vmArgs);
+            OutputAnalyzer output = new OutputAnalyzer(pb.start());
+            output.shouldHaveExitValue(0);
+            output.shouldContain("sum 1999000 product 1999000.0 text 0-1999");
+        }
+    }
+
+    public static class Worker {
+        static long sum;
+        static double product;
+        static String text;
+
+        static void run(int i, long l, double d, String s) {
+            // Capturing lambdas are bound to a DirectMethodHandle of the
+            // lambda class factory.
+            LongSupplier ls = () -> l + i;
+            DoubleSupplier ds = () -> d * i;
+            Supplier<String> ss = () -> s + i;
+            sum += ls.getAsLong();
+            product += ds.getAsDouble();
+            text = ss.get();
+        }
+
+        public static void main(String[] args) {
+            for (int i = 0; i < 200; i++) {
+                sum = 0;
+                product = 0;
+                for (int j = 0; j < 2000; j++) {
+                    run(j, 0L, 1.0, "0-");
+                }
+            }
+            System.out.println("sum " + sum + " product " + product + " text " + text);
+        }
+    }
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test TestVerificationCache
+ * @summary Skip verifying classes that an earlier run verified, using -XX:VerificationCacheFile
+ * @library /testlibrary
+ * @run main TestVerificationCache
+ */
+
+import java.io.File;
+import java.io.FileOutputStream;
+import java.nio.file.Files;
+
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.ProcessTools;
+
+public class TestVerificationCache {
+    static OutputAnalyzer run(File cache) throws Exception {
+        OutputAnalyzer output = run(cache, System.getProperty("test.classes"), "TestVerificationCache$App");
+        output.shouldHaveExitValue(0);
+        output.shouldContain("App ran");
+        return output;
+    }
+
+    static OutputAnalyzer run(File cache, String classPath, String mainClass) throws Exception {
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            "-XX:VerificationCacheFile=" + cache.getAbsolutePath(),
+            "-XX:+PrintVerificationCacheStatistics",
+            "-cp", classPath,
+            mainClass);
+        return new OutputAnalyzer(pb.start());
+    }
+
+    // Copies the class file of Victim into dir, with the bipush 77; ireturn
+    // of Victim.value() replaced by aconst_null; nop; ireturn when broken.
+    // The class keeps its size, only its bytes change.
+    static void writeVictim(File dir, boolean broken) throws Exception {
+        File original = new File(System.getProperty("test.classes"), "TestVerificationCache$Victim.class");
+        byte[] bytes = Files.readAllBytes(original.toPath());
+        if (broken) {
+            int patched = 0;
+            for (int i = 0; i + 2 < bytes.length; i++) {
+                if (bytes[i] == 0x10 && bytes[i + 1] == 77 && bytes[i + 2] == (byte)0xac) {
+                    bytes[i] = 0x01;      // aconst_null
+                    bytes[i + 1] = 0x00;  // nop
+                    patched++;
+                }
+            }
+            if (patched != 1) {
+                throw new RuntimeException("Found " + patched + " places to patch in Victim");
+            }
+        }
+        dir.mkdirs();
+        FileOutputStream out = new FileOutputStream(new File(dir, original.getName()));
+        out.write(bytes);
+        out.close();
+    }
+
+    public static void main(String[] args) throws Exception {
+        File cache = new File("verification.cache");
+        cache.delete();
+
+        // The first run verifies everything and records it
+        OutputAnalyzer output = run(cache);
+        output.shouldContain("Verification cache: 0 hits");
+        if (!cache.exists()) {
+            throw new RuntimeException("Verification cache file was not written");
+        }
+
+        // The second run finds the classes of the first one
+        output = run(cache);
+        output.shouldMatch("Verification cache: [1-9][0-9]* hits");
+
+        // Changed class bytes of the same size are verified again
+        cache.delete();
+        File victimDir = new File("victim");
+        String classPath = victimDir.getAbsolutePath() + File.pathSeparator + System.getProperty("test.classes");
+        writeVictim(victimDir, false);
+        output = run(cache, classPath, "TestVerificationCache$VictimApp");
+        output.shouldHaveExitValue(0);
+        output.shouldContain("Victim 77");
+        output = run(cache, classPath, "TestVerificationCache$VictimApp");
+        output.shouldHaveExitValue(0);
+        output.shouldMatch("Verification cache: [1-9][0-9]* hits");
+        writeVictim(victimDir, true);
+        output = run(cache, classPath, "TestVerificationCache$VictimApp");
+        output.shouldContain("java.lang.VerifyError");
+        output.shouldNotContain("Victim 77");
+
+        // A damaged file is ignored
+        FileOutputStream out = new FileOutputStream(cache);
+        out.write(new byte[] { 1, 2, 3 });
+        out.close();
+        output = run(cache);
+        output.shouldContain("has a wrong format, ignored");
+        output.shouldContain("Verification cache: 0 hits");
+    }
+
+    static class Base {
+        protected int value;
+        protected int get() { return value; }
+    }
+
+    static class Derived extends Base {
+        int twice(Derived other) {
+            Base b = other;
+            return b.get() + other.value + get();
+        }
+    }
+
+    public static class Victim {
+        static int value() {
+            return 77;
+        }
+    }
+
+    public static class VictimApp {
+        public static void main(String[] args) throws Exception {
+            System.out.println("Victim " + Victim.value());
+        }
+    }
+
+    public static class App {
+        public static void main(String[] args) throws Exception {
+            Derived d = new Derived();
+            d.value = 21;
+            if (d.twice(d) != 63) {
+                throw new RuntimeException("Wrong result");
+            }
+            System.out.println("App ran");
+        }
+    }
+}
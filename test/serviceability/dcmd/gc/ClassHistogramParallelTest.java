@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+import com.oracle.java.testlibrary.JDKToolFinder;
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.ProcessTools;
+
+import java.util.ArrayList;
+import java.util.List;
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+/*
+ * @test
+ * @summary GC.class_histogram -parallel counts the same instances as the serial inspection, -sample estimates them
+ * @library /testlibrary
+ * @run main/othervm -XX:+UseG1GC -XX:ParallelGCThreads=4 -XX:G1HeapRegionSize=1m -Xmx256m ClassHistogramParallelTest
+ */
+public class ClassHistogramParallelTest {
+    static final String cmd = "GC.class_histogram";
+    static final int COUNT = 200000;
+
+    static class HistoObject {
+        long payload;
+    }
+
+    static List<HistoObject> holder = new ArrayList<>();
+
+    public static void main(String[] args) throws Exception {
+        for (int i = 0; i < COUNT; i++) {
+            holder.add(new HistoObject());
+        }
+
+        // -all avoids the full GC, the instances stay in place between the runs
+        long serial = instances(jcmd("-all"));
+        long parallel = instances(jcmd("-all", "-parallel=4"));
+        if (serial != COUNT || parallel != COUNT) {
+            throw new RuntimeException("Expected " + COUNT + " instances, serial: " + serial +
+                                       ", parallel: " + parallel);
+        }
+
+        OutputAnalyzer output = jcmd("-all", "-parallel=4", "-sample=50");
+        output.shouldContain("Estimated from 50% of the heap regions");
+        long estimated = instances(output);
+        if (estimated < COUNT / 4 || estimated > COUNT * 4) {
+            throw new RuntimeException("Estimate " + estimated + " too far off " + COUNT);
+        }
+
+        jcmd("-sample=0").shouldContain("Sample percentage out of range");
+        jcmd("-parallel=0").shouldContain("Invalid number of parallel inspection threads");
+        System.out.println("Inspected " + holder.size() + " objects");
+    }
+
+    static OutputAnalyzer jcmd(String... options) throws Exception {
+        String pid = Integer.toString(ProcessTools.getProcessId());
+        List<String> command = new ArrayList<>();
+        command.add(JDKToolFinder.getJDKTool("jcmd"));
+        command.add(pid);
+        command.add(cmd);
+        for (String option : options) {
+            command.add(option);
+        }
+        OutputAnalyzer output = new OutputAnalyzer(new ProcessBuilder(command).start());
+        output.shouldHaveExitValue(0);
+        return output;
+    }
+
+    static long instances(OutputAnalyzer output) {
+        Pattern line = Pattern.compile("^\\s*\\d+:\\s+(\\d+)\\s+\\d+\\s+ClassHistogramParallelTest\\$HistoObject$",
+                                       Pattern.MULTILINE);
+        Matcher m = line.matcher(output.getStdout());
+        if (!m.find()) {
+            throw new RuntimeException("HistoObject not in the histogram");
+        }
+        return Long.parseLong(m.group(1));
+    }
+}
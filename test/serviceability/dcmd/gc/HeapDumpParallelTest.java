@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2020 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+import com.oracle.java.testlibrary.JDKToolFinder;
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.ProcessTools;
+
+import java.io.ByteArrayOutputStream;
+import java.io.File;
+import java.io.FileInputStream;
+import java.io.InputStream;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+import java.util.zip.GZIPInputStream;
+
+/*
+ * @test
+ * @summary GC.heap_dump -parallel and -gz write a complete HPROF file without temporary files
+ * @library /testlibrary
+ * @run main/othervm HeapDumpParallelTest
+ */
+public class HeapDumpParallelTest {
+    static final String cmd = "GC.heap_dump";
+    static final byte[] HEADER = "JAVA PROFILE 1.0.2".getBytes();
+    // HPROF_HEAP_DUMP_END, ticks and length
+    static final byte[] END_RECORD = { 0x2c, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    static List<Object> holder = new ArrayList<>();
+
+    public static void main(String[] args) throws Exception {
+        if (args.length == 0) {
+            // The progress is printed to the output of the dumped VM, so the
+            // dumps are taken by a child VM.
+            ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+                "-XX:+UseG1GC", "-XX:ParallelGCThreads=4", "-XX:G1HeapRegionSize=1m", "-Xmx128m",
+                "-Dtest.jdk=" + System.getProperty("test.jdk"),
+                "HeapDumpParallelTest", "dump");
+            OutputAnalyzer output = new OutputAnalyzer(pb.start());
+            System.out.println(output.getOutput());
+            output.shouldHaveExitValue(0);
+            output.shouldContain("Heap dump progress:");
+            return;
+        }
+
+        for (int i = 0; i < 20000; i++) {
+            holder.add(new int[i % 256]);
+            holder.add("string " + i);
+        }
+        // too long to be buffered with other records, written to a segment of its own
+        holder.add(new long[1 << 20]);
+
+        OutputAnalyzer output = dump("parallel.hprof", "-parallel=4");
+        verify("parallel.hprof", false);
+
+        dump("compressed.hprof.gz", "-gz=1");
+        verify("compressed.hprof.gz", true);
+
+        dump("parallel-compressed.hprof.gz", "-parallel=4", "-gz=6");
+        verify("parallel-compressed.hprof.gz", true);
+
+        output = jcmd(cmd, "-gz=10", "invalid.hprof.gz");
+        output.shouldContain("Compression level out of range");
+        output = jcmd(cmd, "-parallel=0", "invalid.hprof");
+        output.shouldContain("Invalid number of parallel dump threads");
+
+        System.out.println("Dumped " + holder.size() + " objects");
+    }
+
+    static OutputAnalyzer jcmd(String... args) throws Exception {
+        String pid = Integer.toString(ProcessTools.getProcessId());
+        List<String> command = new ArrayList<>();
+        command.add(JDKToolFinder.getJDKTool("jcmd"));
+        command.add(pid);
+        command.addAll(Arrays.asList(args));
+        ProcessBuilder pb = new ProcessBuilder(command);
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+        return output;
+    }
+
+    static OutputAnalyzer dump(String name, String... options) throws Exception {
+        File file = new File(name);
+        file.delete();
+        List<String> args = new ArrayList<>();
+        args.add(cmd);
+        args.addAll(Arrays.asList(options));
+        args.add(file.getAbsolutePath());
+        OutputAnalyzer output = jcmd(args.toArray(new String[0]));
+        output.shouldContain("Heap dump file created");
+        return output;
+    }
+
+    static void verify(String name, boolean compressed) throws Exception {
+        File file = new File(name);
+        byte[] content;
+        try (InputStream in = compressed ? new GZIPInputStream(new FileInputStream(file))
+                                         : new FileInputStream(file)) {
+            ByteArrayOutputStream out = new ByteArrayOutputStream();
+            byte[] buf = new byte[64 * 1024];
+            int n;
+            while ((n = in.read(buf)) > 0) {
+                out.write(buf, 0, n);
+            }
+            content = out.toByteArray();
+        }
+        if (!Arrays.equals(Arrays.copyOf(content, HEADER.length), HEADER)) {
+            throw new RuntimeException(name + ": missing HPROF header");
+        }
+        byte[] tail = Arrays.copyOfRange(content, content.length - END_RECORD.length, content.length);
+        if (!Arrays.equals(tail, END_RECORD)) {
+            throw new RuntimeException(name + ": dump does not end with HPROF_HEAP_DUMP_END");
+        }
+        File dir = file.getAbsoluteFile().getParentFile();
+        for (String f : dir.list()) {
+            if (f.startsWith(name + ".part") || f.equals(name + ".raw")) {
+                throw new RuntimeException("dump part left behind: " + f);
+            }
+        }
+        file.delete();
+    }
+}